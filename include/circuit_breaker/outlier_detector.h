@@ -0,0 +1,181 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "circuit_breaker/circuit_breaker_window.h"
+#include "observability/common.h"
+// <memory>, <vector>, <string>, <array>, <atomic>, <mutex>, <chrono> provided by common.h
+
+class Dispatcher;
+
+namespace OBSERVABILITY_NAMESPACE {
+class ObservabilityManager;
+}  // namespace OBSERVABILITY_NAMESPACE
+
+namespace CIRCUIT_BREAKER_NAMESPACE {
+
+// Passive outlier detection for one multi-endpoint upstream. Proxy
+// outcomes are recorded per (member, dispatcher) into the same kind of
+// sliding window the breaker slices use; three detectors decide which
+// members leave the load balancer's rotation:
+//
+//   consecutive_5xx — N failures in a row on a member, across all
+//                     dispatchers. Checked inline on every failure.
+//   success_rate    — member success rate below the set mean by more
+//                     than stdev * factor. Checked each sweep.
+//   latency         — member p99 above the median member p99 by a
+//                     factor. Checked each sweep.
+//
+// Each dispatcher publishes its window counts and latency histogram on
+// its own sweep tick; dispatcher 0 additionally runs the statistical
+// detectors over the published data and returns members whose ejection
+// time has expired. The published view can lag by up to one interval
+// per dispatcher, which the statistics tolerate.
+//
+// Ejections never push the share of ejected members above
+// circuit_breaker.max_ejection_percent_per_host_set. Under dry_run a
+// would-be ejection is logged and counted but the member stays in
+// rotation.
+//
+// Lifetime: owned by UpstreamHostPool via shared_ptr. Sweep tasks hold
+// a weak_ptr, so a tick that fires after Stop() or destruction is a
+// no-op.
+class OutlierDetector : public std::enable_shared_from_this<OutlierDetector> {
+public:
+    enum class Reason { CONSECUTIVE_5XX, SUCCESS_RATE, LATENCY };
+    static const char* ReasonName(Reason reason) noexcept;
+
+    // Log2 latency buckets: bucket 0 is < 1ms, bucket b covers
+    // [2^(b-1), 2^b) ms. The last bucket absorbs everything above.
+    static constexpr size_t LATENCY_BUCKETS = 24;
+
+    // `member_labels` are the "ip:port" labels used in logs and metrics,
+    // one per pool member.
+    OutlierDetector(std::string service_name,
+                    std::vector<std::string> member_labels,
+                    size_t dispatcher_count,
+                    const CircuitBreakerConfig& config);
+    ~OutlierDetector();
+
+    OutlierDetector(const OutlierDetector&) = delete;
+    OutlierDetector& operator=(const OutlierDetector&) = delete;
+
+    // Schedule one sweep per dispatcher every outlier_detection.interval_ms.
+    // Sweeps run whether or not detection is enabled, so a reload that
+    // turns it on takes effect without a restart.
+    void Start(const std::vector<std::shared_ptr<Dispatcher>>& dispatchers);
+
+    // Stop scheduling sweeps. Any thread; idempotent.
+    void Stop();
+
+    // Apply a reloaded breaker config. Any thread. Turning detection off
+    // (or the breaker off) returns every ejected member immediately.
+    void Reload(const CircuitBreakerConfig& config);
+
+    void SetObservabilityManager(
+        OBSERVABILITY_NAMESPACE::ObservabilityManager* obs_manager) noexcept {
+        obs_manager_.store(obs_manager, std::memory_order_release);
+    }
+
+    // Record one attempt outcome for `member`. `latency_ms` < 0 means
+    // no response was received (connect failure, timeout, disconnect).
+    // Dispatcher thread of `dispatcher_index` only.
+    void Record(size_t dispatcher_index, size_t member, bool failure,
+                int64_t latency_ms,
+                std::chrono::steady_clock::time_point now);
+
+    // Publish this dispatcher's slots; on dispatcher 0 also evaluate.
+    // Called by the sweep task; exposed for tests.
+    void Sweep(size_t dispatcher_index,
+               std::chrono::steady_clock::time_point now);
+
+    // Any thread.
+    bool IsEjected(size_t member) const noexcept {
+        return members_[member].ejected.load(std::memory_order_acquire);
+    }
+    int64_t ejected_count() const noexcept {
+        return ejected_count_.load(std::memory_order_acquire);
+    }
+    // Ejections applied (enforced) / computed under dry_run, since start.
+    int64_t ejections_total() const noexcept {
+        return ejections_total_.load(std::memory_order_relaxed);
+    }
+    int64_t dry_run_ejections_total() const noexcept {
+        return dry_run_ejections_total_.load(std::memory_order_relaxed);
+    }
+    size_t member_count() const noexcept { return members_.size(); }
+
+private:
+    // One (member, dispatcher) observation cell. The window and the
+    // local histogram are dispatcher-local; the published fields are
+    // what the evaluator on dispatcher 0 reads.
+    struct alignas(64) Slot {
+        explicit Slot(int window_seconds) : window(window_seconds) {}
+        CircuitBreakerWindow window;
+        std::array<int64_t, LATENCY_BUCKETS> latency{};
+        std::atomic<int64_t> published_total{0};
+        std::atomic<int64_t> published_failures{0};
+        std::array<std::atomic<int64_t>, LATENCY_BUCKETS> published_latency{};
+    };
+
+    struct MemberState {
+        std::atomic<int> consecutive_failures{0};
+        std::atomic<bool> ejected{false};
+        // Guarded by mtx_.
+        int times_ejected = 0;
+        std::chrono::steady_clock::time_point ejected_until{};
+    };
+
+    static bool Active(const CircuitBreakerConfig& config) noexcept {
+        return config.enabled && config.outlier_detection.enabled;
+    }
+    static size_t LatencyBucket(int64_t latency_ms) noexcept;
+
+    Slot& SlotFor(size_t member, size_t dispatcher_index) {
+        return *slots_[member * dispatcher_count_ + dispatcher_index];
+    }
+    void SyncWindow(Slot& slot);
+    void ScheduleSweep(size_t dispatcher_index);
+    std::shared_ptr<const CircuitBreakerConfig> LoadConfig() const;
+
+    // Dispatcher 0. Returns expired ejections, then runs the
+    // statistical detectors over the published slots.
+    void Evaluate(std::chrono::steady_clock::time_point now);
+    void DetectSuccessRate(const CircuitBreakerConfig& config,
+                           std::chrono::steady_clock::time_point now);
+    void DetectLatency(const CircuitBreakerConfig& config,
+                       std::chrono::steady_clock::time_point now);
+
+    // Eject `member` unless it already is or the percentage cap forbids
+    // it. Any dispatcher; takes mtx_.
+    void TryEject(size_t member, Reason reason,
+                  const CircuitBreakerConfig& config,
+                  std::chrono::steady_clock::time_point now,
+                  const std::string& detail);
+    void EmitEjection(size_t member, Reason reason, bool enforced);
+
+    std::string service_name_;
+    std::vector<std::string> member_labels_;
+    size_t dispatcher_count_;
+
+    // Read on every Record; mirrored from config_ by Reload.
+    std::atomic<bool> active_{false};
+    std::atomic<int> consecutive_limit_{0};
+    std::atomic<int> window_seconds_{0};
+    // Full config for sweeps and ejection decisions. Accessed only via
+    // std::atomic_load / std::atomic_store.
+    std::shared_ptr<const CircuitBreakerConfig> config_;
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<MemberState> members_;
+    std::mutex mtx_;
+    std::atomic<int64_t> ejected_count_{0};
+    std::atomic<int64_t> ejections_total_{0};
+    std::atomic<int64_t> dry_run_ejections_total_{0};
+
+    std::vector<std::shared_ptr<Dispatcher>> dispatchers_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<OBSERVABILITY_NAMESPACE::ObservabilityManager*> obs_manager_{nullptr};
+};
+
+}  // namespace CIRCUIT_BREAKER_NAMESPACE
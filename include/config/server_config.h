@@ -17,6 +17,35 @@ struct TlsConfig {
     std::string cert_file;
     std::string key_file;
     std::string min_version = "1.2";
+
+    // Session resumption. Tickets are encrypted with the keys in
+    // `ticket_key_file` (one or more 80-byte keys, first one encrypts),
+    // or with in-process random keys when the file is empty. The file is
+    // re-read on every SIGHUP; in-process keys are rotated instead, with
+    // the previous key kept for decryption only.
+    bool session_tickets = true;
+    std::string ticket_key_file;
+    // Server-side session cache, in entries. 0 = off (tickets only).
+    int session_cache_size = 0;
+    // Lifetime of a resumable session (ticket lifetime hint / cache TTL).
+    int session_timeout_sec = 3600;
+    // Kernel TLS: after the handshake, hand record encryption to the
+    // kernel (Linux TLS ULP) so writes go to the socket as plain bytes.
+    // Falls back to OpenSSL when the kernel or cipher can't take it.
+    bool ktls = false;
+    // Worker threads for handshake private-key operations (RSA / ECDSA
+    // signatures), so a burst of new connections doesn't stall the
+    // dispatchers. 0 = sign inline on the dispatcher.
+    int handshake_offload_threads = 0;
+    // Dynamic record sizing: records of at most `record_size_initial`
+    // plaintext bytes (one TCP segment) until `record_size_ramp_bytes`
+    // have been written, then 16 KB records; the connection goes back to
+    // small records after `record_size_idle_reset_ms` without a write
+    // (0 = never). Off = every write uses 16 KB records.
+    bool record_sizing = false;
+    int record_size_initial = 1400;
+    int record_size_ramp_bytes = 1048576;
+    int record_size_idle_reset_ms = 1000;
 };
 
 struct LogConfig {
@@ -40,6 +69,11 @@ struct Http2Config {
     // default of 1 applies internally for our PUSH_PROMISE emission.
     bool enable_push = false;
 
+    // Coalesce the frames one dispatcher iteration produces into a single
+    // write per connection (userspace cork, MSG_MORE on plain TCP). Fewer
+    // syscalls and full-size TLS records. Applies to new connections.
+    bool write_batching = true;
+
     // Inbound H2 streaming-request body watermarks + WINDOW_UPDATE
     // replenishment threshold. Live-reloadable.
     struct StreamingConfig {
@@ -59,6 +93,46 @@ struct Http1Config {
     StreamingConfig streaming;
 };
 
+// Experimental HTTP/3-framed listener over UDP (docs/http3.md). No QUIC
+// transport underneath — loopback / lab use only. All fields restart-only.
+struct Http3Config {
+    bool enabled = false;
+    int port = 0;                        // 0 = same port number as bind_port
+    size_t max_datagram_size = 1350;     // outbound datagram cap, [64, 65507]
+    size_t recv_batch_size = 16;         // recvmmsg/sendmmsg vector, [1, 1024]
+};
+
+// RFC 7692 permessage-deflate for inbound WebSocket connections
+// (docs/websocket.md). All fields restart-only.
+struct WebSocketDeflateConfig {
+    bool enabled = false;
+    bool server_no_context_takeover = false;  // reset our compressor after every message
+    bool client_no_context_takeover = false;  // ask clients to reset theirs
+    int server_max_window_bits = 15;          // [9, 15]
+    int client_max_window_bits = 15;          // [9, 15], only when the client offers it
+    int compression_level = 6;                // zlib level, [1, 9]
+    int mem_level = 8;                        // zlib memLevel, [1, 9]
+    size_t min_message_size = 64;             // smaller messages are sent uncompressed
+    size_t max_memory_bytes = 67108864;       // server-wide zlib state cap (64 MB), 0 = unlimited
+
+    bool operator==(const WebSocketDeflateConfig& o) const {
+        return enabled == o.enabled &&
+               server_no_context_takeover == o.server_no_context_takeover &&
+               client_no_context_takeover == o.client_no_context_takeover &&
+               server_max_window_bits == o.server_max_window_bits &&
+               client_max_window_bits == o.client_max_window_bits &&
+               compression_level == o.compression_level &&
+               mem_level == o.mem_level &&
+               min_message_size == o.min_message_size &&
+               max_memory_bytes == o.max_memory_bytes;
+    }
+    bool operator!=(const WebSocketDeflateConfig& o) const { return !(*this == o); }
+};
+
+struct WebSocketConfig {
+    WebSocketDeflateConfig permessage_deflate;
+};
+
 // Per-upstream HTTP/2 client configuration. Distinct from `Http2Config`
 // (which governs INBOUND HTTP/2 server settings) — this struct configures
 // the OUTBOUND H2 client used by the upstream connection pool. Each upstream
@@ -142,11 +216,17 @@ struct UpstreamTlsConfig {
     bool verify_peer = true;
     std::string sni_hostname;
     std::string min_version = "1.2";
+    // Resume TLS sessions on new pool connections (per dispatcher,
+    // keyed by host:port/SNI).
+    bool session_reuse = true;
+    // Kernel TLS offload for pool connections (see TlsConfig::ktls).
+    bool ktls = false;
 
     bool operator==(const UpstreamTlsConfig& o) const {
         return enabled == o.enabled && ca_file == o.ca_file &&
                verify_peer == o.verify_peer && sni_hostname == o.sni_hostname &&
-               min_version == o.min_version;
+               min_version == o.min_version && session_reuse == o.session_reuse &&
+               ktls == o.ktls;
     }
     bool operator!=(const UpstreamTlsConfig& o) const { return !(*this == o); }
 };
@@ -154,6 +234,15 @@ struct UpstreamTlsConfig {
 struct UpstreamPoolConfig {
     int max_connections = 64;
     int max_idle_connections = 16;
+    // Idle connections each dispatcher keeps open ahead of demand (split
+    // across dispatchers like max_idle_connections). adaptive_min_idle
+    // raises the floor to the checkouts expected during one connect.
+    int min_idle_connections = 0;
+    bool adaptive_min_idle = false;
+    // Let a dispatcher whose share is exhausted borrow idle connections
+    // (and the matching share of max_connections) from the other
+    // dispatchers' pools. Plaintext upstreams only.
+    bool lend_idle_connections = false;
     int connect_timeout_ms = 5000;
     int idle_timeout_sec = 90;
     int max_lifetime_sec = 3600;
@@ -162,6 +251,9 @@ struct UpstreamPoolConfig {
     bool operator==(const UpstreamPoolConfig& o) const {
         return max_connections == o.max_connections &&
                max_idle_connections == o.max_idle_connections &&
+               min_idle_connections == o.min_idle_connections &&
+               adaptive_min_idle == o.adaptive_min_idle &&
+               lend_idle_connections == o.lend_idle_connections &&
                connect_timeout_ms == o.connect_timeout_ms &&
                idle_timeout_sec == o.idle_timeout_sec &&
                max_lifetime_sec == o.max_lifetime_sec &&
@@ -170,6 +262,63 @@ struct UpstreamPoolConfig {
     bool operator!=(const UpstreamPoolConfig& o) const { return !(*this == o); }
 };
 
+// One backend of a multi-endpoint upstream. A hostname expands to every
+// A/AAAA record it resolves to; each address becomes its own pool.
+struct UpstreamEndpointConfig {
+    std::string host;
+    int port = 80;
+    int weight = 1;          // Relative share for weighted / hash policies
+
+    bool operator==(const UpstreamEndpointConfig& o) const {
+        return host == o.host && port == o.port && weight == o.weight;
+    }
+    bool operator!=(const UpstreamEndpointConfig& o) const { return !(*this == o); }
+};
+
+// Endpoint selection across an upstream's endpoints. State is kept per
+// dispatcher; hash tables (ring_hash / maglev) are built once at startup.
+struct LoadBalancerConfig {
+    // round_robin | weighted | least_request | ring_hash | maglev
+    std::string policy = "round_robin";
+    // Request key for ring_hash / maglev: client_ip | path | header:<name>
+    std::string hash_key = "client_ip";
+
+    bool operator==(const LoadBalancerConfig& o) const {
+        return policy == o.policy && hash_key == o.hash_key;
+    }
+    bool operator!=(const LoadBalancerConfig& o) const { return !(*this == o); }
+};
+
+// Active health checking of an upstream's endpoints. Every endpoint
+// address is probed on one dispatcher through its own pool partition;
+// results gate load-balancer eligibility. Disabled by default, in which
+// case every endpoint is always eligible.
+struct UpstreamHealthCheckConfig {
+    bool enabled = false;
+    std::string type = "http";         // "http" | "tcp"
+    std::string path = "/health";      // http: request target
+    std::string host;                  // http: Host header; empty = upstream host
+    int interval_ms = 5000;
+    int timeout_ms = 2000;             // Whole check: checkout + response
+    int jitter_percent = 10;           // Each interval drawn from ±jitter
+    int healthy_threshold = 2;         // Consecutive passes to turn healthy
+    int unhealthy_threshold = 3;       // Consecutive failures to turn unhealthy
+    int expected_status_min = 200;     // http: passing status range
+    int expected_status_max = 399;
+
+    bool operator==(const UpstreamHealthCheckConfig& o) const {
+        return enabled == o.enabled && type == o.type && path == o.path &&
+               host == o.host && interval_ms == o.interval_ms &&
+               timeout_ms == o.timeout_ms &&
+               jitter_percent == o.jitter_percent &&
+               healthy_threshold == o.healthy_threshold &&
+               unhealthy_threshold == o.unhealthy_threshold &&
+               expected_status_min == o.expected_status_min &&
+               expected_status_max == o.expected_status_max;
+    }
+    bool operator!=(const UpstreamHealthCheckConfig& o) const { return !(*this == o); }
+};
+
 struct ProxyHeaderRewriteConfig {
     bool set_x_forwarded_for = true;      // Append client IP to X-Forwarded-For
     bool set_x_forwarded_proto = true;     // Set X-Forwarded-Proto
@@ -185,6 +334,47 @@ struct ProxyHeaderRewriteConfig {
     bool operator!=(const ProxyHeaderRewriteConfig& o) const { return !(*this == o); }
 };
 
+// Hedged requests (proxy.retry.hedge). When the first attempt has not
+// produced a response head within the hedge delay, a second attempt is
+// started on a fresh connection; the first response wins and the other
+// attempt is cancelled. Only bodiless GET/HEAD/OPTIONS are hedged, and
+// each hedge consumes a token from the upstream's retry budget.
+struct ProxyHedgeConfig {
+    bool enabled = false;
+    // Fixed hedge delay. With `percentile` set it is used until the route
+    // has enough latency samples. Must be >= 1.
+    int delay_ms = 100;
+    // 0 = fixed delay. 50-99 = hedge once the attempt is slower than this
+    // percentile of recent response-head latencies on the route.
+    int percentile = 0;
+
+    bool operator==(const ProxyHedgeConfig& o) const {
+        return enabled == o.enabled &&
+               delay_ms == o.delay_ms &&
+               percentile == o.percentile;
+    }
+    bool operator!=(const ProxyHedgeConfig& o) const { return !(*this == o); }
+};
+
+// Replay buffer for streamed request bodies (proxy.retry.replay_buffer).
+// Body bytes sent upstream are kept, up to max_bytes, so a retry can
+// resend them after the source stream has been consumed. The first
+// memory_bytes stay in memory; the rest spill to an unlinked, mmap'd
+// file in spill_dir. A body that outgrows max_bytes is still relayed
+// but can no longer be retried once its bytes have been sent.
+struct ProxyReplayBufferConfig {
+    int64_t max_bytes = 0;              // 0 = off
+    int64_t memory_bytes = 65536;       // 64 KiB
+    std::string spill_dir = "/tmp";
+
+    bool operator==(const ProxyReplayBufferConfig& o) const {
+        return max_bytes == o.max_bytes &&
+               memory_bytes == o.memory_bytes &&
+               spill_dir == o.spill_dir;
+    }
+    bool operator!=(const ProxyReplayBufferConfig& o) const { return !(*this == o); }
+};
+
 struct ProxyRetryConfig {
     int max_retries = 0;                    // 0 = no retries
     bool retry_on_connect_failure = true;   // Retry when pool checkout connect fails
@@ -192,6 +382,8 @@ struct ProxyRetryConfig {
     bool retry_on_timeout = false;          // Retry on response timeout
     bool retry_on_disconnect = true;        // Retry when upstream closes mid-response
     bool retry_non_idempotent = false;      // Retry POST/PATCH/DELETE (dangerous)
+    ProxyHedgeConfig hedge;                 // Parallel attempt for slow responses
+    ProxyReplayBufferConfig replay_buffer;  // Retry streamed request bodies
 
     bool operator==(const ProxyRetryConfig& o) const {
         return max_retries == o.max_retries &&
@@ -199,11 +391,74 @@ struct ProxyRetryConfig {
                retry_on_5xx == o.retry_on_5xx &&
                retry_on_timeout == o.retry_on_timeout &&
                retry_on_disconnect == o.retry_on_disconnect &&
-               retry_non_idempotent == o.retry_non_idempotent;
+               retry_non_idempotent == o.retry_non_idempotent &&
+               hedge == o.hedge &&
+               replay_buffer == o.replay_buffer;
     }
     bool operator!=(const ProxyRetryConfig& o) const { return !(*this == o); }
 };
 
+// gRPC mode for a proxy (docs/http2_upstream.md, "gRPC mode"). Applies
+// only to requests whose content-type is application/grpc[+fmt]; other
+// requests through the same proxy keep HTTP-generic behavior.
+struct ProxyGrpcConfig {
+    bool enabled = false;
+    // grpc-status names ("unavailable", "resource-exhausted", ...) that
+    // make a trailers-only upstream response retryable. Retries still need
+    // retry.max_retries > 0 and are bounded by the retry budget; the
+    // method idempotency gate does not apply (every gRPC call is a POST).
+    std::vector<std::string> retry_on;
+    // grpc-status names reported to the circuit breaker as upstream
+    // failures. Any other status (including OK) counts as success.
+    std::vector<std::string> breaker_failure_on = {
+        "unknown", "deadline-exceeded", "internal", "unavailable", "data-loss"};
+    // Parse the client's grpc-timeout into the per-request upstream
+    // deadline (HttpRequest::upstream_deadline_override_ms) and re-emit
+    // the remaining budget upstream on every attempt.
+    bool propagate_timeout = true;
+    // Upper bound applied to a client-supplied grpc-timeout. 0 = no cap.
+    int max_timeout_ms = 0;
+    // Per-message cap on Length-Prefixed-Message payloads, both
+    // directions. 0 = unlimited.
+    uint32_t max_message_bytes = 0;
+    // Record rpc.client.duration per rpc.service / rpc.method.
+    bool method_histograms = true;
+
+    bool operator==(const ProxyGrpcConfig& o) const {
+        return enabled == o.enabled &&
+               retry_on == o.retry_on &&
+               breaker_failure_on == o.breaker_failure_on &&
+               propagate_timeout == o.propagate_timeout &&
+               max_timeout_ms == o.max_timeout_ms &&
+               max_message_bytes == o.max_message_bytes &&
+               method_histograms == o.method_histograms;
+    }
+    bool operator!=(const ProxyGrpcConfig& o) const { return !(*this == o); }
+};
+
+// Request coalescing for a proxy route (proxy.singleflight). Concurrent
+// identical GET/HEAD requests share one upstream transaction and the
+// response is multicast to every waiter.
+struct ProxySingleflightConfig {
+    bool enabled = false;
+    // Request headers (case-insensitive) that are part of the coalescing
+    // key in addition to method, path and query. Requests carrying
+    // Authorization, Cookie or Range are only coalesced when that header
+    // is listed here.
+    std::vector<std::string> key_headers;
+    // Streamed body bytes retained for replay to requests that join
+    // after the response has started. Past this the flight stops
+    // accepting joiners. Must be >= 0.
+    int64_t max_replay_bytes = 1048576;
+
+    bool operator==(const ProxySingleflightConfig& o) const {
+        return enabled == o.enabled &&
+               key_headers == o.key_headers &&
+               max_replay_bytes == o.max_replay_bytes;
+    }
+    bool operator!=(const ProxySingleflightConfig& o) const { return !(*this == o); }
+};
+
 struct ProxyConfig {
     // Response relay mode:
     //   auto   = choose at runtime from framing / content type / size
@@ -231,6 +486,24 @@ struct ProxyConfig {
     // HTTP/1.1 chunked streaming can emit them; HTTP/2 currently warns and
     // drops them because trailer submission is not wired yet.
     bool forward_trailers = false;
+    // 103 Early Hints (RFC 8297). `early_hints` lists Link field values
+    // (e.g. "</app.css>; rel=preload; as=style") sent to the client as a
+    // 103 as soon as the request passes middleware, before the upstream
+    // is contacted. `relay_early_hints` forwards the Link fields of any
+    // 103 the upstream itself sends while the final response is pending.
+    std::vector<std::string> early_hints;
+    bool relay_early_hints = false;
+
+    // Forward WebSocket upgrades on this route to the upstream instead of
+    // answering 404. The upstream's 101 is relayed to the client and the
+    // two sockets are spliced byte-for-byte until either side closes.
+    // relay_buffer_limit_bytes bounds each direction's unsent backlog.
+    bool websocket = false;
+
+    // Serve GET/HEAD responses on this route from the shared response
+    // cache (top-level `proxy_cache`) when the upstream marks them
+    // cacheable. No effect unless proxy_cache.enabled is set.
+    bool cache = false;
 
     // Response timeout: max time to wait for upstream response headers
     // after request is fully sent. 0 = disabled (no deadline). Otherwise
@@ -256,6 +529,16 @@ struct ProxyConfig {
     // Retry policy configuration
     ProxyRetryConfig retry;
 
+    // gRPC-aware proxying (grpc-status retry/breaker classification,
+    // grpc-timeout deadline propagation, message framing, per-method
+    // latency histograms).
+    ProxyGrpcConfig grpc;
+
+    // Coalesce concurrent identical GET/HEAD requests onto one upstream
+    // transaction. Ignored on routes with `cache` set, whose misses are
+    // already collapsed by the response cache.
+    ProxySingleflightConfig singleflight;
+
     // Inline auth policy for this proxy (applies_to derived from route_prefix).
     // Reload-propagated via AuthManager::Reload — EXCLUDED from operator==
     // below so that proxy.auth edits do not trip the outer "restart required"
@@ -267,7 +550,8 @@ struct ProxyConfig {
     // Excludes `auth` — auth policy edits are live-reloadable via
     // `AuthManager::Reload`, which `HttpServer::Reload` invokes on every
     // reload. Topology fields (response_timeout_ms, route_prefix,
-    // strip_prefix, methods, header_rewrite, retry) remain restart-only.
+    // strip_prefix, methods, header_rewrite, retry, grpc) remain
+    // restart-only.
     //
     // Contract: a config pair that differs ONLY in auth fields must compare
     // EQUAL so the outer reload doesn't fire a spurious warn. This is the
@@ -282,16 +566,65 @@ struct ProxyConfig {
                stream_max_duration_sec == o.stream_max_duration_sec &&
                h10_streaming == o.h10_streaming &&
                forward_trailers == o.forward_trailers &&
+               early_hints == o.early_hints &&
+               relay_early_hints == o.relay_early_hints &&
+               websocket == o.websocket &&
+               cache == o.cache &&
                response_timeout_ms == o.response_timeout_ms &&
                route_prefix == o.route_prefix &&
                strip_prefix == o.strip_prefix &&
                methods == o.methods &&
                header_rewrite == o.header_rewrite &&
-               retry == o.retry;
+               retry == o.retry &&
+               grpc == o.grpc &&
+               singleflight == o.singleflight;
     }
     bool operator!=(const ProxyConfig& o) const { return !(*this == o); }
 };
 
+// Passive outlier detection across a multi-endpoint upstream. Nested in
+// CircuitBreakerConfig: it acts only while the breaker is enabled, shares
+// its dry_run switch, reads the breaker's sliding window, and reloads
+// live with it. Each detector below is off at 0.
+struct OutlierDetectionConfig {
+    bool enabled = false;
+    int interval_ms = 10000;               // Statistical sweep period
+
+    // Eject after N consecutive failures (5xx / connect / timeout).
+    int consecutive_5xx = 5;
+
+    // Ejection time = base * times_ejected, capped at max. times_ejected
+    // decays by one for each sweep the endpoint spends back in rotation.
+    int base_ejection_time_ms = 30000;
+    int max_ejection_time_ms = 300000;
+
+    // Statistical detectors consider only endpoints with at least
+    // `request_volume` outcomes in the window, and run only when at
+    // least `minimum_hosts` endpoints qualify.
+    int minimum_hosts = 3;
+    int request_volume = 100;
+    // Eject when success rate < mean - stdev * (factor / 1000).
+    int success_rate_stdev_factor = 1900;
+    // Eject when p99 latency > median endpoint p99 * percent / 100 and
+    // exceeds latency_p99_min_ms.
+    int latency_p99_factor_percent = 300;
+    int latency_p99_min_ms = 50;
+
+    bool operator==(const OutlierDetectionConfig& o) const {
+        return enabled == o.enabled &&
+               interval_ms == o.interval_ms &&
+               consecutive_5xx == o.consecutive_5xx &&
+               base_ejection_time_ms == o.base_ejection_time_ms &&
+               max_ejection_time_ms == o.max_ejection_time_ms &&
+               minimum_hosts == o.minimum_hosts &&
+               request_volume == o.request_volume &&
+               success_rate_stdev_factor == o.success_rate_stdev_factor &&
+               latency_p99_factor_percent == o.latency_p99_factor_percent &&
+               latency_p99_min_ms == o.latency_p99_min_ms;
+    }
+    bool operator!=(const OutlierDetectionConfig& o) const { return !(*this == o); }
+};
+
 struct CircuitBreakerConfig {
     bool enabled = false;                      // Opt-in; off by default
     bool dry_run = false;                      // Compute + log, but do not reject
@@ -310,8 +643,10 @@ struct CircuitBreakerConfig {
     int base_open_duration_ms = 5000;
     int max_open_duration_ms = 60000;
 
-    // Safety valve (future-proof for load-balanced services; no-op v1).
+    // Upper bound on the share of a multi-endpoint upstream that outlier
+    // detection may hold out of rotation at once.
     int max_ejection_percent_per_host_set = 50;
+    OutlierDetectionConfig outlier_detection;
 
     // Retry budget (orthogonal to the breaker). Caps concurrent retries to
     // max(retry_budget_min_concurrency, in_flight * retry_budget_percent/100).
@@ -332,6 +667,7 @@ struct CircuitBreakerConfig {
                base_open_duration_ms == o.base_open_duration_ms &&
                max_open_duration_ms == o.max_open_duration_ms &&
                max_ejection_percent_per_host_set == o.max_ejection_percent_per_host_set &&
+               outlier_detection == o.outlier_detection &&
                retry_budget_percent == o.retry_budget_percent &&
                retry_budget_min_concurrency == o.retry_budget_min_concurrency;
     }
@@ -342,6 +678,12 @@ struct UpstreamConfig {
     std::string name;
     std::string host;
     int port = 80;
+    // Backends to balance across. Empty means the single `host`:`port`.
+    // When set, `host`/`port` stay the upstream's identity (Host header,
+    // SNI fallback) and default to the first entry.
+    std::vector<UpstreamEndpointConfig> endpoints;
+    LoadBalancerConfig load_balancer;
+    UpstreamHealthCheckConfig health_check;
     UpstreamTlsConfig tls;
     UpstreamPoolConfig pool;
     ProxyConfig proxy;
@@ -352,11 +694,22 @@ struct UpstreamConfig {
     // may pin to Buffered via config. Restart-only — see operator==.
     http::RouteRequestMode request_mode = http::RouteRequestMode::Streaming;
 
+    // The endpoints the pools connect to: `endpoints`, or the single
+    // `host`:`port` when no list is configured.
+    std::vector<UpstreamEndpointConfig> EffectiveEndpoints() const {
+        if (!endpoints.empty()) return endpoints;
+        UpstreamEndpointConfig single;
+        single.host = host;
+        single.port = port;
+        return {single};
+    }
+
     // Excludes `circuit_breaker` — breaker fields are live-reloadable via
     // `CircuitBreakerManager::Reload`, which `HttpServer::Reload` invokes on
-    // every reload. Topology fields (name, host, port, tls, pool,
-    // proxy) remain restart-only; a mismatch here triggers the
-    // "restart required" warning in the outer reload.
+    // every reload. Topology fields (name, host, port, endpoints,
+    // load_balancer, health_check, tls, pool, proxy) remain restart-only;
+    // a mismatch here triggers the "restart required" warning in the
+    // outer reload.
     //
     // H2 live fields (ping timers, window sizes, etc.) are propagated via
     // CommitHttp2Snapshots (wired into both MarkServerReady and Reload).
@@ -369,6 +722,8 @@ struct UpstreamConfig {
     // at startup via RegisterProxyRoutes.
     bool operator==(const UpstreamConfig& o) const {
         return name == o.name && host == o.host && port == o.port &&
+               endpoints == o.endpoints && load_balancer == o.load_balancer &&
+               health_check == o.health_check &&
                tls == o.tls && pool == o.pool && proxy == o.proxy &&
                http2.LiveEqual(o.http2) &&
                request_mode == o.request_mode;
@@ -407,6 +762,36 @@ struct RateLimitConfig {
     bool operator!=(const RateLimitConfig& o) const { return !(*this == o); }
 };
 
+// Shared RFC 9111 response cache in front of proxy routes that set
+// proxy.cache. Restart-only: the store is sized once at startup.
+struct ProxyCacheConfig {
+    bool enabled = false;
+    // Byte budget for stored responses held in memory (headers + body).
+    int64_t memory_max_bytes = 67108864;      // 64 MiB
+    // Directory for the mmap'd disk tier. Entries evicted from memory
+    // move here until disk_max_bytes is reached. Empty = memory only.
+    std::string disk_path;
+    int64_t disk_max_bytes = 1073741824;      // 1 GiB
+    // Responses with a larger body are relayed but never stored.
+    int64_t max_object_bytes = 8388608;       // 8 MiB
+    // Cap on stored URLs per tier, across all variants of each.
+    int max_entries = 100000;
+    // Concurrent misses on one key wait for the first request's
+    // response instead of all going to the upstream.
+    bool collapse_requests = true;
+
+    bool operator==(const ProxyCacheConfig& o) const {
+        return enabled == o.enabled &&
+               memory_max_bytes == o.memory_max_bytes &&
+               disk_path == o.disk_path &&
+               disk_max_bytes == o.disk_max_bytes &&
+               max_object_bytes == o.max_object_bytes &&
+               max_entries == o.max_entries &&
+               collapse_requests == o.collapse_requests;
+    }
+    bool operator!=(const ProxyCacheConfig& o) const { return !(*this == o); }
+};
+
 // NOTE: When adding fields, also update ConfigLoader::LoadFromString(),
 // ConfigLoader::ToJson(), ConfigLoader::ApplyEnvOverrides(), and
 // ConfigLoader::Validate() to keep serialization/deserialization in sync.
@@ -448,8 +833,11 @@ struct ServerConfig {
     int shutdown_drain_timeout_sec = 30;
     Http2Config http2;
     Http1Config http1;
+    Http3Config http3;
+    WebSocketConfig websocket;
     std::vector<UpstreamConfig> upstreams;
     RateLimitConfig rate_limit;
+    ProxyCacheConfig proxy_cache;
     AUTH_NAMESPACE::AuthConfig auth;
     NET_DNS_NAMESPACE::DnsConfig dns;
     OBSERVABILITY_NAMESPACE::ObservabilityConfig observability;
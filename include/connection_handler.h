@@ -26,6 +26,12 @@ private:
     std::atomic<bool> is_closing_{false};
     std::atomic<bool> close_after_write_{false};
 
+    // Userspace TCP_CORK (see CorkUntilLoopEnd). Dispatcher-thread-only.
+    bool corked_ = false;
+    // Corked bytes are written early (with MSG_MORE) once they reach this
+    // size, so a bulk producer streams instead of piling up until loop end.
+    static constexpr size_t CORK_FLUSH_BYTES = 65536;
+
     // Opt-in flag for the graceful-shutdown close sweep in NetServer::Stop().
     // A higher layer (e.g. HttpConnectionHandler during an async response
     // cycle) sets this to true so the sweep skips CloseAfterWrite and lets
@@ -75,6 +81,10 @@ private:
     bool tls_read_wants_write_ = false;
     bool tls_write_wants_read_ = false;
     size_t tls_pending_write_size_ = 0;  // Size of pending SSL_write for retry
+    // Kernel TLS send offload is active on this socket: every write path
+    // sends plaintext on the fd (as with TlsState::NONE) and the kernel
+    // frames and encrypts it. Reads still go through TlsConnection::Read.
+    bool ktls_send_ = false;
 
     // Cap on input buffer accumulation during the ET read loop.
     // Prevents allocating far beyond configured limits (max_body_size, etc.)
@@ -132,6 +142,15 @@ private:
     const char* http_protocol_label_ = nullptr;
     OBSERVABILITY_NAMESPACE::UpDownCounter* http_active_counter_  = nullptr;
     OBSERVABILITY_NAMESPACE::Counter*       tls_handshakes_counter_ = nullptr;
+    // Handshakes parked on an offloaded private-key operation. The latch
+    // keeps +1/-1 paired across resumes, failures and destruction.
+    OBSERVABILITY_NAMESPACE::UpDownCounter* tls_key_ops_queued_counter_ = nullptr;
+    bool tls_key_op_waiting_ = false;
+    void SetTlsKeyOpWaiting(bool waiting);
+    // Records written, by record-size class (dynamic record sizing).
+    OBSERVABILITY_NAMESPACE::Counter*       tls_records_counter_ = nullptr;
+    // tls_->Write plus record accounting; every TLS write path goes here.
+    int TlsWrite(const char* buf, size_t len);
 public:
     ConnectionHandler() = delete;
     ConnectionHandler(std::shared_ptr<Dispatcher>, std::unique_ptr<SocketHandler>);
@@ -171,6 +190,11 @@ public:
 
     void SendRaw(const char*, size_t);
     void DoSendRaw(const char*, size_t);  // Internal: appends without length header (in socket thread)
+    // Write whatever output_bf_ holds through the direct-send path (plain
+    // send or SSL_write); falls back to EPOLLOUT on partial write. `more`
+    // marks a mid-batch flush (MSG_MORE on plain TCP).
+    void FlushOutputBuffer(bool more);
+    void Uncork();
 
     void CallCloseCb();
     void ForceClose();  // Bypass close_after_write defer — for stalled flush recovery
@@ -189,6 +213,9 @@ public:
     void SetErrorCb(CALLBACKS_NAMESPACE::ConnErrorCallback);
 
     void SetTlsConnection(std::unique_ptr<TlsConnection> tls);
+    // Continue a handshake whose offloaded key operation finished.
+    // Dispatcher-thread only; posted by the TlsConnection resume callback.
+    void ResumeTlsHandshake();
     void SetMaxInputSize(size_t max) { max_input_size_ = max; }
     // Clear transport-level flags so a pooled connection returning to idle
     // cannot carry stale backpressure / cap-stop state into the next checkout.
@@ -198,6 +225,17 @@ public:
         close_on_resume_.store(false, std::memory_order_release);
         has_pending_reads_.store(false, std::memory_order_release);
     }
+    // Coalesce SendRaw output until the end of the current dispatcher loop
+    // iteration, then write it in one send / SSL_write. Small frames
+    // produced by several callbacks in one iteration leave as one TCP
+    // segment train and full-size TLS records instead of one syscall and
+    // one record each. Corked bytes count toward OutputBufferSize(), so
+    // drain / watermark checks see them; CloseAfterWrite flushes them
+    // before closing. Idempotent; no-op (stays uncorked) off the
+    // dispatcher thread or while closing.
+    void CorkUntilLoopEnd();
+    bool IsCorked() const { return corked_; }
+
     // Dispatcher-thread-only for reuse validation.
     size_t InputBufferSize() const { return input_bf_.Size(); }
     size_t OutputBufferSize() const { return output_bf_.Size(); }
@@ -228,6 +266,9 @@ public:
     bool HasTls() const { return tls_state_ != TlsState::NONE; }
     // Returns true if TLS is fully established (handshake complete).
     bool IsTlsReady() const { return tls_state_ == TlsState::READY; }
+    // True when the kernel encrypts this socket's writes (kTLS), so the fd
+    // can be written directly — including by sendfile / splice.
+    bool IsKtlsSend() const { return ktls_send_; }
 
     // Non-destructive TLS peek for idle connection validation.
     // Returns: >0 (app data buffered — stale), TLS_COMPLETE (clean — benign
@@ -252,6 +293,10 @@ public:
     // Returns empty string if no TLS or ALPN not negotiated.
     std::string GetAlpnProtocol() const;
 
+    // True when the completed TLS handshake resumed a session. False
+    // without TLS or before the handshake is READY.
+    bool IsTlsSessionReused() const;
+
     // One-shot — fires exactly once when the TLS handshake transitions
     // to READY, then is cleared. Used by the H2 upstream codec to
     // inspect ALPN at the moment of completion. Capture weak_ptr in
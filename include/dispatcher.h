@@ -52,6 +52,12 @@ private:
     std::priority_queue<DelayedTask, std::vector<DelayedTask>,
                         std::greater<DelayedTask>> delayed_tasks_;
 
+    // EnQueueAtLoopEnd tasks. Loop-thread-only — no lock. Drained by
+    // RunLoopEndTasks() at the tail of every RunEventLoop iteration and of
+    // ProcessPendingTasks().
+    std::vector<std::function<void()>> loop_end_tasks_;
+    void RunLoopEndTasks();
+
     // Wall-clock gate for the opportunistic task_que_ drain in the
     // channels.size()==0 path. Ensures EnQueueDeferred users get ~1s
     // cadence even when delayed tasks shorten the WaitForEvent timeout.
@@ -133,6 +139,15 @@ public:
     // error response — since the callback will never fire.
     bool EnQueueDelayed(std::function<void()> fn,
                         std::chrono::milliseconds delay);
+    // Run `fn` at the end of the current event-loop iteration — after every
+    // ready channel, queued task and expired delayed task has been handled,
+    // before the next WaitForEvent. Used to coalesce output produced by
+    // several callbacks in one iteration into a single write (see
+    // ConnectionHandler::CorkUntilLoopEnd). Loop-thread-only: returns false
+    // (task dropped) when called off the loop thread or after stop, so the
+    // caller can fall back to doing the work inline. Same lifetime contract
+    // as EnQueue — capture weak_ptr / shared_ptr, never raw `this`.
+    bool EnQueueAtLoopEnd(std::function<void()> fn);
     void AddConnection(std::shared_ptr<ConnectionHandler>);
     void RemoveTimerConnection(int fd);
     void RemoveTimerConnectionIfMatch(int fd, std::shared_ptr<ConnectionHandler> conn);
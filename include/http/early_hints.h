@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common.h"
+#include "http/http_callbacks.h"
+// <string>, <vector> provided by common.h
+
+// 103 Early Hints (RFC 8297) helpers.
+//
+// Early Hints replace HTTP/2 server push (include/http/push_helper.h) as
+// the way to get critical subresources moving while a slow handler or
+// upstream is still working: instead of the server guessing and pushing
+// bytes, it tells the client which resources to preload and lets the
+// client's cache decide. Works on HTTP/1.1 and HTTP/2 (HTTP/1.0 clients
+// never see 1xx responses — the connection layer drops them).
+//
+// Three ways to emit them:
+//   - Declaratively, per route: RouteOptions::early_hints. The server
+//     sends one 103 after middleware has accepted the request and before
+//     the async handler (or proxy) is invoked.
+//   - From an async handler: Send(send_interim, links) with the handler's
+//     InterimResponseSender, any time before complete() / SendHeaders().
+//   - From a proxy: ProxyConfig::relay_early_hints forwards the Link
+//     fields of upstream 103 responses (see ProxyTransaction).
+//
+// Namespace naming: UPPER_SNAKE_CASE per CODE_CONVENTIONS.md, sibling of
+// HTTP2_PUSH_NAMESPACE.
+namespace HTTP_EARLY_HINTS_NAMESPACE {
+
+// One preload target. Rendered as an RFC 8288 Link field value, e.g.
+//   </app.css>; rel=preload; as=style
+struct PreloadLink {
+    std::string uri;               // required; emitted inside <...>
+    std::string rel = "preload";   // "preload" or "preconnect" in practice
+    std::string as;                // destination: style, script, font, image...
+    std::string type;              // optional MIME type hint
+    std::string crossorigin;       // "", "anonymous" or "use-credentials"
+};
+
+// Render a PreloadLink as a Link field value. Returns "" when the link is
+// not representable (empty uri, or any field containing '<', '>', '"',
+// CR, LF or NUL).
+std::string FormatLinkValue(const PreloadLink& link);
+
+// True when `value` is a single well-formed Link field value suitable for
+// a 103: starts with "<uri>", no CR / LF / NUL, bounded length. Used by
+// config validation and by Send() to drop malformed entries.
+bool IsValidLinkValue(const std::string& value);
+
+// Build the header list for a 103 from Link field values. Invalid entries
+// are skipped; one `Link` header per value.
+std::vector<std::pair<std::string, std::string>> BuildHeaders(
+    const std::vector<std::string>& link_values);
+
+// Keep only the fields of an upstream 103 that are safe to relay: `link`
+// headers whose value passes IsValidLinkValue. Everything else (cookies,
+// custom headers, hop-by-hop fields) is dropped so the relay cannot be
+// used to smuggle fields ahead of the final response.
+std::vector<std::pair<std::string, std::string>> FilterRelayableHeaders(
+    const std::vector<std::pair<std::string, std::string>>& upstream_headers);
+
+// Emit a 103 through an async handler's InterimResponseSender. Returns
+// false (and sends nothing) when `send_interim` is empty or no value is
+// valid. Same threading contract as the sender itself — callable from any
+// thread before the final response is claimed.
+bool Send(const HTTP_CALLBACKS_NAMESPACE::InterimResponseSender& send_interim,
+          const std::vector<std::string>& link_values);
+
+// Upper bound on a single Link value accepted by IsValidLinkValue.
+inline constexpr size_t MAX_LINK_VALUE_LENGTH = 2048;
+
+}  // namespace HTTP_EARLY_HINTS_NAMESPACE
@@ -86,6 +86,25 @@ namespace HTTP_CALLBACKS_NAMESPACE {
     // in WS upgrade to prevent upgrades that slipped past the early check.
     using HttpConnShutdownCheckCallback = std::function<bool()>;
 
+    // Claims a validated WS upgrade for a WebSocket proxy route. Returns
+    // false (without side effects) when the path is not a tunnel route.
+    // On true the callee owns the handshake: it must eventually call
+    // HttpConnectionHandler::CompleteWsTunnel on the dispatcher thread.
+    using HttpConnWsTunnelCallback = std::function<bool(
+        std::shared_ptr<HttpConnectionHandler> self,
+        HttpRequest& request
+    )>;
+
+    // Raw relay hooks installed on the downstream connection once the
+    // upstream has answered 101. `on_data` receives every client byte,
+    // `on_drain` reports the client output buffer after a write, and
+    // `on_close` fires once when the client transport goes away.
+    struct HttpConnWsTunnelHooks {
+        std::function<void(std::string& data)> on_data;
+        std::function<void(size_t remaining_bytes)> on_drain;
+        std::function<void()> on_close;
+    };
+
     struct HttpConnCallbacks {
         HttpConnRequestCallback       request_callback       = nullptr;
         HttpConnRouteCheckCallback    route_check_callback    = nullptr;
@@ -99,6 +118,9 @@ namespace HTTP_CALLBACKS_NAMESPACE {
         HttpConnUpgradeCallback       upgrade_callback       = nullptr;
         HttpConnRequestCountCallback  request_count_callback  = nullptr;
         HttpConnShutdownCheckCallback shutdown_check_callback = nullptr;
+        // WebSocket proxy routes. When null every upgrade is terminated
+        // locally.
+        HttpConnWsTunnelCallback      ws_tunnel_callback      = nullptr;
         // Route options resolver — wired by HttpServer to enable per-route
         // streaming upload dispatch. When null, all H1 uploads are buffered.
         HttpConnResolveRouteOptionsCallback resolve_route_options_callback = nullptr;
@@ -192,6 +214,12 @@ namespace HTTP_CALLBACKS_NAMESPACE {
     using WsMessageCallback = std::function<void(
         WebSocketConnection& ws, const std::string& message, bool is_binary
     )>;
+    // Streaming delivery: one call per piece of a message as it arrives.
+    // `is_final` is set on the last piece (which may be empty).
+    using WsMessageChunkCallback = std::function<void(
+        WebSocketConnection& ws, const std::string& chunk, bool is_binary,
+        bool is_final
+    )>;
     using WsCloseCallback = std::function<void(
         WebSocketConnection& ws, uint16_t code, const std::string& reason
     )>;
@@ -204,6 +232,7 @@ namespace HTTP_CALLBACKS_NAMESPACE {
 
     struct WsCallbacks {
         WsMessageCallback message_callback = nullptr;
+        WsMessageChunkCallback chunk_callback = nullptr;
         WsCloseCallback   close_callback   = nullptr;
         WsPingCallback    ping_callback    = nullptr;
         WsErrorCallback   error_callback   = nullptr;
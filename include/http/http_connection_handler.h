@@ -32,6 +32,7 @@ public:
     void SetUpgradeCallback(UpgradeCallback callback);
     void SetRequestCountCallback(HTTP_CALLBACKS_NAMESPACE::HttpConnRequestCountCallback callback);
     void SetShutdownCheckCallback(HTTP_CALLBACKS_NAMESPACE::HttpConnShutdownCheckCallback callback);
+    void SetWsTunnelCallback(HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelCallback callback);
 
     // Configure inbound streaming-request body watermarks. Read at
     // headers-complete time by the HeadersCompleteCallback when constructing
@@ -121,6 +122,26 @@ public:
     bool LegacyH1StatsDecremented() const { return legacy_h1_decremented_; }
     void MarkLegacyH1StatsDecremented() { legacy_h1_decremented_ = true; }
 
+    // WebSocket proxy tunnel. The tunnel callback calls BeginWsTunnel
+    // once it claims an upgrade: the connection enters the deferred
+    // window (client bytes are stashed, the socket is exempt from the
+    // shutdown sweep) and `on_abort` runs if the client drops before
+    // the upstream answers. CompleteWsTunnel delivers that answer on the
+    // dispatcher thread: a 101 with `hooks.on_data` set switches the
+    // connection to raw relay mode and replays the stashed bytes into
+    // on_data; anything else is sent with Connection: close.
+    // `error_type` labels the SERVER span ("" on success).
+    void BeginWsTunnel(const HttpRequest& req, std::function<void()> on_abort);
+    void CompleteWsTunnel(HttpResponse response,
+                          HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelHooks hooks,
+                          const std::string& error_type);
+    bool IsWsTunnel() const {
+        return upgraded_ && static_cast<bool>(ws_tunnel_hooks_.on_data);
+    }
+    // Fire the tunnel's on_close hook once. Called from
+    // HttpServer::SafeNotifyWsClose when the client transport goes away.
+    void NotifyWsTunnelClose();
+
     // Access WebSocket connection (nullptr if not upgraded)
     WebSocketConnection* GetWebSocket() { return ws_conn_.get(); }
 
@@ -136,6 +157,13 @@ public:
     void SetMaxBodySize(size_t max);
     void SetMaxHeaderSize(size_t max);
     void SetMaxWsMessageSize(size_t max) { max_ws_message_size_ = max; }
+    // permessage-deflate for WS upgrades on this connection. The budget
+    // is shared server-wide; config.enabled == false leaves it off.
+    void SetWsDeflate(const WebSocketDeflateConfig& config,
+                      std::shared_ptr<WebSocketDeflateBudget> budget) {
+        ws_deflate_config_ = config;
+        ws_deflate_budget_ = std::move(budget);
+    }
 
     // Update all size limits on an existing connection during live reload.
     // Must be called on the connection's dispatcher thread (via RunOnDispatcher).
@@ -264,6 +292,8 @@ private:
     size_t max_body_size_ = 0;    // 0 = unlimited
     size_t max_header_size_ = 0;  // 0 = unlimited
     size_t max_ws_message_size_ = 0; // 0 = unlimited
+    WebSocketDeflateConfig ws_deflate_config_;
+    std::shared_ptr<WebSocketDeflateBudget> ws_deflate_budget_;
     int request_timeout_sec_ = 0; // 0 = disabled
     int max_async_deferred_sec_ = 0;  // 0 = disabled (no safety cap)
 
@@ -374,7 +404,11 @@ private:
     // Dispatcher-thread-only flag (no atomic needed). See
     // LegacyH1StatsDecremented() docstring above for the contract.
     bool legacy_h1_decremented_ = false;
-    std::unique_ptr<WebSocketConnection> ws_conn_;
+    // shared_ptr so WebSocketBroadcaster subscriptions can hold weak refs.
+    std::shared_ptr<WebSocketConnection> ws_conn_;
+    // Relay hooks of a proxied WebSocket (see CompleteWsTunnel). Set
+    // instead of ws_conn_; cleared by NotifyWsTunnelClose.
+    HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelHooks ws_tunnel_hooks_;
 
     // Deferred-response state — dispatcher-thread only, no atomics needed.
     // Populated by BeginAsyncResponse and consumed by CompleteAsyncResponse.
@@ -33,10 +33,10 @@ struct HttpRequest {
     // max_body_size enforcement on streaming routes (cumulative bytes
     // pushed to body_stream).
     size_t pushed_body_bytes = 0;
-    // RESERVED: per-request upstream deadline override (ms). 0 → use
-    // ProxyConfig default. Intended for the gRPC grpc-timeout decorator
-    // path; no middleware writes this today, and ProxyTransaction does
-    // not read it. Kept as the API surface for the eventual gRPC wiring.
+    // Per-request upstream deadline override (ms). 0 → use ProxyConfig
+    // default. Middleware may set it; ProxyTransaction also derives it
+    // from `grpc-timeout` when proxy.grpc.propagate_timeout is on. Counts
+    // from request start and spans retries.
     int upstream_deadline_override_ms = 0;
     bool keep_alive = true;
     bool upgrade = false;         // Connection: Upgrade (for WebSocket)
@@ -251,6 +251,14 @@ public:
     http::RouteOptions ResolveOptionsAtHeaders(const std::string& method,
                                                 const std::string& path) const;
 
+    // Route-declared 103 Early Hints for an async-trie match. `pattern`
+    // is the matched_pattern_out of GetAsyncHandler; on HEAD→GET fallback
+    // the GET route's hints apply. Returns an empty list (no lookup) when
+    // no route declared hints, so the per-request cost is one branch.
+    const std::vector<std::string>& GetEarlyHints(
+        const std::string& method, bool head_fallback,
+        const std::string& pattern) const;
+
     // Returns true iff (method, pattern) was registered via
     // RouteProxyAsync. ResolveRouteMatch consults this at step (2) to
     // demux an async-trie hit between Async and Proxy classification.
@@ -537,6 +545,9 @@ private:
     // on miss).
     std::unordered_map<std::string,
         std::unordered_map<std::string, http::RouteOptions>> route_options_;
+    // Set at registration when any RouteOptions carries early_hints;
+    // gates the per-request GetEarlyHints lookup.
+    bool has_early_hints_ = false;
 
     // Normalized-pattern keys for async routes, tracked per method.
     // Each registered pattern is reduced to a "semantic shape" key
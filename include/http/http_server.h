@@ -5,6 +5,8 @@
 #include "http/http_connection_handler.h"
 #include "http2/http2_connection_handler.h"
 #include "http2/protocol_detector.h"
+#include "http3/http3_listener.h"
+#include "ws/websocket_broadcast.h"
 #include "config/server_config.h"
 #include "net/dns_resolver.h"
 #include "tls/tls_context.h"
@@ -17,6 +19,8 @@
 // Forward declarations for upstream pool and proxy
 class UpstreamManager;
 class ProxyHandler;
+class ResponseCache;
+struct WsTunnelContext;
 
 namespace CIRCUIT_BREAKER_NAMESPACE {
 class CircuitBreakerManager;
@@ -45,6 +49,18 @@ public:
         int idle_timeout_sec = 0;
         int request_timeout_sec = 0;
         int worker_threads = 0;  // resolved from auto mode
+        // Proxied WebSocket tunnels (proxy.websocket routes)
+        int64_t ws_tunnels_active = 0;
+        int64_t ws_tunnels_total = 0;
+        int64_t ws_tunnel_bytes_to_upstream = 0;
+        int64_t ws_tunnel_bytes_to_client = 0;
+        // TLS handshake key offload (tls.handshake_offload_threads);
+        // all zero when offload is off.
+        int tls_offload_threads = 0;
+        int64_t tls_offload_submitted = 0;
+        int64_t tls_offload_completed = 0;
+        int64_t tls_offload_cancelled = 0;
+        int64_t tls_offload_in_flight = 0;
     };
 
     // Construct with explicit host/port. Delegates to the config ctor,
@@ -85,6 +101,10 @@ public:
     void Delete(const std::string& path, HttpRouter::Handler handler);
     void Route(const std::string& method, const std::string& path, HttpRouter::Handler handler);
     void WebSocket(const std::string& path, HttpRouter::WsUpgradeHandler handler);
+    // Server-wide topic registry for WebSocket fan-out. Subscribe from
+    // the upgrade handler or a message callback; Broadcast*() may be
+    // called from any thread.
+    WebSocketBroadcaster& Broadcaster() { return ws_broadcaster_; }
     void Use(HttpRouter::Middleware middleware);
 
     // Install an async middleware on the router. Mirrors the gating
@@ -248,6 +268,18 @@ public:
     // Returns the actual port the server is listening on.
     int GetBoundPort() const;
 
+    // UDP port of the experimental HTTP/3 listener, or 0 when http3 is
+    // disabled / not started. Valid once IsReady() is true.
+    int GetHttp3BoundPort() const {
+        return http3_listener_ ? http3_listener_->GetBoundPort() : 0;
+    }
+    // Listener counters (datagrams, batches, requests); nullopt when the
+    // HTTP/3 listener is not running.
+    std::optional<Http3Listener::Stats> GetHttp3Stats() const {
+        if (!http3_listener_) return std::nullopt;
+        return http3_listener_->GetStats();
+    }
+
     // Access the upstream pool manager for proxy handlers.
     // Returns nullptr if no upstreams configured, not started, or stopped.
     // Reachable while ready OR during the graceful shutdown drain window.
@@ -561,6 +593,33 @@ private:
     bool DetectAndRouteProtocol(std::shared_ptr<ConnectionHandler> conn,
                                 std::string& message, bool already_counted);
 
+    // Experimental HTTP/3 (UDP) listener. Built in MarkServerReady once the
+    // socket dispatchers exist; null when http3.enabled is false or the
+    // bind failed (logged, server keeps serving TCP). Closed in Stop()
+    // next to StopAccepting; destroyed with the server, after the
+    // dispatcher threads that run its callbacks have been joined.
+    Http3Config http3_config_;
+    std::unique_ptr<Http3Listener> http3_listener_;
+
+    // permessage-deflate for inbound WebSocket upgrades (restart-only).
+    // The budget caps zlib state across every WS connection on this
+    // server; each upgrade reserves against it in the connection handler.
+    WebSocketDeflateConfig ws_deflate_config_;
+    std::shared_ptr<WebSocketDeflateBudget> ws_deflate_budget_;
+
+    // Topic registry behind Broadcaster(). Holds only weak refs to
+    // connections; pending deliveries own the shared registry state, so
+    // destruction order against the dispatchers doesn't matter.
+    WebSocketBroadcaster ws_broadcaster_;
+
+    void StartHttp3Listener();
+    // Router / middleware / async-handler dispatch for one HTTP/3 request.
+    // Mirrors the H1/H2 request callbacks minus the connection-level
+    // bookkeeping (no keep-alive, pipelining or per-stream abort hooks —
+    // each request stands alone).
+    void HandleHttp3Request(HttpRequest& request,
+                            Http3Listener::ResponseCallback respond);
+
     // Upstream connection pool
     std::vector<UpstreamConfig> upstream_configs_;
     std::unique_ptr<UpstreamManager> upstream_manager_;
@@ -579,6 +638,12 @@ private:
     RateLimitConfig rate_limit_config_;
     std::unique_ptr<RateLimitManager> rate_limit_manager_;
 
+    // Proxy response cache — built in MarkServerReady when
+    // proxy_cache.enabled, shared by every ProxyHandler whose route sets
+    // proxy.cache. Handlers hold their own reference.
+    ProxyCacheConfig proxy_cache_config_;
+    std::shared_ptr<ResponseCache> response_cache_;
+
     // Auth — cached config from construction (used to build the manager
     // in MarkServerReady and to supply the canonical auth source for
     // reload). AuthManager is declared AFTER circuit_breaker_manager_ so
@@ -625,6 +690,17 @@ private:
     // otherwise dangle.
     std::unordered_map<std::string, std::shared_ptr<ProxyHandler>> proxy_handlers_;
 
+    // Proxy routes with proxy.websocket enabled, keyed by the same
+    // patterns registered for GET. Consulted by the H1 upgrade path
+    // (route check + tunnel callback) only; local WebSocket() routes
+    // take precedence. Populated before Start(), read-only after.
+    RouteTrie<std::shared_ptr<ProxyHandler>> ws_proxy_trie_;
+    void RegisterWsProxyPatterns(
+        const std::unordered_set<std::string>& patterns,
+        const std::shared_ptr<ProxyHandler>& handler);
+    // Counters shared by every tunnel; outlives them via shared_ptr.
+    std::shared_ptr<WsTunnelContext> ws_tunnel_context_;
+
     // Tracks which methods are registered per canonical proxy path.
     // Key: dedup_prefix (e.g., "/api/*"), Value: set of registered methods.
     // Used to detect method-level conflicts before RouteAsync throws.
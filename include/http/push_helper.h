@@ -5,6 +5,10 @@
 
 // Synchronous HTTP/2 server push helper.
 //
+// Deprecated: browsers have removed push support. Prefer 103 Early Hints
+// (http/early_hints.h, RouteOptions::early_hints) for preloading; this
+// helper is kept for existing non-browser consumers.
+//
 // Async routes get a bound ResourcePusher closure as a parameter (see
 // HttpRouter::AsyncHandler). Sync routes have a fixed signature and
 // cannot be retrofitted with an extra parameter without churning every
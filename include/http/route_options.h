@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 namespace http {
 
 // Per-route request-handling mode. Selected at route registration time;
@@ -16,6 +19,12 @@ enum class RouteRequestMode {
 // per-route knobs (timeouts, body-size caps, etc.) extend this struct.
 struct RouteOptions {
     RouteRequestMode request_mode = RouteRequestMode::Buffered;
+    // RFC 8288 Link field values sent as one 103 Early Hints response after
+    // middleware accepts the request and before the async handler runs
+    // (e.g. "</app.css>; rel=preload; as=style"). Async and proxy routes
+    // only — a sync handler's final response follows immediately, so a
+    // hint would arrive too late to matter. Empty = no 103.
+    std::vector<std::string> early_hints;
 };
 
 }  // namespace http
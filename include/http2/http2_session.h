@@ -15,6 +15,7 @@ public:
         uint32_t max_frame_size         = HTTP2_CONSTANTS::DEFAULT_MAX_FRAME_SIZE;
         uint32_t max_header_list_size   = HTTP2_CONSTANTS::DEFAULT_MAX_HEADER_LIST_SIZE;
         bool     enable_push            = false;  // see Http2Config::enable_push
+        bool     write_batching         = true;   // see Http2Config::write_batching
     };
 
     explicit Http2Session(std::shared_ptr<ConnectionHandler> conn,
@@ -45,6 +46,10 @@ public:
     // Pull pending output bytes from nghttp2 and send via
     // ConnectionHandler::SendRaw(). Returns true if any bytes were sent.
     // MUST be called after every operation that may produce output.
+    // With Settings::write_batching the connection is corked until the end
+    // of the dispatcher iteration, so the several flushes one iteration
+    // performs (post-receive, async completions, trailers) leave the
+    // process as one write instead of one per call.
     bool SendPendingFrames();
 
     // Streaming-request consumer batching. Accumulates bytes against a
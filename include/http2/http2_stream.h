@@ -45,10 +45,36 @@ public:
     Http2Stream(Http2Stream&&) = default;
     Http2Stream& operator=(Http2Stream&&) = default;
 
-    // Header accumulation (called from nghttp2 on_header_callback).
-    // Handles pseudo-headers (:method, :path, :scheme, :authority).
-    // Returns 0 on success, -1 if the header value is invalid (e.g., bad content-length).
-    int AddHeader(const std::string& name, const std::string& value);
+    // Request header names the ingestion path branches on. Classified once
+    // per field from the raw name bytes so AddHeader never re-compares
+    // strings or builds a lowercase copy; everything else is OTHER.
+    enum class HeaderToken : uint8_t {
+        OTHER,
+        METHOD, PATH, SCHEME, AUTHORITY,           // pseudo-headers
+        HOST, COOKIE, TE,
+        CONTENT_LENGTH, CONTENT_TYPE, CONTENT_RANGE, CONTENT_DISPOSITION,
+        AUTHORIZATION,
+        CONNECTION, KEEP_ALIVE, PROXY_CONNECTION,  // RFC 9113 §8.2.2
+        TRANSFER_ENCODING, UPGRADE
+    };
+
+    // Expects a lowercase name (nghttp2 rejects uppercase request field
+    // names before on_header_callback2 runs; HPACK static-table names are
+    // lowercase by definition). A length switch plus one compare — no
+    // allocation.
+    static HeaderToken ClassifyHeaderName(std::string_view lower_name);
+
+    // Header accumulation (called from nghttp2 on_header_callback2 with
+    // views into the session's rcbufs). Handles pseudo-headers (:method,
+    // :path, :scheme, :authority). `name` must be lowercase and `token`
+    // must be ClassifyHeaderName(name). Copies into HttpRequest happen
+    // exactly once per field. Returns 0 on success, -1 if the header value
+    // is invalid (e.g., bad content-length).
+    int AddHeader(HeaderToken token, std::string_view name, std::string_view value);
+
+    // Convenience overload for callers holding mixed-case names (tests,
+    // non-nghttp2 feeders): lowercases only when needed, then classifies.
+    int AddHeader(std::string_view name, std::string_view value);
 
     // Body accumulation (called from nghttp2 on_data_chunk_recv_callback)
     void AppendBody(const char* data, size_t len);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common.h"
+// <string>, <vector>, <cstdint> provided by common.h
+
+struct HttpRequest;
+class HttpResponse;
+
+// Experimental HTTP/3 wire codec used by the UDP listener.
+//
+// Scope: this is the HTTP/3 *framing* layer only (RFC 9114 §7 frames,
+// RFC 9000 §16 variable-length integers, and the literal-only subset of
+// QPACK from RFC 9204 §4.5.6). There is no QUIC transport underneath —
+// no handshake, packet protection, loss recovery or congestion control.
+// Each request travels in a single datagram wrapped in a minimal stream
+// envelope (request id + offset + FIN), and responses are split across as
+// many datagrams as needed. Good enough to exercise the router/proxy path
+// over UDP on loopback; NOT interoperable with real HTTP/3 clients.
+namespace HTTP3_CODEC {
+
+// Frame types (RFC 9114 §7.2). Only DATA and HEADERS carry meaning here;
+// every other type is skipped on receive per §9 (extensibility).
+inline constexpr uint64_t FRAME_DATA    = 0x00;
+inline constexpr uint64_t FRAME_HEADERS = 0x01;
+
+// Envelope flag: last datagram of this request/response.
+inline constexpr uint8_t ENVELOPE_FLAG_FIN = 0x01;
+
+// Largest UDP payload the codec will ever produce or accept (IPv4 limit).
+inline constexpr size_t MAX_DATAGRAM_PAYLOAD = 65507;
+
+// QUIC variable-length integer (RFC 9000 §16). Values above 2^62-1 are
+// not representable; AppendVarint clamps them to the 8-byte form's max.
+void AppendVarint(uint64_t value, std::string& out);
+// Returns the number of bytes consumed, or 0 on truncated input.
+size_t DecodeVarint(const uint8_t* data, size_t len, uint64_t& out);
+
+// Per-datagram stream envelope: [varint request_id][varint offset][u8 flags].
+struct Envelope {
+    uint64_t request_id = 0;
+    uint64_t offset = 0;
+    bool fin = false;
+};
+void AppendEnvelope(const Envelope& env, std::string& out);
+// Returns header bytes consumed, or 0 on malformed input.
+size_t DecodeEnvelope(const uint8_t* data, size_t len, Envelope& out);
+
+// QPACK field section with Required Insert Count = 0 (no dynamic table)
+// and every field as "literal field line with literal name", no Huffman.
+void EncodeFieldSection(
+    const std::vector<std::pair<std::string, std::string>>& fields,
+    std::string& out);
+// Rejects dynamic-table references, static-table references and Huffman
+// strings (the encoder never produces them). Returns false with `err` set.
+bool DecodeFieldSection(
+    const uint8_t* data, size_t len,
+    std::vector<std::pair<std::string, std::string>>& out,
+    std::string& err);
+
+// Parse an HTTP/3 frame sequence (HEADERS followed by zero or more DATA
+// frames) into `out`. Applies the same pseudo-header rules as the H2
+// stream parser: :method/:path/:scheme required, :authority mapped to
+// `host`, header names must be lowercase, cookie crumbs re-joined with
+// "; ". Body bytes beyond `max_body_size` fail the parse. Returns false
+// with `err` set on malformed input.
+bool ParseRequest(const uint8_t* data, size_t len, size_t max_body_size,
+                  HttpRequest& out, std::string& err);
+
+// Serialize a final response as HEADERS (+ DATA unless the body is
+// suppressed by HEAD / 204 / 205 / 304) frames. Connection-specific
+// headers are dropped (RFC 9114 §4.2) and Content-Length is recomputed
+// with HttpResponse::ComputeWireContentLength, mirroring the H2 path.
+std::string SerializeResponse(const HttpResponse& response, bool head_request);
+
+// Split a serialized frame stream into envelope-prefixed datagrams whose
+// total size never exceeds `max_datagram_size`. The last one carries FIN.
+std::vector<std::string> Packetize(uint64_t request_id,
+                                   const std::string& frames,
+                                   size_t max_datagram_size);
+
+} // namespace HTTP3_CODEC
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "common.h"
+#include "inet_addr.h"
+#include "dispatcher.h"
+#include "http3/udp_listener.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "http/http_callbacks.h"
+
+// Experimental HTTP/3-framed request listener over UDP (see
+// http3/http3_codec.h for the wire format and its limits).
+//
+// Owns one UdpListener per socket dispatcher, all bound to the same
+// address with SO_REUSEPORT. Each datagram carries one complete request;
+// the parsed HttpRequest is handed to the request callback on the
+// dispatcher that received it, and the response is packetized and sent
+// back to the originating peer through that dispatcher's UdpListener.
+//
+// HttpServer wires the request callback to the same router / middleware /
+// async-handler (and therefore ProxyHandler) path used by HTTP/1 and HTTP/2.
+class Http3Listener {
+public:
+    struct Options {
+        size_t max_datagram_size = 1350;   // outbound datagram cap (bytes)
+        size_t recv_batch_size = 16;       // datagrams per recvmmsg/sendmmsg
+        size_t max_body_size = 1048576;
+    };
+
+    struct Stats {
+        UdpListener::Stats udp;            // summed across dispatchers
+        uint64_t requests = 0;             // parsed and dispatched
+        uint64_t malformed = 0;            // rejected by the codec (400 sent when possible)
+        uint64_t responses = 0;            // final responses packetized
+    };
+
+    // Delivers the final response. Callable from any thread, at most once —
+    // later calls are ignored. Off-dispatcher calls hop to the dispatcher
+    // that received the request.
+    using ResponseCallback = std::function<void(HttpResponse)>;
+    // Invoked on the receiving dispatcher thread for every parsed request.
+    using RequestCallback =
+        std::function<void(HttpRequest& request, ResponseCallback respond)>;
+
+    Http3Listener(std::vector<std::shared_ptr<Dispatcher>> dispatchers,
+                  Options options);
+    ~Http3Listener();
+
+    Http3Listener(const Http3Listener&) = delete;
+    Http3Listener& operator=(const Http3Listener&) = delete;
+
+    void SetRequestCallback(RequestCallback cb) { request_cb_ = std::move(cb); }
+
+    // Bind one socket per dispatcher. A port of 0 is resolved by the first
+    // bind and reused for the rest so every socket joins the same
+    // SO_REUSEPORT group. Throws std::runtime_error on failure (already
+    // opened sockets are closed).
+    void Start(const InetAddr& bind_addr);
+    void Stop();
+
+    int GetBoundPort() const { return bound_port_.load(std::memory_order_acquire); }
+    Stats GetStats() const;
+
+    // Buffering StreamingResponseSender for async handlers: accumulates
+    // SendHeaders/SendData and delivers the whole response through
+    // `respond` on End(). There is no incremental flow on the datagram
+    // transport, so SendData never reports high water. Abort after
+    // SendHeaders delivers a 502 so the client is not left waiting.
+    static HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender
+    MakeBufferedStreamSender(Dispatcher* dispatcher, ResponseCallback respond);
+
+private:
+    void OnDatagram(size_t index, const InetAddr& peer,
+                    const char* data, size_t len);
+    ResponseCallback MakeResponder(size_t index, const InetAddr& peer,
+                                   uint64_t request_id, bool head_request);
+
+    std::vector<std::shared_ptr<Dispatcher>> dispatchers_;
+    std::vector<std::shared_ptr<UdpListener>> sockets_;
+    Options options_;
+    RequestCallback request_cb_;
+    std::atomic<int> bound_port_{0};
+
+    // Shared with responders so a late async completion after Stop() /
+    // destruction still has somewhere to count.
+    struct Counters {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> malformed{0};
+        std::atomic<uint64_t> responses{0};
+    };
+    std::shared_ptr<Counters> counters_ = std::make_shared<Counters>();
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "common.h"
+#include "inet_addr.h"
+#include "dispatcher.h"
+#include "channel.h"
+
+#include <sys/uio.h>
+
+// One non-blocking UDP socket bound to a dispatcher's event loop.
+//
+// Several listeners (one per socket dispatcher) bind the same address with
+// SO_REUSEPORT so the kernel spreads datagrams across dispatchers by 4-tuple
+// hash — the UDP analogue of the per-dispatcher accept path.
+//
+// Batching: on readable, the socket is drained to EAGAIN in chunks of up to
+// `batch_size` datagrams per recvmmsg(2) call. Outbound datagrams queued with
+// Send() during one dispatcher iteration are coalesced and handed to the
+// kernel with as few sendmmsg(2) calls as possible — synchronous handler
+// responses are flushed right after the read drain, async completions via
+// one EnQueue'd flush. Non-Linux builds fall back to recvfrom/sendto loops.
+//
+// Threading: every method except the constructor, Open() and the stat
+// getters must run on the owning dispatcher thread. Close() is the
+// exception — it is safe from any thread (Channel::CloseChannel hops).
+class UdpListener : public std::enable_shared_from_this<UdpListener> {
+public:
+    // Invoked once per received datagram, on the dispatcher thread. `data`
+    // is only valid for the duration of the call.
+    using DatagramCallback =
+        std::function<void(const InetAddr& peer, const char* data, size_t len)>;
+
+    struct Stats {
+        uint64_t datagrams_received = 0;
+        uint64_t datagrams_sent = 0;
+        uint64_t recv_batches = 0;   // recvmmsg/recvfrom drain calls that returned data
+        uint64_t send_batches = 0;   // sendmmsg/sendto flush calls that sent data
+        uint64_t send_dropped = 0;   // datagrams dropped on hard error or queue overflow
+        uint64_t recv_truncated = 0; // datagrams larger than max_datagram_size
+    };
+
+    UdpListener(std::shared_ptr<Dispatcher> dispatcher,
+                size_t batch_size, size_t max_datagram_size);
+    ~UdpListener();
+
+    UdpListener(const UdpListener&) = delete;
+    UdpListener& operator=(const UdpListener&) = delete;
+
+    // Create the socket, enable SO_REUSEADDR / SO_REUSEPORT, bind and
+    // register for read events. Throws std::runtime_error on failure.
+    // Safe before or after the dispatcher loop starts (registration goes
+    // through Channel::EnableReadMode).
+    void Open(const InetAddr& bind_addr);
+
+    // Stop receiving and release the socket. Idempotent.
+    void Close();
+
+    void SetDatagramCallback(DatagramCallback cb) { datagram_cb_ = std::move(cb); }
+
+    // Queue one datagram for `peer`. Dispatcher thread only. Flushed at the
+    // end of the current read drain, or by a single EnQueue'd flush when
+    // called outside one (async completions).
+    void Send(const InetAddr& peer, std::string payload);
+
+    int GetBoundPort() const;
+    Dispatcher* GetDispatcher() const { return dispatcher_.get(); }
+    Stats GetStats() const;
+
+    // Upper bound on datagrams buffered while the socket reports EAGAIN.
+    static constexpr size_t MAX_PENDING_DATAGRAMS = 4096;
+
+private:
+    struct Outbound {
+        InetAddr peer;
+        std::string payload;
+    };
+
+    void OnReadable();
+    void OnWritable();
+    void Flush();
+    void ScheduleFlush();
+
+    std::shared_ptr<Dispatcher> dispatcher_;
+    std::shared_ptr<Channel> channel_;
+    int fd_ = -1;  // owned by channel_ once registered
+    size_t batch_size_;
+    size_t max_datagram_size_;
+    DatagramCallback datagram_cb_;
+
+    std::deque<Outbound> pending_;
+    bool in_read_drain_ = false;
+    bool flush_scheduled_ = false;
+    bool write_armed_ = false;
+
+    // Receive buffers reused across drains: batch_size_ slots of
+    // max_datagram_size_ + 1 bytes (the extra byte detects truncation on
+    // platforms without MSG_TRUNC reporting).
+    std::vector<char> recv_storage_;
+    std::vector<sockaddr_storage> recv_addrs_;
+#if defined(__linux__)
+    std::vector<mmsghdr> recv_msgs_;
+    std::vector<iovec> recv_iovs_;
+#endif
+
+    std::atomic<uint64_t> datagrams_received_{0};
+    std::atomic<uint64_t> datagrams_sent_{0};
+    std::atomic<uint64_t> recv_batches_{0};
+    std::atomic<uint64_t> send_batches_{0};
+    std::atomic<uint64_t> send_dropped_{0};
+    std::atomic<uint64_t> recv_truncated_{0};
+};
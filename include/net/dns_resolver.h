@@ -84,6 +84,9 @@ struct ResolveRequest {
 
 struct ResolvedEndpoint {
     InetAddr                              addr;
+    // Every address the name resolved to, preferred family first;
+    // `addr` is addrs[0]. Multi-endpoint upstreams pool each one.
+    std::vector<InetAddr>                 addrs;
     std::string                           host;          // echoed input (still bare)
     int                                   port = 0;
     std::string                           tag;
@@ -41,6 +41,16 @@ struct MetricsCatalog {
     // returns TLS_COMPLETE; failure at the close-callback site driven by
     // the handshake-failure branch.
     Counter*       reactor_tls_handshakes = nullptr;
+    // Server handshakes parked on a private-key operation queued to the
+    // TLS key offload pool (tls.handshake_offload_threads). +1 when
+    // DoHandshake returns TLS_WANT_ASYNC, -1 when the handshake moves on.
+    UpDownCounter* reactor_tls_handshakes_queued = nullptr;
+    // TLS records written on inbound connections, `size` ∈ {small, full}:
+    // records capped at tls.record_size_initial while the connection is
+    // cold (dynamic record sizing), or at 16 KB. Counted from each write's
+    // length and cap, so the last record of a write counts in its class
+    // even when shorter.
+    Counter*       reactor_tls_records = nullptr;
 
     // Client / upstream pool. Instruments are registered at boot so
     // `/metrics` surfaces the series as soon as data points arrive;
@@ -52,6 +62,14 @@ struct MetricsCatalog {
     UpDownCounter* reactor_upstream_pool_connections_idle = nullptr;
     UpDownCounter* reactor_upstream_pool_connections_active = nullptr;
     Histogram*     reactor_upstream_pool_checkout_wait_duration = nullptr;
+    Counter*       reactor_upstream_pool_connects = nullptr;
+    Counter*       reactor_upstream_tls_handshakes = nullptr;
+    Counter*       reactor_upstream_health_checks = nullptr;
+    Counter*       reactor_upstream_health_transitions = nullptr;
+    Counter*       reactor_upstream_outlier_ejections = nullptr;
+    // Per-RPC latency for proxy routes in gRPC mode
+    // (`proxy.grpc.method_histograms`). One record per attempt.
+    Histogram*     rpc_client_duration = nullptr;
 
     // Middleware (auth + rate limit + circuit breaker + ws) ---------
     Counter*       reactor_auth_requests = nullptr;
@@ -65,6 +83,13 @@ struct MetricsCatalog {
     Counter*       reactor_dns_resolves = nullptr;
     UpDownCounter* reactor_websocket_active_connections = nullptr;
     Counter*       reactor_websocket_frames = nullptr;
+    Counter*       reactor_proxy_websocket_bytes = nullptr;
+    UpDownCounter* reactor_proxy_websocket_active_tunnels = nullptr;
+    Counter*       reactor_proxy_cache_lookups = nullptr;
+    Counter*       reactor_proxy_cache_served_bytes = nullptr;
+    Counter*       reactor_proxy_cache_origin_latency_saved = nullptr;
+    Counter*       reactor_proxy_singleflight_coalesced = nullptr;
+    Counter*       reactor_proxy_hedges = nullptr;
 
     // Self-metrics (OTel pipeline introspection) --------------------
     Counter*       reactor_otel_spans_created = nullptr;
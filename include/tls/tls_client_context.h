@@ -33,8 +33,20 @@ public:
     // never been called. Exposed for tests / diagnostics.
     const std::vector<unsigned char>& GetAlpnWire() const { return alpn_wire_; }
 
+    // Kernel TLS offload for client connections — same contract as
+    // TlsContext::EnableKtls.
+    bool EnableKtls();
+
+    // Session reuse: when enabled, sessions the upstream issues are handed
+    // to the TlsSessionCache bound to each SSL (see TlsSessionCache::Attach)
+    // and offered again on the next connect. OpenSSL's internal client
+    // store stays off — the per-partition caches are the only store.
+    void SetSessionReuse(bool enabled);
+    bool SessionReuseEnabled() const { return session_reuse_; }
+
 private:
     SSL_CTX* ctx_;
+    bool session_reuse_ = false;
 
     // Stored ALPN protocol list (wire-format: length-prefixed concatenation)
     std::vector<unsigned char> alpn_wire_;
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "tls/tls_context.h"
-// <string>, <stdexcept> provided by common.h (via tls_context.h)
+#include "tls/tls_key_offloader.h"
+// <string>, <stdexcept>, <functional> provided by common.h (via tls_context.h)
 
-// Forward declaration — avoids pulling tls_client_context.h into every includer
+// Forward declarations — avoid pulling the client headers into every includer
 class TlsClientContext;
+class TlsSessionCache;
 
 class TlsConnection {
 public:
@@ -15,6 +17,7 @@ public:
     static constexpr int TLS_ERROR       = -1;  // Fatal error
     static constexpr int TLS_PEER_CLOSED = -2;  // Peer sent close_notify (Read only)
     static constexpr int TLS_CROSS_RW    = -3;  // Read needs write / Write needs read (renegotiation)
+    static constexpr int TLS_WANT_ASYNC  =  3;  // DoHandshake waits on an offloaded key operation
 
     // Server-mode constructor (existing)
     TlsConnection(TlsContext& ctx, int fd);
@@ -30,9 +33,20 @@ public:
     TlsConnection(TlsConnection&&) = delete;
     TlsConnection& operator=(TlsConnection&&) = delete;
 
-    // Returns: TLS_COMPLETE, TLS_WANT_READ, TLS_WANT_WRITE, or TLS_ERROR
+    // Returns: TLS_COMPLETE, TLS_WANT_READ, TLS_WANT_WRITE, TLS_WANT_ASYNC,
+    // or TLS_ERROR. TLS_WANT_ASYNC (server contexts with key offload only):
+    // the private-key operation is on the offload pool; the resume
+    // callback fires from a worker thread when it finishes, after which
+    // DoHandshake must be called again. Calling it earlier is harmless.
     int DoHandshake();
 
+    // Invoked on an offload worker thread when a pending key operation
+    // completes. Must be thread-safe — typically it posts the handshake
+    // continuation to the connection's dispatcher.
+    void SetAsyncResumeCallback(std::function<void()> cb) {
+        async_resume_cb_ = std::move(cb);
+    }
+
     // Returns: >0 bytes read, TLS_COMPLETE (would_block), TLS_CROSS_RW, TLS_PEER_CLOSED, or TLS_ERROR
     int Read(char* buf, size_t len);
 
@@ -42,14 +56,46 @@ public:
     int Peek(char* buf, size_t len);
 
     // Returns: >0 bytes written, TLS_COMPLETE (would_block), TLS_CROSS_RW, or TLS_ERROR
+    // With dynamic record sizing (server mode, TlsContext::SetRecordSizing)
+    // a cold connection writes small records, and a write crossing the
+    // ramp point is cut short there — callers already handle partial
+    // writes. Retries after TLS_COMPLETE / TLS_CROSS_RW must pass at least
+    // the original `len`, as with plain SSL_write.
     int Write(const char* buf, size_t len);
 
+    // Plaintext cap of the records the last Write produced:
+    // TlsContext::MAX_RECORD_SIZE, or the initial record size while cold.
+    size_t LastRecordLimit() const { return record_limit_; }
+
     int Shutdown();
 
     bool IsHandshakeComplete() const { return handshake_complete_; }
     std::string GetCipherName() const;
     std::string GetProtocolVersion() const;
 
+    // Client mode: offer the session cached under `key` and store the
+    // sessions this connection receives back under it. Must be called
+    // before the first DoHandshake. Returns true when a session was offered.
+    bool AttachSessionCache(TlsSessionCache& cache, const std::string& key);
+
+    // True when the completed handshake resumed a session (ticket or
+    // session-cache hit) instead of running a full key exchange.
+    bool IsSessionReused() const { return SSL_session_reused(ssl_) == 1; }
+
+    // Kernel TLS state, sampled when the handshake completes. With kTLS
+    // send active the kernel encrypts whatever is written to the fd, so
+    // callers may bypass Write() and send plaintext on the socket directly
+    // (which also makes sendfile / splice usable). Receive offload still
+    // goes through Read(): OpenSSL's recvmsg path handles the non-data
+    // records (alerts, post-handshake messages) a plain read() would fail on.
+    bool KtlsSendActive() const { return ktls_send_; }
+    bool KtlsRecvActive() const { return ktls_recv_; }
+
+    // True when this OpenSSL build and platform can offload TLS records to
+    // the kernel (SSL_OP_ENABLE_KTLS on Linux). Whether a given connection
+    // gets it still depends on the kernel's tls module and the cipher.
+    static bool KtlsAvailable();
+
     // Test-only accessor — returns the underlying OpenSSL SSL*. Used by
     // DualStack tests to introspect SNI / verify-name post-ctor without
     // running a handshake. Production code must not rely on this; the
@@ -63,4 +109,27 @@ public:
 private:
     SSL* ssl_;
     bool handshake_complete_ = false;
+    bool ktls_send_ = false;
+    bool ktls_recv_ = false;
+
+    // Handshake key offload (server mode, TlsContext::EnableKeyOffload).
+    TlsKeyOffloader* key_offloader_ = nullptr;
+    // Set while SSL_do_handshake is paused on an offloaded operation.
+    std::shared_ptr<TlsKeyOffloader::Operation> pending_key_op_;
+    std::function<void()> async_resume_cb_;
+
+    // Teardown with a paused handshake job: cancel or wait out the
+    // operation, then let the job finish against a null BIO so nothing
+    // is written to a closed (possibly reused) fd.
+    void AbandonPendingKeyOp();
+
+    // Dynamic record sizing (server mode; disabled for clients).
+    TlsContext::RecordSizing record_sizing_;
+    size_t record_limit_ = TlsContext::MAX_RECORD_SIZE;
+    // Bytes written since the connection last went cold.
+    size_t warm_bytes_ = 0;
+    std::chrono::steady_clock::time_point last_write_;
+    // Length handed to SSL_write by a write awaiting retry; the record
+    // size must not change under it.
+    size_t pending_write_len_ = 0;
 };
@@ -2,6 +2,10 @@
 
 #include "common.h"
 #include <openssl/ssl.h>
+#include <array>
+#include <mutex>
+
+class TlsKeyOffloader;
 
 class TlsContext {
 public:
@@ -24,12 +28,105 @@ public:
     // Protocol strings: "h2", "http/1.1". The server selects the first match.
     void SetAlpnProtocols(const std::vector<std::string>& protocols);
 
+    // Kernel TLS (SSL_OP_ENABLE_KTLS): after the handshake OpenSSL tries
+    // to install the traffic keys into the socket (TLS_TX / TLS_RX), per
+    // connection and per direction. Connections whose kernel or cipher
+    // refuses keep using OpenSSL. Returns false when this OpenSSL build
+    // or platform has no kTLS support (the option is then not set).
+    bool EnableKtls();
+
+    // Move handshake private-key operations (RSA / ECDSA signatures) off
+    // the dispatchers onto a pool of `threads` workers — see
+    // TlsKeyOffloader. Returns false, leaving signatures inline, when the
+    // platform has no OpenSSL async job support or the key is neither RSA
+    // nor EC. Call once, before connections are accepted.
+    bool EnableKeyOffload(int threads);
+    // Null unless EnableKeyOffload succeeded.
+    TlsKeyOffloader* KeyOffloader() const { return key_offloader_.get(); }
+
+    // Dynamic record sizing for server connections. While a connection is
+    // cold — fewer than `ramp_bytes` written since the handshake or since
+    // the last idle gap of `idle_reset_ms` — records carry at most
+    // `initial_record_size` plaintext bytes, so each fits one TCP segment
+    // and the client can decrypt the first bytes of a response as soon as
+    // they arrive. Warm connections write full 16 KB records for
+    // throughput. idle_reset_ms = 0 never re-enters the cold phase.
+    struct RecordSizing {
+        bool enabled = false;
+        size_t initial_record_size = 1400;
+        size_t ramp_bytes = 1024 * 1024;
+        int idle_reset_ms = 1000;
+    };
+    // Applies to connections created afterwards.
+    void SetRecordSizing(const RecordSizing& sizing) { record_sizing_ = sizing; }
+    const RecordSizing& GetRecordSizing() const { return record_sizing_; }
+
+    // Largest TLS record plaintext (RFC 8446 §5.1).
+    static constexpr size_t MAX_RECORD_SIZE = 16384;
+
+    // Session resumption (TLS 1.2 and 1.3).
+    //   tickets         — issue stateless session tickets. Keys come from
+    //                     `ticket_key_file` when set, else from an
+    //                     in-process random key.
+    //   cache_size      — server-side session cache in entries; 0 = off.
+    //   timeout_sec     — session lifetime (ticket lifetime hint / cache TTL).
+    // Throws std::runtime_error when the key file cannot be loaded.
+    void ConfigureSessionResumption(bool tickets,
+                                    const std::string& ticket_key_file,
+                                    size_t cache_size, int timeout_sec);
+
+    // Refresh the ticket keys (SIGHUP). With a key file, the file is
+    // re-read and replaces the whole key set. Without one, a new random
+    // key becomes the encryption key and the previous one is kept for
+    // decryption only, so tickets issued before the rotation still resume
+    // until the next one. No-op when tickets are off. Throws
+    // std::runtime_error on a bad file; the current keys stay in force.
+    void RotateTicketKeys();
+
+    // Number of keys currently accepted for decryption (tests / logging).
+    size_t TicketKeyCount() const;
+
+    // Ticket key file layout: 16-byte name, HMAC secret, AES key.
+    // 80-byte keys use a 32-byte HMAC secret and AES-256-CBC; 48-byte
+    // keys (the older nginx format) use 16 bytes each and AES-128-CBC.
+    static constexpr size_t TICKET_KEY_SIZE = 80;
+    static constexpr size_t TICKET_KEY_SIZE_LEGACY = 48;
+
 private:
+    struct TicketKey {
+        std::array<unsigned char, 16> name{};
+        std::array<unsigned char, 32> hmac_key{};
+        std::array<unsigned char, 32> aes_key{};
+        size_t hmac_len = 32;
+        bool aes256 = true;
+    };
+    using TicketKeySet = std::vector<TicketKey>;
+
+    static TicketKeySet LoadTicketKeyFile(const std::string& path);
+    static TicketKey GenerateTicketKey();
+    std::shared_ptr<const TicketKeySet> TicketKeys() const;
+
+    // Ticket encrypt/decrypt callback (SSL_CTX_set_tlsext_ticket_key_evp_cb).
+    static int TicketKeyCallback(SSL* ssl, unsigned char* key_name,
+                                 unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx,
+                                 EVP_MAC_CTX* mac_ctx, int enc);
+
     SSL_CTX* ctx_;
 
+    // Ticket keys: [0] encrypts, all decrypt. Swapped whole on rotation;
+    // handshakes on the dispatcher threads take a snapshot under the mutex.
+    bool tickets_enabled_ = false;
+    std::string ticket_key_file_;
+    mutable std::mutex ticket_keys_mtx_;
+    std::shared_ptr<const TicketKeySet> ticket_keys_;
+
     // Stored ALPN protocol list (wire-format: length-prefixed concatenation)
     std::vector<unsigned char> alpn_wire_;
 
+    std::unique_ptr<TlsKeyOffloader> key_offloader_;
+
+    RecordSizing record_sizing_;
+
     // Static ALPN selection callback for OpenSSL
     static int AlpnSelectCallback(
         SSL* ssl,
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "common.h"
+#include "threadpool.h"
+#include <openssl/ssl.h>
+// <atomic>, <functional>, <memory> provided by common.h
+
+// Runs the private-key operation of server handshakes (the RSA or ECDSA
+// signature over the transcript) on a worker pool instead of the
+// dispatcher that owns the connection.
+//
+// Mechanism: OpenSSL async jobs. TlsContext::EnableKeyOffload installs a
+// copy of the server key whose RSA / EC method routes the signature
+// through this class, and server SSLs run their handshake with
+// SSL_MODE_ASYNC. Inside the job the signature hook queues the operation
+// on the pool and pauses the job; SSL_do_handshake returns
+// SSL_ERROR_WANT_ASYNC (TlsConnection::TLS_WANT_ASYNC) and the dispatcher
+// moves on. When the worker finishes it invokes the connection's resume
+// callback, which re-enters the handshake on the dispatcher; the job picks
+// up where it paused and writes the rest of the server flight.
+//
+// Outside a handshake bound by TlsConnection (no Scope on this thread),
+// or on platforms without async job support, the hooks sign inline.
+class TlsKeyOffloader {
+public:
+    // One queued signature. Shared between the paused handshake job (which
+    // reads the result when resumed) and the worker (which produces it).
+    class Operation {
+    public:
+        enum State { QUEUED, RUNNING, DONE, CANCELLED };
+
+        ~Operation();
+
+        // Claim the operation for `TlsConnection` teardown. True when it was
+        // still queued: it will never run and the job sees a failure. False
+        // when it is running or done — wait for IsDone() before resuming.
+        bool Cancel();
+        bool IsDone() const {
+            return state_.load(std::memory_order_acquire) == DONE;
+        }
+
+    private:
+        friend class TlsKeyOffloader;
+        std::atomic<int> state_{QUEUED};
+        // Inputs, with key references held until the operation is freed.
+        std::vector<unsigned char> input_;
+        RSA* rsa_ = nullptr;
+        int rsa_padding_ = 0;
+        EC_KEY* ec_key_ = nullptr;
+        // Results.
+        std::vector<unsigned char> output_;
+        int rsa_result_ = -1;
+        ECDSA_SIG* ecdsa_sig_ = nullptr;
+        std::function<void()> resume_;
+    };
+
+    // Per-thread binding of the handshake being driven right now. Set by
+    // TlsConnection around SSL_do_handshake; the hooks queue their
+    // operation into `*pending` and call `*resume` when it completes.
+    class Scope {
+    public:
+        Scope(TlsKeyOffloader* offloader, std::shared_ptr<Operation>* pending,
+              const std::function<void()>* resume);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        friend class TlsKeyOffloader;
+        TlsKeyOffloader* offloader_;
+        std::shared_ptr<Operation>* pending_;
+        const std::function<void()>* resume_;
+        Scope* previous_;
+    };
+
+    // Starts `threads` workers. Throws std::runtime_error when threads <= 0.
+    explicit TlsKeyOffloader(int threads);
+    ~TlsKeyOffloader();
+
+    TlsKeyOffloader(const TlsKeyOffloader&) = delete;
+    TlsKeyOffloader& operator=(const TlsKeyOffloader&) = delete;
+
+    // Copy of `key` whose private operations go through the offload hooks,
+    // or nullptr for key types other than RSA and EC (which then stay
+    // inline). Caller owns the result.
+    static EVP_PKEY* WrapKey(EVP_PKEY* key);
+
+    // True when this platform can pause OpenSSL async jobs.
+    static bool Supported();
+
+    int threads() const { return threads_; }
+    // Operations handed to the pool, finished by a worker, and abandoned
+    // before a worker picked them up (connection closed mid-handshake).
+    int64_t submitted() const { return submitted_.load(std::memory_order_relaxed); }
+    int64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+    int64_t cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+    // Operations queued or running right now.
+    int64_t in_flight() const {
+        return submitted() - completed() - cancelled();
+    }
+
+private:
+    class Task;
+
+    static int RsaPrivateEncrypt(int flen, const unsigned char* from,
+                                 unsigned char* to, RSA* rsa, int padding);
+    static ECDSA_SIG* EcdsaSign(const unsigned char* dgst, int dgst_len,
+                                const BIGNUM* kinv, const BIGNUM* r,
+                                EC_KEY* eckey);
+
+    // Queue `op` and pause the calling job until a worker finished it.
+    // Returns false when the operation was cancelled.
+    bool SubmitAndWait(Scope& scope, const std::shared_ptr<Operation>& op);
+    void Run(Operation& op);
+
+    int threads_;
+    std::atomic<int64_t> submitted_{0};
+    std::atomic<int64_t> completed_{0};
+    std::atomic<int64_t> cancelled_{0};
+    // Last member: joined first on destruction, before the counters go.
+    ThreadPool pool_;
+};
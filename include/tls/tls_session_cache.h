@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common.h"
+#include <openssl/ssl.h>
+// <string>, <memory>, <unordered_map> provided by common.h
+
+// Client-side TLS session store for upstream connections. One instance
+// per PoolPartition, so it is only ever touched from that partition's
+// dispatcher thread and needs no locking.
+//
+// Keyed by "host:port/sni". Sessions are offered on the next connect to
+// the same key and replaced whenever the server issues a new one (every
+// TLS 1.2 handshake that hands out a ticket, and each TLS 1.3
+// NewSessionTicket). Expired or non-resumable sessions are dropped on
+// lookup. A session is never shared across TlsClientContexts — resuming
+// skips certificate verification, so a session minted under one
+// upstream's verify settings must not be replayed under another's.
+class TlsSessionCache : public std::enable_shared_from_this<TlsSessionCache> {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16;
+
+    explicit TlsSessionCache(size_t capacity = DEFAULT_CAPACITY);
+    ~TlsSessionCache();
+
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    // Offer the cached session for `key` (if any) on `ssl` and bind `ssl`
+    // so sessions it receives are stored under `key`. Call before the
+    // handshake starts. Returns true when a session was offered.
+    bool Attach(SSL* ssl, const std::string& key);
+
+    // Drop the session stored under `key`.
+    void Remove(const std::string& key);
+
+    size_t Size() const { return entries_.size(); }
+
+    // SSL_CTX_sess_set_new_cb target — installed by TlsClientContext.
+    // Stores a copy of the session in the cache bound by Attach. Always
+    // returns 0: the connection's own reference stays with OpenSSL.
+    static int NewSessionCallback(SSL* ssl, SSL_SESSION* session);
+
+private:
+    struct Entry {
+        SSL_SESSION* session = nullptr;
+        uint64_t stored_seq = 0;
+    };
+
+    // Takes ownership of one reference on `session`.
+    void Store(const std::string& key, SSL_SESSION* session);
+    static int BindingIndex();
+
+    size_t capacity_;
+    uint64_t seq_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "common.h"
+// <string>, <string_view>, <vector>, <optional>, <cstdint> provided by common.h
+
+// gRPC-over-HTTP/2 helpers for ProxyConfig::grpc (see docs/http2_upstream.md,
+// "gRPC mode"). Pure functions + one incremental parser; no I/O, no
+// logging, safe on any thread.
+//
+// Wire references: gRPC PROTOCOL-HTTP2.md (Length-Prefixed-Message,
+// grpc-timeout, grpc-status) and doc/statuscodes.md.
+//
+// Namespace naming: UPPER_SNAKE_CASE per CODE_CONVENTIONS.md.
+namespace GRPC_NAMESPACE {
+
+// Canonical status codes. Plain ints on the wire (`grpc-status: 14`).
+enum StatusCode : int {
+    OK                  = 0,
+    CANCELLED           = 1,
+    UNKNOWN             = 2,
+    INVALID_ARGUMENT    = 3,
+    DEADLINE_EXCEEDED   = 4,
+    NOT_FOUND           = 5,
+    ALREADY_EXISTS      = 6,
+    PERMISSION_DENIED   = 7,
+    RESOURCE_EXHAUSTED  = 8,
+    FAILED_PRECONDITION = 9,
+    ABORTED             = 10,
+    OUT_OF_RANGE        = 11,
+    UNIMPLEMENTED       = 12,
+    INTERNAL            = 13,
+    UNAVAILABLE         = 14,
+    DATA_LOSS           = 15,
+    UNAUTHENTICATED     = 16,
+};
+inline constexpr int MAX_STATUS_CODE = 16;
+
+// Config spelling of a status: lowercase, '-' separated
+// ("unavailable", "resource-exhausted"). ParseStatusName returns -1 for
+// an unknown name; StatusName returns "" for an out-of-range code.
+int ParseStatusName(const std::string& name);
+const char* StatusName(int code);
+
+// Bit `code` set ⇔ the status is a member. Built once from config so the
+// per-response check is a shift and a mask.
+using StatusSet = uint32_t;
+StatusSet MakeStatusSet(const std::vector<std::string>& names);
+inline bool Contains(StatusSet set, int code) {
+    return code >= 0 && code <= MAX_STATUS_CODE &&
+           ((set >> code) & 1u) != 0;
+}
+
+// `application/grpc`, optionally followed by `+<format>` or `;params`.
+// Case-insensitive on the type.
+bool IsGrpcContentType(const std::string& content_type);
+
+// grpc-timeout = 1*8DIGIT unit, unit ∈ {H, M, S, m, u, n}. Returns the
+// timeout in milliseconds, rounded up (a positive sub-millisecond value
+// becomes 1). nullopt when malformed.
+std::optional<int64_t> ParseTimeoutMs(std::string_view value);
+
+// Inverse of ParseTimeoutMs for the outbound header: picks the smallest
+// unit that fits in 8 digits ("250m", "30S").
+std::string FormatTimeout(int64_t ms);
+
+// grpc-status value → code. Accepts any non-negative decimal that fits an
+// int (codes above MAX_STATUS_CODE are legal on the wire and map to
+// UNKNOWN-like handling by the caller). nullopt when malformed.
+std::optional<int> ParseStatus(std::string_view value);
+
+// Look up grpc-status in a header/trailer list (names compared
+// case-insensitively). nullopt when absent or malformed.
+std::optional<int> FindStatus(
+    const std::vector<std::pair<std::string, std::string>>& fields);
+
+// Split a request path "/pkg.Service/Method" into its two parts. Returns
+// false (outputs untouched) for anything else — such paths are not gRPC
+// calls and are labelled by the caller as unknown.
+bool SplitMethodPath(const std::string& path,
+                     std::string& service, std::string& method);
+
+// Incremental reader for the Length-Prefixed-Message framing of a gRPC
+// body: 1 byte compressed flag, 4 byte big-endian length, payload.
+// Bytes may arrive split at any point. Counts complete messages and
+// enforces an optional per-message size cap (0 = unlimited).
+class MessageFramer {
+public:
+    enum class Result {
+        OK,         // consumed; framing still valid
+        OVERSIZE,   // a message declared more than max_message_bytes
+        BAD_FLAG    // compressed-flag byte was neither 0 nor 1
+    };
+
+    explicit MessageFramer(uint32_t max_message_bytes = 0)
+        : max_message_bytes_(max_message_bytes) {}
+
+    // Sticky: once a non-OK result is returned, later calls return it
+    // again without consuming.
+    Result Feed(const char* data, size_t len);
+
+    uint64_t messages() const { return messages_; }
+    // True when no prefix or payload is partially consumed — a body that
+    // ends here is well-framed.
+    bool AtBoundary() const { return prefix_have_ == 0 && remaining_ == 0; }
+
+private:
+    uint32_t max_message_bytes_;
+    uint8_t prefix_[5] = {};
+    size_t prefix_have_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t messages_ = 0;
+    Result error_ = Result::OK;
+};
+
+}  // namespace GRPC_NAMESPACE
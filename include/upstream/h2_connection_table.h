@@ -26,6 +26,10 @@ public:
     // Used by stats / shutdown drain accounting.
     size_t TotalConnections() const;
 
+    // Sum of active streams over every tracked connection. Feeds the
+    // least-request load balancer's per-partition load.
+    size_t TotalActiveStreams() const;
+
     // Returns the number of tracked H2 connections for a single upstream
     // service. Used by saturation-routing decisions when picking among
     // multiple multiplexed sessions for the same upstream.
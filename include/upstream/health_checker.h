@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "upstream/upstream_lease.h"
+#include "upstream/upstream_http_codec.h"
+// <memory>, <functional>, <string>, <atomic>, <chrono> provided by common.h
+
+class PoolPartition;
+class Dispatcher;
+
+// Active health checking of one upstream endpoint address. Runs on the
+// dispatcher owning `partition` and checks out through it, so an HTTP
+// check reuses an idle keep-alive connection when one is pooled and a
+// fresh connect otherwise warms the pool for live traffic.
+//
+// Every check ends in one of three outcomes: pass, fail, or skipped. A
+// check is skipped when the pool is saturated or shutting down, because
+// that says nothing about the backend. Consecutive passes and failures
+// are counted against the thresholds; crossing one fires the transition
+// callback on the dispatcher thread.
+//
+// Lifetime: owned by UpstreamHostPool via shared_ptr. Scheduled tasks
+// hold a weak_ptr and the partition's alive token, so a task that fires
+// after Stop() or after the partition is destroyed does nothing.
+class HealthChecker : public std::enable_shared_from_this<HealthChecker> {
+public:
+    using TransitionCallback = std::function<void(bool healthy,
+                                                  const std::string& reason)>;
+
+    // `endpoint_label` is the "ip:port" used in logs and metric labels;
+    // `host_header` is sent on HTTP checks. `seed` decorrelates the
+    // jitter of checkers started together.
+    HealthChecker(PoolPartition* partition,
+                  std::string endpoint_label,
+                  const UpstreamHealthCheckConfig& config,
+                  std::string host_header,
+                  uint64_t seed,
+                  TransitionCallback on_transition);
+    ~HealthChecker();
+
+    HealthChecker(const HealthChecker&) = delete;
+    HealthChecker& operator=(const HealthChecker&) = delete;
+
+    // Schedule the first check at a random point within one interval so
+    // checkers started together don't probe in lockstep. Any thread.
+    void Start();
+
+    // Stop scheduling checks. An in-flight check is abandoned without a
+    // result. Any thread; idempotent.
+    void Stop();
+
+    const std::string& endpoint_label() const { return endpoint_label_; }
+
+    // Check counters by outcome (relaxed reads; snapshot quality).
+    int64_t checks_passed() const noexcept {
+        return checks_passed_.load(std::memory_order_relaxed);
+    }
+    int64_t checks_failed() const noexcept {
+        return checks_failed_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Probe;
+    enum class Outcome { PASS, FAIL, SKIPPED };
+
+    void ScheduleCheck(std::chrono::milliseconds delay);
+    uint64_t NextRandom();
+    std::chrono::milliseconds NextInterval();
+    bool PartitionUsable() const;
+
+    // Dispatcher thread only.
+    void RunCheck();
+    void OnLease(const std::shared_ptr<Probe>& probe, UpstreamLease lease);
+    void OnResponseData(const std::shared_ptr<Probe>& probe, std::string& data);
+    void FinishCheck(const std::shared_ptr<Probe>& probe, Outcome outcome,
+                     const std::string& reason);
+    void Record(Outcome outcome, const std::string& reason);
+
+    PoolPartition* partition_;
+    std::shared_ptr<std::atomic<bool>> partition_alive_;
+    // Held separately so Start()/Stop() and late timers never
+    // dereference the partition to reach its dispatcher.
+    std::shared_ptr<Dispatcher> dispatcher_;
+    std::string service_name_;
+    std::string endpoint_label_;
+    UpstreamHealthCheckConfig config_;
+    std::string request_;          // Serialized HTTP check request
+    TransitionCallback on_transition_;
+
+    std::atomic<bool> stopped_{false};
+    uint64_t rng_;
+
+    // Dispatcher-thread state. Endpoints start healthy: traffic flows
+    // from startup and the first failures move it out.
+    bool healthy_ = true;
+    int consecutive_passes_ = 0;
+    int consecutive_failures_ = 0;
+    std::shared_ptr<Probe> probe_;
+
+    std::atomic<int64_t> checks_passed_{0};
+    std::atomic<int64_t> checks_failed_{0};
+};
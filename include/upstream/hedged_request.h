@@ -0,0 +1,110 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "http/http_callbacks.h"
+// <string>, <vector>, <memory>, <mutex>, <atomic>, <chrono>, <functional>
+// provided by common.h
+
+class Dispatcher;
+struct HttpRequest;
+
+namespace CIRCUIT_BREAKER_NAMESPACE { class RetryBudget; }
+namespace OBSERVABILITY_NAMESPACE { class ObservabilityManager; }
+
+// Per-route hedge delay (proxy.retry.hedge). Either the fixed delay_ms
+// or, with `percentile` set, that percentile of the route's recent
+// client-observed response-head latencies. Shared by every dispatcher
+// serving the route.
+class HedgePolicy {
+public:
+    explicit HedgePolicy(const ProxyHedgeConfig& config);
+
+    HedgePolicy(const HedgePolicy&) = delete;
+    HedgePolicy& operator=(const HedgePolicy&) = delete;
+
+    // Bodiless GET/HEAD/OPTIONS: safe to send twice.
+    static bool Eligible(const HttpRequest& request);
+
+    std::chrono::milliseconds Delay() const;
+    void RecordLatency(std::chrono::steady_clock::duration latency);
+
+private:
+    static constexpr size_t SAMPLE_COUNT = 256;
+    // Samples before the percentile replaces delay_ms, and between
+    // recomputations of it.
+    static constexpr size_t MIN_SAMPLES = 32;
+    static constexpr size_t RECOMPUTE_EVERY = 16;
+
+    ProxyHedgeConfig config_;
+    std::mutex mtx_;
+    std::vector<int64_t> samples_us_;   // ring buffer
+    size_t next_ = 0;
+    size_t recorded_ = 0;
+    std::atomic<int64_t> percentile_delay_ms_{-1};  // -1 = not computed yet
+};
+
+// One client request racing its primary attempt against at most one
+// hedge. Both attempts run on the client's dispatcher and report
+// through per-attempt senders; the first to produce a response head (or
+// a buffered response) wins and the other is cancelled. Dispatcher
+// thread of the request only.
+class HedgedRequest : public std::enable_shared_from_this<HedgedRequest> {
+public:
+    using StreamingSender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender;
+    using Completion = HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback;
+    // Start one attempt wired to `sender` / `complete`; returns the hook
+    // that cancels it. `primary` is false for the hedge.
+    using Launch = std::function<std::function<void()>(
+        StreamingSender sender, Completion complete, bool primary)>;
+
+    HedgedRequest(std::string service,
+                  std::shared_ptr<HedgePolicy> policy,
+                  Dispatcher* dispatcher,
+                  CIRCUIT_BREAKER_NAMESPACE::RetryBudget* budget,
+                  StreamingSender client_sender,
+                  Completion client_complete);
+    ~HedgedRequest();
+
+    HedgedRequest(const HedgedRequest&) = delete;
+    HedgedRequest& operator=(const HedgedRequest&) = delete;
+
+    // Launch the primary attempt, arm the hedge timer, and take over the
+    // client's cancel slot.
+    void Start(const HttpRequest& request, Launch launch);
+
+private:
+    class AttemptSender;
+    static constexpr int PRIMARY = 0;
+    static constexpr int HEDGE = 1;
+
+    void FireHedge();
+    // First response of the race: true when `attempt` won it.
+    bool Claim(int attempt);
+    // Attempt ended before a response head (Abort). The client hears
+    // about it only when no other attempt is still running.
+    void OnAttemptFailed(int attempt, StreamingSender::AbortReason reason);
+    void CancelAll();
+    void ReleaseBudget();
+    void Record(const char* result);
+
+    StreamingSender AttemptSenderFor(int attempt);
+    Completion CompletionFor(int attempt);
+
+    std::string service_;
+    std::shared_ptr<HedgePolicy> policy_;
+    Dispatcher* dispatcher_;
+    CIRCUIT_BREAKER_NAMESPACE::RetryBudget* budget_;
+    StreamingSender client_sender_;
+    Completion client_complete_;
+    std::weak_ptr<OBSERVABILITY_NAMESPACE::ObservabilityManager> obs_manager_;
+
+    Launch launch_;                       // dropped once the hedge fired
+    std::function<void()> cancel_[2];
+    bool running_[2] = {false, false};
+    std::chrono::steady_clock::time_point started_at_;
+    int winner_ = -1;
+    bool cancelled_ = false;              // client went away
+    bool hedged_ = false;
+    bool budget_held_ = false;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "common.h"
+// <string>, <vector>, <functional> provided by common.h
+
+// Endpoint selection for a multi-endpoint upstream. One instance per
+// UpstreamHostPool, immutable after construction (member list, weights,
+// ring-hash ring, Maglev table). Mutable selection state — round-robin
+// cursor, smooth-weighted credits, P2C random stream — lives in a State
+// owned per dispatcher, so picks never synchronize across threads.
+class LoadBalancer {
+public:
+    enum class Policy {
+        ROUND_ROBIN,    // Cycle through members, weights ignored
+        WEIGHTED,       // Smooth weighted round-robin (nginx)
+        LEAST_REQUEST,  // Power of two choices on outstanding requests
+        RING_HASH,      // Consistent hashing on a weighted ring
+        MAGLEV          // Maglev lookup table (consistent, evenly spread)
+    };
+
+    struct Member {
+        std::string key;    // Stable identity hashed by ring_hash / maglev
+        int weight = 1;
+    };
+
+    // Per-dispatcher selection state. Only touched by the owning
+    // dispatcher; aligned so neighbouring dispatchers don't share a line.
+    struct alignas(64) State {
+        uint64_t cursor = 0;
+        uint64_t rng = 0;
+        std::vector<int64_t> credits;   // WEIGHTED current weights
+    };
+
+    // Prime table size recommended by the Maglev paper for small
+    // backend sets; lookups are one modulo + one load.
+    static constexpr size_t MAGLEV_TABLE_SIZE = 65537;
+    // RING_HASH points per unit of weight. Fixed per member (not scaled
+    // to the member count) so removing a member leaves the others'
+    // points, and therefore their keys, where they were.
+    static constexpr size_t RING_POINTS_PER_WEIGHT = 160;
+
+    // Parse a LoadBalancerConfig::policy string. Returns false on an
+    // unknown name (ConfigLoader::Validate rejects those up front).
+    static bool ParsePolicy(const std::string& name, Policy* out);
+
+    // Stable 64-bit hash (FNV-1a with a final avalanche). Never returns 0,
+    // which RequestHash uses for "no key".
+    static uint64_t Hash(const std::string& data);
+
+    // Throws std::invalid_argument when `members` is empty.
+    LoadBalancer(Policy policy, std::vector<Member> members);
+
+    State MakeState(size_t seed) const;
+
+    // Index of the member to use. `hash` is the request key for the hash
+    // policies (0 = request has no key: fall back to round-robin);
+    // `load(i)` returns member i's outstanding requests for LEAST_REQUEST.
+    // `eligible(i)`, when set, excludes members (failed health checks):
+    // rotation skips them, weighted credits accrue only to eligible
+    // members, and the hash policies walk on to the next eligible entry
+    // so only the excluded members' keys move. With no eligible member
+    // the pick ignores eligibility rather than failing the request.
+    size_t Pick(State& state, uint64_t hash,
+                const std::function<int64_t(size_t)>& load,
+                const std::function<bool(size_t)>& eligible = nullptr) const;
+
+    Policy policy() const { return policy_; }
+    bool hashed() const {
+        return policy_ == Policy::RING_HASH || policy_ == Policy::MAGLEV;
+    }
+    size_t size() const { return members_.size(); }
+    const Member& member(size_t i) const { return members_[i]; }
+
+private:
+    size_t PickWeighted(State& state,
+                        const std::function<bool(size_t)>& eligible) const;
+    size_t PickLeastRequest(State& state,
+                            const std::function<int64_t(size_t)>& load,
+                            const std::function<bool(size_t)>& eligible) const;
+    size_t PickRing(uint64_t hash,
+                    const std::function<bool(size_t)>& eligible) const;
+    size_t PickMaglev(uint64_t hash,
+                      const std::function<bool(size_t)>& eligible) const;
+    size_t PickRoundRobin(State& state,
+                          const std::function<bool(size_t)>& eligible) const;
+    void BuildRing();
+    void BuildMaglev();
+
+    Policy policy_;
+    std::vector<Member> members_;
+    int64_t total_weight_ = 0;
+    // (point, member) sorted by point.
+    std::vector<std::pair<uint64_t, uint32_t>> ring_;
+    std::vector<uint32_t> maglev_;
+};
@@ -7,14 +7,17 @@
 #include "upstream/upstream_callbacks.h"
 #include "upstream/h2_connection_table.h"
 #include "upstream/host_port_key.h"
+#include "upstream/pool_prewarm.h"
 #include "config/server_config.h"
 #include "net/dns_resolver.h"    // ResolvedEndpoint — held via atomic shared_ptr
 #include <condition_variable>
 #include <unordered_set>
 // <memory>, <functional>, <deque>, <vector>, <chrono>, <atomic>, <mutex> provided by common.h
 
-// Forward declaration
+// Forward declarations
 class TlsClientContext;
+class TlsConnection;
+class TlsSessionCache;
 
 namespace OBSERVABILITY_NAMESPACE {
 class ObservabilityManager;
@@ -209,7 +212,8 @@ public:
     // from the adopted H1 idle pool. Called after AdoptAsH1Connection.
     void ReclassifyH2WaitersToAny(const std::string& upstream_name, int port);
 
-    // Evict expired idle connections. Called by timer handler.
+    // Evict expired idle connections, then top the idle pool back up to
+    // the pre-warm target. Called by timer handler.
     void EvictExpired();
 
     // Shutdown: close idle, reject new checkouts, force-close connecting,
@@ -363,6 +367,45 @@ public:
         return preconnect_skipped_cap_count_.load(std::memory_order_relaxed);
     }
 
+    // Upstream TLS handshakes by outcome (relaxed reads, same as above).
+    int64_t tls_handshakes_full() const noexcept {
+        return tls_handshakes_full_.load(std::memory_order_relaxed);
+    }
+    int64_t tls_handshakes_resumed() const noexcept {
+        return tls_handshakes_resumed_.load(std::memory_order_relaxed);
+    }
+
+    // Connects by reason (relaxed reads, same as above): checkouts that
+    // found no idle connection and waited on a connect, connects opened
+    // ahead of demand by MaybePrewarm, and idle connections borrowed from
+    // a sibling partition (pool.lend_idle_connections).
+    int64_t checkout_connects() const noexcept {
+        return checkout_connects_.load(std::memory_order_relaxed);
+    }
+    int64_t prewarm_connects() const noexcept {
+        return prewarm_connects_.load(std::memory_order_relaxed);
+    }
+    int64_t borrowed_connects() const noexcept {
+        return borrowed_connects_.load(std::memory_order_relaxed);
+    }
+    // Idle connections this partition handed to a sibling.
+    int64_t lent_connections() const noexcept {
+        return lent_connections_.load(std::memory_order_relaxed);
+    }
+
+    // Sibling partitions of the same upstream (one per other dispatcher)
+    // to borrow idle connections from when this partition is at its cap
+    // with checkouts queued. Set once by UpstreamHostPool before any
+    // checkout; empty (the default) disables lending. A lent connection
+    // carries one unit of max_connections with it, so the sum over the
+    // partitions stays at the configured cap.
+    void SetLendPeers(std::vector<PoolPartition*> peers) {
+        lend_peers_ = std::move(peers);
+    }
+    // This partition's current share of pool.max_connections. Dispatcher-
+    // thread-only; shifts by one per lent connection.
+    size_t MaxConnections() const { return partition_max_connections_; }
+
     // Partition liveness token. Captured by callers that outlive a
     // partition-destroy (delayed dispatcher tasks, donated H2 leases,
     // ProxyTransaction H2 path). The shared_ptr keeps the atomic alive
@@ -381,6 +424,18 @@ public:
                connecting_conns_.size();
     }
     size_t WaitQueueSize() const { return wait_queue_.size(); }
+    // Requests in flight or waiting on this partition: H1 leases, queued
+    // checkouts, and H2 streams. An H2 session's donated transport sits
+    // in active_conns_ too; it is counted through its streams instead.
+    // Dispatcher-thread-only, like the counts above.
+    int64_t OutstandingRequests() const {
+        const size_t h2_sessions = h2_table_.TotalConnections();
+        const size_t h1_active = active_conns_.size() > h2_sessions
+                                     ? active_conns_.size() - h2_sessions
+                                     : 0;
+        return static_cast<int64_t>(h1_active + wait_queue_.size() +
+                                    h2_table_.TotalActiveStreams());
+    }
 
     // Non-owning observer of the owning dispatcher. Used by H2 conns
     // (via the partition back-pointer) to drive timer cleanup during
@@ -414,6 +469,13 @@ public:
     // `service_name_` is ctor-initialised and never mutated.
     const std::string& service_name() const { return service_name_; }
 
+    // Active health-check metrics, emitted by the HealthChecker running
+    // on this partition's dispatcher. `outcome` is "success" | "failure";
+    // `endpoint` is the checked "ip:port". Same no-op rules as the pool
+    // gauge helpers below.
+    void EmitHealthCheck(const char* outcome);
+    void EmitHealthTransition(const std::string& endpoint, bool healthy);
+
     // Called by UpstreamH2Connection::AdoptLease to convert a per-request
     // lease bump into long-lived H2 donation. Caller already +1'd
     // inflight_leases_. Bump donated FIRST then decrement inflight so
@@ -682,8 +744,42 @@ private:
     std::atomic<int64_t> preconnect_fired_count_{0};
     std::atomic<int64_t> preconnect_skipped_cap_count_{0};
 
+    // Upstream TLS session reuse. The cache is null when TLS or
+    // tls.session_reuse is off; it is dispatcher-local like the rest of
+    // the partition. The counters feed /stats (full vs resumed).
+    std::shared_ptr<TlsSessionCache> tls_session_cache_;
+    std::atomic<int64_t> tls_handshakes_full_{0};
+    std::atomic<int64_t> tls_handshakes_resumed_{0};
+
+    // Idle pre-warming (pool.min_idle_connections / adaptive_min_idle).
+    // parking_connects_ counts connects still in connecting_conns_ that
+    // land in idle_conns_ instead of a lease: MaybePrewarm connects and
+    // connections adopted from a lending sibling.
+    PoolPrewarmPolicy prewarm_;
+    size_t parking_connects_ = 0;
+    std::atomic<int64_t> checkout_connects_{0};
+    std::atomic<int64_t> prewarm_connects_{0};
+    std::atomic<int64_t> borrowed_connects_{0};
+
+    // Cross-dispatcher lending (pool.lend_idle_connections).
+    // borrow_replies_pending_ counts OnLendReply tasks still owed by the
+    // peers for the current borrow round; a new round starts only when
+    // the previous one has fully answered.
+    std::vector<PoolPartition*> lend_peers_;
+    size_t borrow_replies_pending_ = 0;
+    std::atomic<int64_t> lent_connections_{0};
+
+    enum class ConnectReason { CHECKOUT, PREWARM, BORROWED };
+
     // Internal helpers
     void CreateNewConnection(ReadyCallback ready_cb, ErrorCallback error_cb);
+    // Second half of CreateNewConnection: wrap a socket whose non-blocking
+    // connect is in flight (or already established) and register it with
+    // this dispatcher. Completion arrives via OnConnectComplete.
+    void StartConnection(
+        int fd, sa_family_t family,
+        std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> endpoint,
+        ReadyCallback ready_cb, ErrorCallback error_cb);
     void OnConnectComplete(UpstreamConnection* conn,
                            ReadyCallback ready_cb, ErrorCallback error_cb);
     void OnConnectionClosed(UpstreamConnection* conn);
@@ -751,6 +847,25 @@ private:
     // Loops while capacity is available and waiters remain. Checks alive_
     // after each callback (user callbacks may tear down the partition).
     void CreateForWaiters();
+    // Open connections until idle + pre-warming reaches the policy
+    // target. No-op with waiters queued: CreateForWaiters owns new
+    // connects then, and the connections go to the waiters.
+    void MaybePrewarm();
+    // Ask every lend peer, on its own dispatcher, for up to one idle
+    // connection per queued waiter. No-op while a previous round is
+    // still being answered.
+    void MaybeBorrow();
+    // Lender side, on this partition's dispatcher: give idle connections
+    // to `borrower` while `budget` lasts, keeping at least one slot of
+    // this partition's share. Always answers with one OnLendReply.
+    void OnBorrowRequest(PoolPartition* borrower,
+                         std::shared_ptr<std::atomic<int>> budget);
+    // Borrower side: adopt the lent fd (if any) as a parked idle
+    // connection, which ServiceWaitQueue hands to the next waiter.
+    void OnLendReply(
+        std::vector<std::pair<
+            std::shared_ptr<int>,
+            std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint>>> lent);
     void ScheduleWaitQueuePurge();
     void DestroyConnection(std::unique_ptr<UpstreamConnection> conn);
 
@@ -796,4 +911,11 @@ private:
     // queued_satisfied / cancelled / queue_timeout. outcome label
     // allowlist enforced by the catalog cap (cap=8).
     void EmitCheckoutWaitDuration(double duration_sec, const char* outcome);
+    void EmitConnect(ConnectReason reason);
+
+    // Upstream TLS session reuse. AttachTlsSession binds a new client
+    // TlsConnection to tls_session_cache_ under "host:port/sni";
+    // EmitTlsHandshake counts a completed handshake as full or resumed.
+    void AttachTlsSession(TlsConnection& tls);
+    void EmitTlsHandshake(const ConnectionHandler& handler);
 };
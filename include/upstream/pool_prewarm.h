@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+// <chrono> provided by common.h
+
+// How many idle connections one PoolPartition keeps open ahead of demand
+// (pool.min_idle_connections, pool.adaptive_min_idle).
+//
+// The static floor is min_idle_connections. The adaptive floor is the
+// number of checkouts expected to arrive while one replacement connection
+// is opened: the recent checkout rate (exponentially decayed) times the
+// recent connect time (TCP + TLS). With that many warm connections a burst
+// is served from the idle pool while the pool catches up. The target is
+// the larger of the two floors, capped at max_idle_connections.
+//
+// Dispatcher-thread-only, like the partition that owns it.
+class PoolPrewarmPolicy {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Time constant of the checkout-rate average.
+    static constexpr double RATE_TAU_SEC = 10.0;
+    // Below this rate the adaptive floor is zero, so a quiet pool is not
+    // held open by the tail of an old burst.
+    static constexpr double MIN_ADAPTIVE_RATE = 0.1;
+    // Weight of the newest sample in the connect-time average.
+    static constexpr double CONNECT_TIME_ALPHA = 0.2;
+
+    explicit PoolPrewarmPolicy(const UpstreamPoolConfig& config);
+
+    bool enabled() const noexcept { return min_idle_ > 0 || adaptive_; }
+
+    void RecordCheckout(Clock::time_point now);
+    void RecordConnectTime(double seconds);
+
+    // Checkouts per second, decayed to `now`.
+    double CheckoutRate(Clock::time_point now) const;
+    double ConnectTime() const noexcept { return connect_sec_; }
+
+    // Idle connections the partition should hold at `now`.
+    size_t TargetIdle(Clock::time_point now) const;
+
+private:
+    const size_t min_idle_;
+    const size_t max_idle_;
+    const bool adaptive_;
+
+    double rate_ = 0.0;
+    Clock::time_point rate_at_{};
+    double connect_sec_ = 0.0;
+    bool connect_sampled_ = false;
+};
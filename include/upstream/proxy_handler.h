@@ -4,15 +4,21 @@
 #include "config/server_config.h"    // ProxyConfig definition (value member)
 #include "upstream/header_rewriter.h"
 #include "upstream/retry_policy.h"
+#include "upstream/response_cache.h"
+#include "upstream/singleflight.h"
+#include "upstream/hedged_request.h"
 #include "http/http_callbacks.h"
 // <string>, <functional> provided by common.h
 
 // Forward declarations
 class UpstreamManager;
+class HttpConnectionHandler;
+class ProxyTransaction;
 struct HttpRequest;
+struct WsTunnelContext;
 namespace AUTH_NAMESPACE { class AuthManager; }
 
-class ProxyHandler {
+class ProxyHandler : public std::enable_shared_from_this<ProxyHandler> {
 public:
     ProxyHandler(const std::string& service_name,
                  const ProxyConfig& config,
@@ -27,7 +33,10 @@ public:
                  // shared_ptr snapshot, and passes the snapshot through
                  // to HeaderRewriter::RewriteRequest. Null disables the
                  // auth overlay entirely (e.g. when auth.enabled=false).
-                 AUTH_NAMESPACE::AuthManager* auth_manager = nullptr);
+                 AUTH_NAMESPACE::AuthManager* auth_manager = nullptr,
+                 // Shared response cache; consulted only when
+                 // config.cache is set. Null disables caching.
+                 std::shared_ptr<ResponseCache> response_cache = nullptr);
     ~ProxyHandler();
 
     // Non-copyable, non-movable: routes capture a raw handler_ptr.
@@ -43,10 +52,71 @@ public:
                 HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
                 HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete);
 
+    // Same, with the route's interim sender so upstream 103 Early Hints
+    // can be relayed when config.relay_early_hints is set.
+    void Handle(const HttpRequest& request,
+                HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete);
+
+    // Proxy a WebSocket upgrade (config.websocket). Called from the
+    // HTTP/1 upgrade path after auth has run; the client is moved into
+    // the deferred window and answered by the WsTunnel once the
+    // upstream replies to the forwarded handshake.
+    void HandleWebSocket(std::shared_ptr<HttpConnectionHandler> client,
+                         const HttpRequest& request,
+                         std::shared_ptr<WsTunnelContext> context);
+
     // Access configuration for tests/logging
     const std::string& service_name() const { return service_name_; }
 
 private:
+    // Path sent upstream: the catch-all tail when strip_prefix captured
+    // one, else the request path minus static_prefix_. Same rules as
+    // ProxyTransaction::Start.
+    std::string UpstreamPathOverride(const HttpRequest& request) const;
+
+    // Start a ProxyTransaction for `request`.
+    std::shared_ptr<ProxyTransaction> Forward(const HttpRequest& request,
+                 HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                 HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                 HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete);
+
+    // Attach to the singleflight_ flight for `request`, leading it with
+    // a new transaction when none is in progress. Requests that may not
+    // be coalesced are forwarded on their own.
+    void HandleCoalesced(const HttpRequest& request,
+                         HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                         HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                         HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete);
+
+    // Race the primary attempt against a delayed hedge (retry.hedge).
+    void ForwardHedged(const HttpRequest& request,
+                       HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                       HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                       HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete);
+
+    // Serve from response_cache_ or forward with a cache fill attached.
+    // `follower` = resumed after a collapsed leader's fill finished.
+    void HandleCached(const HttpRequest& request,
+                      HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                      HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                      HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete,
+                      bool follower);
+
+    // Forward `request` with `fill` teeing the response into the cache.
+    // A null `complete` makes it a background request with no client.
+    void ForwardWithFill(const HttpRequest& request,
+                         HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+                         HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+                         HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete,
+                         std::shared_ptr<ResponseCache::Fill> fill);
+
+    // stale-while-revalidate: refresh `stale` off the client's path.
+    void RevalidateInBackground(const HttpRequest& request,
+                                const std::string& key,
+                                const ResponseCache::Lookup& stale);
+
     std::string service_name_;
     ProxyConfig config_;          // stored by value — not a reference
     bool upstream_tls_ = false;
@@ -59,6 +129,11 @@ private:
     // never observes a dangling manager pointer. Null when the server has
     // auth disabled or hasn't wired the manager yet.
     AUTH_NAMESPACE::AuthManager* auth_manager_ = nullptr;
+    std::shared_ptr<ResponseCache> response_cache_;
+    // Set when config.singleflight.enabled and the route has no cache.
+    std::shared_ptr<SingleflightGroup> singleflight_;
+    // Set when config.retry.hedge.enabled.
+    std::shared_ptr<HedgePolicy> hedge_policy_;
     HeaderRewriter header_rewriter_;
     RetryPolicy retry_policy_;
     std::string static_prefix_;        // Precomputed from route_prefix for strip_prefix
@@ -8,6 +8,7 @@
 #include "upstream/upstream_lease.h"
 #include "upstream/header_rewriter.h"
 #include "upstream/retry_policy.h"
+#include "upstream/grpc.h"
 #include "auth/auth_context.h"           // AuthContext (stored by value)
 #include "config/server_config.h"        // ProxyConfig (stored by value)
 #include "circuit_breaker/retry_budget.h" // RetryBudget::InFlightGuard (member-by-value)
@@ -23,6 +24,7 @@ class UpstreamManager;
 class ConnectionHandler;
 class Dispatcher;
 class UpstreamH2Connection;
+class ReplayBodyStream;
 
 namespace OBSERVABILITY_NAMESPACE {
 class ObservabilityManager;
@@ -158,6 +160,15 @@ public:
     // handler's abort hook, which always runs on the dispatcher).
     void Cancel();
 
+    // Downstream 1xx sender from the async route. Used only when
+    // config.relay_early_hints is set: the Link fields of upstream 103
+    // responses are forwarded as a downstream 103 while the final
+    // response is still pending. Call before Start().
+    void SetInterimResponseSender(
+        HTTP_CALLBACKS_NAMESPACE::InterimResponseSender sender) {
+        interim_sender_ = std::move(sender);
+    }
+
     // Hand the per-request snapshot to the transaction so Start() can
     // publish the bidirectional link. Once linked, the shutdown kill
     // loop can mark this transaction; terminal callbacks check the
@@ -207,6 +218,9 @@ public:
                                          : SEND_STALL_FALLBACK_MS;
     }
 
+    void OnInterimHeaders(
+        int status_code,
+        const std::vector<std::pair<std::string, std::string>>& headers) override;
     bool OnHeaders(
         const UPSTREAM_CALLBACKS_NAMESPACE::UpstreamResponseHead& head) override;
     bool OnBodyChunk(const char* data, size_t len) override;
@@ -238,11 +252,43 @@ public:
     // <reason>) without needing a live ProxyTransaction.
     static HttpResponse MakeErrorResponse(int result_code);
 
+    // gRPC mode: clients see a trailers-only response (HTTP 200,
+    // grpc-status, grpc-message) instead of an HTTP error status.
+    // GrpcStatusForResult maps a RESULT_* code onto the status code:
+    // timeouts → DEADLINE_EXCEEDED, local size caps →
+    // RESOURCE_EXHAUSTED, malformed upstream output → INTERNAL, the rest
+    // → UNAVAILABLE. Public + static for the same reason as above.
+    static int GrpcStatusForResult(int result_code);
+    static HttpResponse MakeGrpcErrorResponse(int grpc_status,
+                                              const std::string& message);
+
 private:
     // Allowlist for H2-path retries from OnError. H1 retries from
     // OnUpstreamData; H2 retries flow through OnError because the H2
     // codec surfaces every transport-level failure via sink->OnError
     // rather than the parser-driven H1 path.
+    // Swap a locally generated HTTP error for its gRPC trailers-only
+    // form when grpc_request_. Diagnostic X-* and Retry-After headers
+    // carry over. Identity for non-gRPC requests.
+    HttpResponse AdaptLocalError(HttpResponse response, int result_code) const;
+
+    // Header-wait budget for the current attempt: what is left of
+    // upstream_deadline_override_ms_ (floored at 1ms) when set, else
+    // config_.response_timeout_ms.
+    int ResponseTimeoutBudgetMs() const;
+    // upstream_deadline_override_ms_ minus time since start_time_; may
+    // be <= 0. Only meaningful when the override is set.
+    int64_t DeadlineRemainingMs() const;
+
+    // Reject a buffered gRPC request body whose framing is malformed or
+    // carries a message above max_message_bytes. Returns false after
+    // delivering the error.
+    bool ValidateGrpcRequestBody();
+
+    // Classify a gRPC status for the breaker once per attempt (trailers-
+    // only head or final trailers).
+    void ReportGrpcBreakerOutcome(int grpc_status);
+
     static bool IsH2RetryableCode(int result_code) noexcept;
     // Map an H2-retryable result code to the RetryPolicy condition.
     // Connect-style codes (peer never processed the stream) map to
@@ -295,6 +341,19 @@ private:
     // atomic which the pool inspects on every pop / sweep.
     std::shared_ptr<std::atomic<bool>> checkout_cancel_token_;
 
+    // Load balancing across a multi-endpoint upstream. `lb_hash_` is the
+    // request key for ring_hash / maglev (computed once, so every attempt
+    // hashes the same way); `attempt_partition_` is the endpoint picked
+    // for the current attempt by SelectAttemptPartition and used by the
+    // checkout and both H2 dispatch paths. Retries pick again.
+    uint64_t lb_hash_ = 0;
+    PoolPartition* attempt_partition_ = nullptr;
+    // Outlier-detection report for the current attempt: armed with the
+    // picked endpoint by SelectAttemptPartition, consumed by the first
+    // classified outcome so each attempt reports at most once.
+    const PoolPartition* outlier_partition_ = nullptr;
+    std::chrono::steady_clock::time_point outlier_attempt_start_{};
+
     // Request context (all copied at construction -- the original HttpRequest
     // is INVALIDATED by parser_.Reset() immediately after the async handler
     // returns, so no pointers/references to the original may be stored).
@@ -344,6 +403,8 @@ private:
     AUTH_NAMESPACE::AuthManager* auth_manager_ = nullptr;  // non-owning, nullable
     Dispatcher* dispatcher_;              // non-owning, outlives the transaction (for EnQueueDelayed)
     ProxyConfig config_;                  // stored by value — decoupled from ProxyHandler lifetime
+    // Downstream 1xx sender for relay_early_hints (empty = no relay).
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender interim_sender_;
     HeaderRewriter header_rewriter_;      // stored by value — small (4 bools config)
     RetryPolicy retry_policy_;            // stored by value — small (1 int + 5 bools config)
 
@@ -510,13 +571,35 @@ private:
     // (RESULT_RETRY_DENIED_NON_IDEMPOTENT_HEADERS_QUEUED).
     bool request_headers_submitted_ = false;
 
-    // RESERVED: per-request upstream-deadline override (ms). 0 = use
-    // ProxyConfig default. API surface for the future gRPC
-    // `grpc-timeout` decorator; no middleware writes this today and
-    // neither DispatchH1 nor DispatchH2 reads it. Kept as the wiring
-    // point for the eventual gRPC plumbing.
+    // Per-request upstream deadline (ms from start_time_). 0 = use
+    // ProxyConfig::response_timeout_ms. Seeded from
+    // HttpRequest::upstream_deadline_override_ms, else from the client's
+    // grpc-timeout in gRPC mode. When set, ResponseTimeoutBudgetMs()
+    // returns what is left of it, so every attempt (retries included)
+    // and the body phase share one deadline.
     int upstream_deadline_override_ms_ = 0;
 
+    // ---- gRPC mode (config_.grpc) ----
+
+    // True when config_.grpc.enabled and the request content-type is
+    // application/grpc[+fmt]. Everything below is inert otherwise.
+    bool grpc_request_ = false;
+    GRPC_NAMESPACE::StatusSet grpc_retry_on_ = 0;
+    GRPC_NAMESPACE::StatusSet grpc_breaker_failure_on_ = 0;
+    // From the request path; empty when the path is not /Service/Method.
+    std::string grpc_service_;
+    std::string grpc_method_;
+    // grpc-status of the current attempt (trailers-only head or final
+    // trailers). -1 until seen. Reset per attempt.
+    int grpc_status_ = -1;
+    // The held 5xx-retry machinery is driving a trailers-only gRPC
+    // failure rather than an HTTP 5xx: ShouldRetryResponse5xx and
+    // MaybeRetry consult RetryCondition::GRPC_STATUS instead.
+    bool grpc_status_retry_ = false;
+    // Validates Length-Prefixed-Message framing of the response body.
+    // Rebuilt at every OnHeaders.
+    GRPC_NAMESPACE::MessageFramer grpc_response_framer_;
+
     // H1-side parallel to h2_request_fully_sent_. Set when the H1
     // streaming send loop emits its final chunk terminator. Used by
     // SendH1StreamingRequest_'s send-stall fallback.
@@ -552,6 +635,10 @@ private:
     // Active BodyStream for the current streaming request attempt.
     // Non-null when is_streaming_request_=true and the send phase is active.
     std::shared_ptr<http::BodyStream> body_stream_;
+    // Set when config_.retry.replay_buffer is on: body_stream_ is this
+    // recorder wrapped around the client's stream, and a retry rewinds
+    // it instead of being refused once body bytes have been read.
+    std::shared_ptr<ReplayBodyStream> replay_body_;
 
     // Last time the H2 codec emitted a request-side DATA frame.
     // Updated by OnRequestBodyProgress; inspected by the single
@@ -674,6 +761,7 @@ private:
     bool PrepareAttemptAdmission();
     void ActivateAttemptTracking();
     void EnsureCheckoutCancelToken();
+    void SelectAttemptPartition();
     void StartCheckoutAsync();
     // Per-attempt observability setup: resets current_attempt_, captures
     // attempt_start_steady_, allocates the CLIENT span (when sampled),
@@ -832,6 +920,12 @@ private:
     // vs timeout since the slice treats them differently only for logs.
     void ReportBreakerOutcome(int result_code);
 
+    // Feed the attempt's outcome to the upstream's outlier detector
+    // (multi-endpoint upstreams only). Called from ReportBreakerOutcome
+    // ahead of its slice guard, so it runs with or without a breaker
+    // admission. Local and policy outcomes are not reported.
+    void ReportOutlierOutcome(int result_code);
+
     // ReleaseBreakerAdmissionNeutral: release the admission slot without
     // counting a success or failure. Used when the transaction is aborted
     // locally (Cancel() on client disconnect, cancelled_ early-return
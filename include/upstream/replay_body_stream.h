@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "http/body_stream.h"
+// <string>, <memory>, <vector> provided by common.h
+
+class Dispatcher;
+
+// BodyStream decorator that records what the consumer reads from a
+// streamed request body (proxy.retry.replay_buffer) so a retry can send
+// it again. Reads after Rewind() are served from the recording until it
+// is exhausted, then from the source, which keeps being recorded.
+//
+// The first memory_bytes are held in memory; the rest are appended to an
+// unlinked temp file in spill_dir and read back through a read-only
+// mapping. Past max_bytes, or after StopRecording(), the recording is
+// dropped and the stream becomes a plain pass-through that can no longer
+// be rewound.
+//
+// Producer-side calls forward to the source. Consumer-side calls,
+// Rewind and StopRecording run on the consumer dispatcher only.
+class ReplayBodyStream : public http::BodyStream {
+public:
+    ReplayBodyStream(std::shared_ptr<http::BodyStream> source,
+                     const ProxyReplayBufferConfig& config);
+    ~ReplayBodyStream() override;
+
+    ReplayBodyStream(const ReplayBodyStream&) = delete;
+    ReplayBodyStream& operator=(const ReplayBodyStream&) = delete;
+
+    // Restart from the first byte. False when the recording is gone
+    // (max_bytes exceeded, spill I/O failure, StopRecording).
+    bool Rewind();
+    // No further retry is possible: free the recording.
+    void StopRecording();
+
+    bool recording() const noexcept { return !dropped_ && !stop_requested_; }
+    size_t recorded_bytes() const noexcept { return recorded_; }
+    size_t spilled_bytes() const noexcept { return spilled_; }
+
+    // ---- BodyStream consumer-side overrides ----
+    http::BodyStreamResult Read(char* buf, size_t max_len, size_t* bytes_read) override;
+    bool IsEndOfStream() const override;
+    bool Aborted() const override;
+    const std::vector<std::pair<std::string, std::string>>& Trailers() const override;
+    const std::string& AbortReason() const override;
+    void WaitForData(DataAvailableCallback callback) override;
+    size_t BytesQueued() const override;
+
+    // ---- BodyStream producer-side overrides ----
+    void Push(std::string chunk) override;
+    void PushTrailersAndClose(std::vector<std::pair<std::string, std::string>> trailers) override;
+    void CloseEmpty() override;
+    void Abort(std::string reason) override;
+
+    // ---- Shape-decision + late-binding overrides ----
+    SubmitSnapshot SnapshotForSubmit() override;
+    void SetConsumerDispatcher(std::weak_ptr<Dispatcher> d) override;
+
+private:
+    // Append freshly read source bytes; false when they do not fit.
+    bool Record(const char* data, size_t len);
+    bool Spill(const char* data, size_t len);
+    void Drop(const char* why);
+    size_t ReadRecorded(char* buf, size_t max_len);
+
+    std::shared_ptr<http::BodyStream> source_;
+    const size_t max_bytes_;
+    const size_t memory_bytes_;
+    const std::string spill_dir_;
+    std::weak_ptr<Dispatcher> consumer_dispatcher_;
+
+    std::string memory_;            // bytes [0, memory_.size())
+    int spill_fd_ = -1;             // bytes [memory_bytes_, recorded_)
+    size_t spilled_ = 0;
+    void* map_ = nullptr;           // spill file, mapped at Rewind
+    size_t map_len_ = 0;
+
+    size_t recorded_ = 0;
+    size_t cursor_ = 0;             // next byte Read() returns
+    bool dropped_ = false;
+    bool stop_requested_ = false;   // drop once the replay catches up
+};
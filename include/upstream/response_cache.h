@@ -0,0 +1,296 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "sharded_lru_cache.h"
+// <string>, <vector>, <map>, <memory>, <mutex>, <atomic>, <chrono>,
+// <functional>, <unordered_map> provided by common.h
+
+class Dispatcher;
+class HttpResponse;
+struct HttpRequest;
+
+namespace OBSERVABILITY_NAMESPACE {
+class ObservabilityManager;
+}  // namespace OBSERVABILITY_NAMESPACE
+
+// Shared RFC 9111 cache for proxied GET responses, consulted by every
+// ProxyHandler whose route sets proxy.cache.
+//
+// Storage is two-tiered. Entries land in the memory tier; when its byte
+// budget is exceeded the least recently used URLs are written to
+// unlinked files under proxy_cache.disk_path and served from read-only
+// mappings until the disk budget pushes them out too. Both tiers index
+// by the primary key (service, Host, request target) in a
+// ShardedLruCache; each index value holds every stored variant of that
+// URL, selected by the request headers the response's Vary names.
+//
+// Freshness follows RFC 9111 §4.2 for explicit lifetimes only
+// (s-maxage, max-age, Expires); responses without one are not stored.
+// Stale entries carrying stale-while-revalidate are served while a
+// background request refreshes them; stale-if-error lets a stale entry
+// answer when the upstream fails. Expired entries with a validator are
+// revalidated with a conditional request.
+//
+// Threading: lookups and stores run on any dispatcher. Entries are
+// immutable once published; a refresh publishes a new Entry.
+class ResponseCache : public std::enable_shared_from_this<ResponseCache> {
+public:
+    enum class Tier { MEMORY, DISK };
+    static const char* TierName(Tier tier) noexcept;
+
+    // Outcome reported once per cacheable client request.
+    //   hit         — fresh entry served
+    //   stale       — stale entry served (stale-while-revalidate, or
+    //                 stale-if-error on an upstream failure)
+    //   revalidated — upstream answered 304 to the cache's conditional
+    //   collapsed   — served from the fill of a concurrent identical miss
+    //   miss        — answered by the upstream
+    //   bypass      — request not eligible (method, Authorization,
+    //                 Range, Cache-Control: no-store)
+    enum class Result { HIT, STALE, REVALIDATED, COLLAPSED, MISS, BYPASS };
+    static constexpr size_t RESULT_COUNT = 6;
+    static const char* ResultName(Result result) noexcept;
+
+    // Stored body bytes: a heap string in the memory tier, a read-only
+    // mapping of an unlinked file in the disk tier. Holds its tier's
+    // byte charge until destroyed, so readers still serving an evicted
+    // body keep it accounted.
+    class Body {
+    public:
+        ~Body();
+        Body(const Body&) = delete;
+        Body& operator=(const Body&) = delete;
+
+        const char* data() const noexcept;
+        size_t size() const noexcept;
+        Tier tier() const noexcept { return tier_; }
+
+    private:
+        friend class ResponseCache;
+        Body(Tier tier, std::shared_ptr<std::atomic<int64_t>> usage,
+             int64_t charge);
+
+        Tier tier_;
+        std::string heap_;
+        void* map_ = nullptr;
+        size_t map_len_ = 0;
+        std::shared_ptr<std::atomic<int64_t>> usage_;
+        int64_t charge_ = 0;
+    };
+
+    struct Entry {
+        int status_code = 200;
+        std::string status_reason;
+        // Client-facing headers without Age and framing fields.
+        std::vector<std::pair<std::string, std::string>> headers;
+        std::shared_ptr<const Body> body;
+        // Request header values this variant answers, parallel to the
+        // owning record's Vary names. "" = header absent.
+        std::vector<std::string> vary_values;
+
+        std::chrono::steady_clock::time_point response_time;
+        int64_t initial_age_sec = 0;
+        int64_t freshness_lifetime_sec = 0;
+        int64_t stale_while_revalidate_sec = 0;
+        int64_t stale_if_error_sec = 0;
+        // must-revalidate / proxy-revalidate: never served stale.
+        bool must_revalidate = false;
+        std::string etag;
+        std::string last_modified;
+        // Time the upstream took to produce this response; credited to
+        // reactor.proxy.cache.origin_latency_saved on every hit.
+        std::chrono::microseconds origin_latency{0};
+
+        int64_t AgeSec(std::chrono::steady_clock::time_point now) const;
+    };
+
+    enum class Usability { FRESH, STALE_WHILE_REVALIDATE, STALE_IF_ERROR, STALE };
+
+    struct Lookup {
+        std::shared_ptr<const Entry> entry;  // null on miss
+        std::vector<std::string> vary;       // Vary names of the URL, if stored
+        Usability usability = Usability::STALE;
+        int64_t age_sec = 0;
+    };
+
+    // How a request may use the cache.
+    //   BYPASS  — neither served from nor stored in the cache
+    //   REFRESH — forwarded (no-cache / Pragma: no-cache); the response
+    //             may replace the stored one
+    //   LOOKUP  — normal lookup
+    enum class RequestPolicy { BYPASS, REFRESH, LOOKUP };
+    static RequestPolicy ClassifyRequest(const HttpRequest& request);
+
+    // GET and HEAD share a key: a stored GET answers a HEAD.
+    static std::string PrimaryKey(const std::string& service,
+                                  const HttpRequest& request);
+
+    explicit ResponseCache(const ProxyCacheConfig& config);
+    ~ResponseCache();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+    void SetObservabilityManager(
+        OBSERVABILITY_NAMESPACE::ObservabilityManager* obs_manager) noexcept {
+        obs_manager_.store(obs_manager, std::memory_order_release);
+    }
+
+    bool collapse_requests() const noexcept { return config_.collapse_requests; }
+    bool disk_enabled() const noexcept { return disk_enabled_; }
+
+    Lookup Find(const std::string& key, const HttpRequest& request,
+                std::chrono::steady_clock::time_point now);
+
+    // Drop every variant of `key` from both tiers (RFC 9111 §4.4: a
+    // successful unsafe request invalidates the target URI).
+    void Invalidate(const std::string& key);
+
+    // Build the client response for `entry`, with an Age header.
+    // `with_body` = false yields the head for a streaming sender.
+    static HttpResponse BuildResponse(const Entry& entry, int64_t age_sec,
+                                      bool with_body = true);
+
+    // Request collapsing. Returns true when no fill for `collapse_key`
+    // is in flight: the caller now leads it and must hand the key to a
+    // Fill, which releases it. Otherwise `resume` (when set) is queued
+    // and posted to `dispatcher` once the leader's response has been
+    // stored or abandoned.
+    bool JoinOrLead(const std::string& collapse_key, Dispatcher* dispatcher,
+                    std::function<void()> resume);
+    // Key followers wait on: the primary key plus the request's values
+    // for the URL's known Vary names.
+    static std::string CollapseKey(const std::string& key,
+                                   const HttpRequest& request,
+                                   const std::vector<std::string>& vary);
+
+    // Report an outcome answered straight from `entry` (hit, stale,
+    // collapsed) or an origin-bound one (entry null).
+    void RecordResult(const std::string& service, Result result,
+                      const Entry* entry, bool head_only);
+
+    // Captures one upstream response for the cache while the proxy
+    // relays it. Dispatcher thread of the request only.
+    class Fill {
+    public:
+        Fill(std::shared_ptr<ResponseCache> cache,
+             std::string service,
+             std::string key,
+             std::string collapse_key,
+             const HttpRequest& request,
+             Lookup stale,
+             bool conditional_added,
+             bool client_request);
+        ~Fill();
+
+        Fill(const Fill&) = delete;
+        Fill& operator=(const Fill&) = delete;
+
+        // Final response head (streaming) or whole buffered response.
+        // Returns the entry to send instead: a 304 to the cache's own
+        // conditional, or an upstream error covered by stale-if-error.
+        std::shared_ptr<const Entry> OnResponseHead(const HttpResponse& response);
+        void OnBody(const char* data, size_t len);
+        // `clean` = the body arrived whole with no trailers.
+        void OnComplete(bool clean);
+
+        int64_t AgeOf(const Entry& entry) const;
+
+    private:
+        void Release();
+
+        std::shared_ptr<ResponseCache> cache_;
+        std::string service_;
+        std::string key_;
+        std::string collapse_key_;
+        std::map<std::string, std::string> request_headers_;
+        Lookup stale_;
+        bool conditional_added_;
+        bool client_request_;
+        std::chrono::steady_clock::time_point started_at_;
+
+        std::shared_ptr<Entry> pending_;
+        std::vector<std::string> pending_vary_;
+        std::string body_;
+        Result result_ = Result::MISS;
+        bool done_ = false;
+    };
+
+    // Tier occupancy in bytes (bodies + headers), and stored URLs.
+    int64_t memory_bytes() const noexcept {
+        return memory_usage_->load(std::memory_order_relaxed);
+    }
+    int64_t disk_bytes() const noexcept {
+        return disk_usage_->load(std::memory_order_relaxed);
+    }
+    size_t memory_entries() const { return memory_.Size(); }
+    size_t disk_entries() const { return disk_.Size(); }
+    int64_t results(Result result) const noexcept {
+        return results_[static_cast<size_t>(result)].load(
+            std::memory_order_relaxed);
+    }
+
+private:
+    // Every stored variant of one URL.
+    struct Record {
+        std::string key;
+        std::vector<std::string> vary;
+        std::vector<std::shared_ptr<const Entry>> variants;
+        int64_t charge = 0;
+        // use_clock_ tick of the last lookup or store; orders shard
+        // tails for eviction.
+        mutable std::atomic<uint64_t> last_use{0};
+    };
+    using RecordPtr = std::shared_ptr<const Record>;
+    using Index = UTIL_NAMESPACE::ShardedLruCache<std::string, RecordPtr>;
+
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t MAX_VARIANTS = 8;
+
+    using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+    // Build an Entry (without body) from a response head; null when the
+    // response must not be stored. Fills `vary_out` with its Vary names.
+    static std::shared_ptr<Entry> MakeEntry(
+        int status_code, const std::string& status_reason,
+        const HeaderList& headers,
+        const std::map<std::string, std::string>& request_headers,
+        std::vector<std::string>& vary_out,
+        std::chrono::microseconds origin_latency);
+    // RFC 9111 §4.3.4: `stored` with the header fields of a 304 applied.
+    static std::shared_ptr<Entry> Refresh(
+        const Entry& stored, const HeaderList& not_modified_headers,
+        const std::map<std::string, std::string>& request_headers,
+        std::vector<std::string>& vary_out,
+        std::chrono::microseconds origin_latency);
+    std::shared_ptr<const Body> MakeMemoryBody(std::string bytes, int64_t header_bytes);
+    std::shared_ptr<const Body> MakeDiskBody(const Body& source);
+
+    void Store(const std::string& key, const std::vector<std::string>& vary,
+               std::shared_ptr<const Entry> entry);
+    // Evict the least recently used shard tail from `tier` until it is
+    // within budget; memory evictions move to the disk tier when it is
+    // enabled.
+    void EnforceBudget(Tier tier);
+    RecordPtr Demote(const Record& record);
+    void ReleaseFill(const std::string& collapse_key);
+
+    ProxyCacheConfig config_;
+    bool disk_enabled_ = false;
+    Index memory_;
+    Index disk_;
+    std::shared_ptr<std::atomic<int64_t>> memory_usage_;
+    std::shared_ptr<std::atomic<int64_t>> disk_usage_;
+    std::atomic<uint64_t> use_clock_{0};
+
+    struct Waiter {
+        Dispatcher* dispatcher;
+        std::function<void()> resume;
+    };
+    std::mutex fills_mtx_;
+    std::unordered_map<std::string, std::vector<Waiter>> fills_;
+
+    std::array<std::atomic<int64_t>, RESULT_COUNT> results_{};
+    std::atomic<OBSERVABILITY_NAMESPACE::ObservabilityManager*> obs_manager_{nullptr};
+};
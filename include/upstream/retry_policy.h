@@ -12,6 +12,7 @@ public:
         bool retry_on_timeout = false;          // Retry on response timeout
         bool retry_on_disconnect = true;        // Retry when upstream closes mid-response
         bool retry_non_idempotent = false;      // Retry POST/PATCH/DELETE (dangerous)
+        bool retry_on_grpc_status = false;      // Retry on a grpc.retry_on status (gRPC mode)
         // Retry conditions are ORed -- any matching condition triggers a retry.
     };
 
@@ -20,7 +21,11 @@ public:
         CONNECT_FAILURE,      // Upstream connect failed or refused
         RESPONSE_5XX,         // Upstream returned 5xx status
         RESPONSE_TIMEOUT,     // Response not received within timeout
-        UPSTREAM_DISCONNECT   // Upstream closed connection before full response
+        UPSTREAM_DISCONNECT,  // Upstream closed connection before full response
+        GRPC_STATUS           // Trailers-only gRPC response with a retry_on status.
+                              // Not subject to the idempotency gate: every gRPC
+                              // call is a POST, and the operator opted in per
+                              // status code.
     };
 
     explicit RetryPolicy(const Config& config);
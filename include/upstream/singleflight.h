@@ -0,0 +1,164 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+#include "http/http_callbacks.h"
+#include "http/http_response.h"
+// <string>, <vector>, <deque>, <memory>, <mutex>, <atomic>, <functional>,
+// <unordered_map> provided by common.h
+
+class Dispatcher;
+struct HttpRequest;
+
+// Request coalescing for one proxy route (proxy.singleflight).
+//
+// Concurrent identical GET/HEAD requests attach to a single Flight: the
+// first client leads it and starts one upstream transaction whose
+// response the flight multicasts to every attached client. Streamed
+// bodies are kept as refcounted chunks shared by all waiters, so a
+// client that joins after the response head arrived is replayed the
+// head and every chunk so far before following the live stream. Once
+// the retained chunks exceed max_replay_bytes the flight stops taking
+// joiners and drops chunks every waiter has already been sent.
+//
+// Threading: the upstream transaction reports to the flight on the
+// leader's dispatcher; each waiter is written to on its own dispatcher
+// by tasks the flight posts there. A flight outlives its leader: the
+// upstream transaction is cancelled only once every waiter has gone.
+class SingleflightGroup : public std::enable_shared_from_this<SingleflightGroup> {
+public:
+    using StreamingSender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender;
+    using Completion = HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback;
+
+    // One shared upstream request and the clients waiting on it.
+    class Flight : public std::enable_shared_from_this<Flight> {
+    public:
+        Flight(std::weak_ptr<SingleflightGroup> group, std::string key,
+               Dispatcher* upstream_dispatcher, int64_t max_replay_bytes);
+
+        Flight(const Flight&) = delete;
+        Flight& operator=(const Flight&) = delete;
+
+        // Sender and completion callback for the upstream transaction.
+        // Dispatcher thread of the leader only.
+        StreamingSender UpstreamSender();
+        Completion UpstreamCompletion();
+
+        // Hook that cancels the upstream transaction; run from the
+        // dispatcher of whichever waiter leaves last.
+        void SetCancel(std::function<void()> cancel);
+
+    private:
+        friend class SingleflightGroup;
+        class UpstreamSenderImpl;
+
+        struct Waiter {
+            Dispatcher* dispatcher = nullptr;
+            StreamingSender sender;
+            Completion complete;
+            bool done = false;            // answered, cancelled or closed
+            bool head_sent = false;
+            size_t cursor = 0;            // absolute index of next chunk
+            bool pump_scheduled = false;
+            bool above_water = false;
+        };
+
+        enum class Terminal { NONE, END, ABORT, RESPONSE };
+
+        // Attach a waiter; false when the flight no longer takes them.
+        // Caller holds the group's map lock.
+        bool Attach(Dispatcher* dispatcher, StreamingSender sender,
+                    Completion complete, size_t* index);
+        void Detach(size_t index);
+
+        // Upstream side.
+        int PublishHead(const HttpResponse& response);
+        StreamingSender::SendResult PublishData(const char* data, size_t len);
+        void PublishEnd(const std::vector<std::pair<std::string, std::string>>& trailers);
+        void PublishAbort(StreamingSender::AbortReason reason);
+        void PublishResponse(HttpResponse response);
+        void SetUpstreamDrainListener(StreamingSender::DrainListener listener);
+
+        // Waiter side; flight lock held.
+        void ScheduleAllLocked();
+        void ScheduleLocked(size_t index);
+        void FinishWaiterLocked(Waiter& waiter);
+        void TrimLocked();
+        void ReleaseDrainLocked();
+        // Send waiter `index` everything it has not been sent yet.
+        void Pump(size_t index);
+        void OnWaiterDrained(size_t index);
+        void Retire();
+
+        std::weak_ptr<SingleflightGroup> group_;
+        const std::string key_;
+        Dispatcher* const upstream_dispatcher_;
+        const int64_t max_replay_bytes_;
+
+        std::mutex mtx_;
+        std::vector<Waiter> waiters_;
+        size_t live_ = 0;
+        bool closed_ = false;    // no new waiters
+        std::function<void()> cancel_;
+        bool cancelled_ = false;
+
+        bool has_head_ = false;
+        HttpResponse head_;
+        std::deque<std::shared_ptr<const std::string>> chunks_;
+        size_t first_chunk_ = 0;           // absolute index of chunks_.front()
+        int64_t retained_bytes_ = 0;
+        Terminal terminal_ = Terminal::NONE;
+        std::vector<std::pair<std::string, std::string>> trailers_;
+        StreamingSender::AbortReason abort_reason_ =
+            StreamingSender::AbortReason::UPSTREAM_ERROR;
+        std::shared_ptr<const HttpResponse> response_;
+
+        // Backpressure: the upstream is paused while any live waiter's
+        // connection is above its high-water mark.
+        size_t above_water_ = 0;
+        bool upstream_paused_ = false;
+        StreamingSender::DrainListener upstream_drain_;
+    };
+
+    SingleflightGroup(std::string service, const ProxySingleflightConfig& config);
+
+    SingleflightGroup(const SingleflightGroup&) = delete;
+    SingleflightGroup& operator=(const SingleflightGroup&) = delete;
+
+    // Coalescing key for `request`: method, Host, path, query and the
+    // configured key headers. "" when the request must not share an
+    // upstream transaction (method, body, credentials or Range not in
+    // the key, HTTP/1.0 client).
+    std::string KeyFor(const HttpRequest& request) const;
+
+    // Attach a client to the flight for `key`, starting one when none
+    // is in progress. Returns the new flight when the caller leads it
+    // and must start the upstream request wired to its UpstreamSender
+    // and UpstreamCompletion; null when the client joined a flight
+    // already in progress. Either way the response reaches the client
+    // through `sender` / `complete` on `dispatcher`, and its cancel
+    // slot detaches it.
+    std::shared_ptr<Flight> Join(const std::string& key,
+                                 const HttpRequest& request,
+                                 Dispatcher* dispatcher,
+                                 StreamingSender sender,
+                                 Completion complete);
+
+    // Flights currently taking joiners, and clients served by another
+    // client's upstream request.
+    size_t inflight() const;
+    int64_t coalesced() const noexcept {
+        return coalesced_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Drop `flight` from the map if it is still the one under `key`.
+    void Remove(const std::string& key, const Flight* flight);
+
+    std::string service_;
+    ProxySingleflightConfig config_;   // key_headers lowercased
+
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, std::shared_ptr<Flight>> flights_;
+    std::atomic<int64_t> coalesced_{0};
+};
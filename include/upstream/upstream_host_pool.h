@@ -2,6 +2,9 @@
 
 #include "common.h"
 #include "upstream/pool_partition.h"
+#include "upstream/load_balancer.h"
+#include "upstream/health_checker.h"
+#include "circuit_breaker/outlier_detector.h"
 #include "config/server_config.h"
 #include "net/dns_resolver.h"    // ResolvedEndpoint threaded through to partitions
 // <memory>, <vector>, <string> provided by common.h
@@ -10,6 +13,38 @@ class TlsClientContext;
 
 class UpstreamHostPool {
 public:
+    // One configured backend (UpstreamConfig::EffectiveEndpoints entry)
+    // with its DNS result. Every address in `resolved->addrs` becomes a
+    // pool member with its own per-dispatcher partitions.
+    struct EndpointSpec {
+        std::string host;
+        int port = 0;
+        int weight = 1;
+        std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> resolved;
+    };
+
+    // Multi-endpoint pool. Members are fixed here: a later reload can
+    // re-point a member at a new address of the same endpoint, but the
+    // member count (and the ring-hash / Maglev tables built over it)
+    // changes only on restart. Pool limits apply per member.
+    UpstreamHostPool(const std::string& service_name,
+                     const std::string& host, int port,
+                     const std::string& sni_hostname,
+                     std::vector<EndpointSpec> endpoints,
+                     const LoadBalancerConfig& load_balancer,
+                     const UpstreamPoolConfig& config,
+                     const std::vector<std::shared_ptr<Dispatcher>>& dispatchers,
+                     std::shared_ptr<TlsClientContext> tls_ctx,
+                     std::atomic<int64_t>& outstanding_conns,
+                     std::atomic<int64_t>& inflight_leases,
+                     std::atomic<int64_t>& donated_h2_leases,
+                     std::shared_ptr<std::atomic<int64_t>>
+                         off_dispatcher_release_drops,
+                     std::atomic<bool>& manager_shutting_down,
+                     std::mutex& drain_mtx,
+                     std::condition_variable& drain_cv);
+
+    // Single-endpoint pool for `host`:`port`.
     UpstreamHostPool(const std::string& service_name,
                      const std::string& host, int port,
                      const std::string& sni_hostname,
@@ -31,9 +66,64 @@ public:
     UpstreamHostPool(const UpstreamHostPool&) = delete;
     UpstreamHostPool& operator=(const UpstreamHostPool&) = delete;
 
-    // Get the partition for a specific dispatcher (by index)
+    // Get the first member's partition for a specific dispatcher (by
+    // index) — the only partition of a single-endpoint pool.
     PoolPartition* GetPartition(size_t dispatcher_index);
 
+    // Load-balanced partition for one attempt on `dispatcher_index`.
+    // `hash` is the request key from RequestHash (0 = none). Must be
+    // called on that dispatcher: the balancer state is per dispatcher.
+    PoolPartition* PickPartition(size_t dispatcher_index, uint64_t hash);
+
+    // Every member's partition on one dispatcher / on all dispatchers.
+    std::vector<PoolPartition*> PartitionsFor(size_t dispatcher_index) const;
+    std::vector<PoolPartition*> AllPartitions() const;
+
+    // Request key for the ring_hash / maglev policies, from the
+    // configured load_balancer.hash_key. 0 for the other policies and
+    // for requests without the key (e.g. the header is absent).
+    uint64_t RequestHash(const std::string& client_ip,
+                         const std::string& path,
+                         const std::map<std::string, std::string>& headers) const;
+
+    // Start one active health checker per member (no-op when disabled
+    // or already started). Each runs on a dispatcher where the member's
+    // partition has capacity; results gate the member's eligibility in
+    // PickPartition. Members start healthy.
+    void StartHealthChecks(const UpstreamHealthCheckConfig& health_check);
+
+    // False only when health checks run and every member is unhealthy.
+    // Any thread.
+    bool HasHealthyEndpoint() const noexcept {
+        return unhealthy_count_->load(std::memory_order_acquire) <
+               static_cast<int64_t>(members_.size());
+    }
+    bool member_healthy(size_t member_index) const noexcept {
+        return members_[member_index].healthy->load(std::memory_order_acquire);
+    }
+    int64_t health_checks_passed() const noexcept;
+    int64_t health_checks_failed() const noexcept;
+
+    // Create the passive outlier detector for a multi-endpoint pool and
+    // start its per-dispatcher sweeps (no-op for a single member or when
+    // already started). The detector exists whether or not outlier
+    // detection is enabled, so ReloadOutlierDetection can turn it on.
+    // Ejected members are skipped by PickPartition.
+    void StartOutlierDetection(const CircuitBreakerConfig& circuit_breaker);
+    void ReloadOutlierDetection(const CircuitBreakerConfig& circuit_breaker);
+
+    // Feed one attempt outcome against `partition` (a partition of this
+    // pool on `dispatcher_index`) to the outlier detector. `latency_ms`
+    // < 0 when no response arrived. Dispatcher thread only; no-op
+    // without a detector.
+    void RecordOutcome(size_t dispatcher_index, const PoolPartition* partition,
+                       bool failure, int64_t latency_ms);
+
+    // Null for single-endpoint pools.
+    CIRCUIT_BREAKER_NAMESPACE::OutlierDetector* outlier_detector() const noexcept {
+        return outlier_detector_.get();
+    }
+
     // Shutdown all partitions (enqueues to each dispatcher).
     // server_drain_timeout_sec plumbed through from UpstreamManager so
     // each partition's H2 graceful-drain budget is bounded by the
@@ -41,28 +131,60 @@ public:
     // for the 0-sentinel semantic.
     void InitiateShutdown(int server_drain_timeout_sec = 0);
 
-    // Reload-time endpoint swap. For each partition, release-stores the
-    // new endpoint and enqueues a best-effort idle-cleanup task if the
-    // endpoint changed. Synchronous on the caller's thread; does NOT
-    // wait for the async cleanup tasks.
+    // Reload-time endpoint swap for endpoint `endpoint_index`. For each
+    // of its members' partitions, release-stores the new address and
+    // enqueues a best-effort idle-cleanup task if it changed. Member k
+    // takes address k (mod the new address count). Synchronous on the
+    // caller's thread; does NOT wait for the async cleanup tasks.
     void UpdateResolvedEndpoint(
-        std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> new_ep);
+        std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> new_ep,
+        size_t endpoint_index = 0);
 
     const std::string& service_name() const { return service_name_; }
     const std::string& host() const { return host_; }
     int port() const { return port_; }
-    size_t partition_count() const { return partitions_.size(); }
+    // Dispatcher count: partitions per member.
+    size_t partition_count() const { return dispatchers_.size(); }
+    size_t endpoint_count() const { return endpoint_count_; }
+    size_t member_count() const { return members_.size(); }
     int64_t preconnect_fired_count() const noexcept;
     int64_t preconnect_skipped_cap_count() const noexcept;
+    int64_t tls_handshakes_full() const noexcept;
+    int64_t tls_handshakes_resumed() const noexcept;
 
 private:
+    // One connect target: an address of a configured endpoint.
+    struct Member {
+        size_t endpoint_index = 0;
+        size_t addr_index = 0;
+        // Active health-check verdict. Written by the member's checker
+        // on its dispatcher, read by PickPartition on every dispatcher.
+        std::shared_ptr<std::atomic<bool>> healthy =
+            std::make_shared<std::atomic<bool>>(true);
+        // One partition per dispatcher. Index matches dispatcher index.
+        std::vector<std::unique_ptr<PoolPartition>> partitions;
+    };
+
     std::string service_name_;
     std::string host_;
     int port_;
     UpstreamPoolConfig config_;
+    LoadBalancerConfig lb_config_;
+    size_t endpoint_count_ = 0;
 
-    // One partition per dispatcher. Index matches dispatcher index.
-    std::vector<std::unique_ptr<PoolPartition>> partitions_;
+    std::vector<Member> members_;
+    // Members currently failing health checks; PickPartition skips the
+    // eligibility filter entirely while this is 0. Shared with the
+    // checkers' transition callbacks.
+    std::shared_ptr<std::atomic<int64_t>> unhealthy_count_ =
+        std::make_shared<std::atomic<int64_t>>(0);
+    // Declared after members_ so checkers are destroyed before the
+    // partitions they check through.
+    std::vector<std::shared_ptr<HealthChecker>> health_checkers_;
+    std::shared_ptr<CIRCUIT_BREAKER_NAMESPACE::OutlierDetector> outlier_detector_;
+    std::unique_ptr<LoadBalancer> balancer_;
+    // Indexed by dispatcher; each entry only touched on its dispatcher.
+    std::vector<LoadBalancer::State> lb_states_;
     // Keep dispatcher references for shutdown enqueue
     std::vector<std::shared_ptr<Dispatcher>> dispatchers_;
 };
@@ -53,12 +53,46 @@ public:
     // pool drops the queued waiter on pop and proactively sweeps it out
     // if the wait queue is full. See PoolPartition::CheckoutAsync for
     // the full semantics.
+    //
+    // Multi-endpoint upstreams pick the endpoint through the upstream's
+    // load balancer with no request key (hash policies fall back to
+    // round-robin). Callers that need the pick (ProxyTransaction reuses
+    // it for the H2 paths) use SelectPartition + the overload below.
     void CheckoutAsync(const std::string& service_name,
                        size_t dispatcher_index,
                        PoolPartition::ReadyCallback ready_cb,
                        PoolPartition::ErrorCallback error_cb,
                        std::shared_ptr<std::atomic<bool>> cancel_token = nullptr);
 
+    // Checkout on a partition returned by SelectPartition. Same shutdown
+    // gate as above; a null partition fails with CHECKOUT_CONNECT_FAILED.
+    void CheckoutAsync(PoolPartition* partition,
+                       PoolPartition::ReadyCallback ready_cb,
+                       PoolPartition::ErrorCallback error_cb,
+                       std::shared_ptr<std::atomic<bool>> cancel_token = nullptr);
+
+    // Load-balanced endpoint partition for one attempt. `lb_hash` comes
+    // from LoadBalancerHash (0 = no request key). Must be called on the
+    // dispatcher thread identified by dispatcher_index. Returns nullptr
+    // for an unknown service or an out-of-range dispatcher index.
+    PoolPartition* SelectPartition(const std::string& service_name,
+                                   size_t dispatcher_index,
+                                   uint64_t lb_hash);
+
+    // Request key for the upstream's ring_hash / maglev balancer (see
+    // UpstreamHostPool::RequestHash); 0 for other policies or unknown
+    // services. Safe from any thread.
+    uint64_t LoadBalancerHash(const std::string& service_name,
+                              const std::string& client_ip,
+                              const std::string& path,
+                              const std::map<std::string, std::string>& headers) const;
+
+    // ResolvedMap key for endpoint `endpoint_index` of an upstream:
+    // the bare name for the first endpoint (so single-endpoint maps are
+    // unchanged), "<name>#<index>" for the rest.
+    static std::string EndpointResolveKey(const std::string& upstream_name,
+                                          size_t endpoint_index);
+
     // Evict expired connections across all pools (called by timer handler)
     void EvictExpired(size_t dispatcher_index);
 
@@ -128,6 +162,10 @@ public:
     }
     int64_t h2_preconnect_fired_count() const noexcept;
     int64_t h2_preconnect_skipped_cap_count() const noexcept;
+    // Upstream TLS handshakes across every pool, split by whether the
+    // session was resumed from the per-partition session cache.
+    int64_t tls_handshakes_full() const noexcept;
+    int64_t tls_handshakes_resumed() const noexcept;
 
 #ifdef REACTOR_BUILDING_TESTS
     // Test-only: adjust the lease counters by signed deltas. Tests that
@@ -175,7 +213,26 @@ public:
     // Check if an upstream service is configured
     bool HasUpstream(const std::string& service_name) const;
 
-    // Look up the PoolPartition for (service_name, dispatcher_index).
+    // False only when the upstream runs active health checks and every
+    // endpoint is currently failing them. Unknown names report true.
+    // Any thread.
+    bool HasHealthyEndpoint(const std::string& service_name) const;
+
+    // The pool behind `service_name`, or nullptr. Read-only view for
+    // stats and tests; pools_ is fixed after construction.
+    const UpstreamHostPool* GetHostPool(const std::string& service_name) const;
+
+    // Feed one attempt outcome on `partition` (from SelectPartition) to
+    // the upstream's outlier detector. `latency_ms` < 0 when no response
+    // arrived. Dispatcher thread of `dispatcher_index` only; no-op for
+    // single-endpoint upstreams.
+    void RecordEndpointOutcome(const std::string& service_name,
+                               size_t dispatcher_index,
+                               const PoolPartition* partition,
+                               bool failure, int64_t latency_ms);
+
+    // Look up the PoolPartition for (service_name, dispatcher_index) —
+    // the first endpoint's, for multi-endpoint upstreams.
     // Returns nullptr if service is unknown or dispatcher_index is out
     // of range. Used by the circuit-breaker transition callback (wired
     // in HttpServer::MarkServerReady) to drain the wait queue on a
@@ -185,6 +242,12 @@ public:
     PoolPartition* GetPoolPartition(const std::string& service_name,
                                     size_t dispatcher_index);
 
+    // Every endpoint's partition for (service_name, dispatcher_index):
+    // one per member of a multi-endpoint upstream. Empty if unknown.
+    // Same threading rule as GetPoolPartition.
+    std::vector<PoolPartition*> GetPoolPartitions(const std::string& service_name,
+                                                  size_t dispatcher_index);
+
     // Reload-time endpoint refresh. Synchronous on the caller's thread.
     // Iterates every entry in `merged` and, for the matching pool's
     // partitions, performs a release-store on resolved_endpoint_. Returns
@@ -225,6 +288,12 @@ public:
     void CommitHttp2Snapshots(
         const std::vector<UpstreamConfig>& upstreams);
 
+    // Live-apply circuit_breaker.outlier_detection (and the breaker
+    // fields it depends on) to every multi-endpoint pool. Upstreams
+    // missing from `upstreams` keep their current settings. Any thread;
+    // called from HttpServer::Reload next to CircuitBreakerManager::Reload.
+    void ReloadOutlierDetection(const std::vector<UpstreamConfig>& upstreams);
+
     // Read access to the per-upstream TLS client context. Returns null
     // when the upstream is plaintext (no TLS) or when the name is
     // unknown. Exposed for tests / diagnostics — production code uses
@@ -11,6 +11,15 @@ class UpstreamResponseSink {
 public:
     virtual ~UpstreamResponseSink() = default;
 
+    // Informational 1xx response (e.g. 103 Early Hints) received before
+    // the final HEADERS. Fired once per interim block; the codec keeps
+    // waiting for the final response afterwards. `headers` carries the
+    // interim's fields as received. Default no-op — most sinks discard
+    // interims. 100 Continue is not reported.
+    virtual void OnInterimHeaders(
+        int /*status_code*/,
+        const std::vector<std::pair<std::string, std::string>>& /*headers*/) {}
+
     virtual bool OnHeaders(const UpstreamResponseHead& head) = 0;
     virtual bool OnBodyChunk(const char* data, size_t len) = 0;
     // Trailing HEADERS block. Codecs MAY elide an empty trailers block
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "common.h"
+#include "upstream/upstream_lease.h"
+#include "http/http_callbacks.h"
+// <string>, <memory>, <atomic>, <chrono> provided by common.h
+
+// Forward declarations
+class UpstreamManager;
+class ConnectionHandler;
+class HttpConnectionHandler;
+class HttpResponse;
+namespace OBSERVABILITY_NAMESPACE { class ObservabilityManager; }
+
+// Server-wide state shared by every WebSocket proxy tunnel: the /stats
+// counters and the observability manager used for the tunnel metrics
+// (empty when observability is off). Owned by HttpServer; `obs_manager`
+// is written once in MarkServerReady before any tunnel can start.
+struct WsTunnelContext {
+    std::atomic<int64_t> active{0};
+    std::atomic<int64_t> total{0};
+    std::atomic<int64_t> bytes_to_upstream{0};
+    std::atomic<int64_t> bytes_to_client{0};
+    std::weak_ptr<OBSERVABILITY_NAMESPACE::ObservabilityManager> obs_manager;
+};
+
+// One proxied WebSocket. Checks an HTTP/1.1 connection out of the
+// upstream pool, forwards the client's upgrade request, relays the
+// upstream's answer and — on 101 — splices the two sockets byte-for-byte
+// until either side closes.
+//
+// Dispatcher-thread only. The upstream is checked out on the client's
+// dispatcher, so both transports' callbacks run on the same thread and
+// the relay needs no locking.
+//
+// Relay: bytes read from one side are handed to the other side's
+// SendRaw straight out of the read buffer; only what the socket does
+// not accept immediately is copied into its output buffer. When that
+// backlog passes `relay_buffer_limit_bytes` the source's read pump is
+// paused, and resumed once the backlog drains below half of it.
+//
+// The upstream connection is never returned to the pool: after a 101 it
+// speaks a different protocol, and after a relayed rejection its framing
+// state is unknown. It is marked closing and released.
+class WsTunnel : public std::enable_shared_from_this<WsTunnel> {
+public:
+    struct Params {
+        std::string service_name;
+        std::string upstream_host;
+        int upstream_port = 0;
+        UpstreamManager* upstream_manager = nullptr;
+        int dispatcher_index = -1;
+        // Serialized upgrade request (request line + rewritten headers).
+        std::string request_head;
+        size_t relay_buffer_limit_bytes = 0;
+        // Budget for the upstream's handshake answer. 0 = unbounded.
+        int response_timeout_ms = 0;
+        std::shared_ptr<WsTunnelContext> context;
+    };
+
+    WsTunnel(std::weak_ptr<HttpConnectionHandler> client, Params params);
+    ~WsTunnel();
+
+    WsTunnel(const WsTunnel&) = delete;
+    WsTunnel& operator=(const WsTunnel&) = delete;
+
+    // Begin the upstream checkout. The client must already be in the
+    // deferred window (HttpConnectionHandler::BeginWsTunnel).
+    void Start();
+
+    // Client dropped before the upstream answered: abandon the checkout
+    // or handshake and release the upstream.
+    void Cancel();
+
+    // Largest upstream response head accepted before the 101, and the
+    // largest rejection body relayed to the client.
+    static constexpr size_t MAX_RESPONSE_HEAD_BYTES = 65536;
+    static constexpr size_t MAX_REJECTION_BODY_BYTES = 65536;
+
+private:
+    enum class State { IDLE, CHECKOUT, HANDSHAKE, REJECTION_BODY, OPEN, CLOSED };
+
+    void OnCheckoutReady(UpstreamLease lease);
+    void OnCheckoutError(int error_code);
+    void SendHandshake();
+    void OnUpstreamData(std::string& data);
+    // Parses the buffered response head. Returns false when more bytes
+    // are needed.
+    bool ProcessResponseHead();
+    void RelayRejection();
+    void Open(int status_code, const std::string& reason,
+              std::vector<std::pair<std::string, std::string>> headers,
+              std::string leftover);
+
+    void OnClientData(std::string& data);
+    void OnClientDrain(size_t remaining);
+    void OnUpstreamDrain(size_t remaining);
+    void OnClientClose();
+
+    // Answer the client with `response` (pre-101 only) and tear down.
+    void Fail(HttpResponse response, const std::string& error_type,
+              const std::string& reason);
+    void Close(const char* reason);
+    void ReleaseUpstream();
+    void EmitBytes(size_t bytes, const char* direction);
+    void EmitActiveDelta(double delta);
+
+    std::shared_ptr<ConnectionHandler> UpstreamTransport() const;
+
+    std::weak_ptr<HttpConnectionHandler> client_;
+    std::weak_ptr<ConnectionHandler> client_conn_;
+    Params params_;
+    int client_fd_ = -1;
+    State state_ = State::IDLE;
+    std::shared_ptr<std::atomic<bool>> cancel_token_;
+    UpstreamLease lease_;
+    int upstream_fd_ = -1;
+
+    // Handshake-phase parse state.
+    std::string head_buf_;
+    int response_status_ = 0;
+    std::string response_reason_;
+    std::vector<std::pair<std::string, std::string>> response_headers_;
+    size_t rejection_body_len_ = 0;
+
+    // Backpressure: each flag pairs one IncReadDisable on the source.
+    bool client_paused_ = false;
+    bool upstream_paused_ = false;
+
+    uint64_t bytes_to_upstream_ = 0;
+    uint64_t bytes_to_client_ = 0;
+    std::chrono::steady_clock::time_point opened_at_{};
+};
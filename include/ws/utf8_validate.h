@@ -1,52 +1,163 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 // RFC 3629 UTF-8 validation with full codepoint range checks:
 // - Rejects overlong encodings (e.g., 0xC0 0x80 for U+0000)
 // - Rejects surrogates U+D800-U+DFFF
 // - Rejects codepoints > U+10FFFF
+//
+// IsValidUtf8() dispatches at runtime: AVX2 runs the Keiser-Lemire
+// lookup validator 32 bytes at a time; SSE2 and the portable path skip
+// ASCII runs 16 / 8 bytes at a time and decode the rest with the scalar
+// loop below. All paths accept exactly the same inputs.
+bool IsValidUtf8(const char* data, size_t len);
+
 inline bool IsValidUtf8(const std::string& data) {
-    size_t i = 0;
-    while (i < data.size()) {
-        uint8_t c = static_cast<uint8_t>(data[i]);
-        uint32_t codepoint;
-        size_t len;
-
-        if (c <= 0x7F) {
-            i++; continue;
-        } else if ((c & 0xE0) == 0xC0) {
-            len = 2;
-            if (c < 0xC2) return false;  // overlong
-            codepoint = c & 0x1F;
-        } else if ((c & 0xF0) == 0xE0) {
-            len = 3;
-            codepoint = c & 0x0F;
-        } else if ((c & 0xF8) == 0xF0) {
-            len = 4;
-            codepoint = c & 0x07;
-        } else {
-            return false;  // invalid lead byte
-        }
+    return IsValidUtf8(data.data(), data.size());
+}
 
-        if (i + len > data.size()) return false;
+namespace utf8_detail {
 
-        for (size_t j = 1; j < len; j++) {
-            uint8_t cb = static_cast<uint8_t>(data[i + j]);
-            if ((cb & 0xC0) != 0x80) return false;
-            codepoint = (codepoint << 6) | (cb & 0x3F);
-        }
+// Validate the codepoint starting at s[i] and advance i past it.
+inline bool DecodeOne(const uint8_t* s, size_t n, size_t& i) {
+    uint8_t c = s[i];
+    uint32_t codepoint;
+    size_t len;
+
+    if (c <= 0x7F) {
+        i++; return true;
+    } else if ((c & 0xE0) == 0xC0) {
+        len = 2;
+        if (c < 0xC2) return false;  // overlong
+        codepoint = c & 0x1F;
+    } else if ((c & 0xF0) == 0xE0) {
+        len = 3;
+        codepoint = c & 0x0F;
+    } else if ((c & 0xF8) == 0xF0) {
+        len = 4;
+        codepoint = c & 0x07;
+    } else {
+        return false;  // invalid lead byte
+    }
+
+    if (i + len > n) return false;
+
+    for (size_t j = 1; j < len; j++) {
+        uint8_t cb = s[i + j];
+        if ((cb & 0xC0) != 0x80) return false;
+        codepoint = (codepoint << 6) | (cb & 0x3F);
+    }
+
+    // Reject surrogates (U+D800-U+DFFF) and codepoints > U+10FFFF
+    if (codepoint >= 0xD800 && codepoint <= 0xDFFF) return false;
+    if (codepoint > 0x10FFFF) return false;
+
+    // Reject overlong encodings
+    if (len == 3 && codepoint < 0x0800) return false;
+    if (len == 4 && codepoint < 0x10000) return false;
+
+    i += len;
+    return true;
+}
+
+// Declared sequence length for a lead byte; 0 for a continuation byte
+// or a byte that can never start a sequence.
+inline size_t SequenceLength(uint8_t c) {
+    if (c <= 0x7F) return 1;
+    if (c >= 0xC2 && c <= 0xDF) return 2;
+    if (c >= 0xE0 && c <= 0xEF) return 3;
+    if (c >= 0xF0 && c <= 0xF4) return 4;
+    return 0;
+}
 
-        // Reject surrogates (U+D800-U+DFFF) and codepoints > U+10FFFF
-        if (codepoint >= 0xD800 && codepoint <= 0xDFFF) return false;
-        if (codepoint > 0x10FFFF) return false;
+// True when s[0..n) is a strict prefix of some valid sequence, i.e. more
+// bytes could still complete it. Applies the same overlong / surrogate /
+// range limits as DecodeOne to the second byte so truncated input fails
+// as early as complete input would.
+inline bool IsValidPrefix(const uint8_t* s, size_t n) {
+    size_t len = SequenceLength(s[0]);
+    if (len < 2 || n >= len) return false;
+    if (n >= 2) {
+        uint8_t lo = 0x80, hi = 0xBF;
+        switch (s[0]) {
+            case 0xE0: lo = 0xA0; break;  // overlong
+            case 0xED: hi = 0x9F; break;  // surrogates
+            case 0xF0: lo = 0x90; break;  // overlong
+            case 0xF4: hi = 0x8F; break;  // > U+10FFFF
+            default: break;
+        }
+        if (s[1] < lo || s[1] > hi) return false;
+    }
+    if (n >= 3 && (s[2] & 0xC0) != 0x80) return false;
+    return true;
+}
 
-        // Reject overlong encodings
-        if (len == 3 && codepoint < 0x0800) return false;
-        if (len == 4 && codepoint < 0x10000) return false;
+}  // namespace utf8_detail
 
-        i += len;
+// One codepoint at a time. Reference implementation for tests and the
+// benchmark, and the tail loop of the vector paths.
+inline bool IsValidUtf8Scalar(const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    size_t i = 0;
+    while (i < len) {
+        if (!utf8_detail::DecodeOne(s, len, i)) return false;
     }
     return true;
 }
+
+inline bool IsValidUtf8Scalar(const std::string& data) {
+    return IsValidUtf8Scalar(data.data(), data.size());
+}
+
+// Incremental validation for a message that arrives in pieces (streamed
+// WebSocket text). A codepoint may be split across Feed() calls; the
+// incomplete tail (at most 3 bytes) is held until the next piece. Feed()
+// fails as soon as the input can no longer be valid, so a bad byte is
+// reported in the piece that contains it, not at end of message.
+class Utf8StreamValidator {
+public:
+    bool Feed(const char* data, size_t len) {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+        size_t i = 0;
+        // Finish the codepoint left over from the previous piece.
+        if (pending_len_ > 0) {
+            size_t need = utf8_detail::SequenceLength(pending_[0]);
+            while (pending_len_ < need && i < len) pending_[pending_len_++] = s[i++];
+            if (pending_len_ < need) {
+                return utf8_detail::IsValidPrefix(pending_, pending_len_);
+            }
+            size_t pos = 0;
+            if (!utf8_detail::DecodeOne(pending_, pending_len_, pos)) return false;
+            pending_len_ = 0;
+        }
+        // Hold back an incomplete sequence at the end of this piece.
+        size_t tail = 0;
+        for (size_t j = 1; j <= 3 && j <= len - i; ++j) {
+            uint8_t c = s[len - j];
+            if ((c & 0xC0) == 0x80) continue;
+            if (utf8_detail::SequenceLength(c) > j) tail = j;
+            break;
+        }
+        if (!IsValidUtf8(data + i, len - i - tail)) return false;
+        if (tail > 0) {
+            if (!utf8_detail::IsValidPrefix(s + len - tail, tail)) return false;
+            std::memcpy(pending_, s + len - tail, tail);
+            pending_len_ = tail;
+        }
+        return true;
+    }
+
+    // Bytes of an incomplete trailing codepoint. Zero at a codepoint
+    // boundary — required at end of message.
+    size_t pending() const { return pending_len_; }
+
+    void Reset() { pending_len_ = 0; }
+
+private:
+    uint8_t pending_[4] = {0};
+    size_t pending_len_ = 0;
+};
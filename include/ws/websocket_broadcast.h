@@ -0,0 +1,74 @@
+#pragma once
+
+#include "common.h"
+// <string>, <memory>, <atomic>, <cstdint> provided by common.h
+
+class WebSocketConnection;
+
+// What a broadcast does with a subscriber whose transport already has
+// more than `max_pending_bytes` queued (peer not reading fast enough).
+enum class SlowConsumerPolicy {
+    DROP,        // skip this message for that subscriber; stay subscribed
+    DISCONNECT   // send Close 1008 "slow consumer" and unsubscribe
+};
+
+struct WebSocketTopicOptions {
+    // Bytes already waiting in the subscriber's output buffer before it
+    // counts as slow. 0 = never slow (queue without bound).
+    size_t max_pending_bytes = 1024 * 1024;
+    SlowConsumerPolicy slow_consumer_policy = SlowConsumerPolicy::DROP;
+};
+
+// Topic / room fan-out for WebSocket connections.
+//
+// Broadcast() serializes the frame once into an immutable, refcounted
+// buffer shared by every recipient, then hands it to each dispatcher
+// that has subscribers with ONE queued task — not one per connection.
+// Broadcasts issued while a dispatcher's task is still pending join the
+// same batch, so a burst costs one cross-thread wakeup per dispatcher.
+// On the dispatcher the shared bytes go straight to each connection's
+// send path; only a socket that can't take them immediately copies the
+// remainder into its output buffer.
+//
+// Frames are sent uncompressed, including to connections that
+// negotiated permessage-deflate (RSV1 is per-message and optional).
+//
+// Subscriptions hold weak references: a closed connection is dropped
+// from its topics on the next delivery to its dispatcher or the next
+// Subscribe() there. All methods are thread-safe.
+class WebSocketBroadcaster {
+public:
+    struct Stats {
+        uint64_t broadcasts = 0;    // Broadcast*() calls with >= 1 recipient
+        uint64_t delivered = 0;     // frames handed to a connection
+        uint64_t dropped = 0;       // skipped under SlowConsumerPolicy::DROP
+        uint64_t disconnected = 0;  // closed under SlowConsumerPolicy::DISCONNECT
+    };
+
+    explicit WebSocketBroadcaster(WebSocketTopicOptions defaults = {});
+    ~WebSocketBroadcaster();
+    WebSocketBroadcaster(const WebSocketBroadcaster&) = delete;
+    WebSocketBroadcaster& operator=(const WebSocketBroadcaster&) = delete;
+
+    // Options for one topic. Applies to broadcasts issued after the call;
+    // topics without an override use the constructor defaults.
+    void SetTopicOptions(const std::string& topic, const WebSocketTopicOptions& options);
+
+    // False when already subscribed or the connection is not a live
+    // upgraded connection (not owned by a server, or already closing).
+    bool Subscribe(const std::string& topic, WebSocketConnection& ws);
+    bool Unsubscribe(const std::string& topic, WebSocketConnection& ws);
+
+    // Returns the number of subscribers the message was queued for.
+    size_t BroadcastText(const std::string& topic, const std::string& message);
+    size_t BroadcastBinary(const std::string& topic, const std::string& data);
+
+    // Includes closed connections not yet pruned.
+    size_t SubscriberCount(const std::string& topic) const;
+    Stats GetStats() const;
+
+    struct State;
+
+private:
+    std::shared_ptr<State> state_;
+};
@@ -3,10 +3,14 @@
 #include "http/http_callbacks.h"
 #include "ws/websocket_parser.h"
 #include "ws/websocket_frame.h"
+#include "ws/websocket_broadcast.h"
+#include "ws/utf8_validate.h"
 #include "connection_handler.h"
 
 // <memory>, <functional>, <string>, <unordered_map> provided by common.h (via connection_handler.h)
 
+class WebSocketDeflate;
+
 namespace OBSERVABILITY_NAMESPACE {
 struct ObservabilitySnapshot;
 class ObservabilityManager;
@@ -14,13 +18,16 @@ class Counter;
 class UpDownCounter;
 }
 
-class WebSocketConnection {
+// Owned through shared_ptr by HttpConnectionHandler so
+// WebSocketBroadcaster subscriptions can hold weak references.
+class WebSocketConnection : public std::enable_shared_from_this<WebSocketConnection> {
 public:
     explicit WebSocketConnection(std::shared_ptr<ConnectionHandler> conn);
     ~WebSocketConnection();
 
     // Public type aliases for backward compatibility
     using MessageCallback = HTTP_CALLBACKS_NAMESPACE::WsMessageCallback;
+    using MessageChunkCallback = HTTP_CALLBACKS_NAMESPACE::WsMessageChunkCallback;
     using CloseCallback   = HTTP_CALLBACKS_NAMESPACE::WsCloseCallback;
     using PingCallback    = HTTP_CALLBACKS_NAMESPACE::WsPingCallback;
     using ErrorCallback   = HTTP_CALLBACKS_NAMESPACE::WsErrorCallback;
@@ -30,6 +37,31 @@ public:
     void OnPing(PingCallback callback);
     void OnError(ErrorCallback callback);
 
+    // Opt-in streaming delivery. When set, Text/Binary messages are not
+    // reassembled: each piece is handed to `callback` as it is read off
+    // the socket, and OnMessage is not called. Text pieces are validated
+    // incrementally and always end on a codepoint boundary (an invalid
+    // byte closes with 1007 before the piece holding it is delivered).
+    // max_ws_message_size still caps the total message. Compressed
+    // (permessage-deflate) messages are inflated whole and delivered as a
+    // single final piece. Install from the upgrade handler.
+    //
+    // While streaming, each transport read cycle is capped at
+    // kStreamingReadCap instead of max_ws_message_size, which bounds
+    // both the per-read allocation and the size of a piece.
+    void OnMessageChunk(MessageChunkCallback callback);
+    bool IsStreaming() const { return callbacks_.chunk_callback != nullptr; }
+    static constexpr size_t kStreamingReadCap = 256 * 1024;
+
+    // Flow control for streaming consumers. PauseReading() stops reading
+    // the socket (ConnectionHandler::IncReadDisable) and holds frames
+    // already parsed; ResumeReading() delivers them and re-enables reads.
+    // Called from the dispatcher (e.g. inside the chunk callback) they
+    // take effect immediately; from other threads they are queued to it.
+    void PauseReading();
+    void ResumeReading();
+    bool IsReadingPaused() const { return read_paused_.load(std::memory_order_acquire); }
+
     // Send operations
     void SendText(const std::string& message);
     void SendBinary(const std::string& data);
@@ -37,8 +69,21 @@ public:
     void SendPing(const std::string& payload = "");
     void SendPong(const std::string& payload = "");
 
+    // Broadcast delivery (WebSocketBroadcaster). Writes a frame that was
+    // serialized once for all recipients, applying the topic's
+    // slow-consumer policy against this connection's queued output.
+    // `coalesce` corks the transport until loop end when the caller has
+    // more frames for the same sockets. Dispatcher-thread-only.
+    enum class SerializedSendResult { SENT, DROPPED, DISCONNECTED, CLOSED };
+    SerializedSendResult SendSerialized(const std::string& wire,
+                                        WebSocketOpcode opcode,
+                                        size_t payload_size,
+                                        const WebSocketTopicOptions& options,
+                                        bool coalesce);
+
     // Connection info
     int fd() const;
+    std::shared_ptr<Dispatcher> dispatcher_ptr() const;
     bool IsOpen() const { return is_open_ && !close_sent_; }
     // True if we sent a close frame and are waiting for the peer's reply.
     bool IsClosing() const { return is_open_ && close_sent_; }
@@ -49,6 +94,11 @@ public:
     // Set maximum reassembled message size (0 = unlimited)
     void SetMaxMessageSize(size_t max) { max_message_size_ = max; }
 
+    // Turn on permessage-deflate with the codec negotiated in the 101.
+    // Called once at upgrade, before any frame is read or sent.
+    void EnablePerMessageDeflate(std::unique_ptr<WebSocketDeflate> deflate);
+    bool IsDeflateEnabled() const { return deflate_ != nullptr; }
+
     // Route parameters (populated during upgrade from pattern routes)
     const std::unordered_map<std::string, std::string>& GetParams() const { return params_; }
     void SetParams(std::unordered_map<std::string, std::string> params) { params_ = std::move(params); }
@@ -96,6 +146,24 @@ private:
     bool in_fragment_ = false;
     size_t max_message_size_ = 0;  // 0 = unlimited
 
+    // Streaming delivery state (chunk_callback set). in_fragment_ /
+    // fragment_opcode_ / fragment_compressed_ track the current message.
+    size_t stream_message_bytes_ = 0;
+    Utf8StreamValidator stream_utf8_;
+    std::string stream_utf8_carry_;  // incomplete codepoint held back
+
+    // PauseReading / ResumeReading. `read_disable_held_` pairs our single
+    // IncReadDisable with its DecReadDisable. Dispatcher-thread-only
+    // apart from the atomic load in IsReadingPaused.
+    std::atomic<bool> read_paused_{false};
+    bool read_disable_held_ = false;
+    bool draining_ = false;  // inside DrainParsedFrames
+
+    // permessage-deflate (null when not negotiated). Compress runs under
+    // send_mtx_; Decompress on the dispatcher in ProcessFrame.
+    std::unique_ptr<WebSocketDeflate> deflate_;
+    bool fragment_compressed_ = false;  // RSV1 was set on the first fragment
+
     // Route parameters extracted during WebSocket upgrade
     std::unordered_map<std::string, std::string> params_;
 
@@ -152,7 +220,19 @@ private:
     bool bound_once_ = false;
 
     void ProcessFrame(const WebSocketFrame& frame);
+    // Deliver parsed frames until the parser is empty or reading is
+    // paused, then act on a pending parser error.
+    void DrainParsedFrames();
+    // Text/Binary/Continuation piece when chunk_callback is installed.
+    void ProcessStreamedPiece(const WebSocketFrame& piece);
+    void ReleaseReadDisable();
     void SendFrame(const WebSocketFrame& frame);
+    // Compress a Text/Binary frame's payload in place when the extension
+    // is negotiated and the payload reaches min_message_size.
+    void MaybeCompress(WebSocketFrame& frame);
+    // Decompress a complete message. On failure sends the Close (1009
+    // for oversize, 1007 otherwise) and returns false.
+    bool InflateMessage(const std::string& in, std::string& out);
     // Emit a ws.recv / ws.send INTERNAL span. No-op when obs unbound.
     // Called from dispatcher (ProcessFrame) and off-dispatcher under
     // send_mtx_ (SendFrame); Tracer / Span / BSP own internal mutexes.
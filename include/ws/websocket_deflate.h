@@ -0,0 +1,112 @@
+#pragma once
+
+#include "common.h"
+#include "config/server_config.h"
+// <string>, <memory>, <atomic>, <cstdint> provided by common.h
+
+// permessage-deflate (RFC 7692) for WebSocketConnection.
+//
+// Negotiation lives in WebSocketHandshake::NegotiateDeflate; this header
+// holds the agreed parameters, the server-wide memory budget, and the
+// per-connection codec. zlib types stay in the .cc so the WS headers
+// don't drag <zlib.h> into every includer.
+struct z_stream_s;
+
+// Parameters agreed for one connection. "server" is our compressor,
+// "client" is the peer's compressor (our decompressor).
+struct WebSocketDeflateParams {
+    bool server_no_context_takeover = false;
+    bool client_no_context_takeover = false;
+    int server_max_window_bits = 15;
+    int client_max_window_bits = 15;
+
+    // Value for the 101's Sec-WebSocket-Extensions header. Window bits
+    // are only emitted below the RFC default of 15.
+    std::string ToHeaderValue() const;
+};
+
+// Server-wide cap on zlib state held by WebSocket connections. A
+// connection reserves its estimate when the extension is negotiated and
+// releases it on destruction; when the cap would be exceeded the
+// extension is declined and the connection runs uncompressed.
+class WebSocketDeflateBudget {
+public:
+    // cap_bytes == 0 means unlimited (reservations are still counted).
+    explicit WebSocketDeflateBudget(size_t cap_bytes) : cap_bytes_(cap_bytes) {}
+
+    bool TryReserve(size_t bytes);
+    void Release(size_t bytes);
+
+    size_t used_bytes() const { return used_bytes_.load(std::memory_order_relaxed); }
+    size_t cap_bytes() const { return cap_bytes_; }
+
+private:
+    const size_t cap_bytes_;
+    std::atomic<size_t> used_bytes_{0};
+};
+
+// Per-connection compressor + decompressor.
+//
+// A direction that keeps its context (no *_no_context_takeover) owns a
+// private z_stream for the connection's lifetime and is charged to the
+// budget. A direction without context takeover starts every message
+// from an empty window, so it borrows a thread-local z_stream instead
+// and costs nothing per connection — one shared context per thread.
+//
+// Not thread-safe: compress calls are serialized by the connection's
+// send mutex, decompress calls run on the connection's dispatcher.
+class WebSocketDeflate {
+public:
+    enum class InflateResult {
+        OK,
+        TOO_LARGE,   // output would exceed max_size
+        CORRUPT      // not a valid DEFLATE stream
+    };
+
+    // nullptr when the budget has no room or zlib fails to initialize —
+    // the caller declines the extension.
+    static std::unique_ptr<WebSocketDeflate> Create(
+        const WebSocketDeflateParams& params,
+        const WebSocketDeflateConfig& config,
+        std::shared_ptr<WebSocketDeflateBudget> budget);
+
+    ~WebSocketDeflate();
+    WebSocketDeflate(const WebSocketDeflate&) = delete;
+    WebSocketDeflate& operator=(const WebSocketDeflate&) = delete;
+
+    // Compress one whole message into `out` with the trailing
+    // 0x00 0x00 0xff 0xff removed (RFC 7692 §7.2.1). Returns false on a
+    // zlib error; the compressor is reset either way.
+    bool Compress(const std::string& in, std::string& out);
+
+    // Decompress one whole message (all fragments concatenated).
+    // max_size == 0 means unlimited.
+    InflateResult Decompress(const std::string& in, std::string& out,
+                             size_t max_size);
+
+    const WebSocketDeflateParams& params() const { return params_; }
+    size_t min_message_size() const { return min_message_size_; }
+    // Bytes charged to the budget by this connection.
+    size_t reserved_bytes() const { return reserved_bytes_; }
+
+    // zlib's documented state sizes (zconf.h), plus a small allowance
+    // for the stream structs themselves.
+    static size_t EstimateDeflateBytes(int window_bits, int mem_level);
+    static size_t EstimateInflateBytes(int window_bits);
+
+private:
+    WebSocketDeflate() = default;
+
+    WebSocketDeflateParams params_;
+    int compression_level_ = 6;
+    int mem_level_ = 8;
+    size_t min_message_size_ = 0;
+
+    // Owned streams; null for a direction that uses the shared
+    // thread-local context.
+    z_stream_s* deflate_stream_ = nullptr;
+    z_stream_s* inflate_stream_ = nullptr;
+
+    std::shared_ptr<WebSocketDeflateBudget> budget_;
+    size_t reserved_bytes_ = 0;
+};
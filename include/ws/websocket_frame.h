@@ -13,12 +13,20 @@ enum class WebSocketOpcode : uint8_t {
 
 struct WebSocketFrame {
     bool fin = true;
+    bool rsv1 = false;   // permessage-deflate: payload is compressed (first frame only)
     WebSocketOpcode opcode = WebSocketOpcode::Text;
     bool masked = false;
     uint64_t payload_length = 0;
     uint8_t masking_key[4] = {0};
     std::string payload;
 
+    // Streamed data frames (WebSocketParser::SetStreamData) arrive in
+    // pieces: `payload` then holds this frame's bytes starting at
+    // `payload_offset`, and `frame_end` marks the last piece. Whole
+    // frames have offset 0 and frame_end set.
+    uint64_t payload_offset = 0;
+    bool frame_end = true;
+
     // Serialize frame for sending (server->client: NOT masked per RFC 6455)
     std::string Serialize() const;
 
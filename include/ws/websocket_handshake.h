@@ -2,6 +2,7 @@
 
 #include "http/http_request.h"
 #include "http/http_response.h"
+#include "ws/websocket_deflate.h"
 #include <string>
 
 class WebSocketHandshake {
@@ -13,6 +14,14 @@ public:
     // Generate 101 Switching Protocols response for a valid upgrade.
     static HttpResponse Accept(const HttpRequest& request);
 
+    // permessage-deflate negotiation (RFC 7692 §7.1). Picks the first
+    // acceptable offer in the request's Sec-WebSocket-Extensions and
+    // fills `out`. Returns false when the client made no acceptable
+    // offer; the connection then runs without the extension.
+    static bool NegotiateDeflate(const HttpRequest& request,
+                                 const WebSocketDeflateConfig& config,
+                                 WebSocketDeflateParams& out);
+
     // Generate error response rejecting the upgrade.
     static HttpResponse Reject(int status_code, const std::string& reason);
 
@@ -12,6 +12,16 @@ public:
     // Set maximum allowed payload size (0 = unlimited)
     void SetMaxPayloadSize(size_t max_size) { max_payload_size_ = max_size; }
 
+    // Accept RSV1 on the first frame of a data message. Set once
+    // permessage-deflate has been negotiated.
+    void SetRsv1Allowed(bool allowed) { rsv1_allowed_ = allowed; }
+
+    // Emit Text/Binary/Continuation frames in pieces as their payload
+    // arrives instead of buffering each frame whole. Pieces are already
+    // unmasked; see WebSocketFrame::payload_offset / frame_end. Control
+    // frames are always delivered whole.
+    void SetStreamData(bool stream) { stream_data_ = stream; }
+
     // Feed raw bytes. Returns number of bytes consumed.
     size_t Parse(const char* data, size_t len);
 
@@ -47,9 +57,13 @@ private:
     std::string buffer_;
     size_t payload_read_ = 0;
     size_t max_payload_size_ = 0;  // 0 = unlimited
+    bool rsv1_allowed_ = false;
+    bool stream_data_ = false;
     bool has_error_ = false;
     std::string error_message_;
 
-    // Unmask payload in-place
+    // Unmask payload in-place (vectorized; see ws/websocket_simd.h)
     static void Unmask(std::string& data, const uint8_t key[4], size_t offset = 0);
+    // Queue the next `available` payload bytes of current_ as one piece.
+    void EmitPiece(const char* data, size_t available);
 };
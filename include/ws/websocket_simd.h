@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Instruction-set paths behind WebSocketParser::Unmask and IsValidUtf8.
+//
+// The public entry points pick DetectedLevel() once per process; the
+// explicit-level functions exist so tests and the benchmark can run
+// every path on the same input. A level above what the CPU supports is
+// clamped to DetectedLevel().
+namespace websocket_simd {
+
+enum class Level {
+    PORTABLE,  // 64-bit words, no intrinsics
+    SSE2,      // x86-64 baseline
+    AVX2       // runtime-detected
+};
+
+Level DetectedLevel();
+const char* LevelName(Level level);
+
+// XOR `len` bytes at `data` with `key`, key[0] applying to data[0].
+void Unmask(Level level, uint8_t* data, size_t len, const uint8_t key[4]);
+
+bool ValidateUtf8(Level level, const char* data, size_t len);
+
+}  // namespace websocket_simd
@@ -3,6 +3,8 @@
 #include "auth/auth_url_util.h"        // AUTH_NAMESPACE::HasHttpsScheme
 #include "auth/jws_algorithms.h"
 #include "http2/http2_constants.h"
+#include "http/early_hints.h"      // IsValidLinkValue for proxy.early_hints
+#include "upstream/grpc.h"         // ParseStatusName for proxy.grpc
 #include "http/route_trie.h"         // ParsePattern, ValidatePattern for proxy route_prefix
 #include "log/logger.h"
 #include "net/dns_resolver.h"        // IsValidHostOrIpLiteral grammar
@@ -663,6 +665,41 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                 throw std::runtime_error("tls.min_version must be a string");
             config.tls.min_version = tls["min_version"].get<std::string>();
         }
+        if (tls.contains("session_tickets")) {
+            if (!tls["session_tickets"].is_boolean())
+                throw std::runtime_error("tls.session_tickets must be a boolean");
+            config.tls.session_tickets = tls["session_tickets"].get<bool>();
+        }
+        if (tls.contains("ticket_key_file")) {
+            if (!tls["ticket_key_file"].is_string())
+                throw std::runtime_error("tls.ticket_key_file must be a string");
+            config.tls.ticket_key_file = tls["ticket_key_file"].get<std::string>();
+        }
+        config.tls.session_cache_size = ParseStrictInt(
+            tls, "session_cache_size", config.tls.session_cache_size, "tls");
+        config.tls.session_timeout_sec = ParseStrictInt(
+            tls, "session_timeout_sec", config.tls.session_timeout_sec, "tls");
+        if (tls.contains("ktls")) {
+            if (!tls["ktls"].is_boolean())
+                throw std::runtime_error("tls.ktls must be a boolean");
+            config.tls.ktls = tls["ktls"].get<bool>();
+        }
+        config.tls.handshake_offload_threads = ParseStrictInt(
+            tls, "handshake_offload_threads",
+            config.tls.handshake_offload_threads, "tls");
+        if (tls.contains("record_sizing")) {
+            if (!tls["record_sizing"].is_boolean())
+                throw std::runtime_error("tls.record_sizing must be a boolean");
+            config.tls.record_sizing = tls["record_sizing"].get<bool>();
+        }
+        config.tls.record_size_initial = ParseStrictInt(
+            tls, "record_size_initial", config.tls.record_size_initial, "tls");
+        config.tls.record_size_ramp_bytes = ParseStrictInt(
+            tls, "record_size_ramp_bytes",
+            config.tls.record_size_ramp_bytes, "tls");
+        config.tls.record_size_idle_reset_ms = ParseStrictInt(
+            tls, "record_size_idle_reset_ms",
+            config.tls.record_size_idle_reset_ms, "tls");
     }
 
     // HTTP/2 section
@@ -700,6 +737,11 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                 throw std::runtime_error("http2.enable_push must be a boolean");
             config.http2.enable_push = h2["enable_push"].get<bool>();
         }
+        if (h2.contains("write_batching")) {
+            if (!h2["write_batching"].is_boolean())
+                throw std::runtime_error("http2.write_batching must be a boolean");
+            config.http2.write_batching = h2["write_batching"].get<bool>();
+        }
         if (h2.contains("streaming")) {
             if (!h2["streaming"].is_object())
                 throw std::runtime_error("http2.streaming must be an object");
@@ -744,6 +786,69 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
         }
     }
 
+    // HTTP/3 section — experimental UDP listener.
+    if (j.contains("http3")) {
+        if (!j["http3"].is_object())
+            throw std::runtime_error("http3 must be an object");
+        auto& h3 = j["http3"];
+        if (h3.contains("enabled")) {
+            if (!h3["enabled"].is_boolean())
+                throw std::runtime_error("http3.enabled must be a boolean");
+            config.http3.enabled = h3["enabled"].get<bool>();
+        }
+        config.http3.port = ParseStrictInt(h3, "port", config.http3.port, "http3");
+        if (h3.contains("max_datagram_size")) {
+            if (!h3["max_datagram_size"].is_number_unsigned())
+                throw std::runtime_error("http3.max_datagram_size must be a non-negative integer");
+            config.http3.max_datagram_size = h3["max_datagram_size"].get<size_t>();
+        }
+        if (h3.contains("recv_batch_size")) {
+            if (!h3["recv_batch_size"].is_number_unsigned())
+                throw std::runtime_error("http3.recv_batch_size must be a non-negative integer");
+            config.http3.recv_batch_size = h3["recv_batch_size"].get<size_t>();
+        }
+    }
+
+    // WebSocket section — permessage-deflate (RFC 7692).
+    if (j.contains("websocket")) {
+        if (!j["websocket"].is_object())
+            throw std::runtime_error("websocket must be an object");
+        auto& ws = j["websocket"];
+        if (ws.contains("permessage_deflate")) {
+            if (!ws["permessage_deflate"].is_object())
+                throw std::runtime_error(
+                    "websocket.permessage_deflate must be an object");
+            auto& pd = ws["permessage_deflate"];
+            auto& dc = config.websocket.permessage_deflate;
+            const std::string ctx = "websocket.permessage_deflate";
+            auto pd_bool = [&](const char* key, bool& out) {
+                if (!pd.contains(key)) return;
+                if (!pd[key].is_boolean())
+                    throw std::runtime_error(ctx + "." + key + " must be a boolean");
+                out = pd[key].get<bool>();
+            };
+            auto pd_size = [&](const char* key, size_t& out) {
+                if (!pd.contains(key)) return;
+                if (!pd[key].is_number_unsigned())
+                    throw std::runtime_error(
+                        ctx + "." + key + " must be a non-negative integer");
+                out = pd[key].get<size_t>();
+            };
+            pd_bool("enabled", dc.enabled);
+            pd_bool("server_no_context_takeover", dc.server_no_context_takeover);
+            pd_bool("client_no_context_takeover", dc.client_no_context_takeover);
+            dc.server_max_window_bits = ParseStrictInt(
+                pd, "server_max_window_bits", dc.server_max_window_bits, ctx);
+            dc.client_max_window_bits = ParseStrictInt(
+                pd, "client_max_window_bits", dc.client_max_window_bits, ctx);
+            dc.compression_level = ParseStrictInt(
+                pd, "compression_level", dc.compression_level, ctx);
+            dc.mem_level = ParseStrictInt(pd, "mem_level", dc.mem_level, ctx);
+            pd_size("min_message_size", dc.min_message_size);
+            pd_size("max_memory_bytes", dc.max_memory_bytes);
+        }
+    }
+
     // Log section
     if (j.contains("log")) {
         if (!j["log"].is_object())
@@ -796,6 +901,64 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                 "']";
             upstream.port = ParseStrictInt(item, "port", 80, up_ctx);
 
+            if (item.contains("endpoints")) {
+                if (!item["endpoints"].is_array())
+                    throw std::runtime_error(up_ctx + ".endpoints must be an array");
+                for (const auto& e : item["endpoints"]) {
+                    if (!e.is_object())
+                        throw std::runtime_error(
+                            up_ctx + ".endpoints entry must be an object");
+                    const std::string ep_ctx = up_ctx + ".endpoints[" +
+                        std::to_string(upstream.endpoints.size()) + "]";
+                    UpstreamEndpointConfig ep;
+                    ep.host = e.value("host", "");
+                    ep.port = ParseStrictInt(e, "port", 80, ep_ctx);
+                    ep.weight = ParseStrictInt(e, "weight", 1, ep_ctx);
+                    upstream.endpoints.push_back(std::move(ep));
+                }
+                // The upstream's identity (Host header, SNI fallback)
+                // defaults to the first endpoint.
+                if (!upstream.endpoints.empty() && !item.contains("host")) {
+                    upstream.host = upstream.endpoints.front().host;
+                    if (!item.contains("port")) {
+                        upstream.port = upstream.endpoints.front().port;
+                    }
+                }
+            }
+
+            if (item.contains("load_balancer")) {
+                if (!item["load_balancer"].is_object())
+                    throw std::runtime_error(
+                        up_ctx + ".load_balancer must be an object");
+                auto& lb = item["load_balancer"];
+                upstream.load_balancer.policy = lb.value("policy", "round_robin");
+                upstream.load_balancer.hash_key = lb.value("hash_key", "client_ip");
+            }
+
+            if (item.contains("health_check")) {
+                if (!item["health_check"].is_object())
+                    throw std::runtime_error(
+                        up_ctx + ".health_check must be an object");
+                auto& hc = item["health_check"];
+                const std::string hc_ctx = up_ctx + ".health_check";
+                auto& out = upstream.health_check;
+                out.enabled = hc.value("enabled", false);
+                out.type = hc.value("type", "http");
+                out.path = hc.value("path", "/health");
+                out.host = hc.value("host", "");
+                out.interval_ms = ParseStrictInt(hc, "interval_ms", 5000, hc_ctx);
+                out.timeout_ms = ParseStrictInt(hc, "timeout_ms", 2000, hc_ctx);
+                out.jitter_percent = ParseStrictInt(hc, "jitter_percent", 10, hc_ctx);
+                out.healthy_threshold =
+                    ParseStrictInt(hc, "healthy_threshold", 2, hc_ctx);
+                out.unhealthy_threshold =
+                    ParseStrictInt(hc, "unhealthy_threshold", 3, hc_ctx);
+                out.expected_status_min =
+                    ParseStrictInt(hc, "expected_status_min", 200, hc_ctx);
+                out.expected_status_max =
+                    ParseStrictInt(hc, "expected_status_max", 399, hc_ctx);
+            }
+
             if (item.contains("tls")) {
                 if (!item["tls"].is_object())
                     throw std::runtime_error("upstream tls must be an object");
@@ -805,6 +968,18 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                 upstream.tls.verify_peer = tls.value("verify_peer", true);
                 upstream.tls.sni_hostname = tls.value("sni_hostname", "");
                 upstream.tls.min_version = tls.value("min_version", "1.2");
+                if (tls.contains("session_reuse")) {
+                    if (!tls["session_reuse"].is_boolean())
+                        throw std::runtime_error(
+                            up_ctx + ".tls.session_reuse must be a boolean");
+                    upstream.tls.session_reuse = tls["session_reuse"].get<bool>();
+                }
+                if (tls.contains("ktls")) {
+                    if (!tls["ktls"].is_boolean())
+                        throw std::runtime_error(
+                            up_ctx + ".tls.ktls must be a boolean");
+                    upstream.tls.ktls = tls["ktls"].get<bool>();
+                }
             }
 
             if (item.contains("pool")) {
@@ -816,6 +991,22 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                     ParseStrictInt(pool, "max_connections", 64, pool_ctx);
                 upstream.pool.max_idle_connections =
                     ParseStrictInt(pool, "max_idle_connections", 16, pool_ctx);
+                upstream.pool.min_idle_connections =
+                    ParseStrictInt(pool, "min_idle_connections", 0, pool_ctx);
+                if (pool.contains("adaptive_min_idle")) {
+                    if (!pool["adaptive_min_idle"].is_boolean())
+                        throw std::runtime_error(
+                            pool_ctx + ".adaptive_min_idle must be a boolean");
+                    upstream.pool.adaptive_min_idle =
+                        pool["adaptive_min_idle"].get<bool>();
+                }
+                if (pool.contains("lend_idle_connections")) {
+                    if (!pool["lend_idle_connections"].is_boolean())
+                        throw std::runtime_error(
+                            pool_ctx + ".lend_idle_connections must be a boolean");
+                    upstream.pool.lend_idle_connections =
+                        pool["lend_idle_connections"].get<bool>();
+                }
                 upstream.pool.connect_timeout_ms =
                     ParseStrictInt(pool, "connect_timeout_ms", 5000, pool_ctx);
                 upstream.pool.idle_timeout_sec =
@@ -843,6 +1034,31 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                     proxy.value("h10_streaming", "close");
                 upstream.proxy.forward_trailers =
                     proxy.value("forward_trailers", false);
+                if (proxy.contains("early_hints")) {
+                    if (!proxy["early_hints"].is_array())
+                        throw std::runtime_error("upstream proxy early_hints must be an array");
+                    for (const auto& l : proxy["early_hints"]) {
+                        if (!l.is_string())
+                            throw std::runtime_error("upstream proxy early_hints entry must be a string");
+                        upstream.proxy.early_hints.push_back(l.get<std::string>());
+                    }
+                }
+                if (proxy.contains("relay_early_hints")) {
+                    if (!proxy["relay_early_hints"].is_boolean())
+                        throw std::runtime_error("upstream proxy relay_early_hints must be a boolean");
+                    upstream.proxy.relay_early_hints =
+                        proxy["relay_early_hints"].get<bool>();
+                }
+                if (proxy.contains("websocket")) {
+                    if (!proxy["websocket"].is_boolean())
+                        throw std::runtime_error("upstream proxy websocket must be a boolean");
+                    upstream.proxy.websocket = proxy["websocket"].get<bool>();
+                }
+                if (proxy.contains("cache")) {
+                    if (!proxy["cache"].is_boolean())
+                        throw std::runtime_error("upstream proxy cache must be a boolean");
+                    upstream.proxy.cache = proxy["cache"].get<bool>();
+                }
                 upstream.proxy.route_prefix = proxy.value("route_prefix", "");
                 upstream.proxy.strip_prefix = proxy.value("strip_prefix", false);
                 upstream.proxy.response_timeout_ms = ParseStrictInt(
@@ -879,6 +1095,116 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                     upstream.proxy.retry.retry_on_timeout = r.value("retry_on_timeout", false);
                     upstream.proxy.retry.retry_on_disconnect = r.value("retry_on_disconnect", true);
                     upstream.proxy.retry.retry_non_idempotent = r.value("retry_non_idempotent", false);
+                    if (r.contains("hedge")) {
+                        if (!r["hedge"].is_object())
+                            throw std::runtime_error("upstream proxy retry hedge must be an object");
+                        auto& h = r["hedge"];
+                        const std::string hedge_ctx = up_ctx + ".proxy.retry.hedge";
+                        if (h.contains("enabled")) {
+                            if (!h["enabled"].is_boolean())
+                                throw std::runtime_error(hedge_ctx + ".enabled must be a boolean");
+                            upstream.proxy.retry.hedge.enabled = h["enabled"].get<bool>();
+                        }
+                        upstream.proxy.retry.hedge.delay_ms =
+                            ParseStrictInt(h, "delay_ms", 100, hedge_ctx);
+                        upstream.proxy.retry.hedge.percentile =
+                            ParseStrictInt(h, "percentile", 0, hedge_ctx);
+                    }
+                    if (r.contains("replay_buffer")) {
+                        if (!r["replay_buffer"].is_object())
+                            throw std::runtime_error("upstream proxy retry replay_buffer must be an object");
+                        auto& rb = r["replay_buffer"];
+                        const std::string rb_ctx = up_ctx + ".proxy.retry.replay_buffer";
+                        auto& replay = upstream.proxy.retry.replay_buffer;
+                        auto rb_bytes = [&rb, &rb_ctx](const char* key, int64_t& out) {
+                            if (!rb.contains(key)) return;
+                            if (!rb[key].is_number_integer())
+                                throw std::runtime_error(
+                                    rb_ctx + "." + key + " must be an integer");
+                            out = rb[key].get<int64_t>();
+                        };
+                        rb_bytes("max_bytes", replay.max_bytes);
+                        rb_bytes("memory_bytes", replay.memory_bytes);
+                        if (rb.contains("spill_dir")) {
+                            if (!rb["spill_dir"].is_string())
+                                throw std::runtime_error(rb_ctx + ".spill_dir must be a string");
+                            replay.spill_dir = rb["spill_dir"].get<std::string>();
+                        }
+                    }
+                }
+
+                if (proxy.contains("grpc")) {
+                    if (!proxy["grpc"].is_object())
+                        throw std::runtime_error("upstream proxy grpc must be an object");
+                    auto& g = proxy["grpc"];
+                    const std::string grpc_ctx = up_ctx + ".proxy.grpc";
+                    auto grpc_bool = [&g, &grpc_ctx](const char* name, bool def) {
+                        if (!g.contains(name)) return def;
+                        if (!g[name].is_boolean())
+                            throw std::runtime_error(
+                                grpc_ctx + "." + name + " must be a boolean");
+                        return g[name].get<bool>();
+                    };
+                    auto grpc_names = [&g, &grpc_ctx](const char* name,
+                                                      std::vector<std::string>& out) {
+                        if (!g.contains(name)) return;
+                        if (!g[name].is_array())
+                            throw std::runtime_error(
+                                grpc_ctx + "." + name + " must be an array");
+                        out.clear();
+                        for (const auto& v : g[name]) {
+                            if (!v.is_string())
+                                throw std::runtime_error(
+                                    grpc_ctx + "." + name + " entry must be a string");
+                            out.push_back(v.get<std::string>());
+                        }
+                    };
+                    upstream.proxy.grpc.enabled = grpc_bool("enabled", false);
+                    grpc_names("retry_on", upstream.proxy.grpc.retry_on);
+                    grpc_names("breaker_failure_on",
+                               upstream.proxy.grpc.breaker_failure_on);
+                    upstream.proxy.grpc.propagate_timeout =
+                        grpc_bool("propagate_timeout", true);
+                    upstream.proxy.grpc.max_timeout_ms =
+                        ParseStrictInt(g, "max_timeout_ms", 0, grpc_ctx);
+                    int max_msg = ParseStrictInt(g, "max_message_bytes", 0, grpc_ctx);
+                    if (max_msg < 0)
+                        throw std::runtime_error(
+                            grpc_ctx + ".max_message_bytes must be >= 0");
+                    upstream.proxy.grpc.max_message_bytes =
+                        static_cast<uint32_t>(max_msg);
+                    upstream.proxy.grpc.method_histograms =
+                        grpc_bool("method_histograms", true);
+                }
+
+                if (proxy.contains("singleflight")) {
+                    if (!proxy["singleflight"].is_object())
+                        throw std::runtime_error("upstream proxy singleflight must be an object");
+                    auto& sf = proxy["singleflight"];
+                    const std::string sf_ctx = up_ctx + ".proxy.singleflight";
+                    if (sf.contains("enabled")) {
+                        if (!sf["enabled"].is_boolean())
+                            throw std::runtime_error(sf_ctx + ".enabled must be a boolean");
+                        upstream.proxy.singleflight.enabled = sf["enabled"].get<bool>();
+                    }
+                    if (sf.contains("key_headers")) {
+                        if (!sf["key_headers"].is_array())
+                            throw std::runtime_error(sf_ctx + ".key_headers must be an array");
+                        for (const auto& h : sf["key_headers"]) {
+                            if (!h.is_string())
+                                throw std::runtime_error(
+                                    sf_ctx + ".key_headers entry must be a string");
+                            upstream.proxy.singleflight.key_headers.push_back(
+                                h.get<std::string>());
+                        }
+                    }
+                    if (sf.contains("max_replay_bytes")) {
+                        if (!sf["max_replay_bytes"].is_number_integer())
+                            throw std::runtime_error(
+                                sf_ctx + ".max_replay_bytes must be an integer");
+                        upstream.proxy.singleflight.max_replay_bytes =
+                            sf["max_replay_bytes"].get<int64_t>();
+                    }
                 }
 
                 // Inline per-proxy auth policy. `applies_to` is derived from
@@ -949,6 +1275,38 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
                     cb_int("retry_budget_percent", 20);
                 upstream.circuit_breaker.retry_budget_min_concurrency =
                     cb_int("retry_budget_min_concurrency", 3);
+
+                if (cb.contains("outlier_detection")) {
+                    if (!cb["outlier_detection"].is_object())
+                        throw std::runtime_error(
+                            "circuit_breaker.outlier_detection must be an object");
+                    auto& od_json = cb["outlier_detection"];
+                    auto& od = upstream.circuit_breaker.outlier_detection;
+                    auto od_int = [&od_json](const char* name, int default_val) {
+                        return ParseStrictInt(od_json, name, default_val,
+                                              "circuit_breaker.outlier_detection");
+                    };
+                    if (od_json.contains("enabled")) {
+                        if (!od_json["enabled"].is_boolean())
+                            throw std::invalid_argument(
+                                "circuit_breaker.outlier_detection.enabled "
+                                "must be a boolean");
+                        od.enabled = od_json["enabled"].get<bool>();
+                    }
+                    od.interval_ms = od_int("interval_ms", 10000);
+                    od.consecutive_5xx = od_int("consecutive_5xx", 5);
+                    od.base_ejection_time_ms =
+                        od_int("base_ejection_time_ms", 30000);
+                    od.max_ejection_time_ms =
+                        od_int("max_ejection_time_ms", 300000);
+                    od.minimum_hosts = od_int("minimum_hosts", 3);
+                    od.request_volume = od_int("request_volume", 100);
+                    od.success_rate_stdev_factor =
+                        od_int("success_rate_stdev_factor", 1900);
+                    od.latency_p99_factor_percent =
+                        od_int("latency_p99_factor_percent", 300);
+                    od.latency_p99_min_ms = od_int("latency_p99_min_ms", 50);
+                }
             }
 
             if (item.contains("http2")) {
@@ -1125,6 +1483,42 @@ ServerConfig ConfigLoader::LoadFromString(const std::string& json_str) {
         }
     }
 
+    // Shared proxy response cache — restart-only; routes opt in through
+    // upstreams[].proxy.cache.
+    if (j.contains("proxy_cache")) {
+        if (!j["proxy_cache"].is_object())
+            throw std::runtime_error("proxy_cache must be an object");
+        auto& pc = j["proxy_cache"];
+        auto& cc = config.proxy_cache;
+        auto pc_bool = [&](const char* key, bool& out) {
+            if (!pc.contains(key)) return;
+            if (!pc[key].is_boolean())
+                throw std::runtime_error(
+                    std::string("proxy_cache.") + key + " must be a boolean");
+            out = pc[key].get<bool>();
+        };
+        auto pc_bytes = [&](const char* key, int64_t& out) {
+            if (!pc.contains(key)) return;
+            if (!pc[key].is_number_unsigned())
+                throw std::runtime_error(
+                    std::string("proxy_cache.") + key +
+                    " must be a non-negative integer");
+            out = pc[key].get<int64_t>();
+        };
+        pc_bool("enabled", cc.enabled);
+        pc_bool("collapse_requests", cc.collapse_requests);
+        pc_bytes("memory_max_bytes", cc.memory_max_bytes);
+        pc_bytes("disk_max_bytes", cc.disk_max_bytes);
+        pc_bytes("max_object_bytes", cc.max_object_bytes);
+        if (pc.contains("disk_path")) {
+            if (!pc["disk_path"].is_string())
+                throw std::runtime_error("proxy_cache.disk_path must be a string");
+            cc.disk_path = pc["disk_path"].get<std::string>();
+        }
+        cc.max_entries = ParseStrictInt(pc, "max_entries", cc.max_entries,
+                                        "proxy_cache");
+    }
+
     // Top-level auth config section (OAuth 2.0 token validation — §5.1).
     // Parsed into config.auth; actually consumed by AuthManager at startup
     // and by HttpServer::Reload() via AuthManager::Reload(). Per-proxy
@@ -1784,6 +2178,11 @@ void ConfigLoader::Normalize(ServerConfig& config) {
         const std::string host_field =
             "upstreams[" + std::to_string(i) + "] ('" + u.name + "').host";
         normalize_one(u.host, host_field);
+        for (size_t e = 0; e < u.endpoints.size(); ++e) {
+            normalize_one(u.endpoints[e].host,
+                          "upstreams[" + std::to_string(i) + "] ('" + u.name +
+                          "').endpoints[" + std::to_string(e) + "].host");
+        }
 
         // tls.sni_hostname: strip ONE trailing '.' (§5.6 v0.37 round-36
         // P2 + v0.38 round-37 P2 malformed-dot guard). SNI is NEVER a
@@ -2075,6 +2474,54 @@ static void ValidateIntrospectionFields(
     }
 }
 
+// Range checks for circuit_breaker.outlier_detection. Shared by Validate()
+// and ValidateHotReloadable() because the block reloads live with the
+// breaker. `ctx` names the owning upstream in error messages.
+static void ValidateOutlierDetection(const OutlierDetectionConfig& od,
+                                     const std::string& ctx) {
+    if (od.interval_ms < 100) {
+        throw std::invalid_argument(
+            ctx + ".interval_ms must be >= 100");
+    }
+    if (od.consecutive_5xx < 0 || od.consecutive_5xx > 10000) {
+        throw std::invalid_argument(
+            ctx + ".consecutive_5xx must be in [0, 10000] (0 = disabled)");
+    }
+    if (od.base_ejection_time_ms < 100) {
+        throw std::invalid_argument(
+            ctx + ".base_ejection_time_ms must be >= 100");
+    }
+    if (od.max_ejection_time_ms < od.base_ejection_time_ms) {
+        throw std::invalid_argument(
+            ctx + ".max_ejection_time_ms must be >= base_ejection_time_ms");
+    }
+    if (od.minimum_hosts < 2 || od.minimum_hosts > 10000) {
+        throw std::invalid_argument(
+            ctx + ".minimum_hosts must be in [2, 10000]");
+    }
+    if (od.request_volume < 1 || od.request_volume > 10000000) {
+        throw std::invalid_argument(
+            ctx + ".request_volume must be in [1, 10000000]");
+    }
+    if (od.success_rate_stdev_factor < 0 ||
+        od.success_rate_stdev_factor > 100000) {
+        throw std::invalid_argument(
+            ctx + ".success_rate_stdev_factor must be in [0, 100000] "
+            "(0 = disabled)");
+    }
+    if (od.latency_p99_factor_percent != 0 &&
+        (od.latency_p99_factor_percent < 101 ||
+         od.latency_p99_factor_percent > 100000)) {
+        throw std::invalid_argument(
+            ctx + ".latency_p99_factor_percent must be 0 (disabled) or "
+            "in [101, 100000]");
+    }
+    if (od.latency_p99_min_ms < 0) {
+        throw std::invalid_argument(
+            ctx + ".latency_p99_min_ms must be >= 0");
+    }
+}
+
 void ConfigLoader::ValidateHotReloadable(
         const ServerConfig& config,
         const std::unordered_set<std::string>& live_upstream_names,
@@ -2348,6 +2795,9 @@ void ConfigLoader::ValidateHotReloadable(
                 idx + " ('" + u.name +
                 "'): circuit_breaker.retry_budget_min_concurrency must be >= 0");
         }
+        ValidateOutlierDetection(
+            cb.outlier_detection,
+            idx + " ('" + u.name + "'): circuit_breaker.outlier_detection");
     }
 
     // Auth hot-reloadable field validation. Two-pass scoping so structural
@@ -2920,6 +3370,64 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
             "http1.streaming.low_water_bytes must be < high_water_bytes");
     }
 
+    if (config.proxy_cache.enabled) {
+        const auto& pc = config.proxy_cache;
+        if (pc.memory_max_bytes <= 0) {
+            throw std::invalid_argument(
+                "proxy_cache.memory_max_bytes must be > 0");
+        }
+        if (pc.max_object_bytes <= 0 ||
+            pc.max_object_bytes > pc.memory_max_bytes) {
+            throw std::invalid_argument(
+                "proxy_cache.max_object_bytes must be in [1, memory_max_bytes]");
+        }
+        if (!pc.disk_path.empty() && pc.disk_max_bytes <= 0) {
+            throw std::invalid_argument(
+                "proxy_cache.disk_max_bytes must be > 0 when disk_path is set");
+        }
+        if (pc.max_entries < 1) {
+            throw std::invalid_argument(
+                "proxy_cache.max_entries must be >= 1");
+        }
+    }
+
+    if (config.http3.enabled) {
+        if (config.http3.port < 0 || config.http3.port > 65535) {
+            throw std::invalid_argument(
+                "http3.port must be in [0, 65535]");
+        }
+        if (config.http3.max_datagram_size < 64 ||
+            config.http3.max_datagram_size > 65507) {
+            throw std::invalid_argument(
+                "http3.max_datagram_size must be in [64, 65507]");
+        }
+        if (config.http3.recv_batch_size < 1 ||
+            config.http3.recv_batch_size > 1024) {
+            throw std::invalid_argument(
+                "http3.recv_batch_size must be in [1, 1024]");
+        }
+    }
+
+    {
+        const auto& dc = config.websocket.permessage_deflate;
+        if (dc.server_max_window_bits < 9 || dc.server_max_window_bits > 15) {
+            throw std::invalid_argument(
+                "websocket.permessage_deflate.server_max_window_bits must be in [9, 15]");
+        }
+        if (dc.client_max_window_bits < 9 || dc.client_max_window_bits > 15) {
+            throw std::invalid_argument(
+                "websocket.permessage_deflate.client_max_window_bits must be in [9, 15]");
+        }
+        if (dc.compression_level < 1 || dc.compression_level > 9) {
+            throw std::invalid_argument(
+                "websocket.permessage_deflate.compression_level must be in [1, 9]");
+        }
+        if (dc.mem_level < 1 || dc.mem_level > 9) {
+            throw std::invalid_argument(
+                "websocket.permessage_deflate.mem_level must be in [1, 9]");
+        }
+    }
+
     if (config.tls.enabled) {
         if (config.tls.cert_file.empty()) {
             throw std::invalid_argument(
@@ -2968,6 +3476,53 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                 "Invalid tls.min_version: '" + config.tls.min_version +
                 "' (must be '1.2' or '1.3')");
         }
+        if (!config.tls.ticket_key_file.empty()) {
+            if (!config.tls.session_tickets) {
+                throw std::invalid_argument(
+                    "tls.ticket_key_file is set but tls.session_tickets is false");
+            }
+            struct stat st{};
+            if (stat(config.tls.ticket_key_file.c_str(), &st) != 0) {
+                if (errno != EACCES) {
+                    throw std::invalid_argument(
+                        "TLS ticket_key_file not found: '" +
+                        config.tls.ticket_key_file + "' (" +
+                        std::strerror(errno) + ")");
+                }
+            } else if (!S_ISREG(st.st_mode)) {
+                throw std::invalid_argument(
+                    "TLS ticket_key_file is not a regular file: '" +
+                    config.tls.ticket_key_file + "'");
+            }
+        }
+        if (config.tls.session_cache_size < 0) {
+            throw std::invalid_argument(
+                "tls.session_cache_size must be >= 0 (0 = off)");
+        }
+        if (config.tls.session_timeout_sec < 1 ||
+            config.tls.session_timeout_sec > 604800) {
+            throw std::invalid_argument(
+                "tls.session_timeout_sec must be in [1, 604800]");
+        }
+        if (config.tls.handshake_offload_threads < 0 ||
+            config.tls.handshake_offload_threads > 64) {
+            throw std::invalid_argument(
+                "tls.handshake_offload_threads must be in [0, 64]");
+        }
+        // OpenSSL's max_send_fragment floor is 512.
+        if (config.tls.record_size_initial < 512 ||
+            config.tls.record_size_initial > 16384) {
+            throw std::invalid_argument(
+                "tls.record_size_initial must be in [512, 16384]");
+        }
+        if (config.tls.record_size_ramp_bytes < 0) {
+            throw std::invalid_argument(
+                "tls.record_size_ramp_bytes must be >= 0");
+        }
+        if (config.tls.record_size_idle_reset_ms < 0) {
+            throw std::invalid_argument(
+                "tls.record_size_idle_reset_ms must be >= 0");
+        }
     }
 
     // Upstream validation
@@ -2984,6 +3539,19 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                 throw std::invalid_argument(
                     "Duplicate upstream name: '" + u.name + "'");
             }
+            // Endpoints after the first are resolved under "<name>#<i>"
+            // (UpstreamManager::EndpointResolveKey); a '#' in a name
+            // could collide with another upstream's key.
+            if (u.name.find('#') != std::string::npos) {
+                for (const auto& other : config.upstreams) {
+                    if (other.endpoints.size() > 1) {
+                        throw std::invalid_argument(
+                            idx + " ('" + u.name + "'): name must not "
+                            "contain '#' when any upstream lists more than "
+                            "one endpoint");
+                    }
+                }
+            }
             if (u.host.empty()) {
                 throw std::invalid_argument(
                     idx + " ('" + u.name + "'): host must not be empty");
@@ -3006,6 +3574,102 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                     idx + " ('" + u.name + "'): port must be 1-65535, got " +
                     std::to_string(u.port));
             }
+            for (size_t e = 0; e < u.endpoints.size(); ++e) {
+                const auto& ep = u.endpoints[e];
+                const std::string ep_idx = idx + " ('" + u.name +
+                    "'): endpoints[" + std::to_string(e) + "]";
+                if (!NET_DNS_NAMESPACE::DnsResolver::IsValidHostOrIpLiteral(ep.host)) {
+                    throw std::invalid_argument(
+                        ep_idx + ".host must be a valid IP literal or RFC 1123 "
+                        "hostname, got '" + ep.host + "'");
+                }
+                if (ep.port < 1 || ep.port > 65535) {
+                    throw std::invalid_argument(
+                        ep_idx + ".port must be 1-65535, got " +
+                        std::to_string(ep.port));
+                }
+                if (ep.weight < 1 || ep.weight > 1000) {
+                    throw std::invalid_argument(
+                        ep_idx + ".weight must be 1-1000, got " +
+                        std::to_string(ep.weight));
+                }
+            }
+            {
+                const auto& lb = u.load_balancer;
+                if (lb.policy != "round_robin" && lb.policy != "weighted" &&
+                    lb.policy != "least_request" && lb.policy != "ring_hash" &&
+                    lb.policy != "maglev") {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name + "'): load_balancer.policy must "
+                        "be one of round_robin, weighted, least_request, "
+                        "ring_hash, maglev; got '" + lb.policy + "'");
+                }
+                const bool header_key =
+                    lb.hash_key.size() > 7 &&
+                    lb.hash_key.rfind("header:", 0) == 0;
+                if (lb.hash_key != "client_ip" && lb.hash_key != "path" &&
+                    !header_key) {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name + "'): load_balancer.hash_key must "
+                        "be client_ip, path, or header:<name>; got '" +
+                        lb.hash_key + "'");
+                }
+            }
+            {
+                const auto& hc = u.health_check;
+                const std::string hc_idx =
+                    idx + " ('" + u.name + "'): health_check.";
+                if (hc.type != "http" && hc.type != "tcp") {
+                    throw std::invalid_argument(
+                        hc_idx + "type must be http or tcp, got '" +
+                        hc.type + "'");
+                }
+                if (hc.type == "http" &&
+                    (hc.path.empty() || hc.path[0] != '/')) {
+                    throw std::invalid_argument(
+                        hc_idx + "path must start with '/', got '" +
+                        hc.path + "'");
+                }
+                // Both go on the request line / Host header verbatim.
+                auto has_ctl = [](const std::string& v) {
+                    return std::any_of(v.begin(), v.end(), [](unsigned char c) {
+                        return c <= 0x20 || c == 0x7f;
+                    });
+                };
+                if (has_ctl(hc.path) || has_ctl(hc.host)) {
+                    throw std::invalid_argument(
+                        hc_idx + "path and host must not contain spaces or "
+                        "control characters");
+                }
+                if (hc.interval_ms < 100 || hc.interval_ms > 3600000) {
+                    throw std::invalid_argument(
+                        hc_idx + "interval_ms must be 100-3600000, got " +
+                        std::to_string(hc.interval_ms));
+                }
+                if (hc.timeout_ms < 1 || hc.timeout_ms > hc.interval_ms) {
+                    throw std::invalid_argument(
+                        hc_idx + "timeout_ms must be 1-interval_ms, got " +
+                        std::to_string(hc.timeout_ms));
+                }
+                if (hc.jitter_percent < 0 || hc.jitter_percent > 50) {
+                    throw std::invalid_argument(
+                        hc_idx + "jitter_percent must be 0-50, got " +
+                        std::to_string(hc.jitter_percent));
+                }
+                if (hc.healthy_threshold < 1 || hc.healthy_threshold > 100 ||
+                    hc.unhealthy_threshold < 1 || hc.unhealthy_threshold > 100) {
+                    throw std::invalid_argument(
+                        hc_idx + "healthy_threshold and unhealthy_threshold "
+                        "must be 1-100");
+                }
+                if (hc.expected_status_min < 100 ||
+                    hc.expected_status_max > 599 ||
+                    hc.expected_status_min > hc.expected_status_max) {
+                    throw std::invalid_argument(
+                        hc_idx + "expected_status_min/max must be an "
+                        "ascending range within 100-599");
+                }
+            }
 
             // Pool constraints
             if (u.pool.max_connections < 1) {
@@ -3025,6 +3689,20 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                     "'): pool.max_idle_connections must be 0 to pool.max_connections (" +
                     std::to_string(u.pool.max_connections) + ")");
             }
+            if (u.pool.min_idle_connections < 0 ||
+                u.pool.min_idle_connections > u.pool.max_idle_connections) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): pool.min_idle_connections must be 0 to pool.max_idle_connections (" +
+                    std::to_string(u.pool.max_idle_connections) + ")");
+            }
+            // A lent connection moves between event loops as a bare fd;
+            // a TLS session is tied to the dispatcher that handshook it.
+            if (u.pool.lend_idle_connections && u.tls.enabled) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): pool.lend_idle_connections requires tls.enabled=false");
+            }
             if (u.pool.connect_timeout_ms < 1000) {
                 throw std::invalid_argument(
                     idx + " ('" + u.name +
@@ -3139,6 +3817,33 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                     "'): proxy.retry.max_retries must be >= 0 and <= " +
                     std::to_string(kMaxProxyRetryCount));
             }
+            if (u.proxy.retry.hedge.delay_ms < 1) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): proxy.retry.hedge.delay_ms must be >= 1");
+            }
+            if (u.proxy.retry.hedge.percentile != 0 &&
+                (u.proxy.retry.hedge.percentile < 50 ||
+                 u.proxy.retry.hedge.percentile > 99)) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): proxy.retry.hedge.percentile must be 0 or 50-99");
+            }
+            {
+                const auto& rb = u.proxy.retry.replay_buffer;
+                if (rb.max_bytes < 0 || rb.memory_bytes < 0) {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name +
+                        "'): proxy.retry.replay_buffer.max_bytes and "
+                        "memory_bytes must be >= 0");
+                }
+                if (rb.max_bytes > rb.memory_bytes && rb.spill_dir.empty()) {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name +
+                        "'): proxy.retry.replay_buffer.spill_dir is required "
+                        "when max_bytes exceeds memory_bytes");
+                }
+            }
 
             // Circuit breaker validation.
             //
@@ -3201,6 +3906,9 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                         idx + " ('" + u.name +
                         "'): circuit_breaker.retry_budget_min_concurrency must be >= 0");
                 }
+                ValidateOutlierDetection(
+                    cb.outlier_detection,
+                    idx + " ('" + u.name + "'): circuit_breaker.outlier_detection");
             }
 
             // Per-upstream HTTP/2 validation. Outbound H2 requires
@@ -3334,6 +4042,47 @@ void ConfigLoader::Validate(const ServerConfig& config, bool reload_copy) {
                 }
             }
 
+            // Early Hints Link values go onto the wire verbatim inside a
+            // 103 — reject anything that is not a single <uri>-led value.
+            for (const auto& l : u.proxy.early_hints) {
+                if (!HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue(l)) {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name +
+                        "'): proxy.early_hints entry is not a valid Link value "
+                        "(expected \"<uri>; rel=preload...\"): " + l);
+                }
+            }
+
+            if (u.proxy.grpc.max_timeout_ms < 0) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): proxy.grpc.max_timeout_ms must be >= 0");
+            }
+            for (const auto* list : {&u.proxy.grpc.retry_on,
+                                     &u.proxy.grpc.breaker_failure_on}) {
+                for (const auto& n : *list) {
+                    if (GRPC_NAMESPACE::ParseStatusName(n) < 0) {
+                        throw std::invalid_argument(
+                            idx + " ('" + u.name +
+                            "'): proxy.grpc status name is not a gRPC status "
+                            "(expected e.g. \"unavailable\"): " + n);
+                    }
+                }
+            }
+
+            if (u.proxy.singleflight.max_replay_bytes < 0) {
+                throw std::invalid_argument(
+                    idx + " ('" + u.name +
+                    "'): proxy.singleflight.max_replay_bytes must be >= 0");
+            }
+            for (const auto& h : u.proxy.singleflight.key_headers) {
+                if (h.empty()) {
+                    throw std::invalid_argument(
+                        idx + " ('" + u.name +
+                        "'): proxy.singleflight.key_headers entry must be non-empty");
+                }
+            }
+
             // Upstream TLS validation
             if (u.tls.enabled) {
                 if (u.tls.min_version != "1.2" && u.tls.min_version != "1.3") {
@@ -4199,6 +4948,16 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
     j["tls"]["cert_file"]   = config.tls.cert_file;
     j["tls"]["key_file"]    = config.tls.key_file;
     j["tls"]["min_version"] = config.tls.min_version;
+    j["tls"]["session_tickets"]     = config.tls.session_tickets;
+    j["tls"]["ticket_key_file"]     = config.tls.ticket_key_file;
+    j["tls"]["session_cache_size"]  = config.tls.session_cache_size;
+    j["tls"]["session_timeout_sec"] = config.tls.session_timeout_sec;
+    j["tls"]["ktls"] = config.tls.ktls;
+    j["tls"]["handshake_offload_threads"] = config.tls.handshake_offload_threads;
+    j["tls"]["record_sizing"] = config.tls.record_sizing;
+    j["tls"]["record_size_initial"] = config.tls.record_size_initial;
+    j["tls"]["record_size_ramp_bytes"] = config.tls.record_size_ramp_bytes;
+    j["tls"]["record_size_idle_reset_ms"] = config.tls.record_size_idle_reset_ms;
     j["log"]["level"]       = config.log.level;
     j["log"]["file"]        = config.log.file;
     j["log"]["max_file_size"] = config.log.max_file_size;
@@ -4209,6 +4968,7 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
     j["http2"]["max_frame_size"]         = config.http2.max_frame_size;
     j["http2"]["max_header_list_size"]   = config.http2.max_header_list_size;
     j["http2"]["enable_push"]            = config.http2.enable_push;
+    j["http2"]["write_batching"]         = config.http2.write_batching;
     {
         nlohmann::json sj;
         sj["high_water_bytes"] = config.http2.streaming.high_water_bytes;
@@ -4222,6 +4982,24 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
         sj["low_water_bytes"]  = config.http1.streaming.low_water_bytes;
         j["http1"]["streaming"] = sj;
     }
+    j["http3"]["enabled"]           = config.http3.enabled;
+    j["http3"]["port"]              = config.http3.port;
+    j["http3"]["max_datagram_size"] = config.http3.max_datagram_size;
+    j["http3"]["recv_batch_size"]   = config.http3.recv_batch_size;
+    {
+        const auto& dc = config.websocket.permessage_deflate;
+        nlohmann::json pj;
+        pj["enabled"]                    = dc.enabled;
+        pj["server_no_context_takeover"] = dc.server_no_context_takeover;
+        pj["client_no_context_takeover"] = dc.client_no_context_takeover;
+        pj["server_max_window_bits"]     = dc.server_max_window_bits;
+        pj["client_max_window_bits"]     = dc.client_max_window_bits;
+        pj["compression_level"]          = dc.compression_level;
+        pj["mem_level"]                  = dc.mem_level;
+        pj["min_message_size"]           = dc.min_message_size;
+        pj["max_memory_bytes"]           = dc.max_memory_bytes;
+        j["websocket"]["permessage_deflate"] = pj;
+    }
 
     j["upstreams"] = nlohmann::json::array();
     for (const auto& u : config.upstreams) {
@@ -4229,13 +5007,42 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
         uj["name"] = u.name;
         uj["host"] = u.host;
         uj["port"] = u.port;
+        if (!u.endpoints.empty()) {
+            uj["endpoints"] = nlohmann::json::array();
+            for (const auto& ep : u.endpoints) {
+                uj["endpoints"].push_back(
+                    {{"host", ep.host}, {"port", ep.port}, {"weight", ep.weight}});
+            }
+        }
+        uj["load_balancer"]["policy"]   = u.load_balancer.policy;
+        uj["load_balancer"]["hash_key"] = u.load_balancer.hash_key;
+        {
+            const auto& hc = u.health_check;
+            auto& hcj = uj["health_check"];
+            hcj["enabled"]             = hc.enabled;
+            hcj["type"]                = hc.type;
+            hcj["path"]                = hc.path;
+            hcj["host"]                = hc.host;
+            hcj["interval_ms"]         = hc.interval_ms;
+            hcj["timeout_ms"]          = hc.timeout_ms;
+            hcj["jitter_percent"]      = hc.jitter_percent;
+            hcj["healthy_threshold"]   = hc.healthy_threshold;
+            hcj["unhealthy_threshold"] = hc.unhealthy_threshold;
+            hcj["expected_status_min"] = hc.expected_status_min;
+            hcj["expected_status_max"] = hc.expected_status_max;
+        }
         uj["tls"]["enabled"]      = u.tls.enabled;
         uj["tls"]["ca_file"]      = u.tls.ca_file;
         uj["tls"]["verify_peer"]  = u.tls.verify_peer;
         uj["tls"]["sni_hostname"] = u.tls.sni_hostname;
         uj["tls"]["min_version"]  = u.tls.min_version;
+        uj["tls"]["session_reuse"] = u.tls.session_reuse;
+        uj["tls"]["ktls"] = u.tls.ktls;
         uj["pool"]["max_connections"]      = u.pool.max_connections;
         uj["pool"]["max_idle_connections"] = u.pool.max_idle_connections;
+        uj["pool"]["min_idle_connections"] = u.pool.min_idle_connections;
+        uj["pool"]["adaptive_min_idle"]    = u.pool.adaptive_min_idle;
+        uj["pool"]["lend_idle_connections"] = u.pool.lend_idle_connections;
         uj["pool"]["connect_timeout_ms"]   = u.pool.connect_timeout_ms;
         uj["pool"]["idle_timeout_sec"]     = u.pool.idle_timeout_sec;
         uj["pool"]["max_lifetime_sec"]     = u.pool.max_lifetime_sec;
@@ -4266,6 +5073,10 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
             pj["stream_max_duration_sec"] = u.proxy.stream_max_duration_sec;
             pj["h10_streaming"] = u.proxy.h10_streaming;
             pj["forward_trailers"] = u.proxy.forward_trailers;
+            pj["early_hints"] = u.proxy.early_hints;
+            pj["relay_early_hints"] = u.proxy.relay_early_hints;
+            pj["websocket"] = u.proxy.websocket;
+            pj["cache"] = u.proxy.cache;
             pj["route_prefix"] = u.proxy.route_prefix;
             pj["strip_prefix"] = u.proxy.strip_prefix;
             pj["response_timeout_ms"] = u.proxy.response_timeout_ms;
@@ -4285,8 +5096,34 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
             rj["retry_on_timeout"] = u.proxy.retry.retry_on_timeout;
             rj["retry_on_disconnect"] = u.proxy.retry.retry_on_disconnect;
             rj["retry_non_idempotent"] = u.proxy.retry.retry_non_idempotent;
+            nlohmann::json hj;
+            hj["enabled"] = u.proxy.retry.hedge.enabled;
+            hj["delay_ms"] = u.proxy.retry.hedge.delay_ms;
+            hj["percentile"] = u.proxy.retry.hedge.percentile;
+            rj["hedge"] = hj;
+            nlohmann::json rbj;
+            rbj["max_bytes"] = u.proxy.retry.replay_buffer.max_bytes;
+            rbj["memory_bytes"] = u.proxy.retry.replay_buffer.memory_bytes;
+            rbj["spill_dir"] = u.proxy.retry.replay_buffer.spill_dir;
+            rj["replay_buffer"] = rbj;
             pj["retry"] = rj;
 
+            nlohmann::json gj;
+            gj["enabled"] = u.proxy.grpc.enabled;
+            gj["retry_on"] = u.proxy.grpc.retry_on;
+            gj["breaker_failure_on"] = u.proxy.grpc.breaker_failure_on;
+            gj["propagate_timeout"] = u.proxy.grpc.propagate_timeout;
+            gj["max_timeout_ms"] = u.proxy.grpc.max_timeout_ms;
+            gj["max_message_bytes"] = u.proxy.grpc.max_message_bytes;
+            gj["method_histograms"] = u.proxy.grpc.method_histograms;
+            pj["grpc"] = gj;
+
+            nlohmann::json sfj;
+            sfj["enabled"] = u.proxy.singleflight.enabled;
+            sfj["key_headers"] = u.proxy.singleflight.key_headers;
+            sfj["max_replay_bytes"] = u.proxy.singleflight.max_replay_bytes;
+            pj["singleflight"] = sfj;
+
             // Inline per-proxy auth policy. Only emitted when differs from
             // default — same shape as the circuit_breaker block below —
             // because an empty/disabled stanza is the common case and
@@ -4320,6 +5157,19 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
                 u.circuit_breaker.retry_budget_percent;
             cbj["retry_budget_min_concurrency"] =
                 u.circuit_breaker.retry_budget_min_concurrency;
+            const auto& od = u.circuit_breaker.outlier_detection;
+            nlohmann::json odj;
+            odj["enabled"] = od.enabled;
+            odj["interval_ms"] = od.interval_ms;
+            odj["consecutive_5xx"] = od.consecutive_5xx;
+            odj["base_ejection_time_ms"] = od.base_ejection_time_ms;
+            odj["max_ejection_time_ms"] = od.max_ejection_time_ms;
+            odj["minimum_hosts"] = od.minimum_hosts;
+            odj["request_volume"] = od.request_volume;
+            odj["success_rate_stdev_factor"] = od.success_rate_stdev_factor;
+            odj["latency_p99_factor_percent"] = od.latency_p99_factor_percent;
+            odj["latency_p99_min_ms"] = od.latency_p99_min_ms;
+            cbj["outlier_detection"] = odj;
             uj["circuit_breaker"] = cbj;
         }
         if (u.http2 != Http2UpstreamConfig{}) {
@@ -4368,6 +5218,18 @@ std::string ConfigLoader::ToJson(const ServerConfig& config) {
         j["rate_limit"] = rlj;
     }
 
+    {
+        nlohmann::json pcj;
+        pcj["enabled"]           = config.proxy_cache.enabled;
+        pcj["memory_max_bytes"]  = config.proxy_cache.memory_max_bytes;
+        pcj["disk_path"]         = config.proxy_cache.disk_path;
+        pcj["disk_max_bytes"]    = config.proxy_cache.disk_max_bytes;
+        pcj["max_object_bytes"]  = config.proxy_cache.max_object_bytes;
+        pcj["max_entries"]       = config.proxy_cache.max_entries;
+        pcj["collapse_requests"] = config.proxy_cache.collapse_requests;
+        j["proxy_cache"] = pcj;
+    }
+
     // DNS section — always emitted so operators can see the effective
     // defaults in `--dump-config`-style tooling without parsing
     // dns_resolver.h. The one-line forms keep the JSON compact.
@@ -32,6 +32,7 @@ ConnectionHandler::~ConnectionHandler() {
         http_active_counter_->Add(-1.0,
             {{"protocol", http_protocol_label_}});
     }
+    SetTlsKeyOpWaiting(false);
 }
 
 void ConnectionHandler::AttachTransportObservability(
@@ -44,6 +45,8 @@ void ConnectionHandler::AttachTransportObservability(
     net_accepted_counter_   = cat.reactor_net_connections_accepted;
     http_active_counter_    = cat.reactor_http_connections_active;
     tls_handshakes_counter_ = cat.reactor_tls_handshakes;
+    tls_key_ops_queued_counter_ = cat.reactor_tls_handshakes_queued;
+    tls_records_counter_    = cat.reactor_tls_records;
     if (net_active_counter_   != nullptr) net_active_counter_->Add(1.0, {});
     if (net_accepted_counter_ != nullptr) net_accepted_counter_->Add(1.0, {});
 }
@@ -191,11 +194,20 @@ void ConnectionHandler::OnMessage(){
     tls_ready_from_write_ = false;  // consume
     if (tls_state_ == TlsState::HANDSHAKE) {
         int result = tls_->DoHandshake();
+        SetTlsKeyOpWaiting(result == TlsConnection::TLS_WANT_ASYNC);
+        if (result == TlsConnection::TLS_WANT_ASYNC) {
+            // Signature is on the offload pool; ResumeTlsHandshake runs
+            // when it completes.
+            return;
+        }
         if (result == TlsConnection::TLS_COMPLETE) {
             tls_state_ = TlsState::READY;
+            ktls_send_ = tls_->KtlsSendActive();
             tls_just_ready = true;
             if (tls_handshakes_counter_ != nullptr) {
-                tls_handshakes_counter_->Add(1.0, {{"outcome", "success"}});
+                tls_handshakes_counter_->Add(1.0, {
+                    {"outcome", "success"},
+                    {"mode", tls_->IsSessionReused() ? "resumed" : "full"}});
             }
             // Handshake complete, fall through to read any buffered data
         } else if (result == TlsConnection::TLS_WANT_READ) {
@@ -502,9 +514,9 @@ void ConnectionHandler::DoSend(const char *data, size_t size){
 
     if (output_bf_.Size() > 0) {
         ssize_t written;
-        if (tls_state_ == TlsState::READY) {
+        if (tls_state_ == TlsState::READY && !ktls_send_) {
             size_t try_len = output_bf_.Size();
-            written = tls_->Write(output_bf_.Data(), try_len);
+            written = TlsWrite(output_bf_.Data(), try_len);
             if (written == TlsConnection::TLS_COMPLETE) {
                 // WANT_WRITE — treat as EAGAIN for the send path
                 tls_pending_write_size_ = try_len;
@@ -520,8 +532,8 @@ void ConnectionHandler::DoSend(const char *data, size_t size){
                 // and we busy-loop retrying SSL_write that keeps returning WANT_READ.
                 return;
             }
-        } else if (tls_state_ == TlsState::NONE) {
-            // No TLS — raw send
+        } else if (tls_state_ == TlsState::NONE || ktls_send_) {
+            // No TLS, or the kernel encrypts (kTLS) — raw send
             written = ::send(fd(), output_bf_.Data(), output_bf_.Size(), SEND_FLAGS);
         }
         // tls_state_ == HANDSHAKE: skip direct send, data stays buffered
@@ -587,13 +599,21 @@ void ConnectionHandler::DoSendRaw(const char *data, size_t size){
         return;
     }
 
+    if (corked_) {
+        output_bf_.Append(data, size);
+        if (output_bf_.Size() >= CORK_FLUSH_BYTES) {
+            FlushOutputBuffer(/*more=*/true);
+        }
+        return;
+    }
+
     // If output buffer is empty, try sending directly first.
     // This avoids the edge-triggered EPOLLOUT issue where a freshly writable
     // socket won't generate a new event when EPOLLOUT is first registered.
     if (output_bf_.Size() == 0 && tls_state_ != TlsState::HANDSHAKE) {
         ssize_t written;
-        if (tls_state_ == TlsState::READY) {
-            written = tls_->Write(data, size);
+        if (tls_state_ == TlsState::READY && !ktls_send_) {
+            written = TlsWrite(data, size);
             if (written == TlsConnection::TLS_COMPLETE) {
                 // WANT_WRITE — data will be buffered below, record size for retry
                 tls_pending_write_size_ = size;
@@ -609,7 +629,7 @@ void ConnectionHandler::DoSendRaw(const char *data, size_t size){
                 return;
             }
         } else {
-            // No TLS — raw send
+            // No TLS, or kTLS — raw send
             written = ::send(fd(), data, size, SEND_FLAGS);
         }
         if (written > 0) {
@@ -638,6 +658,78 @@ void ConnectionHandler::DoSendRaw(const char *data, size_t size){
     client_channel_ -> EnableWriteMode();
 }
 
+void ConnectionHandler::CorkUntilLoopEnd() {
+    if (corked_ || is_closing_ || !IsOnDispatcherThread()) return;
+    std::weak_ptr<ConnectionHandler> weak_self = shared_from_this();
+    corked_ = event_dispatcher_->EnQueueAtLoopEnd([weak_self]() {
+        if (auto self = weak_self.lock()) {
+            self->Uncork();
+        }
+    });
+}
+
+void ConnectionHandler::Uncork() {
+    if (!corked_) return;
+    corked_ = false;
+    FlushOutputBuffer(/*more=*/false);
+}
+
+void ConnectionHandler::FlushOutputBuffer(bool more) {
+    if (is_closing_ || output_bf_.Size() == 0) return;
+    // TLS retry pending: OpenSSL needs the same buffer on the retry, which
+    // the read / EPOLLOUT path owns. Same rules as DoSendRaw.
+    if (tls_write_wants_read_) return;
+    if (tls_read_wants_write_ || tls_state_ == TlsState::HANDSHAKE) {
+        client_channel_->EnableWriteMode();
+        return;
+    }
+    // Earlier bytes are already waiting on EPOLLOUT — CallWriteCb will
+    // pick the corked bytes up behind them.
+    if (client_channel_->isEnableWriteMode()) return;
+
+    ssize_t written;
+    if (tls_state_ == TlsState::READY && !ktls_send_) {
+        size_t try_len = output_bf_.Size();
+        written = TlsWrite(output_bf_.Data(), try_len);
+        if (written == TlsConnection::TLS_COMPLETE) {
+            tls_pending_write_size_ = try_len;
+            client_channel_->EnableWriteMode();
+            return;
+        }
+        if (written == TlsConnection::TLS_CROSS_RW) {
+            tls_pending_write_size_ = try_len;
+            tls_write_wants_read_ = true;
+            client_channel_->EnableReadMode();
+            return;
+        }
+    } else {
+        int flags = SEND_FLAGS;
+#ifdef MSG_MORE
+        if (more) flags |= MSG_MORE;
+#else
+        (void)more;
+#endif
+        written = ::send(fd(), output_bf_.Data(), output_bf_.Size(), flags);
+    }
+    if (written > 0) {
+        output_bf_.Erase(0, written);
+        ts_ = TimeStamp::Now();
+        tls_pending_write_size_ = 0;
+        if (output_bf_.Size() == 0) {
+            if (callbacks_.complete_callback)
+                callbacks_.complete_callback(shared_from_this());
+            if (close_after_write_.load(std::memory_order_acquire)) {
+                ForceClose();
+            }
+            return;
+        }
+    } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        CallCloseCb();
+        return;
+    }
+    client_channel_->EnableWriteMode();
+}
+
 void ConnectionHandler::CloseAfterWrite(){
     close_after_write_.store(true, std::memory_order_release);
     // Always enqueue the buffer-check/close so it runs after any previously
@@ -924,11 +1016,18 @@ void ConnectionHandler::CallWriteCb(){
     // TLS handshake WANT_WRITE handling
     if (tls_state_ == TlsState::HANDSHAKE) {
         int result = tls_->DoHandshake();
+        SetTlsKeyOpWaiting(result == TlsConnection::TLS_WANT_ASYNC);
+        if (result == TlsConnection::TLS_WANT_ASYNC) {
+            return;  // see OnMessage
+        }
         if (result == TlsConnection::TLS_COMPLETE) {
             tls_state_ = TlsState::READY;
+            ktls_send_ = tls_->KtlsSendActive();
             tls_ready_from_write_ = true;  // signal OnMessage to fire callback
             if (tls_handshakes_counter_ != nullptr) {
-                tls_handshakes_counter_->Add(1.0, {{"outcome", "success"}});
+                tls_handshakes_counter_->Add(1.0, {
+                    {"outcome", "success"},
+                    {"mode", tls_->IsSessionReused() ? "resumed" : "full"}});
             }
             // Handshake complete — OpenSSL may have buffered application data.
             OnMessage();
@@ -967,10 +1066,10 @@ void ConnectionHandler::CallWriteCb(){
     if (tls_state_ == TlsState::HANDSHAKE) {
         // Don't write during handshake — data stays buffered until READY
         return;
-    } else if (tls_state_ == TlsState::READY) {
+    } else if (tls_state_ == TlsState::READY && !ktls_send_) {
         // Use pending size for retry, or full buffer for new write
         size_t write_len = tls_pending_write_size_ > 0 ? tls_pending_write_size_ : output_bf_.Size();
-        write_sz = tls_->Write(output_bf_.Data(), write_len);
+        write_sz = TlsWrite(output_bf_.Data(), write_len);
         if (write_sz == TlsConnection::TLS_COMPLETE) {
             tls_pending_write_size_ = write_len;  // Track for retry
             return;  // WANT_WRITE — try again on next EPOLLOUT
@@ -1071,6 +1170,46 @@ void ConnectionHandler::SetErrorCb(CALLBACKS_NAMESPACE::ConnErrorCallback fn){
 void ConnectionHandler::SetTlsConnection(std::unique_ptr<TlsConnection> tls) {
     tls_ = std::move(tls);
     tls_state_ = TlsState::HANDSHAKE;
+    // Offloaded key operations complete on a worker thread: hop back to
+    // this connection's dispatcher before touching the handshake.
+    tls_->SetAsyncResumeCallback(
+        [weak_self = weak_from_this(),
+         weak_dispatcher = std::weak_ptr<Dispatcher>(event_dispatcher_)]() {
+            auto dispatcher = weak_dispatcher.lock();
+            if (!dispatcher) return;
+            dispatcher->EnQueue([weak_self]() {
+                if (auto self = weak_self.lock()) {
+                    self->ResumeTlsHandshake();
+                }
+            });
+        });
+}
+
+void ConnectionHandler::ResumeTlsHandshake() {
+    if (is_closing_ || tls_state_ != TlsState::HANDSHAKE ||
+        (client_channel_ && client_channel_->is_channel_closed())) {
+        return;
+    }
+    OnMessage();
+}
+
+void ConnectionHandler::SetTlsKeyOpWaiting(bool waiting) {
+    if (waiting == tls_key_op_waiting_) return;
+    tls_key_op_waiting_ = waiting;
+    if (tls_key_ops_queued_counter_ != nullptr) {
+        tls_key_ops_queued_counter_->Add(waiting ? 1.0 : -1.0, {});
+    }
+}
+
+int ConnectionHandler::TlsWrite(const char* buf, size_t len) {
+    int written = tls_->Write(buf, len);
+    if (written > 0 && tls_records_counter_ != nullptr) {
+        const size_t limit = tls_->LastRecordLimit();
+        const size_t records = (static_cast<size_t>(written) + limit - 1) / limit;
+        tls_records_counter_->Add(static_cast<double>(records), {
+            {"size", limit < TlsContext::MAX_RECORD_SIZE ? "small" : "full"}});
+    }
+    return written;
 }
 
 void ConnectionHandler::EnableReadMode() {
@@ -1191,6 +1330,10 @@ std::string ConnectionHandler::GetAlpnProtocol() const {
     return "";
 }
 
+bool ConnectionHandler::IsTlsSessionReused() const {
+    return tls_ && tls_state_ == TlsState::READY && tls_->IsSessionReused();
+}
+
 void ConnectionHandler::SetDeadlineTimeoutCb(DeadlineTimeoutCb cb) {
     deadline_timeout_cb_ = std::move(cb);
     ++deadline_cb_generation_;
@@ -154,6 +154,11 @@ void Dispatcher::RunEventLoop(){
         // to meet their deadlines.
         int wait_timeout_ms = 1000;
         bool delayed_shortened = false;
+        // Loop-end work left over from the previous iteration (round cap
+        // hit in RunLoopEndTasks) must not wait for the next event.
+        if (!loop_end_tasks_.empty()) {
+            wait_timeout_ms = 0;
+        }
         {
             std::lock_guard<std::mutex> lck(mtx_);
             if (!delayed_tasks_.empty()) {
@@ -270,6 +275,10 @@ void Dispatcher::RunEventLoop(){
             }
         }
 
+        // Coalesced-output flushes (corked connections) run last, after
+        // everything else this iteration may have written.
+        RunLoopEndTasks();
+
       } catch (const std::exception& e) {
         // Catch exceptions from WaitForEvent, TimerHandler, or timeout callbacks
         // that escape the inner try/catch. Without this, the dispatcher thread dies
@@ -280,6 +289,10 @@ void Dispatcher::RunEventLoop(){
       }
     } // end of while(is_running())
 
+    // Release anything still corked before the shutdown drain decides
+    // which connections have empty output buffers.
+    RunLoopEndTasks();
+
     // Final drain: process all tasks enqueued during shutdown.
     // Loop because a task may EnQueue more work (e.g., close callback
     // triggers timer removal which enqueues to this dispatcher).
@@ -476,6 +489,38 @@ void Dispatcher::ProcessPendingTasks() {
             logging::Get()->error("Delayed task unknown error");
         }
     }
+    // The event loop is not iterating while a handler pumps tasks here,
+    // so loop-end work would otherwise never run.
+    RunLoopEndTasks();
+}
+
+bool Dispatcher::EnQueueAtLoopEnd(std::function<void()> fn) {
+    if (!is_on_loop_thread() || was_stopped_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    loop_end_tasks_.push_back(std::move(fn));
+    return true;
+}
+
+void Dispatcher::RunLoopEndTasks() {
+    // A loop-end task may schedule another (a flush that completes a write
+    // can produce more output). Bound the rounds so a pathological producer
+    // cannot starve the poller; leftovers run after a zero-timeout wait.
+    static constexpr int MAX_LOOP_END_ROUNDS = 8;
+    for (int round = 0; round < MAX_LOOP_END_ROUNDS && !loop_end_tasks_.empty();
+         ++round) {
+        std::vector<std::function<void()>> tasks;
+        tasks.swap(loop_end_tasks_);
+        for (auto& fn : tasks) {
+            try {
+                fn();
+            } catch (const std::exception& e) {
+                logging::Get()->error("Loop-end task error: {}", e.what());
+            } catch (...) {
+                logging::Get()->error("Loop-end task unknown error");
+            }
+        }
+    }
 }
 
 void Dispatcher::EnQueue(std::function<void()> fn){
@@ -328,6 +328,38 @@ InetAddr PickAddress(const struct addrinfo* ai, LookupFamily pref, int port) {
     return InetAddr::FromAddrInfo(chosen, port);
 }
 
+// Every distinct address in the chain, the family PickAddress would
+// choose first and the other one after it (unless *_only).
+std::vector<InetAddr> CollectAddresses(const struct addrinfo* ai,
+                                       LookupFamily pref, int port) {
+    const InetAddr first = PickAddress(ai, pref, port);
+    std::vector<InetAddr> out;
+    if (!first.is_valid()) return out;
+    const int first_family =
+        first.family() == InetAddr::Family::kIPv4 ? AF_INET : AF_INET6;
+    const bool single_family = pref == LookupFamily::kV4Only ||
+                               pref == LookupFamily::kV6Only;
+    for (int pass = 0; pass < (single_family ? 1 : 2); ++pass) {
+        for (const struct addrinfo* cur = ai; cur != nullptr;
+             cur = cur->ai_next) {
+            const bool wanted = pass == 0 ? cur->ai_family == first_family
+                                          : cur->ai_family != first_family;
+            if (!wanted ||
+                (cur->ai_family != AF_INET && cur->ai_family != AF_INET6)) {
+                continue;
+            }
+            InetAddr a = InetAddr::FromAddrInfo(cur, port);
+            if (!a.is_valid()) continue;
+            bool dup = false;
+            for (const auto& seen : out) {
+                if (seen.Ip() == a.Ip()) { dup = true; break; }
+            }
+            if (!dup) out.push_back(std::move(a));
+        }
+    }
+    return out;
+}
+
 }  // namespace
 
 // ---------------------------------------------------------------------------
@@ -919,7 +951,7 @@ ResolvedEndpoint DnsResolver::DoBlockingResolve(const ResolveRequest& req) {
         return out;
     }
 
-    InetAddr addr = PickAddress(res, req.family, req.port);
+    std::vector<InetAddr> addrs = CollectAddresses(res, req.family, req.port);
     ::freeaddrinfo(res);
 
     ResolvedEndpoint out;
@@ -927,13 +959,14 @@ ResolvedEndpoint DnsResolver::DoBlockingResolve(const ResolveRequest& req) {
     out.port = req.port;
     out.tag  = req.tag;
     out.resolved_at = std::chrono::steady_clock::now();
-    if (!addr.is_valid()) {
+    if (addrs.empty()) {
         out.error         = true;
         out.error_code    = EAI_NONAME;
         out.error_message = "no address matched requested family";
         return out;
     }
-    out.addr = addr;
+    out.addr  = addrs.front();
+    out.addrs = std::move(addrs);
     return out;
 }
 
@@ -967,7 +1000,8 @@ ResolvedEndpoint DnsResolver::MakeReadyLiteralResult(const ResolveRequest& req)
         out.error_message = "IPv4 literal rejected under v6_only";
         return out;
     }
-    out.addr = addr;
+    out.addr  = addr;
+    out.addrs = {addr};
     return out;
 }
 
@@ -0,0 +1,98 @@
+#include "http/early_hints.h"
+#include "http/http_status.h"
+
+namespace HTTP_EARLY_HINTS_NAMESPACE {
+
+namespace {
+
+bool HasUnsafeChar(const std::string& s, bool allow_angle) {
+    for (unsigned char c : s) {
+        if (c == '\r' || c == '\n' || c == '\0') return true;
+        if (!allow_angle && (c == '<' || c == '>' || c == '"')) return true;
+    }
+    return false;
+}
+
+bool IEquals(const std::string& a, const char* b) {
+    size_t n = std::strlen(b);
+    if (a.size() != n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::string FormatLinkValue(const PreloadLink& link) {
+    if (link.uri.empty() || link.rel.empty()) return {};
+    if (HasUnsafeChar(link.uri, false) || HasUnsafeChar(link.rel, false) ||
+        HasUnsafeChar(link.as, false) || HasUnsafeChar(link.type, false) ||
+        HasUnsafeChar(link.crossorigin, false)) {
+        return {};
+    }
+    std::string out;
+    out.reserve(link.uri.size() + 48);
+    out += '<';
+    out += link.uri;
+    out += ">; rel=";
+    out += link.rel;
+    if (!link.as.empty()) {
+        out += "; as=";
+        out += link.as;
+    }
+    if (!link.type.empty()) {
+        out += "; type=\"";
+        out += link.type;
+        out += '"';
+    }
+    if (!link.crossorigin.empty()) {
+        if (link.crossorigin == "anonymous") {
+            out += "; crossorigin";
+        } else {
+            out += "; crossorigin=";
+            out += link.crossorigin;
+        }
+    }
+    return out;
+}
+
+bool IsValidLinkValue(const std::string& value) {
+    if (value.size() < 3 || value.size() > MAX_LINK_VALUE_LENGTH) return false;
+    if (value.front() != '<') return false;
+    size_t close = value.find('>');
+    if (close == std::string::npos || close == 1) return false;
+    return !HasUnsafeChar(value, true);
+}
+
+std::vector<std::pair<std::string, std::string>> BuildHeaders(
+        const std::vector<std::string>& link_values) {
+    std::vector<std::pair<std::string, std::string>> headers;
+    headers.reserve(link_values.size());
+    for (const auto& v : link_values) {
+        if (IsValidLinkValue(v)) headers.emplace_back("Link", v);
+    }
+    return headers;
+}
+
+std::vector<std::pair<std::string, std::string>> FilterRelayableHeaders(
+        const std::vector<std::pair<std::string, std::string>>& upstream_headers) {
+    std::vector<std::pair<std::string, std::string>> out;
+    for (const auto& [name, value] : upstream_headers) {
+        if (IEquals(name, "link") && IsValidLinkValue(value)) {
+            out.emplace_back("Link", value);
+        }
+    }
+    return out;
+}
+
+bool Send(const HTTP_CALLBACKS_NAMESPACE::InterimResponseSender& send_interim,
+          const std::vector<std::string>& link_values) {
+    if (!send_interim || link_values.empty()) return false;
+    auto headers = BuildHeaders(link_values);
+    if (headers.empty()) return false;
+    send_interim(HttpStatus::EARLY_HINTS, headers);
+    return true;
+}
+
+}  // namespace HTTP_EARLY_HINTS_NAMESPACE
@@ -0,0 +1,173 @@
+#include "upstream/grpc.h"
+
+namespace GRPC_NAMESPACE {
+
+namespace {
+
+// Index == status code.
+constexpr const char* kStatusNames[MAX_STATUS_CODE + 1] = {
+    "ok",
+    "cancelled",
+    "unknown",
+    "invalid-argument",
+    "deadline-exceeded",
+    "not-found",
+    "already-exists",
+    "permission-denied",
+    "resource-exhausted",
+    "failed-precondition",
+    "aborted",
+    "out-of-range",
+    "unimplemented",
+    "internal",
+    "unavailable",
+    "data-loss",
+    "unauthenticated",
+};
+
+char AsciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+bool IEquals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (AsciiLower(a[i]) != b[i]) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int ParseStatusName(const std::string& name) {
+    for (int code = 0; code <= MAX_STATUS_CODE; ++code) {
+        if (name == kStatusNames[code]) return code;
+    }
+    return -1;
+}
+
+const char* StatusName(int code) {
+    if (code < 0 || code > MAX_STATUS_CODE) return "";
+    return kStatusNames[code];
+}
+
+StatusSet MakeStatusSet(const std::vector<std::string>& names) {
+    StatusSet set = 0;
+    for (const auto& n : names) {
+        int code = ParseStatusName(n);
+        if (code >= 0) set |= (1u << code);
+    }
+    return set;
+}
+
+bool IsGrpcContentType(const std::string& content_type) {
+    static constexpr std::string_view kType = "application/grpc";
+    if (content_type.size() < kType.size()) return false;
+    if (!IEquals(std::string_view(content_type).substr(0, kType.size()), kType)) {
+        return false;
+    }
+    if (content_type.size() == kType.size()) return true;
+    char next = content_type[kType.size()];
+    return next == '+' || next == ';';
+}
+
+std::optional<int64_t> ParseTimeoutMs(std::string_view value) {
+    // 1..8 digits followed by exactly one unit character.
+    if (value.size() < 2 || value.size() > 9) return std::nullopt;
+    int64_t n = 0;
+    for (size_t i = 0; i + 1 < value.size(); ++i) {
+        char c = value[i];
+        if (c < '0' || c > '9') return std::nullopt;
+        n = n * 10 + (c - '0');
+    }
+    switch (value.back()) {
+        case 'H': return n * 3600 * 1000;
+        case 'M': return n * 60 * 1000;
+        case 'S': return n * 1000;
+        case 'm': return n;
+        case 'u': return (n + 999) / 1000;
+        case 'n': return (n + 999999) / 1000000;
+        default:  return std::nullopt;
+    }
+}
+
+std::string FormatTimeout(int64_t ms) {
+    static constexpr int64_t kMaxDigits = 99999999;
+    if (ms < 0) ms = 0;
+    if (ms <= kMaxDigits) return std::to_string(ms) + "m";
+    int64_t sec = (ms + 999) / 1000;
+    if (sec <= kMaxDigits) return std::to_string(sec) + "S";
+    int64_t min = (sec + 59) / 60;
+    if (min <= kMaxDigits) return std::to_string(min) + "M";
+    int64_t hours = (min + 59) / 60;
+    if (hours > kMaxDigits) hours = kMaxDigits;
+    return std::to_string(hours) + "H";
+}
+
+std::optional<int> ParseStatus(std::string_view value) {
+    if (value.empty() || value.size() > 9) return std::nullopt;
+    int code = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') return std::nullopt;
+        code = code * 10 + (c - '0');
+    }
+    return code;
+}
+
+std::optional<int> FindStatus(
+        const std::vector<std::pair<std::string, std::string>>& fields) {
+    for (const auto& [name, value] : fields) {
+        if (IEquals(name, "grpc-status")) return ParseStatus(value);
+    }
+    return std::nullopt;
+}
+
+bool SplitMethodPath(const std::string& path,
+                     std::string& service, std::string& method) {
+    if (path.size() < 4 || path[0] != '/') return false;
+    size_t slash = path.find('/', 1);
+    if (slash == std::string::npos || slash == 1 ||
+        slash + 1 >= path.size() ||
+        path.find('/', slash + 1) != std::string::npos) {
+        return false;
+    }
+    service = path.substr(1, slash - 1);
+    method = path.substr(slash + 1);
+    return true;
+}
+
+MessageFramer::Result MessageFramer::Feed(const char* data, size_t len) {
+    if (error_ != Result::OK) return error_;
+    size_t pos = 0;
+    while (pos < len) {
+        if (remaining_ > 0) {
+            size_t take = static_cast<size_t>(
+                std::min<uint64_t>(remaining_, len - pos));
+            remaining_ -= take;
+            pos += take;
+            if (remaining_ == 0) ++messages_;
+            continue;
+        }
+        prefix_[prefix_have_++] = static_cast<uint8_t>(data[pos++]);
+        if (prefix_have_ < sizeof(prefix_)) continue;
+
+        prefix_have_ = 0;
+        if (prefix_[0] > 1) {
+            error_ = Result::BAD_FLAG;
+            return error_;
+        }
+        uint32_t length = (static_cast<uint32_t>(prefix_[1]) << 24) |
+                          (static_cast<uint32_t>(prefix_[2]) << 16) |
+                          (static_cast<uint32_t>(prefix_[3]) << 8) |
+                          static_cast<uint32_t>(prefix_[4]);
+        if (max_message_bytes_ > 0 && length > max_message_bytes_) {
+            error_ = Result::OVERSIZE;
+            return error_;
+        }
+        remaining_ = length;
+        if (remaining_ == 0) ++messages_;
+    }
+    return Result::OK;
+}
+
+}  // namespace GRPC_NAMESPACE
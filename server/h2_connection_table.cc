@@ -28,6 +28,16 @@ size_t H2ConnectionTable::TotalConnections() const {
     return total;
 }
 
+size_t H2ConnectionTable::TotalActiveStreams() const {
+    size_t total = 0;
+    for (const auto& [_, conns] : by_upstream_) {
+        for (const auto& c : conns) {
+            if (c) total += c->active_stream_count();
+        }
+    }
+    return total;
+}
+
 size_t H2ConnectionTable::ConnectionsForUpstream(
     const std::string& upstream_name) const
 {
@@ -0,0 +1,297 @@
+#include "upstream/health_checker.h"
+#include "upstream/pool_partition.h"
+#include "upstream/upstream_connection.h"
+#include "upstream/http_request_serializer.h"
+#include "connection_handler.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+
+namespace {
+
+// Health responses are status-only; anything larger is a misconfigured
+// path (or a hostile backend) and closes the connection at the cap.
+constexpr size_t MAX_HEALTH_RESPONSE_BYTES = 64 * 1024;
+
+const char* CheckoutFailureReason(int code) noexcept {
+    switch (code) {
+        case PoolPartition::CHECKOUT_CONNECT_FAILED:  return "connect_failed";
+        case PoolPartition::CHECKOUT_CONNECT_TIMEOUT: return "connect_timeout";
+        default:                                       return nullptr;
+    }
+}
+
+}  // namespace
+
+// One in-flight check. Held by the checker between CheckoutAsync and
+// the verdict; every callback reaches it through a weak_ptr, so a late
+// checkout or transport callback after the verdict is a no-op.
+struct HealthChecker::Probe {
+    std::shared_ptr<std::atomic<bool>> cancel =
+        std::make_shared<std::atomic<bool>>(false);
+    UpstreamLease lease;
+    UpstreamHttpCodec codec;
+    bool finished = false;
+    // The connection's HTTP stream is in an unknown state (timeout, parse
+    // error, close-delimited response): destroy it instead of pooling it.
+    bool poison = false;
+};
+
+HealthChecker::HealthChecker(PoolPartition* partition,
+                             std::string endpoint_label,
+                             const UpstreamHealthCheckConfig& config,
+                             std::string host_header,
+                             uint64_t seed,
+                             TransitionCallback on_transition)
+    : partition_(partition),
+      partition_alive_(partition->alive_token()),
+      dispatcher_(partition->dispatcher_ptr()),
+      service_name_(partition->service_name()),
+      endpoint_label_(std::move(endpoint_label)),
+      config_(config),
+      on_transition_(std::move(on_transition)),
+      rng_((seed * 0x9e3779b97f4a7c15ULL) | 1)
+{
+    if (config_.type == "http") {
+        std::map<std::string, std::string> headers;
+        headers["host"] = config_.host.empty() ? host_header : config_.host;
+        headers["user-agent"] = "reactor-health-check";
+        request_ = HttpRequestSerializer::Serialize(
+            "GET", config_.path, "", headers, "");
+    }
+}
+
+HealthChecker::~HealthChecker() = default;
+
+void HealthChecker::Start() {
+    const auto interval = std::max(config_.interval_ms, 1);
+    ScheduleCheck(std::chrono::milliseconds(
+        NextRandom() % static_cast<uint64_t>(interval)));
+}
+
+void HealthChecker::Stop() {
+    stopped_.store(true, std::memory_order_release);
+}
+
+bool HealthChecker::PartitionUsable() const {
+    return partition_alive_ &&
+           partition_alive_->load(std::memory_order_acquire) &&
+           !partition_->IsShuttingDown();
+}
+
+uint64_t HealthChecker::NextRandom() {
+    // xorshift64*; the state is seeded odd in the ctor.
+    rng_ ^= rng_ >> 12;
+    rng_ ^= rng_ << 25;
+    rng_ ^= rng_ >> 27;
+    return rng_ * 0x2545f4914f6cdd1dULL;
+}
+
+std::chrono::milliseconds HealthChecker::NextInterval() {
+    // interval * (1 ± jitter_percent%), uniform.
+    const int64_t interval = config_.interval_ms;
+    const int64_t spread = interval * config_.jitter_percent / 100;
+    if (spread == 0) return std::chrono::milliseconds(interval);
+    const uint64_t span = static_cast<uint64_t>(2 * spread + 1);
+    const int64_t offset = static_cast<int64_t>(NextRandom() % span) - spread;
+    return std::chrono::milliseconds(std::max<int64_t>(1, interval + offset));
+}
+
+void HealthChecker::ScheduleCheck(std::chrono::milliseconds delay) {
+    if (stopped_.load(std::memory_order_acquire)) return;
+    std::weak_ptr<HealthChecker> weak = weak_from_this();
+    // A false return means the dispatcher stopped; checks end with it.
+    dispatcher_->EnQueueDelayed([weak]() {
+        auto self = weak.lock();
+        if (!self || self->stopped_.load(std::memory_order_acquire)) return;
+        self->RunCheck();
+    }, delay);
+}
+
+void HealthChecker::RunCheck() {
+    // A shutting-down partition ends the cycle: no reschedule.
+    if (!PartitionUsable()) return;
+
+    auto probe = std::make_shared<Probe>();
+    probe_ = probe;
+    if (config_.type == "http") probe->codec.SetRequestMethod("GET");
+
+    std::weak_ptr<HealthChecker> weak = weak_from_this();
+    std::weak_ptr<Probe> weak_probe = probe;
+
+    // Whole-check budget: checkout (queue + connect) plus the response.
+    // Cancelling the token drops a still-queued checkout; a connect that
+    // completes later hands its lease to a dead probe and goes back to
+    // the pool untouched.
+    dispatcher_->EnQueueDelayed([weak, weak_probe]() {
+        auto self = weak.lock();
+        auto p = weak_probe.lock();
+        if (!self || !p || p->finished) return;
+        p->cancel->store(true, std::memory_order_release);
+        p->poison = true;
+        self->FinishCheck(p, Outcome::FAIL, "timeout");
+    }, std::chrono::milliseconds(config_.timeout_ms));
+
+    partition_->CheckoutAsync(
+        [weak, weak_probe](UpstreamLease lease) {
+            auto self = weak.lock();
+            auto p = weak_probe.lock();
+            if (!self || !p || p->finished) return;
+            self->OnLease(p, std::move(lease));
+        },
+        [weak, weak_probe](int code) {
+            auto self = weak.lock();
+            auto p = weak_probe.lock();
+            if (!self || !p || p->finished) return;
+            // Only connect failures say something about the backend.
+            // Exhaustion, queue limits, shutdown and an open breaker are
+            // local conditions: the check is skipped.
+            const char* reason = CheckoutFailureReason(code);
+            if (reason) {
+                self->FinishCheck(p, Outcome::FAIL, reason);
+            } else {
+                self->FinishCheck(p, Outcome::SKIPPED, "checkout_unavailable");
+            }
+        },
+        probe->cancel);
+}
+
+void HealthChecker::OnLease(const std::shared_ptr<Probe>& probe,
+                            UpstreamLease lease) {
+    probe->lease = std::move(lease);
+    auto* conn = probe->lease.Get();
+    // No H1 connection: the pool answered from a live HTTP/2 session.
+    // That proves the endpoint is reachable; it is the best an HTTP
+    // check can do without opening a stream of its own.
+    if (!conn) {
+        FinishCheck(probe, Outcome::PASS, "h2_session");
+        return;
+    }
+    auto transport = conn->GetTransport();
+    if (!transport) {
+        FinishCheck(probe, Outcome::FAIL, "missing_transport");
+        return;
+    }
+    if (config_.type == "tcp" || transport->GetAlpnProtocol() == "h2") {
+        FinishCheck(probe, Outcome::PASS, "connected");
+        return;
+    }
+
+    std::weak_ptr<HealthChecker> weak = weak_from_this();
+    std::weak_ptr<Probe> weak_probe = probe;
+    transport->SetMaxInputSize(MAX_HEALTH_RESPONSE_BYTES);
+    transport->SetOnMessageCb(
+        [weak, weak_probe](std::shared_ptr<ConnectionHandler> /*conn*/,
+                           std::string& data) {
+            auto self = weak.lock();
+            auto p = weak_probe.lock();
+            if (!self || !p || p->finished) return;
+            self->OnResponseData(p, data);
+        });
+    transport->SetCompletionCb(
+        [](std::shared_ptr<ConnectionHandler> /*conn*/) {});
+    transport->SendRaw(request_.data(), request_.size());
+}
+
+void HealthChecker::OnResponseData(const std::shared_ptr<Probe>& probe,
+                                   std::string& data) {
+    auto& codec = probe->codec;
+    if (data.empty()) {
+        // Upstream EOF (PoolPartition's on-close hook). Completes a
+        // close-delimited response; anything else is a failed check.
+        codec.Finish();
+        probe->poison = true;
+        if (!codec.GetResponse().complete) {
+            FinishCheck(probe, Outcome::FAIL, "upstream_disconnect");
+            return;
+        }
+    } else {
+        size_t consumed = codec.Parse(data.data(), data.size());
+        if (codec.HasError()) {
+            probe->poison = true;
+            FinishCheck(probe, Outcome::FAIL, "parse_error");
+            return;
+        }
+        if (consumed > 0 && consumed <= data.size()) {
+            data.erase(0, consumed);
+        }
+        if (!codec.GetResponse().complete) return;
+    }
+
+    const auto& resp = codec.GetResponse();
+    if (!resp.keep_alive) probe->poison = true;
+    if (resp.status_code >= config_.expected_status_min &&
+        resp.status_code <= config_.expected_status_max) {
+        FinishCheck(probe, Outcome::PASS, "status");
+    } else {
+        FinishCheck(probe, Outcome::FAIL,
+                    "status_" + std::to_string(resp.status_code));
+    }
+}
+
+void HealthChecker::FinishCheck(const std::shared_ptr<Probe>& probe,
+                                Outcome outcome,
+                                const std::string& reason) {
+    if (probe->finished) return;
+    probe->finished = true;
+    if (probe_ == probe) probe_.reset();
+
+    // The lease (if any) goes back before the verdict runs callbacks.
+    // A dead partition means the connection is gone with it: skip the
+    // transport entirely and let the lease's alive gate drop it.
+    if (probe->lease.Get() &&
+        partition_alive_->load(std::memory_order_acquire)) {
+        auto* conn = probe->lease.Get();
+        if (auto transport = conn->GetTransport()) {
+            transport->SetOnMessageCb(nullptr);
+            transport->SetCompletionCb(nullptr);
+            transport->SetMaxInputSize(0);
+        }
+        if (probe->poison) conn->MarkClosing();
+    }
+    probe->lease.Release();
+
+    if (stopped_.load(std::memory_order_acquire)) return;
+    Record(outcome, reason);
+    ScheduleCheck(NextInterval());
+}
+
+void HealthChecker::Record(Outcome outcome, const std::string& reason) {
+    if (outcome == Outcome::SKIPPED) return;
+    const bool passed = outcome == Outcome::PASS;
+    if (passed) {
+        checks_passed_.fetch_add(1, std::memory_order_relaxed);
+        consecutive_failures_ = 0;
+        ++consecutive_passes_;
+    } else {
+        checks_failed_.fetch_add(1, std::memory_order_relaxed);
+        consecutive_passes_ = 0;
+        ++consecutive_failures_;
+        logging::Get()->debug(
+            "Health check failed upstream={} endpoint={} reason={}",
+            service_name_, endpoint_label_, reason);
+    }
+    partition_->EmitHealthCheck(passed ? "success" : "failure");
+
+    bool flip = false;
+    if (healthy_ && !passed &&
+        consecutive_failures_ >= config_.unhealthy_threshold) {
+        flip = true;
+    } else if (!healthy_ && passed &&
+               consecutive_passes_ >= config_.healthy_threshold) {
+        flip = true;
+    }
+    if (!flip) return;
+    healthy_ = passed;
+    if (healthy_) {
+        logging::Get()->info(
+            "Upstream endpoint healthy upstream={} endpoint={} after {} passes",
+            service_name_, endpoint_label_, consecutive_passes_);
+    } else {
+        logging::Get()->warn(
+            "Upstream endpoint unhealthy upstream={} endpoint={} reason={} "
+            "after {} failures",
+            service_name_, endpoint_label_, reason, consecutive_failures_);
+    }
+    partition_->EmitHealthTransition(endpoint_label_, healthy_);
+    if (on_transition_) on_transition_(healthy_, reason);
+}
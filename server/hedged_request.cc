@@ -0,0 +1,247 @@
+#include "upstream/hedged_request.h"
+#include "circuit_breaker/retry_budget.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+#include "observability/counter.h"
+#include "observability/metrics_catalog.h"
+#include "observability/observability_manager.h"
+#include "observability/observability_snapshot.h"
+
+#include <algorithm>
+
+// --- HedgePolicy ---
+
+HedgePolicy::HedgePolicy(const ProxyHedgeConfig& config) : config_(config) {
+    if (config_.percentile > 0) samples_us_.reserve(SAMPLE_COUNT);
+}
+
+bool HedgePolicy::Eligible(const HttpRequest& request) {
+    if (request.method != "GET" && request.method != "HEAD" &&
+        request.method != "OPTIONS") {
+        return false;
+    }
+    // Proxy routes stream request bodies, so body_stream is set even
+    // for a bodiless GET; the framing headers tell whether one follows.
+    const auto& headers = request.headers;
+    auto cl = headers.find("content-length");
+    return request.body.empty() && !headers.count("transfer-encoding") &&
+           (cl == headers.end() || cl->second == "0");
+}
+
+std::chrono::milliseconds HedgePolicy::Delay() const {
+    if (config_.percentile > 0) {
+        int64_t ms = percentile_delay_ms_.load(std::memory_order_relaxed);
+        if (ms >= 0) return std::chrono::milliseconds(std::max<int64_t>(ms, 1));
+    }
+    return std::chrono::milliseconds(config_.delay_ms);
+}
+
+void HedgePolicy::RecordLatency(std::chrono::steady_clock::duration latency) {
+    if (config_.percentile <= 0) return;
+    const int64_t us =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (samples_us_.size() < SAMPLE_COUNT) {
+        samples_us_.push_back(us);
+    } else {
+        samples_us_[next_] = us;
+    }
+    next_ = (next_ + 1) % SAMPLE_COUNT;
+    ++recorded_;
+    if (recorded_ < MIN_SAMPLES || recorded_ % RECOMPUTE_EVERY != 0) return;
+
+    std::vector<int64_t> sorted = samples_us_;
+    size_t rank = sorted.size() * static_cast<size_t>(config_.percentile) / 100;
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    // Round up: a hedge fired just before the percentile is wasted.
+    percentile_delay_ms_.store((sorted[rank] + 999) / 1000,
+                               std::memory_order_relaxed);
+}
+
+// --- HedgedRequest ---
+
+// The sender one attempt reports through. Before the race is decided
+// the first response head claims it; afterwards only the winner reaches
+// the client and the loser sees a closed stream.
+class HedgedRequest::AttemptSender : public StreamingSender::Impl {
+public:
+    AttemptSender(std::shared_ptr<HedgedRequest> race, int attempt)
+        : race_(std::move(race)), attempt_(attempt) {}
+
+    int SendHeaders(const HttpResponse& response) override {
+        if (!race_->Claim(attempt_)) return -1;
+        return race_->client_sender_.SendHeaders(response);
+    }
+    StreamingSender::SendResult SendData(const char* data, size_t len) override {
+        if (race_->winner_ != attempt_) return StreamingSender::SendResult::CLOSED;
+        return race_->client_sender_.SendData(data, len);
+    }
+    StreamingSender::SendResult End(
+        const std::vector<std::pair<std::string, std::string>>& trailers) override {
+        if (race_->winner_ != attempt_) return StreamingSender::SendResult::CLOSED;
+        return race_->client_sender_.End(trailers);
+    }
+    void Abort(StreamingSender::AbortReason reason) override {
+        if (race_->winner_ == attempt_) {
+            race_->client_sender_.Abort(reason);
+        } else if (race_->winner_ < 0) {
+            race_->OnAttemptFailed(attempt_, reason);
+        }
+    }
+    void SetDrainListener(StreamingSender::DrainListener listener) override {
+        // A loser clearing its listener must not clear the winner's.
+        if (race_->winner_ == attempt_) {
+            race_->client_sender_.SetDrainListener(std::move(listener));
+        }
+    }
+    void ConfigureWatermarks(size_t high_water_bytes) override {
+        race_->client_sender_.ConfigureWatermarks(high_water_bytes);
+    }
+    Dispatcher* GetDispatcher() override { return race_->dispatcher_; }
+
+private:
+    std::shared_ptr<HedgedRequest> race_;
+    int attempt_;
+};
+
+HedgedRequest::HedgedRequest(std::string service,
+                             std::shared_ptr<HedgePolicy> policy,
+                             Dispatcher* dispatcher,
+                             CIRCUIT_BREAKER_NAMESPACE::RetryBudget* budget,
+                             StreamingSender client_sender,
+                             Completion client_complete)
+    : service_(std::move(service)),
+      policy_(std::move(policy)),
+      dispatcher_(dispatcher),
+      budget_(budget),
+      client_sender_(std::move(client_sender)),
+      client_complete_(std::move(client_complete)) {}
+
+HedgedRequest::~HedgedRequest() {
+    ReleaseBudget();
+}
+
+void HedgedRequest::Start(const HttpRequest& request, Launch launch) {
+    started_at_ = std::chrono::steady_clock::now();
+    if (request.obs_snapshot) obs_manager_ = request.obs_snapshot->manager;
+    launch_ = std::move(launch);
+    running_[PRIMARY] = true;
+    cancel_[PRIMARY] = launch_(AttemptSenderFor(PRIMARY), CompletionFor(PRIMARY),
+                               /*primary=*/true);
+    if (winner_ >= 0) {
+        launch_ = nullptr;
+        return;
+    }
+
+    std::weak_ptr<HedgedRequest> weak_self = weak_from_this();
+    if (request.async_cancel_slot) {
+        *request.async_cancel_slot = [weak_self]() {
+            if (auto self = weak_self.lock()) self->CancelAll();
+        };
+    }
+    if (!dispatcher_->EnQueueDelayed(
+            [weak_self]() {
+                if (auto self = weak_self.lock()) self->FireHedge();
+            },
+            policy_->Delay())) {
+        launch_ = nullptr;
+    }
+}
+
+void HedgedRequest::FireHedge() {
+    if (winner_ >= 0 || cancelled_ || !launch_ || !running_[PRIMARY]) return;
+    auto launch = std::move(launch_);
+    launch_ = nullptr;
+    // A hedge is extra upstream load exactly like a retry: it must not
+    // amplify an overload the retry budget is already holding back.
+    if (budget_ && !budget_->TryConsumeRetry()) {
+        Record("rejected");
+        logging::Get()->debug("Hedge skipped, retry budget exhausted service={}",
+                              service_);
+        return;
+    }
+    budget_held_ = budget_ != nullptr;
+    hedged_ = true;
+    running_[HEDGE] = true;
+    logging::Get()->debug("Hedging slow request service={}", service_);
+    cancel_[HEDGE] = launch(AttemptSenderFor(HEDGE), CompletionFor(HEDGE),
+                            /*primary=*/false);
+    if (!cancel_[HEDGE] && winner_ < 0) {
+        running_[HEDGE] = false;
+        ReleaseBudget();
+    }
+}
+
+bool HedgedRequest::Claim(int attempt) {
+    if (winner_ >= 0) return winner_ == attempt;
+    if (cancelled_) return false;
+    winner_ = attempt;
+    launch_ = nullptr;
+    policy_->RecordLatency(std::chrono::steady_clock::now() - started_at_);
+    const int other = 1 - attempt;
+    if (running_[other] && cancel_[other]) {
+        // Not inline: the winner's transaction is mid-callback.
+        dispatcher_->EnQueue(std::move(cancel_[other]));
+        cancel_[other] = nullptr;
+    }
+    running_[other] = false;
+    ReleaseBudget();
+    if (hedged_) Record(attempt == HEDGE ? "won" : "lost");
+    return true;
+}
+
+void HedgedRequest::OnAttemptFailed(int attempt,
+                                    StreamingSender::AbortReason reason) {
+    running_[attempt] = false;
+    cancel_[attempt] = nullptr;
+    if (running_[1 - attempt]) return;
+    if (attempt == PRIMARY && launch_) {
+        // Failed before the hedge was due: nothing left to race.
+        launch_ = nullptr;
+    }
+    if (!Claim(attempt)) return;
+    client_sender_.Abort(reason);
+}
+
+void HedgedRequest::CancelAll() {
+    cancelled_ = true;
+    launch_ = nullptr;
+    for (int i = PRIMARY; i <= HEDGE; ++i) {
+        auto cancel = std::move(cancel_[i]);
+        cancel_[i] = nullptr;
+        running_[i] = false;
+        if (cancel) cancel();
+    }
+    ReleaseBudget();
+}
+
+void HedgedRequest::ReleaseBudget() {
+    if (!budget_held_) return;
+    budget_held_ = false;
+    budget_->ReleaseRetry();
+}
+
+void HedgedRequest::Record(const char* result) {
+    auto mgr = obs_manager_.lock();
+    if (!mgr) return;
+    const auto& cat = mgr->catalog();
+    if (cat.reactor_proxy_hedges != nullptr) {
+        cat.reactor_proxy_hedges->Add(
+            1.0, {{"reactor.upstream.service", service_}, {"result", result}});
+    }
+}
+
+HedgedRequest::StreamingSender HedgedRequest::AttemptSenderFor(int attempt) {
+    return StreamingSender(
+        std::make_shared<AttemptSender>(shared_from_this(), attempt));
+}
+
+HedgedRequest::Completion HedgedRequest::CompletionFor(int attempt) {
+    auto self = shared_from_this();
+    return [self, attempt](HttpResponse response) {
+        if (self->Claim(attempt)) self->client_complete_(std::move(response));
+    };
+}
@@ -167,10 +167,15 @@ static int OnBeginHeadersCallback(
     return 0;
 }
 
+// Receives each field as a pair of nghttp2_rcbuf. The views below point
+// into session-owned memory (the HPACK static table for well-known names,
+// the decoder's buffers otherwise) and stay valid for the duration of the
+// callback, so nothing is copied until Http2Stream::AddHeader stores the
+// field in HttpRequest — one copy per name and value instead of the three
+// or four temporaries a std::string-based path costs.
 static int OnHeaderCallback(
     nghttp2_session* session, const nghttp2_frame* frame,
-    const uint8_t* name, size_t namelen,
-    const uint8_t* value, size_t valuelen,
+    nghttp2_rcbuf* name_buf, nghttp2_rcbuf* value_buf,
     uint8_t /*flags*/, void* user_data) {
 
     auto* self = static_cast<Http2Session*>(user_data);
@@ -191,8 +196,12 @@ static int OnHeaderCallback(
         return 0;
     }
 
-    std::string hdr_name(reinterpret_cast<const char*>(name), namelen);
-    std::string hdr_value(reinterpret_cast<const char*>(value), valuelen);
+    nghttp2_vec name_vec = nghttp2_rcbuf_get_buf(name_buf);
+    nghttp2_vec value_vec = nghttp2_rcbuf_get_buf(value_buf);
+    std::string_view hdr_name(reinterpret_cast<const char*>(name_vec.base),
+                              name_vec.len);
+    std::string_view hdr_value(reinterpret_cast<const char*>(value_vec.base),
+                               value_vec.len);
 
     // Helper: mark stream rejected, submit RST_STREAM(PROTOCOL_ERROR), return 0.
     // We use explicit RST + return 0 instead of NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE
@@ -239,7 +248,7 @@ static int OnHeaderCallback(
     // Enforce max_header_list_size on ALL header frames (request + trailers).
     // RFC 7541 Section 4.1: entry size = name + value + 32.
     // nghttp2 advertises this in SETTINGS but does NOT enforce it on the receive side.
-    stream->AddHeaderBytes(namelen, valuelen);
+    stream->AddHeaderBytes(hdr_name.size(), hdr_value.size());
     if (self->MaxHeaderListSize() > 0 &&
         stream->AccumulatedHeaderSize() > self->MaxHeaderListSize()) {
         logging::Get()->warn("HTTP/2 stream {} header list size ({}) exceeds limit ({})",
@@ -283,17 +292,24 @@ static int OnHeaderCallback(
         // discarded after classification.
         if (stream->route_mode() == http::RouteRequestMode::Streaming) {
             stream->pending_trailers().emplace_back(
-                std::move(result.lower_name), hdr_value);
+                std::move(result.lower_name), std::string(hdr_value));
         }
         return 0;
     }
 
     // --- Request headers below ---
 
+    // Names from nghttp2 are lowercase (HTTP messaging validation rejects
+    // anything else before this callback), so classification works on the
+    // raw bytes.
+    using HeaderToken = Http2Stream::HeaderToken;
+    HeaderToken token = Http2Stream::ClassifyHeaderName(hdr_name);
+
     // Validate forbidden HTTP/2 connection-level headers (RFC 9113 Section 8.2.2)
-    if (hdr_name == "connection" || hdr_name == "keep-alive" ||
-        hdr_name == "proxy-connection" || hdr_name == "transfer-encoding" ||
-        hdr_name == "upgrade") {
+    if (token == HeaderToken::CONNECTION || token == HeaderToken::KEEP_ALIVE ||
+        token == HeaderToken::PROXY_CONNECTION ||
+        token == HeaderToken::TRANSFER_ENCODING ||
+        token == HeaderToken::UPGRADE) {
         logging::Get()->warn("HTTP/2 stream {} received forbidden header: {}",
                              frame->hd.stream_id, hdr_name);
         return reject_protocol_error();
@@ -301,23 +317,27 @@ static int OnHeaderCallback(
 
     // TE header: only "trailers" is allowed in HTTP/2 (RFC 9113 Section 8.2.2).
     // Trim OWS (RFC 9110 Section 5.5) and compare case-insensitively.
-    if (hdr_name == "te") {
-        std::string te_lower = hdr_value;
-        // Trim leading/trailing whitespace (OWS = SP / HTAB)
-        size_t start = te_lower.find_first_not_of(" \t");
-        size_t end = te_lower.find_last_not_of(" \t");
-        if (start != std::string::npos) {
-            te_lower = te_lower.substr(start, end - start + 1);
-        }
-        std::transform(te_lower.begin(), te_lower.end(), te_lower.begin(), [](unsigned char c){ return std::tolower(c); });
-        if (te_lower != "trailers") {
+    if (token == HeaderToken::TE) {
+        std::string_view te = hdr_value;
+        size_t start = te.find_first_not_of(" \t");
+        size_t end = te.find_last_not_of(" \t");
+        te = (start == std::string_view::npos)
+                 ? std::string_view()
+                 : te.substr(start, end - start + 1);
+        static constexpr std::string_view kTrailers = "trailers";
+        bool ok = te.size() == kTrailers.size() &&
+            std::equal(te.begin(), te.end(), kTrailers.begin(),
+                       [](char a, char b) {
+                           return std::tolower(static_cast<unsigned char>(a)) == b;
+                       });
+        if (!ok) {
             logging::Get()->warn("HTTP/2 stream {} received invalid TE value: {}",
                                  frame->hd.stream_id, hdr_value);
             return reject_protocol_error();
         }
     }
 
-    int add_rv = stream->AddHeader(hdr_name, hdr_value);
+    int add_rv = stream->AddHeader(token, hdr_name, hdr_value);
     if (add_rv != 0) {
         logging::Get()->warn("HTTP/2 stream {} invalid header value for: {}",
                              frame->hd.stream_id, hdr_name);
@@ -1057,7 +1077,7 @@ Http2Session::Http2Session(std::shared_ptr<ConnectionHandler> conn,
     }
     nghttp2_session_callbacks_set_on_begin_headers_callback(
         impl_->callbacks, OnBeginHeadersCallback);
-    nghttp2_session_callbacks_set_on_header_callback(
+    nghttp2_session_callbacks_set_on_header_callback2(
         impl_->callbacks, OnHeaderCallback);
     nghttp2_session_callbacks_set_on_data_chunk_recv_callback(
         impl_->callbacks, OnDataChunkRecvCallback);
@@ -1198,6 +1218,9 @@ bool Http2Session::SendPendingFrames() {
             break;
         }
 
+        if (!sent_any && settings_.write_batching) {
+            conn_->CorkUntilLoopEnd();
+        }
         conn_->SendRaw(reinterpret_cast<const char*>(data),
                         static_cast<size_t>(len));
         sent_any = true;
@@ -2,6 +2,7 @@
 #include "log/logger.h"
 #include <nghttp2/nghttp2.h>
 #include <algorithm>
+#include <charconv>
 
 // Returns the default port for a given HTTP(S) scheme. Empty string if
 // scheme is unknown (caller falls back to strict exact-match).
@@ -104,7 +105,73 @@ ssize_t BufferedResponseDataSource::ReadChunk(
     return static_cast<ssize_t>(to_copy);
 }
 
-int Http2Stream::AddHeader(const std::string& name, const std::string& value) {
+Http2Stream::HeaderToken Http2Stream::ClassifyHeaderName(std::string_view n) {
+    switch (n.size()) {
+    case 2:
+        if (n == "te") return HeaderToken::TE;
+        break;
+    case 4:
+        if (n == "host") return HeaderToken::HOST;
+        break;
+    case 5:
+        if (n == ":path") return HeaderToken::PATH;
+        break;
+    case 6:
+        if (n == "cookie") return HeaderToken::COOKIE;
+        break;
+    case 7:
+        if (n == ":method") return HeaderToken::METHOD;
+        if (n == ":scheme") return HeaderToken::SCHEME;
+        if (n == "upgrade") return HeaderToken::UPGRADE;
+        break;
+    case 10:
+        if (n == ":authority") return HeaderToken::AUTHORITY;
+        if (n == "connection") return HeaderToken::CONNECTION;
+        if (n == "keep-alive") return HeaderToken::KEEP_ALIVE;
+        break;
+    case 12:
+        if (n == "content-type") return HeaderToken::CONTENT_TYPE;
+        break;
+    case 13:
+        if (n == "authorization") return HeaderToken::AUTHORIZATION;
+        if (n == "content-range") return HeaderToken::CONTENT_RANGE;
+        break;
+    case 14:
+        if (n == "content-length") return HeaderToken::CONTENT_LENGTH;
+        break;
+    case 16:
+        if (n == "proxy-connection") return HeaderToken::PROXY_CONNECTION;
+        break;
+    case 17:
+        if (n == "transfer-encoding") return HeaderToken::TRANSFER_ENCODING;
+        break;
+    case 19:
+        if (n == "content-disposition") return HeaderToken::CONTENT_DISPOSITION;
+        break;
+    default:
+        break;
+    }
+    return HeaderToken::OTHER;
+}
+
+int Http2Stream::AddHeader(std::string_view name, std::string_view value) {
+    bool has_upper = std::any_of(name.begin(), name.end(),
+        [](unsigned char c) { return c >= 'A' && c <= 'Z'; });
+    if (!has_upper) {
+        return AddHeader(ClassifyHeaderName(name), name, value);
+    }
+    std::string lower_name(name);
+    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), [](unsigned char c){ return std::tolower(c); });
+    return AddHeader(ClassifyHeaderName(lower_name), lower_name, value);
+}
+
+int Http2Stream::AddHeader(HeaderToken token, std::string_view name,
+                           std::string_view value) {
+    // Map keys for the well-known fields this function writes. Built once so
+    // find()/emplace on them never constructs a temporary key.
+    static const std::string kHost = "host";
+    static const std::string kCookie = "cookie";
+
     // Handle pseudo-headers (RFC 9113 Section 8.3)
     if (!name.empty() && name[0] == ':') {
         // RFC 9113 Section 8.3: pseudo-headers MUST appear before all
@@ -115,45 +182,52 @@ int Http2Stream::AddHeader(const std::string& name, const std::string& value) {
             return -1;  // Late pseudo-header
         }
 
-        if (name == ":method") {
+        switch (token) {
+        case HeaderToken::METHOD:
             if (has_method_) {
                 logging::Get()->debug("H2 stream {} duplicate pseudo-header: {}", stream_id_, name);
                 return -1;  // Duplicate
             }
             has_method_ = true;
-            request_.method = value;
-        } else if (name == ":path") {
+            request_.method.assign(value.data(), value.size());
+            break;
+        case HeaderToken::PATH: {
             if (has_path_) {
                 logging::Get()->debug("H2 stream {} duplicate pseudo-header: {}", stream_id_, name);
                 return -1;  // Duplicate
             }
             has_path_ = true;
-            request_.url = value;
+            request_.url.assign(value.data(), value.size());
             // Split path and query
             auto qpos = value.find('?');
-            if (qpos != std::string::npos) {
-                request_.path = value.substr(0, qpos);
-                request_.query = value.substr(qpos + 1);
+            if (qpos != std::string_view::npos) {
+                request_.path.assign(value.data(), qpos);
+                request_.query.assign(value.data() + qpos + 1,
+                                      value.size() - qpos - 1);
             } else {
-                request_.path = value;
+                request_.path.assign(value.data(), value.size());
                 request_.query.clear();
             }
-        } else if (name == ":authority") {
+            break;
+        }
+        case HeaderToken::AUTHORITY:
             if (has_authority_) {
                 logging::Get()->debug("H2 stream {} duplicate pseudo-header: {}", stream_id_, name);
                 return -1;  // Duplicate
             }
             has_authority_ = true;
-            authority_ = value;
-            request_.headers["host"] = value;
-        } else if (name == ":scheme") {
+            authority_.assign(value.data(), value.size());
+            request_.headers.insert_or_assign(kHost, authority_);
+            break;
+        case HeaderToken::SCHEME:
             if (has_scheme_) {
                 logging::Get()->debug("H2 stream {} duplicate pseudo-header: {}", stream_id_, name);
                 return -1;  // Duplicate
             }
             has_scheme_ = true;
-            scheme_ = value;
-        } else {
+            scheme_.assign(value.data(), value.size());
+            break;
+        default:
             // Unknown pseudo-header — malformed per RFC 9113 Section 8.3
             logging::Get()->debug("H2 stream {} unknown pseudo-header: {}", stream_id_, name);
             return -1;
@@ -164,18 +238,14 @@ int Http2Stream::AddHeader(const std::string& name, const std::string& value) {
     // First regular header — mark transition
     seen_regular_header_ = true;
 
-    // Regular headers — store lowercase (matching HTTP/1.x convention)
-    std::string lower_name = name;
-    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), [](unsigned char c){ return std::tolower(c); });
-
     // Cookie headers in HTTP/2 may arrive as separate header fields
     // (RFC 9113 Section 8.2.3) — concatenate with "; "
-    if (lower_name == "cookie") {
-        auto it = request_.headers.find("cookie");
+    if (token == HeaderToken::COOKIE) {
+        auto it = request_.headers.find(kCookie);
         if (it != request_.headers.end()) {
-            it->second += "; " + value;
+            it->second.append("; ", 2).append(value.data(), value.size());
         } else {
-            request_.headers["cookie"] = value;
+            request_.headers.emplace(kCookie, std::string(value));
         }
         return 0;
     }
@@ -194,15 +264,16 @@ int Http2Stream::AddHeader(const std::string& name, const std::string& value) {
     //   overwriting the client's canonical intent.
     // - If :authority was set and conflicts, reject.
     // - Duplicate host headers (without :authority) rejected below as singleton.
-    if (lower_name == "host" && has_authority_) {
-        if (!AuthorityMatch(scheme_, authority_, value)) {
+    if (token == HeaderToken::HOST && has_authority_) {
+        std::string host_value(value);
+        if (!AuthorityMatch(scheme_, authority_, host_value)) {
             logging::Get()->debug("H2 stream {} conflicting :authority and host", stream_id_);
             return -1;  // Malformed: conflicting :authority and host
         }
         // Match — preserve the client's literal host value (may differ
         // textually from :authority but is equivalent after default-port
         // normalization).
-        request_.headers["host"] = value;
+        request_.headers.insert_or_assign(kHost, std::move(host_value));
         return 0;
     }
 
@@ -211,48 +282,53 @@ int Http2Stream::AddHeader(const std::string& name, const std::string& value) {
     // - Comma-fold list-valued headers per RFC 9110 Section 5.3
     // - Cookie uses "; " per RFC 6265 Section 5.4
     // - content-length handled separately below (allows identical duplicates)
-    auto it = request_.headers.find(lower_name);
-    if (it != request_.headers.end()) {
+    //
+    // One key construction per field: lower_bound locates both the
+    // duplicate and the insertion hint, and the key is moved into the node.
+    std::string key(name);
+    auto it = request_.headers.lower_bound(key);
+    if (it != request_.headers.end() && it->first == key) {
         // Reject singleton headers that must not be duplicated
-        if (lower_name == "host" || lower_name == "authorization" ||
-            lower_name == "content-type" ||
-            lower_name == "content-range" || lower_name == "content-disposition") {
+        if (token == HeaderToken::HOST || token == HeaderToken::AUTHORIZATION ||
+            token == HeaderToken::CONTENT_TYPE ||
+            token == HeaderToken::CONTENT_RANGE ||
+            token == HeaderToken::CONTENT_DISPOSITION) {
             logging::Get()->debug("H2 stream {} duplicate singleton header: {}",
                                   stream_id_, name);
             return -1;
         }
         // content-length: don't reject here — reconciliation below allows
         // identical values (common in proxied/translated requests)
-        if (lower_name != "content-length") {
+        if (token != HeaderToken::CONTENT_LENGTH) {
             // List-valued headers: comma-fold
-            it->second += ", " + value;
+            it->second.append(", ", 2).append(value.data(), value.size());
             return 0;
         }
     } else {
-        request_.headers[lower_name] = value;
+        request_.headers.emplace_hint(it, std::move(key), std::string(value));
     }
 
     // Track content-length for body size expectations.
     // RFC 9110 Section 8.6: content-length must be a valid non-negative integer.
     // Multiple content-length fields with differing values are malformed.
-    if (lower_name == "content-length") {
+    if (token == HeaderToken::CONTENT_LENGTH) {
         // Reject leading/trailing whitespace, signs, or non-digit chars
         if (value.empty()) return -1;
         for (char c : value) {
             if (c < '0' || c > '9') return -1;
         }
-        try {
-            size_t new_cl = std::stoull(value);
-            if (has_content_length_ && request_.content_length != new_cl) {
-                logging::Get()->debug("H2 stream {} invalid content-length", stream_id_);
-                return -1;  // Conflicting content-length values
-            }
-            request_.content_length = new_cl;
-            has_content_length_ = true;
-        } catch (...) {
+        unsigned long long new_cl = 0;
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), new_cl);
+        if (ec != std::errc() || ptr != value.data() + value.size()) {
+            logging::Get()->debug("H2 stream {} invalid content-length", stream_id_);
+            return -1;  // Overflow
+        }
+        if (has_content_length_ && request_.content_length != new_cl) {
             logging::Get()->debug("H2 stream {} invalid content-length", stream_id_);
-            return -1;  // Overflow or other parse error
+            return -1;  // Conflicting content-length values
         }
+        request_.content_length = static_cast<size_t>(new_cl);
+        has_content_length_ = true;
     }
 
     return 0;
@@ -0,0 +1,373 @@
+#include "http3/http3_codec.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "http/http_status.h"
+
+namespace HTTP3_CODEC {
+
+namespace {
+
+constexpr uint64_t VARINT_MAX = (1ULL << 62) - 1;
+
+// RFC 7541 §5.1 prefix integer — QPACK reuses the HPACK encoding with
+// different prefix widths (RFC 9204 §4.1.1).
+void AppendPrefixInt(uint8_t first_byte_bits, int prefix_bits,
+                     uint64_t value, std::string& out) {
+    const uint64_t max_prefix = (1ULL << prefix_bits) - 1;
+    if (value < max_prefix) {
+        out.push_back(static_cast<char>(first_byte_bits | value));
+        return;
+    }
+    out.push_back(static_cast<char>(first_byte_bits | max_prefix));
+    value -= max_prefix;
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Returns bytes consumed or 0 on truncation / overflow.
+size_t DecodePrefixInt(const uint8_t* data, size_t len, int prefix_bits,
+                       uint64_t& out) {
+    if (len == 0) return 0;
+    const uint64_t max_prefix = (1ULL << prefix_bits) - 1;
+    out = data[0] & max_prefix;
+    if (out < max_prefix) return 1;
+    size_t pos = 1;
+    int shift = 0;
+    while (pos < len) {
+        uint8_t b = data[pos++];
+        if (shift > 56) return 0;
+        out += static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) return pos;
+        shift += 7;
+    }
+    return 0;
+}
+
+void AppendFrame(uint64_t type, const char* payload, size_t len,
+                 std::string& out) {
+    AppendVarint(type, out);
+    AppendVarint(len, out);
+    out.append(payload, len);
+}
+
+bool IsConnectionSpecificHeader(const std::string& lower) {
+    return lower == "connection" || lower == "keep-alive" ||
+           lower == "proxy-connection" || lower == "transfer-encoding" ||
+           lower == "upgrade" || lower == "te";
+}
+
+bool HasUppercase(const std::string& s) {
+    for (unsigned char c : s) {
+        if (c >= 'A' && c <= 'Z') return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+void AppendVarint(uint64_t value, std::string& out) {
+    if (value > VARINT_MAX) value = VARINT_MAX;
+    if (value < (1ULL << 6)) {
+        out.push_back(static_cast<char>(value));
+    } else if (value < (1ULL << 14)) {
+        out.push_back(static_cast<char>(0x40 | (value >> 8)));
+        out.push_back(static_cast<char>(value & 0xFF));
+    } else if (value < (1ULL << 30)) {
+        out.push_back(static_cast<char>(0x80 | (value >> 24)));
+        for (int shift = 16; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    } else {
+        out.push_back(static_cast<char>(0xC0 | (value >> 56)));
+        for (int shift = 48; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+}
+
+size_t DecodeVarint(const uint8_t* data, size_t len, uint64_t& out) {
+    if (len == 0) return 0;
+    const size_t n = static_cast<size_t>(1) << (data[0] >> 6);
+    if (len < n) return 0;
+    out = data[0] & 0x3F;
+    for (size_t i = 1; i < n; ++i) {
+        out = (out << 8) | data[i];
+    }
+    return n;
+}
+
+void AppendEnvelope(const Envelope& env, std::string& out) {
+    AppendVarint(env.request_id, out);
+    AppendVarint(env.offset, out);
+    out.push_back(static_cast<char>(env.fin ? ENVELOPE_FLAG_FIN : 0));
+}
+
+size_t DecodeEnvelope(const uint8_t* data, size_t len, Envelope& out) {
+    size_t pos = 0;
+    size_t n = DecodeVarint(data, len, out.request_id);
+    if (n == 0) return 0;
+    pos += n;
+    n = DecodeVarint(data + pos, len - pos, out.offset);
+    if (n == 0) return 0;
+    pos += n;
+    if (pos >= len) return 0;
+    const uint8_t flags = data[pos++];
+    if (flags & ~ENVELOPE_FLAG_FIN) return 0;  // reserved bits must be zero
+    out.fin = (flags & ENVELOPE_FLAG_FIN) != 0;
+    return pos;
+}
+
+void EncodeFieldSection(
+        const std::vector<std::pair<std::string, std::string>>& fields,
+        std::string& out) {
+    // Encoded Field Section Prefix: Required Insert Count = 0, Base = 0.
+    out.push_back('\0');
+    out.push_back('\0');
+    for (const auto& f : fields) {
+        // 001N H xxx — literal name, N=0, H=0, 3-bit name length prefix.
+        AppendPrefixInt(0x20, 3, f.first.size(), out);
+        out.append(f.first);
+        // H=0, 7-bit value length prefix.
+        AppendPrefixInt(0x00, 7, f.second.size(), out);
+        out.append(f.second);
+    }
+}
+
+bool DecodeFieldSection(
+        const uint8_t* data, size_t len,
+        std::vector<std::pair<std::string, std::string>>& out,
+        std::string& err) {
+    size_t pos = 0;
+    uint64_t ric = 0, base = 0;
+    size_t n = DecodePrefixInt(data, len, 8, ric);
+    if (n == 0) { err = "truncated field section prefix"; return false; }
+    pos += n;
+    n = DecodePrefixInt(data + pos, len - pos, 7, base);
+    if (n == 0) { err = "truncated field section prefix"; return false; }
+    pos += n;
+    if (ric != 0) {
+        err = "dynamic table references are not supported";
+        return false;
+    }
+    while (pos < len) {
+        const uint8_t b = data[pos];
+        if ((b & 0xE0) != 0x20) {
+            err = "only literal field lines with literal names are supported";
+            return false;
+        }
+        if (b & 0x08) {
+            err = "huffman-encoded names are not supported";
+            return false;
+        }
+        uint64_t name_len = 0;
+        n = DecodePrefixInt(data + pos, len - pos, 3, name_len);
+        if (n == 0 || name_len > len - pos - n) {
+            err = "truncated field name";
+            return false;
+        }
+        pos += n;
+        std::string name(reinterpret_cast<const char*>(data + pos),
+                         static_cast<size_t>(name_len));
+        pos += static_cast<size_t>(name_len);
+        if (pos >= len) { err = "missing field value"; return false; }
+        if (data[pos] & 0x80) {
+            err = "huffman-encoded values are not supported";
+            return false;
+        }
+        uint64_t value_len = 0;
+        n = DecodePrefixInt(data + pos, len - pos, 7, value_len);
+        if (n == 0 || value_len > len - pos - n) {
+            err = "truncated field value";
+            return false;
+        }
+        pos += n;
+        std::string value(reinterpret_cast<const char*>(data + pos),
+                          static_cast<size_t>(value_len));
+        pos += static_cast<size_t>(value_len);
+        out.emplace_back(std::move(name), std::move(value));
+    }
+    return true;
+}
+
+bool ParseRequest(const uint8_t* data, size_t len, size_t max_body_size,
+                  HttpRequest& out, std::string& err) {
+    bool seen_headers = false;
+    size_t pos = 0;
+    while (pos < len) {
+        uint64_t type = 0, flen = 0;
+        size_t n = DecodeVarint(data + pos, len - pos, type);
+        if (n == 0) { err = "truncated frame type"; return false; }
+        pos += n;
+        n = DecodeVarint(data + pos, len - pos, flen);
+        if (n == 0) { err = "truncated frame length"; return false; }
+        pos += n;
+        if (flen > len - pos) { err = "truncated frame payload"; return false; }
+        const uint8_t* payload = data + pos;
+        pos += static_cast<size_t>(flen);
+
+        if (type == FRAME_HEADERS) {
+            // Trailing HEADERS (trailers) are not supported by the
+            // single-datagram request model.
+            if (seen_headers) { err = "unexpected second HEADERS frame"; return false; }
+            seen_headers = true;
+            std::vector<std::pair<std::string, std::string>> fields;
+            if (!DecodeFieldSection(payload, static_cast<size_t>(flen),
+                                    fields, err)) {
+                return false;
+            }
+            bool has_method = false, has_path = false, has_scheme = false;
+            bool has_authority = false, seen_regular = false;
+            for (auto& f : fields) {
+                const std::string& name = f.first;
+                if (name.empty() || HasUppercase(name)) {
+                    err = "invalid header name";
+                    return false;
+                }
+                if (name[0] == ':') {
+                    if (seen_regular) { err = "pseudo-header after regular header"; return false; }
+                    if (name == ":method" && !has_method) {
+                        has_method = true;
+                        out.method = f.second;
+                    } else if (name == ":path" && !has_path) {
+                        has_path = true;
+                        out.url = f.second;
+                        auto qpos = f.second.find('?');
+                        if (qpos != std::string::npos) {
+                            out.path = f.second.substr(0, qpos);
+                            out.query = f.second.substr(qpos + 1);
+                        } else {
+                            out.path = f.second;
+                        }
+                    } else if (name == ":scheme" && !has_scheme) {
+                        has_scheme = true;
+                        out.url_scheme = f.second;
+                    } else if (name == ":authority" && !has_authority) {
+                        has_authority = true;
+                        out.headers["host"] = f.second;
+                    } else {
+                        err = "duplicate or unknown pseudo-header " + name;
+                        return false;
+                    }
+                    continue;
+                }
+                seen_regular = true;
+                if (IsConnectionSpecificHeader(name)) {
+                    err = "connection-specific header " + name;
+                    return false;
+                }
+                if (name == "host" && has_authority) continue;
+                auto it = out.headers.find(name);
+                if (it == out.headers.end()) {
+                    out.headers.emplace(name, std::move(f.second));
+                } else if (name == "cookie") {
+                    it->second += "; " + f.second;
+                } else if (name == "host" || name == "authorization" ||
+                           name == "content-type" || name == "content-length") {
+                    err = "duplicate singleton header " + name;
+                    return false;
+                } else {
+                    it->second += ", " + f.second;
+                }
+            }
+            if (!has_method || !has_path || !has_scheme || out.path.empty()) {
+                err = "missing required pseudo-header";
+                return false;
+            }
+        } else if (type == FRAME_DATA) {
+            if (!seen_headers) { err = "DATA before HEADERS"; return false; }
+            if (out.body.size() + flen > max_body_size) {
+                err = "request body too large";
+                return false;
+            }
+            out.body.append(reinterpret_cast<const char*>(payload),
+                            static_cast<size_t>(flen));
+        }
+        // Unknown / reserved frame types are ignored (RFC 9114 §9).
+    }
+    if (!seen_headers) { err = "missing HEADERS frame"; return false; }
+
+    auto cl = out.headers.find("content-length");
+    if (cl != out.headers.end()) {
+        const std::string& v = cl->second;
+        if (v.empty() || v.find_first_not_of("0123456789") != std::string::npos ||
+            v.size() > 19 || std::stoull(v) != out.body.size()) {
+            err = "content-length does not match DATA frames";
+            return false;
+        }
+    }
+    out.content_length = out.body.size();
+    out.http_major = 3;
+    out.http_minor = 0;
+    out.network_protocol_version = "3";
+    out.keep_alive = true;
+    out.headers_complete = true;
+    out.complete = true;
+    return true;
+}
+
+std::string SerializeResponse(const HttpResponse& response, bool head_request) {
+    const int status_code = response.GetStatusCode();
+    const bool suppress_body = head_request ||
+                               status_code == HttpStatus::NO_CONTENT ||
+                               status_code == HttpStatus::RESET_CONTENT ||
+                               status_code == HttpStatus::NOT_MODIFIED;
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    fields.reserve(response.GetHeaders().size() + 2);
+    fields.emplace_back(":status", std::to_string(status_code));
+    for (const auto& hdr : response.GetHeaders()) {
+        std::string key = hdr.first;
+        std::transform(key.begin(), key.end(), key.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        if (IsConnectionSpecificHeader(key) || key == "trailer" ||
+            key == "content-length") {
+            continue;
+        }
+        fields.emplace_back(std::move(key), hdr.second);
+    }
+    if (auto cl = response.ComputeWireContentLength(status_code)) {
+        fields.emplace_back("content-length", *cl);
+    }
+
+    std::string section;
+    EncodeFieldSection(fields, section);
+    std::string frames;
+    AppendFrame(FRAME_HEADERS, section.data(), section.size(), frames);
+    const std::string& body = response.GetBody();
+    if (!suppress_body && !body.empty()) {
+        AppendFrame(FRAME_DATA, body.data(), body.size(), frames);
+    }
+    return frames;
+}
+
+std::vector<std::string> Packetize(uint64_t request_id,
+                                   const std::string& frames,
+                                   size_t max_datagram_size) {
+    std::vector<std::string> out;
+    size_t offset = 0;
+    do {
+        Envelope env;
+        env.request_id = request_id;
+        env.offset = offset;
+        std::string dgram;
+        AppendEnvelope(env, dgram);
+        // Envelope size is computed with fin=false; the flag byte is fixed
+        // width, so flipping it below never changes the header length.
+        const size_t header_len = dgram.size();
+        const size_t room = max_datagram_size > header_len
+                                ? max_datagram_size - header_len : 1;
+        const size_t chunk = std::min(room, frames.size() - offset);
+        dgram.append(frames, offset, chunk);
+        offset += chunk;
+        if (offset == frames.size()) {
+            dgram[header_len - 1] = static_cast<char>(ENVELOPE_FLAG_FIN);
+        }
+        out.push_back(std::move(dgram));
+    } while (offset < frames.size());
+    return out;
+}
+
+} // namespace HTTP3_CODEC
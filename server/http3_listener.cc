@@ -0,0 +1,217 @@
+#include "http3/http3_listener.h"
+#include "http3/http3_codec.h"
+#include "http/http_status.h"
+#include "log/logger.h"
+
+namespace {
+
+using StreamSender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender;
+
+class BufferedStreamSenderImpl final : public StreamSender::Impl {
+public:
+    BufferedStreamSenderImpl(Dispatcher* dispatcher,
+                             Http3Listener::ResponseCallback respond)
+        : dispatcher_(dispatcher), respond_(std::move(respond)) {}
+
+    int SendHeaders(const HttpResponse& headers_only_response) override {
+        if (state_ != State::IDLE) return -1;
+        response_ = headers_only_response;
+        response_.Body(std::string{});
+        state_ = State::HEADERS_SENT;
+        return 0;
+    }
+
+    StreamSender::SendResult SendData(const char* data, size_t len) override {
+        if (state_ != State::HEADERS_SENT) return StreamSender::SendResult::CLOSED;
+        body_.append(data, len);
+        return StreamSender::SendResult::ACCEPTED_BELOW_WATER;
+    }
+
+    StreamSender::SendResult End(
+            const std::vector<std::pair<std::string, std::string>>&) override {
+        // Trailers have no carrier in the single-HEADERS response model and
+        // are dropped, same as an HTTP/1.0 client would see.
+        if (state_ != State::HEADERS_SENT) return StreamSender::SendResult::CLOSED;
+        state_ = State::DONE;
+        // The upstream may have advertised a Content-Length that matches
+        // the relayed body; recompute from the buffered bytes instead.
+        response_.RemoveHeader("Content-Length");
+        response_.Body(std::move(body_));
+        if (respond_) respond_(std::move(response_));
+        return StreamSender::SendResult::ACCEPTED_BELOW_WATER;
+    }
+
+    void Abort(StreamSender::AbortReason) override {
+        const bool headers_sent = (state_ == State::HEADERS_SENT);
+        if (state_ == State::DONE) return;
+        state_ = State::DONE;
+        if (headers_sent && respond_) respond_(HttpResponse::BadGateway());
+    }
+
+    void SetDrainListener(StreamSender::DrainListener) override {}
+    void ConfigureWatermarks(size_t) override {}
+    Dispatcher* GetDispatcher() override { return dispatcher_; }
+
+private:
+    enum class State { IDLE, HEADERS_SENT, DONE };
+    Dispatcher* dispatcher_;
+    Http3Listener::ResponseCallback respond_;
+    HttpResponse response_;
+    std::string body_;
+    State state_ = State::IDLE;
+};
+
+}  // namespace
+
+Http3Listener::Http3Listener(std::vector<std::shared_ptr<Dispatcher>> dispatchers,
+                             Options options)
+    : dispatchers_(std::move(dispatchers)), options_(options) {
+    options_.max_datagram_size = std::min(
+        std::max<size_t>(options_.max_datagram_size, 64),
+        HTTP3_CODEC::MAX_DATAGRAM_PAYLOAD);
+}
+
+Http3Listener::~Http3Listener() {
+    Stop();
+}
+
+void Http3Listener::Start(const InetAddr& bind_addr) {
+    InetAddr addr = bind_addr;
+    try {
+        for (size_t i = 0; i < dispatchers_.size(); ++i) {
+            // Inbound datagrams may be up to the IPv4 UDP maximum — requests
+            // are not bound by the outbound max_datagram_size.
+            auto sock = std::make_shared<UdpListener>(
+                dispatchers_[i], options_.recv_batch_size,
+                HTTP3_CODEC::MAX_DATAGRAM_PAYLOAD);
+            sock->SetDatagramCallback(
+                [this, i](const InetAddr& peer, const char* data, size_t len) {
+                    OnDatagram(i, peer, data, len);
+                });
+            sock->Open(addr);
+            if (i == 0) {
+                addr.SetPort(static_cast<uint16_t>(sock->GetBoundPort()));
+                bound_port_.store(sock->GetBoundPort(), std::memory_order_release);
+            }
+            sockets_.push_back(std::move(sock));
+        }
+    } catch (...) {
+        Stop();
+        throw;
+    }
+    logging::Get()->info("HTTP/3 (experimental) listening on udp {} ({} sockets)",
+                         addr.ToString(), sockets_.size());
+}
+
+void Http3Listener::Stop() {
+    // Close only flips the channel closed and hands the fd teardown to the
+    // owning dispatcher; the datagram callbacks (which capture `this`) stay
+    // installed because a read drain may be running on that thread right
+    // now. HttpServer keeps this object alive until its dispatchers have
+    // been joined.
+    for (auto& s : sockets_) s->Close();
+}
+
+Http3Listener::Stats Http3Listener::GetStats() const {
+    Stats s;
+    for (const auto& sock : sockets_) {
+        auto u = sock->GetStats();
+        s.udp.datagrams_received += u.datagrams_received;
+        s.udp.datagrams_sent += u.datagrams_sent;
+        s.udp.recv_batches += u.recv_batches;
+        s.udp.send_batches += u.send_batches;
+        s.udp.send_dropped += u.send_dropped;
+        s.udp.recv_truncated += u.recv_truncated;
+    }
+    s.requests = counters_->requests.load(std::memory_order_relaxed);
+    s.malformed = counters_->malformed.load(std::memory_order_relaxed);
+    s.responses = counters_->responses.load(std::memory_order_relaxed);
+    return s;
+}
+
+Http3Listener::ResponseCallback Http3Listener::MakeResponder(
+        size_t index, const InetAddr& peer, uint64_t request_id,
+        bool head_request) {
+    std::weak_ptr<UdpListener> weak_sock = sockets_[index];
+    std::shared_ptr<Dispatcher> dispatcher = dispatchers_[index];
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    auto counters = counters_;
+    const size_t max_dgram = options_.max_datagram_size;
+    return [weak_sock, dispatcher, done, counters, peer, request_id,
+            head_request, max_dgram](HttpResponse response) {
+        if (done->exchange(true, std::memory_order_acq_rel)) return;
+        auto emit = [weak_sock, counters, peer, request_id, head_request,
+                     max_dgram](const HttpResponse& r) {
+            auto sock = weak_sock.lock();
+            if (!sock) return;
+            auto dgrams = HTTP3_CODEC::Packetize(
+                request_id, HTTP3_CODEC::SerializeResponse(r, head_request),
+                max_dgram);
+            for (auto& d : dgrams) sock->Send(peer, std::move(d));
+            counters->responses.fetch_add(1, std::memory_order_relaxed);
+        };
+        if (dispatcher->is_on_loop_thread()) {
+            emit(response);
+            return;
+        }
+        auto shared_resp = std::make_shared<HttpResponse>(std::move(response));
+        dispatcher->EnQueue([emit, shared_resp]() { emit(*shared_resp); });
+    };
+}
+
+void Http3Listener::OnDatagram(size_t index, const InetAddr& peer,
+                               const char* data, size_t len) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    HTTP3_CODEC::Envelope env;
+    const size_t hdr = HTTP3_CODEC::DecodeEnvelope(bytes, len, env);
+    if (hdr == 0) {
+        // No request id to answer to — drop silently.
+        counters_->malformed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (env.offset != 0 || !env.fin) {
+        counters_->malformed.fetch_add(1, std::memory_order_relaxed);
+        MakeResponder(index, peer, env.request_id, false)(
+            HttpResponse::PayloadTooLarge().Text(
+                "HTTP/3 prototype: request must fit in one datagram"));
+        return;
+    }
+
+    HttpRequest request;
+    std::string err;
+    if (!HTTP3_CODEC::ParseRequest(bytes + hdr, len - hdr,
+                                   options_.max_body_size, request, err)) {
+        counters_->malformed.fetch_add(1, std::memory_order_relaxed);
+        logging::Get()->debug("HTTP/3 request {} from {} rejected: {}",
+                              env.request_id, peer.ToString(), err);
+        MakeResponder(index, peer, env.request_id, false)(
+            HttpResponse::BadRequest());
+        return;
+    }
+    counters_->requests.fetch_add(1, std::memory_order_relaxed);
+
+    request.client_ip = peer.Ip();
+    request.client_tls = false;
+    request.dispatcher_index = dispatchers_[index]->dispatcher_index();
+    request.owning_dispatcher = dispatchers_[index].get();
+
+    auto respond = MakeResponder(index, peer, env.request_id,
+                                 request.method == "HEAD");
+    if (!request_cb_) {
+        respond(HttpResponse::NotFound());
+        return;
+    }
+    try {
+        request_cb_(request, respond);
+    } catch (const std::exception& e) {
+        logging::Get()->error("HTTP/3 request handler threw: {}", e.what());
+        respond(HttpResponse::InternalError());
+    }
+}
+
+HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender
+Http3Listener::MakeBufferedStreamSender(Dispatcher* dispatcher,
+                                        ResponseCallback respond) {
+    return StreamSender(std::make_shared<BufferedStreamSenderImpl>(
+        dispatcher, std::move(respond)));
+}
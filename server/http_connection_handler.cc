@@ -642,6 +642,10 @@ HttpConnectionHandler::HttpConnectionHandler(std::shared_ptr<ConnectionHandler>
         auto opts = callbacks_.resolve_route_options_callback(req.method, req.path);
         if (opts.request_mode != http::RouteRequestMode::Streaming) return;
         if (req.complete) return;  // END_STREAM on headers — no body coming
+        // A GET upgrade has no body and is routed by the WebSocket path at
+        // message-complete; dispatching it here would send a proxy route's
+        // upgrade upstream as a plain GET.
+        if (req.upgrade && req.method == "GET") return;
 
         std::weak_ptr<HttpConnectionHandler> weak_self = weak_from_this();
         http::ChunkQueueBodyStream::Config cfg;
@@ -875,6 +879,11 @@ void HttpConnectionHandler::SetShutdownCheckCallback(
     callbacks_.shutdown_check_callback = std::move(callback);
 }
 
+void HttpConnectionHandler::SetWsTunnelCallback(
+    HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelCallback callback) {
+    callbacks_.ws_tunnel_callback = std::move(callback);
+}
+
 void HttpConnectionHandler::SetMaxBodySize(size_t max) {
     max_body_size_ = max;
     parser_.SetMaxBodySize(max);
@@ -896,7 +905,12 @@ void HttpConnectionHandler::UpdateSizeLimits(size_t body, size_t header,
         // transport cap to the WS-specific value (0 = unlimited).
         ws_conn_->GetParser().SetMaxPayloadSize(ws);
         ws_conn_->SetMaxMessageSize(ws);
-        conn_->SetMaxInputSize(ws);
+        // Streaming consumers keep their smaller per-read cap.
+        conn_->SetMaxInputSize(ws_conn_->IsStreaming()
+                                   ? WebSocketConnection::kStreamingReadCap : ws);
+    } else if (IsWsTunnel()) {
+        // Proxied WebSocket: the tunnel owns the per-read cap (the
+        // upstream's relay_buffer_limit_bytes); HTTP limits no longer apply.
     } else {
         // HTTP-mode connection: use the composite HTTP input cap.
         conn_->SetMaxInputSize(http_input_cap);
@@ -1370,12 +1384,89 @@ void HttpConnectionHandler::OnSendComplete() {
     if (auto impl = active_stream_sender_impl_.lock()) {
         impl->OnDownstreamWriteComplete();
     }
+    if (IsWsTunnel()) {
+        auto on_drain = ws_tunnel_hooks_.on_drain;
+        if (on_drain) on_drain(0);
+    }
 }
 
 void HttpConnectionHandler::OnWriteProgress(size_t remaining_bytes) {
     if (auto impl = active_stream_sender_impl_.lock()) {
         impl->OnDownstreamWriteProgress(remaining_bytes);
     }
+    if (IsWsTunnel()) {
+        auto on_drain = ws_tunnel_hooks_.on_drain;
+        if (on_drain) on_drain(remaining_bytes);
+    }
+}
+
+void HttpConnectionHandler::BeginWsTunnel(const HttpRequest& req,
+                                          std::function<void()> on_abort) {
+    // The async-middleware resume path is already inside the deferred
+    // window opened at suspend time; keep its stash.
+    if (!deferred_response_pending_) {
+        BeginAsyncResponse(req);
+    }
+    // Replaces the suspend-time hook, so finalize the snapshot here the
+    // same way it did.
+    auto snap = req.obs_snapshot;
+    SetAsyncAbortHook([on_abort = std::move(on_abort), snap]() {
+        if (on_abort) on_abort();
+        if (snap) {
+            if (auto mgr = snap->manager.lock()) {
+                mgr->FinalizeFromSnapshot(*snap, /*status_code=*/0,
+                                          /*wire_body_size=*/0,
+                                          "client_disconnect");
+            }
+        }
+    });
+}
+
+void HttpConnectionHandler::CompleteWsTunnel(
+        HttpResponse response,
+        HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelHooks hooks,
+        const std::string& error_type) {
+    if (!deferred_response_pending_) {
+        logging::Get()->warn(
+            "CompleteWsTunnel called without a pending upgrade fd={}",
+            conn_ ? conn_->fd() : -1);
+        return;
+    }
+    const bool switching =
+        response.GetStatusCode() == HttpStatus::SWITCHING_PROTOCOLS &&
+        hooks.on_data && !conn_->IsClosing();
+
+    if (deferred_obs_snapshot_) {
+        if (auto mgr = deferred_obs_snapshot_->manager.lock()) {
+            mgr->FinalizeFromSnapshot(
+                *deferred_obs_snapshot_, response.GetStatusCode(),
+                switching ? 0u : response.GetBody().size(), error_type);
+        }
+    }
+
+    if (!switching) {
+        response.Header("Connection", "close");
+        response.ClearDeferred();
+        CompleteAsyncResponse(std::move(response));
+        return;
+    }
+
+    // Same ordering as the local async-resume upgrade: switch modes
+    // BEFORE CompleteAsyncResponse so its deferred-buf replay reaches
+    // the tunnel instead of the HTTP parser. A 101 never closes.
+    upgraded_ = true;
+    ws_tunnel_hooks_ = std::move(hooks);
+    deferred_keep_alive_ = true;
+    conn_->HandOffToWebSocket();
+    response.ClearDeferred();
+    CompleteAsyncResponse(std::move(response));
+}
+
+void HttpConnectionHandler::NotifyWsTunnelClose() {
+    if (!upgraded_ || !ws_tunnel_hooks_.on_data) return;
+    auto on_close = std::move(ws_tunnel_hooks_.on_close);
+    ws_tunnel_hooks_ = {};
+    if (on_close) on_close();
 }
 
 void HttpConnectionHandler::CloseConnection() {
@@ -1780,7 +1871,7 @@ bool HttpConnectionHandler::HandleCompleteRequest(const char*& buf, size_t& rema
                 // Snapshot was already finalized at 101 success.
                 ws_conn_->SendClose(1011, "Internal error");
             } else {
-                // Post-101 but ws_conn_ is null — make_unique threw (OOM).
+                // Post-101 but ws_conn_ is null — make_shared threw (OOM).
                 // Connection is in a bad state (101 sent, no WS handler).
                 // Force close the transport immediately.
                 conn_->ForceClose();
@@ -2052,6 +2143,23 @@ bool HttpConnectionHandler::ContinueWsUpgradeAfterAuth(
     conn_->ClearDeadline();
     conn_->SetDeadlineTimeoutCb(nullptr);
 
+    // WebSocket proxy route: the upstream negotiates the handshake and
+    // its answer arrives later through CompleteWsTunnel. Shutdown is
+    // gated first for the same reason as the local 101 below.
+    if (callbacks_.ws_tunnel_callback &&
+        !(callbacks_.shutdown_check_callback &&
+          callbacks_.shutdown_check_callback())) {
+        if (callbacks_.ws_tunnel_callback(shared_from_this(), req)) {
+            // Frames pipelined behind the upgrade wait in the deferred
+            // stash until the upstream's 101 is relayed.
+            if (trailing_len > 0 && trailing_buf &&
+                deferred_response_pending_) {
+                StashDeferredBytes(std::string(trailing_buf, trailing_len));
+            }
+            return true;
+        }
+    }
+
     // Build the 101 response, merging safe middleware headers.
     HttpResponse upgrade_resp = WebSocketHandshake::Accept(req);
     for (const auto& hdr : mw_response.GetHeaders()) {
@@ -2059,11 +2167,10 @@ bool HttpConnectionHandler::ContinueWsUpgradeAfterAuth(
         std::transform(key.begin(), key.end(), key.begin(),
                        [](unsigned char c){ return std::tolower(c); });
         // Skip 101 mandatory headers, framing headers, and WS
-        // negotiation headers. This server doesn't implement WS
-        // extensions or subprotocol negotiation, so allowing middleware
-        // to inject Sec-WebSocket-Extensions (e.g. permessage-deflate)
-        // would cause clients to send RSV1 frames that the parser
-        // rejects as protocol errors.
+        // negotiation headers. Extensions are negotiated below from
+        // config (the parser only accepts RSV1 when the server agreed
+        // to permessage-deflate itself), and subprotocol negotiation is
+        // not implemented, so middleware must not inject either.
         if (key == "connection" || key == "upgrade" ||
             key == "sec-websocket-accept" || key == "content-length" ||
             key == "transfer-encoding" ||
@@ -2074,6 +2181,28 @@ bool HttpConnectionHandler::ContinueWsUpgradeAfterAuth(
         upgrade_resp.Header(hdr.first, hdr.second);
     }
 
+    // permessage-deflate. The codec reserves its zlib memory against the
+    // server-wide budget now; when the budget is full the offer is
+    // declined and the connection runs uncompressed. Dropped (and the
+    // reservation released) if the upgrade fails before ws_conn_ exists.
+    std::unique_ptr<WebSocketDeflate> ws_deflate;
+    if (ws_deflate_config_.enabled) {
+        WebSocketDeflateParams deflate_params;
+        if (WebSocketHandshake::NegotiateDeflate(req, ws_deflate_config_,
+                                                 deflate_params)) {
+            ws_deflate = WebSocketDeflate::Create(
+                deflate_params, ws_deflate_config_, ws_deflate_budget_);
+            if (ws_deflate) {
+                upgrade_resp.Header("Sec-WebSocket-Extensions",
+                                    deflate_params.ToHeaderValue());
+            } else {
+                logging::Get()->debug(
+                    "WS permessage-deflate declined fd={}: memory budget "
+                    "exhausted", conn_->fd());
+            }
+        }
+    }
+
     // Late shutdown gate: the early route_check ran before middleware/101.
     // Must check BEFORE sending 101 — once 101 is on the wire, clients
     // expect a WebSocket session. Sending 101 then closing the TCP
@@ -2106,12 +2235,15 @@ bool HttpConnectionHandler::ContinueWsUpgradeAfterAuth(
     // preserved unchanged.
     if (from_async_resume) {
         upgraded_ = true;
-        ws_conn_ = std::make_unique<WebSocketConnection>(conn_);
+        ws_conn_ = std::make_shared<WebSocketConnection>(conn_);
         if (max_ws_message_size_ > 0) {
             ws_conn_->GetParser().SetMaxPayloadSize(max_ws_message_size_);
             ws_conn_->SetMaxMessageSize(max_ws_message_size_);
             conn_->SetMaxInputSize(max_ws_message_size_);
         }
+        if (ws_deflate) {
+            ws_conn_->EnablePerMessageDeflate(std::move(ws_deflate));
+        }
         // Release the http/1.1 slot BEFORE wiring the WS snapshot's +1 so
         // a /metrics scrape racing the handoff (Prometheus scrapes run on
         // whichever socket dispatcher accepted the scrape connection, not
@@ -2197,12 +2329,15 @@ bool HttpConnectionHandler::ContinueWsUpgradeAfterAuth(
     // and sends WS close 1011 instead of raw HTTP 500.
     upgraded_ = true;
 
-    ws_conn_ = std::make_unique<WebSocketConnection>(conn_);
+    ws_conn_ = std::make_shared<WebSocketConnection>(conn_);
     if (max_ws_message_size_ > 0) {
         ws_conn_->GetParser().SetMaxPayloadSize(max_ws_message_size_);
         ws_conn_->SetMaxMessageSize(max_ws_message_size_);
         conn_->SetMaxInputSize(max_ws_message_size_);
     }
+    if (ws_deflate) {
+        ws_conn_->EnablePerMessageDeflate(std::move(ws_deflate));
+    }
     // Release the http/1.1 slot BEFORE wiring the WS snapshot's +1 so a
     // /metrics scrape racing the handoff (Prometheus scrapes run on
     // whichever socket dispatcher accepted the scrape connection, not
@@ -2636,6 +2771,14 @@ void HttpConnectionHandler::OnRawData(std::shared_ptr<ConnectionHandler> conn, s
         HandleUpgradedData(data);
         return;
     }
+    // Proxied WebSocket: raw bytes go straight to the tunnel. Once the
+    // tunnel has closed, late bytes are dropped rather than parsed as HTTP.
+    if (upgraded_ && !ws_conn_) {
+        // Copy: a close triggered inside the relay clears the hooks.
+        auto on_data = ws_tunnel_hooks_.on_data;
+        if (on_data) on_data(data);
+        return;
+    }
 
     // If an async response is still pending, buffer the incoming bytes
     // instead of parsing new requests. This preserves HTTP/1 response
@@ -284,13 +284,15 @@ void HttpRouter::Route(const std::string& method, const std::string& path,
     // Trie insert first so duplicate-pattern exception surfaces before
     // route_options_ commit (mirrors the 3-arg sync_pattern_keys_ ordering).
     Route(method, path, std::move(handler));
-    route_options_[method][path] = options;
+    if (!options.early_hints.empty()) has_early_hints_ = true;
+    route_options_[method][path] = std::move(options);
 }
 
 void HttpRouter::RouteAsync(const std::string& method, const std::string& path,
                              AsyncHandler handler, http::RouteOptions options) {
     RouteAsync(method, path, std::move(handler));
-    route_options_[method][path] = options;
+    if (!options.early_hints.empty()) has_early_hints_ = true;
+    route_options_[method][path] = std::move(options);
 }
 
 void HttpRouter::RouteProxyAsync(const std::string& method,
@@ -298,7 +300,8 @@ void HttpRouter::RouteProxyAsync(const std::string& method,
                                   AsyncHandler handler,
                                   http::RouteOptions options) {
     RouteProxyAsync(method, path, std::move(handler));
-    route_options_[method][path] = options;
+    if (!options.early_hints.empty()) has_early_hints_ = true;
+    route_options_[method][path] = std::move(options);
 }
 
 http::RouteOptions HttpRouter::ResolveOptionsAtHeaders(
@@ -351,6 +354,18 @@ http::RouteOptions HttpRouter::ResolveOptionsAtHeaders(
     return {};
 }
 
+const std::vector<std::string>& HttpRouter::GetEarlyHints(
+    const std::string& method, bool head_fallback,
+    const std::string& pattern) const {
+    static const std::vector<std::string> kNone;
+    if (!has_early_hints_ || pattern.empty()) return kNone;
+    auto mit = route_options_.find(head_fallback ? std::string("GET") : method);
+    if (mit == route_options_.end()) return kNone;
+    auto pit = mit->second.find(pattern);
+    if (pit == mit->second.end()) return kNone;
+    return pit->second.early_hints;
+}
+
 bool HttpRouter::IsProxyAsyncPattern(const std::string& method,
                                       const std::string& pattern) const {
     auto it = proxy_async_patterns_.find(method);
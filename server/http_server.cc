@@ -1,10 +1,12 @@
 #include "http/http_server.h"
 #include "http/http_status.h"
 #include "http/push_helper.h"
+#include "http/early_hints.h"
 #include "config/config_loader.h"
 #include "net/dns_resolver.h"            // IsValidHostOrIpLiteral grammar
 #include "upstream/upstream_manager.h"
 #include "upstream/proxy_handler.h"
+#include "upstream/ws_tunnel.h"
 #include "auth/auth_manager.h"
 #include "auth/upstream_http_client.h"
 #include "observability/batch_span_processor.h"
@@ -21,6 +23,7 @@
 #include "circuit_breaker/circuit_breaker_host.h"
 #include "circuit_breaker/circuit_breaker_slice.h"
 #include "upstream/pool_partition.h"
+#include "tls/tls_key_offloader.h"
 #include "log/logger.h"
 #include "log/log_utils.h"
 #include <netdb.h>                        // getaddrinfo (bind-host resolve)
@@ -954,6 +957,10 @@ void HttpServer::MarkServerReady() {
     // gate closed (as intended).
     InternalRegistrationScope scope;
 
+    // Tunnels start only after server_ready_ flips, so this plain store
+    // is published by that release-store.
+    ws_tunnel_context_->obs_manager = observability_manager_;
+
     // Assign dispatcher indices for upstream pool partition affinity
     const auto& dispatchers = net_server_.GetSocketDispatchers();
     for (size_t i = 0; i < dispatchers.size(); ++i) {
@@ -1216,7 +1223,7 @@ void HttpServer::MarkServerReady() {
                                     service, i);
                                 return;
                             }
-                            if (auto* part = um->GetPoolPartition(
+                            for (auto* part : um->GetPoolPartitions(
                                     service, i)) {
                                 part->DrainWaitQueueOnTrip();
                             }
@@ -1366,6 +1373,10 @@ void HttpServer::MarkServerReady() {
     // sees the failure instead of the server starting in a partially
     // configured state where the expected proxy routes are missing.
     // Mirrors the upstream_manager_ init-failure pattern above.
+    if (proxy_cache_config_.enabled && !response_cache_) {
+        response_cache_ = std::make_shared<ResponseCache>(proxy_cache_config_);
+        response_cache_->SetObservabilityManager(observability_manager_.get());
+    }
     try {
         for (const auto& [pattern, name] : pending_proxy_routes_) {
             Proxy(pattern, name);
@@ -1504,6 +1515,12 @@ void HttpServer::MarkServerReady() {
             "ObservabilityManager middleware installed");
     }
 
+    // Experimental HTTP/3 listener — after every middleware is installed
+    // so the first datagram already sees the complete chain.
+    if (http3_config_.enabled) {
+        StartHttp3Listener();
+    }
+
     start_time_ = std::chrono::steady_clock::now();
     server_ready_.store(true, std::memory_order_release);
 
@@ -1764,6 +1781,7 @@ HttpServer::HttpServer(ServerConfig config)
     request_timeout_sec_.store(config.request_timeout_sec, std::memory_order_relaxed);
     shutdown_drain_timeout_sec_.store(config.shutdown_drain_timeout_sec, std::memory_order_relaxed);
     net_server_.SetMaxConnections(config.max_connections);
+    ws_tunnel_context_ = std::make_shared<WsTunnelContext>();
 
     // Set input buffer cap on NetServer — applied BEFORE epoll registration
     // to eliminate the race where data arrives before the cap is set.
@@ -1772,6 +1790,12 @@ HttpServer::HttpServer(ServerConfig config)
     // Initialize HTTP/2 enabled flag BEFORE the TLS section so that ALPN
     // protocol selection below uses the config value, not the member default.
     http2_enabled_ = config.http2.enabled;
+    http3_config_ = config.http3;
+    ws_deflate_config_ = config.websocket.permessage_deflate;
+    if (ws_deflate_config_.enabled) {
+        ws_deflate_budget_ = std::make_shared<WebSocketDeflateBudget>(
+            ws_deflate_config_.max_memory_bytes);
+    }
 
     if (config.tls.enabled) {
         tls_ctx_ = std::make_shared<TlsContext>(config.tls.cert_file, config.tls.key_file);
@@ -1792,6 +1816,41 @@ HttpServer::HttpServer(ServerConfig config)
             tls_ctx_->SetAlpnProtocols({"http/1.1"});
         }
 
+        tls_ctx_->ConfigureSessionResumption(
+            config.tls.session_tickets, config.tls.ticket_key_file,
+            static_cast<size_t>(config.tls.session_cache_size),
+            config.tls.session_timeout_sec);
+
+        if (config.tls.ktls && !tls_ctx_->EnableKtls()) {
+            logging::Get()->warn("tls.ktls requested but this OpenSSL build "
+                                 "has no kernel TLS support — using "
+                                 "user-space TLS");
+        }
+
+        if (config.tls.handshake_offload_threads > 0) {
+            if (tls_ctx_->EnableKeyOffload(config.tls.handshake_offload_threads)) {
+                logging::Get()->info("TLS handshake key operations offloaded "
+                                     "to {} worker thread(s)",
+                                     config.tls.handshake_offload_threads);
+            } else {
+                logging::Get()->warn("tls.handshake_offload_threads set but "
+                                     "key offload is unavailable (no async "
+                                     "job support or key is not RSA/EC) — "
+                                     "signing on the dispatchers");
+            }
+        }
+
+        if (config.tls.record_sizing) {
+            TlsContext::RecordSizing sizing;
+            sizing.enabled = true;
+            sizing.initial_record_size =
+                static_cast<size_t>(config.tls.record_size_initial);
+            sizing.ramp_bytes =
+                static_cast<size_t>(config.tls.record_size_ramp_bytes);
+            sizing.idle_reset_ms = config.tls.record_size_idle_reset_ms;
+            tls_ctx_->SetRecordSizing(sizing);
+        }
+
         net_server_.SetTlsContext(tls_ctx_);
     }
 
@@ -1801,6 +1860,7 @@ HttpServer::HttpServer(ServerConfig config)
     h2_settings_.max_frame_size         = config.http2.max_frame_size;
     h2_settings_.max_header_list_size   = config.http2.max_header_list_size;
     h2_settings_.enable_push            = config.http2.enable_push;
+    h2_settings_.write_batching         = config.http2.write_batching;
 
     // Snapshot streaming watermarks from config. Live-reload via Reload()
     // updates these atomics and walks live handlers to push the new values.
@@ -1820,6 +1880,7 @@ HttpServer::HttpServer(ServerConfig config)
 
     // Store rate limit config for MarkServerReady()
     rate_limit_config_ = config.rate_limit;
+    proxy_cache_config_ = config.proxy_cache;
 
     // Store auth config for MarkServerReady (AuthManager is constructed
     // there, alongside UpstreamManager — the manager needs the pool
@@ -2060,7 +2121,8 @@ void HttpServer::Proxy(const std::string& route_pattern,
         found->port,
         found->tls.sni_hostname,
         upstream_manager_.get(),
-        auth_manager_.get());
+        auth_manager_.get(),
+        response_cache_);
 
     // Determine methods to register. HEAD is included so the proxy sends
     // HEAD upstream (not GET via fallback, which downloads the full body).
@@ -2275,14 +2337,16 @@ void HttpServer::Proxy(const std::string& route_pattern,
             // must honor UpstreamConfig::request_mode identically.
             router_.RouteProxyAsync(mr.method, pattern,
                 [handler](HttpRequest& request,
-                          HTTP_CALLBACKS_NAMESPACE::InterimResponseSender /*send_interim*/,
+                          HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
                           HTTP_CALLBACKS_NAMESPACE::ResourcePusher        /*push_resource*/,
                           HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
                           HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
-                    handler->Handle(request, std::move(stream_sender),
+                    handler->Handle(request, std::move(send_interim),
+                                    std::move(stream_sender),
                                     std::move(complete));
                 },
-                http::RouteOptions{found->request_mode});
+                http::RouteOptions{found->request_mode,
+                                   found->proxy.early_hints});
             // Mark the derived bare-prefix companion only for the
             // methods this proxy actually registers on it. A method
             // not in the proxy's method list should NOT yield — a
@@ -2321,6 +2385,9 @@ void HttpServer::Proxy(const std::string& route_pattern,
     // alive even if proxy_handlers_ is later overwritten), so this is
     // just for future Proxy() lookups and conflict detection.
     proxy_handlers_[handler_key] = handler;
+    if (handler_config.websocket) {
+        RegisterWsProxyPatterns(patterns_with_get, handler);
+    }
     for (const auto& m : accepted_methods) {
         registered.insert(m);
     }
@@ -2511,7 +2578,8 @@ void HttpServer::RegisterProxyRoutes() {
             upstream.port,
             upstream.tls.sni_hostname,
             upstream_manager_.get(),
-            auth_manager_.get());
+            auth_manager_.get(),
+            response_cache_);
 
         // Same HEAD policy as Proxy() — HEAD included for correct upstream semantics
         static const std::vector<std::string> DEFAULT_PROXY_METHODS =
@@ -2690,14 +2758,16 @@ void HttpServer::RegisterProxyRoutes() {
                 // upstream config requests it.
                 router_.RouteProxyAsync(mr.method, pattern,
                     [handler](HttpRequest& request,
-                              HTTP_CALLBACKS_NAMESPACE::InterimResponseSender /*send_interim*/,
+                              HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
                               HTTP_CALLBACKS_NAMESPACE::ResourcePusher        /*push_resource*/,
                               HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
                               HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
-                        handler->Handle(request, std::move(stream_sender),
+                        handler->Handle(request, std::move(send_interim),
+                                        std::move(stream_sender),
                                         std::move(complete));
                     },
-                    http::RouteOptions{upstream.request_mode});
+                    http::RouteOptions{upstream.request_mode,
+                                       upstream.proxy.early_hints});
                 if (!derived_companion.empty() && pattern == derived_companion) {
                     router_.MarkProxyCompanion(mr.method, pattern);
                 }
@@ -2724,6 +2794,9 @@ void HttpServer::RegisterProxyRoutes() {
 
         // All routes registered successfully — commit bookkeeping.
         proxy_handlers_[handler_key] = handler;
+        if (handler_config.websocket) {
+            RegisterWsProxyPatterns(patterns_with_get, handler);
+        }
         for (const auto& m : accepted_methods) {
             registered.insert(m);
         }
@@ -2779,15 +2852,20 @@ void HttpServer::Start() {
         bind_req.tag     = "bind";
         batch.push_back(std::move(bind_req));
     }
+    // One request per configured endpoint; multi-endpoint upstreams tag
+    // the extra ones "upstream:<name>#<i>" (UpstreamManager::EndpointResolveKey).
     for (const auto& u : live_config_.upstreams) {
-        NET_DNS_NAMESPACE::ResolveRequest r;
-        r.host    = u.host;
-        r.port    = u.port;
-        r.family  = live_config_.dns.lookup_family;
-        r.timeout = std::chrono::milliseconds(
-            live_config_.dns.resolve_timeout_ms);
-        r.tag     = "upstream:" + u.name;
-        batch.push_back(std::move(r));
+        const auto endpoints = u.EffectiveEndpoints();
+        for (size_t e = 0; e < endpoints.size(); ++e) {
+            NET_DNS_NAMESPACE::ResolveRequest r;
+            r.host    = endpoints[e].host;
+            r.port    = endpoints[e].port;
+            r.family  = live_config_.dns.lookup_family;
+            r.timeout = std::chrono::milliseconds(
+                live_config_.dns.resolve_timeout_ms);
+            r.tag     = "upstream:" + UpstreamManager::EndpointResolveKey(u.name, e);
+            batch.push_back(std::move(r));
+        }
     }
 
     // INVARIANT — NO MUTEX held across this call. ResolveMany blocks
@@ -2957,6 +3035,9 @@ void HttpServer::Stop() {
     // between the WS snapshot and the H2 drain snapshot. Without this, a WS
     // accepted in the gap would miss the 1001 "Going Away" close frame.
     net_server_.StopAccepting();
+    if (http3_listener_) {
+        http3_listener_->Stop();
+    }
 
     // Publish auth shutdown intent EARLY (before the protocol drain) so
     // background OIDC/JWKS retry timers and middleware-triggered kid-miss
@@ -3727,6 +3808,7 @@ void HttpServer::SetupHandlers(std::shared_ptr<HttpConnectionHandler> http_conn)
     http_conn->SetMaxBodySize(max_body_size_.load(std::memory_order_relaxed));
     http_conn->SetMaxHeaderSize(max_header_size_.load(std::memory_order_relaxed));
     http_conn->SetMaxWsMessageSize(max_ws_message_size_.load(std::memory_order_relaxed));
+    http_conn->SetWsDeflate(ws_deflate_config_, ws_deflate_budget_);
     http_conn->SetRequestTimeout(request_timeout_sec_.load(std::memory_order_relaxed));
     http_conn->SetMaxAsyncDeferredSec(
         max_async_deferred_sec_.load(std::memory_order_relaxed));
@@ -3766,8 +3848,9 @@ void HttpServer::SetupHandlers(std::shared_ptr<HttpConnectionHandler> http_conn)
             //      performs normalization, sends the bytes, and either
             //      closes or resumes parsing pipelined data.
             bool async_head_fallback = false;
+            std::string async_pattern;
             auto async_handler = router_.GetAsyncHandler(
-                request, &async_head_fallback);
+                request, &async_head_fallback, &async_pattern);
             if (async_handler) {
                 bool mw_ok = router_.RunMiddleware(request, response);
                 if (!mw_ok) {
@@ -4104,6 +4187,13 @@ void HttpServer::SetupHandlers(std::shared_ptr<HttpConnectionHandler> http_conn)
                 auto stream_sender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender(
                     std::make_shared<MiddlewareMergingStreamSenderImpl>(
                         std::move(raw_stream_sender), mw_headers));
+                // Route-declared 103 Early Hints: middleware has accepted
+                // the request, the handler has not started — the client
+                // can begin preloading while the handler / upstream works.
+                HTTP_EARLY_HINTS_NAMESPACE::Send(
+                    send_interim,
+                    router_.GetEarlyHints(request.method, async_head_fallback,
+                                          async_pattern));
                 try {
                     if (async_head_fallback) {
                         HttpRequest get_req = request;
@@ -4402,7 +4492,37 @@ void HttpServer::SetupHandlers(std::shared_ptr<HttpConnectionHandler> http_conn)
     http_conn->SetRouteCheckCallback(
         [this](HttpRequest& request) -> bool {
             auto handler = router_.GetWebSocketHandler(request);
-            return handler != nullptr;
+            if (handler) return true;
+            // WebSocket proxy routes exist too; populate their params
+            // (strip_prefix reads the catch-all tail).
+            std::unordered_map<std::string, std::string> params;
+            if (ws_proxy_trie_.Search(request.path, params).handler) {
+                request.params = std::move(params);
+                return true;
+            }
+            return false;
+        }
+    );
+
+    // WebSocket proxy: hand the upgrade to the route's ProxyHandler,
+    // which answers it asynchronously with the upstream's reply. Local
+    // WebSocket() routes win on overlapping paths.
+    http_conn->SetWsTunnelCallback(
+        [this](std::shared_ptr<HttpConnectionHandler> self,
+               HttpRequest& request) -> bool {
+            if (router_.GetWebSocketHandler(request)) return false;
+            std::unordered_map<std::string, std::string> params;
+            auto result = ws_proxy_trie_.Search(request.path, params);
+            if (!result.handler) return false;
+            request.params = std::move(params);
+            auto handler = *result.handler;
+            // Same legacy /stats accounting as the local upgrade
+            // callback: the connection leaves the HTTP/1 count now and
+            // RemoveConnection must not decrement it again.
+            active_http1_connections_.fetch_sub(1, std::memory_order_relaxed);
+            self->MarkLegacyH1StatsDecremented();
+            handler->HandleWebSocket(self, request, ws_tunnel_context_);
+            return true;
         }
     );
 
@@ -4465,6 +4585,26 @@ void HttpServer::SafeNotifyWsClose(const std::shared_ptr<HttpConnectionHandler>&
             logging::Get()->error("Exception in WS close handler: {}", e.what());
         }
     }
+    http_conn->NotifyWsTunnelClose();
+}
+
+void HttpServer::RegisterWsProxyPatterns(
+        const std::unordered_set<std::string>& patterns,
+        const std::shared_ptr<ProxyHandler>& handler) {
+    for (const auto& pattern : patterns) {
+        try {
+            ws_proxy_trie_.Insert(pattern, handler);
+        } catch (const std::invalid_argument& e) {
+            // Already claimed by another websocket proxy registration;
+            // the first one keeps the upgrade path.
+            logging::Get()->warn("WebSocket proxy route {} not registered "
+                                 "for {}: {}", pattern,
+                                 handler->service_name(), e.what());
+            continue;
+        }
+        logging::Get()->info("WebSocket proxy route registered: {} -> {}",
+                             pattern, handler->service_name());
+    }
 }
 
 void HttpServer::HandleNewConnection(std::shared_ptr<ConnectionHandler> conn) {
@@ -5022,8 +5162,9 @@ void HttpServer::SetupH2Handlers(std::shared_ptr<Http2ConnectionHandler> h2_conn
             // the async operation is naturally protected during shutdown
             // without needing shutdown_exempt_ bookkeeping.
             bool async_head_fallback = false;
+            std::string async_pattern;
             auto async_handler = router_.GetAsyncHandler(
-                request, &async_head_fallback);
+                request, &async_head_fallback, &async_pattern);
             if (async_handler) {
                 if (!router_.RunMiddleware(request, response)) {
                     HttpRouter::FillDefaultRejectionResponse(response);
@@ -5305,6 +5446,11 @@ void HttpServer::SetupH2Handlers(std::shared_ptr<Http2ConnectionHandler> h2_conn
                 auto stream_sender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender(
                     std::make_shared<MiddlewareMergingStreamSenderImpl>(
                         std::move(raw_stream_sender), mw_headers));
+                // Route-declared 103 Early Hints (see the H1 path).
+                HTTP_EARLY_HINTS_NAMESPACE::Send(
+                    send_interim,
+                    router_.GetEarlyHints(request.method, async_head_fallback,
+                                          async_pattern));
                 try {
                     if (async_head_fallback) {
                         HttpRequest get_req = request;
@@ -5637,6 +5783,157 @@ void HttpServer::SetupH2Handlers(std::shared_ptr<Http2ConnectionHandler> h2_conn
     );
 }
 
+void HttpServer::StartHttp3Listener() {
+    if (!bind_resolved_) return;
+    Http3Listener::Options opts;
+    opts.max_datagram_size = http3_config_.max_datagram_size;
+    opts.recv_batch_size   = http3_config_.recv_batch_size;
+    opts.max_body_size     = max_body_size_.load(std::memory_order_relaxed);
+    InetAddr addr = bind_resolved_->addr;
+    addr.SetPort(static_cast<uint16_t>(
+        http3_config_.port > 0 ? http3_config_.port : bind_resolved_->port));
+    auto listener = std::make_unique<Http3Listener>(
+        net_server_.GetSocketDispatchers(), opts);
+    listener->SetRequestCallback(
+        [this](HttpRequest& request, Http3Listener::ResponseCallback respond) {
+            HandleHttp3Request(request, std::move(respond));
+        });
+    try {
+        listener->Start(addr);
+    } catch (const std::exception& e) {
+        // Experimental transport: a UDP bind failure must not take the
+        // TCP listener down with it.
+        logging::Get()->error("HTTP/3 listener disabled: {}", e.what());
+        return;
+    }
+    http3_listener_ = std::move(listener);
+}
+
+void HttpServer::HandleHttp3Request(HttpRequest& request,
+                                     Http3Listener::ResponseCallback respond) {
+    total_requests_.fetch_add(1, std::memory_order_relaxed);
+    active_requests_->fetch_add(1, std::memory_order_relaxed);
+    RequestGuard guard{active_requests_};
+    HttpResponse response;
+
+    // Middleware rejections and sync routes share this tail.
+    auto send_sync = [&](std::string error_type) {
+        FinalizeIfSnapshot(request, response, std::move(error_type));
+        respond(std::move(response));
+    };
+    // HTTP/3 has no suspend/resume trampoline yet, so async middleware that
+    // cannot complete inline is answered like the H1/H2 async-route warmup
+    // case: 503 + Retry-After and let the cache populate.
+    // Returns true when the request was answered here.
+    auto run_async_middleware = [&]() -> bool {
+        std::shared_ptr<HttpRouter::AsyncPendingState> mw_state;
+        if (!router_.RunAsyncMiddleware(request, response, mw_state)) {
+            response = HttpResponse();
+            response.Status(HttpStatus::SERVICE_UNAVAILABLE)
+                    .Header("Retry-After", "1")
+                    .Header("Cache-Control", "no-store")
+                    .Text("authentication unavailable — retry");
+            if (auth_manager_ && !auth_config_.issuers.empty()) {
+                auth_manager_->RecordVerdict(
+                    response, AUTH_NAMESPACE::VerifyOutcome::UNDETERMINED,
+                    /*issuer=*/std::string{},
+                    /*policy=*/std::string{},
+                    AUTH_NAMESPACE::AuthCache::None);
+            }
+            send_sync("async_route_warmup_unavailable");
+            return true;
+        }
+        if (mw_state && mw_state->sync_result() ==
+                HttpRouter::AsyncMiddlewareResult::DENY) {
+            send_sync("rejected_by_async_middleware");
+            return true;
+        }
+        return false;
+    };
+
+    bool async_head_fallback = false;
+    auto async_handler = router_.GetAsyncHandler(request, &async_head_fallback);
+    if (!router_.RunMiddleware(request, response)) {
+        HttpRouter::FillDefaultRejectionResponse(response);
+        send_sync("rejected_by_middleware");
+        return;
+    }
+    if (run_async_middleware()) return;
+
+    if (!async_handler) {
+        const auto auth_hdrs = CaptureDebugAuthHeaders(response);
+        if (!router_.DispatchHandler(request, response)) {
+            response.Status(HttpStatus::NOT_FOUND).Text("Not Found");
+        }
+        RestoreDebugAuthHeaders(response, auth_hdrs);
+        send_sync(std::string{});
+        return;
+    }
+
+    auto mw_headers = response.GetHeaders();
+    auto active_counter = active_requests_;
+    auto bookkeeping_done = std::make_shared<std::atomic<bool>>(false);
+    auto obs_snap_local = request.obs_snapshot;
+    const bool was_head_local = (request.method == "HEAD");
+    auto cancel_slot = std::make_shared<std::function<void()>>();
+    request.async_cancel_slot = cancel_slot;
+
+    // Single delivery point for both the buffered completion and the
+    // buffering stream sender. `respond` is itself one-shot; the
+    // bookkeeping flag keeps active_requests_ exact when both race.
+    auto deliver = [respond, active_counter, bookkeeping_done,
+                    obs_snap_local, was_head_local](HttpResponse final_resp) {
+        if (bookkeeping_done->exchange(true, std::memory_order_acq_rel)) return;
+        if (obs_snap_local) {
+            if (auto mgr = obs_snap_local->manager.lock()) {
+                mgr->FinalizeFromSnapshot(
+                    *obs_snap_local, final_resp.GetStatusCode(),
+                    ObsWireBodySize(final_resp, was_head_local),
+                    /*error_type=*/std::string{});
+            }
+        }
+        respond(std::move(final_resp));
+        active_counter->fetch_sub(1, std::memory_order_relaxed);
+    };
+    HttpRouter::AsyncCompletionCallback complete =
+        [deliver, mw_headers](HttpResponse final_resp) {
+            deliver(MergeAsyncResponseHeaders(final_resp, mw_headers));
+        };
+    // 1xx interims and pushes have no carrier on this transport.
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim =
+        [](int, const std::vector<std::pair<std::string, std::string>>&) {};
+    HTTP_CALLBACKS_NAMESPACE::ResourcePusher push_resource =
+        [](const std::string&, const std::string&, const std::string&,
+           const std::string&, const HttpResponse&) -> int32_t { return -1; };
+    auto stream_sender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender(
+        std::make_shared<MiddlewareMergingStreamSenderImpl>(
+            Http3Listener::MakeBufferedStreamSender(
+                request.owning_dispatcher, deliver),
+            mw_headers));
+
+    try {
+        if (async_head_fallback) {
+            HttpRequest get_req = request;
+            get_req.method = "GET";
+            async_handler(get_req, send_interim, push_resource,
+                          stream_sender, std::move(complete));
+        } else {
+            async_handler(request, send_interim, push_resource,
+                          stream_sender, std::move(complete));
+        }
+    } catch (const std::exception& e) {
+        logging::Get()->error("HTTP/3 async handler threw: {}", e.what());
+        if (*cancel_slot) {
+            auto local = std::move(*cancel_slot);
+            *cancel_slot = nullptr;
+            try { local(); } catch (...) {}
+        }
+        deliver(HttpResponse::InternalError());
+    }
+    // The completion path owns the active_requests_ decrement from here.
+    guard.release();
+}
+
 HttpServer::ConnectionSnapshot HttpServer::SnapshotConnections() {
     ConnectionSnapshot snap;
     std::lock_guard<std::mutex> lck(conn_mtx_);
@@ -5959,14 +6256,18 @@ bool HttpServer::Reload(ServerConfig new_config) {
         std::vector<NET_DNS_NAMESPACE::ResolveRequest> batch;
         batch.reserve(live_config_.upstreams.size());
         for (const auto& u : live_config_.upstreams) {
-            NET_DNS_NAMESPACE::ResolveRequest r;
-            r.host    = u.host;
-            r.port    = u.port;
-            r.family  = live_config_.dns.lookup_family;  // restart-only
-            r.timeout = std::chrono::milliseconds(
-                new_config.dns.resolve_timeout_ms);       // hot-reloadable
-            r.tag     = "upstream:" + u.name;
-            batch.push_back(std::move(r));
+            const auto endpoints = u.EffectiveEndpoints();
+            for (size_t e = 0; e < endpoints.size(); ++e) {
+                NET_DNS_NAMESPACE::ResolveRequest r;
+                r.host    = endpoints[e].host;
+                r.port    = endpoints[e].port;
+                r.family  = live_config_.dns.lookup_family;  // restart-only
+                r.timeout = std::chrono::milliseconds(
+                    new_config.dns.resolve_timeout_ms);       // hot-reloadable
+                r.tag     = "upstream:" +
+                            UpstreamManager::EndpointResolveKey(u.name, e);
+                batch.push_back(std::move(r));
+            }
         }
 
         // dns_results / dns_merged / local_stale are valid only when the
@@ -6145,6 +6446,10 @@ bool HttpServer::Reload(ServerConfig new_config) {
     if (circuit_breaker_manager_) {
         circuit_breaker_manager_->Reload(new_config.upstreams);
     }
+    // Outlier detection rides on the breaker block; same live contract.
+    if (upstream_manager_) {
+        upstream_manager_->ReloadOutlierDetection(new_config.upstreams);
+    }
 
     // Three-phase update to prevent mid-reload connections from seeing
     // inconsistent cap vs limits:
@@ -6379,6 +6684,7 @@ bool HttpServer::Reload(ServerConfig new_config) {
         // keep the value they were created with — RFC 9113 §6.5.2 forbids
         // a server from sending ENABLE_PUSH after the preface.
         h2_settings_.enable_push            = new_config.http2.enable_push;
+        h2_settings_.write_batching         = new_config.http2.write_batching;
         // Persist so GetLiveConfigSnapshot() returns the applied settings.
         live_config_.http2 = new_config.http2;
     }
@@ -6388,6 +6694,20 @@ bool HttpServer::Reload(ServerConfig new_config) {
     // field discipline used for size limits above.
     live_config_.http1.streaming = new_config.http1.streaming;
 
+    // TLS session ticket keys rotate on every reload: the configured key
+    // file is re-read, or a fresh in-process key takes over encryption.
+    // The tls.* block itself is restart-only. A bad key file keeps the
+    // current keys in force rather than failing live-safe edits.
+    if (tls_ctx_) {
+        try {
+            tls_ctx_->RotateTicketKeys();
+        } catch (const std::exception& e) {
+            logging::Get()->error(
+                "Reload: TLS ticket key rotation failed, keeping current "
+                "keys: {}", e.what());
+        }
+    }
+
     // Rate limit reload — always safe because manager is always created
     if (rate_limit_manager_) {
         rate_limit_manager_->Reload(new_config.rate_limit);
@@ -6408,6 +6728,10 @@ bool HttpServer::Reload(ServerConfig new_config) {
     if (circuit_breaker_manager_) {
         circuit_breaker_manager_->Reload(new_config.upstreams);
     }
+    // Outlier detection rides on the breaker block; same live contract.
+    if (upstream_manager_) {
+        upstream_manager_->ReloadOutlierDetection(new_config.upstreams);
+    }
 
     // H2 sub-config live propagation. Topology (added/removed upstreams)
     // is restart-required, so live partitions only see commits for
@@ -6675,6 +6999,20 @@ HttpServer::ServerStats HttpServer::GetStats() const {
     stats.idle_timeout_sec    = static_cast<int>(net_server_.GetConnectionTimeout().count());
     stats.request_timeout_sec = request_timeout_sec_.load(std::memory_order_relaxed);
     stats.worker_threads      = resolved_worker_threads_;
+    stats.ws_tunnels_active   = ws_tunnel_context_->active.load(std::memory_order_relaxed);
+    stats.ws_tunnels_total    = ws_tunnel_context_->total.load(std::memory_order_relaxed);
+    stats.ws_tunnel_bytes_to_upstream =
+        ws_tunnel_context_->bytes_to_upstream.load(std::memory_order_relaxed);
+    stats.ws_tunnel_bytes_to_client =
+        ws_tunnel_context_->bytes_to_client.load(std::memory_order_relaxed);
+    if (const TlsKeyOffloader* offload =
+            tls_ctx_ ? tls_ctx_->KeyOffloader() : nullptr) {
+        stats.tls_offload_threads   = offload->threads();
+        stats.tls_offload_submitted = offload->submitted();
+        stats.tls_offload_completed = offload->completed();
+        stats.tls_offload_cancelled = offload->cancelled();
+        stats.tls_offload_in_flight = offload->in_flight();
+    }
     return stats;
 }
 
@@ -6701,37 +7039,43 @@ HttpServer::GetUpstreamResolvedSnapshot() const {
 
     // Walk upstream_configs_ to preserve declaration order and include
     // upstreams whose DNS resolution is absent (not yet resolved).
+    // Multi-endpoint upstreams get one entry per endpoint, named by
+    // their resolve key ("<name>#<i>" after the first).
     for (const auto& cfg : upstream_configs_) {
-        UpstreamResolvedEntry e;
-        e.service_name = cfg.name;
-        e.host_bare    = cfg.host;
-
-        auto it = upstream_resolved_.find(cfg.name);
-        if (it != upstream_resolved_.end() && it->second) {
-            const auto& ep = *it->second;
-            e.resolved_ip        = ep.addr.Ip();
-            e.resolved_authority = ep.addr.ToString();
-            e.resolved_family    =
-                (ep.addr.family() == InetAddr::Family::kIPv6) ? "v6" : "v4";
-            e.age_seconds = std::chrono::duration_cast<std::chrono::seconds>(
-                now - ep.resolved_at).count();
-        } else {
-            // No resolved entry: report empty fields and negative age.
-            e.resolved_ip        = "";
-            e.resolved_authority = "";
-            e.resolved_family    = "";
-            e.age_seconds        = -1;
-        }
-
-        auto rs_it = upstream_reresolve_status_.find(cfg.name);
-        if (rs_it != upstream_reresolve_status_.end()) {
-            e.last_reresolve_succeeded = rs_it->second.succeeded;
-            if (!rs_it->second.error_message.empty()) {
-                e.last_reresolve_error = rs_it->second.error_message;
+        const auto endpoints = cfg.EffectiveEndpoints();
+        for (size_t idx = 0; idx < endpoints.size(); ++idx) {
+            const std::string key = UpstreamManager::EndpointResolveKey(cfg.name, idx);
+            UpstreamResolvedEntry e;
+            e.service_name = key;
+            e.host_bare    = cfg.endpoints.empty() ? cfg.host : endpoints[idx].host;
+
+            auto it = upstream_resolved_.find(key);
+            if (it != upstream_resolved_.end() && it->second) {
+                const auto& ep = *it->second;
+                e.resolved_ip        = ep.addr.Ip();
+                e.resolved_authority = ep.addr.ToString();
+                e.resolved_family    =
+                    (ep.addr.family() == InetAddr::Family::kIPv6) ? "v6" : "v4";
+                e.age_seconds = std::chrono::duration_cast<std::chrono::seconds>(
+                    now - ep.resolved_at).count();
+            } else {
+                // No resolved entry: report empty fields and negative age.
+                e.resolved_ip        = "";
+                e.resolved_authority = "";
+                e.resolved_family    = "";
+                e.age_seconds        = -1;
+            }
+
+            auto rs_it = upstream_reresolve_status_.find(key);
+            if (rs_it != upstream_reresolve_status_.end()) {
+                e.last_reresolve_succeeded = rs_it->second.succeeded;
+                if (!rs_it->second.error_message.empty()) {
+                    e.last_reresolve_error = rs_it->second.error_message;
+                }
             }
-        }
 
-        result.push_back(std::move(e));
+            result.push_back(std::move(e));
+        }
     }
     return result;
 }
@@ -0,0 +1,238 @@
+#include "upstream/load_balancer.h"
+
+#include <limits>
+
+namespace {
+
+// splitmix64 finalizer: spreads FNV's weak low bits before the modulo
+// and ring lookups.
+uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t NextRandom(uint64_t& s) {
+    // xorshift64*; the state is seeded non-zero by MakeState.
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 0x2545f4914f6cdd1dULL;
+}
+
+}  // namespace
+
+bool LoadBalancer::ParsePolicy(const std::string& name, Policy* out) {
+    if (name == "round_robin")   { *out = Policy::ROUND_ROBIN;   return true; }
+    if (name == "weighted")      { *out = Policy::WEIGHTED;      return true; }
+    if (name == "least_request") { *out = Policy::LEAST_REQUEST; return true; }
+    if (name == "ring_hash")     { *out = Policy::RING_HASH;     return true; }
+    if (name == "maglev")        { *out = Policy::MAGLEV;        return true; }
+    return false;
+}
+
+uint64_t LoadBalancer::Hash(const std::string& data) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    h = Mix(h);
+    return h == 0 ? 1 : h;
+}
+
+LoadBalancer::LoadBalancer(Policy policy, std::vector<Member> members)
+    : policy_(policy), members_(std::move(members))
+{
+    if (members_.empty()) {
+        throw std::invalid_argument("LoadBalancer needs at least one member");
+    }
+    for (auto& m : members_) {
+        if (m.weight < 1) m.weight = 1;
+        total_weight_ += m.weight;
+    }
+    if (policy_ == Policy::RING_HASH) {
+        BuildRing();
+    } else if (policy_ == Policy::MAGLEV) {
+        BuildMaglev();
+    }
+}
+
+LoadBalancer::State LoadBalancer::MakeState(size_t seed) const {
+    State s;
+    // Start dispatchers at different members so a burst spread across
+    // dispatchers doesn't land on member 0 everywhere.
+    s.cursor = seed;
+    s.rng = Mix(static_cast<uint64_t>(seed) + 0x9e3779b97f4a7c15ULL) | 1;
+    if (policy_ == Policy::WEIGHTED) s.credits.assign(members_.size(), 0);
+    return s;
+}
+
+size_t LoadBalancer::Pick(State& state, uint64_t hash,
+                          const std::function<int64_t(size_t)>& load,
+                          const std::function<bool(size_t)>& eligible) const {
+    const size_t n = members_.size();
+    if (n == 1) return 0;
+    // Nothing eligible: spread over everyone as if all were healthy. A
+    // health-check outage must not take the whole upstream down with it.
+    static const std::function<bool(size_t)> kAll;
+    const std::function<bool(size_t)>* filter = &eligible;
+    if (eligible) {
+        bool any = false;
+        for (size_t i = 0; i < n && !any; ++i) any = eligible(i);
+        if (!any) filter = &kAll;
+    }
+    switch (policy_) {
+        case Policy::WEIGHTED:
+            return PickWeighted(state, *filter);
+        case Policy::LEAST_REQUEST:
+            return PickLeastRequest(state, load, *filter);
+        case Policy::RING_HASH:
+            if (hash != 0) return PickRing(hash, *filter);
+            break;
+        case Policy::MAGLEV:
+            if (hash != 0) return PickMaglev(hash, *filter);
+            break;
+        case Policy::ROUND_ROBIN:
+            break;
+    }
+    return PickRoundRobin(state, *filter);
+}
+
+size_t LoadBalancer::PickRoundRobin(
+        State& state, const std::function<bool(size_t)>& eligible) const {
+    const size_t n = members_.size();
+    for (size_t tries = 0; tries < n; ++tries) {
+        const size_t i = static_cast<size_t>(state.cursor++ % n);
+        if (!eligible || eligible(i)) return i;
+    }
+    return static_cast<size_t>(state.cursor % n);
+}
+
+size_t LoadBalancer::PickWeighted(
+        State& state, const std::function<bool(size_t)>& eligible) const {
+    // Smooth weighted round-robin: every member earns its weight, the
+    // richest is picked and pays the total. Interleaves heavy members
+    // instead of sending them runs of consecutive requests. Excluded
+    // members neither earn nor count towards the total, so the split
+    // among the rest keeps their relative weights.
+    size_t best = members_.size();
+    int64_t total = 0;
+    for (size_t i = 0; i < members_.size(); ++i) {
+        if (eligible && !eligible(i)) continue;
+        state.credits[i] += members_[i].weight;
+        total += members_[i].weight;
+        if (best == members_.size() || state.credits[i] > state.credits[best]) {
+            best = i;
+        }
+    }
+    state.credits[best] -= total;
+    return best;
+}
+
+size_t LoadBalancer::PickLeastRequest(
+        State& state, const std::function<int64_t(size_t)>& load,
+        const std::function<bool(size_t)>& eligible) const {
+    size_t n = members_.size();
+    // Draw from the eligible subset when some members are excluded.
+    std::vector<size_t> pool;
+    if (eligible) {
+        for (size_t i = 0; i < members_.size(); ++i) {
+            if (eligible(i)) pool.push_back(i);
+        }
+        n = pool.size();
+        if (n == 1) return pool[0];
+    }
+    size_t a = static_cast<size_t>(NextRandom(state.rng) % n);
+    size_t b = static_cast<size_t>(NextRandom(state.rng) % (n - 1));
+    if (b >= a) ++b;
+    if (!pool.empty()) {
+        a = pool[a];
+        b = pool[b];
+    }
+    if (!load) return a;
+    // Compare outstanding / weight without division: (la+1)/wa vs (lb+1)/wb.
+    const int64_t la = load(a) + 1;
+    const int64_t lb = load(b) + 1;
+    return la * members_[b].weight <= lb * members_[a].weight ? a : b;
+}
+
+size_t LoadBalancer::PickRing(
+        uint64_t hash, const std::function<bool(size_t)>& eligible) const {
+    auto it = std::lower_bound(
+        ring_.begin(), ring_.end(), hash,
+        [](const std::pair<uint64_t, uint32_t>& e, uint64_t h) {
+            return e.first < h;
+        });
+    if (it == ring_.end()) it = ring_.begin();
+    // Walk clockwise past excluded members' points.
+    for (size_t steps = 0; eligible && steps < ring_.size(); ++steps) {
+        if (eligible(it->second)) break;
+        if (++it == ring_.end()) it = ring_.begin();
+    }
+    return it->second;
+}
+
+size_t LoadBalancer::PickMaglev(
+        uint64_t hash, const std::function<bool(size_t)>& eligible) const {
+    size_t slot = static_cast<size_t>(hash % maglev_.size());
+    // Excluded members' slots fall through to the next slot's owner,
+    // which spreads their keys over the survivors roughly evenly.
+    for (size_t steps = 0; eligible && steps < maglev_.size(); ++steps) {
+        if (eligible(maglev_[slot])) break;
+        if (++slot == maglev_.size()) slot = 0;
+    }
+    return maglev_[slot];
+}
+
+void LoadBalancer::BuildRing() {
+    for (size_t i = 0; i < members_.size(); ++i) {
+        const size_t replicas =
+            static_cast<size_t>(members_[i].weight) * RING_POINTS_PER_WEIGHT;
+        for (size_t r = 0; r < replicas; ++r) {
+            ring_.emplace_back(Hash(members_[i].key + "_" + std::to_string(r)),
+                               static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(ring_.begin(), ring_.end());
+}
+
+void LoadBalancer::BuildMaglev() {
+    // Maglev population (Eisenbud et al., NSDI '16 §3.4): each member walks
+    // its own permutation of the table and claims the next free slot when
+    // it has a turn. Turns are handed out in proportion to weight: the
+    // heaviest member claims one slot per round, the others accumulate
+    // weight/max_weight of a slot per round.
+    const size_t m = MAGLEV_TABLE_SIZE;
+    const size_t n = members_.size();
+    std::vector<uint64_t> offset(n), skip(n), next(n, 0);
+    std::vector<double> credit(n, 0.0);
+    int max_weight = 1;
+    for (size_t i = 0; i < n; ++i) {
+        offset[i] = Hash(members_[i].key) % m;
+        skip[i] = Hash(members_[i].key + "#skip") % (m - 1) + 1;
+        max_weight = std::max(max_weight, members_[i].weight);
+    }
+    const uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+    maglev_.assign(m, kEmpty);
+    size_t filled = 0;
+    while (filled < m) {
+        for (size_t i = 0; i < n && filled < m; ++i) {
+            credit[i] += static_cast<double>(members_[i].weight) / max_weight;
+            while (credit[i] >= 1.0 && filled < m) {
+                size_t c = (offset[i] + next[i] * skip[i]) % m;
+                while (maglev_[c] != kEmpty) {
+                    ++next[i];
+                    c = (offset[i] + next[i] * skip[i]) % m;
+                }
+                maglev_[c] = static_cast<uint32_t>(i);
+                ++next[i];
+                ++filled;
+                credit[i] -= 1.0;
+            }
+        }
+    }
+}
@@ -480,6 +480,26 @@ MakeStatsHandler(HttpServer* server, const ServerConfig& config) {
                 h2["preconnect_skipped_cap"] =
                     upm->h2_preconnect_skipped_cap_count();
                 root["h2_upstream"] = std::move(h2);
+
+                nlohmann::json utls;
+                utls["handshakes_full"] = upm->tls_handshakes_full();
+                utls["handshakes_resumed"] = upm->tls_handshakes_resumed();
+                root["upstream_tls"] = std::move(utls);
+            }
+            nlohmann::json wst;
+            wst["active"] = stats.ws_tunnels_active;
+            wst["total"] = stats.ws_tunnels_total;
+            wst["bytes_to_upstream"] = stats.ws_tunnel_bytes_to_upstream;
+            wst["bytes_to_client"] = stats.ws_tunnel_bytes_to_client;
+            root["websocket_proxy"] = std::move(wst);
+            if (stats.tls_offload_threads > 0) {
+                nlohmann::json tko;
+                tko["threads"] = stats.tls_offload_threads;
+                tko["submitted"] = stats.tls_offload_submitted;
+                tko["completed"] = stats.tls_offload_completed;
+                tko["cancelled"] = stats.tls_offload_cancelled;
+                tko["in_flight"] = stats.tls_offload_in_flight;
+                root["tls_key_offload"] = std::move(tko);
             }
             // Render the JSON, then re-open the trailing '}' so
             // AppendAuthSnapshot can splice in the auth fields without
@@ -608,10 +628,32 @@ static bool ReloadConfig(const std::string& config_path,
     if (new_config.tls.enabled != current_config.tls.enabled ||
         new_config.tls.cert_file != current_config.tls.cert_file ||
         new_config.tls.key_file != current_config.tls.key_file ||
-        new_config.tls.min_version != current_config.tls.min_version)
+        new_config.tls.min_version != current_config.tls.min_version ||
+        new_config.tls.session_tickets != current_config.tls.session_tickets ||
+        new_config.tls.ticket_key_file != current_config.tls.ticket_key_file ||
+        new_config.tls.session_cache_size != current_config.tls.session_cache_size ||
+        new_config.tls.session_timeout_sec != current_config.tls.session_timeout_sec ||
+        new_config.tls.ktls != current_config.tls.ktls ||
+        new_config.tls.handshake_offload_threads !=
+            current_config.tls.handshake_offload_threads ||
+        new_config.tls.record_sizing != current_config.tls.record_sizing ||
+        new_config.tls.record_size_initial != current_config.tls.record_size_initial ||
+        new_config.tls.record_size_ramp_bytes != current_config.tls.record_size_ramp_bytes ||
+        new_config.tls.record_size_idle_reset_ms !=
+            current_config.tls.record_size_idle_reset_ms)
         logging::Get()->warn("tls.* changed — requires restart, ignored");
     if (new_config.http2.enabled != current_config.http2.enabled)
         logging::Get()->warn("http2.enabled changed — requires restart, ignored");
+    if (new_config.http3.enabled != current_config.http3.enabled ||
+        new_config.http3.port != current_config.http3.port ||
+        new_config.http3.max_datagram_size != current_config.http3.max_datagram_size ||
+        new_config.http3.recv_batch_size != current_config.http3.recv_batch_size)
+        logging::Get()->warn("http3.* changed — requires restart, ignored");
+    if (new_config.websocket.permessage_deflate !=
+        current_config.websocket.permessage_deflate)
+        logging::Get()->warn("websocket.permessage_deflate.* changed — requires restart, ignored");
+    if (new_config.proxy_cache != current_config.proxy_cache)
+        logging::Get()->warn("proxy_cache.* changed — requires restart, ignored");
 
     // Validate log directory BEFORE applying any changes — if this fails,
     // nothing is mutated (no partial state).
@@ -819,6 +861,9 @@ static bool ReloadConfig(const std::string& config_path,
     auto saved_tls = current_config.tls;
     auto saved_workers = current_config.worker_threads;
     auto saved_h2_enabled = current_config.http2.enabled;
+    auto saved_http3 = current_config.http3;
+    auto saved_websocket = current_config.websocket;
+    auto saved_proxy_cache = current_config.proxy_cache;
     // Preserve upstreams for the same reason: HttpServer::Reload treats
     // the whole upstream block as restart-required (see http_server.cc
     // upstream_configs_ comparison), and that internal copy never changes
@@ -866,6 +911,9 @@ static bool ReloadConfig(const std::string& config_path,
     current_config.tls = saved_tls;
     current_config.worker_threads = saved_workers;
     current_config.http2.enabled = saved_h2_enabled;
+    current_config.http3 = saved_http3;
+    current_config.websocket = saved_websocket;
+    current_config.proxy_cache = saved_proxy_cache;
     current_config.upstreams = std::move(saved_upstreams);
 
     current_config.observability.enabled = saved_obs_enabled;
@@ -919,7 +967,8 @@ static int ValidateDaemonConfig(const ServerConfig& config,
     }
     if (config.tls.enabled) {
         if (!RequireAbsolutePath(config.tls.cert_file, "TLS cert file") ||
-            !RequireAbsolutePath(config.tls.key_file, "TLS key file")) {
+            !RequireAbsolutePath(config.tls.key_file, "TLS key file") ||
+            !RequireAbsolutePath(config.tls.ticket_key_file, "TLS ticket key file")) {
             return EXIT_ERROR;
         }
     }
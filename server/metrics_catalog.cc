@@ -98,12 +98,26 @@ void MetricsCatalog::Build(ObservabilityManager& manager, MetricsCatalog& out) {
         MakeCatalog({}));
 
     // TLS handshake event counter — `outcome` is a closed vocabulary
-    // {success, failure}. Cap=2 documents the bound.
+    // {success, failure}; `mode` ∈ {full, resumed} rides on successes
+    // only (a failed handshake never got far enough to resume). Cap=2
+    // documents both bounds.
     out.reactor_tls_handshakes = meter->GetCounter(
         "reactor.tls.handshakes",
         "TLS handshake outcomes",
         "{handshakes}",
-        MakeCatalog({"outcome"}, {{"outcome", 2}}));
+        MakeCatalog({"outcome", "mode"}, {{"outcome", 2}, {"mode", 2}}));
+
+    out.reactor_tls_handshakes_queued = meter->GetUpDownCounter(
+        "reactor.tls.handshakes.queued",
+        "TLS handshakes waiting on an offloaded private-key operation",
+        "{handshakes}",
+        MakeCatalog({}));
+
+    out.reactor_tls_records = meter->GetCounter(
+        "reactor.tls.records",
+        "TLS records written, by record size class",
+        "{records}",
+        MakeCatalog({"size"}, {{"size", 2}}));
 
     // Client / upstream pool ----------------------------------------
     // Defense-in-depth: keys whose values come from operator config
@@ -126,6 +140,19 @@ void MetricsCatalog::Build(ObservabilityManager& manager, MetricsCatalog& out) {
                       {"error.type",              kDefaultGenericCap},
                       {"reactor.upstream.service", kDefaultGenericCap}}));
 
+    out.rpc_client_duration = meter->GetHistogram(
+        "rpc.client.duration",
+        "Upstream gRPC call latency in seconds",
+        "s",
+        ToVec(kLatencyBuckets),
+        MakeCatalog({"rpc.system", "rpc.service", "rpc.method",
+                       "rpc.grpc.status_code", "error.type",
+                       "reactor.upstream.service"},
+                     {{"rpc.service",              kDefaultGenericCap},
+                      {"rpc.method",               kDefaultGenericCap},
+                      {"error.type",               kDefaultGenericCap},
+                      {"reactor.upstream.service", kDefaultGenericCap}}));
+
     out.http_client_active_requests = meter->GetUpDownCounter(
         "http.client.active_requests",
         "In-flight upstream requests",
@@ -166,6 +193,57 @@ void MetricsCatalog::Build(ObservabilityManager& manager, MetricsCatalog& out) {
                      {{"reactor.upstream.service", kDefaultGenericCap},
                       {"outcome", 8}}));
 
+    // New pool connections — `reason` ∈ {checkout, prewarm}: a checkout
+    // that found no idle connection and waited on the connect, or a
+    // connect opened ahead of demand (pool.min_idle_connections).
+    out.reactor_upstream_pool_connects = meter->GetCounter(
+        "reactor.upstream.pool.connects",
+        "New upstream pool connections by reason",
+        "{connections}",
+        MakeCatalog({"reactor.upstream.service", "reason"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"reason", 2}}));
+
+    // Upstream TLS handshakes — `mode` ∈ {full, resumed}; resumed means
+    // the partition's session cache supplied the session.
+    out.reactor_upstream_tls_handshakes = meter->GetCounter(
+        "reactor.upstream.tls.handshakes",
+        "Completed upstream TLS handshakes",
+        "{handshakes}",
+        MakeCatalog({"reactor.upstream.service", "mode"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"mode", 2}}));
+
+    // Active upstream health checks — `outcome` ∈ {success, failure}
+    // (skipped checks are not counted); transitions carry the endpoint
+    // "ip:port" (operator-config-bounded) and `to` ∈ {healthy, unhealthy}.
+    out.reactor_upstream_health_checks = meter->GetCounter(
+        "reactor.upstream.health.checks",
+        "Completed active upstream health checks",
+        "{checks}",
+        MakeCatalog({"reactor.upstream.service", "outcome"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"outcome", 2}}));
+    out.reactor_upstream_health_transitions = meter->GetCounter(
+        "reactor.upstream.health.transitions",
+        "Upstream endpoint health state changes",
+        "{transitions}",
+        MakeCatalog({"reactor.upstream.service", "endpoint", "to"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"endpoint", kDefaultGenericCap},
+                      {"to", 2}}));
+    // Passive outlier detection — `reason` ∈ {consecutive_5xx,
+    // success_rate, latency}; `mode` ∈ {enforced, dry_run}.
+    out.reactor_upstream_outlier_ejections = meter->GetCounter(
+        "reactor.upstream.outlier.ejections",
+        "Upstream endpoints ejected by outlier detection",
+        "{ejections}",
+        MakeCatalog({"reactor.upstream.service", "endpoint", "reason", "mode"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"endpoint", kDefaultGenericCap},
+                      {"reason", 3},
+                      {"mode", 2}}));
+
     // Middleware (auth + rate limit + circuit breaker + ws) ---------
     // `issuer` values are operator-config-bounded (issuer names from
     // auth config); explicit caps document the bound.
@@ -246,6 +324,60 @@ void MetricsCatalog::Build(ObservabilityManager& manager, MetricsCatalog& out) {
         "{frames}",
         MakeCatalog({"op", "direction"}));
 
+    out.reactor_proxy_websocket_bytes = meter->GetCounter(
+        "reactor.proxy.websocket.bytes",
+        "Bytes relayed through proxied WebSocket tunnels",
+        "By",
+        MakeCatalog({"reactor.upstream.service", "direction"},
+                     {{"reactor.upstream.service", kDefaultGenericCap}}));
+
+    out.reactor_proxy_websocket_active_tunnels = meter->GetUpDownCounter(
+        "reactor.proxy.websocket.active_tunnels",
+        "Open proxied WebSocket tunnels",
+        "{tunnels}",
+        MakeCatalog({"reactor.upstream.service"},
+                     {{"reactor.upstream.service", kDefaultGenericCap}}));
+
+    // Proxy response cache — `result` ∈ {hit, stale, revalidated,
+    // collapsed, miss, bypass}; `tier` ∈ {memory, disk}.
+    out.reactor_proxy_cache_lookups = meter->GetCounter(
+        "reactor.proxy.cache.lookups",
+        "Proxy requests on cached routes by cache outcome",
+        "{requests}",
+        MakeCatalog({"reactor.upstream.service", "result"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"result", 6}}));
+
+    out.reactor_proxy_cache_served_bytes = meter->GetCounter(
+        "reactor.proxy.cache.served_bytes",
+        "Response body bytes served from the proxy cache",
+        "By",
+        MakeCatalog({"reactor.upstream.service", "tier"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"tier", 2}}));
+
+    out.reactor_proxy_cache_origin_latency_saved = meter->GetCounter(
+        "reactor.proxy.cache.origin_latency_saved",
+        "Upstream response time avoided by serving from the proxy cache",
+        "s",
+        MakeCatalog({"reactor.upstream.service"},
+                     {{"reactor.upstream.service", kDefaultGenericCap}}));
+
+    out.reactor_proxy_singleflight_coalesced = meter->GetCounter(
+        "reactor.proxy.singleflight.coalesced",
+        "Proxy requests answered by another request's upstream transaction",
+        "{requests}",
+        MakeCatalog({"reactor.upstream.service"},
+                     {{"reactor.upstream.service", kDefaultGenericCap}}));
+
+    out.reactor_proxy_hedges = meter->GetCounter(
+        "reactor.proxy.hedges",
+        "Hedge decisions for slow proxy requests",
+        "{requests}",
+        MakeCatalog({"reactor.upstream.service", "result"},
+                     {{"reactor.upstream.service", kDefaultGenericCap},
+                      {"result", 3}}));
+
     // Self-metrics (OTel pipeline introspection) --------------------
     out.reactor_otel_spans_created = meter->GetCounter(
         "reactor.otel.spans.created",
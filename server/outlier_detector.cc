@@ -0,0 +1,344 @@
+#include "circuit_breaker/outlier_detector.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+#include "observability/counter.h"
+#include "observability/metrics_catalog.h"
+#include "observability/observability_manager.h"
+
+#include <cmath>
+
+namespace CIRCUIT_BREAKER_NAMESPACE {
+
+const char* OutlierDetector::ReasonName(Reason reason) noexcept {
+    switch (reason) {
+        case Reason::CONSECUTIVE_5XX: return "consecutive_5xx";
+        case Reason::SUCCESS_RATE:    return "success_rate";
+        case Reason::LATENCY:         return "latency";
+    }
+    return "unknown";
+}
+
+OutlierDetector::OutlierDetector(std::string service_name,
+                                 std::vector<std::string> member_labels,
+                                 size_t dispatcher_count,
+                                 const CircuitBreakerConfig& config)
+    : service_name_(std::move(service_name)),
+      member_labels_(std::move(member_labels)),
+      dispatcher_count_(dispatcher_count),
+      members_(member_labels_.size())
+{
+    slots_.reserve(members_.size() * dispatcher_count_);
+    for (size_t i = 0; i < members_.size() * dispatcher_count_; ++i) {
+        slots_.push_back(std::make_unique<Slot>(config.window_seconds));
+    }
+    Reload(config);
+}
+
+OutlierDetector::~OutlierDetector() = default;
+
+size_t OutlierDetector::LatencyBucket(int64_t latency_ms) noexcept {
+    size_t bucket = 0;
+    while (latency_ms > 0 && bucket + 1 < LATENCY_BUCKETS) {
+        latency_ms >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+std::shared_ptr<const CircuitBreakerConfig> OutlierDetector::LoadConfig() const {
+    return std::atomic_load_explicit(&config_, std::memory_order_acquire);
+}
+
+void OutlierDetector::Reload(const CircuitBreakerConfig& config) {
+    auto fresh = std::make_shared<const CircuitBreakerConfig>(config);
+    std::atomic_store_explicit(&config_, fresh, std::memory_order_release);
+    consecutive_limit_.store(config.outlier_detection.consecutive_5xx,
+                             std::memory_order_relaxed);
+    window_seconds_.store(config.window_seconds, std::memory_order_relaxed);
+    active_.store(Active(config), std::memory_order_release);
+    if (Active(config)) return;
+
+    // Detection off: nothing may stay held out of rotation by it.
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (size_t m = 0; m < members_.size(); ++m) {
+        auto& state = members_[m];
+        state.consecutive_failures.store(0, std::memory_order_relaxed);
+        state.times_ejected = 0;
+        if (!state.ejected.load(std::memory_order_relaxed)) continue;
+        state.ejected.store(false, std::memory_order_release);
+        ejected_count_.fetch_sub(1, std::memory_order_acq_rel);
+        logging::Get()->info(
+            "Outlier detection disabled; endpoint returned to rotation "
+            "upstream={} endpoint={}", service_name_, member_labels_[m]);
+    }
+}
+
+void OutlierDetector::Start(
+        const std::vector<std::shared_ptr<Dispatcher>>& dispatchers) {
+    dispatchers_ = dispatchers;
+    for (size_t d = 0; d < dispatchers_.size() && d < dispatcher_count_; ++d) {
+        ScheduleSweep(d);
+    }
+}
+
+void OutlierDetector::Stop() {
+    stopped_.store(true, std::memory_order_release);
+}
+
+void OutlierDetector::ScheduleSweep(size_t dispatcher_index) {
+    if (stopped_.load(std::memory_order_acquire)) return;
+    const auto interval = std::chrono::milliseconds(
+        LoadConfig()->outlier_detection.interval_ms);
+    std::weak_ptr<OutlierDetector> weak = weak_from_this();
+    // A false return means the dispatcher stopped; sweeps end with it.
+    dispatchers_[dispatcher_index]->EnQueueDelayed([weak, dispatcher_index]() {
+        auto self = weak.lock();
+        if (!self || self->stopped_.load(std::memory_order_acquire)) return;
+        self->Sweep(dispatcher_index, std::chrono::steady_clock::now());
+        self->ScheduleSweep(dispatcher_index);
+    }, interval);
+}
+
+void OutlierDetector::SyncWindow(Slot& slot) {
+    const int window_seconds = window_seconds_.load(std::memory_order_relaxed);
+    if (slot.window.window_seconds() != window_seconds) {
+        slot.window.Resize(window_seconds);
+    }
+}
+
+void OutlierDetector::Record(size_t dispatcher_index, size_t member,
+                             bool failure, int64_t latency_ms,
+                             std::chrono::steady_clock::time_point now) {
+    if (!active_.load(std::memory_order_acquire)) return;
+    if (member >= members_.size() || dispatcher_index >= dispatcher_count_) {
+        return;
+    }
+    Slot& slot = SlotFor(member, dispatcher_index);
+    SyncWindow(slot);
+    if (failure) {
+        slot.window.AddFailure(now);
+    } else {
+        slot.window.AddSuccess(now);
+    }
+    if (latency_ms >= 0) ++slot.latency[LatencyBucket(latency_ms)];
+
+    auto& state = members_[member];
+    if (!failure) {
+        // Skip the store in the common case so successes don't bounce
+        // the cache line between dispatchers.
+        if (state.consecutive_failures.load(std::memory_order_relaxed) != 0) {
+            state.consecutive_failures.store(0, std::memory_order_relaxed);
+        }
+        return;
+    }
+    const int limit = consecutive_limit_.load(std::memory_order_relaxed);
+    if (limit <= 0) return;
+    const int run =
+        state.consecutive_failures.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (run < limit) return;
+    state.consecutive_failures.store(0, std::memory_order_relaxed);
+    TryEject(member, Reason::CONSECUTIVE_5XX, *LoadConfig(), now,
+             std::to_string(run) + " consecutive failures");
+}
+
+void OutlierDetector::Sweep(size_t dispatcher_index,
+                            std::chrono::steady_clock::time_point now) {
+    if (dispatcher_index >= dispatcher_count_) return;
+    for (size_t m = 0; m < members_.size(); ++m) {
+        Slot& slot = SlotFor(m, dispatcher_index);
+        SyncWindow(slot);
+        slot.published_total.store(slot.window.TotalCount(now),
+                                   std::memory_order_relaxed);
+        slot.published_failures.store(slot.window.FailureCount(now),
+                                      std::memory_order_relaxed);
+        // Latency is per sweep interval: publish and start over.
+        for (size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            slot.published_latency[b].store(slot.latency[b],
+                                            std::memory_order_relaxed);
+            slot.latency[b] = 0;
+        }
+    }
+    if (dispatcher_index == 0) Evaluate(now);
+}
+
+void OutlierDetector::Evaluate(std::chrono::steady_clock::time_point now) {
+    auto config = LoadConfig();
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (size_t m = 0; m < members_.size(); ++m) {
+            auto& state = members_[m];
+            if (!state.ejected.load(std::memory_order_relaxed)) {
+                // A member that stays in rotation earns back one step of
+                // its ejection backoff per interval.
+                if (state.times_ejected > 0) --state.times_ejected;
+                continue;
+            }
+            if (now < state.ejected_until) continue;
+            state.ejected.store(false, std::memory_order_release);
+            state.consecutive_failures.store(0, std::memory_order_relaxed);
+            ejected_count_.fetch_sub(1, std::memory_order_acq_rel);
+            logging::Get()->info(
+                "Outlier ejection expired; endpoint returned to rotation "
+                "upstream={} endpoint={}", service_name_, member_labels_[m]);
+        }
+    }
+    if (!Active(*config)) return;
+    DetectSuccessRate(*config, now);
+    DetectLatency(*config, now);
+}
+
+void OutlierDetector::DetectSuccessRate(
+        const CircuitBreakerConfig& config,
+        std::chrono::steady_clock::time_point now) {
+    const auto& od = config.outlier_detection;
+    if (od.success_rate_stdev_factor <= 0) return;
+
+    std::vector<std::pair<size_t, double>> rates;
+    for (size_t m = 0; m < members_.size(); ++m) {
+        if (IsEjected(m)) continue;
+        int64_t total = 0;
+        int64_t failures = 0;
+        for (size_t d = 0; d < dispatcher_count_; ++d) {
+            const Slot& slot = SlotFor(m, d);
+            total += slot.published_total.load(std::memory_order_relaxed);
+            failures += slot.published_failures.load(std::memory_order_relaxed);
+        }
+        if (total < od.request_volume) continue;
+        rates.emplace_back(m, static_cast<double>(total - failures) /
+                                  static_cast<double>(total));
+    }
+    if (rates.size() < static_cast<size_t>(od.minimum_hosts)) return;
+
+    double mean = 0.0;
+    for (const auto& [m, rate] : rates) mean += rate;
+    mean /= static_cast<double>(rates.size());
+    double variance = 0.0;
+    for (const auto& [m, rate] : rates) {
+        variance += (rate - mean) * (rate - mean);
+    }
+    const double stdev =
+        std::sqrt(variance / static_cast<double>(rates.size()));
+    const double threshold =
+        mean - stdev * (od.success_rate_stdev_factor / 1000.0);
+    for (const auto& [m, rate] : rates) {
+        if (rate >= threshold) continue;
+        TryEject(m, Reason::SUCCESS_RATE, config, now,
+                 "success rate " + std::to_string(rate) +
+                 " below threshold " + std::to_string(threshold));
+    }
+}
+
+void OutlierDetector::DetectLatency(
+        const CircuitBreakerConfig& config,
+        std::chrono::steady_clock::time_point now) {
+    const auto& od = config.outlier_detection;
+    if (od.latency_p99_factor_percent <= 0) return;
+
+    // p99 per member, reported as the upper bound of its bucket.
+    std::vector<std::pair<size_t, int64_t>> p99s;
+    std::array<int64_t, LATENCY_BUCKETS> histogram;
+    for (size_t m = 0; m < members_.size(); ++m) {
+        if (IsEjected(m)) continue;
+        histogram.fill(0);
+        int64_t count = 0;
+        for (size_t d = 0; d < dispatcher_count_; ++d) {
+            const Slot& slot = SlotFor(m, d);
+            for (size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+                const int64_t n =
+                    slot.published_latency[b].load(std::memory_order_relaxed);
+                histogram[b] += n;
+                count += n;
+            }
+        }
+        if (count < od.request_volume) continue;
+        const int64_t rank = count - count / 100;  // ceil-ish 99th rank
+        int64_t seen = 0;
+        size_t bucket = 0;
+        for (; bucket < LATENCY_BUCKETS; ++bucket) {
+            seen += histogram[bucket];
+            if (seen >= rank) break;
+        }
+        bucket = std::min(bucket, LATENCY_BUCKETS - 1);
+        p99s.emplace_back(m, (int64_t{1} << bucket) - 1);
+    }
+    if (p99s.size() < static_cast<size_t>(od.minimum_hosts)) return;
+
+    std::vector<int64_t> sorted;
+    sorted.reserve(p99s.size());
+    for (const auto& [m, p99] : p99s) sorted.push_back(p99);
+    const size_t mid = (sorted.size() - 1) / 2;  // lower median
+    std::nth_element(sorted.begin(), sorted.begin() + mid, sorted.end());
+    const int64_t median = sorted[mid];
+    const int64_t limit = std::max<int64_t>(
+        median * od.latency_p99_factor_percent / 100, od.latency_p99_min_ms);
+    for (const auto& [m, p99] : p99s) {
+        if (p99 <= limit) continue;
+        TryEject(m, Reason::LATENCY, config, now,
+                 "p99 " + std::to_string(p99) + "ms over limit " +
+                 std::to_string(limit) + "ms (median " +
+                 std::to_string(median) + "ms)");
+    }
+}
+
+void OutlierDetector::TryEject(size_t member, Reason reason,
+                               const CircuitBreakerConfig& config,
+                               std::chrono::steady_clock::time_point now,
+                               const std::string& detail) {
+    if (!Active(config)) return;
+    const auto& od = config.outlier_detection;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto& state = members_[member];
+        if (state.ejected.load(std::memory_order_relaxed)) return;
+        const int64_t n = static_cast<int64_t>(members_.size());
+        const int64_t ejected = ejected_count_.load(std::memory_order_relaxed);
+        if ((ejected + 1) * 100 >
+            static_cast<int64_t>(config.max_ejection_percent_per_host_set) * n) {
+            logging::Get()->warn(
+                "Outlier ejection suppressed by max_ejection_percent_per_host_set "
+                "upstream={} endpoint={} reason={} ({}) ejected={}/{}",
+                service_name_, member_labels_[member], ReasonName(reason),
+                detail, ejected, n);
+            return;
+        }
+        if (config.dry_run) {
+            dry_run_ejections_total_.fetch_add(1, std::memory_order_relaxed);
+            logging::Get()->info(
+                "[dry-run] Outlier would eject upstream={} endpoint={} "
+                "reason={} ({})",
+                service_name_, member_labels_[member], ReasonName(reason),
+                detail);
+        } else {
+            ++state.times_ejected;
+            const int64_t duration_ms = std::min<int64_t>(
+                static_cast<int64_t>(od.base_ejection_time_ms) *
+                    state.times_ejected,
+                od.max_ejection_time_ms);
+            state.ejected_until = now + std::chrono::milliseconds(duration_ms);
+            state.ejected.store(true, std::memory_order_release);
+            ejected_count_.fetch_add(1, std::memory_order_acq_rel);
+            ejections_total_.fetch_add(1, std::memory_order_relaxed);
+            logging::Get()->warn(
+                "Outlier ejected upstream={} endpoint={} reason={} ({}) "
+                "for {}ms",
+                service_name_, member_labels_[member], ReasonName(reason),
+                detail, duration_ms);
+        }
+    }
+    EmitEjection(member, reason, !config.dry_run);
+}
+
+void OutlierDetector::EmitEjection(size_t member, Reason reason,
+                                   bool enforced) {
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_upstream_outlier_ejections == nullptr) return;
+    cat.reactor_upstream_outlier_ejections->Add(
+        1.0, {{"reactor.upstream.service", service_name_},
+              {"endpoint", member_labels_[member]},
+              {"reason", ReasonName(reason)},
+              {"mode", enforced ? "enforced" : "dry_run"}});
+}
+
+}  // namespace CIRCUIT_BREAKER_NAMESPACE
@@ -6,6 +6,7 @@
 #include "socket_handler.h"
 #include "tls/tls_client_context.h"
 #include "tls/tls_connection.h"
+#include "tls/tls_session_cache.h"
 #include "log/logger.h"
 #include "log/log_utils.h"
 #include "observability/counter.h"
@@ -164,6 +165,7 @@ PoolPartition::PoolPartition(
     , drain_mtx_(drain_mtx)
     , drain_cv_(drain_cv)
     , partition_max_connections_(static_cast<size_t>(config.max_connections))
+    , prewarm_(config)
 {
     // Programmer error guard: partition needs a resolved endpoint to
     // connect. Production builds get one from HttpServer::Start's DNS
@@ -178,6 +180,9 @@ PoolPartition::PoolPartition(
             "setups; direct PoolPartition construction requires a "
             "ResolvedEndpoint).");
     }
+    if (tls_ctx_ && tls_ctx_->SessionReuseEnabled()) {
+        tls_session_cache_ = std::make_shared<TlsSessionCache>();
+    }
     logging::Get()->debug(
         "PoolPartition created for {}:{} (resolved={}:{}) on dispatcher {}",
         upstream_host_, upstream_port_,
@@ -337,6 +342,8 @@ void PoolPartition::CheckoutAsync(ReadyCallback ready_cb, ErrorCallback error_cb
         return;
     }
 
+    prewarm_.RecordCheckout(std::chrono::steady_clock::now());
+
     // 1. Try to find a valid idle connection (MRU = front).
     // Defense-in-depth against the reload-cleanup task race: a connection
     // idle at reload time should be reaped by EnqueueIdleCleanupOnEndpointChange,
@@ -389,6 +396,9 @@ void PoolPartition::CheckoutAsync(ReadyCallback ready_cb, ErrorCallback error_cb
         EmitIdleGaugeDelta(-1.0);
         EmitActiveGaugeDelta(+1.0);
         EmitCheckoutWaitDuration(0.0, "immediate");
+        // Replace the connection just taken before the callback runs:
+        // MaybePrewarm only starts connects, it never calls user code.
+        MaybePrewarm();
         // Bump inflight_leases_ BEFORE handing the lease to the caller.
         // ReturnConnection (called from ~UpstreamLease) decrements.
         inflight_leases_.fetch_add(1, std::memory_order_acq_rel);
@@ -398,7 +408,10 @@ void PoolPartition::CheckoutAsync(ReadyCallback ready_cb, ErrorCallback error_cb
 
     // 2. No idle — create new if under limit
     if (TotalCount() < partition_max_connections_) {
+        EmitConnect(/*prewarm=*/false);
         CreateNewConnection(std::move(ready_cb), std::move(error_cb));
+        if (!alive->load(std::memory_order_acquire)) return;
+        MaybePrewarm();
         return;
     }
 
@@ -1056,6 +1069,10 @@ void PoolPartition::EvictExpired() {
 
     // Eviction freed capacity — retry queued checkouts.
     ServiceWaitQueue();
+    if (!alive_local->load(std::memory_order_acquire)) return;
+
+    // Refill what eviction took, and warm the pool after a quiet period.
+    MaybePrewarm();
 }
 
 std::shared_ptr<void> PoolPartition::MakeInflightGuard() {
@@ -2005,6 +2022,14 @@ void PoolPartition::CreateNewConnection(ReadyCallback ready_cb,
         return;
     }
 
+    StartConnection(fd, family, std::move(endpoint), std::move(ready_cb),
+                    std::move(error_cb));
+}
+
+void PoolPartition::StartConnection(
+    int fd, sa_family_t family,
+    std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> endpoint,
+    ReadyCallback ready_cb, ErrorCallback error_cb) {
     // Build socket handler and connection handler. Thread the resolved
     // family into SocketHandler so later observability / debug paths
     // (e.g. GetBoundPort's getsockname) branch on ss_family correctly.
@@ -2059,6 +2084,7 @@ void PoolPartition::CreateNewConnection(ReadyCallback ready_cb,
                     // address as SNI would fail against name-based certificates.
                     auto tls = std::make_unique<TlsConnection>(
                         *tls_ctx_, handler->fd(), sni_hostname_);
+                    AttachTlsSession(*tls);
                     handler->SetTlsConnection(std::move(tls));
                     // The fall-through in CallWriteCb kicks off DoHandshake
                     // inline on the same EPOLLOUT. OnMessage fires when done.
@@ -2172,6 +2198,7 @@ void PoolPartition::CreateNewConnection(ReadyCallback ready_cb,
             (std::shared_ptr<ConnectionHandler> handler, std::string&) {
                 if (raw_conn->IsConnecting()) {
                     handler->ClearDeadline();
+                    EmitTlsHandshake(*handler);
                     OnConnectComplete(raw_conn, *ready_cb_copy, *error_cb_copy);
                 }
             });
@@ -2221,12 +2248,32 @@ void PoolPartition::OnConnectComplete(UpstreamConnection* conn,
     // is set immediately by InitiateShutdown(); the partition flag is set later
     // by the enqueued task. Without checking both, a connect that completes
     // between the two can deliver a lease after Stop() has begun.
+    prewarm_.RecordConnectTime(connect_dur_sec);
+
     if (shutting_down_ || manager_shutting_down_.load(std::memory_order_acquire)) {
         DestroyConnection(std::move(owned));
         error_cb(CHECKOUT_SHUTTING_DOWN);
         return;
     }
 
+    if (!ready_cb) {
+        // MaybePrewarm connect: park it in the idle pool like a returned
+        // connection. No lease, so no active gauge or wait histogram.
+        --prewarm_connecting_;
+        owned->MarkIdle();
+        WirePoolCallbacks(owned.get());
+        owned->GetTransport()->SetDeadline(
+            std::chrono::steady_clock::now() +
+            std::chrono::seconds(config_.idle_timeout_sec));
+        logging::Get()->debug("Upstream connection pre-warmed fd={} {}:{}",
+                              owned->fd(), upstream_host_, upstream_port_);
+        idle_conns_.push_front(std::move(owned));
+        EmitIdleGaugeDelta(+1.0);
+        // A checkout may have queued behind this connect at the cap.
+        ServiceWaitQueue();
+        return;
+    }
+
     // Set a far-future deadline instead of clearing. ClearDeadline would
     // expose the transport to the server-wide idle timeout (since the fd is
     // still in the dispatcher's connections_ map). A far-future deadline
@@ -2480,6 +2527,7 @@ bool PoolPartition::OpenNewH2Connection(const std::string& upstream_name,
                 try {
                     auto tls = std::make_unique<TlsConnection>(
                         *tls_ctx_, handler->fd(), sni_hostname_);
+                    AttachTlsSession(*tls);
                     handler->SetTlsConnection(std::move(tls));
                 } catch (const std::exception& e) {
                     logging::Get()->error(
@@ -2496,7 +2544,10 @@ bool PoolPartition::OpenNewH2Connection(const std::string& upstream_name,
                 if (!alive->load(std::memory_order_acquire)) return;
                 std::string alpn;
                 auto t = raw_uc ? raw_uc->GetTransport() : nullptr;
-                if (t) alpn = t->GetAlpnProtocol();
+                if (t) {
+                    alpn = t->GetAlpnProtocol();
+                    EmitTlsHandshake(*t);
+                }
                 OnH2ConnectHandshakeComplete(
                     upstream_name, port, CHECKOUT_OK, alpn);
             });
@@ -3262,6 +3313,7 @@ void PoolPartition::CreateForWaiters() {
         auto entry = std::move(wait_queue_.front());
         wait_queue_.pop_front();
         size_t count_before = TotalCount();
+        EmitConnect(/*prewarm=*/false);
         CreateNewConnection(std::move(entry.ready_callback),
                             std::move(entry.error_callback));
         if (!alive->load(std::memory_order_acquire)) return;
@@ -3273,6 +3325,35 @@ void PoolPartition::CreateForWaiters() {
     }
 }
 
+void PoolPartition::MaybePrewarm() {
+    if (!prewarm_.enabled() || !wait_queue_.empty() ||
+        shutting_down_.load(std::memory_order_acquire) ||
+        manager_shutting_down_.load(std::memory_order_acquire)) {
+        return;
+    }
+    // Pre-warming fills the HTTP/1.1 idle pool, which a prefer="always"
+    // upstream never checks out from.
+    auto h2 = LoadHttp2ConfigSnapshot();
+    if (h2 && h2->enabled && h2->prefer == "always") return;
+    const size_t target = prewarm_.TargetIdle(std::chrono::steady_clock::now());
+    while (idle_conns_.size() + prewarm_connecting_ < target &&
+           TotalCount() < partition_max_connections_) {
+        size_t count_before = TotalCount();
+        ++prewarm_connecting_;
+        EmitConnect(/*prewarm=*/true);
+        // Null ready_cb marks the connect as a pre-warm (OnConnectComplete
+        // parks it idle). Failures are only logged by CreateNewConnection;
+        // the next timer tick tries again.
+        auto alive = alive_;
+        CreateNewConnection(nullptr, [this, alive](int) {
+            if (alive->load(std::memory_order_acquire)) --prewarm_connecting_;
+        });
+        // Synchronous failure (fd exhaustion, bad endpoint): stop here
+        // rather than spin on the same error.
+        if (TotalCount() == count_before) break;
+    }
+}
+
 void PoolPartition::DestroyConnection(
     std::unique_ptr<UpstreamConnection> conn) {
     if (!conn) return;
@@ -3319,6 +3400,51 @@ void PoolPartition::EmitActiveGaugeDelta(double delta) {
         delta, {{"reactor.upstream.service", service_name_}});
 }
 
+void PoolPartition::AttachTlsSession(TlsConnection& tls) {
+    if (!tls_session_cache_) return;
+    tls.AttachSessionCache(*tls_session_cache_,
+                           upstream_host_ + ":" + std::to_string(upstream_port_) +
+                           "/" + sni_hostname_);
+}
+
+void PoolPartition::EmitTlsHandshake(const ConnectionHandler& handler) {
+    const bool resumed = handler.IsTlsSessionReused();
+    if (resumed) {
+        tls_handshakes_resumed_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        tls_handshakes_full_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs || service_name_.empty()) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_upstream_tls_handshakes == nullptr) return;
+    cat.reactor_upstream_tls_handshakes->Add(
+        1.0, {{"reactor.upstream.service", service_name_},
+              {"mode", resumed ? "resumed" : "full"}});
+}
+
+void PoolPartition::EmitHealthCheck(const char* outcome) {
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs || service_name_.empty() || outcome == nullptr) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_upstream_health_checks == nullptr) return;
+    cat.reactor_upstream_health_checks->Add(
+        1.0, {{"reactor.upstream.service", service_name_},
+              {"outcome", outcome}});
+}
+
+void PoolPartition::EmitHealthTransition(const std::string& endpoint,
+                                         bool healthy) {
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs || service_name_.empty()) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_upstream_health_transitions == nullptr) return;
+    cat.reactor_upstream_health_transitions->Add(
+        1.0, {{"reactor.upstream.service", service_name_},
+              {"endpoint", endpoint},
+              {"to", healthy ? "healthy" : "unhealthy"}});
+}
+
 void PoolPartition::EmitCheckoutWaitDuration(double duration_sec,
                                               const char* outcome) {
     auto* obs = obs_manager_.load(std::memory_order_acquire);
@@ -3332,6 +3458,18 @@ void PoolPartition::EmitCheckoutWaitDuration(double duration_sec,
          {"outcome", outcome}});
 }
 
+void PoolPartition::EmitConnect(bool prewarm) {
+    (prewarm ? prewarm_connects_ : checkout_connects_)
+        .fetch_add(1, std::memory_order_relaxed);
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs || service_name_.empty()) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_upstream_pool_connects == nullptr) return;
+    cat.reactor_upstream_pool_connects->Add(
+        1.0, {{"reactor.upstream.service", service_name_},
+              {"reason", prewarm ? "prewarm" : "checkout"}});
+}
+
 void PoolPartition::MaybeSignalDrain() {
     // Check both partition-local and manager-wide shutdown flags.
     // Without the manager check, a lease returned between manager shutdown
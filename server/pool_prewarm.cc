@@ -0,0 +1,49 @@
+#include "upstream/pool_prewarm.h"
+
+#include <algorithm>
+#include <cmath>
+
+PoolPrewarmPolicy::PoolPrewarmPolicy(const UpstreamPoolConfig& config)
+    : min_idle_(static_cast<size_t>(std::max(config.min_idle_connections, 0))),
+      max_idle_(static_cast<size_t>(std::max(config.max_idle_connections, 0))),
+      adaptive_(config.adaptive_min_idle) {}
+
+void PoolPrewarmPolicy::RecordCheckout(Clock::time_point now) {
+    // Each checkout adds 1/tau to a rate that decays with time constant
+    // tau, so a steady stream of r per second settles at r.
+    rate_ = CheckoutRate(now) + 1.0 / RATE_TAU_SEC;
+    rate_at_ = now;
+}
+
+void PoolPrewarmPolicy::RecordConnectTime(double seconds) {
+    if (seconds < 0.0) seconds = 0.0;
+    if (!connect_sampled_) {
+        connect_sec_ = seconds;
+        connect_sampled_ = true;
+        return;
+    }
+    connect_sec_ += CONNECT_TIME_ALPHA * (seconds - connect_sec_);
+}
+
+double PoolPrewarmPolicy::CheckoutRate(Clock::time_point now) const {
+    if (rate_ <= 0.0) return 0.0;
+    const double elapsed =
+        std::chrono::duration<double>(now - rate_at_).count();
+    if (elapsed <= 0.0) return rate_;
+    return rate_ * std::exp(-elapsed / RATE_TAU_SEC);
+}
+
+size_t PoolPrewarmPolicy::TargetIdle(Clock::time_point now) const {
+    size_t target = min_idle_;
+    if (adaptive_) {
+        const double rate = CheckoutRate(now);
+        if (rate >= MIN_ADAPTIVE_RATE) {
+            const double expected = std::ceil(rate * connect_sec_);
+            // Compare before converting: an outlier connect time must not
+            // overflow size_t.
+            if (expected >= static_cast<double>(max_idle_)) return max_idle_;
+            target = std::max(target, static_cast<size_t>(expected));
+        }
+    }
+    return std::min(target, max_idle_);
+}
@@ -1,9 +1,114 @@
 #include "upstream/proxy_handler.h"
 #include "upstream/proxy_transaction.h"
+#include "upstream/ws_tunnel.h"
+#include "upstream/http_request_serializer.h"
+#include "auth/auth_manager.h"
+#include "http/http_connection_handler.h"
 #include "config/server_config.h"
 #include "http/http_request.h"
+#include "http/http_response.h"
+#include "upstream/upstream_manager.h"
+#include "circuit_breaker/circuit_breaker_manager.h"
+#include "circuit_breaker/circuit_breaker_host.h"
+#include "dispatcher.h"
 #include "log/logger.h"
 
+namespace {
+
+using StreamingSender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender;
+
+// Tees a streamed upstream response into a ResponseCache::Fill. When
+// the fill substitutes a cached entry (304 to the cache's conditional,
+// stale-if-error) the entry is sent in its place and the upstream body
+// is swallowed. Without an inner sender it is a sink for background
+// revalidations.
+class CacheFillSender : public StreamingSender::Impl {
+public:
+    CacheFillSender(StreamingSender inner,
+                    std::shared_ptr<ResponseCache::Fill> fill)
+        : inner_(std::move(inner)), fill_(std::move(fill)) {}
+
+    int SendHeaders(const HttpResponse& response) override {
+        auto substitute = fill_->OnResponseHead(response);
+        if (!substitute) {
+            return inner_ ? inner_.SendHeaders(response) : 0;
+        }
+        substituted_ = true;
+        if (!inner_) return 0;
+        int rv = inner_.SendHeaders(ResponseCache::BuildResponse(
+            *substitute, fill_->AgeOf(*substitute), /*with_body=*/false));
+        if (rv < 0) return rv;
+        if (substitute->body && substitute->body->size() > 0 &&
+            inner_.SendData(substitute->body->data(), substitute->body->size()) ==
+                StreamingSender::SendResult::CLOSED) {
+            return rv;
+        }
+        (void)inner_.End();
+        return rv;
+    }
+
+    StreamingSender::SendResult SendData(const char* data, size_t len) override {
+        if (substituted_) return StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+        fill_->OnBody(data, len);
+        return inner_ ? inner_.SendData(data, len)
+                      : StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+    }
+
+    StreamingSender::SendResult End(
+        const std::vector<std::pair<std::string, std::string>>& trailers) override {
+        if (substituted_) return StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+        // Trailers are not stored, so a response carrying them is not
+        // cached.
+        fill_->OnComplete(trailers.empty());
+        return inner_ ? inner_.End(trailers)
+                      : StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+    }
+
+    void Abort(StreamingSender::AbortReason reason) override {
+        fill_->OnComplete(false);
+        if (!substituted_) inner_.Abort(reason);
+    }
+
+    void SetDrainListener(StreamingSender::DrainListener listener) override {
+        inner_.SetDrainListener(std::move(listener));
+    }
+    void ConfigureWatermarks(size_t high_water_bytes) override {
+        inner_.ConfigureWatermarks(high_water_bytes);
+    }
+    Dispatcher* GetDispatcher() override { return inner_.GetDispatcher(); }
+
+private:
+    StreamingSender inner_;
+    std::shared_ptr<ResponseCache::Fill> fill_;
+    bool substituted_ = false;
+};
+
+// Add the stored validators of `stale` to `request` unless the client
+// already sent its own conditionals (their 304 belongs to the client).
+bool AddCacheConditionals(HttpRequest& request, const ResponseCache::Entry& stale) {
+    if (request.headers.count("if-none-match") ||
+        request.headers.count("if-modified-since")) {
+        return false;
+    }
+    bool added = false;
+    if (!stale.etag.empty()) {
+        request.headers["if-none-match"] = stale.etag;
+        added = true;
+    }
+    if (!stale.last_modified.empty()) {
+        request.headers["if-modified-since"] = stale.last_modified;
+        added = true;
+    }
+    return added;
+}
+
+bool IsSafeMethod(const std::string& method) {
+    return method == "GET" || method == "HEAD" || method == "OPTIONS" ||
+           method == "TRACE";
+}
+
+}  // namespace
+
 ProxyHandler::ProxyHandler(
     const std::string& service_name,
     const ProxyConfig& config,
@@ -12,7 +117,8 @@ ProxyHandler::ProxyHandler(
     int upstream_port,
     const std::string& sni_hostname,
     UpstreamManager* upstream_manager,
-    AUTH_NAMESPACE::AuthManager* auth_manager)
+    AUTH_NAMESPACE::AuthManager* auth_manager,
+    std::shared_ptr<ResponseCache> response_cache)
     : service_name_(service_name),
       config_(config),
       upstream_tls_(upstream_tls),
@@ -21,6 +127,14 @@ ProxyHandler::ProxyHandler(
       sni_hostname_(sni_hostname),
       upstream_manager_(upstream_manager),
       auth_manager_(auth_manager),
+      response_cache_(config.cache ? std::move(response_cache) : nullptr),
+      singleflight_(config.singleflight.enabled && !response_cache_
+                        ? std::make_shared<SingleflightGroup>(
+                              service_name, config.singleflight)
+                        : nullptr),
+      hedge_policy_(config.retry.hedge.enabled
+                        ? std::make_shared<HedgePolicy>(config.retry.hedge)
+                        : nullptr),
       header_rewriter_(HeaderRewriter::Config{
           config.header_rewrite.set_x_forwarded_for,
           config.header_rewrite.set_x_forwarded_proto,
@@ -33,7 +147,8 @@ ProxyHandler::ProxyHandler(
           config.retry.retry_on_5xx,
           config.retry.retry_on_timeout,
           config.retry.retry_on_disconnect,
-          config.retry.retry_non_idempotent
+          config.retry.retry_non_idempotent,
+          config.grpc.enabled && !config.grpc.retry_on.empty()
       })
 {
     // Precompute static_prefix for strip_prefix path rewriting.
@@ -90,9 +205,12 @@ ProxyHandler::ProxyHandler(
     }
 
     logging::Get()->info("ProxyHandler created service={} upstream={}:{} "
-                         "route_prefix={} strip_prefix={}",
+                         "route_prefix={} strip_prefix={} cache={} "
+                         "singleflight={} hedge={}",
                          service_name_, upstream_host_, upstream_port_,
-                         config_.route_prefix, config_.strip_prefix);
+                         config_.route_prefix, config_.strip_prefix,
+                         response_cache_ != nullptr, singleflight_ != nullptr,
+                         hedge_policy_ != nullptr);
 }
 
 ProxyHandler::~ProxyHandler() {
@@ -100,16 +218,8 @@ ProxyHandler::~ProxyHandler() {
                           service_name_);
 }
 
-void ProxyHandler::Handle(
-    const HttpRequest& request,
-    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
-    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
-
-    logging::Get()->debug("ProxyHandler::Handle service={} client_fd={} "
-                          "{} {}",
-                          service_name_, request.client_fd,
-                          request.method, request.path);
-
+std::string ProxyHandler::UpstreamPathOverride(
+    const HttpRequest& request) const {
     // Extract catch-all route param for strip_prefix. The param name is
     // determined by the route pattern: auto-generated routes use "proxy_path",
     // user-defined patterns may use any name (e.g., "*rest" → "rest").
@@ -145,6 +255,67 @@ void ProxyHandler::Handle(
         }
         // else: unnamed catch-all → leave override empty, use static_prefix_
     }
+    return upstream_path_override;
+}
+
+void ProxyHandler::Handle(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+    Handle(request, HTTP_CALLBACKS_NAMESPACE::InterimResponseSender{},
+           std::move(stream_sender), std::move(complete));
+}
+
+void ProxyHandler::Handle(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+
+    logging::Get()->debug("ProxyHandler::Handle service={} client_fd={} "
+                          "{} {}",
+                          service_name_, request.client_fd,
+                          request.method, request.path);
+
+    // Honor the operator's "disabled" intent: when response_timeout_ms
+    // is 0 this upstream is allowed unbounded response lifetime
+    // (SSE, long-poll, intentionally unbounded backends). The global
+    // async-deferred safety cap would otherwise abort this request
+    // after the default floor (~1 hour), contradicting the configured
+    // behavior advertised by response_timeout_ms=0. Writing 0 into
+    // the per-request override tells the framework's deferred
+    // heartbeat (HTTP/1) and ResetExpiredStreams (HTTP/2) to skip
+    // the safety-cap check for THIS request only — unrelated routes
+    // on the same server still get their normal global cap.
+    if (config_.response_timeout_ms == 0) {
+        request.async_cap_sec_override = 0;
+    }
+
+    if (response_cache_) {
+        HandleCached(request, std::move(send_interim), std::move(stream_sender),
+                     std::move(complete), /*follower=*/false);
+        return;
+    }
+    if (singleflight_) {
+        HandleCoalesced(request, std::move(send_interim),
+                        std::move(stream_sender), std::move(complete));
+        return;
+    }
+    if (hedge_policy_ && stream_sender && HedgePolicy::Eligible(request)) {
+        ForwardHedged(request, std::move(send_interim), std::move(stream_sender),
+                      std::move(complete));
+        return;
+    }
+    Forward(request, std::move(send_interim), std::move(stream_sender),
+            std::move(complete));
+}
+
+std::shared_ptr<ProxyTransaction> ProxyHandler::Forward(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+    std::string upstream_path_override = UpstreamPathOverride(request);
 
     auto txn = std::make_shared<ProxyTransaction>(
         service_name_,
@@ -180,20 +351,6 @@ void ProxyHandler::Handle(
         };
     }
 
-    // Honor the operator's "disabled" intent: when response_timeout_ms
-    // is 0 this upstream is allowed unbounded response lifetime
-    // (SSE, long-poll, intentionally unbounded backends). The global
-    // async-deferred safety cap would otherwise abort this request
-    // after the default floor (~1 hour), contradicting the configured
-    // behavior advertised by response_timeout_ms=0. Writing 0 into
-    // the per-request override tells the framework's deferred
-    // heartbeat (HTTP/1) and ResetExpiredStreams (HTTP/2) to skip
-    // the safety-cap check for THIS request only — unrelated routes
-    // on the same server still get their normal global cap.
-    if (config_.response_timeout_ms == 0) {
-        request.async_cap_sec_override = 0;
-    }
-
     // Wire the observability snapshot into the transaction BEFORE Start()
     // so KillOutstandingSnapshots() can call MarkKilledForShutdown()
     // through the link/kill protocol on real proxy traffic. Without this,
@@ -205,6 +362,339 @@ void ProxyHandler::Handle(
         txn->AttachObservabilitySnapshot(request.obs_snapshot);
     }
 
+    if (config_.relay_early_hints && send_interim) {
+        txn->SetInterimResponseSender(std::move(send_interim));
+    }
+
     txn->Start();
     // txn stays alive via shared_ptr captured in async callbacks
+    return txn;
+}
+
+void ProxyHandler::HandleCoalesced(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+    std::string key;
+    if (stream_sender) key = singleflight_->KeyFor(request);
+    Dispatcher* dispatcher = !key.empty() && request.dispatcher_index >= 0
+        ? upstream_manager_->GetDispatcherForIndex(
+              static_cast<size_t>(request.dispatcher_index))
+        : nullptr;
+    if (!dispatcher) {
+        Forward(request, std::move(send_interim), std::move(stream_sender),
+                std::move(complete));
+        return;
+    }
+
+    // Waiters are written by the flight, not the transaction; give them
+    // the watermark the transaction would have configured.
+    stream_sender.ConfigureWatermarks(config_.relay_buffer_limit_bytes);
+    auto flight = singleflight_->Join(key, request, dispatcher,
+                                      std::move(stream_sender),
+                                      std::move(complete));
+    if (!flight) return;
+
+    // The upstream request belongs to the flight and outlives the
+    // leader's connection: the leader's cancel slot only detaches the
+    // leader, and the transaction is cancelled once every waiter has
+    // gone. It keeps the leader's observability snapshot, so spans and
+    // client metrics hang off the leading request.
+    HttpRequest shared = request;
+    shared.async_cancel_slot.reset();
+    shared.body_stream.reset();
+    auto txn = Forward(shared, std::move(send_interim), flight->UpstreamSender(),
+                       flight->UpstreamCompletion());
+    std::weak_ptr<ProxyTransaction> weak_txn = txn;
+    flight->SetCancel([weak_txn, dispatcher]() {
+        dispatcher->EnQueue([weak_txn]() {
+            if (auto t = weak_txn.lock()) t->Cancel();
+        });
+    });
+}
+
+void ProxyHandler::ForwardHedged(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+    Dispatcher* dispatcher = request.dispatcher_index >= 0
+        ? upstream_manager_->GetDispatcherForIndex(
+              static_cast<size_t>(request.dispatcher_index))
+        : nullptr;
+    if (!dispatcher) {
+        Forward(request, std::move(send_interim), std::move(stream_sender),
+                std::move(complete));
+        return;
+    }
+    CIRCUIT_BREAKER_NAMESPACE::RetryBudget* budget = nullptr;
+    if (auto* cbm = upstream_manager_->GetCircuitBreakerManager()) {
+        if (auto* host = cbm->GetHost(service_name_)) {
+            budget = host->GetRetryBudget();
+        }
+    }
+
+    auto race = std::make_shared<HedgedRequest>(
+        service_name_, hedge_policy_, dispatcher, budget,
+        std::move(stream_sender), std::move(complete));
+    // Each attempt is its own transaction. The race owns the client's
+    // cancel slot; the observability snapshot and the interim sender
+    // stay with the primary, and the hedge does not share the primary's
+    // (empty) request body stream.
+    auto attempt_request = std::make_shared<HttpRequest>(request);
+    attempt_request->async_cancel_slot.reset();
+    std::weak_ptr<ProxyHandler> weak_self = weak_from_this();
+    race->Start(request, [weak_self, attempt_request, send_interim](
+                             HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender sender,
+                             HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback done,
+                             bool primary) -> std::function<void()> {
+        auto self = weak_self.lock();
+        if (!self) return nullptr;
+        HttpRequest attempt = *attempt_request;
+        if (!primary) {
+            attempt.obs_snapshot.reset();
+            attempt.body_stream.reset();
+        }
+        auto txn = self->Forward(
+            attempt,
+            primary ? send_interim : HTTP_CALLBACKS_NAMESPACE::InterimResponseSender{},
+            std::move(sender), std::move(done));
+        std::weak_ptr<ProxyTransaction> weak_txn = txn;
+        return [weak_txn]() {
+            if (auto t = weak_txn.lock()) t->Cancel();
+        };
+    });
+}
+
+void ProxyHandler::HandleCached(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete,
+    bool follower) {
+    const auto policy = ResponseCache::ClassifyRequest(request);
+    if (policy == ResponseCache::RequestPolicy::BYPASS) {
+        // RFC 9111 §4.4. Invalidated up front rather than on the
+        // response: a concurrent GET could at worst refill the old
+        // representation, which its own freshness then bounds.
+        if (!IsSafeMethod(request.method)) {
+            response_cache_->Invalidate(
+                ResponseCache::PrimaryKey(service_name_, request));
+        }
+        response_cache_->RecordResult(service_name_,
+                                      ResponseCache::Result::BYPASS,
+                                      nullptr, false);
+        Forward(request, std::move(send_interim), std::move(stream_sender),
+                std::move(complete));
+        return;
+    }
+
+    const bool head_only = request.method == "HEAD";
+    const std::string key = ResponseCache::PrimaryKey(service_name_, request);
+    ResponseCache::Lookup found;
+    if (policy == ResponseCache::RequestPolicy::LOOKUP) {
+        found = response_cache_->Find(key, request,
+                                      std::chrono::steady_clock::now());
+    }
+
+    if (found.entry &&
+        (found.usability == ResponseCache::Usability::FRESH ||
+         found.usability == ResponseCache::Usability::STALE_WHILE_REVALIDATE)) {
+        const bool fresh = found.usability == ResponseCache::Usability::FRESH;
+        response_cache_->RecordResult(
+            service_name_,
+            !fresh ? ResponseCache::Result::STALE
+                   : follower ? ResponseCache::Result::COLLAPSED
+                              : ResponseCache::Result::HIT,
+            found.entry.get(), head_only);
+        if (!fresh) RevalidateInBackground(request, key, found);
+        complete(ResponseCache::BuildResponse(*found.entry, found.age_sec));
+        return;
+    }
+
+    // A HEAD response has no body to store; the upstream answers it.
+    if (head_only) {
+        response_cache_->RecordResult(service_name_,
+                                      ResponseCache::Result::MISS,
+                                      nullptr, false);
+        Forward(request, std::move(send_interim), std::move(stream_sender),
+                std::move(complete));
+        return;
+    }
+
+    // Collapse concurrent misses: the first leads a fill, the rest wait
+    // for it and retry the lookup. A follower never waits twice — if
+    // the leader's response was not storable it goes to the upstream.
+    std::string collapse_key;
+    if (policy == ResponseCache::RequestPolicy::LOOKUP && !follower &&
+        response_cache_->collapse_requests()) {
+        collapse_key = ResponseCache::CollapseKey(key, request, found.vary);
+        auto cancelled = std::make_shared<std::atomic<bool>>(false);
+        auto waiting = std::make_shared<HttpRequest>(request);
+        std::weak_ptr<ProxyHandler> weak_self = weak_from_this();
+        auto resume = [weak_self, waiting, cancelled, send_interim,
+                       stream_sender, complete]() {
+            if (cancelled->load(std::memory_order_acquire)) return;
+            auto self = weak_self.lock();
+            if (!self) return;
+            self->HandleCached(*waiting, send_interim, stream_sender, complete,
+                               /*follower=*/true);
+        };
+        Dispatcher* dispatcher = request.dispatcher_index >= 0
+            ? upstream_manager_->GetDispatcherForIndex(
+                  static_cast<size_t>(request.dispatcher_index))
+            : nullptr;
+        if (dispatcher &&
+            !response_cache_->JoinOrLead(collapse_key, dispatcher,
+                                         std::move(resume))) {
+            // Until resumed, a client disconnect just drops the waiter;
+            // the transaction started on resume replaces this hook.
+            if (request.async_cancel_slot) {
+                *request.async_cancel_slot = [cancelled]() {
+                    cancelled->store(true, std::memory_order_release);
+                };
+            }
+            logging::Get()->debug("Proxy cache: collapsed miss service={} {}",
+                                  service_name_, request.path);
+            return;
+        }
+        if (!dispatcher) collapse_key.clear();
+    }
+
+    // Revalidate an expired entry with its validators rather than
+    // refetching it whole.
+    HttpRequest upstream_request = request;
+    bool conditional_added = false;
+    if (found.entry) {
+        conditional_added = AddCacheConditionals(upstream_request, *found.entry);
+    }
+    auto fill = std::make_shared<ResponseCache::Fill>(
+        response_cache_, service_name_, key, std::move(collapse_key),
+        request, std::move(found), conditional_added, /*client_request=*/true);
+    ForwardWithFill(upstream_request, std::move(send_interim),
+                    std::move(stream_sender), std::move(complete),
+                    std::move(fill));
+}
+
+void ProxyHandler::ForwardWithFill(
+    const HttpRequest& request,
+    HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender stream_sender,
+    HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete,
+    std::shared_ptr<ResponseCache::Fill> fill) {
+    HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender sender;
+    if (stream_sender || !complete) {
+        sender = HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender(
+            std::make_shared<CacheFillSender>(std::move(stream_sender), fill));
+    }
+    auto on_complete = [fill, complete = std::move(complete)](
+                           HttpResponse response) {
+        if (auto substitute = fill->OnResponseHead(response)) {
+            if (complete) {
+                complete(ResponseCache::BuildResponse(
+                    *substitute, fill->AgeOf(*substitute)));
+            }
+            return;
+        }
+        fill->OnBody(response.GetBody().data(), response.GetBody().size());
+        fill->OnComplete(true);
+        if (complete) complete(std::move(response));
+    };
+    Forward(request, std::move(send_interim), std::move(sender),
+            std::move(on_complete));
+}
+
+void ProxyHandler::RevalidateInBackground(const HttpRequest& request,
+                                          const std::string& key,
+                                          const ResponseCache::Lookup& stale) {
+    // One refresh per URL variant at a time; an in-flight fill (client
+    // miss or another revalidation) will refresh the entry anyway.
+    std::string collapse_key =
+        ResponseCache::CollapseKey(key, request, stale.vary);
+    if (!response_cache_->JoinOrLead(collapse_key, nullptr, nullptr)) return;
+
+    // Detached from the client request: no cancel hook, no snapshot,
+    // and the client's own conditionals do not apply.
+    HttpRequest refresh = request;
+    refresh.method = "GET";
+    refresh.async_cancel_slot.reset();
+    refresh.obs_snapshot.reset();
+    refresh.body_stream.reset();
+    for (const char* name : {"if-none-match", "if-modified-since", "if-match",
+                             "if-unmodified-since", "if-range"}) {
+        refresh.headers.erase(name);
+    }
+    const bool conditional_added = AddCacheConditionals(refresh, *stale.entry);
+    auto fill = std::make_shared<ResponseCache::Fill>(
+        response_cache_, service_name_, key, std::move(collapse_key), refresh,
+        stale, conditional_added, /*client_request=*/false);
+    logging::Get()->debug("Proxy cache: background revalidation service={} {}",
+                          service_name_, request.path);
+    ForwardWithFill(refresh, {}, {}, nullptr, std::move(fill));
+}
+
+void ProxyHandler::HandleWebSocket(
+    std::shared_ptr<HttpConnectionHandler> client,
+    const HttpRequest& request,
+    std::shared_ptr<WsTunnelContext> context) {
+
+    logging::Get()->debug("ProxyHandler::HandleWebSocket service={} "
+                          "client_fd={} {}",
+                          service_name_, request.client_fd, request.path);
+
+    std::string upstream_path = request.path;
+    std::string upstream_path_override = UpstreamPathOverride(request);
+    if (!upstream_path_override.empty()) {
+        upstream_path = upstream_path_override;
+    } else if (!static_prefix_.empty() &&
+               request.path.compare(0, static_prefix_.size(),
+                                    static_prefix_) == 0) {
+        upstream_path = request.path.substr(static_prefix_.size());
+    }
+    if (upstream_path.empty() || upstream_path[0] != '/') {
+        upstream_path = "/" + upstream_path;
+    }
+
+    // Same IsEnforcing() gate as ProxyTransaction: a staged-but-disabled
+    // auth config must not rewrite identity headers.
+    std::shared_ptr<const AUTH_NAMESPACE::AuthForwardConfig> fwd_snap;
+    if (auth_manager_ && auth_manager_->IsEnforcing()) {
+        fwd_snap = auth_manager_->ForwardConfig();
+    }
+    auto headers = header_rewriter_.RewriteRequest(
+        request.headers, request.client_ip, request.client_tls,
+        upstream_tls_, upstream_host_, upstream_port_, sni_hostname_,
+        fwd_snap ? fwd_snap.get() : nullptr, &request.auth);
+
+    // The rewriter strips Connection/Upgrade as hop-by-hop; the upgrade
+    // is exactly the hop this proxy is forwarding, so put them back.
+    // Sec-WebSocket-* (key, version, protocol, extensions) pass through
+    // untouched and are negotiated end-to-end with the backend.
+    auto upgrade_it = request.headers.find("upgrade");
+    headers["upgrade"] = upgrade_it != request.headers.end()
+                             ? upgrade_it->second
+                             : std::string("websocket");
+    headers["connection"] = "Upgrade";
+
+    WsTunnel::Params params;
+    params.service_name = service_name_;
+    params.upstream_host = upstream_host_;
+    params.upstream_port = upstream_port_;
+    params.upstream_manager = upstream_manager_;
+    params.dispatcher_index = request.dispatcher_index;
+    params.request_head = HttpRequestSerializer::Serialize(
+        "GET", upstream_path, request.query, headers, std::string{});
+    params.relay_buffer_limit_bytes = config_.relay_buffer_limit_bytes;
+    params.response_timeout_ms = config_.response_timeout_ms;
+    params.context = std::move(context);
+
+    auto tunnel = std::make_shared<WsTunnel>(client, std::move(params));
+    std::weak_ptr<WsTunnel> weak_tunnel = tunnel;
+    client->BeginWsTunnel(request, [weak_tunnel]() {
+        if (auto t = weak_tunnel.lock()) t->Cancel();
+    });
+    tunnel->Start();
+    // tunnel stays alive via shared_ptr captured in checkout / transport
+    // callbacks and, once open, the client's tunnel hooks.
 }
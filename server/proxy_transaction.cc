@@ -2,6 +2,7 @@
 #include "upstream/upstream_manager.h"
 #include "upstream/upstream_connection.h"
 #include "upstream/http_request_serializer.h"
+#include "upstream/replay_body_stream.h"
 #include "auth/auth_manager.h"
 #include "circuit_breaker/circuit_breaker_manager.h"
 #include "circuit_breaker/circuit_breaker_host.h"
@@ -12,6 +13,8 @@
 // config/server_config.h provided by proxy_transaction.h (ProxyConfig stored by value)
 #include "http/http_request.h"
 #include "http/http_status.h"
+#include "http/early_hints.h"
+#include "upstream/grpc.h"
 #include "http/trailer_policy.h"
 #include "http/http2_trailer_sanitizer.h"
 #include "log/logger.h"
@@ -26,6 +29,7 @@
 #include "observability/propagator.h"
 #include "observability/tracer_provider.h"
 #include "observability/tracer.h"
+#include <limits>
 #include <unordered_set>
 
 namespace {
@@ -324,6 +328,51 @@ ProxyTransaction::ProxyTransaction(
     if (client_request.body_stream) {
         is_streaming_request_ = true;
         body_stream_ = client_request.body_stream;
+        if (config_.retry.replay_buffer.max_bytes > 0 &&
+            config_.retry.max_retries > 0) {
+            replay_body_ = std::make_shared<ReplayBodyStream>(
+                body_stream_, config_.retry.replay_buffer);
+            body_stream_ = replay_body_;
+        }
+    }
+
+    // Request key for hash-based endpoint selection, captured while the
+    // client headers are at hand (before HeaderRewriter runs).
+    if (upstream_manager_) {
+        lb_hash_ = upstream_manager_->LoadBalancerHash(
+            service_name_, client_ip_, path_, client_headers_);
+    }
+
+    // gRPC mode. A middleware-set deadline override wins over the
+    // client's grpc-timeout; either way it is clamped only by
+    // max_timeout_ms, and ResponseTimeoutBudgetMs() counts it down from
+    // start_time_ across every attempt.
+    upstream_deadline_override_ms_ = client_request.upstream_deadline_override_ms;
+    if (config_.grpc.enabled) {
+        auto ct_it = client_headers_.find("content-type");
+        grpc_request_ = ct_it != client_headers_.end() &&
+                        GRPC_NAMESPACE::IsGrpcContentType(ct_it->second);
+    }
+    if (grpc_request_) {
+        grpc_retry_on_ = GRPC_NAMESPACE::MakeStatusSet(config_.grpc.retry_on);
+        grpc_breaker_failure_on_ =
+            GRPC_NAMESPACE::MakeStatusSet(config_.grpc.breaker_failure_on);
+        GRPC_NAMESPACE::SplitMethodPath(path_, grpc_service_, grpc_method_);
+        auto to_it = client_headers_.find("grpc-timeout");
+        if (config_.grpc.propagate_timeout &&
+            upstream_deadline_override_ms_ <= 0 &&
+            to_it != client_headers_.end()) {
+            if (auto ms = GRPC_NAMESPACE::ParseTimeoutMs(to_it->second)) {
+                int64_t deadline = std::max<int64_t>(1, *ms);
+                if (config_.grpc.max_timeout_ms > 0) {
+                    deadline = std::min<int64_t>(deadline,
+                                                 config_.grpc.max_timeout_ms);
+                }
+                upstream_deadline_override_ms_ = static_cast<int>(
+                    std::min<int64_t>(deadline,
+                                      std::numeric_limits<int>::max()));
+            }
+        }
     }
 
     logging::Get()->debug("ProxyTransaction created client_fd={} service={} "
@@ -447,10 +496,10 @@ void ProxyTransaction::FinalizeAttemptSpan(int status_code,
         auto* mgr = obs_manager();
         if (mgr) {
             const auto& cat = mgr->catalog();
+            const double elapsed = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() -
+                attempt_start_steady_).count();
             if (cat.http_client_request_duration != nullptr) {
-                auto elapsed = std::chrono::duration<double>(
-                    std::chrono::steady_clock::now() -
-                    attempt_start_steady_).count();
                 std::vector<std::pair<std::string, std::string>> labels;
                 labels.reserve(6);
                 if (!method_.empty()) {
@@ -470,6 +519,31 @@ void ProxyTransaction::FinalizeAttemptSpan(int status_code,
                                      service_name_);
                 cat.http_client_request_duration->Record(elapsed, labels);
             }
+            // rpc.client.duration: the same attempt, keyed by RPC method.
+            // A status is known for trailers-only heads and completed
+            // calls; local failures carry error.type instead.
+            if (grpc_request_ && config_.grpc.method_histograms &&
+                cat.rpc_client_duration != nullptr) {
+                std::vector<std::pair<std::string, std::string>> labels;
+                labels.reserve(6);
+                labels.emplace_back("rpc.system", "grpc");
+                labels.emplace_back(
+                    "rpc.service",
+                    grpc_service_.empty() ? "unknown" : grpc_service_);
+                labels.emplace_back(
+                    "rpc.method",
+                    grpc_method_.empty() ? "unknown" : grpc_method_);
+                if (grpc_status_ >= 0) {
+                    labels.emplace_back("rpc.grpc.status_code",
+                                         std::to_string(grpc_status_));
+                }
+                if (!error_type.empty()) {
+                    labels.emplace_back("error.type", error_type);
+                }
+                labels.emplace_back("reactor.upstream.service",
+                                     service_name_);
+                cat.rpc_client_duration->Record(elapsed, labels);
+            }
             // Matching -1 for the +1 from SetupAttemptObservability.
             // Gated on TryDecrementIfPositive winning the CAS so the
             // kill-loop / dtor backstop and this natural finalize
@@ -593,6 +667,12 @@ void ProxyTransaction::Start() {
     InvalidateStreamTimers();
     sse_stream_ = false;
     ClearPendingRetryable5xxResponse();
+    grpc_status_ = -1;
+    grpc_status_retry_ = false;
+
+    if (grpc_request_ && !ValidateGrpcRequestBody()) {
+        return;
+    }
 
     // Take a stack-local ForwardConfig() snapshot, but ONLY when
     // enforcement is live. The IsEnforcing() gate is at the CALLER:
@@ -724,6 +804,50 @@ bool ProxyTransaction::PrepareAttemptAdmission() {
         return false;
     }
 
+    // Health gate: with active health checks failing on every endpoint
+    // the breaker fails fast instead of waiting for live traffic to trip
+    // it. Only an enforcing breaker rejects; without one (or in dry-run)
+    // the balancer still routes over all endpoints. Reported under the
+    // breaker's rejected metric with reason="no_healthy_endpoint".
+    if (slice_ && slice_->config().enabled && upstream_manager_ &&
+        !upstream_manager_->HasHealthyEndpoint(service_name_)) {
+        const bool is_dry_run = slice_->config().dry_run;
+        if (auto* mgr = obs_manager()) {
+            const auto& cat = mgr->catalog();
+            if (cat.reactor_circuit_breaker_rejected != nullptr) {
+                cat.reactor_circuit_breaker_rejected->Add(
+                    1.0,
+                    {{"service", service_name_},
+                     {"reason", is_dry_run ? "no_healthy_endpoint_dry_run"
+                                           : "no_healthy_endpoint"}});
+            }
+        }
+        if (is_dry_run) {
+            logging::Get()->info(
+                "ProxyTransaction no-healthy-endpoint would-reject (dry-run) "
+                "client_fd={} service={} attempt={}",
+                client_fd_, service_name_, attempt_);
+        } else {
+            // Same release contract as the retry-budget reject below:
+            // the admission ConsultBreaker took must not strand a probe.
+            ReleaseBreakerAdmissionNeutral();
+            if (ResumeHeldRetryable5xxResponse("no_healthy_endpoint")) {
+                return false;
+            }
+            if (DeliverPendingRetryable5xxResponse("no_healthy_endpoint")) {
+                return false;
+            }
+            state_ = State::FAILED;
+            logging::Get()->info(
+                "ProxyTransaction no-healthy-endpoint reject client_fd={} "
+                "service={} attempt={}",
+                client_fd_, service_name_, attempt_);
+            DeliverResponse(AdaptLocalError(MakeCircuitOpenResponse(),
+                                            RESULT_CIRCUIT_OPEN));
+            return false;
+        }
+    }
+
     // Retry-budget gate for retry attempts (attempt_ > 0). Gating here
     // rather than in MaybeRetry means a delayed retry holds no token
     // during its backoff sleep — the budget's `retries_in_flight`
@@ -779,7 +903,8 @@ bool ProxyTransaction::PrepareAttemptAdmission() {
                 return false;
             }
             state_ = State::FAILED;
-            DeliverResponse(MakeRetryBudgetResponse());
+            DeliverResponse(AdaptLocalError(MakeRetryBudgetResponse(),
+                                            RESULT_RETRY_BUDGET_EXHAUSTED));
             return false;
         }
     }
@@ -812,12 +937,21 @@ void ProxyTransaction::EnsureCheckoutCancelToken() {
     }
 }
 
+void ProxyTransaction::SelectAttemptPartition() {
+    attempt_partition_ = nullptr;
+    if (upstream_manager_ && dispatcher_index_ >= 0) {
+        attempt_partition_ = upstream_manager_->SelectPartition(
+            service_name_, static_cast<size_t>(dispatcher_index_), lb_hash_);
+    }
+    outlier_partition_ = attempt_partition_;
+    outlier_attempt_start_ = std::chrono::steady_clock::now();
+}
+
 void ProxyTransaction::StartCheckoutAsync() {
     auto self = shared_from_this();
 
     upstream_manager_->CheckoutAsync(
-        service_name_,
-        static_cast<size_t>(dispatcher_index_),
+        attempt_partition_,
         // ready callback
         [self](UpstreamLease lease) {
             self->OnCheckoutReady(std::move(lease));
@@ -930,6 +1064,16 @@ void ProxyTransaction::AttemptCheckout() {
     ActivateAttemptTracking();
     EnsureCheckoutCancelToken();
     SetupAttemptObservability();
+    SelectAttemptPartition();
+
+    // gRPC deadline propagation: each attempt tells the upstream how much
+    // of the client's deadline is left, so a retry never outlives it.
+    if (grpc_request_ && config_.grpc.propagate_timeout &&
+        upstream_deadline_override_ms_ > 0) {
+        rewritten_headers_["grpc-timeout"] =
+            GRPC_NAMESPACE::FormatTimeout(ResponseTimeoutBudgetMs());
+        serialized_request_.clear();
+    }
 
     // Fast path: if a usable multiplexed H2 session already exists for
     // this upstream, dispatch onto it without consuming a pool slot.
@@ -947,8 +1091,7 @@ void ProxyTransaction::AttemptCheckout() {
 
 bool ProxyTransaction::TryDispatchExistingH2Session() {
     if (!upstream_manager_ || dispatcher_index_ < 0) return false;
-    PoolPartition* partition = upstream_manager_->GetPoolPartition(
-        service_name_, static_cast<size_t>(dispatcher_index_));
+    PoolPartition* partition = attempt_partition_;
     if (!partition) return false;
     auto cfg = partition->LoadHttp2ConfigSnapshot();
     if (!cfg || !cfg->enabled || cfg->prefer == "never") return false;
@@ -1074,11 +1217,7 @@ void ProxyTransaction::OnCheckoutReady(UpstreamLease lease) {
     // commits are observed). For TLS upstreams in `auto` prefer mode
     // we wait for the handshake-complete callback to read ALPN; bare
     // TCP `auto` falls through to H1 (no ALPN signal available).
-    PoolPartition* partition = nullptr;
-    if (upstream_manager_ && dispatcher_index_ >= 0) {
-        partition = upstream_manager_->GetPoolPartition(
-            service_name_, static_cast<size_t>(dispatcher_index_));
-    }
+    PoolPartition* partition = attempt_partition_;
     std::shared_ptr<const Http2UpstreamConfig> cfg;
     if (partition) cfg = partition->LoadHttp2ConfigSnapshot();
 
@@ -1231,7 +1370,7 @@ void ProxyTransaction::SendH1StreamingRequest_(
     // socket actually drains, and the pool's far-future checkout deadline
     // never trips. SetWriteProgressCb also resumes the pump when the
     // transport buffer drains below low-water (see PumpH1StreamingBody_).
-    h1_stall_budget_ms_ = ComputeH2StallBudgetMs(config_.response_timeout_ms);
+    h1_stall_budget_ms_ = ComputeH2StallBudgetMs(ResponseTimeoutBudgetMs());
     ArmResponseTimeout(h1_stall_budget_ms_);
     {
         std::weak_ptr<ProxyTransaction> weak_self = weak_from_this();
@@ -1335,6 +1474,12 @@ void ProxyTransaction::PumpH1StreamingBody_() {
     }
     char buf[MAX_CHUNK_BYTES];
     while (true) {
+        // A send failure can end this attempt from inside SendRaw and
+        // start a retry that rewinds a replay buffer; what is left of the
+        // body belongs to the next attempt's connection.
+        if (lease_.Get() != uc) {
+            return;
+        }
         // Pause on transport backpressure BEFORE pulling more from the
         // body_stream — the Read() call would release inbound producer
         // backpressure, causing the inbound queue to grow even though
@@ -1539,11 +1684,7 @@ void ProxyTransaction::DispatchH2() {
         return;
     }
 
-    PoolPartition* partition = nullptr;
-    if (upstream_manager_ && dispatcher_index_ >= 0) {
-        partition = upstream_manager_->GetPoolPartition(
-            service_name_, static_cast<size_t>(dispatcher_index_));
-    }
+    PoolPartition* partition = attempt_partition_;
     if (!partition) {
         MaybeRetry(RetryPolicy::RetryCondition::CONNECT_FAILURE);
         return;
@@ -1642,7 +1783,7 @@ void ProxyTransaction::DispatchH2() {
     h2_request_fully_sent_ = false;
 
     h2_stall_budget_ms_ = ComputeH2StallBudgetMs(
-        config_.response_timeout_ms);
+        ResponseTimeoutBudgetMs());
     h2_last_progress_at_ = std::chrono::steady_clock::now();
     ArmH2SendStallDeadline(h2_stall_budget_ms_);
 
@@ -1808,7 +1949,8 @@ void ProxyTransaction::OnCheckoutError(int error_code) {
         if (DeliverPendingRetryable5xxResponse("checkout_circuit_open")) {
             return;
         }
-        DeliverResponse(MakeCircuitOpenResponse());
+        DeliverResponse(
+            AdaptLocalError(MakeCircuitOpenResponse(), RESULT_CIRCUIT_OPEN));
         return;
     }
 
@@ -1908,7 +2050,7 @@ void ProxyTransaction::SendUpstreamRequest() {
     // (response_timeout_ms == 0) opts out of the response-wait timeout,
     // NOT the hang protection.
     const int stall_budget_ms = ComputeH2StallBudgetMs(
-        config_.response_timeout_ms);
+        ResponseTimeoutBudgetMs());
     ArmResponseTimeout(stall_budget_ms);
 
     // Install write-progress callback to refresh the stall deadline on
@@ -2107,9 +2249,30 @@ bool ProxyTransaction::OnHeaders(
         ClearResponseTimeout();
     }
 
-    if (head.status_code >= HttpStatus::INTERNAL_SERVER_ERROR &&
-        head.status_code < 600) {
-        ReportBreakerOutcome(-1000);
+    const bool http_5xx = head.status_code >= HttpStatus::INTERNAL_SERVER_ERROR &&
+                          head.status_code < 600;
+    grpc_status_ = -1;
+    grpc_status_retry_ = false;
+    if (grpc_request_) {
+        grpc_response_framer_ =
+            GRPC_NAMESPACE::MessageFramer(config_.grpc.max_message_bytes);
+        // Trailers-only response: grpc-status rides in the head, so the
+        // call's outcome is known now and can drive retry + breaker the
+        // same way an HTTP 5xx does.
+        if (auto code = GRPC_NAMESPACE::FindStatus(head.headers)) {
+            grpc_status_ = *code;
+            if (!http_5xx) {
+                ReportGrpcBreakerOutcome(grpc_status_);
+                grpc_status_retry_ =
+                    GRPC_NAMESPACE::Contains(grpc_retry_on_, grpc_status_);
+            }
+        }
+    }
+
+    if (http_5xx || grpc_status_retry_) {
+        if (http_5xx) {
+            ReportBreakerOutcome(-1000);
+        }
         if (ShouldRetryResponse5xx() && CanRetryResponse5xxNow()) {
             retry_from_headers_pending_ = true;
             poison_connection_ = true;
@@ -2137,8 +2300,10 @@ bool ProxyTransaction::OnHeaders(
         } else if (ShouldRetryResponse5xx()) {
             logging::Get()->info(
                 "ProxyTransaction relaying current upstream 5xx client_fd={} "
-                "service={} status={} attempt={} because retry is unavailable",
-                client_fd_, service_name_, head.status_code, attempt_);
+                "service={} status={} grpc_status={} attempt={} because "
+                "retry is unavailable",
+                client_fd_, service_name_, head.status_code, grpc_status_,
+                attempt_);
         }
     }
 
@@ -2176,6 +2341,21 @@ bool ProxyTransaction::OnBodyChunk(const char* data, size_t len) {
     }
     RefreshStreamIdleTimer();
 
+    if (grpc_request_) {
+        auto framed = grpc_response_framer_.Feed(data, len);
+        if (framed != GRPC_NAMESPACE::MessageFramer::Result::OK) {
+            poison_connection_ = true;
+            if (framed == GRPC_NAMESPACE::MessageFramer::Result::OVERSIZE) {
+                OnError(RESULT_RESPONSE_TOO_LARGE,
+                        "Upstream gRPC message exceeds max_message_bytes");
+            } else {
+                OnError(RESULT_PARSE_ERROR,
+                        "Upstream gRPC response framing is malformed");
+            }
+            return false;
+        }
+    }
+
     if (relay_mode_ == RelayMode::BUFFERED) {
         if (response_body_.size() >= UpstreamHttpCodec::MAX_RESPONSE_BODY_SIZE ||
             len > UpstreamHttpCodec::MAX_RESPONSE_BODY_SIZE - response_body_.size()) {
@@ -2204,10 +2384,39 @@ bool ProxyTransaction::OnBodyChunk(const char* data, size_t len) {
     return true;
 }
 
+void ProxyTransaction::OnInterimHeaders(
+    int status_code,
+    const std::vector<std::pair<std::string, std::string>>& headers) {
+    if (cancelled_ || IsKilledForShutdown()) return;
+    if (!config_.relay_early_hints || !interim_sender_) return;
+    if (status_code != HttpStatus::EARLY_HINTS) return;
+    // Only while the final response is still outstanding (the upstream
+    // may answer before the request write is acknowledged, so the state
+    // can still read CHECKOUT_PENDING / SENDING_REQUEST). The downstream
+    // sender drops late interims too; this just avoids the work.
+    if (state_ == State::RECEIVING_BODY || state_ == State::COMPLETE ||
+        state_ == State::FAILED) {
+        return;
+    }
+    auto relay = HTTP_EARLY_HINTS_NAMESPACE::FilterRelayableHeaders(headers);
+    if (relay.empty()) return;
+    logging::Get()->debug("ProxyTransaction relaying 103 service={} links={}",
+                          service_name_, relay.size());
+    interim_sender_(HttpStatus::EARLY_HINTS, relay);
+}
+
 void ProxyTransaction::OnTrailers(
     const std::vector<std::pair<std::string, std::string>>& trailers) {
     if (cancelled_ || IsKilledForShutdown()) return;
-    if (!config_.forward_trailers) return;
+    if (grpc_request_) {
+        // grpc-status lives here for every non-trailers-only call, so
+        // gRPC mode forwards trailers regardless of forward_trailers.
+        if (auto code = GRPC_NAMESPACE::FindStatus(trailers)) {
+            grpc_status_ = *code;
+        }
+    } else if (!config_.forward_trailers) {
+        return;
+    }
     if (client_http_major_ == 2) {
         // H2 downstream: sanitize pseudo-headers, hop-by-hop, and framing
         // headers; no Trailer declaration enforcement (H2 doesn't use it).
@@ -2298,7 +2507,7 @@ void ProxyTransaction::OnUpstreamWriteComplete(
     // the fallback stall deadline explicitly — otherwise a slow but
     // legitimate response would be capped at SEND_STALL_FALLBACK_MS
     // (30s), contradicting the documented "disabled" semantic.
-    if (config_.response_timeout_ms > 0) {
+    if (ResponseTimeoutBudgetMs() > 0) {
         ArmResponseTimeout();
     } else {
         ClearResponseTimeout();
@@ -2315,7 +2524,12 @@ void ProxyTransaction::OnResponseComplete() {
         // 5xx outcomes are reported at headers so retry/breaker gates see the
         // failure before deciding whether another attempt is allowed.
     } else if (response_head_.status_code >= HttpStatus::BAD_REQUEST) {
+        // Neutral for the breaker, but the endpoint did answer: a
+        // success as far as outlier detection is concerned.
+        ReportOutlierOutcome(RESULT_SUCCESS);
         ReleaseBreakerAdmissionNeutral();
+    } else if (grpc_request_ && grpc_status_ >= 0) {
+        ReportGrpcBreakerOutcome(grpc_status_);
     } else {
         ReportBreakerOutcome(RESULT_SUCCESS);
     }
@@ -2422,7 +2636,7 @@ void ProxyTransaction::OnRequestSubmitted() {
         // under the deferred-drain dispatch semantic (sink virtuals
         // fire from real wire-drain callbacks; a stuck transport
         // keeps the send-stall closure armed).
-        if (config_.response_timeout_ms > 0) {
+        if (ResponseTimeoutBudgetMs() > 0) {
             ArmResponseTimeout();
             h2_response_timeout_armed_ = true;
         } else {
@@ -2587,7 +2801,7 @@ void ProxyTransaction::DeliverTerminalError(int result_code,
     HttpResponse error_response = (result_code == RESULT_CIRCUIT_OPEN)
         ? MakeCircuitOpenResponse()
         : MakeErrorResponse(result_code);
-    DeliverResponse(std::move(error_response));
+    DeliverResponse(AdaptLocalError(std::move(error_response), result_code));
 }
 
 void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
@@ -2607,8 +2821,21 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
         // operators can distinguish the failure reason from logs/metrics.
         const bool replay_safe = retry_policy_.IsMethodRetryableForReplay(method_);
         const bool headers_queued = request_headers_submitted_;
+        // With a replay buffer holding every byte read so far, the next
+        // attempt resends them from the start: consumed source and body
+        // bytes on the wire no longer rule the retry out.
+        const bool rewound =
+            (source_consumed_ || body_bytes_written_to_upstream_ > 0) &&
+            replay_body_ && replay_body_->Rewind();
+        if (rewound) {
+            logging::Get()->debug(
+                "streaming retry rewinds replay buffer bytes={} spilled={}",
+                replay_body_->recorded_bytes(), replay_body_->spilled_bytes());
+            // The half-sent request must not return to the idle pool.
+            poison_connection_ = true;
+        }
 
-        if (source_consumed_) {
+        if (source_consumed_ && !rewound) {
             logging::Get()->debug(
                 "streaming retry blocked: source consumed drained={}",
                 body_bytes_written_to_upstream_);
@@ -2621,7 +2848,7 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
                                  "streaming source consumed before failure");
             return;
         }
-        if (body_bytes_written_to_upstream_ > 0) {
+        if (body_bytes_written_to_upstream_ > 0 && !rewound) {
             logging::Get()->debug(
                 "streaming retry blocked: body bytes on wire count={}",
                 body_bytes_written_to_upstream_);
@@ -2646,7 +2873,21 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
         streaming_tombstone_pending = headers_queued && replay_safe;
     }
 
-    if (retry_policy_.ShouldRetry(attempt_, method_, condition, response_committed_)) {
+    // A trailers-only gRPC failure rides the RESPONSE_5XX hold/replay
+    // machinery but is gated by its own policy condition.
+    const RetryPolicy::RetryCondition policy_condition =
+        (condition == RetryPolicy::RetryCondition::RESPONSE_5XX &&
+         grpc_status_retry_)
+            ? RetryPolicy::RetryCondition::GRPC_STATUS
+            : condition;
+    // An expired per-request deadline ends the call: another attempt
+    // could only time out again.
+    const bool deadline_left =
+        upstream_deadline_override_ms_ <= 0 || DeadlineRemainingMs() > 0;
+
+    if (deadline_left &&
+        retry_policy_.ShouldRetry(attempt_, method_, policy_condition,
+                                  response_committed_)) {
         if (streaming_tombstone_pending) {
             TombstonePreBodyHeadersForRetry_();
         }
@@ -2702,6 +2943,7 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
                 case RetryPolicy::RetryCondition::RESPONSE_TIMEOUT:
                     prev_error = "timeout"; break;
                 case RetryPolicy::RetryCondition::RESPONSE_5XX:
+                case RetryPolicy::RetryCondition::GRPC_STATUS:
                     break;
             }
             FinalizeAttemptSpan(/*status_code=*/0, prev_error);
@@ -2716,7 +2958,7 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
             const auto& cat = mgr->catalog();
             if (cat.reactor_upstream_retries != nullptr) {
                 const char* reason = "unknown";
-                switch (condition) {
+                switch (policy_condition) {
                     case RetryPolicy::RetryCondition::CONNECT_FAILURE:
                         reason = "connect_failure"; break;
                     case RetryPolicy::RetryCondition::UPSTREAM_DISCONNECT:
@@ -2725,6 +2967,8 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
                         reason = "timeout"; break;
                     case RetryPolicy::RetryCondition::RESPONSE_5XX:
                         reason = "response_5xx"; break;
+                    case RetryPolicy::RetryCondition::GRPC_STATUS:
+                        reason = "grpc_status"; break;
                 }
                 cat.reactor_upstream_retries->Add(1.0, {
                     {"reactor.upstream.service", service_name_},
@@ -2870,6 +3114,7 @@ void ProxyTransaction::MaybeRetry(RetryPolicy::RetryCondition condition) {
             result_code = RESULT_UPSTREAM_DISCONNECT;
             break;
         case RetryPolicy::RetryCondition::RESPONSE_5XX:
+        case RetryPolicy::RetryCondition::GRPC_STATUS:
             // On 5xx with no retry, deliver the actual upstream response
             // (which may contain useful error details for the client).
             {
@@ -3093,6 +3338,7 @@ void ProxyTransaction::Cancel() {
         body_stream_->Abort("proxy_transaction_cancel");
         body_stream_.reset();
     }
+    replay_body_.reset();
     // Release the upstream lease back to the pool (or destroy it if
     // poisoned) and clear transport callbacks so any in-flight upstream
     // bytes land harmlessly.
@@ -3255,6 +3501,7 @@ void ProxyTransaction::Cleanup() {
             body_stream_->Abort("proxy_transaction_cleanup");
         }
         body_stream_.reset();
+        replay_body_.reset();
     }
 }
 
@@ -3356,6 +3603,7 @@ void ProxyTransaction::ResetForRetryAttempt() {
     paused_parse_bytes_.clear();
     InvalidateStreamTimers();
     sse_stream_ = false;
+    grpc_status_ = -1;
     // Per-attempt request-send progress flags. Without resetting, the
     // retry's first OnUpstreamWriteComplete (headers ack) sees a stale
     // h1_streaming_send_complete_=true and transitions to
@@ -3364,6 +3612,7 @@ void ProxyTransaction::ResetForRetryAttempt() {
     // DispatchH2 / Cleanup; H1 needs explicit reset here.
     h1_streaming_send_complete_ = false;
     h1_request_fully_sent_ = false;
+    h1_pump_paused_for_drain_ = false;
     request_headers_submitted_ = false;
 }
 
@@ -3502,6 +3751,7 @@ void ProxyTransaction::BeginRetryAttemptFromHeld5xx() {
     // invisible in the trace tree and replays the prior attempt's
     // traceparent on its serialized request.
     SetupAttemptObservability();
+    SelectAttemptPartition();
     StartCheckoutAsync();
 }
 
@@ -3561,6 +3811,8 @@ bool ProxyTransaction::CommitStreamingResponse() {
         return false;
     }
     response_committed_ = true;
+    // Committed responses are never retried: the replay copy is dead weight.
+    if (replay_body_) replay_body_->StopRecording();
     return true;
 }
 
@@ -3579,6 +3831,11 @@ ProxyTransaction::RelayMode ProxyTransaction::DecideRelayMode(
     if (IsNoBodyResponse(head)) {
         return RelayMode::BUFFERED;
     }
+    // Streaming RPCs must not wait for the upstream to finish; unary
+    // calls lose nothing by streaming either.
+    if (grpc_request_) {
+        return RelayMode::STREAMING;
+    }
     if (IsSseStream(head)) {
         return RelayMode::STREAMING;
     }
@@ -3606,6 +3863,10 @@ bool ProxyTransaction::IsNoBodyResponse(
 }
 
 bool ProxyTransaction::ShouldRetryResponse5xx() const {
+    if (grpc_status_retry_) {
+        return retry_policy_.ShouldRetry(
+            attempt_, method_, RetryPolicy::RetryCondition::GRPC_STATUS, false);
+    }
     if (response_head_.status_code < HttpStatus::INTERNAL_SERVER_ERROR ||
         response_head_.status_code >= 600) {
         return false;
@@ -3778,8 +4039,15 @@ void ProxyTransaction::ScheduleStreamIdleCheck(
 
 void ProxyTransaction::ArmStreamBudgetTimer() {
     ++stream_budget_timer_generation_;
+    // A per-request deadline also bounds the body phase.
+    int64_t budget_ms =
+        static_cast<int64_t>(config_.stream_max_duration_sec) * 1000;
+    if (upstream_deadline_override_ms_ > 0) {
+        int64_t left = std::max<int64_t>(1, DeadlineRemainingMs());
+        budget_ms = budget_ms > 0 ? std::min(budget_ms, left) : left;
+    }
     if (!dispatcher_ || !response_headers_seen_ || body_complete_ ||
-        cancelled_ || config_.stream_max_duration_sec == 0) {
+        cancelled_ || budget_ms <= 0) {
         return;
     }
 
@@ -3791,8 +4059,7 @@ void ProxyTransaction::ArmStreamBudgetTimer() {
                 self->OnStreamBudgetTimeout(generation);
             }
         },
-        std::chrono::milliseconds(
-            static_cast<int64_t>(config_.stream_max_duration_sec) * 1000));
+        std::chrono::milliseconds(budget_ms));
 }
 
 void ProxyTransaction::InvalidateStreamTimers() {
@@ -3850,7 +4117,7 @@ void ProxyTransaction::ArmResponseTimeout(int explicit_budget_ms) {
     // silently skip.
     int budget_ms = explicit_budget_ms > 0
                   ? explicit_budget_ms
-                  : config_.response_timeout_ms;
+                  : ResponseTimeoutBudgetMs();
     if (budget_ms <= 0) {
         return;
     }
@@ -4117,10 +4384,12 @@ HttpResponse ProxyTransaction::MakeCircuitOpenResponse() const {
             retry_after_secs = std::min(hint, RETRY_AFTER_ABS_MAX_SECS);
             breaker_label = "half_open";
         }
-        // Any other state (CLOSED): shouldn't reach here — ConsultBreaker
-        // only calls this on REJECTED_OPEN. Fall through with the
-        // conservative defaults (Retry-After=1, label="open") so a
-        // regression can't silently emit Retry-After=0.
+        // Any other state (CLOSED): ConsultBreaker only calls this on
+        // REJECTED_OPEN; the one CLOSED caller is the no-healthy-endpoint
+        // gate in PrepareAttemptAdmission, where the next health-check
+        // interval is the wait. Fall through with the conservative
+        // defaults (Retry-After=1, label="open") so a regression can't
+        // silently emit Retry-After=0.
     }
 
     HttpResponse resp;
@@ -4149,6 +4418,103 @@ HttpResponse ProxyTransaction::MakeRetryBudgetResponse() {
     return resp;
 }
 
+int ProxyTransaction::GrpcStatusForResult(int result_code) {
+    switch (result_code) {
+        case RESULT_RESPONSE_TIMEOUT:
+            return GRPC_NAMESPACE::DEADLINE_EXCEEDED;
+        case RESULT_RESPONSE_TOO_LARGE:
+        case RESULT_REQUEST_BODY_LIMIT_EXCEEDED:
+            return GRPC_NAMESPACE::RESOURCE_EXHAUSTED;
+        case RESULT_PARSE_ERROR:
+        case RESULT_TRUNCATED_RESPONSE:
+            return GRPC_NAMESPACE::INTERNAL;
+        default:
+            return GRPC_NAMESPACE::UNAVAILABLE;
+    }
+}
+
+HttpResponse ProxyTransaction::MakeGrpcErrorResponse(
+        int grpc_status, const std::string& message) {
+    // Trailers-only: the status travels in the only HEADERS block. The
+    // message is ours (ASCII, no '%'), so it needs no percent-encoding.
+    HttpResponse resp;
+    resp.Status(HttpStatus::OK);
+    resp.Header("Content-Type", "application/grpc");
+    resp.Header("grpc-status", std::to_string(grpc_status));
+    if (!message.empty()) {
+        resp.Header("grpc-message", message);
+    }
+    return resp;
+}
+
+HttpResponse ProxyTransaction::AdaptLocalError(HttpResponse response,
+                                                int result_code) const {
+    if (!grpc_request_) {
+        return response;
+    }
+    HttpResponse grpc = MakeGrpcErrorResponse(
+        GrpcStatusForResult(result_code),
+        "proxy: " + std::to_string(response.GetStatusCode()) + " " +
+            response.GetStatusReason());
+    for (const auto& [name, value] : response.GetHeaders()) {
+        if (name.rfind("X-", 0) == 0 || name == "Retry-After") {
+            grpc.Header(name, value);
+        }
+    }
+    return grpc;
+}
+
+int64_t ProxyTransaction::DeadlineRemainingMs() const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    return static_cast<int64_t>(upstream_deadline_override_ms_) - elapsed;
+}
+
+int ProxyTransaction::ResponseTimeoutBudgetMs() const {
+    if (upstream_deadline_override_ms_ <= 0) {
+        return config_.response_timeout_ms;
+    }
+    return static_cast<int>(std::max<int64_t>(1, DeadlineRemainingMs()));
+}
+
+bool ProxyTransaction::ValidateGrpcRequestBody() {
+    // Streaming bodies are relayed as they arrive; only a buffered body
+    // can be checked before the upstream sees it.
+    if (is_streaming_request_ || request_body_.empty()) {
+        return true;
+    }
+    GRPC_NAMESPACE::MessageFramer framer(config_.grpc.max_message_bytes);
+    auto result = framer.Feed(request_body_.data(), request_body_.size());
+    if (result == GRPC_NAMESPACE::MessageFramer::Result::OK &&
+        framer.AtBoundary()) {
+        return true;
+    }
+    const bool oversize =
+        result == GRPC_NAMESPACE::MessageFramer::Result::OVERSIZE;
+    logging::Get()->warn(
+        "ProxyTransaction rejecting gRPC request client_fd={} service={} "
+        "path={}: {}",
+        client_fd_, service_name_, path_,
+        oversize ? "message exceeds max_message_bytes"
+                 : "malformed message framing");
+    state_ = State::FAILED;
+    DeliverResponse(MakeGrpcErrorResponse(
+        oversize ? GRPC_NAMESPACE::RESOURCE_EXHAUSTED
+                 : GRPC_NAMESPACE::INTERNAL,
+        oversize ? "proxy: request message too large"
+                 : "proxy: malformed request message framing"));
+    return false;
+}
+
+void ProxyTransaction::ReportGrpcBreakerOutcome(int grpc_status) {
+    // -1000 is ReportBreakerOutcome's 5xx sentinel: a failure-set status
+    // is an upstream health signal of the same weight.
+    ReportBreakerOutcome(
+        GRPC_NAMESPACE::Contains(grpc_breaker_failure_on_, grpc_status)
+            ? -1000
+            : RESULT_SUCCESS);
+}
+
 bool ProxyTransaction::ConsultBreaker() {
     if (!slice_) {
         // No breaker attached for this service. Proceed as if the
@@ -4202,7 +4568,8 @@ bool ProxyTransaction::ConsultBreaker() {
             "ProxyTransaction circuit-open reject client_fd={} service={} "
             "attempt={}",
             client_fd_, service_name_, attempt_);
-        DeliverResponse(MakeCircuitOpenResponse());
+        DeliverResponse(
+            AdaptLocalError(MakeCircuitOpenResponse(), RESULT_CIRCUIT_OPEN));
         // Clear admission_generation_ — there's nothing to Report.
         admission_generation_ = 0;
         return false;
@@ -4294,7 +4661,50 @@ RetryPolicy::RetryCondition ProxyTransaction::MapH2CodeToRetryCondition(
     }
 }
 
+void ProxyTransaction::ReportOutlierOutcome(int result_code) {
+    const PoolPartition* partition = outlier_partition_;
+    if (!partition || !upstream_manager_ || dispatcher_index_ < 0) return;
+    outlier_partition_ = nullptr;
+
+    bool failure = false;
+    bool responded = false;
+    switch (result_code) {
+        case RESULT_SUCCESS:
+            responded = true;
+            break;
+        case -1000:  // ReportBreakerOutcome's 5xx sentinel
+            failure = true;
+            responded = true;
+            break;
+        case RESULT_CHECKOUT_FAILED:
+        case RESULT_RESPONSE_TIMEOUT:
+        case RESULT_UPSTREAM_DISCONNECT:
+        case RESULT_SEND_FAILED:
+        case RESULT_PARSE_ERROR:
+        case RESULT_TRUNCATED_RESPONSE:
+            failure = true;
+            break;
+        default:
+            // Local limits, policy rejects, GOAWAY and retry denials say
+            // nothing about this endpoint — same split as the breaker's
+            // neutral outcomes.
+            return;
+    }
+    // Latency is time to response headers, so a long streamed body
+    // doesn't read as a slow endpoint.
+    int64_t latency_ms = -1;
+    if (responded && response_headers_at_ >= outlier_attempt_start_) {
+        latency_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            response_headers_at_ - outlier_attempt_start_).count();
+    }
+    upstream_manager_->RecordEndpointOutcome(
+        service_name_, static_cast<size_t>(dispatcher_index_), partition,
+        failure, latency_ms);
+}
+
 void ProxyTransaction::ReportBreakerOutcome(int result_code) {
+    ReportOutlierOutcome(result_code);
+
     // No slice, or already reported: bail. admission_generation_==0 is
     // the sentinel — slice domain generations start at 1, so a 0 gen
     // would be rejected as stale anyway; the early return just avoids
@@ -4311,9 +4721,9 @@ void ProxyTransaction::ReportBreakerOutcome(int result_code) {
 
     using CIRCUIT_BREAKER_NAMESPACE::FailureKind;
 
-    // Synthetic sentinel for the OnResponseComplete 5xx path — maps to
-    // RESPONSE_5XX without needing a new public result code. Callers
-    // other than OnResponseComplete never use this value.
+    // Synthetic sentinel for upstream 5xx (and gRPC failure-set
+    // statuses) — maps to RESPONSE_5XX without needing a new public
+    // result code.
     static constexpr int SENTINEL_5XX = -1000;
 
     switch (result_code) {
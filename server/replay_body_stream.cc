@@ -0,0 +1,202 @@
+#include "upstream/replay_body_stream.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+
+ReplayBodyStream::ReplayBodyStream(std::shared_ptr<http::BodyStream> source,
+                                   const ProxyReplayBufferConfig& config)
+    : source_(std::move(source)),
+      max_bytes_(static_cast<size_t>(std::max<int64_t>(config.max_bytes, 0))),
+      memory_bytes_(std::min(
+          max_bytes_,
+          static_cast<size_t>(std::max<int64_t>(config.memory_bytes, 0)))),
+      spill_dir_(config.spill_dir) {}
+
+ReplayBodyStream::~ReplayBodyStream() {
+    if (map_) munmap(map_, map_len_);
+    if (spill_fd_ >= 0) close(spill_fd_);
+}
+
+bool ReplayBodyStream::Rewind() {
+    if (dropped_ || stop_requested_) return false;
+    if (spilled_ > map_len_) {
+        if (map_) munmap(map_, map_len_);
+        map_ = nullptr;
+        map_len_ = 0;
+        void* map = mmap(nullptr, spilled_, PROT_READ, MAP_SHARED, spill_fd_, 0);
+        if (map == MAP_FAILED) {
+            logging::Get()->debug("Replay buffer: mmap failed errno={}", errno);
+            Drop("mmap failed");
+            return false;
+        }
+        map_ = map;
+        map_len_ = spilled_;
+    }
+    cursor_ = 0;
+    return true;
+}
+
+void ReplayBodyStream::StopRecording() {
+    if (dropped_) return;
+    if (cursor_ >= recorded_) {
+        Drop("no retry possible");
+    } else {
+        // Mid-replay: the rest of the recording is still owed upstream.
+        stop_requested_ = true;
+    }
+}
+
+bool ReplayBodyStream::Record(const char* data, size_t len) {
+    if (len > max_bytes_ - recorded_) return false;
+    const size_t in_memory =
+        std::min(len, memory_bytes_ - std::min(memory_bytes_, memory_.size()));
+    memory_.append(data, in_memory);
+    if (in_memory < len && !Spill(data + in_memory, len - in_memory)) {
+        return false;
+    }
+    recorded_ += len;
+    return true;
+}
+
+bool ReplayBodyStream::Spill(const char* data, size_t len) {
+    if (spill_fd_ < 0) {
+        std::string path = spill_dir_ + "/reactor-replay-XXXXXX";
+        spill_fd_ = mkstemp(path.data());
+        if (spill_fd_ < 0) {
+            logging::Get()->debug("Replay buffer: mkstemp in {} failed errno={}",
+                                  spill_dir_, errno);
+            return false;
+        }
+        // Unlinked at once: the descriptor and mapping keep the blocks.
+        unlink(path.c_str());
+    }
+    // write() rather than writing through a mapping, so a full disk
+    // fails here with ENOSPC instead of SIGBUS on a later read.
+    while (len > 0) {
+        ssize_t n = write(spill_fd_, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            logging::Get()->debug("Replay buffer: spill write failed errno={}", errno);
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+        spilled_ += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void ReplayBodyStream::Drop(const char* why) {
+    logging::Get()->debug("Replay buffer dropped after {} bytes: {}", recorded_, why);
+    dropped_ = true;
+    stop_requested_ = false;
+    std::string().swap(memory_);
+    if (map_) munmap(map_, map_len_);
+    map_ = nullptr;
+    map_len_ = 0;
+    if (spill_fd_ >= 0) close(spill_fd_);
+    spill_fd_ = -1;
+    spilled_ = 0;
+    recorded_ = 0;
+    cursor_ = 0;
+}
+
+size_t ReplayBodyStream::ReadRecorded(char* buf, size_t max_len) {
+    size_t n = std::min(max_len, recorded_ - cursor_);
+    if (cursor_ < memory_.size()) {
+        n = std::min(n, memory_.size() - cursor_);
+        std::memcpy(buf, memory_.data() + cursor_, n);
+    } else {
+        // Rewind mapped everything spilled so far, and bytes are only
+        // recorded once the replay has caught up.
+        const size_t offset = cursor_ - memory_.size();
+        n = std::min(n, map_len_ - offset);
+        std::memcpy(buf, static_cast<const char*>(map_) + offset, n);
+    }
+    cursor_ += n;
+    if (stop_requested_ && cursor_ == recorded_) Drop("no retry possible");
+    return n;
+}
+
+http::BodyStreamResult ReplayBodyStream::Read(char* buf, size_t max_len,
+                                              size_t* bytes_read) {
+    if (cursor_ < recorded_ && max_len > 0) {
+        *bytes_read = ReadRecorded(buf, max_len);
+        return http::BodyStreamResult::OK;
+    }
+    auto rc = source_->Read(buf, max_len, bytes_read);
+    if (rc == http::BodyStreamResult::OK && *bytes_read > 0 && !dropped_) {
+        if (Record(buf, *bytes_read)) {
+            cursor_ = recorded_;
+        } else {
+            Drop("max_bytes exceeded or spill failed");
+        }
+    }
+    return rc;
+}
+
+bool ReplayBodyStream::IsEndOfStream() const {
+    return cursor_ >= recorded_ && source_->IsEndOfStream();
+}
+
+bool ReplayBodyStream::Aborted() const {
+    return source_->Aborted();
+}
+
+const std::vector<std::pair<std::string, std::string>>&
+ReplayBodyStream::Trailers() const {
+    return source_->Trailers();
+}
+
+const std::string& ReplayBodyStream::AbortReason() const {
+    return source_->AbortReason();
+}
+
+void ReplayBodyStream::WaitForData(DataAvailableCallback callback) {
+    if (cursor_ < recorded_) {
+        // Recorded bytes are readable now; resume on the next loop turn
+        // like a producer push would.
+        if (auto d = consumer_dispatcher_.lock()) {
+            d->EnQueue(std::move(callback));
+        }
+        return;
+    }
+    source_->WaitForData(std::move(callback));
+}
+
+size_t ReplayBodyStream::BytesQueued() const {
+    return (recorded_ - cursor_) + source_->BytesQueued();
+}
+
+void ReplayBodyStream::Push(std::string chunk) {
+    source_->Push(std::move(chunk));
+}
+
+void ReplayBodyStream::PushTrailersAndClose(
+    std::vector<std::pair<std::string, std::string>> trailers) {
+    source_->PushTrailersAndClose(std::move(trailers));
+}
+
+void ReplayBodyStream::CloseEmpty() {
+    source_->CloseEmpty();
+}
+
+void ReplayBodyStream::Abort(std::string reason) {
+    source_->Abort(std::move(reason));
+}
+
+http::BodyStream::SubmitSnapshot ReplayBodyStream::SnapshotForSubmit() {
+    SubmitSnapshot snap = source_->SnapshotForSubmit();
+    // Pending replay bytes make the body non-empty whatever the source
+    // has left, so a rewound request keeps its Bodied shape.
+    snap.bytes_queued += recorded_ - cursor_;
+    return snap;
+}
+
+void ReplayBodyStream::SetConsumerDispatcher(std::weak_ptr<Dispatcher> d) {
+    consumer_dispatcher_ = d;
+    source_->SetConsumerDispatcher(std::move(d));
+}
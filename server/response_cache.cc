@@ -0,0 +1,816 @@
+#include "upstream/response_cache.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "http/http_status.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+#include "observability/counter.h"
+#include "observability/metrics_catalog.h"
+#include "observability/observability_manager.h"
+
+#include <cctype>
+#include <sys/mman.h>
+
+namespace {
+
+// Header fields never stored: framing is recomputed when the entry is
+// served, Age is recomputed from the entry's own clock.
+bool IsUnstoredHeader(const std::string& lower_name) {
+    return lower_name == "age" || lower_name == "content-length" ||
+           lower_name == "transfer-encoding" || lower_name == "connection" ||
+           lower_name == "keep-alive" || lower_name == "trailer";
+}
+
+// Final statuses a shared cache may store given explicit freshness.
+// 206 is excluded: range requests bypass the cache.
+bool IsStorableStatus(int status) {
+    switch (status) {
+        case 200: case 203: case 204: case 300: case 301: case 308:
+        case 404: case 405: case 410: case 414: case 501:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string ToLower(std::string_view s) {
+    std::string out(s);
+    for (auto& c : out) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+// All values of `lower_name`, comma-joined (RFC 9110 §5.3).
+std::string JoinHeader(const std::vector<std::pair<std::string, std::string>>& headers,
+                       const std::string& lower_name, bool* present = nullptr) {
+    std::string out;
+    bool found = false;
+    for (const auto& [name, value] : headers) {
+        if (ToLower(name) != lower_name) continue;
+        if (found) out += ", ";
+        out += value;
+        found = true;
+    }
+    if (present) *present = found;
+    return out;
+}
+
+// Split a comma-separated list into trimmed, non-empty members.
+std::vector<std::string_view> SplitList(std::string_view value) {
+    std::vector<std::string_view> out;
+    size_t pos = 0;
+    while (pos <= value.size()) {
+        size_t comma = value.find(',', pos);
+        if (comma == std::string_view::npos) comma = value.size();
+        auto item = Trim(value.substr(pos, comma - pos));
+        if (!item.empty()) out.push_back(item);
+        pos = comma + 1;
+    }
+    return out;
+}
+
+// delta-seconds (RFC 9111 §1.2.2); -1 when malformed. Values past
+// 2^31 saturate as the RFC recommends.
+int64_t ParseDeltaSeconds(std::string_view s) {
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"') {
+        s = s.substr(1, s.size() - 2);
+    }
+    if (s.empty()) return -1;
+    int64_t v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return -1;
+        if (v < 2147483648LL) v = v * 10 + (c - '0');
+    }
+    return std::min<int64_t>(v, 2147483648LL);
+}
+
+struct CacheControl {
+    bool no_store = false;
+    bool no_cache = false;
+    bool private_ = false;
+    bool must_revalidate = false;
+    bool proxy_revalidate = false;
+    int64_t max_age = -1;
+    int64_t s_maxage = -1;
+    int64_t min_fresh = -1;
+    int64_t stale_while_revalidate = -1;
+    int64_t stale_if_error = -1;
+};
+
+// Directives are case-insensitive; unknown ones are ignored. The
+// qualified forms no-cache="f" and private="f" are treated as their
+// unqualified forms, which only makes the cache more conservative.
+CacheControl ParseCacheControl(std::string_view value) {
+    CacheControl cc;
+    for (auto item : SplitList(value)) {
+        auto eq = item.find('=');
+        std::string name = ToLower(Trim(item.substr(0, eq)));
+        std::string_view arg =
+            eq == std::string_view::npos ? std::string_view{} : Trim(item.substr(eq + 1));
+        if (name == "no-store") cc.no_store = true;
+        else if (name == "no-cache") cc.no_cache = true;
+        else if (name == "private") cc.private_ = true;
+        else if (name == "must-revalidate") cc.must_revalidate = true;
+        else if (name == "proxy-revalidate") cc.proxy_revalidate = true;
+        else if (name == "max-age") cc.max_age = ParseDeltaSeconds(arg);
+        else if (name == "s-maxage") cc.s_maxage = ParseDeltaSeconds(arg);
+        else if (name == "min-fresh") cc.min_fresh = ParseDeltaSeconds(arg);
+        else if (name == "stale-while-revalidate")
+            cc.stale_while_revalidate = ParseDeltaSeconds(arg);
+        else if (name == "stale-if-error")
+            cc.stale_if_error = ParseDeltaSeconds(arg);
+    }
+    return cc;
+}
+
+// IMF-fixdate only ("Sun, 06 Nov 1994 08:49:37 GMT"), which is what
+// every current origin sends. nullopt for anything else.
+std::optional<time_t> ParseHttpDate(const std::string& value) {
+    struct tm tm {};
+    const char* end = strptime(value.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+    if (!end || *end != '\0') return std::nullopt;
+    return timegm(&tm);
+}
+
+// Request values for the Vary names: "=" + value when present, "" when
+// absent, so an absent header never matches an empty one.
+std::vector<std::string> VaryValues(const std::map<std::string, std::string>& headers,
+                                    const std::vector<std::string>& vary) {
+    std::vector<std::string> out;
+    out.reserve(vary.size());
+    for (const auto& name : vary) {
+        auto it = headers.find(name);
+        out.push_back(it == headers.end()
+                          ? std::string()
+                          : "=" + std::string(Trim(it->second)));
+    }
+    return out;
+}
+
+int64_t HeaderBytes(const std::vector<std::pair<std::string, std::string>>& headers) {
+    int64_t bytes = 0;
+    for (const auto& [name, value] : headers) {
+        bytes += static_cast<int64_t>(name.size() + value.size() + 4);
+    }
+    return bytes;
+}
+
+}  // namespace
+
+const char* ResponseCache::TierName(Tier tier) noexcept {
+    return tier == Tier::MEMORY ? "memory" : "disk";
+}
+
+const char* ResponseCache::ResultName(Result result) noexcept {
+    switch (result) {
+        case Result::HIT:         return "hit";
+        case Result::STALE:       return "stale";
+        case Result::REVALIDATED: return "revalidated";
+        case Result::COLLAPSED:   return "collapsed";
+        case Result::MISS:        return "miss";
+        case Result::BYPASS:      return "bypass";
+    }
+    return "miss";
+}
+
+// --- Body ---
+
+ResponseCache::Body::Body(Tier tier,
+                          std::shared_ptr<std::atomic<int64_t>> usage,
+                          int64_t charge)
+    : tier_(tier), usage_(std::move(usage)), charge_(charge) {
+    usage_->fetch_add(charge_, std::memory_order_relaxed);
+}
+
+ResponseCache::Body::~Body() {
+    if (map_) munmap(map_, map_len_);
+    usage_->fetch_sub(charge_, std::memory_order_relaxed);
+}
+
+const char* ResponseCache::Body::data() const noexcept {
+    return map_ ? static_cast<const char*>(map_) : heap_.data();
+}
+
+size_t ResponseCache::Body::size() const noexcept {
+    return map_ ? map_len_ : heap_.size();
+}
+
+int64_t ResponseCache::Entry::AgeSec(
+    std::chrono::steady_clock::time_point now) const {
+    const auto resident = std::chrono::duration_cast<std::chrono::seconds>(
+        now - response_time).count();
+    return initial_age_sec + std::max<int64_t>(0, resident);
+}
+
+// --- Construction ---
+
+ResponseCache::ResponseCache(const ProxyCacheConfig& config)
+    : config_(config),
+      memory_(SHARD_COUNT,
+              std::max<size_t>(1, static_cast<size_t>(config.max_entries) / SHARD_COUNT)),
+      disk_(SHARD_COUNT,
+            std::max<size_t>(1, static_cast<size_t>(config.max_entries) / SHARD_COUNT)),
+      memory_usage_(std::make_shared<std::atomic<int64_t>>(0)),
+      disk_usage_(std::make_shared<std::atomic<int64_t>>(0))
+{
+    if (!config_.disk_path.empty()) {
+        struct stat st {};
+        if (stat(config_.disk_path.c_str(), &st) == 0 && S_ISDIR(st.st_mode) &&
+            access(config_.disk_path.c_str(), W_OK | X_OK) == 0) {
+            disk_enabled_ = true;
+        } else {
+            logging::Get()->warn(
+                "proxy_cache.disk_path '{}' is not a writable directory; "
+                "running with the memory tier only", config_.disk_path);
+        }
+    }
+    logging::Get()->info(
+        "Proxy response cache memory={}B disk={} collapse={}",
+        config_.memory_max_bytes,
+        disk_enabled_ ? config_.disk_path + " (" +
+                            std::to_string(config_.disk_max_bytes) + "B)"
+                      : std::string("off"),
+        config_.collapse_requests);
+}
+
+ResponseCache::~ResponseCache() = default;
+
+// --- Request classification ---
+
+ResponseCache::RequestPolicy ResponseCache::ClassifyRequest(
+    const HttpRequest& request) {
+    if (request.method != "GET" && request.method != "HEAD") {
+        return RequestPolicy::BYPASS;
+    }
+    const auto& headers = request.headers;
+    // Proxy routes stream request bodies, so body_stream is set even
+    // for a bodiless GET; the framing headers tell whether one follows.
+    // Authorized responses are per-user unless the origin says
+    // otherwise (§3.5); Range needs partial-content support the cache
+    // does not have.
+    auto cl = headers.find("content-length");
+    const bool has_body = !request.body.empty() ||
+                          headers.count("transfer-encoding") ||
+                          (cl != headers.end() && cl->second != "0");
+    if (has_body || headers.count("authorization") || headers.count("range")) {
+        return RequestPolicy::BYPASS;
+    }
+    auto cc_it = headers.find("cache-control");
+    if (cc_it != headers.end()) {
+        auto cc = ParseCacheControl(cc_it->second);
+        if (cc.no_store) return RequestPolicy::BYPASS;
+        if (cc.no_cache || cc.max_age == 0) return RequestPolicy::REFRESH;
+    } else if (auto p = headers.find("pragma");
+               p != headers.end() &&
+               ToLower(p->second).find("no-cache") != std::string::npos) {
+        return RequestPolicy::REFRESH;
+    }
+    return RequestPolicy::LOOKUP;
+}
+
+std::string ResponseCache::PrimaryKey(const std::string& service,
+                                      const HttpRequest& request) {
+    std::string key = service;
+    key += '\n';
+    if (auto it = request.headers.find("host"); it != request.headers.end()) {
+        key += ToLower(it->second);
+    }
+    key += '\n';
+    key += request.path;
+    if (!request.query.empty()) {
+        key += '?';
+        key += request.query;
+    }
+    return key;
+}
+
+std::string ResponseCache::CollapseKey(const std::string& key,
+                                       const HttpRequest& request,
+                                       const std::vector<std::string>& vary) {
+    std::string out = key;
+    for (const auto& v : VaryValues(request.headers, vary)) {
+        out += '\n';
+        out += v;
+    }
+    return out;
+}
+
+// --- Lookup ---
+
+ResponseCache::Lookup ResponseCache::Find(
+    const std::string& key, const HttpRequest& request,
+    std::chrono::steady_clock::time_point now) {
+    Lookup out;
+    RecordPtr record;
+    if (auto h = memory_.FindAndTouch(key)) {
+        record = *h;
+    } else if (disk_enabled_) {
+        if (auto d = disk_.FindAndTouch(key)) record = *d;
+    }
+    if (!record) return out;
+    record->last_use.store(use_clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    out.vary = record->vary;
+
+    const auto values = VaryValues(request.headers, record->vary);
+    for (const auto& variant : record->variants) {
+        if (variant->vary_values == values) {
+            out.entry = variant;
+            break;
+        }
+    }
+    if (!out.entry) return out;
+
+    const Entry& e = *out.entry;
+    out.age_sec = e.AgeSec(now);
+    CacheControl req_cc;
+    if (auto it = request.headers.find("cache-control");
+        it != request.headers.end()) {
+        req_cc = ParseCacheControl(it->second);
+    }
+    int64_t lifetime = e.freshness_lifetime_sec;
+    if (req_cc.max_age >= 0) lifetime = std::min(lifetime, req_cc.max_age + 1);
+    if (req_cc.min_fresh > 0) lifetime -= req_cc.min_fresh;
+
+    const int64_t staleness = out.age_sec - lifetime;
+    if (staleness < 0) {
+        out.usability = Usability::FRESH;
+    } else if (e.must_revalidate) {
+        out.usability = Usability::STALE;
+    } else if (staleness < e.stale_while_revalidate_sec) {
+        out.usability = Usability::STALE_WHILE_REVALIDATE;
+    } else if (staleness < e.stale_if_error_sec) {
+        out.usability = Usability::STALE_IF_ERROR;
+    } else {
+        out.usability = Usability::STALE;
+    }
+    return out;
+}
+
+void ResponseCache::Invalidate(const std::string& key) {
+    memory_.Erase(key);
+    if (disk_enabled_) disk_.Erase(key);
+}
+
+HttpResponse ResponseCache::BuildResponse(const Entry& entry, int64_t age_sec,
+                                          bool with_body) {
+    HttpResponse response;
+    if (entry.status_reason.empty()) {
+        response.Status(entry.status_code);
+    } else {
+        response.Status(entry.status_code, entry.status_reason);
+    }
+    for (const auto& [name, value] : entry.headers) {
+        response.AppendHeader(name, value);
+    }
+    response.Header("Age", std::to_string(age_sec));
+    if (with_body && entry.body && entry.body->size() > 0) {
+        response.Body(std::string(entry.body->data(), entry.body->size()));
+    }
+    return response;
+}
+
+// --- Entry construction ---
+
+std::shared_ptr<ResponseCache::Entry> ResponseCache::MakeEntry(
+    int status_code, const std::string& status_reason,
+    const HeaderList& headers,
+    const std::map<std::string, std::string>& request_headers,
+    std::vector<std::string>& vary_out,
+    std::chrono::microseconds origin_latency) {
+    if (!IsStorableStatus(status_code)) return nullptr;
+
+    const auto cc = ParseCacheControl(JoinHeader(headers, "cache-control"));
+    // no-cache would need revalidation on every use; treat it like
+    // no-store rather than store something that can never be served.
+    if (cc.no_store || cc.private_ || cc.no_cache) return nullptr;
+    bool has_cookie = false;
+    JoinHeader(headers, "set-cookie", &has_cookie);
+    if (has_cookie) return nullptr;
+
+    vary_out.clear();
+    for (auto name : SplitList(JoinHeader(headers, "vary"))) {
+        if (name == "*") return nullptr;
+        vary_out.push_back(ToLower(name));
+    }
+    std::sort(vary_out.begin(), vary_out.end());
+    vary_out.erase(std::unique(vary_out.begin(), vary_out.end()), vary_out.end());
+
+    const time_t now_wall = time(nullptr);
+    bool has_date = false;
+    const auto date = ParseHttpDate(JoinHeader(headers, "date", &has_date));
+
+    int64_t lifetime = -1;
+    if (cc.s_maxage >= 0) {
+        lifetime = cc.s_maxage;
+    } else if (cc.max_age >= 0) {
+        lifetime = cc.max_age;
+    } else {
+        bool has_expires = false;
+        auto expires_raw = JoinHeader(headers, "expires", &has_expires);
+        if (has_expires) {
+            auto expires = ParseHttpDate(expires_raw);
+            // An invalid Expires (e.g. "0") means already expired.
+            lifetime = expires
+                ? std::max<int64_t>(0, *expires - (date ? *date : now_wall))
+                : 0;
+        }
+    }
+    // No explicit freshness: no heuristic caching.
+    if (lifetime < 0) return nullptr;
+
+    auto entry = std::make_shared<Entry>();
+    entry->status_code = status_code;
+    entry->status_reason = status_reason;
+    entry->response_time = std::chrono::steady_clock::now();
+    entry->freshness_lifetime_sec = lifetime;
+    entry->stale_while_revalidate_sec = std::max<int64_t>(0, cc.stale_while_revalidate);
+    entry->stale_if_error_sec = std::max<int64_t>(0, cc.stale_if_error);
+    // s-maxage carries proxy-revalidate semantics for shared caches.
+    entry->must_revalidate =
+        cc.must_revalidate || cc.proxy_revalidate || cc.s_maxage >= 0;
+    entry->etag = JoinHeader(headers, "etag");
+    entry->last_modified = JoinHeader(headers, "last-modified");
+    entry->origin_latency = origin_latency;
+
+    // §4.2.3 corrected_initial_age.
+    const int64_t apparent_age =
+        date ? std::max<int64_t>(0, now_wall - *date) : 0;
+    int64_t age_value = ParseDeltaSeconds(Trim(JoinHeader(headers, "age")));
+    if (age_value < 0) age_value = 0;
+    const int64_t response_delay =
+        std::chrono::duration_cast<std::chrono::seconds>(origin_latency).count();
+    entry->initial_age_sec = std::max(apparent_age, age_value + response_delay);
+
+    const bool usable_later = entry->stale_while_revalidate_sec > 0 ||
+                              entry->stale_if_error_sec > 0 ||
+                              !entry->etag.empty() ||
+                              !entry->last_modified.empty();
+    if (lifetime <= entry->initial_age_sec && !usable_later) return nullptr;
+
+    for (const auto& [name, value] : headers) {
+        if (IsUnstoredHeader(ToLower(name))) continue;
+        entry->headers.emplace_back(name, value);
+    }
+    entry->vary_values = VaryValues(request_headers, vary_out);
+    return entry;
+}
+
+std::shared_ptr<ResponseCache::Entry> ResponseCache::Refresh(
+    const Entry& stored, const HeaderList& not_modified_headers,
+    const std::map<std::string, std::string>& request_headers,
+    std::vector<std::string>& vary_out,
+    std::chrono::microseconds origin_latency) {
+    HeaderList merged;
+    std::unordered_set<std::string> replaced;
+    for (const auto& [name, value] : not_modified_headers) {
+        auto lower = ToLower(name);
+        if (!IsUnstoredHeader(lower)) replaced.insert(lower);
+    }
+    for (const auto& h : stored.headers) {
+        if (!replaced.count(ToLower(h.first))) merged.push_back(h);
+    }
+    for (const auto& h : not_modified_headers) {
+        if (replaced.count(ToLower(h.first))) merged.push_back(h);
+    }
+    auto entry = MakeEntry(stored.status_code, stored.status_reason, merged,
+                           request_headers, vary_out, origin_latency);
+    if (entry) entry->body = stored.body;
+    return entry;
+}
+
+std::shared_ptr<const ResponseCache::Body> ResponseCache::MakeMemoryBody(
+    std::string bytes, int64_t header_bytes) {
+    const int64_t charge = static_cast<int64_t>(bytes.size()) + header_bytes;
+    std::shared_ptr<Body> body(new Body(Tier::MEMORY, memory_usage_, charge));
+    body->heap_ = std::move(bytes);
+    return body;
+}
+
+std::shared_ptr<const ResponseCache::Body> ResponseCache::MakeDiskBody(
+    const Body& source) {
+    const size_t len = source.size();
+    const int64_t header_bytes =
+        source.charge_ - static_cast<int64_t>(len);
+    if (len == 0) {
+        return std::shared_ptr<Body>(new Body(Tier::DISK, disk_usage_, header_bytes));
+    }
+    std::string path = config_.disk_path + "/reactor-cache-XXXXXX";
+    int fd = mkstemp(path.data());
+    if (fd < 0) {
+        logging::Get()->debug("Proxy cache: mkstemp in {} failed errno={}",
+                              config_.disk_path, errno);
+        return nullptr;
+    }
+    // Unlinked at once: the mapping keeps the blocks, and nothing is
+    // left behind on disk across a restart.
+    unlink(path.c_str());
+    // write() rather than writing through the mapping, so a full disk
+    // fails here with ENOSPC instead of SIGBUS later.
+    const char* p = source.data();
+    size_t left = len;
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            logging::Get()->debug("Proxy cache: disk write failed errno={}", errno);
+            close(fd);
+            return nullptr;
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    void* map = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        logging::Get()->debug("Proxy cache: mmap failed errno={}", errno);
+        return nullptr;
+    }
+    std::shared_ptr<Body> body(new Body(
+        Tier::DISK, disk_usage_, static_cast<int64_t>(len) + header_bytes));
+    body->map_ = map;
+    body->map_len_ = len;
+    return body;
+}
+
+// --- Store / eviction ---
+
+void ResponseCache::Store(const std::string& key,
+                          const std::vector<std::string>& vary,
+                          std::shared_ptr<const Entry> entry) {
+    RecordPtr existing;
+    if (auto h = memory_.Find(key)) {
+        existing = *h;
+    } else if (disk_enabled_) {
+        if (auto d = disk_.Find(key)) existing = *d;
+    }
+
+    auto record = std::make_shared<Record>();
+    record->key = key;
+    record->vary = vary;
+    record->variants.push_back(entry);
+    record->last_use.store(use_clock_.fetch_add(1, std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    // Variants under a different Vary set were selected by other
+    // headers and can no longer be matched; drop them.
+    if (existing && existing->vary == vary) {
+        for (const auto& v : existing->variants) {
+            if (record->variants.size() >= MAX_VARIANTS) break;
+            if (v->vary_values != entry->vary_values) {
+                record->variants.push_back(v);
+            }
+        }
+    }
+    for (const auto& v : record->variants) {
+        if (v->body && v->body->tier() == Tier::MEMORY) {
+            record->charge += v->body->charge_;
+        }
+    }
+    memory_.Insert(key, std::move(record));
+    if (disk_enabled_) disk_.Erase(key);
+    EnforceBudget(Tier::MEMORY);
+}
+
+void ResponseCache::EnforceBudget(Tier tier) {
+    Index& index = tier == Tier::MEMORY ? memory_ : disk_;
+    const auto& usage = tier == Tier::MEMORY ? *memory_usage_ : *disk_usage_;
+    const int64_t budget = tier == Tier::MEMORY ? config_.memory_max_bytes
+                                                : config_.disk_max_bytes;
+    if (usage.load(std::memory_order_relaxed) <= budget) return;
+
+    // Each round evicts the shard tail with the oldest use, so eviction
+    // follows global LRU order rather than each shard's own.
+    std::vector<RecordPtr> evicted;
+    int64_t freed = 0;
+    while (usage.load(std::memory_order_relaxed) - freed > budget) {
+        size_t victim = SHARD_COUNT;
+        uint64_t oldest = UINT64_MAX;
+        for (size_t shard = 0; shard < SHARD_COUNT; ++shard) {
+            index.EvictFromTailWhile(shard, [&](const RecordPtr& r, size_t) {
+                const uint64_t used = r->last_use.load(std::memory_order_relaxed);
+                if (used < oldest) {
+                    oldest = used;
+                    victim = shard;
+                }
+                return false;
+            });
+        }
+        if (victim == SHARD_COUNT) break;
+        index.EvictFromTailWhile(victim, [&](const RecordPtr& r, size_t) {
+            if (r->last_use.load(std::memory_order_relaxed) != oldest) return false;
+            freed += r->charge;
+            evicted.push_back(r);
+            return true;
+        });
+    }
+
+    if (tier == Tier::MEMORY && disk_enabled_ && !evicted.empty()) {
+        for (const auto& r : evicted) {
+            if (auto demoted = Demote(*r)) disk_.Insert(r->key, std::move(demoted));
+        }
+        evicted.clear();
+        EnforceBudget(Tier::DISK);
+    }
+}
+
+ResponseCache::RecordPtr ResponseCache::Demote(const Record& record) {
+    auto out = std::make_shared<Record>();
+    out->key = record.key;
+    out->vary = record.vary;
+    out->last_use.store(record.last_use.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    for (const auto& v : record.variants) {
+        if (!v->body) continue;
+        std::shared_ptr<const Body> body = v->body;
+        if (body->tier() == Tier::MEMORY) {
+            body = MakeDiskBody(*body);
+            if (!body) continue;
+        }
+        auto moved = std::make_shared<Entry>(*v);
+        moved->body = body;
+        out->charge += body->charge_;
+        out->variants.push_back(std::move(moved));
+    }
+    if (out->variants.empty()) return nullptr;
+    return out;
+}
+
+// --- Request collapsing ---
+
+bool ResponseCache::JoinOrLead(const std::string& collapse_key,
+                               Dispatcher* dispatcher,
+                               std::function<void()> resume) {
+    std::lock_guard<std::mutex> lk(fills_mtx_);
+    auto it = fills_.find(collapse_key);
+    if (it == fills_.end()) {
+        fills_.emplace(collapse_key, std::vector<Waiter>{});
+        return true;
+    }
+    if (resume) it->second.push_back({dispatcher, std::move(resume)});
+    return false;
+}
+
+void ResponseCache::ReleaseFill(const std::string& collapse_key) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lk(fills_mtx_);
+        auto it = fills_.find(collapse_key);
+        if (it == fills_.end()) return;
+        waiters = std::move(it->second);
+        fills_.erase(it);
+    }
+    for (auto& w : waiters) {
+        if (w.dispatcher) w.dispatcher->EnQueue(std::move(w.resume));
+    }
+}
+
+// --- Observability ---
+
+void ResponseCache::RecordResult(const std::string& service, Result result,
+                                 const Entry* entry, bool head_only) {
+    results_[static_cast<size_t>(result)].fetch_add(1, std::memory_order_relaxed);
+    auto* obs = obs_manager_.load(std::memory_order_acquire);
+    if (!obs) return;
+    const auto& cat = obs->catalog();
+    if (cat.reactor_proxy_cache_lookups != nullptr) {
+        cat.reactor_proxy_cache_lookups->Add(
+            1.0, {{"reactor.upstream.service", service},
+                  {"result", ResultName(result)}});
+    }
+    if (!entry || !entry->body) return;
+    const size_t bytes = head_only ? 0 : entry->body->size();
+    if (bytes > 0 && cat.reactor_proxy_cache_served_bytes != nullptr) {
+        cat.reactor_proxy_cache_served_bytes->Add(
+            static_cast<double>(bytes),
+            {{"reactor.upstream.service", service},
+             {"tier", TierName(entry->body->tier())}});
+    }
+    // A 304 round trip still paid the origin latency.
+    if (result != Result::REVALIDATED &&
+        cat.reactor_proxy_cache_origin_latency_saved != nullptr) {
+        cat.reactor_proxy_cache_origin_latency_saved->Add(
+            static_cast<double>(entry->origin_latency.count()) / 1e6,
+            {{"reactor.upstream.service", service}});
+    }
+}
+
+// --- Fill ---
+
+ResponseCache::Fill::Fill(std::shared_ptr<ResponseCache> cache,
+                          std::string service,
+                          std::string key,
+                          std::string collapse_key,
+                          const HttpRequest& request,
+                          Lookup stale,
+                          bool conditional_added,
+                          bool client_request)
+    : cache_(std::move(cache)),
+      service_(std::move(service)),
+      key_(std::move(key)),
+      collapse_key_(std::move(collapse_key)),
+      request_headers_(request.headers),
+      stale_(std::move(stale)),
+      conditional_added_(conditional_added),
+      client_request_(client_request),
+      started_at_(std::chrono::steady_clock::now()) {}
+
+ResponseCache::Fill::~Fill() {
+    OnComplete(false);
+}
+
+int64_t ResponseCache::Fill::AgeOf(const Entry& entry) const {
+    return entry.AgeSec(std::chrono::steady_clock::now());
+}
+
+void ResponseCache::Fill::Release() {
+    if (collapse_key_.empty()) return;
+    cache_->ReleaseFill(collapse_key_);
+    collapse_key_.clear();
+}
+
+std::shared_ptr<const ResponseCache::Entry>
+ResponseCache::Fill::OnResponseHead(const HttpResponse& response) {
+    if (done_) return nullptr;
+    const auto now = std::chrono::steady_clock::now();
+    const auto latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - started_at_);
+    const int status = response.GetStatusCode();
+
+    // 304 to the cache's own conditional: refresh and answer from the
+    // stored body.
+    if (status == HttpStatus::NOT_MODIFIED && conditional_added_ && stale_.entry) {
+        std::vector<std::string> vary;
+        std::shared_ptr<const Entry> served = Refresh(
+            *stale_.entry, response.GetHeaders(), request_headers_, vary, latency);
+        if (served) {
+            cache_->Store(key_, vary, served);
+        } else {
+            served = stale_.entry;
+        }
+        done_ = true;
+        Release();
+        if (client_request_) {
+            cache_->RecordResult(service_, Result::REVALIDATED, served.get(), false);
+        }
+        return served;
+    }
+
+    // Upstream failure inside the stale-if-error window.
+    if (status >= HttpStatus::INTERNAL_SERVER_ERROR && stale_.entry &&
+        !stale_.entry->must_revalidate) {
+        const Entry& e = *stale_.entry;
+        const int64_t staleness = e.AgeSec(now) - e.freshness_lifetime_sec;
+        if (staleness < e.stale_if_error_sec) {
+            done_ = true;
+            Release();
+            if (client_request_) {
+                cache_->RecordResult(service_, Result::STALE, &e, false);
+            }
+            logging::Get()->debug(
+                "Proxy cache: upstream {} answered {}, serving stale entry "
+                "(stale {}s)", service_, status, staleness);
+            return stale_.entry;
+        }
+    }
+
+    pending_ = MakeEntry(status, response.GetStatusReason(),
+                         response.GetHeaders(), request_headers_,
+                         pending_vary_, latency);
+    // Not storable: waiters go to the upstream themselves now rather
+    // than after this whole response has been relayed.
+    if (!pending_) Release();
+    return nullptr;
+}
+
+void ResponseCache::Fill::OnBody(const char* data, size_t len) {
+    if (done_ || !pending_) return;
+    if (static_cast<int64_t>(body_.size() + len) > cache_->config_.max_object_bytes) {
+        pending_.reset();
+        std::string().swap(body_);
+        Release();
+        return;
+    }
+    body_.append(data, len);
+}
+
+void ResponseCache::Fill::OnComplete(bool clean) {
+    if (done_) return;
+    done_ = true;
+    if (pending_ && clean) {
+        pending_->body = cache_->MakeMemoryBody(std::move(body_),
+                                                HeaderBytes(pending_->headers));
+        cache_->Store(key_, pending_vary_, std::move(pending_));
+    }
+    pending_.reset();
+    Release();
+    if (client_request_) {
+        cache_->RecordResult(service_, result_, nullptr, false);
+    }
+}
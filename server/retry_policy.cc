@@ -48,12 +48,21 @@ bool RetryPolicy::ShouldRetry(int attempt, const std::string& method,
         case RetryCondition::UPSTREAM_DISCONNECT:
             condition_allowed = config_.retry_on_disconnect;
             break;
+        case RetryCondition::GRPC_STATUS:
+            condition_allowed = config_.retry_on_grpc_status;
+            break;
     }
 
     if (!condition_allowed) {
         return false;
     }
 
+    // The status set is the operator's statement that the call is safe
+    // to repeat (gRPC methods are all POST, so the method says nothing).
+    if (condition == RetryCondition::GRPC_STATUS) {
+        return true;
+    }
+
     // Non-idempotent methods require explicit opt-in
     if (!IsIdempotent(method) && !config_.retry_non_idempotent) {
         return false;
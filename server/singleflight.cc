@@ -0,0 +1,509 @@
+#include "upstream/singleflight.h"
+#include "http/http_request.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+#include "observability/counter.h"
+#include "observability/metrics_catalog.h"
+#include "observability/observability_manager.h"
+#include "observability/observability_snapshot.h"
+
+#include <cctype>
+
+namespace {
+
+std::string ToLower(std::string s) {
+    for (auto& c : s) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return s;
+}
+
+}  // namespace
+
+// Reports the shared upstream response to the flight. Never pushes
+// back on the transaction by itself: it is paused only while a waiter's
+// own connection is above its high-water mark.
+class SingleflightGroup::Flight::UpstreamSenderImpl : public StreamingSender::Impl {
+public:
+    explicit UpstreamSenderImpl(std::shared_ptr<Flight> flight)
+        : flight_(std::move(flight)) {}
+
+    // A transaction torn down without a terminal call (cancel, shutdown
+    // kill) must not leave waiters hanging on the flight.
+    ~UpstreamSenderImpl() override {
+        flight_->PublishAbort(StreamingSender::AbortReason::UPSTREAM_ERROR);
+    }
+
+    int SendHeaders(const HttpResponse& response) override {
+        return flight_->PublishHead(response);
+    }
+    StreamingSender::SendResult SendData(const char* data, size_t len) override {
+        return flight_->PublishData(data, len);
+    }
+    StreamingSender::SendResult End(
+        const std::vector<std::pair<std::string, std::string>>& trailers) override {
+        flight_->PublishEnd(trailers);
+        return StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+    }
+    void Abort(StreamingSender::AbortReason reason) override {
+        flight_->PublishAbort(reason);
+    }
+    void SetDrainListener(StreamingSender::DrainListener listener) override {
+        flight_->SetUpstreamDrainListener(std::move(listener));
+    }
+    // Each waiter's connection carries the route's watermark.
+    void ConfigureWatermarks(size_t) override {}
+    Dispatcher* GetDispatcher() override { return flight_->upstream_dispatcher_; }
+
+private:
+    std::shared_ptr<Flight> flight_;
+};
+
+// --- Flight ---
+
+SingleflightGroup::Flight::Flight(std::weak_ptr<SingleflightGroup> group,
+                                  std::string key,
+                                  Dispatcher* upstream_dispatcher,
+                                  int64_t max_replay_bytes)
+    : group_(std::move(group)),
+      key_(std::move(key)),
+      upstream_dispatcher_(upstream_dispatcher),
+      max_replay_bytes_(max_replay_bytes) {}
+
+SingleflightGroup::StreamingSender SingleflightGroup::Flight::UpstreamSender() {
+    return StreamingSender(
+        std::make_shared<UpstreamSenderImpl>(shared_from_this()));
+}
+
+SingleflightGroup::Completion SingleflightGroup::Flight::UpstreamCompletion() {
+    auto self = shared_from_this();
+    return [self](HttpResponse response) {
+        self->PublishResponse(std::move(response));
+    };
+}
+
+void SingleflightGroup::Flight::SetCancel(std::function<void()> cancel) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!cancelled_) {
+            cancel_ = std::move(cancel);
+            return;
+        }
+    }
+    if (cancel) cancel();
+}
+
+bool SingleflightGroup::Flight::Attach(Dispatcher* dispatcher,
+                                       StreamingSender sender,
+                                       Completion complete, size_t* index) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (closed_) return false;
+    Waiter waiter;
+    waiter.dispatcher = dispatcher;
+    waiter.sender = std::move(sender);
+    waiter.complete = std::move(complete);
+    waiters_.push_back(std::move(waiter));
+    ++live_;
+    *index = waiters_.size() - 1;
+    // A late joiner is replayed what the others have been sent so far.
+    if (has_head_) ScheduleLocked(*index);
+    return true;
+}
+
+void SingleflightGroup::Flight::Detach(size_t index) {
+    std::function<void()> cancel;
+    bool retire = false;
+    StreamingSender sender;
+    Completion complete;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        Waiter& waiter = waiters_[index];
+        if (waiter.done) return;
+        sender = std::move(waiter.sender);
+        complete = std::move(waiter.complete);
+        FinishWaiterLocked(waiter);
+        TrimLocked();
+        if (live_ == 0 && terminal_ == Terminal::NONE && !cancelled_) {
+            cancelled_ = true;
+            retire = !closed_;
+            closed_ = true;
+            cancel = std::move(cancel_);
+        }
+    }
+    if (retire) Retire();
+    if (cancel) {
+        logging::Get()->debug("Singleflight: every waiter left, cancelling "
+                              "upstream request");
+        cancel();
+    }
+}
+
+int SingleflightGroup::Flight::PublishHead(const HttpResponse& response) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (cancelled_ || terminal_ != Terminal::NONE) return -1;
+    head_ = response;
+    has_head_ = true;
+    ScheduleAllLocked();
+    return 0;
+}
+
+SingleflightGroup::StreamingSender::SendResult
+SingleflightGroup::Flight::PublishData(const char* data, size_t len) {
+    bool retire = false;
+    StreamingSender::SendResult result;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (cancelled_ || terminal_ != Terminal::NONE) {
+            return StreamingSender::SendResult::CLOSED;
+        }
+        chunks_.push_back(std::make_shared<const std::string>(data, len));
+        retained_bytes_ += static_cast<int64_t>(len);
+        if (!closed_ && retained_bytes_ > max_replay_bytes_) {
+            // Too much to replay: later identical requests start their
+            // own flight, and chunks are kept only until every current
+            // waiter has been sent them.
+            closed_ = true;
+            retire = true;
+        }
+        TrimLocked();
+        ScheduleAllLocked();
+        if (above_water_ > 0) {
+            upstream_paused_ = true;
+            result = StreamingSender::SendResult::ACCEPTED_ABOVE_HIGH_WATER;
+        } else {
+            result = StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+        }
+    }
+    if (retire) Retire();
+    return result;
+}
+
+void SingleflightGroup::Flight::PublishEnd(
+    const std::vector<std::pair<std::string, std::string>>& trailers) {
+    bool retire = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (terminal_ != Terminal::NONE) return;
+        terminal_ = Terminal::END;
+        trailers_ = trailers;
+        retire = !closed_;
+        closed_ = true;
+        ScheduleAllLocked();
+    }
+    if (retire) Retire();
+}
+
+void SingleflightGroup::Flight::PublishAbort(StreamingSender::AbortReason reason) {
+    bool retire = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (terminal_ != Terminal::NONE) return;
+        terminal_ = Terminal::ABORT;
+        abort_reason_ = reason;
+        retire = !closed_;
+        closed_ = true;
+        ScheduleAllLocked();
+    }
+    if (retire) Retire();
+}
+
+void SingleflightGroup::Flight::PublishResponse(HttpResponse response) {
+    bool retire = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (terminal_ != Terminal::NONE) return;
+        terminal_ = Terminal::RESPONSE;
+        response_ = std::make_shared<const HttpResponse>(std::move(response));
+        retire = !closed_;
+        closed_ = true;
+        ScheduleAllLocked();
+    }
+    if (retire) Retire();
+}
+
+void SingleflightGroup::Flight::SetUpstreamDrainListener(
+    StreamingSender::DrainListener listener) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    upstream_drain_ = std::move(listener);
+    // Every waiter drained between the paused SendData and this call.
+    if (upstream_drain_ && !upstream_paused_) {
+        upstream_dispatcher_->EnQueue(upstream_drain_);
+    }
+}
+
+void SingleflightGroup::Flight::ScheduleAllLocked() {
+    for (size_t i = 0; i < waiters_.size(); ++i) ScheduleLocked(i);
+}
+
+void SingleflightGroup::Flight::ScheduleLocked(size_t index) {
+    Waiter& waiter = waiters_[index];
+    if (waiter.done || waiter.pump_scheduled) return;
+    waiter.pump_scheduled = true;
+    auto self = shared_from_this();
+    waiter.dispatcher->EnQueue([self, index]() { self->Pump(index); });
+}
+
+void SingleflightGroup::Flight::FinishWaiterLocked(Waiter& waiter) {
+    if (waiter.done) return;
+    waiter.done = true;
+    --live_;
+    if (waiter.above_water) {
+        waiter.above_water = false;
+        --above_water_;
+        ReleaseDrainLocked();
+    }
+}
+
+void SingleflightGroup::Flight::TrimLocked() {
+    if (!closed_) return;
+    size_t keep_from = first_chunk_ + chunks_.size();
+    for (const auto& waiter : waiters_) {
+        if (!waiter.done) keep_from = std::min(keep_from, waiter.cursor);
+    }
+    while (first_chunk_ < keep_from) {
+        retained_bytes_ -= static_cast<int64_t>(chunks_.front()->size());
+        chunks_.pop_front();
+        ++first_chunk_;
+    }
+}
+
+void SingleflightGroup::Flight::ReleaseDrainLocked() {
+    if (above_water_ > 0 || !upstream_paused_) return;
+    upstream_paused_ = false;
+    if (upstream_drain_) upstream_dispatcher_->EnQueue(upstream_drain_);
+}
+
+void SingleflightGroup::Flight::Pump(size_t index) {
+    bool send_head = false;
+    HttpResponse head;
+    std::vector<std::shared_ptr<const std::string>> chunks;
+    Terminal terminal = Terminal::NONE;
+    std::vector<std::pair<std::string, std::string>> trailers;
+    StreamingSender::AbortReason reason = abort_reason_;
+    std::shared_ptr<const HttpResponse> response;
+    StreamingSender sender;
+    Completion complete;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        Waiter& waiter = waiters_[index];
+        waiter.pump_scheduled = false;
+        if (waiter.done) return;
+        if (terminal_ == Terminal::RESPONSE && !waiter.head_sent) {
+            response = response_;
+            complete = std::move(waiter.complete);
+            waiter.sender = StreamingSender();
+            FinishWaiterLocked(waiter);
+            TrimLocked();
+        } else {
+            if (has_head_ && !waiter.head_sent) {
+                send_head = true;
+                head = head_;
+                waiter.head_sent = true;
+            }
+            if (waiter.head_sent) {
+                for (size_t i = waiter.cursor - first_chunk_; i < chunks_.size(); ++i) {
+                    chunks.push_back(chunks_[i]);
+                }
+                waiter.cursor = first_chunk_ + chunks_.size();
+            }
+            terminal = terminal_;
+            if (terminal == Terminal::RESPONSE) {
+                // A buffered completion after streaming began; the
+                // transaction never does this, but the stream must end.
+                terminal = Terminal::ABORT;
+                reason = StreamingSender::AbortReason::UPSTREAM_ERROR;
+            }
+            if (terminal == Terminal::END) trailers = trailers_;
+            if (terminal == Terminal::ABORT) reason = abort_reason_;
+            if (terminal != Terminal::NONE) {
+                sender = std::move(waiter.sender);
+                waiter.complete = nullptr;
+                FinishWaiterLocked(waiter);
+            } else {
+                sender = waiter.sender;
+            }
+            TrimLocked();
+        }
+    }
+
+    if (response) {
+        complete(HttpResponse(*response));
+        return;
+    }
+
+    bool closed = false;
+    auto last = StreamingSender::SendResult::ACCEPTED_BELOW_WATER;
+    if (send_head && sender.SendHeaders(head) < 0) closed = true;
+    for (const auto& chunk : chunks) {
+        if (closed) break;
+        last = sender.SendData(chunk->data(), chunk->size());
+        if (last == StreamingSender::SendResult::CLOSED) closed = true;
+    }
+    if (closed) {
+        sender.Abort(StreamingSender::AbortReason::CLIENT_DISCONNECT);
+        Detach(index);
+        return;
+    }
+    if (terminal == Terminal::END) {
+        (void)sender.End(trailers);
+        return;
+    }
+    if (terminal == Terminal::ABORT) {
+        sender.Abort(reason);
+        return;
+    }
+    if (chunks.empty()) return;
+
+    const bool above =
+        last == StreamingSender::SendResult::ACCEPTED_ABOVE_HIGH_WATER;
+    bool listen = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        Waiter& waiter = waiters_[index];
+        if (waiter.done || waiter.above_water == above) return;
+        waiter.above_water = above;
+        if (above) {
+            ++above_water_;
+            listen = true;
+        } else {
+            --above_water_;
+            ReleaseDrainLocked();
+        }
+    }
+    if (listen) {
+        std::weak_ptr<Flight> weak_self = weak_from_this();
+        sender.SetDrainListener([weak_self, index]() {
+            if (auto self = weak_self.lock()) self->OnWaiterDrained(index);
+        });
+    }
+}
+
+void SingleflightGroup::Flight::OnWaiterDrained(size_t index) {
+    StreamingSender sender;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        Waiter& waiter = waiters_[index];
+        sender = waiter.sender;
+        if (!waiter.done && waiter.above_water) {
+            waiter.above_water = false;
+            --above_water_;
+            ReleaseDrainLocked();
+        }
+    }
+    sender.SetDrainListener(nullptr);
+}
+
+void SingleflightGroup::Flight::Retire() {
+    if (auto group = group_.lock()) group->Remove(key_, this);
+}
+
+// --- SingleflightGroup ---
+
+SingleflightGroup::SingleflightGroup(std::string service,
+                                     const ProxySingleflightConfig& config)
+    : service_(std::move(service)), config_(config) {
+    for (auto& name : config_.key_headers) name = ToLower(name);
+}
+
+std::string SingleflightGroup::KeyFor(const HttpRequest& request) const {
+    if (request.method != "GET" && request.method != "HEAD") return {};
+    // HTTP/1.0 clients may be relayed a buffered response the others
+    // would not get.
+    if (request.http_major == 1 && request.http_minor == 0) return {};
+    const auto& headers = request.headers;
+    // Proxy routes stream request bodies, so body_stream is set even
+    // for a bodiless GET; the framing headers tell whether one follows.
+    auto cl = headers.find("content-length");
+    if (!request.body.empty() || headers.count("transfer-encoding") ||
+        (cl != headers.end() && cl->second != "0")) {
+        return {};
+    }
+    auto keyed = [this](const char* name) {
+        for (const auto& h : config_.key_headers) {
+            if (h == name) return true;
+        }
+        return false;
+    };
+    for (const char* name : {"authorization", "cookie", "range"}) {
+        if (headers.count(name) && !keyed(name)) return {};
+    }
+
+    // The relayed head differs by client protocol (Trailer declaration),
+    // so HTTP/1.1 and HTTP/2 clients do not share a flight.
+    std::string key = request.method;
+    key += ' ';
+    key += std::to_string(request.http_major);
+    key += ' ';
+    auto host = headers.find("host");
+    if (host != headers.end()) key += host->second;
+    key += ' ';
+    key += request.path;
+    key += '?';
+    key += request.query;
+    for (const auto& name : config_.key_headers) {
+        key += '\n';
+        auto it = headers.find(name);
+        if (it != headers.end()) {
+            key += '=';
+            key += it->second;
+        }
+    }
+    return key;
+}
+
+std::shared_ptr<SingleflightGroup::Flight> SingleflightGroup::Join(
+    const std::string& key, const HttpRequest& request, Dispatcher* dispatcher,
+    StreamingSender sender, Completion complete) {
+    std::shared_ptr<Flight> flight;
+    size_t index = 0;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        auto it = flights_.find(key);
+        if (it != flights_.end() &&
+            it->second->Attach(dispatcher, sender, complete, &index)) {
+            flight = it->second;
+        } else {
+            flight = std::make_shared<Flight>(weak_from_this(), key, dispatcher,
+                                              config_.max_replay_bytes);
+            flight->Attach(dispatcher, std::move(sender), std::move(complete),
+                           &index);
+            flights_[key] = flight;
+            leader = true;
+        }
+    }
+
+    // Until answered, a client disconnect only detaches this waiter.
+    if (request.async_cancel_slot) {
+        std::weak_ptr<Flight> weak_flight = flight;
+        *request.async_cancel_slot = [weak_flight, index]() {
+            if (auto f = weak_flight.lock()) f->Detach(index);
+        };
+    }
+    if (leader) return flight;
+
+    coalesced_.fetch_add(1, std::memory_order_relaxed);
+    if (request.obs_snapshot) {
+        if (auto mgr = request.obs_snapshot->manager.lock()) {
+            const auto& cat = mgr->catalog();
+            if (cat.reactor_proxy_singleflight_coalesced != nullptr) {
+                cat.reactor_proxy_singleflight_coalesced->Add(
+                    1.0, {{"reactor.upstream.service", service_}});
+            }
+        }
+    }
+    logging::Get()->debug("Singleflight: coalesced service={} {} {}",
+                          service_, request.method, request.path);
+    return nullptr;
+}
+
+size_t SingleflightGroup::inflight() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return flights_.size();
+}
+
+void SingleflightGroup::Remove(const std::string& key, const Flight* flight) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = flights_.find(key);
+    if (it != flights_.end() && it->second.get() == flight) flights_.erase(it);
+}
@@ -1,4 +1,6 @@
 #include "tls/tls_client_context.h"
+#include "tls/tls_connection.h"
+#include "tls/tls_session_cache.h"
 #include "log/logger.h"
 #include <openssl/err.h>
 #include <stdexcept>
@@ -74,3 +76,23 @@ void TlsClientContext::SetAlpnProtocols(const std::vector<std::string>& protocol
 
     logging::Get()->debug("TlsClientContext: ALPN protocols set (count={})", protocols.size());
 }
+
+bool TlsClientContext::EnableKtls() {
+    if (!TlsConnection::KtlsAvailable()) return false;
+#ifdef SSL_OP_ENABLE_KTLS
+    SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+#endif
+    return true;
+}
+
+void TlsClientContext::SetSessionReuse(bool enabled) {
+    if (enabled) {
+        SSL_CTX_set_session_cache_mode(
+            ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx_, TlsSessionCache::NewSessionCallback);
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_OFF);
+        SSL_CTX_sess_set_new_cb(ctx_, nullptr);
+    }
+    session_reuse_ = enabled;
+}
@@ -1,5 +1,6 @@
 #include "tls/tls_connection.h"
 #include "tls/tls_client_context.h"
+#include "tls/tls_session_cache.h"
 #include "net/dns_resolver.h"  // StripTrailingDot (§5.10 SNI/verify-name strip)
 #include "log/logger.h"
 #include <openssl/err.h>
@@ -16,6 +17,15 @@ TlsConnection::TlsConnection(TlsContext& ctx, int fd) {
     }
     SSL_set_accept_state(ssl_);  // Server-side
 
+    key_offloader_ = ctx.KeyOffloader();
+    if (key_offloader_) {
+        // Handshake steps run as OpenSSL async jobs so the signature hook
+        // can pause them. Cleared once the handshake completes.
+        SSL_set_mode(ssl_, SSL_MODE_ASYNC);
+    }
+
+    record_sizing_ = ctx.GetRecordSizing();
+
     // Allow retrying SSL_write with a different buffer address.
     // Our output_bf_ can reallocate between the original write and the retry.
     SSL_set_mode(ssl_, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER | SSL_MODE_ENABLE_PARTIAL_WRITE);
@@ -66,14 +76,33 @@ TlsConnection::~TlsConnection() {
         // TlsConnection is destroyed, Channel::CloseChannel() has already
         // closed the fd. Use the explicit Shutdown() method before socket
         // close if a clean close_notify is needed.
+        if (pending_key_op_) AbandonPendingKeyOp();
         SSL_free(ssl_);
     }
 }
 
 int TlsConnection::DoHandshake() {
-    int ret = SSL_do_handshake(ssl_);
+    int ret;
+    if (key_offloader_) {
+        TlsKeyOffloader::Scope scope(key_offloader_, &pending_key_op_,
+                                     &async_resume_cb_);
+        ret = SSL_do_handshake(ssl_);
+        if (ret != 1 && SSL_get_error(ssl_, ret) == SSL_ERROR_WANT_ASYNC) {
+            return TLS_WANT_ASYNC;
+        }
+        pending_key_op_.reset();
+        if (ret == 1) SSL_clear_mode(ssl_, SSL_MODE_ASYNC);
+    } else {
+        ret = SSL_do_handshake(ssl_);
+    }
     if (ret == 1) {
         handshake_complete_ = true;
+        ktls_send_ = BIO_get_ktls_send(SSL_get_wbio(ssl_));
+        ktls_recv_ = BIO_get_ktls_recv(SSL_get_rbio(ssl_));
+        if (ktls_send_ || ktls_recv_) {
+            logging::Get()->debug("TlsConnection: kernel TLS active (tx={}, rx={})",
+                                  ktls_send_, ktls_recv_);
+        }
         return TLS_COMPLETE;
     }
 
@@ -108,12 +137,61 @@ int TlsConnection::Peek(char* buf, size_t len) {
 }
 
 int TlsConnection::Write(const char* buf, size_t len) {
+    if (!record_sizing_.enabled) {
+        int ret = SSL_write(ssl_, buf, static_cast<int>(len));
+        if (ret > 0) return ret;
+
+        int err = SSL_get_error(ssl_, ret);
+        if (err == SSL_ERROR_WANT_WRITE) return TLS_COMPLETE;    // Need write readiness
+        if (err == SSL_ERROR_WANT_READ) return TLS_CROSS_RW;     // Need read readiness (renegotiation)
+        return TLS_ERROR;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (pending_write_len_ > 0) {
+        // Retry: OpenSSL already framed part of the original write, so
+        // neither the length nor the record size may change.
+        len = std::min(len, pending_write_len_);
+    } else {
+        if (warm_bytes_ > 0 && record_sizing_.idle_reset_ms > 0 &&
+            now - last_write_ >=
+                std::chrono::milliseconds(record_sizing_.idle_reset_ms)) {
+            // Idle long enough for the congestion window to decay: start
+            // small again so the next response's first bytes go out alone.
+            warm_bytes_ = 0;
+        }
+        const bool cold = warm_bytes_ < record_sizing_.ramp_bytes;
+        const size_t limit = cold ? record_sizing_.initial_record_size
+                                  : TlsContext::MAX_RECORD_SIZE;
+        if (limit != record_limit_) {
+            // Lowering max_send_fragment drags split_send_fragment down
+            // with it, and raising it does not bring it back up.
+            SSL_set_max_send_fragment(ssl_, static_cast<long>(limit));
+            SSL_set_split_send_fragment(ssl_, static_cast<long>(limit));
+            record_limit_ = limit;
+        }
+        // Stop at the ramp point so the rest of the buffer goes out in
+        // full records on the caller's next write.
+        if (cold) len = std::min(len, record_sizing_.ramp_bytes - warm_bytes_);
+    }
+
     int ret = SSL_write(ssl_, buf, static_cast<int>(len));
-    if (ret > 0) return ret;
+    if (ret > 0) {
+        pending_write_len_ = 0;
+        warm_bytes_ += static_cast<size_t>(ret);
+        last_write_ = now;
+        return ret;
+    }
 
     int err = SSL_get_error(ssl_, ret);
-    if (err == SSL_ERROR_WANT_WRITE) return TLS_COMPLETE;    // Need write readiness
-    if (err == SSL_ERROR_WANT_READ) return TLS_CROSS_RW;     // Need read readiness (renegotiation)
+    if (err == SSL_ERROR_WANT_WRITE) {
+        pending_write_len_ = len;
+        return TLS_COMPLETE;
+    }
+    if (err == SSL_ERROR_WANT_READ) {
+        pending_write_len_ = len;
+        return TLS_CROSS_RW;
+    }
     return TLS_ERROR;
 }
 
@@ -121,6 +199,34 @@ int TlsConnection::Shutdown() {
     return SSL_shutdown(ssl_);
 }
 
+void TlsConnection::AbandonPendingKeyOp() {
+    if (!pending_key_op_->Cancel()) {
+        // A worker has it; that is at most one key operation to wait out.
+        while (!pending_key_op_->IsDone()) std::this_thread::yield();
+    }
+    BIO* sink = BIO_new(BIO_s_null());
+    if (sink) SSL_set_bio(ssl_, sink, sink);
+    // Resume the job so it runs to completion and goes back to OpenSSL's
+    // job pool: a cancelled operation fails the handshake, a finished one
+    // writes its flight into the null BIO and stops on the next read.
+    SSL_do_handshake(ssl_);
+    ERR_clear_error();
+    pending_key_op_.reset();
+}
+
+bool TlsConnection::KtlsAvailable() {
+#if defined(__linux__) && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool TlsConnection::AttachSessionCache(TlsSessionCache& cache,
+                                       const std::string& key) {
+    return cache.Attach(ssl_, key);
+}
+
 std::string TlsConnection::GetCipherName() const {
     const char* cipher = SSL_get_cipher(ssl_);
     return cipher ? cipher : "unknown";
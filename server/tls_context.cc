@@ -1,5 +1,13 @@
 #include "tls/tls_context.h"
+#include "tls/tls_connection.h"
+#include "tls/tls_key_offloader.h"
+#include <openssl/core_names.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <stdexcept>
 
 TlsContext::TlsContext(const std::string& cert_file, const std::string& key_file) {
@@ -93,3 +101,197 @@ int TlsContext::AlpnSelectCallback(
 
     return SSL_TLSEXT_ERR_OK;
 }
+
+bool TlsContext::EnableKtls() {
+    if (!TlsConnection::KtlsAvailable()) return false;
+#ifdef SSL_OP_ENABLE_KTLS
+    SSL_CTX_set_options(ctx_, SSL_OP_ENABLE_KTLS);
+#endif
+    return true;
+}
+
+bool TlsContext::EnableKeyOffload(int threads) {
+    if (key_offloader_ || threads <= 0) return false;
+    if (!TlsKeyOffloader::Supported()) return false;
+    EVP_PKEY* wrapped = TlsKeyOffloader::WrapKey(SSL_CTX_get0_privatekey(ctx_));
+    if (wrapped == nullptr) return false;
+    // Replaces the key loaded by the constructor; the certificate is
+    // re-checked against it.
+    const bool installed = SSL_CTX_use_PrivateKey(ctx_, wrapped) == 1;
+    EVP_PKEY_free(wrapped);
+    if (!installed) {
+        ERR_clear_error();
+        return false;
+    }
+    key_offloader_ = std::make_unique<TlsKeyOffloader>(threads);
+    return true;
+}
+
+void TlsContext::ConfigureSessionResumption(bool tickets,
+                                            const std::string& ticket_key_file,
+                                            size_t cache_size,
+                                            int timeout_sec) {
+    SSL_CTX_set_timeout(ctx_, static_cast<long>(timeout_sec));
+
+    if (cache_size > 0) {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(ctx_, static_cast<long>(cache_size));
+        // Cached sessions are only offered back to this context.
+        static const unsigned char kSessionIdContext[] = "reactor";
+        SSL_CTX_set_session_id_context(ctx_, kSessionIdContext,
+                                       sizeof(kSessionIdContext) - 1);
+    } else {
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_OFF);
+    }
+
+    if (!tickets) {
+        SSL_CTX_set_options(ctx_, SSL_OP_NO_TICKET);
+        // With neither tickets nor a cache there is nothing to resume
+        // from — stop TLS 1.3 from sending NewSessionTicket at all.
+        if (cache_size == 0) {
+            SSL_CTX_set_num_tickets(ctx_, 0);
+        }
+        return;
+    }
+
+    auto keys = std::make_shared<TicketKeySet>(
+        ticket_key_file.empty() ? TicketKeySet{GenerateTicketKey()}
+                                : LoadTicketKeyFile(ticket_key_file));
+    {
+        std::lock_guard<std::mutex> lock(ticket_keys_mtx_);
+        ticket_keys_ = std::move(keys);
+    }
+    tickets_enabled_ = true;
+    ticket_key_file_ = ticket_key_file;
+
+    SSL_CTX_clear_options(ctx_, SSL_OP_NO_TICKET);
+    SSL_CTX_set_app_data(ctx_, this);
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx_, TicketKeyCallback);
+}
+
+void TlsContext::RotateTicketKeys() {
+    if (!tickets_enabled_) return;
+
+    std::shared_ptr<const TicketKeySet> next;
+    if (!ticket_key_file_.empty()) {
+        next = std::make_shared<TicketKeySet>(LoadTicketKeyFile(ticket_key_file_));
+    } else {
+        auto rotated = std::make_shared<TicketKeySet>();
+        rotated->push_back(GenerateTicketKey());
+        auto current = TicketKeys();
+        if (current && !current->empty()) {
+            rotated->push_back(current->front());
+        }
+        next = std::move(rotated);
+    }
+
+    std::lock_guard<std::mutex> lock(ticket_keys_mtx_);
+    ticket_keys_ = std::move(next);
+}
+
+size_t TlsContext::TicketKeyCount() const {
+    auto keys = TicketKeys();
+    return keys ? keys->size() : 0;
+}
+
+std::shared_ptr<const TlsContext::TicketKeySet> TlsContext::TicketKeys() const {
+    std::lock_guard<std::mutex> lock(ticket_keys_mtx_);
+    return ticket_keys_;
+}
+
+TlsContext::TicketKeySet TlsContext::LoadTicketKeyFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Failed to open TLS ticket key file: " + path);
+    }
+    std::string raw((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+
+    size_t key_size = 0;
+    if (!raw.empty() && raw.size() % TICKET_KEY_SIZE == 0) {
+        key_size = TICKET_KEY_SIZE;
+    } else if (!raw.empty() && raw.size() % TICKET_KEY_SIZE_LEGACY == 0) {
+        key_size = TICKET_KEY_SIZE_LEGACY;
+    } else {
+        OPENSSL_cleanse(raw.data(), raw.size());
+        throw std::runtime_error(
+            "TLS ticket key file must hold one or more 80-byte (or 48-byte) "
+            "keys: " + path + " has " + std::to_string(raw.size()) + " bytes");
+    }
+
+    TicketKeySet keys;
+    const auto* p = reinterpret_cast<const unsigned char*>(raw.data());
+    for (size_t off = 0; off < raw.size(); off += key_size) {
+        TicketKey key;
+        const size_t secret_len = (key_size == TICKET_KEY_SIZE) ? 32 : 16;
+        std::memcpy(key.name.data(), p + off, 16);
+        std::memcpy(key.hmac_key.data(), p + off + 16, secret_len);
+        std::memcpy(key.aes_key.data(), p + off + 16 + secret_len, secret_len);
+        key.hmac_len = secret_len;
+        key.aes256 = (key_size == TICKET_KEY_SIZE);
+        keys.push_back(key);
+    }
+    OPENSSL_cleanse(raw.data(), raw.size());
+    return keys;
+}
+
+TlsContext::TicketKey TlsContext::GenerateTicketKey() {
+    TicketKey key;
+    if (RAND_bytes(key.name.data(), static_cast<int>(key.name.size())) != 1 ||
+        RAND_bytes(key.hmac_key.data(), static_cast<int>(key.hmac_key.size())) != 1 ||
+        RAND_bytes(key.aes_key.data(), static_cast<int>(key.aes_key.size())) != 1) {
+        throw std::runtime_error("Failed to generate TLS ticket key");
+    }
+    return key;
+}
+
+int TlsContext::TicketKeyCallback(SSL* ssl, unsigned char* key_name,
+                                  unsigned char* iv,
+                                  EVP_CIPHER_CTX* cipher_ctx,
+                                  EVP_MAC_CTX* mac_ctx, int enc) {
+    auto* self = static_cast<TlsContext*>(
+        SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    if (!self) return -1;
+    auto keys = self->TicketKeys();
+    // Without a key: issue no ticket / treat the presented one as unknown.
+    if (!keys || keys->empty()) return 0;
+
+    size_t index = 0;
+    if (!enc) {
+        while (index < keys->size() &&
+               std::memcmp((*keys)[index].name.data(), key_name, 16) != 0) {
+            ++index;
+        }
+        if (index == keys->size()) return 0;  // full handshake, new ticket
+    }
+    const TicketKey& key = (*keys)[index];
+
+    OSSL_PARAM params[3];
+    params[0] = OSSL_PARAM_construct_octet_string(
+        OSSL_MAC_PARAM_KEY, const_cast<unsigned char*>(key.hmac_key.data()),
+        key.hmac_len);
+    params[1] = OSSL_PARAM_construct_utf8_string(
+        OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0);
+    params[2] = OSSL_PARAM_construct_end();
+
+    const EVP_CIPHER* cipher = key.aes256 ? EVP_aes_256_cbc() : EVP_aes_128_cbc();
+    if (enc) {
+        std::memcpy(key_name, key.name.data(), 16);
+        if (RAND_bytes(iv, EVP_CIPHER_get_iv_length(cipher)) != 1 ||
+            EVP_EncryptInit_ex(cipher_ctx, cipher, nullptr,
+                               key.aes_key.data(), iv) != 1 ||
+            EVP_MAC_CTX_set_params(mac_ctx, params) != 1) {
+            return -1;
+        }
+        return 1;
+    }
+
+    if (EVP_MAC_CTX_set_params(mac_ctx, params) != 1 ||
+        EVP_DecryptInit_ex(cipher_ctx, cipher, nullptr,
+                           key.aes_key.data(), iv) != 1) {
+        return -1;
+    }
+    // Decrypted with a retired key: resume, but re-issue the ticket under
+    // the current one so clients migrate before the old key is dropped.
+    return index == 0 ? 1 : 2;
+}
@@ -0,0 +1,263 @@
+// RSA_METHOD / EC_KEY_METHOD are deprecated in OpenSSL 3.0 but remain the
+// only way to intercept libssl's signature without an engine or provider;
+// this translation unit opts out of the deprecation warnings.
+#define OPENSSL_SUPPRESS_DEPRECATED
+
+#include "tls/tls_key_offloader.h"
+#include "log/logger.h"
+#include <openssl/async.h>
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/rsa.h>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+thread_local TlsKeyOffloader::Scope* current_scope = nullptr;
+
+// Default implementations the hooks delegate to — on the worker, or
+// inline when there is nothing to offload to.
+int (*default_rsa_priv_enc)(int, const unsigned char*, unsigned char*,
+                            RSA*, int) = nullptr;
+ECDSA_SIG* (*default_ecdsa_sign_sig)(const unsigned char*, int,
+                                     const BIGNUM*, const BIGNUM*,
+                                     EC_KEY*) = nullptr;
+
+}  // namespace
+
+class TlsKeyOffloader::Task : public ThreadTaskInterface {
+public:
+    Task(TlsKeyOffloader& owner, std::shared_ptr<Operation> op)
+        : owner_(owner), op_(std::move(op)) {}
+
+protected:
+    int RunTask() override {
+        int expected = Operation::QUEUED;
+        if (!op_->state_.compare_exchange_strong(expected, Operation::RUNNING,
+                                                 std::memory_order_acq_rel)) {
+            return 0;  // cancelled while queued
+        }
+        owner_.Run(*op_);
+        auto resume = std::move(op_->resume_);
+        owner_.completed_.fetch_add(1, std::memory_order_relaxed);
+        op_->state_.store(Operation::DONE, std::memory_order_release);
+        if (resume) resume();
+        return 0;
+    }
+
+private:
+    TlsKeyOffloader& owner_;
+    std::shared_ptr<Operation> op_;
+};
+
+TlsKeyOffloader::Operation::~Operation() {
+    if (rsa_) RSA_free(rsa_);
+    if (ec_key_) EC_KEY_free(ec_key_);
+    if (ecdsa_sig_) ECDSA_SIG_free(ecdsa_sig_);
+}
+
+bool TlsKeyOffloader::Operation::Cancel() {
+    int expected = QUEUED;
+    return state_.compare_exchange_strong(expected, CANCELLED,
+                                          std::memory_order_acq_rel);
+}
+
+TlsKeyOffloader::Scope::Scope(TlsKeyOffloader* offloader,
+                              std::shared_ptr<Operation>* pending,
+                              const std::function<void()>* resume)
+    : offloader_(offloader), pending_(pending), resume_(resume),
+      previous_(current_scope) {
+    current_scope = this;
+}
+
+TlsKeyOffloader::Scope::~Scope() {
+    current_scope = previous_;
+}
+
+TlsKeyOffloader::TlsKeyOffloader(int threads) : threads_(threads) {
+    if (threads <= 0) {
+        throw std::runtime_error("TLS key offload needs at least one thread");
+    }
+    pool_.SetErrorLogger([](const std::string& msg) {
+        logging::Get()->error("TLS key offload pool: {}", msg);
+    });
+    pool_.Init(threads);
+    pool_.Start();
+}
+
+TlsKeyOffloader::~TlsKeyOffloader() {
+    pool_.Stop();
+}
+
+bool TlsKeyOffloader::Supported() {
+    return ASYNC_is_capable() == 1;
+}
+
+EVP_PKEY* TlsKeyOffloader::WrapKey(EVP_PKEY* key) {
+    // Methods are process-wide: they carry no per-key state, the binding
+    // to a pool comes from the Scope of the handshake being driven.
+    static RSA_METHOD* rsa_method = [] {
+        const RSA_METHOD* base = RSA_PKCS1_OpenSSL();
+        default_rsa_priv_enc = RSA_meth_get_priv_enc(base);
+        RSA_METHOD* m = RSA_meth_dup(base);
+        if (m) {
+            RSA_meth_set1_name(m, "reactor offloaded RSA");
+            RSA_meth_set_priv_enc(m, &TlsKeyOffloader::RsaPrivateEncrypt);
+        }
+        return m;
+    }();
+    static EC_KEY_METHOD* ec_method = [] {
+        const EC_KEY_METHOD* base = EC_KEY_OpenSSL();
+        int (*sign)(int, const unsigned char*, int, unsigned char*,
+                    unsigned int*, const BIGNUM*, const BIGNUM*,
+                    EC_KEY*) = nullptr;
+        int (*sign_setup)(EC_KEY*, BN_CTX*, BIGNUM**, BIGNUM**) = nullptr;
+        EC_KEY_METHOD_get_sign(base, &sign, &sign_setup,
+                               &default_ecdsa_sign_sig);
+        EC_KEY_METHOD* m = EC_KEY_METHOD_new(base);
+        if (m) {
+            EC_KEY_METHOD_set_sign(m, sign, sign_setup,
+                                   &TlsKeyOffloader::EcdsaSign);
+        }
+        return m;
+    }();
+
+    if (key == nullptr) return nullptr;
+    EVP_PKEY* wrapped = nullptr;
+    switch (EVP_PKEY_get_base_id(key)) {
+        case EVP_PKEY_RSA: {
+            if (rsa_method == nullptr) return nullptr;
+            RSA* shared = EVP_PKEY_get1_RSA(key);
+            RSA* copy = shared ? RSAPrivateKey_dup(shared) : nullptr;
+            RSA_free(shared);
+            if (copy == nullptr || RSA_set_method(copy, rsa_method) != 1) {
+                RSA_free(copy);
+                return nullptr;
+            }
+            wrapped = EVP_PKEY_new();
+            if (wrapped == nullptr || EVP_PKEY_assign_RSA(wrapped, copy) != 1) {
+                RSA_free(copy);
+                EVP_PKEY_free(wrapped);
+                return nullptr;
+            }
+            break;
+        }
+        case EVP_PKEY_EC: {
+            if (ec_method == nullptr) return nullptr;
+            EC_KEY* shared = EVP_PKEY_get1_EC_KEY(key);
+            EC_KEY* copy = shared ? EC_KEY_dup(shared) : nullptr;
+            EC_KEY_free(shared);
+            if (copy == nullptr || EC_KEY_set_method(copy, ec_method) != 1) {
+                EC_KEY_free(copy);
+                return nullptr;
+            }
+            wrapped = EVP_PKEY_new();
+            if (wrapped == nullptr ||
+                EVP_PKEY_assign_EC_KEY(wrapped, copy) != 1) {
+                EC_KEY_free(copy);
+                EVP_PKEY_free(wrapped);
+                return nullptr;
+            }
+            break;
+        }
+        default:
+            return nullptr;
+    }
+    return wrapped;
+}
+
+bool TlsKeyOffloader::SubmitAndWait(Scope& scope,
+                                    const std::shared_ptr<Operation>& op) {
+    op->resume_ = *scope.resume_;
+    *scope.pending_ = op;
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    try {
+        pool_.AddTask(std::make_shared<Task>(*this, op));
+    } catch (const std::exception&) {
+        // Pool stopped (shutdown): fall back to signing here.
+        op->state_.store(Operation::RUNNING, std::memory_order_relaxed);
+        Run(*op);
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        op->state_.store(Operation::DONE, std::memory_order_release);
+        return true;
+    }
+    // Spurious resumes (socket events while the worker is busy) re-enter
+    // the job before the result is in; pause again until it is.
+    for (;;) {
+        const int state = op->state_.load(std::memory_order_acquire);
+        if (state == Operation::DONE) return true;
+        if (state == Operation::CANCELLED) {
+            cancelled_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (ASYNC_pause_job() != 1) {
+            // Could not pause: claim the operation back, or wait out the
+            // worker that already has it.
+            if (op->Cancel()) {
+                Run(*op);
+                completed_.fetch_add(1, std::memory_order_relaxed);
+                op->state_.store(Operation::DONE, std::memory_order_release);
+                return true;
+            }
+            while (!op->IsDone()) std::this_thread::yield();
+            return true;
+        }
+    }
+}
+
+void TlsKeyOffloader::Run(Operation& op) {
+    if (op.rsa_ != nullptr) {
+        op.output_.resize(static_cast<size_t>(RSA_size(op.rsa_)));
+        op.rsa_result_ = default_rsa_priv_enc(
+            static_cast<int>(op.input_.size()), op.input_.data(),
+            op.output_.data(), op.rsa_, op.rsa_padding_);
+    } else if (op.ec_key_ != nullptr) {
+        op.ecdsa_sig_ = default_ecdsa_sign_sig(
+            op.input_.data(), static_cast<int>(op.input_.size()),
+            nullptr, nullptr, op.ec_key_);
+    }
+    // Errors stay on the worker's queue otherwise; the handshake reports
+    // the failure through the missing result.
+    ERR_clear_error();
+}
+
+int TlsKeyOffloader::RsaPrivateEncrypt(int flen, const unsigned char* from,
+                                       unsigned char* to, RSA* rsa,
+                                       int padding) {
+    Scope* scope = current_scope;
+    if (scope == nullptr || ASYNC_get_current_job() == nullptr) {
+        return default_rsa_priv_enc(flen, from, to, rsa, padding);
+    }
+    auto op = std::make_shared<Operation>();
+    op->input_.assign(from, from + flen);
+    RSA_up_ref(rsa);
+    op->rsa_ = rsa;
+    op->rsa_padding_ = padding;
+    if (!scope->offloader_->SubmitAndWait(*scope, op)) return -1;
+    if (op->rsa_result_ > 0) {
+        std::memcpy(to, op->output_.data(),
+                    static_cast<size_t>(op->rsa_result_));
+    }
+    return op->rsa_result_;
+}
+
+ECDSA_SIG* TlsKeyOffloader::EcdsaSign(const unsigned char* dgst, int dgst_len,
+                                      const BIGNUM* kinv, const BIGNUM* r,
+                                      EC_KEY* eckey) {
+    Scope* scope = current_scope;
+    // Precomputed (kinv, r) is a caller-managed setup this path never
+    // sees from libssl; keep it inline rather than copy the bignums.
+    if (scope == nullptr || ASYNC_get_current_job() == nullptr ||
+        kinv != nullptr || r != nullptr) {
+        return default_ecdsa_sign_sig(dgst, dgst_len, kinv, r, eckey);
+    }
+    auto op = std::make_shared<Operation>();
+    op->input_.assign(dgst, dgst + dgst_len);
+    EC_KEY_up_ref(eckey);
+    op->ec_key_ = eckey;
+    if (!scope->offloader_->SubmitAndWait(*scope, op)) return nullptr;
+    ECDSA_SIG* sig = op->ecdsa_sig_;
+    op->ecdsa_sig_ = nullptr;  // ownership passes to the caller
+    return sig;
+}
@@ -0,0 +1,113 @@
+#include "tls/tls_session_cache.h"
+#include <ctime>
+
+namespace {
+
+// Per-SSL binding, owned by the SSL's ex_data slot and released with it.
+// Holds the cache by shared_ptr so a connection that outlives its
+// partition during teardown never points at a freed cache.
+struct Binding {
+    std::shared_ptr<TlsSessionCache> cache;
+    std::string key;
+};
+
+void FreeBinding(void* /*parent*/, void* ptr, CRYPTO_EX_DATA* /*ad*/,
+                 int /*idx*/, long /*argl*/, void* /*argp*/) {
+    delete static_cast<Binding*>(ptr);
+}
+
+bool IsUsable(const SSL_SESSION* session) {
+    if (SSL_SESSION_is_resumable(session) != 1) return false;
+    const long issued = SSL_SESSION_get_time(session);
+    const long lifetime = SSL_SESSION_get_timeout(session);
+    return static_cast<long>(std::time(nullptr)) < issued + lifetime;
+}
+
+}  // namespace
+
+TlsSessionCache::TlsSessionCache(size_t capacity)
+    : capacity_(capacity == 0 ? 1 : capacity) {}
+
+TlsSessionCache::~TlsSessionCache() {
+    for (auto& kv : entries_) {
+        SSL_SESSION_free(kv.second.session);
+    }
+}
+
+int TlsSessionCache::BindingIndex() {
+    // Function-local static: thread-safe one-time registration.
+    static const int index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, FreeBinding);
+    return index;
+}
+
+bool TlsSessionCache::Attach(SSL* ssl, const std::string& key) {
+    const int index = BindingIndex();
+    if (index < 0) return false;
+    auto* binding = new Binding{shared_from_this(), key};
+    if (SSL_set_ex_data(ssl, index, binding) != 1) {
+        delete binding;
+        return false;
+    }
+
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    if (!IsUsable(it->second.session)) {
+        SSL_SESSION_free(it->second.session);
+        entries_.erase(it);
+        return false;
+    }
+    // Offer a copy for the same reason NewSessionCallback stores one: a
+    // resumed connection that is later dropped uncleanly would otherwise
+    // mark the cached entry non-resumable. Servers need not issue a fresh
+    // ticket on resumption, so the entry must survive to be offered again.
+    SSL_SESSION* offer = SSL_SESSION_dup(it->second.session);
+    if (offer == nullptr) return false;
+    const bool set = SSL_set_session(ssl, offer) == 1;
+    SSL_SESSION_free(offer);  // SSL_set_session took its own reference
+    return set;
+}
+
+void TlsSessionCache::Remove(const std::string& key) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return;
+    SSL_SESSION_free(it->second.session);
+    entries_.erase(it);
+}
+
+void TlsSessionCache::Store(const std::string& key, SSL_SESSION* session) {
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        SSL_SESSION_free(it->second.session);
+        it->second.session = session;
+        it->second.stored_seq = ++seq_;
+        return;
+    }
+    if (entries_.size() >= capacity_) {
+        // Evict the least recently stored key. Capacity is small (one key
+        // per endpoint of one upstream), so a scan beats bookkeeping.
+        auto oldest = entries_.begin();
+        for (auto e = entries_.begin(); e != entries_.end(); ++e) {
+            if (e->second.stored_seq < oldest->second.stored_seq) oldest = e;
+        }
+        SSL_SESSION_free(oldest->second.session);
+        entries_.erase(oldest);
+    }
+    entries_.emplace(key, Entry{session, ++seq_});
+}
+
+int TlsSessionCache::NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+    const int index = BindingIndex();
+    if (index < 0) return 0;
+    auto* binding = static_cast<Binding*>(SSL_get_ex_data(ssl, index));
+    if (binding == nullptr || !binding->cache) return 0;
+    if (SSL_SESSION_is_resumable(session) != 1) return 0;
+    // Keep a private copy rather than taking the connection's reference:
+    // OpenSSL marks a connection's session non-resumable when the SSL is
+    // freed without a close_notify, which is how pooled connections that
+    // are reaped or dropped by the peer usually end.
+    SSL_SESSION* copy = SSL_SESSION_dup(session);
+    if (copy == nullptr) return 0;
+    binding->cache->Store(binding->key, copy);
+    return 0;
+}
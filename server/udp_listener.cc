@@ -0,0 +1,272 @@
+#include "http3/udp_listener.h"
+#include "log/logger.h"
+#include "log/log_utils.h"
+
+UdpListener::UdpListener(std::shared_ptr<Dispatcher> dispatcher,
+                         size_t batch_size, size_t max_datagram_size)
+    : dispatcher_(std::move(dispatcher)),
+      batch_size_(std::max<size_t>(1, batch_size)),
+      max_datagram_size_(std::max<size_t>(1, max_datagram_size)),
+      recv_storage_(batch_size_ * (max_datagram_size_ + 1)),
+      recv_addrs_(batch_size_) {
+#if defined(__linux__)
+    recv_msgs_.resize(batch_size_);
+    recv_iovs_.resize(batch_size_);
+#endif
+}
+
+UdpListener::~UdpListener() {
+    Close();
+}
+
+void UdpListener::Open(const InetAddr& bind_addr) {
+    if (!bind_addr.is_valid()) {
+        throw std::runtime_error("UdpListener: invalid bind address");
+    }
+    const int family =
+        (bind_addr.family() == InetAddr::Family::kIPv6) ? AF_INET6 : AF_INET;
+#if defined(__linux__)
+    int fd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+#else
+    int fd = ::socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd >= 0) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (fd < 0) {
+        int saved_errno = errno;
+        throw std::runtime_error("UdpListener: socket() failed: " +
+                                 logging::SafeStrerror(saved_errno));
+    }
+
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0) {
+        int saved_errno = errno;
+        ::close(fd);
+        throw std::runtime_error("UdpListener: SO_REUSEPORT failed: " +
+                                 logging::SafeStrerror(saved_errno));
+    }
+    // Same fail-closed v6-only rule as the TCP Acceptor: peer addresses
+    // must be plain v4 or v6 for the IP-based rate-limit / ACL contract.
+    if (family == AF_INET6 &&
+        ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on)) != 0) {
+        int saved_errno = errno;
+        ::close(fd);
+        throw std::runtime_error("UdpListener: IPV6_V6ONLY failed: " +
+                                 logging::SafeStrerror(saved_errno));
+    }
+    if (::bind(fd, bind_addr.Addr(), bind_addr.Len()) != 0) {
+        int saved_errno = errno;
+        ::close(fd);
+        throw std::runtime_error("UdpListener: bind " + bind_addr.ToString() +
+                                 " failed: " + logging::SafeStrerror(saved_errno));
+    }
+    fd_ = fd;
+
+    // Channel owns the fd from here on (closed by CloseChannel / ~Channel).
+    channel_ = std::make_shared<Channel>(dispatcher_, fd_);
+    std::weak_ptr<UdpListener> weak_self = weak_from_this();
+    channel_->SetReadCallBackFn([weak_self]() {
+        if (auto self = weak_self.lock()) self->OnReadable();
+    });
+    channel_->SetWriteCallBackFn([weak_self]() {
+        if (auto self = weak_self.lock()) self->OnWritable();
+    });
+    // UDP sockets never see peer hangup; ignore HUP/ERR instead of letting
+    // Channel's default close path tear the listener down.
+    channel_->SetCloseCallBackFn([]() {});
+    channel_->SetErrorCallBackFn([]() {});
+    channel_->EnableETMode();
+    channel_->EnableReadMode();
+}
+
+void UdpListener::Close() {
+    if (channel_ && !channel_->is_channel_closed()) {
+        channel_->CloseChannel();
+    }
+}
+
+int UdpListener::GetBoundPort() const {
+    if (fd_ < 0) return 0;
+    sockaddr_storage ss{};
+    socklen_t len = sizeof(ss);
+    if (::getsockname(fd_, reinterpret_cast<sockaddr*>(&ss), &len) != 0) {
+        return 0;
+    }
+    return InetAddr(reinterpret_cast<sockaddr*>(&ss), len).Port();
+}
+
+UdpListener::Stats UdpListener::GetStats() const {
+    Stats s;
+    s.datagrams_received = datagrams_received_.load(std::memory_order_relaxed);
+    s.datagrams_sent = datagrams_sent_.load(std::memory_order_relaxed);
+    s.recv_batches = recv_batches_.load(std::memory_order_relaxed);
+    s.send_batches = send_batches_.load(std::memory_order_relaxed);
+    s.send_dropped = send_dropped_.load(std::memory_order_relaxed);
+    s.recv_truncated = recv_truncated_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void UdpListener::OnReadable() {
+    if (!channel_ || channel_->is_channel_closed()) return;
+    const size_t slot = max_datagram_size_ + 1;
+    in_read_drain_ = true;
+
+    // Edge-triggered: drain to EAGAIN or the next edge never fires.
+    for (;;) {
+#if defined(__linux__)
+        auto& msgs = recv_msgs_;
+        auto& iovs = recv_iovs_;
+        auto& addrs = recv_addrs_;
+        for (size_t i = 0; i < batch_size_; ++i) {
+            iovs[i].iov_base = recv_storage_.data() + i * slot;
+            iovs[i].iov_len = slot;
+            msgs[i] = mmsghdr{};
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+        int n = ::recvmmsg(fd_, msgs.data(), static_cast<unsigned>(batch_size_),
+                           MSG_DONTWAIT, nullptr);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logging::Get()->warn("UdpListener recvmmsg failed: {}",
+                                     logging::SafeStrerror(errno));
+            }
+            break;
+        }
+        if (n == 0) break;
+        recv_batches_.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            const size_t len = msgs[i].msg_len;
+            if (len > max_datagram_size_ || (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+                recv_truncated_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+            InetAddr peer(reinterpret_cast<sockaddr*>(&addrs[i]),
+                          msgs[i].msg_hdr.msg_namelen);
+            if (datagram_cb_) {
+                datagram_cb_(peer, recv_storage_.data() + i * slot, len);
+            }
+        }
+        if (static_cast<size_t>(n) < batch_size_) break;
+#else
+        sockaddr_storage& addr = recv_addrs_[0];
+        socklen_t alen = sizeof(addr);
+        ssize_t len = ::recvfrom(fd_, recv_storage_.data(), slot, 0,
+                                 reinterpret_cast<sockaddr*>(&addr), &alen);
+        if (len < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logging::Get()->warn("UdpListener recvfrom failed: {}",
+                                     logging::SafeStrerror(errno));
+            }
+            break;
+        }
+        recv_batches_.fetch_add(1, std::memory_order_relaxed);
+        if (static_cast<size_t>(len) > max_datagram_size_) {
+            recv_truncated_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+        InetAddr peer(reinterpret_cast<sockaddr*>(&addr), alen);
+        if (datagram_cb_) {
+            datagram_cb_(peer, recv_storage_.data(), static_cast<size_t>(len));
+        }
+#endif
+        if (!channel_ || channel_->is_channel_closed()) break;
+    }
+
+    in_read_drain_ = false;
+    // Responses produced synchronously by the callbacks above leave in
+    // one batch here instead of one syscall each.
+    Flush();
+}
+
+void UdpListener::OnWritable() {
+    if (write_armed_) {
+        write_armed_ = false;
+        channel_->DisableWriteMode();
+    }
+    Flush();
+}
+
+void UdpListener::Send(const InetAddr& peer, std::string payload) {
+    if (!channel_ || channel_->is_channel_closed()) {
+        send_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (pending_.size() >= MAX_PENDING_DATAGRAMS) {
+        send_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending_.push_back(Outbound{peer, std::move(payload)});
+    if (!in_read_drain_) ScheduleFlush();
+}
+
+void UdpListener::ScheduleFlush() {
+    if (flush_scheduled_ || write_armed_) return;
+    flush_scheduled_ = true;
+    std::weak_ptr<UdpListener> weak_self = weak_from_this();
+    dispatcher_->EnQueue([weak_self]() {
+        auto self = weak_self.lock();
+        if (!self) return;
+        self->flush_scheduled_ = false;
+        self->Flush();
+    });
+}
+
+void UdpListener::Flush() {
+    if (!channel_ || channel_->is_channel_closed()) {
+        send_dropped_.fetch_add(pending_.size(), std::memory_order_relaxed);
+        pending_.clear();
+        return;
+    }
+    while (!pending_.empty() && !write_armed_) {
+#if defined(__linux__)
+        const size_t count = std::min(pending_.size(), batch_size_);
+        std::vector<mmsghdr> msgs(count);
+        std::vector<iovec> iovs(count);
+        for (size_t i = 0; i < count; ++i) {
+            Outbound& o = pending_[i];
+            iovs[i].iov_base = o.payload.data();
+            iovs[i].iov_len = o.payload.size();
+            msgs[i] = mmsghdr{};
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(o.peer.Addr());
+            msgs[i].msg_hdr.msg_namelen = o.peer.Len();
+        }
+        int n = ::sendmmsg(fd_, msgs.data(), static_cast<unsigned>(count), SEND_FLAGS);
+#else
+        Outbound& o = pending_.front();
+        int n = ::sendto(fd_, o.payload.data(), o.payload.size(), SEND_FLAGS,
+                         o.peer.Addr(), o.peer.Len()) < 0 ? -1 : 1;
+#endif
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+                // Socket buffer full — resume on EPOLLOUT.
+                write_armed_ = true;
+                channel_->EnableWriteMode();
+                return;
+            }
+            // Hard per-datagram error (e.g. EMSGSIZE, unreachable peer):
+            // drop the head datagram and keep going with the rest.
+            logging::Get()->debug("UdpListener send to {} failed: {}",
+                                  pending_.front().peer.ToString(),
+                                  logging::SafeStrerror(errno));
+            pending_.pop_front();
+            send_dropped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        send_batches_.fetch_add(1, std::memory_order_relaxed);
+        datagrams_sent_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        pending_.erase(pending_.begin(), pending_.begin() + n);
+    }
+}
@@ -21,6 +21,17 @@ namespace {
 // not register one to keep readers from assuming there's a wired send
 // path.
 
+// Hand a completed interim HEADERS block (103 Early Hints etc.) to the
+// sink. 100 Continue carries nothing a sink can use and is not reported.
+void ReportInterim(UpstreamH2Stream* stream) {
+    if (!stream->sink ||
+        stream->response_head.status_code == HttpStatus::CONTINUE) {
+        return;
+    }
+    stream->sink->OnInterimHeaders(stream->response_head.status_code,
+                                   stream->response_head.headers);
+}
+
 int OnFrameRecvCallback(nghttp2_session* /*session*/,
                         const nghttp2_frame* frame, void* user_data)
 {
@@ -42,6 +53,7 @@ int OnFrameRecvCallback(nghttp2_session* /*session*/,
             if (stream && stream->response_head.status_code >= 100 &&
                 stream->response_head.status_code < 200) {
                 stream->saw_1xx_interim = true;
+                ReportInterim(stream);
             } else {
                 self->OnHeadersComplete(frame->hd.stream_id, end_stream);
             }
@@ -56,6 +68,7 @@ int OnFrameRecvCallback(nghttp2_session* /*session*/,
                     stream->response_head.status_code < 200) {
                     // Another interim — keep waiting for the final.
                     stream->saw_1xx_interim = true;
+                    ReportInterim(stream);
                 } else {
                     self->OnHeadersComplete(frame->hd.stream_id, end_stream);
                 }
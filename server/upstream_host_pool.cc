@@ -2,6 +2,23 @@
 #include "tls/tls_client_context.h"
 #include "log/logger.h"
 
+namespace {
+
+// A member's view of its endpoint: the resolved entry with `addr`
+// narrowed to the member's own address.
+std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> MemberEndpoint(
+    const std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint>& ep,
+    size_t addr_index)
+{
+    if (ep->addrs.size() <= 1) return ep;
+    auto narrowed = std::make_shared<NET_DNS_NAMESPACE::ResolvedEndpoint>(*ep);
+    narrowed->addr = ep->addrs[addr_index % ep->addrs.size()];
+    narrowed->addrs = {narrowed->addr};
+    return narrowed;
+}
+
+}  // namespace
+
 UpstreamHostPool::UpstreamHostPool(
     const std::string& service_name,
     const std::string& host, int port,
@@ -17,20 +34,56 @@ UpstreamHostPool::UpstreamHostPool(
     std::atomic<bool>& manager_shutting_down,
     std::mutex& drain_mtx,
     std::condition_variable& drain_cv)
+    : UpstreamHostPool(service_name, host, port, sni_hostname,
+                       {EndpointSpec{host, port, 1, std::move(resolved_endpoint)}},
+                       LoadBalancerConfig{}, config, dispatchers,
+                       std::move(tls_ctx), outstanding_conns, inflight_leases,
+                       donated_h2_leases, std::move(off_dispatcher_release_drops),
+                       manager_shutting_down, drain_mtx, drain_cv) {}
+
+UpstreamHostPool::UpstreamHostPool(
+    const std::string& service_name,
+    const std::string& host, int port,
+    const std::string& sni_hostname,
+    std::vector<EndpointSpec> endpoints,
+    const LoadBalancerConfig& load_balancer,
+    const UpstreamPoolConfig& config,
+    const std::vector<std::shared_ptr<Dispatcher>>& dispatchers,
+    std::shared_ptr<TlsClientContext> tls_ctx,
+    std::atomic<int64_t>& outstanding_conns,
+    std::atomic<int64_t>& inflight_leases,
+    std::atomic<int64_t>& donated_h2_leases,
+    std::shared_ptr<std::atomic<int64_t>> off_dispatcher_release_drops,
+    std::atomic<bool>& manager_shutting_down,
+    std::mutex& drain_mtx,
+    std::condition_variable& drain_cv)
     : service_name_(service_name)
     , host_(host)
     , port_(port)
     , config_(config)
+    , lb_config_(load_balancer)
+    , endpoint_count_(endpoints.size())
     , dispatchers_(dispatchers)
 {
-    if (!resolved_endpoint) {
+    if (endpoints.empty()) {
+        throw std::invalid_argument(
+            "UpstreamHostPool '" + service_name +
+            "': at least one endpoint is required");
+    }
+    for (const auto& ep : endpoints) {
+        if (!ep.resolved) {
+            throw std::invalid_argument(
+                "UpstreamHostPool '" + service_name +
+                "': resolved_endpoint must not be null");
+        }
+    }
+    LoadBalancer::Policy policy = LoadBalancer::Policy::ROUND_ROBIN;
+    if (!LoadBalancer::ParsePolicy(load_balancer.policy, &policy)) {
         throw std::invalid_argument(
             "UpstreamHostPool '" + service_name +
-            "': resolved_endpoint must not be null");
+            "': unknown load_balancer.policy '" + load_balancer.policy + "'");
     }
-    // Create one partition per dispatcher
     size_t num_dispatchers = dispatchers.size();
-    partitions_.reserve(num_dispatchers);
 
     // Guard against negative limits from direct API callers that bypass
     // ConfigLoader::Validate. The static_cast<size_t> below would wrap
@@ -45,6 +98,11 @@ UpstreamHostPool::UpstreamHostPool(
             "upstream '" + service_name + "': pool.max_idle_connections (" +
             std::to_string(config.max_idle_connections) + ") must not be negative");
     }
+    if (config.min_idle_connections < 0) {
+        throw std::invalid_argument(
+            "upstream '" + service_name + "': pool.min_idle_connections (" +
+            std::to_string(config.min_idle_connections) + ") must not be negative");
+    }
 
     // Distribute limits across partitions using floor division + remainder.
     // The first R partitions get floor+1, the rest get floor. This ensures
@@ -58,8 +116,12 @@ UpstreamHostPool::UpstreamHostPool(
     // inflating the cap would defeat that limit and risk overloading the
     // upstream backend. A warning surfaces the mismatch so operators can
     // increase pool.max_connections if needed.
+    //
+    // With several endpoints the limits apply to each member (address)
+    // separately — they bound the load on one backend.
     size_t total_conn = static_cast<size_t>(config.max_connections);
     size_t total_idle = static_cast<size_t>(config.max_idle_connections);
+    size_t total_min_idle = static_cast<size_t>(config.min_idle_connections);
 
     if (num_dispatchers > 0 && total_conn < num_dispatchers) {
         logging::Get()->warn(
@@ -74,95 +136,324 @@ UpstreamHostPool::UpstreamHostPool(
     size_t conn_remainder = (num_dispatchers > 0) ? total_conn % num_dispatchers : 0;
     size_t idle_floor = (num_dispatchers > 0) ? total_idle / num_dispatchers : total_idle;
     size_t idle_remainder = (num_dispatchers > 0) ? total_idle % num_dispatchers : 0;
+    size_t min_idle_floor = (num_dispatchers > 0) ? total_min_idle / num_dispatchers : total_min_idle;
+    size_t min_idle_remainder = (num_dispatchers > 0) ? total_min_idle % num_dispatchers : 0;
 
-    for (size_t i = 0; i < num_dispatchers; ++i) {
-        UpstreamPoolConfig partition_config = config;
-        size_t per_partition = conn_floor + (i < conn_remainder ? 1 : 0);
-        partition_config.max_connections = static_cast<int>(per_partition);
+    std::vector<LoadBalancer::Member> lb_members;
+    for (size_t e = 0; e < endpoints.size(); ++e) {
+        const auto& spec = endpoints[e];
+        const size_t addr_count =
+            std::max<size_t>(1, spec.resolved->addrs.size());
+        for (size_t k = 0; k < addr_count; ++k) {
+            auto member_ep = MemberEndpoint(spec.resolved, k);
+            Member member;
+            member.endpoint_index = e;
+            member.addr_index = k;
+            member.partitions.reserve(num_dispatchers);
+            for (size_t i = 0; i < num_dispatchers; ++i) {
+                UpstreamPoolConfig partition_config = config;
+                size_t per_partition = conn_floor + (i < conn_remainder ? 1 : 0);
+                partition_config.max_connections = static_cast<int>(per_partition);
+
+                size_t per_partition_idle = idle_floor + (i < idle_remainder ? 1 : 0);
+                partition_config.max_idle_connections = static_cast<int>(per_partition_idle);
 
-        size_t per_partition_idle = idle_floor + (i < idle_remainder ? 1 : 0);
-        partition_config.max_idle_connections = static_cast<int>(per_partition_idle);
+                // Same split as max_idle, so a partition's floor never
+                // exceeds its idle cap when min <= max overall.
+                size_t per_partition_min_idle =
+                    min_idle_floor + (i < min_idle_remainder ? 1 : 0);
+                partition_config.min_idle_connections =
+                    static_cast<int>(per_partition_min_idle);
 
-        // All partitions share the same `resolved_endpoint` shared_ptr
-        // at construction. By-value capture here hands each partition an already-refcount-held pointer so
-        // destruction order within the pool doesn't matter.
-        partitions_.push_back(std::make_unique<PoolPartition>(
-            dispatchers[i], service_name, host, port, sni_hostname,
-            resolved_endpoint, partition_config, tls_ctx,
-            outstanding_conns, inflight_leases, donated_h2_leases,
-            off_dispatcher_release_drops,
-            manager_shutting_down, drain_mtx, drain_cv));
+                // All partitions of a member share the same endpoint
+                // shared_ptr at construction. By-value capture here hands
+                // each partition an already-refcount-held pointer so
+                // destruction order within the pool doesn't matter.
+                member.partitions.push_back(std::make_unique<PoolPartition>(
+                    dispatchers[i], service_name, spec.host, spec.port,
+                    sni_hostname, member_ep, partition_config, tls_ctx,
+                    outstanding_conns, inflight_leases, donated_h2_leases,
+                    off_dispatcher_release_drops,
+                    manager_shutting_down, drain_mtx, drain_cv));
+            }
+            // Hash identity: the address the member connects to, so
+            // gateways resolving the same records agree on placement.
+            lb_members.push_back(
+                {member_ep->addr.Ip() + ":" +
+                     std::to_string(member_ep->addr.Port()),
+                 spec.weight});
+            logging::Get()->info("UpstreamHostPool '{}' member {}:{} "
+                                 "(resolved={}:{}, weight={})",
+                                 service_name_, spec.host, spec.port,
+                                 member_ep->addr.Ip(), member_ep->addr.Port(),
+                                 spec.weight);
+            members_.push_back(std::move(member));
+        }
     }
 
+    balancer_ = std::make_unique<LoadBalancer>(policy, std::move(lb_members));
+    lb_states_.reserve(num_dispatchers);
+    for (size_t i = 0; i < num_dispatchers; ++i) {
+        lb_states_.push_back(balancer_->MakeState(i));
+    }
 
     logging::Get()->info("UpstreamHostPool '{}' created for {}:{} "
-                         "(resolved={}:{}) with {} partitions "
-                         "(max_conn={}, max_idle={})",
-                         service_name_, host_, port_,
-                         resolved_endpoint->addr.Ip(),
-                         resolved_endpoint->addr.Port(),
-                         num_dispatchers,
+                         "with {} member(s) x {} partitions "
+                         "(policy={}, max_conn={}, max_idle={})",
+                         service_name_, host_, port_, members_.size(),
+                         num_dispatchers, load_balancer.policy,
                          config.max_connections, config.max_idle_connections);
 }
 
 UpstreamHostPool::~UpstreamHostPool() {
+    for (auto& checker : health_checkers_) checker->Stop();
+    if (outlier_detector_) outlier_detector_->Stop();
     logging::Get()->debug("UpstreamHostPool '{}' destroyed", service_name_);
 }
 
 PoolPartition* UpstreamHostPool::GetPartition(size_t dispatcher_index) {
-    if (dispatcher_index >= partitions_.size()) {
+    if (dispatcher_index >= dispatchers_.size()) {
         logging::Get()->error("Invalid dispatcher index {} for pool '{}' "
                               "(partitions={})", dispatcher_index,
-                              service_name_, partitions_.size());
+                              service_name_, dispatchers_.size());
         return nullptr;
     }
-    return partitions_[dispatcher_index].get();
+    return members_.front().partitions[dispatcher_index].get();
+}
+
+PoolPartition* UpstreamHostPool::PickPartition(size_t dispatcher_index,
+                                               uint64_t hash) {
+    if (members_.size() == 1) return GetPartition(dispatcher_index);
+    if (dispatcher_index >= dispatchers_.size()) {
+        return GetPartition(dispatcher_index);  // logs and returns null
+    }
+    // The eligibility filter costs a call per candidate; only pay it
+    // while some member is failing its health checks or is ejected.
+    static const std::function<bool(size_t)> kAllEligible;
+    const std::function<bool(size_t)> in_rotation = [this](size_t i) {
+        return members_[i].healthy->load(std::memory_order_acquire) &&
+               !(outlier_detector_ && outlier_detector_->IsEjected(i));
+    };
+    const bool filtered =
+        unhealthy_count_->load(std::memory_order_acquire) > 0 ||
+        (outlier_detector_ && outlier_detector_->ejected_count() > 0);
+    const size_t m = balancer_->Pick(
+        lb_states_[dispatcher_index], hash,
+        [this, dispatcher_index](size_t i) {
+            return members_[i].partitions[dispatcher_index]->OutstandingRequests();
+        },
+        filtered ? in_rotation : kAllEligible);
+    return members_[m].partitions[dispatcher_index].get();
+}
+
+std::vector<PoolPartition*> UpstreamHostPool::PartitionsFor(
+        size_t dispatcher_index) const {
+    std::vector<PoolPartition*> out;
+    if (dispatcher_index >= dispatchers_.size()) return out;
+    out.reserve(members_.size());
+    for (const auto& member : members_) {
+        out.push_back(member.partitions[dispatcher_index].get());
+    }
+    return out;
+}
+
+std::vector<PoolPartition*> UpstreamHostPool::AllPartitions() const {
+    std::vector<PoolPartition*> out;
+    out.reserve(members_.size() * dispatchers_.size());
+    for (const auto& member : members_) {
+        for (const auto& partition : member.partitions) {
+            out.push_back(partition.get());
+        }
+    }
+    return out;
+}
+
+uint64_t UpstreamHostPool::RequestHash(
+        const std::string& client_ip, const std::string& path,
+        const std::map<std::string, std::string>& headers) const {
+    if (!balancer_->hashed() || members_.size() == 1) return 0;
+    const std::string& key = lb_config_.hash_key;
+    if (key == "client_ip") {
+        return client_ip.empty() ? 0 : LoadBalancer::Hash(client_ip);
+    }
+    if (key == "path") return LoadBalancer::Hash(path);
+    static constexpr std::string_view kHeaderPrefix = "header:";
+    if (key.size() > kHeaderPrefix.size() &&
+        key.compare(0, kHeaderPrefix.size(), kHeaderPrefix) == 0) {
+        // Header names are stored lowercase by the parser.
+        std::string name = key.substr(kHeaderPrefix.size());
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        auto it = headers.find(name);
+        if (it == headers.end()) return 0;
+        return LoadBalancer::Hash(it->second);
+    }
+    return 0;
 }
 
 int64_t UpstreamHostPool::preconnect_fired_count() const noexcept {
     int64_t total = 0;
-    for (const auto& partition : partitions_) {
-        if (partition) total += partition->preconnect_fired_count();
+    for (const auto& member : members_) {
+        for (const auto& partition : member.partitions) {
+            if (partition) total += partition->preconnect_fired_count();
+        }
     }
     return total;
 }
 
 int64_t UpstreamHostPool::preconnect_skipped_cap_count() const noexcept {
     int64_t total = 0;
-    for (const auto& partition : partitions_) {
-        if (partition) total += partition->preconnect_skipped_cap_count();
+    for (const auto& member : members_) {
+        for (const auto& partition : member.partitions) {
+            if (partition) total += partition->preconnect_skipped_cap_count();
+        }
+    }
+    return total;
+}
+
+int64_t UpstreamHostPool::tls_handshakes_full() const noexcept {
+    int64_t total = 0;
+    for (const auto& member : members_) {
+        for (const auto& partition : member.partitions) {
+            if (partition) total += partition->tls_handshakes_full();
+        }
+    }
+    return total;
+}
+
+int64_t UpstreamHostPool::tls_handshakes_resumed() const noexcept {
+    int64_t total = 0;
+    for (const auto& member : members_) {
+        for (const auto& partition : member.partitions) {
+            if (partition) total += partition->tls_handshakes_resumed();
+        }
+    }
+    return total;
+}
+
+void UpstreamHostPool::StartHealthChecks(
+        const UpstreamHealthCheckConfig& health_check) {
+    if (!health_check.enabled || !health_checkers_.empty()) return;
+    if (dispatchers_.empty()) return;
+    // Dispatchers [0, cap) are the ones whose partitions got a share of
+    // max_connections (see the floor + remainder split in the ctor).
+    // Spreading members over them keeps checks off a single loop.
+    const size_t cap = std::max<size_t>(1, std::min<size_t>(
+        dispatchers_.size(), static_cast<size_t>(config_.max_connections)));
+    std::string host_header = host_;
+    if (port_ != 80 && port_ != 443) {
+        host_header += ":" + std::to_string(port_);
+    }
+    health_checkers_.reserve(members_.size());
+    for (size_t m = 0; m < members_.size(); ++m) {
+        auto* partition = members_[m].partitions[m % cap].get();
+        const std::string& label = balancer_->member(m).key;
+        auto healthy = members_[m].healthy;
+        auto unhealthy_count = unhealthy_count_;
+        auto checker = std::make_shared<HealthChecker>(
+            partition, label, health_check, host_header,
+            LoadBalancer::Hash(service_name_ + "/" + label),
+            [healthy, unhealthy_count](bool now_healthy, const std::string&) {
+                // The checker only reports real flips, so the count
+                // stays in step with the flags.
+                healthy->store(now_healthy, std::memory_order_release);
+                unhealthy_count->fetch_add(now_healthy ? -1 : 1,
+                                           std::memory_order_acq_rel);
+            });
+        checker->Start();
+        health_checkers_.push_back(std::move(checker));
+    }
+    logging::Get()->info("UpstreamHostPool '{}' health checks started "
+                         "(type={}, interval={}ms, members={})",
+                         service_name_, health_check.type,
+                         health_check.interval_ms, members_.size());
+}
+
+void UpstreamHostPool::StartOutlierDetection(
+        const CircuitBreakerConfig& circuit_breaker) {
+    if (members_.size() < 2 || outlier_detector_ || dispatchers_.empty()) {
+        return;
+    }
+    std::vector<std::string> labels;
+    labels.reserve(members_.size());
+    for (size_t m = 0; m < members_.size(); ++m) {
+        labels.push_back(balancer_->member(m).key);
+    }
+    outlier_detector_ = std::make_shared<CIRCUIT_BREAKER_NAMESPACE::OutlierDetector>(
+        service_name_, std::move(labels), dispatchers_.size(), circuit_breaker);
+    outlier_detector_->Start(dispatchers_);
+}
+
+void UpstreamHostPool::ReloadOutlierDetection(
+        const CircuitBreakerConfig& circuit_breaker) {
+    if (outlier_detector_) outlier_detector_->Reload(circuit_breaker);
+}
+
+void UpstreamHostPool::RecordOutcome(size_t dispatcher_index,
+                                     const PoolPartition* partition,
+                                     bool failure, int64_t latency_ms) {
+    if (!outlier_detector_ || dispatcher_index >= dispatchers_.size()) return;
+    for (size_t m = 0; m < members_.size(); ++m) {
+        if (members_[m].partitions[dispatcher_index].get() != partition) continue;
+        outlier_detector_->Record(dispatcher_index, m, failure, latency_ms,
+                                  std::chrono::steady_clock::now());
+        return;
+    }
+}
+
+int64_t UpstreamHostPool::health_checks_passed() const noexcept {
+    int64_t total = 0;
+    for (const auto& checker : health_checkers_) {
+        total += checker->checks_passed();
+    }
+    return total;
+}
+
+int64_t UpstreamHostPool::health_checks_failed() const noexcept {
+    int64_t total = 0;
+    for (const auto& checker : health_checkers_) {
+        total += checker->checks_failed();
     }
     return total;
 }
 
 void UpstreamHostPool::InitiateShutdown(int server_drain_timeout_sec) {
+    for (auto& checker : health_checkers_) checker->Stop();
+    if (outlier_detector_) outlier_detector_->Stop();
     // Route through PoolPartition::ScheduleInitiateShutdown so the enqueue
     // is tracked by the partition's inflight_tasks_ counter. The partition
     // destructor blocks on that counter before freeing containers, which
     // eliminates the standalone-teardown race where a queued InitiateShutdown
     // lambda could run after the partition had been freed.
-    for (auto& partition : partitions_) {
-        partition->ScheduleInitiateShutdown(server_drain_timeout_sec);
+    for (auto& member : members_) {
+        for (auto& partition : member.partitions) {
+            partition->ScheduleInitiateShutdown(server_drain_timeout_sec);
+        }
     }
 }
 
 void UpstreamHostPool::UpdateResolvedEndpoint(
-    std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> new_ep)
+    std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint> new_ep,
+    size_t endpoint_index)
 {
     if (!new_ep) return;
-    for (auto& part : partitions_) {
-        // Capture old before swapping for the endpoint-change check.
-        auto old_ep = part->LoadResolvedEndpoint();
-
-        // No-change short-circuit: skip the swap and the cleanup enqueue
-        // when IP+port are the same. Avoids closing healthy idle keepalives
-        // on a no-op reload.
-        if (old_ep && old_ep->addr.Ip() == new_ep->addr.Ip() &&
-                      old_ep->addr.Port() == new_ep->addr.Port()) {
-            continue;
-        }
+    for (auto& member : members_) {
+        if (member.endpoint_index != endpoint_index) continue;
+        auto member_ep = MemberEndpoint(new_ep, member.addr_index);
+        for (auto& part : member.partitions) {
+            // Capture old before swapping for the endpoint-change check.
+            auto old_ep = part->LoadResolvedEndpoint();
 
-        part->StoreResolvedEndpoint(new_ep);
-        part->EnqueueIdleCleanupOnEndpointChange(old_ep);
+            // No-change short-circuit: skip the swap and the cleanup enqueue
+            // when IP+port are the same. Avoids closing healthy idle keepalives
+            // on a no-op reload.
+            if (old_ep && old_ep->addr.Ip() == member_ep->addr.Ip() &&
+                          old_ep->addr.Port() == member_ep->addr.Port()) {
+                continue;
+            }
+
+            part->StoreResolvedEndpoint(member_ep);
+            part->EnqueueIdleCleanupOnEndpointChange(old_ep);
+        }
     }
 }
@@ -145,6 +145,12 @@ static int on_headers_complete(llhttp_t* parser) {
             self->error_type_ = UpstreamHttpCodec::ParseError::PARSE_ERROR;
             return HPE_USER;
         }
+    } else if (self->sink_ &&
+               self->response_.status_code > HttpStatus::SWITCHING_PROTOCOLS) {
+        // Interim (e.g. 103 Early Hints). Report the block before Parse()
+        // discards it and waits for the final response.
+        self->sink_->OnInterimHeaders(self->response_.status_code,
+                                      self->response_.headers);
     }
     return 0;
 }
@@ -251,9 +257,9 @@ size_t UpstreamHttpCodec::Parse(const char* data, size_t len) {
             }
             int status = llhttp_get_status_code(&impl_->parser);
             if (status >= HttpStatus::CONTINUE && status < HttpStatus::OK) {
-                // Interim 1xx response: discard, resume, continue parsing
-                // remaining bytes. The proxy does NOT forward 1xx to the
-                // client — it waits for the final response.
+                // Interim 1xx response: already reported to the sink from
+                // on_headers_complete (the proxy relays 103 only when
+                // configured). Discard, resume, continue parsing.
                 llhttp_resume(&impl_->parser);
                 paused_ = false;
                 response_.Reset();
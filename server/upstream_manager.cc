@@ -50,27 +50,33 @@ static NET_DNS_NAMESPACE::ResolvedMap BuildResolvedFromLiterals(
     NET_DNS_NAMESPACE::ResolvedMap out;
     out.reserve(upstreams.size());
     for (const auto& u : upstreams) {
-        std::string bare;
-        if (!NET_DNS_NAMESPACE::DnsResolver::NormalizeHostToBare(u.host, &bare)) {
-            throw std::invalid_argument(
-                "UpstreamManager legacy ctor: upstream '" + u.name +
-                "' host '" + u.host + "' is malformed (unbalanced "
-                "brackets or invalid grammar).");
-        }
-        InetAddr addr(bare, u.port);
-        if (!addr.is_valid()) {
-            throw std::invalid_argument(
-                "UpstreamManager legacy ctor: upstream '" + u.name +
-                "' host '" + u.host + "' is not a literal IPv4/IPv6 "
-                "address. Use the 3-arg ctor with a resolved map "
-                "(from DnsResolver::ResolveMany) for hostnames.");
+        const auto endpoints = u.EffectiveEndpoints();
+        for (size_t e = 0; e < endpoints.size(); ++e) {
+            const auto& cfg = endpoints[e];
+            std::string bare;
+            if (!NET_DNS_NAMESPACE::DnsResolver::NormalizeHostToBare(cfg.host, &bare)) {
+                throw std::invalid_argument(
+                    "UpstreamManager legacy ctor: upstream '" + u.name +
+                    "' host '" + cfg.host + "' is malformed (unbalanced "
+                    "brackets or invalid grammar).");
+            }
+            InetAddr addr(bare, cfg.port);
+            if (!addr.is_valid()) {
+                throw std::invalid_argument(
+                    "UpstreamManager legacy ctor: upstream '" + u.name +
+                    "' host '" + cfg.host + "' is not a literal IPv4/IPv6 "
+                    "address. Use the 3-arg ctor with a resolved map "
+                    "(from DnsResolver::ResolveMany) for hostnames.");
+            }
+            auto ep = std::make_shared<NET_DNS_NAMESPACE::ResolvedEndpoint>();
+            ep->addr        = addr;
+            ep->addrs       = {addr};
+            ep->host        = bare;
+            ep->port        = cfg.port;
+            ep->resolved_at = std::chrono::steady_clock::now();
+            out.emplace(UpstreamManager::EndpointResolveKey(u.name, e),
+                        std::move(ep));
         }
-        auto ep = std::make_shared<NET_DNS_NAMESPACE::ResolvedEndpoint>();
-        ep->addr        = addr;
-        ep->host        = bare;
-        ep->port        = u.port;
-        ep->resolved_at = std::chrono::steady_clock::now();
-        out.emplace(u.name, std::move(ep));
     }
     return out;
 }
@@ -125,6 +131,13 @@ UpstreamManager::UpstreamManager(
                 }
                 alpn.push_back("http/1.1");
                 tls_ctx->SetAlpnProtocols(alpn);
+                tls_ctx->SetSessionReuse(upstream.tls.session_reuse);
+                if (upstream.tls.ktls && !tls_ctx->EnableKtls()) {
+                    logging::Get()->warn("Upstream '{}': tls.ktls requested but "
+                                         "this OpenSSL build has no kernel TLS "
+                                         "support — using user-space TLS",
+                                         upstream.name);
+                }
 
                 tls_contexts_[upstream.name] = tls_ctx;
                 logging::Get()->info("TLS client context created for upstream '{}'",
@@ -143,15 +156,25 @@ UpstreamManager::UpstreamManager(
         // carried separately via `resolved_endpoint` so the string and
         // the socket address are never coupled by a bridge that
         // rewrites one in terms of the other.
-        auto it = resolved.find(upstream.name);
-        if (it == resolved.end() || !it->second) {
-            throw std::invalid_argument(
-                "UpstreamManager: no resolved endpoint for upstream '" +
-                upstream.name + "'. HttpServer::Start should have "
-                "produced one via the DNS batch.");
+        //
+        // Each configured endpoint has its own entry, keyed by
+        // EndpointResolveKey.
+        const auto endpoint_configs = upstream.EffectiveEndpoints();
+        std::vector<UpstreamHostPool::EndpointSpec> endpoints;
+        endpoints.reserve(endpoint_configs.size());
+        for (size_t e = 0; e < endpoint_configs.size(); ++e) {
+            const std::string key = EndpointResolveKey(upstream.name, e);
+            auto it = resolved.find(key);
+            if (it == resolved.end() || !it->second) {
+                throw std::invalid_argument(
+                    "UpstreamManager: no resolved endpoint for upstream '" +
+                    key + "'. HttpServer::Start should have "
+                    "produced one via the DNS batch.");
+            }
+            endpoints.push_back({endpoint_configs[e].host,
+                                 endpoint_configs[e].port,
+                                 endpoint_configs[e].weight, it->second});
         }
-        std::shared_ptr<const NET_DNS_NAMESPACE::ResolvedEndpoint>
-            resolved_endpoint = it->second;
 
         // Effective SNI selection rule. Three tiers:
         //   1. Explicit `tls.sni_hostname` wins (operator intent).
@@ -190,11 +213,13 @@ UpstreamManager::UpstreamManager(
         pools_[upstream.name] = std::make_unique<UpstreamHostPool>(
             upstream.name, upstream.host, upstream.port,
             effective_sni,
-            resolved_endpoint,
+            std::move(endpoints), upstream.load_balancer,
             upstream.pool, dispatchers, tls_ctx,
             outstanding_conns_, inflight_leases_, donated_h2_leases_,
             off_dispatcher_release_drops_ptr_,
             shutting_down_, drain_mtx_, drain_cv_);
+        pools_[upstream.name]->StartHealthChecks(upstream.health_check);
+        pools_[upstream.name]->StartOutlierDetection(upstream.circuit_breaker);
     }
 
     // Adjust dispatcher timer intervals for upstream timeout enforcement.
@@ -289,6 +314,22 @@ int64_t UpstreamManager::h2_preconnect_skipped_cap_count() const noexcept {
     return total;
 }
 
+int64_t UpstreamManager::tls_handshakes_full() const noexcept {
+    int64_t total = 0;
+    for (const auto& [_, pool] : pools_) {
+        if (pool) total += pool->tls_handshakes_full();
+    }
+    return total;
+}
+
+int64_t UpstreamManager::tls_handshakes_resumed() const noexcept {
+    int64_t total = 0;
+    for (const auto& [_, pool] : pools_) {
+        if (pool) total += pool->tls_handshakes_resumed();
+    }
+    return total;
+}
+
 void UpstreamManager::CheckoutAsync(
     const std::string& service_name,
     size_t dispatcher_index,
@@ -316,7 +357,7 @@ void UpstreamManager::CheckoutAsync(
         return;
     }
 
-    auto* partition = it->second->GetPartition(dispatcher_index);
+    auto* partition = it->second->PickPartition(dispatcher_index, 0);
     if (!partition) {
         error_cb(PoolPartition::CHECKOUT_CONNECT_FAILED);
         return;
@@ -326,10 +367,50 @@ void UpstreamManager::CheckoutAsync(
                                std::move(cancel_token));
 }
 
+void UpstreamManager::CheckoutAsync(
+    PoolPartition* partition,
+    PoolPartition::ReadyCallback ready_cb,
+    PoolPartition::ErrorCallback error_cb,
+    std::shared_ptr<std::atomic<bool>> cancel_token) {
+    // Same shutdown gate as the by-name overload above.
+    if (shutting_down_.load(std::memory_order_acquire)) {
+        error_cb(PoolPartition::CHECKOUT_SHUTTING_DOWN);
+        return;
+    }
+    if (!partition) {
+        error_cb(PoolPartition::CHECKOUT_CONNECT_FAILED);
+        return;
+    }
+    partition->CheckoutAsync(std::move(ready_cb), std::move(error_cb),
+                               std::move(cancel_token));
+}
+
+PoolPartition* UpstreamManager::SelectPartition(
+        const std::string& service_name, size_t dispatcher_index,
+        uint64_t lb_hash) {
+    auto it = pools_.find(service_name);
+    if (it == pools_.end()) return nullptr;
+    return it->second->PickPartition(dispatcher_index, lb_hash);
+}
+
+uint64_t UpstreamManager::LoadBalancerHash(
+        const std::string& service_name, const std::string& client_ip,
+        const std::string& path,
+        const std::map<std::string, std::string>& headers) const {
+    auto it = pools_.find(service_name);
+    if (it == pools_.end()) return 0;
+    return it->second->RequestHash(client_ip, path, headers);
+}
+
+std::string UpstreamManager::EndpointResolveKey(const std::string& upstream_name,
+                                                size_t endpoint_index) {
+    if (endpoint_index == 0) return upstream_name;
+    return upstream_name + "#" + std::to_string(endpoint_index);
+}
+
 void UpstreamManager::EvictExpired(size_t dispatcher_index) {
     for (auto& [name, pool] : pools_) {
-        auto* partition = pool->GetPartition(dispatcher_index);
-        if (partition) {
+        for (auto* partition : pool->PartitionsFor(dispatcher_index)) {
             partition->EvictExpired();
         }
     }
@@ -381,11 +462,8 @@ void UpstreamManager::ForceCloseRemaining() {
     // and dereference freed memory — the same race ScheduleInitiateShutdown
     // was introduced to close.
     for (auto& [name, pool] : pools_) {
-        for (size_t i = 0; i < pool->partition_count(); ++i) {
-            auto* partition = pool->GetPartition(i);
-            if (partition) {
-                partition->ScheduleForceCloseActive();
-            }
+        for (auto* partition : pool->AllPartitions()) {
+            partition->ScheduleForceCloseActive();
         }
     }
 }
@@ -403,6 +481,35 @@ bool UpstreamManager::HasUpstream(const std::string& service_name) const {
     return pools_.find(service_name) != pools_.end();
 }
 
+bool UpstreamManager::HasHealthyEndpoint(
+        const std::string& service_name) const {
+    auto it = pools_.find(service_name);
+    return it == pools_.end() || it->second->HasHealthyEndpoint();
+}
+
+const UpstreamHostPool* UpstreamManager::GetHostPool(
+        const std::string& service_name) const {
+    auto it = pools_.find(service_name);
+    return it == pools_.end() ? nullptr : it->second.get();
+}
+
+void UpstreamManager::RecordEndpointOutcome(
+        const std::string& service_name, size_t dispatcher_index,
+        const PoolPartition* partition, bool failure, int64_t latency_ms) {
+    auto it = pools_.find(service_name);
+    if (it == pools_.end() || it->second->member_count() < 2) return;
+    it->second->RecordOutcome(dispatcher_index, partition, failure, latency_ms);
+}
+
+void UpstreamManager::ReloadOutlierDetection(
+        const std::vector<UpstreamConfig>& upstreams) {
+    for (const auto& u : upstreams) {
+        auto it = pools_.find(u.name);
+        if (it == pools_.end()) continue;
+        it->second->ReloadOutlierDetection(u.circuit_breaker);
+    }
+}
+
 void UpstreamManager::SetObservabilityManager(
     OBSERVABILITY_NAMESPACE::ObservabilityManager* obs_manager) noexcept
 {
@@ -411,9 +518,11 @@ void UpstreamManager::SetObservabilityManager(
     // never modified after, so iterating here is safe from any thread.
     for (auto& [name, pool] : pools_) {
         if (!pool) continue;
-        for (size_t i = 0; i < pool->partition_count(); ++i) {
-            auto* p = pool->GetPartition(i);
-            if (p) p->SetObservabilityManager(obs_manager);
+        for (auto* p : pool->AllPartitions()) {
+            p->SetObservabilityManager(obs_manager);
+        }
+        if (auto* detector = pool->outlier_detector()) {
+            detector->SetObservabilityManager(obs_manager);
         }
     }
 }
@@ -428,14 +537,38 @@ PoolPartition* UpstreamManager::GetPoolPartition(
     return it->second->GetPartition(dispatcher_index);
 }
 
+std::vector<PoolPartition*> UpstreamManager::GetPoolPartitions(
+        const std::string& service_name,
+        size_t dispatcher_index) {
+    auto it = pools_.find(service_name);
+    if (it == pools_.end()) return {};
+    return it->second->PartitionsFor(dispatcher_index);
+}
+
 void UpstreamManager::UpdateResolvedEndpoints(
     const NET_DNS_NAMESPACE::ResolvedMap& merged)
 {
-    for (const auto& [service_name, new_ep] : merged) {
-        auto it = pools_.find(service_name);
-        if (it == pools_.end()) continue;
+    for (const auto& [key, new_ep] : merged) {
         if (!new_ep) continue;
-        it->second->UpdateResolvedEndpoint(new_ep);
+        // "<name>" is endpoint 0, "<name>#<i>" endpoint i (see
+        // EndpointResolveKey). Exact name first: '#' is legal in names.
+        std::string service_name = key;
+        size_t endpoint_index = 0;
+        auto it = pools_.find(service_name);
+        if (it == pools_.end()) {
+            const size_t hash_pos = key.rfind('#');
+            if (hash_pos == std::string::npos) continue;
+            service_name = key.substr(0, hash_pos);
+            const std::string idx = key.substr(hash_pos + 1);
+            if (idx.empty() ||
+                idx.find_first_not_of("0123456789") != std::string::npos) {
+                continue;
+            }
+            endpoint_index = std::stoul(idx);
+            it = pools_.find(service_name);
+            if (it == pools_.end()) continue;
+        }
+        it->second->UpdateResolvedEndpoint(new_ep, endpoint_index);
     }
 }
 
@@ -445,9 +578,8 @@ UpstreamManager::LivePartitions() const
     std::vector<LivePartitionRef> out;
     for (const auto& [name, pool] : pools_) {
         if (!pool) continue;
-        for (size_t i = 0; i < pool->partition_count(); ++i) {
-            PoolPartition* p = pool->GetPartition(i);
-            if (p) out.push_back({name, p});
+        for (PoolPartition* p : pool->AllPartitions()) {
+            out.push_back({name, p});
         }
     }
     return out;
@@ -465,6 +597,10 @@ int UpstreamManager::ComputeMinUpstreamCadenceSec(
         if (u.proxy.response_timeout_ms > 0) {
             m = std::min(m, CadenceSecFromMs(u.proxy.response_timeout_ms));
         }
+        // A client's grpc-timeout can be far below response_timeout_ms.
+        if (u.proxy.grpc.enabled && u.proxy.grpc.propagate_timeout) {
+            m = std::min(m, 1);
+        }
         m = std::min(m, u.http2.MinCadenceSec());
     }
     return m;
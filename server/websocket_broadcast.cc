@@ -0,0 +1,324 @@
+#include "ws/websocket_broadcast.h"
+#include "ws/websocket_connection.h"
+#include "ws/websocket_frame.h"
+#include "dispatcher.h"
+#include "log/logger.h"
+
+namespace {
+
+struct Subscriber {
+    std::weak_ptr<WebSocketConnection> ws;
+    const WebSocketConnection* key;  // identity for Unsubscribe; never dereferenced
+};
+using SubscriberList = std::vector<Subscriber>;
+
+// One queued broadcast for one dispatcher's subscribers of one topic.
+struct Pending {
+    std::shared_ptr<const std::string> wire;   // shared by every dispatcher
+    std::shared_ptr<const SubscriberList> subscribers;
+    WebSocketOpcode opcode;
+    size_t payload_size;
+    WebSocketTopicOptions options;
+    std::string topic;
+};
+
+// Per-dispatcher batch. `scheduled` is true from the moment a drain is
+// queued (or running inline) until it finds the queue empty, so any
+// number of Broadcast() calls in between share one EnQueue.
+struct Outbox {
+    std::mutex mtx;
+    std::vector<Pending> items;
+    bool scheduled = false;
+};
+
+// A topic's subscribers on one dispatcher. `subscribers` is replaced,
+// never mutated, so Broadcast() can hand the current list to a drain
+// without copying it.
+struct Group {
+    std::weak_ptr<Dispatcher> dispatcher;
+    std::shared_ptr<Outbox> outbox;
+    std::shared_ptr<const SubscriberList> subscribers;
+};
+
+struct Topic {
+    WebSocketTopicOptions options;
+    bool custom_options = false;
+    std::unordered_map<Dispatcher*, Group> groups;
+};
+
+// Copy `in` without `drop` and without subscribers whose connection is
+// gone. With `check_open` (owning dispatcher only) closed connections
+// are dropped too; the strong refs taken for that check go to
+// `keep_alive` so a last-reference destructor runs after the caller
+// releases the registry lock, never under it.
+std::shared_ptr<SubscriberList> Filtered(
+        const SubscriberList& in, const WebSocketConnection* drop,
+        bool check_open,
+        std::vector<std::shared_ptr<WebSocketConnection>>* keep_alive) {
+    auto out = std::make_shared<SubscriberList>();
+    out->reserve(in.size());
+    for (const auto& s : in) {
+        if (s.key == drop || s.ws.expired()) continue;
+        if (check_open) {
+            auto ws = s.ws.lock();
+            if (!ws || !ws->IsOpen()) continue;
+            keep_alive->push_back(std::move(ws));
+        }
+        out->push_back(s);
+    }
+    return out;
+}
+
+}  // namespace
+
+struct WebSocketBroadcaster::State {
+    mutable std::shared_mutex mtx;
+    WebSocketTopicOptions defaults;
+    std::unordered_map<std::string, Topic> topics;
+    // One outbox per dispatcher, shared by all topics so a burst across
+    // topics is still one wakeup. Keyed by address; the weak_ptr tells a
+    // reused address (server restarted) from the original.
+    struct OutboxSlot {
+        std::weak_ptr<Dispatcher> dispatcher;
+        std::shared_ptr<Outbox> outbox;
+    };
+    std::unordered_map<Dispatcher*, OutboxSlot> outboxes;
+
+    std::atomic<uint64_t> broadcasts{0};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> disconnected{0};
+
+    // Drop closed / expired subscribers of `topic` on `dispatcher`.
+    void Prune(const std::string& topic, Dispatcher* dispatcher) {
+        std::vector<std::shared_ptr<WebSocketConnection>> keep_alive;
+        std::unique_lock<std::shared_mutex> lck(mtx);
+        auto tit = topics.find(topic);
+        if (tit == topics.end()) return;
+        auto git = tit->second.groups.find(dispatcher);
+        if (git == tit->second.groups.end()) return;
+        git->second.subscribers = Filtered(*git->second.subscribers, nullptr,
+                                           /*check_open=*/true, &keep_alive);
+        EraseIfEmpty(tit, git);
+    }
+
+    void EraseIfEmpty(std::unordered_map<std::string, Topic>::iterator tit,
+                      std::unordered_map<Dispatcher*, Group>::iterator git) {
+        if (!git->second.subscribers->empty()) return;
+        tit->second.groups.erase(git);
+        if (tit->second.groups.empty() && !tit->second.custom_options) {
+            topics.erase(tit);
+        }
+    }
+};
+
+namespace {
+
+void Drain(const std::shared_ptr<WebSocketBroadcaster::State>& state,
+           Dispatcher* dispatcher, const std::shared_ptr<Outbox>& outbox) {
+    std::vector<Pending> items;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lck(outbox->mtx);
+            items.clear();
+            items.swap(outbox->items);
+            if (items.empty()) {
+                outbox->scheduled = false;
+                return;
+            }
+        }
+        // Several frames for the same sockets in this pass: cork so they
+        // leave as one write per connection at loop end.
+        bool coalesce = items.size() > 1;
+        for (const auto& item : items) {
+            bool stale = false;
+            for (const auto& sub : *item.subscribers) {
+                auto ws = sub.ws.lock();
+                if (!ws) {
+                    stale = true;
+                    continue;
+                }
+                using R = WebSocketConnection::SerializedSendResult;
+                switch (ws->SendSerialized(*item.wire, item.opcode,
+                                           item.payload_size, item.options,
+                                           coalesce)) {
+                    case R::SENT:
+                        state->delivered.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    case R::DROPPED:
+                        state->dropped.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    case R::DISCONNECTED:
+                        state->disconnected.fetch_add(1, std::memory_order_relaxed);
+                        stale = true;
+                        break;
+                    case R::CLOSED:
+                        stale = true;
+                        break;
+                }
+            }
+            if (stale) state->Prune(item.topic, dispatcher);
+        }
+    }
+}
+
+}  // namespace
+
+WebSocketBroadcaster::WebSocketBroadcaster(WebSocketTopicOptions defaults)
+    : state_(std::make_shared<State>()) {
+    state_->defaults = defaults;
+}
+
+WebSocketBroadcaster::~WebSocketBroadcaster() = default;
+
+void WebSocketBroadcaster::SetTopicOptions(const std::string& topic,
+                                           const WebSocketTopicOptions& options) {
+    std::unique_lock<std::shared_mutex> lck(state_->mtx);
+    Topic& t = state_->topics[topic];
+    t.options = options;
+    t.custom_options = true;
+}
+
+bool WebSocketBroadcaster::Subscribe(const std::string& topic,
+                                     WebSocketConnection& ws) {
+    std::weak_ptr<WebSocketConnection> weak = ws.weak_from_this();
+    std::shared_ptr<Dispatcher> dispatcher = ws.dispatcher_ptr();
+    if (weak.expired() || !dispatcher || !ws.IsOpen()) return false;
+
+    std::unique_lock<std::shared_mutex> lck(state_->mtx);
+    auto inserted = state_->topics.try_emplace(topic);
+    Topic& t = inserted.first->second;
+    if (inserted.second) t.options = state_->defaults;
+
+    Group& g = t.groups[dispatcher.get()];
+    if (!g.outbox || g.dispatcher.lock() != dispatcher) {
+        auto& slot = state_->outboxes[dispatcher.get()];
+        if (!slot.outbox || slot.dispatcher.lock() != dispatcher) {
+            slot.dispatcher = dispatcher;
+            slot.outbox = std::make_shared<Outbox>();
+        }
+        g.outbox = slot.outbox;
+        g.dispatcher = dispatcher;
+        g.subscribers = std::make_shared<const SubscriberList>();
+    }
+    for (const auto& s : *g.subscribers) {
+        if (s.key == &ws && !s.ws.expired()) return false;
+    }
+    // Copy-on-write; also sheds subscribers destroyed since the last
+    // delivery, so churn without broadcasts can't grow the list.
+    auto next = Filtered(*g.subscribers, nullptr, /*check_open=*/false, nullptr);
+    next->push_back(Subscriber{weak, &ws});
+    g.subscribers = std::move(next);
+    return true;
+}
+
+bool WebSocketBroadcaster::Unsubscribe(const std::string& topic,
+                                       WebSocketConnection& ws) {
+    std::unique_lock<std::shared_mutex> lck(state_->mtx);
+    auto tit = state_->topics.find(topic);
+    if (tit == state_->topics.end()) return false;
+    for (auto git = tit->second.groups.begin(); git != tit->second.groups.end(); ++git) {
+        const auto& list = *git->second.subscribers;
+        bool found = std::any_of(list.begin(), list.end(),
+                                 [&](const Subscriber& s) { return s.key == &ws; });
+        if (!found) continue;
+        git->second.subscribers = Filtered(list, &ws, /*check_open=*/false, nullptr);
+        state_->EraseIfEmpty(tit, git);
+        return true;
+    }
+    return false;
+}
+
+namespace {
+
+size_t Broadcast(const std::shared_ptr<WebSocketBroadcaster::State>& state,
+                 const std::string& topic, const WebSocketFrame& frame) {
+    struct Target {
+        std::shared_ptr<Dispatcher> dispatcher;
+        std::shared_ptr<Outbox> outbox;
+        std::shared_ptr<const SubscriberList> subscribers;
+    };
+    std::vector<Target> targets;
+    std::shared_ptr<const std::string> wire;
+    WebSocketTopicOptions options;
+    size_t recipients = 0;
+    {
+        std::shared_lock<std::shared_mutex> lck(state->mtx);
+        auto tit = state->topics.find(topic);
+        if (tit == state->topics.end()) return 0;
+        options = tit->second.options;
+        targets.reserve(tit->second.groups.size());
+        for (const auto& entry : tit->second.groups) {
+            const Group& g = entry.second;
+            auto dispatcher = g.dispatcher.lock();
+            if (!dispatcher || g.subscribers->empty()) continue;
+            recipients += g.subscribers->size();
+            targets.push_back(Target{std::move(dispatcher), g.outbox, g.subscribers});
+        }
+    }
+    if (recipients == 0) return 0;
+
+    // The one serialization for every recipient on every dispatcher.
+    wire = std::make_shared<const std::string>(frame.Serialize());
+    state->broadcasts.fetch_add(1, std::memory_order_relaxed);
+
+    for (auto& t : targets) {
+        bool run_inline = false;
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lck(t.outbox->mtx);
+            t.outbox->items.push_back(Pending{wire, std::move(t.subscribers),
+                                              frame.opcode, frame.payload.size(),
+                                              options, topic});
+            if (!t.outbox->scheduled) {
+                t.outbox->scheduled = true;
+                // Already on that loop with nothing queued: deliver now
+                // instead of waking ourselves up.
+                if (t.dispatcher->is_on_loop_thread()) {
+                    run_inline = true;
+                } else {
+                    schedule = true;
+                }
+            }
+        }
+        Dispatcher* raw = t.dispatcher.get();
+        if (run_inline) {
+            Drain(state, raw, t.outbox);
+        } else if (schedule) {
+            t.dispatcher->EnQueue([state, raw, outbox = t.outbox]() {
+                Drain(state, raw, outbox);
+            });
+        }
+    }
+    return recipients;
+}
+
+}  // namespace
+
+size_t WebSocketBroadcaster::BroadcastText(const std::string& topic,
+                                           const std::string& message) {
+    return Broadcast(state_, topic, WebSocketFrame::TextFrame(message));
+}
+
+size_t WebSocketBroadcaster::BroadcastBinary(const std::string& topic,
+                                             const std::string& data) {
+    return Broadcast(state_, topic, WebSocketFrame::BinaryFrame(data));
+}
+
+size_t WebSocketBroadcaster::SubscriberCount(const std::string& topic) const {
+    std::shared_lock<std::shared_mutex> lck(state_->mtx);
+    auto tit = state_->topics.find(topic);
+    if (tit == state_->topics.end()) return 0;
+    size_t n = 0;
+    for (const auto& entry : tit->second.groups) n += entry.second.subscribers->size();
+    return n;
+}
+
+WebSocketBroadcaster::Stats WebSocketBroadcaster::GetStats() const {
+    Stats s;
+    s.broadcasts = state_->broadcasts.load(std::memory_order_relaxed);
+    s.delivered = state_->delivered.load(std::memory_order_relaxed);
+    s.dropped = state_->dropped.load(std::memory_order_relaxed);
+    s.disconnected = state_->disconnected.load(std::memory_order_relaxed);
+    return s;
+}
@@ -1,5 +1,6 @@
 #include "ws/websocket_connection.h"
 #include "ws/utf8_validate.h"
+#include "ws/websocket_deflate.h"
 #include "log/logger.h"
 #include "observability/counter.h"
 #include "observability/metrics_catalog.h"
@@ -34,6 +35,59 @@ void WebSocketConnection::OnClose(CloseCallback callback) { callbacks_.close_cal
 void WebSocketConnection::OnPing(PingCallback callback) { callbacks_.ping_callback = std::move(callback); }
 void WebSocketConnection::OnError(ErrorCallback callback) { callbacks_.error_callback = std::move(callback); }
 
+void WebSocketConnection::OnMessageChunk(MessageChunkCallback callback) {
+    callbacks_.chunk_callback = std::move(callback);
+    parser_.SetStreamData(IsStreaming());
+    if (conn_ && IsStreaming()) conn_->SetMaxInputSize(kStreamingReadCap);
+}
+
+void WebSocketConnection::PauseReading() {
+    if (!conn_) return;
+    if (!conn_->IsOnDispatcherThread()) {
+        std::weak_ptr<WebSocketConnection> weak = weak_from_this();
+        conn_->RunOnDispatcher([weak]() {
+            if (auto self = weak.lock()) self->PauseReading();
+        });
+        return;
+    }
+    read_paused_.store(true, std::memory_order_release);
+    if (!read_disable_held_ && is_open_) {
+        read_disable_held_ = true;
+        conn_->IncReadDisable();
+    }
+}
+
+void WebSocketConnection::ResumeReading() {
+    if (!conn_) return;
+    if (!conn_->IsOnDispatcherThread()) {
+        std::weak_ptr<WebSocketConnection> weak = weak_from_this();
+        conn_->RunOnDispatcher([weak]() {
+            if (auto self = weak.lock()) self->ResumeReading();
+        });
+        return;
+    }
+    if (!read_paused_.exchange(false, std::memory_order_acq_rel)) return;
+    // Called from a callback inside DrainParsedFrames: that loop picks
+    // up the held frames itself once the callback returns.
+    if (!draining_) {
+        // Not under HandleUpgradedData's catch here, so mirror it.
+        try {
+            DrainParsedFrames();
+        } catch (const std::exception& e) {
+            logging::Get()->error("Exception in WS handler: {}", e.what());
+            if (IsOpen()) SendClose(1011, "Internal error");
+        }
+    }
+    // Paused again by a callback during the drain — keep the hold.
+    if (!read_paused_.load(std::memory_order_acquire)) ReleaseReadDisable();
+}
+
+void WebSocketConnection::ReleaseReadDisable() {
+    if (!read_disable_held_) return;
+    read_disable_held_ = false;
+    if (conn_) conn_->DecReadDisable();
+}
+
 void WebSocketConnection::SendText(const std::string& message) {
     std::lock_guard<std::recursive_mutex> lck(send_mtx_);
     if (close_sent_ || !is_open_) return;  // No data frames after close
@@ -46,14 +100,45 @@ void WebSocketConnection::SendText(const std::string& message) {
         return;
     }
     MaybeEmitMessageSpan("ws.send", WebSocketOpcode::Text, message.size());
-    SendFrame(WebSocketFrame::TextFrame(message));
+    WebSocketFrame frame = WebSocketFrame::TextFrame(message);
+    MaybeCompress(frame);
+    SendFrame(frame);
 }
 
 void WebSocketConnection::SendBinary(const std::string& data) {
     std::lock_guard<std::recursive_mutex> lck(send_mtx_);
     if (close_sent_ || !is_open_) return;  // No data frames after close
     MaybeEmitMessageSpan("ws.send", WebSocketOpcode::Binary, data.size());
-    SendFrame(WebSocketFrame::BinaryFrame(data));
+    WebSocketFrame frame = WebSocketFrame::BinaryFrame(data);
+    MaybeCompress(frame);
+    SendFrame(frame);
+}
+
+WebSocketConnection::SerializedSendResult WebSocketConnection::SendSerialized(
+        const std::string& wire, WebSocketOpcode opcode, size_t payload_size,
+        const WebSocketTopicOptions& options, bool coalesce) {
+    std::lock_guard<std::recursive_mutex> lck(send_mtx_);
+    if (close_sent_ || !is_open_ || !conn_ || conn_->IsClosing()) {
+        return SerializedSendResult::CLOSED;
+    }
+    if (options.max_pending_bytes > 0 &&
+        conn_->OutputBufferSize() > options.max_pending_bytes) {
+        if (options.slow_consumer_policy == SlowConsumerPolicy::DISCONNECT) {
+            logging::Get()->debug("WS slow consumer fd={} pending={}, closing",
+                                  fd(), conn_->OutputBufferSize());
+            // 1008: the peer isn't keeping up with the topic's rate. The
+            // Close sits behind the backlog; SendClose's deadline bounds
+            // how long we wait for it to drain.
+            SendClose(1008, "slow consumer");
+            return SerializedSendResult::DISCONNECTED;
+        }
+        return SerializedSendResult::DROPPED;
+    }
+    MaybeEmitMessageSpan("ws.send", opcode, payload_size);
+    BumpFrameCounter(opcode, "out");
+    if (coalesce) conn_->CorkUntilLoopEnd();
+    conn_->SendRaw(wire.data(), wire.size());
+    return SerializedSendResult::SENT;
 }
 
 void WebSocketConnection::SendClose(uint16_t code, const std::string& reason) {
@@ -91,10 +176,59 @@ void WebSocketConnection::SendPong(const std::string& payload) {
     SendFrame(WebSocketFrame::PongFrame(payload));
 }
 
+void WebSocketConnection::EnablePerMessageDeflate(
+    std::unique_ptr<WebSocketDeflate> deflate) {
+    deflate_ = std::move(deflate);
+    parser_.SetRsv1Allowed(deflate_ != nullptr);
+}
+
+void WebSocketConnection::MaybeCompress(WebSocketFrame& frame) {
+    if (!deflate_ || frame.payload.size() < deflate_->min_message_size()) {
+        return;
+    }
+    // With context takeover the compressor has now absorbed this message,
+    // so the compressed form must be sent even when it isn't smaller —
+    // the peer's window has to see the same bytes ours did.
+    std::string compressed;
+    if (!deflate_->Compress(frame.payload, compressed)) {
+        logging::Get()->warn("WS deflate failed fd={}, sending uncompressed", fd());
+        return;
+    }
+    // Without takeover each message stands alone, so an incompressible
+    // one can go out as-is.
+    if (deflate_->params().server_no_context_takeover &&
+        compressed.size() >= frame.payload.size()) {
+        return;
+    }
+    frame.payload = std::move(compressed);
+    frame.payload_length = frame.payload.size();
+    frame.rsv1 = true;
+}
+
+bool WebSocketConnection::InflateMessage(const std::string& in, std::string& out) {
+    auto rc = deflate_->Decompress(in, out, max_message_size_);
+    if (rc == WebSocketDeflate::InflateResult::OK) return true;
+    out.clear();
+    if (rc == WebSocketDeflate::InflateResult::TOO_LARGE) {
+        logging::Get()->warn("WS message too big after inflate fd={}", fd());
+        if (callbacks_.error_callback) callbacks_.error_callback(*this, "Message exceeds maximum size");
+        SendClose(1009, "Message too big");
+    } else {
+        logging::Get()->warn("WS invalid compressed message fd={}", fd());
+        if (callbacks_.error_callback) callbacks_.error_callback(*this, "Invalid compressed message");
+        SendClose(1007, "Invalid compressed data");
+    }
+    return false;
+}
+
 int WebSocketConnection::fd() const {
     return conn_->fd();
 }
 
+std::shared_ptr<Dispatcher> WebSocketConnection::dispatcher_ptr() const {
+    return conn_ ? conn_->dispatcher_ptr() : nullptr;
+}
+
 void WebSocketConnection::NotifyTransportClose() {
     if (!is_open_) return;
     is_open_ = false;
@@ -111,13 +245,25 @@ void WebSocketConnection::OnRawData(const std::string& data) {
     if (!is_open_) return;
 
     parser_.Parse(data.data(), data.size());
+    DrainParsedFrames();
+}
 
+void WebSocketConnection::DrainParsedFrames() {
     // Drain any valid frames that were parsed BEFORE the error.
     // The parser may have pushed complete frames before encountering a malformed one.
-    while (parser_.HasFrame() && is_open_) {
+    struct DrainingScope {
+        bool& flag;
+        explicit DrainingScope(bool& f) : flag(f) { flag = true; }
+        ~DrainingScope() { flag = false; }
+    } scope(draining_);
+    while (parser_.HasFrame() && is_open_ &&
+           !read_paused_.load(std::memory_order_acquire)) {
         ProcessFrame(parser_.NextFrame());
     }
 
+    // Held by PauseReading: frames parsed before the error go first.
+    if (parser_.HasFrame() && is_open_) return;
+
     if (parser_.HasError() && is_open_) {
         if (!close_sent_) {
             std::string error_message = parser_.GetError();
@@ -145,8 +291,9 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
     // Count every inbound frame at the entry boundary. This includes
     // frames the WS state machine RECEIVED, including ones rejected by
     // the close-handshake branch below — operators investigating a WS
-    // disconnect storm want the post-Close burst visible.
-    BumpFrameCounter(frame.opcode, "in");
+    // disconnect storm want the post-Close burst visible. Streamed
+    // frames count once, on their first piece.
+    if (frame.payload_offset == 0) BumpFrameCounter(frame.opcode, "in");
     // If we've sent a close frame, only accept Close replies and Ping/Pong control frames.
     // RFC 6455 §5.5.2: endpoint MUST respond to Ping until Close is received.
     // Discard data/continuation frames during the close handshake.
@@ -156,6 +303,12 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
         return;
     }
 
+    if (callbacks_.chunk_callback &&
+        static_cast<uint8_t>(frame.opcode) < 0x8) {
+        ProcessStreamedPiece(frame);
+        return;
+    }
+
     switch (frame.opcode) {
         // Text and Binary share the same processing logic: both are data frames
         // subject to the same fragmentation, reassembly, and delivery rules.
@@ -175,16 +328,22 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
 
             if (frame.fin) {
                 // Complete single-frame message
+                const std::string* payload = &frame.payload;
+                std::string inflated;
+                if (frame.rsv1) {
+                    if (!InflateMessage(frame.payload, inflated)) return;
+                    payload = &inflated;
+                }
                 // RFC 6455 §5.6: text frames must contain valid UTF-8
-                if (frame.opcode == WebSocketOpcode::Text && !IsValidUtf8(frame.payload)) {
+                if (frame.opcode == WebSocketOpcode::Text && !IsValidUtf8(*payload)) {
                     logging::Get()->warn("WS invalid UTF-8 in text frame fd={}", fd());
                     if (callbacks_.error_callback) callbacks_.error_callback(*this, "Invalid UTF-8 in text message");
                     SendClose(1007, "Invalid UTF-8");
                     return;
                 }
-                MaybeEmitMessageSpan("ws.recv", frame.opcode, frame.payload.size());
+                MaybeEmitMessageSpan("ws.recv", frame.opcode, payload->size());
                 if (callbacks_.message_callback) {
-                    callbacks_.message_callback(*this, frame.payload,
+                    callbacks_.message_callback(*this, *payload,
                                      frame.opcode == WebSocketOpcode::Binary);
                 }
             } else {
@@ -199,6 +358,7 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
                 }
                 in_fragment_ = true;
                 fragment_opcode_ = frame.opcode;
+                fragment_compressed_ = frame.rsv1;
                 fragment_buffer_ = frame.payload;
             }
             break;
@@ -221,6 +381,15 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
             }
             fragment_buffer_ += frame.payload;
             if (frame.fin) {
+                if (fragment_compressed_) {
+                    std::string inflated;
+                    if (!InflateMessage(fragment_buffer_, inflated)) {
+                        in_fragment_ = false;
+                        fragment_buffer_.clear();
+                        return;
+                    }
+                    fragment_buffer_ = std::move(inflated);
+                }
                 // RFC 6455 §5.6: validate reassembled text messages
                 if (fragment_opcode_ == WebSocketOpcode::Text && !IsValidUtf8(fragment_buffer_)) {
                     logging::Get()->warn("WS invalid UTF-8 in text frame fd={}", fd());
@@ -354,6 +523,107 @@ void WebSocketConnection::ProcessFrame(const WebSocketFrame& frame) {
     }
 }
 
+void WebSocketConnection::ProcessStreamedPiece(const WebSocketFrame& piece) {
+    if (piece.payload_offset == 0) {
+        if (piece.opcode == WebSocketOpcode::Continuation) {
+            if (!in_fragment_) {
+                if (callbacks_.error_callback) callbacks_.error_callback(*this, "Unexpected continuation frame");
+                SendClose(1002, "Protocol error: unexpected continuation");
+                return;
+            }
+        } else {
+            if (in_fragment_) {
+                logging::Get()->warn("WS protocol error fd={}: interleaved data frames", fd());
+                if (callbacks_.error_callback) {
+                    callbacks_.error_callback(*this, "New data frame received during fragmented message");
+                }
+                SendClose(1002, "Protocol error: interleaved data frames");
+                return;
+            }
+            in_fragment_ = true;
+            fragment_opcode_ = piece.opcode;
+            fragment_compressed_ = piece.rsv1;
+            fragment_buffer_.clear();
+            stream_message_bytes_ = 0;
+            stream_utf8_.Reset();
+            stream_utf8_carry_.clear();
+        }
+    }
+    if (!in_fragment_) return;
+
+    const bool is_final = piece.fin && piece.frame_end;
+    const bool is_binary = fragment_opcode_ == WebSocketOpcode::Binary;
+    stream_message_bytes_ += piece.payload.size();
+    if (max_message_size_ > 0 && stream_message_bytes_ > max_message_size_) {
+        logging::Get()->warn("WS message too big fd={}", fd());
+        if (callbacks_.error_callback) callbacks_.error_callback(*this, "Message exceeds maximum size");
+        SendClose(1009, "Message too big");
+        in_fragment_ = false;
+        fragment_buffer_.clear();
+        return;
+    }
+    if (is_final) in_fragment_ = false;
+
+    // DEFLATE can't be validated or delivered in pieces without a
+    // streaming inflater; buffer the compressed bytes and hand the
+    // inflated message over whole.
+    if (fragment_compressed_) {
+        fragment_buffer_ += piece.payload;
+        if (!is_final) return;
+        std::string inflated;
+        bool ok = InflateMessage(fragment_buffer_, inflated);
+        fragment_buffer_.clear();
+        if (!ok) return;
+        if (!is_binary && !IsValidUtf8(inflated)) {
+            logging::Get()->warn("WS invalid UTF-8 in text frame fd={}", fd());
+            if (callbacks_.error_callback) callbacks_.error_callback(*this, "Invalid UTF-8 in text message");
+            SendClose(1007, "Invalid UTF-8");
+            return;
+        }
+        MaybeEmitMessageSpan("ws.recv", fragment_opcode_, inflated.size());
+        callbacks_.chunk_callback(*this, inflated, is_binary, true);
+        return;
+    }
+
+    if (is_final) {
+        MaybeEmitMessageSpan("ws.recv", fragment_opcode_, stream_message_bytes_);
+    }
+    if (is_binary) {
+        if (!piece.payload.empty() || is_final) {
+            callbacks_.chunk_callback(*this, piece.payload, true, is_final);
+        }
+        return;
+    }
+
+    // RFC 6455 §5.6 / §8.1: fail the connection as soon as the text
+    // can no longer be valid, without waiting for the end of message.
+    if (!stream_utf8_.Feed(piece.payload.data(), piece.payload.size()) ||
+        (is_final && stream_utf8_.pending() != 0)) {
+        logging::Get()->warn("WS invalid UTF-8 in text frame fd={}", fd());
+        if (callbacks_.error_callback) callbacks_.error_callback(*this, "Invalid UTF-8 in text message");
+        SendClose(1007, "Invalid UTF-8");
+        in_fragment_ = false;
+        stream_utf8_carry_.clear();
+        return;
+    }
+    // Hand over whole codepoints only; an incomplete trailing sequence
+    // waits for the next piece.
+    size_t hold = stream_utf8_.pending();
+    if (stream_utf8_carry_.empty() && hold == 0) {
+        if (!piece.payload.empty() || is_final) {
+            callbacks_.chunk_callback(*this, piece.payload, false, is_final);
+        }
+        return;
+    }
+    std::string joined = std::move(stream_utf8_carry_);
+    joined += piece.payload;
+    stream_utf8_carry_ = joined.substr(joined.size() - hold);
+    joined.resize(joined.size() - hold);
+    if (!joined.empty() || is_final) {
+        callbacks_.chunk_callback(*this, joined, false, is_final);
+    }
+}
+
 void WebSocketConnection::SendFrame(const WebSocketFrame& frame) {
     if (!conn_) return;
     BumpFrameCounter(frame.opcode, "out");
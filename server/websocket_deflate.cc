@@ -0,0 +1,252 @@
+#include "ws/websocket_deflate.h"
+
+#include <zlib.h>
+
+namespace {
+
+constexpr char kFlushTail[4] = {'\x00', '\x00', '\xff', '\xff'};
+constexpr size_t kOutChunk = 16384;
+
+// zlib rejects windowBits 8 for raw deflate; a 9-bit window is a
+// superset and decodes an 8-bit peer stream fine.
+int RawBits(int bits) {
+    return -std::max(9, std::min(15, bits));
+}
+
+// Thread-local context for directions without context takeover. Every
+// message starts from a reset stream, so one context per thread serves
+// every connection whose parameters match; a mismatch re-initializes.
+struct SharedDeflater {
+    z_stream z{};
+    bool ready = false;
+    int level = 0, bits = 0, mem = 0;
+
+    z_stream* Get(int want_level, int want_bits, int want_mem) {
+        if (ready && level == want_level && bits == want_bits && mem == want_mem) {
+            return &z;
+        }
+        if (ready) {
+            deflateEnd(&z);
+            ready = false;
+        }
+        z = z_stream{};
+        if (deflateInit2(&z, want_level, Z_DEFLATED, RawBits(want_bits),
+                         want_mem, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return nullptr;
+        }
+        ready = true;
+        level = want_level;
+        bits = want_bits;
+        mem = want_mem;
+        return &z;
+    }
+    ~SharedDeflater() { if (ready) deflateEnd(&z); }
+};
+
+struct SharedInflater {
+    z_stream z{};
+    bool ready = false;
+    int bits = 0;
+
+    z_stream* Get(int want_bits) {
+        if (ready && bits == want_bits) return &z;
+        if (ready) {
+            inflateEnd(&z);
+            ready = false;
+        }
+        z = z_stream{};
+        if (inflateInit2(&z, RawBits(want_bits)) != Z_OK) return nullptr;
+        ready = true;
+        bits = want_bits;
+        return &z;
+    }
+    ~SharedInflater() { if (ready) inflateEnd(&z); }
+};
+
+thread_local SharedDeflater tls_deflater;
+thread_local SharedInflater tls_inflater;
+
+// Feed `len` bytes through `z`, appending output to `out`.
+WebSocketDeflate::InflateResult InflateChunk(z_stream* z, const char* data,
+                                             size_t len, std::string& out,
+                                             size_t max_size) {
+    using R = WebSocketDeflate::InflateResult;
+    z->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    z->avail_in = static_cast<uInt>(len);
+    while (true) {
+        size_t old = out.size();
+        out.resize(old + kOutChunk);
+        z->next_out = reinterpret_cast<Bytef*>(&out[old]);
+        z->avail_out = static_cast<uInt>(kOutChunk);
+        int rc = inflate(z, Z_SYNC_FLUSH);
+        out.resize(old + kOutChunk - z->avail_out);
+        if (max_size > 0 && out.size() > max_size) return R::TOO_LARGE;
+        if (rc == Z_STREAM_END) {
+            // Peer set BFINAL; the next message starts a fresh stream.
+            inflateReset(z);
+            if (z->avail_in == 0) return R::OK;
+            continue;
+        }
+        if (rc == Z_BUF_ERROR) {
+            // No progress possible: input exhausted with room to spare.
+            if (z->avail_out > 0) return R::OK;
+            continue;
+        }
+        if (rc != Z_OK) return R::CORRUPT;
+        if (z->avail_in == 0 && z->avail_out > 0) return R::OK;
+    }
+}
+
+}  // namespace
+
+std::string WebSocketDeflateParams::ToHeaderValue() const {
+    std::string value = "permessage-deflate";
+    if (server_no_context_takeover) value += "; server_no_context_takeover";
+    if (client_no_context_takeover) value += "; client_no_context_takeover";
+    if (server_max_window_bits < 15) {
+        value += "; server_max_window_bits=" + std::to_string(server_max_window_bits);
+    }
+    if (client_max_window_bits < 15) {
+        value += "; client_max_window_bits=" + std::to_string(client_max_window_bits);
+    }
+    return value;
+}
+
+bool WebSocketDeflateBudget::TryReserve(size_t bytes) {
+    size_t used = used_bytes_.load(std::memory_order_relaxed);
+    while (true) {
+        if (cap_bytes_ > 0 && used + bytes > cap_bytes_) return false;
+        if (used_bytes_.compare_exchange_weak(used, used + bytes,
+                                              std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void WebSocketDeflateBudget::Release(size_t bytes) {
+    used_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t WebSocketDeflate::EstimateDeflateBytes(int window_bits, int mem_level) {
+    int bits = std::max(9, window_bits);
+    return (size_t{1} << (bits + 2)) + (size_t{1} << (mem_level + 9)) +
+           sizeof(z_stream) + 6 * 1024;
+}
+
+size_t WebSocketDeflate::EstimateInflateBytes(int window_bits) {
+    int bits = std::max(9, window_bits);
+    return (size_t{1} << bits) + sizeof(z_stream) + 7 * 1024;
+}
+
+std::unique_ptr<WebSocketDeflate> WebSocketDeflate::Create(
+        const WebSocketDeflateParams& params,
+        const WebSocketDeflateConfig& config,
+        std::shared_ptr<WebSocketDeflateBudget> budget) {
+    std::unique_ptr<WebSocketDeflate> codec(new WebSocketDeflate());
+    codec->params_ = params;
+    codec->compression_level_ = config.compression_level;
+    codec->mem_level_ = config.mem_level;
+    codec->min_message_size_ = config.min_message_size;
+
+    size_t charge = 0;
+    if (!params.server_no_context_takeover) {
+        charge += EstimateDeflateBytes(params.server_max_window_bits, config.mem_level);
+    }
+    if (!params.client_no_context_takeover) {
+        charge += EstimateInflateBytes(params.client_max_window_bits);
+    }
+    if (charge > 0 && budget) {
+        if (!budget->TryReserve(charge)) return nullptr;
+        codec->budget_ = std::move(budget);
+        codec->reserved_bytes_ = charge;
+    }
+
+    // From here the destructor releases the reservation and ends any
+    // stream that initialized.
+    if (!params.server_no_context_takeover) {
+        auto* z = new z_stream{};
+        if (deflateInit2(z, config.compression_level, Z_DEFLATED,
+                         RawBits(params.server_max_window_bits),
+                         config.mem_level, Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete z;
+            return nullptr;
+        }
+        codec->deflate_stream_ = z;
+    }
+    if (!params.client_no_context_takeover) {
+        auto* z = new z_stream{};
+        if (inflateInit2(z, RawBits(params.client_max_window_bits)) != Z_OK) {
+            delete z;
+            return nullptr;
+        }
+        codec->inflate_stream_ = z;
+    }
+    return codec;
+}
+
+WebSocketDeflate::~WebSocketDeflate() {
+    if (deflate_stream_) {
+        deflateEnd(deflate_stream_);
+        delete deflate_stream_;
+    }
+    if (inflate_stream_) {
+        inflateEnd(inflate_stream_);
+        delete inflate_stream_;
+    }
+    if (budget_ && reserved_bytes_ > 0) {
+        budget_->Release(reserved_bytes_);
+    }
+}
+
+bool WebSocketDeflate::Compress(const std::string& in, std::string& out) {
+    z_stream* z = deflate_stream_
+        ? deflate_stream_
+        : tls_deflater.Get(compression_level_, params_.server_max_window_bits,
+                           mem_level_);
+    if (!z) return false;
+
+    out.clear();
+    z->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    z->avail_in = static_cast<uInt>(in.size());
+    bool ok = true;
+    do {
+        size_t old = out.size();
+        out.resize(old + kOutChunk);
+        z->next_out = reinterpret_cast<Bytef*>(&out[old]);
+        z->avail_out = static_cast<uInt>(kOutChunk);
+        int rc = deflate(z, Z_SYNC_FLUSH);
+        out.resize(old + kOutChunk - z->avail_out);
+        if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            ok = false;
+            break;
+        }
+    } while (z->avail_out == 0);
+
+    if (ok && out.size() >= 4 &&
+        std::memcmp(out.data() + out.size() - 4, kFlushTail, 4) == 0) {
+        out.resize(out.size() - 4);
+    }
+    if (!ok || params_.server_no_context_takeover) {
+        deflateReset(z);
+    }
+    return ok;
+}
+
+WebSocketDeflate::InflateResult WebSocketDeflate::Decompress(
+        const std::string& in, std::string& out, size_t max_size) {
+    z_stream* z = inflate_stream_
+        ? inflate_stream_
+        : tls_inflater.Get(params_.client_max_window_bits);
+    if (!z) return InflateResult::CORRUPT;
+
+    out.clear();
+    InflateResult rc = InflateChunk(z, in.data(), in.size(), out, max_size);
+    if (rc == InflateResult::OK) {
+        // Re-append the tail the sender stripped (RFC 7692 §7.2.2).
+        rc = InflateChunk(z, kFlushTail, sizeof(kFlushTail), out, max_size);
+    }
+    if (rc != InflateResult::OK || params_.client_no_context_takeover) {
+        inflateReset(z);
+    }
+    return rc;
+}
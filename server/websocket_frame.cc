@@ -7,6 +7,7 @@ std::string WebSocketFrame::Serialize() const {
     // Byte 1: FIN + opcode
     uint8_t byte1 = static_cast<uint8_t>(opcode);
     if (fin) byte1 |= 0x80;
+    if (rsv1) byte1 |= 0x40;
     result += static_cast<char>(byte1);
 
     // Byte 2: MASK + payload length
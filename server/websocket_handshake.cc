@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstring>
 #include <sstream>
+#include <vector>
 
 static const char* WS_MAGIC = "258EAFA5-E914-47DA-95CA-5AB611DC65B6";
 
@@ -145,6 +146,131 @@ HttpResponse WebSocketHandshake::Accept(const HttpRequest& request) {
     return response;
 }
 
+namespace {
+
+void TrimOws(std::string& s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.erase(s.begin());
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.pop_back();
+}
+
+// Split on `sep`, honoring quoted-strings so a ',' or ';' inside quotes
+// doesn't break a token (RFC 6455 §9.1 extension grammar).
+std::vector<std::string> SplitOutsideQuotes(const std::string& s, char sep) {
+    std::vector<std::string> parts;
+    std::string cur;
+    bool quoted = false;
+    for (char c : s) {
+        if (c == '"') quoted = !quoted;
+        if (c == sep && !quoted) {
+            parts.push_back(cur);
+            cur.clear();
+            continue;
+        }
+        cur += c;
+    }
+    parts.push_back(cur);
+    return parts;
+}
+
+// Window-bits value: 1*DIGIT in [8, 15], optionally quoted.
+int ParseWindowBits(std::string value) {
+    if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+        value = value.substr(1, value.size() - 2);
+    }
+    if (value.empty() || value.size() > 2) return -1;
+    int bits = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') return -1;
+        bits = bits * 10 + (c - '0');
+    }
+    return (bits >= 8 && bits <= 15) ? bits : -1;
+}
+
+// One permessage-deflate offer → params, or false if it has to be
+// declined (unknown / duplicate / malformed parameter).
+bool AcceptOffer(const std::vector<std::string>& params,
+                 const WebSocketDeflateConfig& config,
+                 WebSocketDeflateParams& out) {
+    WebSocketDeflateParams p;
+    p.server_no_context_takeover = config.server_no_context_takeover;
+    p.client_no_context_takeover = config.client_no_context_takeover;
+    p.server_max_window_bits = config.server_max_window_bits;
+    // Without client_max_window_bits in the offer the client may use a
+    // full 15-bit window and we must not ask for less (§7.1.2.2).
+    p.client_max_window_bits = 15;
+
+    bool seen_snct = false, seen_cnct = false, seen_smwb = false, seen_cmwb = false;
+    for (size_t i = 1; i < params.size(); ++i) {
+        std::string name = params[i];
+        std::string value;
+        bool has_value = false;
+        size_t eq = name.find('=');
+        if (eq != std::string::npos) {
+            value = name.substr(eq + 1);
+            name = name.substr(0, eq);
+            has_value = true;
+            TrimOws(value);
+        }
+        TrimOws(name);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c){ return std::tolower(c); });
+
+        if (name == "server_no_context_takeover") {
+            if (seen_snct || has_value) return false;
+            seen_snct = true;
+            p.server_no_context_takeover = true;
+        } else if (name == "client_no_context_takeover") {
+            if (seen_cnct || has_value) return false;
+            seen_cnct = true;
+            // A hint: the client resets anyway, so our decompressor can
+            // too. Echoing it back is always permitted.
+            p.client_no_context_takeover = true;
+        } else if (name == "server_max_window_bits") {
+            if (seen_smwb || !has_value) return false;
+            seen_smwb = true;
+            int bits = ParseWindowBits(value);
+            // zlib cannot produce a raw stream with an 8-bit window.
+            if (bits < 9) return false;
+            p.server_max_window_bits = std::min(p.server_max_window_bits, bits);
+        } else if (name == "client_max_window_bits") {
+            if (seen_cmwb) return false;
+            seen_cmwb = true;
+            int offered = 15;
+            if (has_value) {
+                offered = ParseWindowBits(value);
+                if (offered < 0) return false;
+            }
+            p.client_max_window_bits =
+                std::min(config.client_max_window_bits, offered);
+        } else {
+            return false;
+        }
+    }
+    out = p;
+    return true;
+}
+
+}  // namespace
+
+bool WebSocketHandshake::NegotiateDeflate(const HttpRequest& request,
+                                          const WebSocketDeflateConfig& config,
+                                          WebSocketDeflateParams& out) {
+    if (!config.enabled) return false;
+    std::string header = request.GetHeader("sec-websocket-extensions");
+    if (header.empty()) return false;
+
+    for (const auto& extension : SplitOutsideQuotes(header, ',')) {
+        auto params = SplitOutsideQuotes(extension, ';');
+        std::string name = params[0];
+        TrimOws(name);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c){ return std::tolower(c); });
+        if (name != "permessage-deflate") continue;
+        if (AcceptOffer(params, config, out)) return true;
+    }
+    return false;
+}
+
 HttpResponse WebSocketHandshake::Reject(int status_code, const std::string& reason) {
     return HttpResponse().Status(status_code).Text(reason);
 }
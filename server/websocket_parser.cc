@@ -1,4 +1,5 @@
 #include "ws/websocket_parser.h"
+#include "ws/websocket_simd.h"
 #include <algorithm>
 
 WebSocketParser::WebSocketParser() {}
@@ -19,6 +20,7 @@ size_t WebSocketParser::Parse(const char* data, size_t len) {
 
                 current_ = WebSocketFrame{};
                 current_.fin = (byte1 & 0x80) != 0;
+                current_.rsv1 = (byte1 & 0x40) != 0;
                 current_.opcode = static_cast<WebSocketOpcode>(byte1 & 0x0F);
                 current_.masked = (byte2 & 0x80) != 0;
 
@@ -27,7 +29,7 @@ size_t WebSocketParser::Parse(const char* data, size_t len) {
 
 
                 // RFC 6455 §5.2: RSV bits must be 0 unless extension negotiated
-                if ((byte1 & 0x70) != 0) {
+                if ((byte1 & (rsv1_allowed_ ? 0x30 : 0x70)) != 0) {
                     has_error_ = true;
                     error_message_ = "RSV bits set without extension negotiation";
                     goto done;
@@ -49,6 +51,15 @@ size_t WebSocketParser::Parse(const char* data, size_t len) {
                     goto done;
                 }
 
+                // RFC 7692 §6.1: RSV1 marks a compressed message and only
+                // appears on its first frame — never on control frames or
+                // continuations.
+                if (current_.rsv1 && (op >= 0x8 || op == 0x0)) {
+                    has_error_ = true;
+                    error_message_ = "RSV1 set on control or continuation frame";
+                    goto done;
+                }
+
                 // Validate: control frames must not be fragmented and <= 125 bytes
                 if (op >= 0x8) {
                     if (!current_.fin) {
@@ -152,6 +163,18 @@ size_t WebSocketParser::Parse(const char* data, size_t len) {
                 size_t available = std::min(remaining, buf_remaining());
                 if (available == 0) goto done;
 
+                if (stream_data_ &&
+                    static_cast<uint8_t>(current_.opcode) < 0x8) {
+                    EmitPiece(buffer_.data() + offset, available);
+                    offset += available;
+                    payload_read_ += available;
+                    if (payload_read_ == current_.payload_length) {
+                        state_ = State::ReadHeader;
+                        payload_read_ = 0;
+                    }
+                    break;
+                }
+
                 current_.payload.append(buffer_.data() + offset, available);
                 offset += available;
                 payload_read_ += available;
@@ -196,8 +219,31 @@ WebSocketFrame WebSocketParser::NextFrame() {
     return frame;
 }
 
-void WebSocketParser::Unmask(std::string& data, const uint8_t key[4], size_t offset) {
-    for (size_t i = offset; i < data.size(); i++) {
-        data[i] ^= key[(i - offset) % 4];
+void WebSocketParser::EmitPiece(const char* data, size_t available) {
+    WebSocketFrame piece;
+    piece.fin = current_.fin;
+    piece.rsv1 = current_.rsv1;
+    piece.opcode = current_.opcode;
+    piece.masked = current_.masked;
+    piece.payload_length = current_.payload_length;
+    piece.payload_offset = payload_read_;
+    piece.frame_end = payload_read_ + available == current_.payload_length;
+    piece.payload.assign(data, available);
+    if (current_.masked) {
+        // Rotate the key so byte 0 of this piece lines up with its
+        // position in the frame.
+        uint8_t key[4];
+        for (size_t i = 0; i < 4; ++i) {
+            key[i] = current_.masking_key[(payload_read_ + i) % 4];
+        }
+        Unmask(piece.payload, key);
     }
+    completed_.push_back(std::move(piece));
+}
+
+void WebSocketParser::Unmask(std::string& data, const uint8_t key[4], size_t offset) {
+    if (offset >= data.size()) return;
+    websocket_simd::Unmask(websocket_simd::DetectedLevel(),
+                           reinterpret_cast<uint8_t*>(&data[offset]),
+                           data.size() - offset, key);
 }
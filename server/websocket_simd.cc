@@ -0,0 +1,352 @@
+#include "ws/websocket_simd.h"
+#include "ws/utf8_validate.h"
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define WS_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace websocket_simd {
+
+namespace {
+
+Level Clamp(Level level) {
+    Level max = DetectedLevel();
+    return static_cast<int>(level) > static_cast<int>(max) ? max : level;
+}
+
+// ---------------------------------------------------------------------
+// Unmask
+// ---------------------------------------------------------------------
+
+// Every path works in multiples of 4 bytes, so the key phase at the
+// handoff to a narrower loop is always key[0].
+size_t UnmaskWords(uint8_t* data, size_t len, const uint8_t key[4]) {
+    uint32_t k32;
+    std::memcpy(&k32, key, 4);
+    uint64_t k64 = (static_cast<uint64_t>(k32) << 32) | k32;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        w ^= k64;
+        std::memcpy(data + i, &w, 8);
+    }
+    return i;
+}
+
+#ifdef WS_SIMD_X86
+size_t UnmaskSse2(uint8_t* data, size_t len, const uint8_t key[4]) {
+    int32_t k32;
+    std::memcpy(&k32, key, 4);
+    const __m128i k = _mm_set1_epi32(k32);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), k));
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+size_t UnmaskAvx2(uint8_t* data, size_t len, const uint8_t key[4]) {
+    int32_t k32;
+    std::memcpy(&k32, key, 4);
+    const __m256i k = _mm256_set1_epi32(k32);
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i* p0 = reinterpret_cast<__m256i*>(data + i);
+        __m256i* p1 = reinterpret_cast<__m256i*>(data + i + 32);
+        __m256i a = _mm256_loadu_si256(p0);
+        __m256i b = _mm256_loadu_si256(p1);
+        _mm256_storeu_si256(p0, _mm256_xor_si256(a, k));
+        _mm256_storeu_si256(p1, _mm256_xor_si256(b, k));
+    }
+    for (; i + 32 <= len; i += 32) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i);
+        _mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), k));
+    }
+    return i;
+}
+#endif
+
+// ---------------------------------------------------------------------
+// UTF-8
+// ---------------------------------------------------------------------
+
+// Skip ASCII a word at a time; on a block with a high bit, decode
+// codepoints until past that block. DecodeOne keeps `i` on a codepoint
+// boundary, so resuming the block scan from there is safe.
+bool ValidateUtf8Words(const uint8_t* s, size_t n) {
+    size_t i = 0;
+    while (i + 8 <= n) {
+        uint64_t w;
+        std::memcpy(&w, s + i, 8);
+        if ((w & 0x8080808080808080ULL) == 0) {
+            i += 8;
+            continue;
+        }
+        size_t end = i + 8;
+        while (i < end) {
+            if (!utf8_detail::DecodeOne(s, n, i)) return false;
+        }
+    }
+    while (i < n) {
+        if (!utf8_detail::DecodeOne(s, n, i)) return false;
+    }
+    return true;
+}
+
+#ifdef WS_SIMD_X86
+bool ValidateUtf8Sse2(const uint8_t* s, size_t n) {
+    size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) == 0) {
+            i += 16;
+            continue;
+        }
+        size_t end = i + 16;
+        while (i < end) {
+            if (!utf8_detail::DecodeOne(s, n, i)) return false;
+        }
+    }
+    while (i < n) {
+        if (!utf8_detail::DecodeOne(s, n, i)) return false;
+    }
+    return true;
+}
+
+// Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per
+// Byte" (2021): three 16-entry nibble lookups classify every
+// (previous byte, current byte) pair into error bits, and a separate
+// check requires continuation bytes exactly where a 3/4-byte lead two
+// or three positions back demands them. Errors accumulate in a vector
+// and are tested once at the end.
+namespace kl {
+
+constexpr uint8_t TOO_SHORT = 1 << 0;   // lead followed by lead/ASCII
+constexpr uint8_t TOO_LONG = 1 << 1;    // ASCII followed by continuation
+constexpr uint8_t OVERLONG_3 = 1 << 2;  // E0 80..9F
+constexpr uint8_t TOO_LARGE = 1 << 3;   // F4 90..BF, F5..FF
+constexpr uint8_t SURROGATE = 1 << 4;   // ED A0..BF
+constexpr uint8_t OVERLONG_2 = 1 << 5;  // C0..C1
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;
+constexpr uint8_t OVERLONG_4 = 1 << 6;  // F0 80..8F
+constexpr uint8_t TWO_CONTS = 1 << 7;   // continuation after continuation
+constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+__attribute__((target("avx2")))
+inline __m256i Lookup16(__m256i idx, __m256i table) {
+    return _mm256_shuffle_epi8(table, idx);
+}
+
+__attribute__((target("avx2")))
+inline __m256i HighNibble(__m256i v) {
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// `prev` shifted in by N bytes: lane i of the result is input[i - N].
+template <int N>
+__attribute__((target("avx2")))
+inline __m256i Prev(__m256i input, __m256i prev_input) {
+    return _mm256_alignr_epi8(
+        input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+}
+
+#define KL_TABLE(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+
+__attribute__((target("avx2")))
+inline __m256i CheckSpecialCases(__m256i input, __m256i prev1) {
+    const __m256i byte_1_high = Lookup16(HighNibble(prev1), KL_TABLE(
+        // 0_______ ________ <ASCII in byte 1>
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        // 10______ ________ <continuation in byte 1>
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        // 1100____ ________ <two byte lead in byte 1>
+        TOO_SHORT | OVERLONG_2,
+        // 1101____ ________ <two byte lead in byte 1>
+        TOO_SHORT,
+        // 1110____ ________ <three byte lead in byte 1>
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        // 1111____ ________ <four+ byte lead in byte 1>
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4));
+
+    const __m256i byte_1_low = Lookup16(
+        _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)), KL_TABLE(
+        // ____0000 ________
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        // ____0001 ________
+        CARRY | OVERLONG_2,
+        // ____001_ ________
+        CARRY,
+        CARRY,
+        // ____0100 ________
+        CARRY | TOO_LARGE,
+        // ____0101 ________
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        // ____011_ ________
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        // ____1___ ________
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        // ____1101 ________
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000));
+
+    const __m256i byte_2_high = Lookup16(HighNibble(input), KL_TABLE(
+        // ________ 0_______ <ASCII in byte 2>
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        // ________ 1000____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        // ________ 1001____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        // ________ 101_____
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        // ________ 11______
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT));
+
+    return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+}
+
+#undef KL_TABLE
+
+// The lookups flag a continuation with TWO_CONTS whenever the byte
+// before it is also a continuation. That is legal exactly when a 3-byte
+// lead sits two back or a 4-byte lead three back; XOR-ing those
+// positions' 0x80 clears the expected TWO_CONTS and raises an error
+// where a required continuation is missing.
+__attribute__((target("avx2")))
+inline __m256i CheckMultibyteLengths(__m256i input, __m256i prev_input,
+                                     __m256i special_cases) {
+    __m256i prev2 = Prev<2>(input, prev_input);
+    __m256i prev3 = Prev<3>(input, prev_input);
+    __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0u - 0x80));
+    __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0u - 0x80));
+    __m256i must23_80 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth),
+                                         _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must23_80, special_cases);
+}
+
+// Nonzero when the block ends inside a multi-byte sequence, i.e. one of
+// the last three bytes is a lead needing more bytes than remain.
+__attribute__((target("avx2")))
+inline __m256i IsIncomplete(__m256i input) {
+    const __m256i max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+        static_cast<char>(0xC0 - 1));
+    return _mm256_subs_epu8(input, max);
+}
+
+}  // namespace kl
+
+struct Avx2State {
+    __m256i error;
+    __m256i prev_input;
+    __m256i prev_incomplete;
+};
+
+__attribute__((target("avx2")))
+inline void Avx2Step(Avx2State& st, __m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        // ASCII block: only an unfinished sequence from the previous
+        // block can be wrong.
+        st.error = _mm256_or_si256(st.error, st.prev_incomplete);
+    } else {
+        __m256i prev1 = kl::Prev<1>(input, st.prev_input);
+        __m256i sc = kl::CheckSpecialCases(input, prev1);
+        st.error = _mm256_or_si256(
+            st.error, kl::CheckMultibyteLengths(input, st.prev_input, sc));
+        st.prev_incomplete = kl::IsIncomplete(input);
+    }
+    st.prev_input = input;
+}
+
+__attribute__((target("avx2")))
+bool ValidateUtf8Avx2(const uint8_t* s, size_t n) {
+    Avx2State st;
+    st.error = _mm256_setzero_si256();
+    st.prev_input = _mm256_setzero_si256();
+    st.prev_incomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        Avx2Step(st, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+    }
+    if (i < n) {
+        // Zero padding reads as ASCII, so a sequence cut off by the end
+        // of input is caught by prev_incomplete below.
+        alignas(32) uint8_t tail[32] = {};
+        std::memcpy(tail, s + i, n - i);
+        Avx2Step(st, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    }
+    __m256i error = _mm256_or_si256(st.error, st.prev_incomplete);
+    return _mm256_testz_si256(error, error) != 0;
+}
+#endif  // WS_SIMD_X86
+
+}  // namespace
+
+Level DetectedLevel() {
+#ifdef WS_SIMD_X86
+    static const Level level =
+        __builtin_cpu_supports("avx2") ? Level::AVX2 : Level::SSE2;
+    return level;
+#else
+    return Level::PORTABLE;
+#endif
+}
+
+const char* LevelName(Level level) {
+    switch (level) {
+        case Level::PORTABLE: return "portable";
+        case Level::SSE2:     return "sse2";
+        case Level::AVX2:     return "avx2";
+    }
+    return "unknown";
+}
+
+void Unmask(Level level, uint8_t* data, size_t len, const uint8_t key[4]) {
+    size_t i = 0;
+    switch (Clamp(level)) {
+#ifdef WS_SIMD_X86
+        case Level::AVX2: i = UnmaskAvx2(data, len, key); break;
+        case Level::SSE2: i = UnmaskSse2(data, len, key); break;
+#endif
+        default: break;
+    }
+    i += UnmaskWords(data + i, len - i, key);
+    for (; i < len; i++) {
+        data[i] ^= key[i & 3];
+    }
+}
+
+bool ValidateUtf8(Level level, const char* data, size_t len) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(data);
+    switch (Clamp(level)) {
+#ifdef WS_SIMD_X86
+        case Level::AVX2: return ValidateUtf8Avx2(s, len);
+        case Level::SSE2: return ValidateUtf8Sse2(s, len);
+#endif
+        default: return ValidateUtf8Words(s, len);
+    }
+}
+
+}  // namespace websocket_simd
+
+bool IsValidUtf8(const char* data, size_t len) {
+    return websocket_simd::ValidateUtf8(websocket_simd::DetectedLevel(), data, len);
+}
@@ -0,0 +1,566 @@
+#include "upstream/ws_tunnel.h"
+#include "upstream/upstream_manager.h"
+#include "upstream/upstream_connection.h"
+#include "upstream/pool_partition.h"
+#include "upstream/header_rewriter.h"
+#include "http/http_connection_handler.h"
+#include "http/http_response.h"
+#include "http/http_status.h"
+#include "connection_handler.h"
+#include "log/logger.h"
+#include "observability/observability_manager.h"
+#include "observability/metrics_catalog.h"
+#include "observability/counter.h"
+
+namespace {
+
+std::string ToLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+void TrimOws(std::string& s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.erase(s.begin());
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.pop_back();
+}
+
+}  // namespace
+
+WsTunnel::WsTunnel(std::weak_ptr<HttpConnectionHandler> client, Params params)
+    : client_(std::move(client)), params_(std::move(params)) {
+    if (auto c = client_.lock()) {
+        client_conn_ = c->GetConnection();
+        if (auto cc = client_conn_.lock()) client_fd_ = cc->fd();
+    }
+}
+
+WsTunnel::~WsTunnel() {
+    // Every path to destruction runs Close/Fail first; this only guards
+    // a tunnel dropped before Start().
+    if (lease_) ReleaseUpstream();
+}
+
+void WsTunnel::Start() {
+    if (state_ != State::IDLE) return;
+    if (!params_.upstream_manager || params_.dispatcher_index < 0) {
+        Fail(HttpResponse::BadGateway(), "upstream_unavailable",
+             "no upstream manager");
+        return;
+    }
+    state_ = State::CHECKOUT;
+    cancel_token_ = std::make_shared<std::atomic<bool>>(false);
+    logging::Get()->debug("WsTunnel checkout client_fd={} service={}",
+                          client_fd_, params_.service_name);
+
+    // Callbacks may fire synchronously (idle connection available, or an
+    // immediate pool rejection).
+    auto self = shared_from_this();
+    params_.upstream_manager->CheckoutAsync(
+        params_.service_name,
+        static_cast<size_t>(params_.dispatcher_index),
+        [self](UpstreamLease lease) { self->OnCheckoutReady(std::move(lease)); },
+        [self](int error_code) { self->OnCheckoutError(error_code); },
+        cancel_token_);
+}
+
+void WsTunnel::Cancel() {
+    if (state_ == State::CLOSED) return;
+    if (cancel_token_) cancel_token_->store(true, std::memory_order_release);
+    logging::Get()->debug("WsTunnel cancelled client_fd={} service={}",
+                          client_fd_, params_.service_name);
+    Close("client_disconnect");
+}
+
+void WsTunnel::OnCheckoutReady(UpstreamLease lease) {
+    if (state_ != State::CHECKOUT) {
+        lease.Release();
+        return;
+    }
+    lease_ = std::move(lease);
+    auto transport = UpstreamTransport();
+    if (!transport) {
+        // Includes the empty lease handed out when an H2 session frees
+        // up: a tunnel needs a dedicated HTTP/1.1 connection.
+        Fail(HttpResponse::BadGateway(), "upstream_connect_failure",
+             "no HTTP/1.1 upstream transport");
+        return;
+    }
+    upstream_fd_ = transport->fd();
+
+    if (transport->HasTls() && !transport->IsTlsReady()) {
+        // Same transient hooks as ProxyTransaction: the pool reports a
+        // disconnect as an empty OnMessage.
+        std::weak_ptr<WsTunnel> weak_self = weak_from_this();
+        transport->SetOnMessageCb(
+            [weak_self](std::shared_ptr<ConnectionHandler>, std::string& data) {
+                if (!data.empty()) return;
+                if (auto self = weak_self.lock()) {
+                    self->Fail(HttpResponse::BadGateway(),
+                               "upstream_disconnect",
+                               "upstream disconnected during TLS handshake");
+                }
+            });
+        // Strong capture keeps the tunnel alive across the TLS handshake;
+        // cleared by ReleaseUpstream.
+        auto self = shared_from_this();
+        transport->SetHandshakeCompleteCallback([self]() {
+            auto tunnel = self;
+            tunnel->SendHandshake();
+        });
+        return;
+    }
+    SendHandshake();
+}
+
+void WsTunnel::OnCheckoutError(int error_code) {
+    if (state_ != State::CHECKOUT) return;
+    logging::Get()->warn("WsTunnel checkout failed client_fd={} service={} "
+                         "error={}", client_fd_, params_.service_name,
+                         error_code);
+    if (error_code == PoolPartition::CHECKOUT_CONNECT_FAILED ||
+        error_code == PoolPartition::CHECKOUT_CONNECT_TIMEOUT) {
+        Fail(HttpResponse::BadGateway(), "upstream_connect_failure",
+             "checkout failed");
+    } else {
+        Fail(HttpResponse::ServiceUnavailable(), "upstream_unavailable",
+             "checkout failed");
+    }
+}
+
+void WsTunnel::SendHandshake() {
+    if (state_ != State::CHECKOUT) return;
+    auto transport = UpstreamTransport();
+    if (!transport || transport->IsClosing()) {
+        Fail(HttpResponse::BadGateway(), "upstream_disconnect",
+             "upstream closed before handshake");
+        return;
+    }
+    if (transport->GetAlpnProtocol() == "h2") {
+        // RFC 8441 extended CONNECT is not implemented on the upstream
+        // H2 codec; a WebSocket needs an HTTP/1.1 upstream.
+        HttpResponse resp = HttpResponse::BadGateway();
+        resp.Header("X-H2-Limitation", "websocket-not-supported");
+        Fail(std::move(resp), "upstream_h2_not_supported",
+             "upstream negotiated h2");
+        return;
+    }
+
+    state_ = State::HANDSHAKE;
+    std::weak_ptr<WsTunnel> weak_self = weak_from_this();
+    transport->SetMaxInputSize(params_.relay_buffer_limit_bytes);
+    // The message callback owns the tunnel (as in ProxyTransaction);
+    // ReleaseUpstream clears it. The stack copy survives that clear
+    // when it happens inside the callback.
+    auto self = shared_from_this();
+    transport->SetOnMessageCb(
+        [self](std::shared_ptr<ConnectionHandler>, std::string& data) {
+            auto tunnel = self;
+            tunnel->OnUpstreamData(data);
+        });
+    transport->SetCompletionCb(
+        [weak_self](std::shared_ptr<ConnectionHandler>) {
+            if (auto self = weak_self.lock()) self->OnUpstreamDrain(0);
+        });
+    transport->SetWriteProgressCb(
+        [weak_self](std::shared_ptr<ConnectionHandler>, size_t remaining) {
+            if (auto self = weak_self.lock()) self->OnUpstreamDrain(remaining);
+        });
+
+    if (params_.response_timeout_ms > 0) {
+        transport->SetDeadline(std::chrono::steady_clock::now() +
+                               std::chrono::milliseconds(
+                                   params_.response_timeout_ms));
+        transport->SetDeadlineTimeoutCb([weak_self]() -> bool {
+            auto self = weak_self.lock();
+            if (!self) return false;
+            self->Fail(HttpResponse::GatewayTimeout(), "response_timeout",
+                       "upstream handshake timeout");
+            // The lease is released (connection marked closing); the
+            // pool owns the transport's lifecycle from here.
+            return true;
+        });
+    }
+
+    logging::Get()->debug("WsTunnel sending upgrade client_fd={} service={} "
+                          "upstream_fd={}", client_fd_, params_.service_name,
+                          upstream_fd_);
+    std::string head = std::move(params_.request_head);
+    params_.request_head.clear();
+    transport->SendRaw(head.data(), head.size());
+}
+
+void WsTunnel::OnUpstreamData(std::string& data) {
+    if (data.empty()) {
+        // Pool-reported upstream disconnect.
+        if (state_ == State::OPEN) {
+            Close("upstream_closed");
+        } else if (state_ == State::REJECTION_BODY) {
+            // Close-delimited or truncated body: relay what arrived.
+            RelayRejection();
+        } else if (state_ != State::CLOSED) {
+            Fail(HttpResponse::BadGateway(), "upstream_disconnect",
+                 "upstream closed during handshake");
+        }
+        return;
+    }
+
+    if (state_ == State::OPEN) {
+        auto cc = client_conn_.lock();
+        if (!cc || cc->IsClosing()) return;
+        const size_t n = data.size();
+        cc->SendRaw(data.data(), n);
+        bytes_to_client_ += n;
+        if (params_.context) {
+            params_.context->bytes_to_client.fetch_add(
+                static_cast<int64_t>(n), std::memory_order_relaxed);
+        }
+        EmitBytes(n, "downstream");
+        if (state_ == State::OPEN && !upstream_paused_ &&
+            cc->OutputBufferSize() > params_.relay_buffer_limit_bytes) {
+            if (lease_.Get()) {
+                lease_.Get()->IncReadDisable();
+                upstream_paused_ = true;
+            }
+        }
+        return;
+    }
+
+    if (state_ == State::HANDSHAKE) {
+        head_buf_.append(data);
+        ProcessResponseHead();
+        return;
+    }
+
+    if (state_ == State::REJECTION_BODY) {
+        head_buf_.append(data);
+        if (head_buf_.size() >= rejection_body_len_) RelayRejection();
+    }
+}
+
+bool WsTunnel::ProcessResponseHead() {
+    while (state_ == State::HANDSHAKE) {
+        size_t head_end = head_buf_.find("\r\n\r\n");
+        if (head_end == std::string::npos) {
+            if (head_buf_.size() > MAX_RESPONSE_HEAD_BYTES) {
+                Fail(HttpResponse::BadGateway(), "upstream_parse_error",
+                     "upstream response head too large");
+            }
+            return false;
+        }
+
+        // Status line: HTTP/1.x SP 3DIGIT [SP reason]
+        size_t line_end = head_buf_.find("\r\n");
+        std::string status_line = head_buf_.substr(0, line_end);
+        int status = 0;
+        std::string reason;
+        if (status_line.size() >= 12 &&
+            status_line.compare(0, 7, "HTTP/1.") == 0 &&
+            status_line[8] == ' ' &&
+            std::isdigit(static_cast<unsigned char>(status_line[9])) &&
+            std::isdigit(static_cast<unsigned char>(status_line[10])) &&
+            std::isdigit(static_cast<unsigned char>(status_line[11]))) {
+            status = std::stoi(status_line.substr(9, 3));
+            if (status_line.size() > 13) reason = status_line.substr(13);
+        }
+        if (status < 100) {
+            Fail(HttpResponse::BadGateway(), "upstream_parse_error",
+                 "malformed upstream status line");
+            return false;
+        }
+
+        std::vector<std::pair<std::string, std::string>> headers;
+        size_t pos = line_end + 2;
+        while (pos < head_end) {
+            size_t eol = head_buf_.find("\r\n", pos);
+            std::string line = head_buf_.substr(pos, eol - pos);
+            pos = eol + 2;
+            size_t colon = line.find(':');
+            if (colon == std::string::npos || colon == 0) {
+                Fail(HttpResponse::BadGateway(), "upstream_parse_error",
+                     "malformed upstream header");
+                return false;
+            }
+            std::string name = line.substr(0, colon);
+            std::string value = line.substr(colon + 1);
+            TrimOws(value);
+            headers.emplace_back(std::move(name), std::move(value));
+        }
+        std::string rest = head_buf_.substr(head_end + 4);
+
+        if (status == HttpStatus::SWITCHING_PROTOCOLS) {
+            head_buf_.clear();
+            Open(status, reason, std::move(headers), std::move(rest));
+            return true;
+        }
+        if (status < 200) {
+            // Other interim responses (100, 103) carry nothing the
+            // client needs before the final answer.
+            head_buf_ = std::move(rest);
+            continue;
+        }
+
+        // Final non-101 answer: the upstream refused the upgrade. Relay
+        // it with a bounded Content-Length body; other framings are
+        // relayed without their body.
+        response_status_ = status;
+        response_reason_ = reason;
+        response_headers_ = std::move(headers);
+        rejection_body_len_ = 0;
+        for (const auto& h : response_headers_) {
+            if (ToLower(h.first) != "content-length") continue;
+            try {
+                unsigned long long cl = std::stoull(h.second);
+                if (cl <= MAX_REJECTION_BODY_BYTES) {
+                    rejection_body_len_ = static_cast<size_t>(cl);
+                }
+            } catch (const std::exception&) {}
+            break;
+        }
+        head_buf_ = std::move(rest);
+        state_ = State::REJECTION_BODY;
+        if (head_buf_.size() >= rejection_body_len_) RelayRejection();
+        return true;
+    }
+    return false;
+}
+
+void WsTunnel::RelayRejection() {
+    if (state_ != State::REJECTION_BODY) return;
+    HttpResponse resp;
+    resp.Status(response_status_, response_reason_);
+    for (const auto& h : response_headers_) {
+        std::string key = ToLower(h.first);
+        if (key == "content-length" ||
+            HeaderRewriter::IsHopByHopHeader(key)) {
+            continue;
+        }
+        resp.AppendHeader(h.first, h.second);
+    }
+    if (head_buf_.size() > rejection_body_len_) {
+        head_buf_.resize(rejection_body_len_);
+    }
+    resp.Body(std::move(head_buf_));
+    head_buf_.clear();
+    logging::Get()->debug("WsTunnel upstream refused upgrade client_fd={} "
+                          "service={} status={}", client_fd_,
+                          params_.service_name, response_status_);
+    Fail(std::move(resp), std::string{}, "upstream refused upgrade");
+}
+
+void WsTunnel::Open(int status_code, const std::string& reason,
+                    std::vector<std::pair<std::string, std::string>> headers,
+                    std::string leftover) {
+    auto transport = UpstreamTransport();
+    if (transport) {
+        transport->ClearDeadline();
+        transport->SetDeadlineTimeoutCb(nullptr);
+    }
+
+    HttpResponse resp;
+    resp.Status(status_code,
+                reason.empty() ? std::string("Switching Protocols") : reason);
+    std::string upgrade_value = "websocket";
+    for (auto& h : headers) {
+        std::string key = ToLower(h.first);
+        if (key == "upgrade") {
+            upgrade_value = h.second;
+            continue;
+        }
+        if (key == "content-length" ||
+            HeaderRewriter::IsHopByHopHeader(key)) {
+            continue;
+        }
+        resp.AppendHeader(h.first, h.second);
+    }
+    resp.Header("Upgrade", upgrade_value);
+    resp.Header("Connection", "Upgrade");
+
+    auto client = client_.lock();
+    if (!client) {
+        Close("client_disconnect");
+        return;
+    }
+
+    state_ = State::OPEN;
+    opened_at_ = std::chrono::steady_clock::now();
+    if (params_.context) {
+        params_.context->active.fetch_add(1, std::memory_order_relaxed);
+        params_.context->total.fetch_add(1, std::memory_order_relaxed);
+    }
+    EmitActiveDelta(1.0);
+    logging::Get()->debug("WsTunnel open client_fd={} service={} "
+                          "upstream_fd={}", client_fd_,
+                          params_.service_name, upstream_fd_);
+
+    auto self = shared_from_this();
+    HTTP_CALLBACKS_NAMESPACE::HttpConnWsTunnelHooks hooks;
+    hooks.on_data = [self](std::string& data) {
+        auto keep = self;
+        keep->OnClientData(data);
+    };
+    hooks.on_drain = [self](size_t remaining) {
+        auto keep = self;
+        keep->OnClientDrain(remaining);
+    };
+    hooks.on_close = [self]() {
+        auto keep = self;
+        keep->OnClientClose();
+    };
+    // Sends the 101 and replays client bytes stashed since the upgrade
+    // request into on_data.
+    client->CompleteWsTunnel(std::move(resp), std::move(hooks), std::string{});
+    if (state_ != State::OPEN) return;
+    if (!client->IsWsTunnel()) {
+        // Client closed while the 101 was being written; no hooks were
+        // installed, so nothing else will close the tunnel.
+        Close("client_disconnect");
+        return;
+    }
+    if (auto cc = client_conn_.lock()) {
+        cc->SetMaxInputSize(params_.relay_buffer_limit_bytes);
+    }
+    if (!leftover.empty()) OnUpstreamData(leftover);
+}
+
+void WsTunnel::OnClientData(std::string& data) {
+    if (state_ != State::OPEN || data.empty()) return;
+    auto transport = UpstreamTransport();
+    if (!transport || transport->IsClosing()) return;
+    const size_t n = data.size();
+    transport->SendRaw(data.data(), n);
+    bytes_to_upstream_ += n;
+    if (params_.context) {
+        params_.context->bytes_to_upstream.fetch_add(
+            static_cast<int64_t>(n), std::memory_order_relaxed);
+    }
+    EmitBytes(n, "upstream");
+    if (state_ == State::OPEN && !client_paused_ &&
+        transport->OutputBufferSize() > params_.relay_buffer_limit_bytes) {
+        if (auto cc = client_conn_.lock()) {
+            cc->IncReadDisable();
+            client_paused_ = true;
+        }
+    }
+}
+
+void WsTunnel::OnClientDrain(size_t remaining) {
+    if (state_ != State::OPEN || !upstream_paused_) return;
+    if (remaining > params_.relay_buffer_limit_bytes / 2) return;
+    upstream_paused_ = false;
+    if (lease_.Get()) lease_.Get()->DecReadDisable();
+}
+
+void WsTunnel::OnUpstreamDrain(size_t remaining) {
+    if (state_ != State::OPEN || !client_paused_) return;
+    if (remaining > params_.relay_buffer_limit_bytes / 2) return;
+    client_paused_ = false;
+    if (auto cc = client_conn_.lock()) cc->DecReadDisable();
+}
+
+void WsTunnel::OnClientClose() {
+    if (state_ == State::CLOSED) return;
+    Close("client_closed");
+}
+
+void WsTunnel::Fail(HttpResponse response, const std::string& error_type,
+                    const std::string& reason) {
+    if (state_ == State::CLOSED || state_ == State::OPEN) {
+        if (state_ == State::OPEN) Close("error");
+        return;
+    }
+    if (!error_type.empty()) {
+        logging::Get()->warn("WsTunnel failed client_fd={} service={} "
+                             "upstream={}:{} status={}: {}", client_fd_,
+                             params_.service_name, params_.upstream_host,
+                             params_.upstream_port,
+                             response.GetStatusCode(), reason);
+    }
+    if (cancel_token_) cancel_token_->store(true, std::memory_order_release);
+    state_ = State::CLOSED;
+    ReleaseUpstream();
+    if (auto client = client_.lock()) {
+        client->CompleteWsTunnel(std::move(response), {}, error_type);
+    }
+}
+
+void WsTunnel::Close(const char* reason) {
+    if (state_ == State::CLOSED) return;
+    const bool was_open = (state_ == State::OPEN);
+    state_ = State::CLOSED;
+    if (cancel_token_) cancel_token_->store(true, std::memory_order_release);
+
+    auto cc = client_conn_.lock();
+    if (client_paused_ && cc) {
+        cc->DecReadDisable();
+        client_paused_ = false;
+    }
+    ReleaseUpstream();
+
+    if (!was_open) return;
+    if (params_.context) {
+        params_.context->active.fetch_sub(1, std::memory_order_relaxed);
+    }
+    EmitActiveDelta(-1.0);
+    auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - opened_at_).count();
+    logging::Get()->info("WsTunnel closed client_fd={} service={} "
+                         "upstream_fd={} reason={} bytes_to_upstream={} "
+                         "bytes_to_client={} duration_ms={}", client_fd_,
+                         params_.service_name, upstream_fd_, reason,
+                         bytes_to_upstream_, bytes_to_client_, duration_ms);
+    // Flush whatever the upstream already sent (typically its Close
+    // frame) before the client socket goes away.
+    if (cc && !cc->IsClosing()) cc->CloseAfterWrite();
+}
+
+void WsTunnel::ReleaseUpstream() {
+    if (!lease_) return;
+    auto* upstream_conn = lease_.Get();
+    if (upstream_conn) {
+        auto transport = upstream_conn->GetTransport();
+        if (transport) {
+            transport->SetOnMessageCb(nullptr);
+            transport->SetCompletionCb(nullptr);
+            transport->SetWriteProgressCb(nullptr);
+            transport->SetHandshakeCompleteCallback(nullptr);
+            transport->ClearDeadline();
+            transport->SetDeadlineTimeoutCb(nullptr);
+        }
+        if (upstream_paused_) {
+            upstream_conn->DecReadDisable();
+            upstream_paused_ = false;
+        }
+        // Never reusable: it either switched protocols or answered the
+        // upgrade in a framing the tunnel did not fully consume.
+        upstream_conn->MarkClosing();
+    }
+    lease_.Release();
+}
+
+std::shared_ptr<ConnectionHandler> WsTunnel::UpstreamTransport() const {
+    auto* upstream_conn = lease_.Get();
+    return upstream_conn ? upstream_conn->GetTransport() : nullptr;
+}
+
+void WsTunnel::EmitBytes(size_t bytes, const char* direction) {
+    if (!params_.context) return;
+    auto mgr = params_.context->obs_manager.lock();
+    if (!mgr) return;
+    const auto& cat = mgr->catalog();
+    if (cat.reactor_proxy_websocket_bytes == nullptr) return;
+    cat.reactor_proxy_websocket_bytes->Add(
+        static_cast<double>(bytes),
+        {{"reactor.upstream.service", params_.service_name},
+         {"direction", direction}});
+}
+
+void WsTunnel::EmitActiveDelta(double delta) {
+    if (!params_.context) return;
+    auto mgr = params_.context->obs_manager.lock();
+    if (!mgr) return;
+    const auto& cat = mgr->catalog();
+    if (cat.reactor_proxy_websocket_active_tunnels == nullptr) return;
+    cat.reactor_proxy_websocket_active_tunnels->Add(
+        delta, {{"reactor.upstream.service", params_.service_name}});
+}
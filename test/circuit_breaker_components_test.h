@@ -7,6 +7,7 @@
 #include "circuit_breaker/retry_budget.h"
 #include "circuit_breaker/circuit_breaker_host.h"
 #include "circuit_breaker/circuit_breaker_manager.h"
+#include "circuit_breaker/outlier_detector.h"
 #include "dispatcher.h"
 
 #include <iostream>
@@ -15,7 +16,7 @@
 #include <vector>
 
 // Circuit-breaker component unit tests: RetryBudget, CircuitBreakerHost,
-// CircuitBreakerManager.
+// CircuitBreakerManager, OutlierDetector.
 //
 // These tests exercise the standalone data structures without any
 // integration into the request path (covered by the integration suite).
@@ -30,6 +31,7 @@ using CIRCUIT_BREAKER_NAMESPACE::CircuitBreakerHostSnapshot;
 using CIRCUIT_BREAKER_NAMESPACE::CircuitBreakerManager;
 using CIRCUIT_BREAKER_NAMESPACE::Decision;
 using CIRCUIT_BREAKER_NAMESPACE::FailureKind;
+using CIRCUIT_BREAKER_NAMESPACE::OutlierDetector;
 using CIRCUIT_BREAKER_NAMESPACE::RetryBudget;
 using CIRCUIT_BREAKER_NAMESPACE::State;
 
@@ -483,6 +485,199 @@ void TestManagerSkipsEmptyNameUpstream() {
     }
 }
 
+// ============================================================================
+// OutlierDetector tests
+// ============================================================================
+//
+// Driven directly through Record / Sweep with explicit timestamps on a
+// single dispatcher slot set — Start() is never called, so no sweep task
+// runs behind the test's back.
+
+static CircuitBreakerConfig OutlierCbConfig() {
+    auto cb = DefaultCbConfig();
+    cb.max_ejection_percent_per_host_set = 50;
+    auto& od = cb.outlier_detection;
+    od.enabled = true;
+    od.consecutive_5xx = 3;
+    od.base_ejection_time_ms = 1000;
+    od.max_ejection_time_ms = 2500;
+    od.minimum_hosts = 3;
+    od.request_volume = 20;
+    od.success_rate_stdev_factor = 0;
+    od.latency_p99_factor_percent = 0;
+    return cb;
+}
+
+static std::vector<std::string> OutlierLabels(size_t n) {
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < n; ++i) {
+        labels.push_back("10.0.0." + std::to_string(i + 1) + ":80");
+    }
+    return labels;
+}
+
+// consecutive_5xx ejects on the Nth failure in a row; a success resets
+// the run; max_ejection_percent_per_host_set caps how many go at once.
+void TestOutlierConsecutiveAndCap() {
+    std::cout << "\n[TEST] OutlierDetector: consecutive_5xx + ejection cap..."
+              << std::endl;
+    try {
+        auto det = std::make_shared<OutlierDetector>(
+            "svc", OutlierLabels(3), 1, OutlierCbConfig());
+        auto now = std::chrono::steady_clock::now();
+
+        // Two failures, a success, two failures: no run of 3.
+        det->Record(0, 0, true, 5, now);
+        det->Record(0, 0, true, 5, now);
+        det->Record(0, 0, false, 5, now);
+        det->Record(0, 0, true, 5, now);
+        det->Record(0, 0, true, 5, now);
+        bool reset_ok = !det->IsEjected(0);
+
+        det->Record(0, 0, true, -1, now);
+        bool ejected_ok = det->IsEjected(0) && det->ejected_count() == 1;
+
+        // A second member would make 2/3 > 50%: refused.
+        for (int i = 0; i < 3; ++i) det->Record(0, 1, true, 5, now);
+        bool capped_ok = !det->IsEjected(1) && det->ejected_count() == 1 &&
+                         det->ejections_total() == 1;
+
+        bool pass = reset_ok && ejected_ok && capped_ok;
+        TestFramework::RecordTest("OutlierDetector consecutive_5xx + cap", pass,
+            pass ? "" :
+            "reset_ok=" + std::to_string(reset_ok) +
+            " ejected_ok=" + std::to_string(ejected_ok) +
+            " capped_ok=" + std::to_string(capped_ok),
+            TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("OutlierDetector consecutive_5xx + cap", false,
+            e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Ejection lasts base * times_ejected (capped at max) and expires on the
+// dispatcher-0 sweep; disabling detection on reload returns everyone.
+void TestOutlierEjectionExpiryAndReload() {
+    std::cout << "\n[TEST] OutlierDetector: ejection expiry + reload..."
+              << std::endl;
+    try {
+        auto cb = OutlierCbConfig();
+        auto det = std::make_shared<OutlierDetector>(
+            "svc", OutlierLabels(2), 1, cb);
+        auto t0 = std::chrono::steady_clock::now();
+        using std::chrono::milliseconds;
+
+        for (int i = 0; i < 3; ++i) det->Record(0, 0, true, -1, t0);
+        det->Sweep(0, t0 + milliseconds(999));
+        bool held_ok = det->IsEjected(0);
+        det->Sweep(0, t0 + milliseconds(1000));
+        bool expired_ok = !det->IsEjected(0) && det->ejected_count() == 0;
+
+        // Second ejection right away: 2 * base = 2000ms.
+        auto t1 = t0 + milliseconds(1000);
+        for (int i = 0; i < 3; ++i) det->Record(0, 0, true, -1, t1);
+        det->Sweep(0, t1 + milliseconds(1500));
+        bool backoff_ok = det->IsEjected(0);
+
+        cb.outlier_detection.enabled = false;
+        det->Reload(cb);
+        bool reload_ok = !det->IsEjected(0) && det->ejected_count() == 0;
+        // Disabled: failures are ignored.
+        for (int i = 0; i < 5; ++i) det->Record(0, 1, true, -1, t1);
+        bool disabled_ok = !det->IsEjected(1);
+
+        bool pass = held_ok && expired_ok && backoff_ok && reload_ok &&
+                    disabled_ok;
+        TestFramework::RecordTest("OutlierDetector ejection expiry + reload", pass,
+            pass ? "" :
+            "held_ok=" + std::to_string(held_ok) +
+            " expired_ok=" + std::to_string(expired_ok) +
+            " backoff_ok=" + std::to_string(backoff_ok) +
+            " reload_ok=" + std::to_string(reload_ok) +
+            " disabled_ok=" + std::to_string(disabled_ok),
+            TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("OutlierDetector ejection expiry + reload", false,
+            e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Statistical detectors: a member whose success rate sits far below the
+// set, and one whose p99 is far above the median p99, are ejected on the
+// sweep. Members under request_volume are not judged.
+void TestOutlierSuccessRateAndLatency() {
+    std::cout << "\n[TEST] OutlierDetector: success-rate + latency..."
+              << std::endl;
+    try {
+        auto now = std::chrono::steady_clock::now();
+
+        auto cb = OutlierCbConfig();
+        cb.outlier_detection.consecutive_5xx = 0;
+        cb.outlier_detection.success_rate_stdev_factor = 1000;
+        auto rate_det = std::make_shared<OutlierDetector>(
+            "svc", OutlierLabels(4), 1, cb);
+        for (int i = 0; i < 30; ++i) {
+            rate_det->Record(0, 0, false, 5, now);
+            rate_det->Record(0, 1, false, 5, now);
+            rate_det->Record(0, 2, i % 10 == 0, 5, now);  // 90%
+            rate_det->Record(0, 3, i % 2 == 0, 5, now);   // 50%
+        }
+        rate_det->Sweep(0, now);
+        bool rate_ok = rate_det->IsEjected(3) && !rate_det->IsEjected(2) &&
+                       rate_det->ejected_count() == 1;
+
+        auto lcb = OutlierCbConfig();
+        lcb.outlier_detection.consecutive_5xx = 0;
+        lcb.outlier_detection.latency_p99_factor_percent = 300;
+        lcb.outlier_detection.latency_p99_min_ms = 50;
+        auto lat_det = std::make_shared<OutlierDetector>(
+            "svc", OutlierLabels(4), 1, lcb);
+        for (int i = 0; i < 30; ++i) {
+            lat_det->Record(0, 0, false, 4, now);
+            lat_det->Record(0, 1, false, 6, now);
+            lat_det->Record(0, 2, false, 200, now);
+            if (i < 5) lat_det->Record(0, 3, false, 900, now);  // low volume
+        }
+        lat_det->Sweep(0, now);
+        bool latency_ok = lat_det->IsEjected(2) && !lat_det->IsEjected(3) &&
+                          lat_det->ejected_count() == 1;
+
+        bool pass = rate_ok && latency_ok;
+        TestFramework::RecordTest("OutlierDetector success-rate + latency", pass,
+            pass ? "" :
+            "rate_ok=" + std::to_string(rate_ok) +
+            " latency_ok=" + std::to_string(latency_ok),
+            TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("OutlierDetector success-rate + latency", false,
+            e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// dry_run computes and counts the ejection but keeps the member in
+// rotation.
+void TestOutlierDryRun() {
+    std::cout << "\n[TEST] OutlierDetector: dry_run..." << std::endl;
+    try {
+        auto cb = OutlierCbConfig();
+        cb.dry_run = true;
+        auto det = std::make_shared<OutlierDetector>(
+            "svc", OutlierLabels(2), 1, cb);
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i) det->Record(0, 0, true, -1, now);
+
+        bool pass = !det->IsEjected(0) && det->ejected_count() == 0 &&
+                    det->ejections_total() == 0 &&
+                    det->dry_run_ejections_total() == 1;
+        TestFramework::RecordTest("OutlierDetector dry_run", pass,
+            pass ? "" : "dry_run ejected or did not count",
+            TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("OutlierDetector dry_run", false,
+            e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
 // Run all circuit-breaker component unit tests.
 void RunAllTests() {
     std::cout << "\n" << std::string(60, '=') << std::endl;
@@ -502,6 +697,11 @@ void RunAllTests() {
     TestManagerGetHostLookup();
     TestManagerSnapshotAllAndReloadSkipsTopologyChanges();
     TestManagerSkipsEmptyNameUpstream();
+
+    TestOutlierConsecutiveAndCap();
+    TestOutlierEjectionExpiryAndReload();
+    TestOutlierSuccessRateAndLatency();
+    TestOutlierDryRun();
 }
 
 }  // namespace CircuitBreakerComponentsTests
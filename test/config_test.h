@@ -267,6 +267,279 @@ namespace ConfigTests {
         }
     }
 
+    // TLS session resumption fields — parse, round-trip, validate
+    void TestTlsKtlsConfig() {
+        std::cout << "\n[TEST] TLS kTLS Config..." << std::endl;
+        try {
+            bool pass = true;
+            std::string err;
+
+            ServerConfig defaults;
+            UpstreamTlsConfig upstream_defaults;
+            if (defaults.tls.ktls || upstream_defaults.ktls) {
+                pass = false; err += "ktls should default to false; ";
+            }
+
+            ServerConfig config = ConfigLoader::LoadFromString(R"({
+                "tls": { "ktls": true },
+                "upstreams": [{
+                    "name": "backend", "host": "127.0.0.1", "port": 8443,
+                    "tls": { "enabled": true, "ktls": true }
+                }]
+            })");
+            if (!config.tls.ktls || config.upstreams.size() != 1 ||
+                !config.upstreams[0].tls.ktls) {
+                pass = false; err += "parse mismatch; ";
+            }
+            ServerConfig round = ConfigLoader::LoadFromString(ConfigLoader::ToJson(config));
+            if (!round.tls.ktls || round.upstreams.size() != 1 ||
+                !round.upstreams[0].tls.ktls) {
+                pass = false; err += "round-trip mismatch; ";
+            }
+            UpstreamTlsConfig other = config.upstreams[0].tls;
+            other.ktls = false;
+            if (other == config.upstreams[0].tls) {
+                pass = false; err += "operator== ignores ktls; ";
+            }
+
+            try {
+                ConfigLoader::LoadFromString(R"({"tls": {"ktls": "yes"}})");
+                pass = false; err += "string tls.ktls accepted; ";
+            } catch (const std::exception&) {}
+            try {
+                ConfigLoader::LoadFromString(R"({"upstreams": [{
+                    "name": "b", "host": "127.0.0.1", "port": 1,
+                    "tls": {"ktls": 1}}]})");
+                pass = false; err += "integer upstream tls.ktls accepted; ";
+            } catch (const std::exception&) {}
+
+            TestFramework::RecordTest("TLS kTLS Config", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            TestFramework::RecordTest("TLS kTLS Config", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    void TestTlsHandshakeOffloadConfig() {
+        std::cout << "\n[TEST] TLS Handshake Offload Config..." << std::endl;
+        const std::string cert = "/tmp/cfg_tls_cert.pem";
+        const std::string key = "/tmp/cfg_tls_key.pem";
+        try {
+            std::ofstream(cert) << "x";
+            std::ofstream(key) << "x";
+
+            bool pass = true;
+            std::string err;
+
+            ServerConfig defaults;
+            if (defaults.tls.handshake_offload_threads != 0) {
+                pass = false; err += "handshake_offload_threads should default to 0; ";
+            }
+
+            ServerConfig config = ConfigLoader::LoadFromString(R"({
+                "tls": {
+                    "enabled": true,
+                    "cert_file": "/tmp/cfg_tls_cert.pem",
+                    "key_file": "/tmp/cfg_tls_key.pem",
+                    "handshake_offload_threads": 4
+                }
+            })");
+            ConfigLoader::Validate(config);
+            if (config.tls.handshake_offload_threads != 4) {
+                pass = false; err += "parse mismatch; ";
+            }
+            ServerConfig round = ConfigLoader::LoadFromString(ConfigLoader::ToJson(config));
+            if (round.tls.handshake_offload_threads != 4) {
+                pass = false; err += "round-trip mismatch; ";
+            }
+
+            for (int bad_threads : {-1, 65}) {
+                ServerConfig bad = config;
+                bad.tls.handshake_offload_threads = bad_threads;
+                try {
+                    ConfigLoader::Validate(bad);
+                    pass = false;
+                    err += "handshake_offload_threads=" +
+                           std::to_string(bad_threads) + " accepted; ";
+                } catch (const std::invalid_argument&) {}
+            }
+            try {
+                ConfigLoader::LoadFromString(
+                    R"({"tls": {"handshake_offload_threads": "2"}})");
+                pass = false; err += "string handshake_offload_threads accepted; ";
+            } catch (const std::exception&) {}
+
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            TestFramework::RecordTest("TLS Handshake Offload Config", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            TestFramework::RecordTest("TLS Handshake Offload Config", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    void TestTlsRecordSizingConfig() {
+        std::cout << "\n[TEST] TLS Record Sizing Config..." << std::endl;
+        const std::string cert = "/tmp/cfg_tls_cert.pem";
+        const std::string key = "/tmp/cfg_tls_key.pem";
+        try {
+            std::ofstream(cert) << "x";
+            std::ofstream(key) << "x";
+
+            bool pass = true;
+            std::string err;
+
+            ServerConfig defaults;
+            if (defaults.tls.record_sizing || defaults.tls.record_size_initial != 1400 ||
+                defaults.tls.record_size_ramp_bytes != 1048576 ||
+                defaults.tls.record_size_idle_reset_ms != 1000) {
+                pass = false; err += "unexpected defaults; ";
+            }
+
+            ServerConfig config = ConfigLoader::LoadFromString(R"({
+                "tls": {
+                    "enabled": true,
+                    "cert_file": "/tmp/cfg_tls_cert.pem",
+                    "key_file": "/tmp/cfg_tls_key.pem",
+                    "record_sizing": true,
+                    "record_size_initial": 1200,
+                    "record_size_ramp_bytes": 65536,
+                    "record_size_idle_reset_ms": 0
+                }
+            })");
+            ConfigLoader::Validate(config);
+            if (!config.tls.record_sizing || config.tls.record_size_initial != 1200 ||
+                config.tls.record_size_ramp_bytes != 65536 ||
+                config.tls.record_size_idle_reset_ms != 0) {
+                pass = false; err += "parse mismatch; ";
+            }
+            ServerConfig round = ConfigLoader::LoadFromString(ConfigLoader::ToJson(config));
+            if (!round.tls.record_sizing || round.tls.record_size_initial != 1200 ||
+                round.tls.record_size_ramp_bytes != 65536 ||
+                round.tls.record_size_idle_reset_ms != 0) {
+                pass = false; err += "round-trip mismatch; ";
+            }
+
+            auto rejects = [&](ServerConfig c, const char* what) {
+                try {
+                    ConfigLoader::Validate(c);
+                    pass = false; err += std::string(what) + " accepted; ";
+                } catch (const std::invalid_argument&) {}
+            };
+            ServerConfig bad = config;
+            bad.tls.record_size_initial = 511;
+            rejects(bad, "record_size_initial=511");
+            bad = config;
+            bad.tls.record_size_initial = 16385;
+            rejects(bad, "record_size_initial=16385");
+            bad = config;
+            bad.tls.record_size_ramp_bytes = -1;
+            rejects(bad, "record_size_ramp_bytes=-1");
+            bad = config;
+            bad.tls.record_size_idle_reset_ms = -1;
+            rejects(bad, "record_size_idle_reset_ms=-1");
+            try {
+                ConfigLoader::LoadFromString(R"({"tls": {"record_sizing": 1}})");
+                pass = false; err += "integer record_sizing accepted; ";
+            } catch (const std::exception&) {}
+
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            TestFramework::RecordTest("TLS Record Sizing Config", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            TestFramework::RecordTest("TLS Record Sizing Config", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    void TestTlsSessionResumptionConfig() {
+        std::cout << "\n[TEST] TLS Session Resumption Config..." << std::endl;
+        const std::string cert = "/tmp/cfg_tls_cert.pem";
+        const std::string key = "/tmp/cfg_tls_key.pem";
+        const std::string ticket = "/tmp/cfg_tls_ticket.key";
+        try {
+            std::ofstream(cert) << "x";
+            std::ofstream(key) << "x";
+            std::ofstream(ticket) << std::string(80, 'k');
+
+            bool pass = true;
+            std::string err;
+
+            ServerConfig defaults;
+            if (!defaults.tls.session_tickets || !defaults.tls.ticket_key_file.empty() ||
+                defaults.tls.session_cache_size != 0 ||
+                defaults.tls.session_timeout_sec != 3600) {
+                pass = false; err += "unexpected defaults; ";
+            }
+
+            ServerConfig config = ConfigLoader::LoadFromString(R"({
+                "tls": {
+                    "enabled": true,
+                    "cert_file": "/tmp/cfg_tls_cert.pem",
+                    "key_file": "/tmp/cfg_tls_key.pem",
+                    "ticket_key_file": "/tmp/cfg_tls_ticket.key",
+                    "session_cache_size": 2048,
+                    "session_timeout_sec": 600
+                }
+            })");
+            ConfigLoader::Validate(config);
+            if (config.tls.ticket_key_file != ticket ||
+                config.tls.session_cache_size != 2048 ||
+                config.tls.session_timeout_sec != 600) {
+                pass = false; err += "parse mismatch; ";
+            }
+            ServerConfig round = ConfigLoader::LoadFromString(ConfigLoader::ToJson(config));
+            if (round.tls.ticket_key_file != ticket ||
+                round.tls.session_cache_size != 2048 ||
+                round.tls.session_timeout_sec != 600 || !round.tls.session_tickets) {
+                pass = false; err += "round-trip mismatch; ";
+            }
+
+            auto rejects = [&](ServerConfig c, const char* what) {
+                try {
+                    ConfigLoader::Validate(c);
+                    pass = false; err += std::string(what) + " accepted; ";
+                } catch (const std::invalid_argument&) {}
+            };
+            ServerConfig bad = config;
+            bad.tls.session_tickets = false;
+            rejects(bad, "ticket_key_file without session_tickets");
+            bad = config;
+            bad.tls.session_timeout_sec = 0;
+            rejects(bad, "session_timeout_sec=0");
+            bad = config;
+            bad.tls.session_cache_size = -1;
+            rejects(bad, "session_cache_size=-1");
+            bad = config;
+            bad.tls.ticket_key_file = "/tmp/cfg_tls_missing.key";
+            rejects(bad, "missing ticket_key_file");
+
+            try {
+                ConfigLoader::LoadFromString(R"({"tls": {"session_cache_size": true}})");
+                pass = false; err += "boolean session_cache_size accepted; ";
+            } catch (const std::exception&) {}
+
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            std::remove(ticket.c_str());
+            TestFramework::RecordTest("TLS Session Resumption Config", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(cert.c_str());
+            std::remove(key.c_str());
+            std::remove(ticket.c_str());
+            TestFramework::RecordTest("TLS Session Resumption Config", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
     // Test 7: Environment variable overrides
     void TestEnvOverrides() {
         std::cout << "\n[TEST] Environment Variable Overrides..." << std::endl;
@@ -617,6 +890,94 @@ namespace ConfigTests {
         }
     }
 
+    // circuit_breaker.outlier_detection: defaults when absent, explicit
+    // values parse, survive ToJson(), and feed the breaker's equality
+    // (so a detector-only edit reloads live); bad ranges are rejected.
+    void TestCircuitBreakerOutlierDetection() {
+        std::cout << "\n[TEST] Circuit Breaker Outlier Detection config..." << std::endl;
+        try {
+            ServerConfig defaults = ConfigLoader::LoadFromString(R"({
+                "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                               "circuit_breaker": {"enabled": true}}]
+            })");
+            const auto& dod = defaults.upstreams.at(0).circuit_breaker.outlier_detection;
+            bool defaults_ok = !dod.enabled && dod.interval_ms == 10000 &&
+                               dod.consecutive_5xx == 5 &&
+                               dod.base_ejection_time_ms == 30000 &&
+                               dod.max_ejection_time_ms == 300000 &&
+                               dod.minimum_hosts == 3 &&
+                               dod.request_volume == 100 &&
+                               dod.success_rate_stdev_factor == 1900 &&
+                               dod.latency_p99_factor_percent == 300 &&
+                               dod.latency_p99_min_ms == 50;
+
+            ServerConfig config = ConfigLoader::LoadFromString(R"({
+                "upstreams": [{
+                    "name": "svc", "host": "10.0.0.1", "port": 8080,
+                    "circuit_breaker": {
+                        "enabled": true,
+                        "outlier_detection": {
+                            "enabled": true,
+                            "interval_ms": 2000,
+                            "consecutive_5xx": 3,
+                            "base_ejection_time_ms": 1000,
+                            "max_ejection_time_ms": 8000,
+                            "minimum_hosts": 2,
+                            "request_volume": 20,
+                            "success_rate_stdev_factor": 1000,
+                            "latency_p99_factor_percent": 250,
+                            "latency_p99_min_ms": 10
+                        }
+                    }
+                }]
+            })");
+            ConfigLoader::Validate(config);
+            const auto& od = config.upstreams.at(0).circuit_breaker.outlier_detection;
+            bool parsed_ok = od.enabled && od.interval_ms == 2000 &&
+                             od.consecutive_5xx == 3 &&
+                             od.base_ejection_time_ms == 1000 &&
+                             od.max_ejection_time_ms == 8000 &&
+                             od.minimum_hosts == 2 &&
+                             od.request_volume == 20 &&
+                             od.success_rate_stdev_factor == 1000 &&
+                             od.latency_p99_factor_percent == 250 &&
+                             od.latency_p99_min_ms == 10;
+            ServerConfig round =
+                ConfigLoader::LoadFromString(ConfigLoader::ToJson(config));
+            bool round_ok =
+                round.upstreams.at(0).circuit_breaker.outlier_detection == od;
+            bool cb_differs = config.upstreams.at(0).circuit_breaker !=
+                              defaults.upstreams.at(0).circuit_breaker;
+
+            bool pass = defaults_ok && parsed_ok && round_ok && cb_differs;
+            TestFramework::RecordTest("Circuit Breaker Outlier Detection parse + round-trip",
+                pass,
+                pass ? "" :
+                "defaults_ok=" + std::to_string(defaults_ok) +
+                " parsed_ok=" + std::to_string(parsed_ok) +
+                " round_ok=" + std::to_string(round_ok) +
+                " cb_differs=" + std::to_string(cb_differs),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            TestFramework::RecordTest("Circuit Breaker Outlier Detection parse + round-trip",
+                false, e.what(), TestFramework::TestCategory::OTHER);
+        }
+
+        ExpectValidationFailure("CB Validation: outlier max<base ejection time",
+            R"({"outlier_detection": {"base_ejection_time_ms": 5000,
+                                      "max_ejection_time_ms": 1000}})",
+            "outlier_detection.max_ejection_time_ms must be >= base_ejection_time_ms");
+        ExpectValidationFailure("CB Validation: outlier minimum_hosts<2",
+            R"({"outlier_detection": {"minimum_hosts": 1}})",
+            "outlier_detection.minimum_hosts must be in [2, 10000]");
+        ExpectValidationFailure("CB Validation: outlier latency factor <= 100%",
+            R"({"outlier_detection": {"latency_p99_factor_percent": 90}})",
+            "outlier_detection.latency_p99_factor_percent must be 0 (disabled)");
+        ExpectValidationFailure("CB Validation: outlier float rejected for int field",
+            R"({"outlier_detection": {"interval_ms": 1.5}})",
+            "circuit_breaker.outlier_detection.interval_ms must be an integer");
+    }
+
     // ───────────────────────────────────────────────────────────────────
     // ConfigLoader Normalize + DNS tests
     // ───────────────────────────────────────────────────────────────────
@@ -1122,6 +1483,10 @@ namespace ConfigTests {
         TestInvalidJson();
         TestValidationInvalidPort();
         TestValidationTlsNoCert();
+        TestTlsSessionResumptionConfig();
+        TestTlsKtlsConfig();
+        TestTlsHandshakeOffloadConfig();
+        TestTlsRecordSizingConfig();
         TestEnvOverrides();
         TestMissingFile();
 
@@ -1132,6 +1497,7 @@ namespace ConfigTests {
         TestCircuitBreakerJsonRoundTrip();
         TestCircuitBreakerValidation();
         TestCircuitBreakerEquality();
+        TestCircuitBreakerOutlierDetection();
 
         // Step 6 — ConfigLoader Normalize + DNS + hostname acceptance
         TestIsValidRejectsScopeId();
@@ -0,0 +1,463 @@
+#pragma once
+
+// early_hints_test.h — 103 Early Hints (RFC 8297).
+//
+// Test dimensions:
+//   Unit (in-process, no sockets):
+//     T1  FormatLinkValue / IsValidLinkValue: rendering, CR/LF rejection,
+//         missing "<uri>", length cap
+//     T2  BuildHeaders skips invalid values; FilterRelayableHeaders keeps
+//         only valid `link` fields
+//   Integration (real HttpServer, raw H1 client on loopback):
+//     T3  RouteOptions::early_hints emits one 103 before the async 200
+//     T4  HTTP/1.0 client never sees the 103
+//     T5  Send() from an async handler
+//     T6  Proxy: upstream 103 relayed (Link only) when relay_early_hints=true
+//     T7  Proxy: upstream 103 dropped by default
+//     T8  Proxy: proxy.early_hints emits a 103 before the upstream answers
+//   Config:
+//     T9  early_hints / relay_early_hints JSON round-trip; invalid Link
+//         value rejected by Validate
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "proxy_test.h"  // RawHttpBackendServer, SendAll, RecvUntilClose
+#include "http/http_server.h"
+#include "http/early_hints.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <thread>
+#include <chrono>
+
+namespace EarlyHintsTests {
+
+// Send `request` on a fresh connection and read until the peer closes.
+inline std::string Exchange(int port, const std::string& request,
+                            int timeout_ms = 3000) {
+    int fd = TestHttpClient::ConnectRawSocket(port);
+    if (fd < 0) return "";
+    if (!ProxyTests::SendAll(fd, request)) {
+        close(fd);
+        return "";
+    }
+    std::string out = ProxyTests::RecvUntilClose(fd, timeout_ms);
+    close(fd);
+    return out;
+}
+
+// Verify `resp` holds exactly one 103 block that precedes the final
+// `final_line` and carries `link`. Appends failures to `err`.
+inline bool Check103Before(const std::string& resp, const std::string& final_line,
+                           const std::string& link, std::string& err) {
+    auto pos103 = resp.find("HTTP/1.1 103");
+    auto pos_final = resp.find(final_line);
+    if (pos103 == std::string::npos) { err += "missing 103; "; return false; }
+    if (pos_final == std::string::npos) { err += "missing final response; "; return false; }
+    if (pos103 > pos_final) { err += "103 after final; "; return false; }
+    if (resp.find("HTTP/1.1 103", pos103 + 1) != std::string::npos) {
+        err += "more than one 103; ";
+        return false;
+    }
+    std::string block = resp.substr(pos103, pos_final - pos103);
+    if (block.find("Link: " + link) == std::string::npos) {
+        err += "Link not in 103 block; ";
+        return false;
+    }
+    return true;
+}
+
+// T1
+void TestFormatAndValidate() {
+    std::cout << "\n[TEST] Early Hints: FormatLinkValue / IsValidLinkValue..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        HTTP_EARLY_HINTS_NAMESPACE::PreloadLink style;
+        style.uri = "/app.css";
+        style.as = "style";
+        std::string v = HTTP_EARLY_HINTS_NAMESPACE::FormatLinkValue(style);
+        if (v != "</app.css>; rel=preload; as=style") {
+            pass = false; err += "style rendered as '" + v + "'; ";
+        }
+
+        HTTP_EARLY_HINTS_NAMESPACE::PreloadLink font;
+        font.uri = "/f.woff2";
+        font.as = "font";
+        font.type = "font/woff2";
+        font.crossorigin = "anonymous";
+        v = HTTP_EARLY_HINTS_NAMESPACE::FormatLinkValue(font);
+        if (v != "</f.woff2>; rel=preload; as=font; type=\"font/woff2\"; crossorigin") {
+            pass = false; err += "font rendered as '" + v + "'; ";
+        }
+
+        HTTP_EARLY_HINTS_NAMESPACE::PreloadLink bad;
+        bad.uri = "/x>\r\nSet-Cookie: a=b";
+        if (!HTTP_EARLY_HINTS_NAMESPACE::FormatLinkValue(bad).empty()) {
+            pass = false; err += "unsafe uri rendered; ";
+        }
+        if (!HTTP_EARLY_HINTS_NAMESPACE::FormatLinkValue({}).empty()) {
+            pass = false; err += "empty uri rendered; ";
+        }
+
+        if (!HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue("</a.js>; rel=preload; as=script")) {
+            pass = false; err += "valid value rejected; ";
+        }
+        if (HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue("/a.js; rel=preload")) {
+            pass = false; err += "value without <uri> accepted; ";
+        }
+        if (HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue("<>; rel=preload")) {
+            pass = false; err += "empty <> accepted; ";
+        }
+        if (HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue("</a.js>\r\nX: y")) {
+            pass = false; err += "CRLF accepted; ";
+        }
+        std::string huge = "</" + std::string(
+            HTTP_EARLY_HINTS_NAMESPACE::MAX_LINK_VALUE_LENGTH, 'a') + ">";
+        if (HTTP_EARLY_HINTS_NAMESPACE::IsValidLinkValue(huge)) {
+            pass = false; err += "oversized value accepted; ";
+        }
+
+        TestFramework::RecordTest("Early Hints: FormatLinkValue / IsValidLinkValue",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: FormatLinkValue / IsValidLinkValue",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestBuildAndFilterHeaders() {
+    std::cout << "\n[TEST] Early Hints: BuildHeaders / FilterRelayableHeaders..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        auto built = HTTP_EARLY_HINTS_NAMESPACE::BuildHeaders(
+            {"</a.css>; rel=preload; as=style", "garbage", "</b.js>; rel=preload; as=script"});
+        if (built.size() != 2 || built[0].first != "Link" ||
+            built[1].second != "</b.js>; rel=preload; as=script") {
+            pass = false; err += "BuildHeaders size=" + std::to_string(built.size()) + "; ";
+        }
+
+        std::vector<std::pair<std::string, std::string>> upstream = {
+            {"link", "</a.css>; rel=preload; as=style"},
+            {"set-cookie", "session=secret"},
+            {"LINK", "</b.js>; rel=preload; as=script"},
+            {"link", "not-a-link"},
+            {"x-internal", "1"},
+        };
+        auto relay = HTTP_EARLY_HINTS_NAMESPACE::FilterRelayableHeaders(upstream);
+        if (relay.size() != 2) {
+            pass = false; err += "relay size=" + std::to_string(relay.size()) + "; ";
+        }
+        for (const auto& [name, value] : relay) {
+            if (name != "Link") { pass = false; err += "non-Link relayed: " + name + "; "; }
+        }
+
+        TestFramework::RecordTest("Early Hints: BuildHeaders / FilterRelayableHeaders",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: BuildHeaders / FilterRelayableHeaders",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Async route with a declared 103 and a short delay before completing, so
+// the hint is useful and observable. Shared by T3 and T4.
+inline void RegisterHintedRoute(HttpServer& server) {
+    http::RouteOptions opts;
+    opts.early_hints = {"</hinted.css>; rel=preload; as=style"};
+    server.RouteAsync("GET", "/hinted",
+        [](const HttpRequest&,
+           HTTP_CALLBACKS_NAMESPACE::InterimResponseSender /*send_interim*/,
+           HTTP_CALLBACKS_NAMESPACE::ResourcePusher /*push_resource*/,
+           HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender /*stream_sender*/,
+           HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+            HttpResponse r;
+            r.Status(200).Text("page");
+            complete(std::move(r));
+        },
+        std::move(opts));
+}
+
+// T3
+void TestRouteOptionEmits103() {
+    std::cout << "\n[TEST] Early Hints: route option emits 103 before 200..." << std::endl;
+    try {
+        HttpServer server("127.0.0.1", 0);
+        RegisterHintedRoute(server);
+        TestServerRunner<HttpServer> runner(server);
+
+        std::string resp = Exchange(runner.GetPort(),
+            "GET /hinted HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n");
+
+        std::string err;
+        bool pass = Check103Before(resp, "HTTP/1.1 200",
+                                   "</hinted.css>; rel=preload; as=style", err);
+        TestFramework::RecordTest("Early Hints: route option emits 103 before 200",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: route option emits 103 before 200",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestHttp10ClientGetsNo103() {
+    std::cout << "\n[TEST] Early Hints: HTTP/1.0 client gets no 103..." << std::endl;
+    try {
+        HttpServer server("127.0.0.1", 0);
+        RegisterHintedRoute(server);
+        TestServerRunner<HttpServer> runner(server);
+
+        std::string resp = Exchange(runner.GetPort(),
+            "GET /hinted HTTP/1.0\r\nHost: x\r\n\r\n");
+
+        bool pass = true;
+        std::string err;
+        if (resp.find(" 103 ") != std::string::npos) {
+            pass = false; err += "103 sent to HTTP/1.0 client; ";
+        }
+        if (resp.find(" 200 ") == std::string::npos) {
+            pass = false; err += "missing 200; ";
+        }
+        TestFramework::RecordTest("Early Hints: HTTP/1.0 client gets no 103",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: HTTP/1.0 client gets no 103",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestSendFromAsyncHandler() {
+    std::cout << "\n[TEST] Early Hints: Send() from async handler..." << std::endl;
+    try {
+        HttpServer server("127.0.0.1", 0);
+        server.GetAsync("/manual",
+            [](const HttpRequest&,
+               HTTP_CALLBACKS_NAMESPACE::InterimResponseSender send_interim,
+               HTTP_CALLBACKS_NAMESPACE::ResourcePusher /*push_resource*/,
+               HTTP_CALLBACKS_NAMESPACE::StreamingResponseSender /*stream_sender*/,
+               HTTP_CALLBACKS_NAMESPACE::AsyncCompletionCallback complete) {
+                HTTP_EARLY_HINTS_NAMESPACE::PreloadLink link;
+                link.uri = "/m.js";
+                link.as = "script";
+                HTTP_EARLY_HINTS_NAMESPACE::Send(
+                    send_interim, {HTTP_EARLY_HINTS_NAMESPACE::FormatLinkValue(link)});
+                HttpResponse r;
+                r.Status(200).Text("ok");
+                complete(std::move(r));
+            });
+        TestServerRunner<HttpServer> runner(server);
+
+        std::string resp = Exchange(runner.GetPort(),
+            "GET /manual HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n");
+
+        std::string err;
+        bool pass = Check103Before(resp, "HTTP/1.1 200",
+                                   "</m.js>; rel=preload; as=script", err);
+        TestFramework::RecordTest("Early Hints: Send() from async handler",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: Send() from async handler",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Backend that answers with an interim 103 (one Link, one field that must
+// never be relayed), pauses, then sends the final 200.
+inline ProxyTests::RawHttpBackendServer::SessionHandler Upstream103Session() {
+    return [](int fd, const std::string&) {
+        ProxyTests::SendAll(fd,
+            "HTTP/1.1 103 Early Hints\r\n"
+            "Link: </up.css>; rel=preload; as=style\r\n"
+            "X-Secret: internal\r\n"
+            "\r\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        ProxyTests::SendAll(fd,
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 2\r\n"
+            "Content-Type: text/plain\r\n"
+            "\r\n"
+            "ok");
+    };
+}
+
+inline ServerConfig MakeGatewayConfig(const UpstreamConfig& u) {
+    ServerConfig gw_config;
+    gw_config.bind_host = "127.0.0.1";
+    gw_config.bind_port = 0;
+    gw_config.worker_threads = 1;
+    gw_config.http2.enabled = false;
+    gw_config.upstreams.push_back(u);
+    return gw_config;
+}
+
+// T6
+void TestProxyRelaysUpstream103() {
+    std::cout << "\n[TEST] Early Hints: proxy relays upstream 103..." << std::endl;
+    try {
+        ProxyTests::RawHttpBackendServer backend(Upstream103Session());
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "backend", "127.0.0.1", backend.GetPort(), "/relay");
+        u.proxy.relay_early_hints = true;
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Exchange(gw_runner.GetPort(),
+            "GET /relay HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+        std::string err;
+        bool pass = Check103Before(resp, "HTTP/1.1 200",
+                                   "</up.css>; rel=preload; as=style", err);
+        if (resp.find("X-Secret") != std::string::npos ||
+            resp.find("x-secret") != std::string::npos) {
+            pass = false; err += "non-Link interim field relayed; ";
+        }
+        TestFramework::RecordTest("Early Hints: proxy relays upstream 103",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: proxy relays upstream 103",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T7
+void TestProxyDropsUpstream103ByDefault() {
+    std::cout << "\n[TEST] Early Hints: proxy drops upstream 103 by default..." << std::endl;
+    try {
+        ProxyTests::RawHttpBackendServer backend(Upstream103Session());
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "backend", "127.0.0.1", backend.GetPort(), "/relay");
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Exchange(gw_runner.GetPort(),
+            "GET /relay HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+        bool pass = true;
+        std::string err;
+        if (resp.find("HTTP/1.1 103") != std::string::npos) {
+            pass = false; err += "103 relayed without relay_early_hints; ";
+        }
+        if (resp.find("HTTP/1.1 200") == std::string::npos) {
+            pass = false; err += "missing 200; ";
+        }
+        TestFramework::RecordTest("Early Hints: proxy drops upstream 103 by default",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: proxy drops upstream 103 by default",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T8
+void TestProxyConfiguredHints() {
+    std::cout << "\n[TEST] Early Hints: proxy.early_hints emits 103..." << std::endl;
+    try {
+        ProxyTests::RawHttpBackendServer backend([](int fd, const std::string&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            ProxyTests::SendAll(fd,
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 2\r\n"
+                "\r\n"
+                "ok");
+        });
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "backend", "127.0.0.1", backend.GetPort(), "/static");
+        u.proxy.early_hints = {"</cfg.js>; rel=preload; as=script"};
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Exchange(gw_runner.GetPort(),
+            "GET /static HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+        std::string err;
+        bool pass = Check103Before(resp, "HTTP/1.1 200",
+                                   "</cfg.js>; rel=preload; as=script", err);
+        TestFramework::RecordTest("Early Hints: proxy.early_hints emits 103",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: proxy.early_hints emits 103",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T9
+void TestConfigRoundTripAndValidation() {
+    std::cout << "\n[TEST] Early Hints: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        const std::string json = R"({
+            "upstreams": [{
+                "name": "web",
+                "host": "127.0.0.1",
+                "port": 9000,
+                "proxy": {
+                    "route_prefix": "/web",
+                    "early_hints": ["</web.css>; rel=preload; as=style"],
+                    "relay_early_hints": true
+                }
+            }]
+        })";
+        ServerConfig cfg = ConfigLoader::LoadFromString(json);
+        ConfigLoader::Validate(cfg);
+        const auto& p = cfg.upstreams.at(0).proxy;
+        if (p.early_hints.size() != 1 || !p.relay_early_hints) {
+            pass = false; err += "fields not loaded; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (!(again.upstreams.at(0).proxy == p)) {
+            pass = false; err += "ToJson round-trip mismatch; ";
+        }
+
+        cfg.upstreams[0].proxy.early_hints = {"/web.css; rel=preload"};
+        bool threw = false;
+        try {
+            ConfigLoader::Validate(cfg);
+        } catch (const std::invalid_argument& e) {
+            threw = std::string(e.what()).find("early_hints") != std::string::npos;
+        }
+        if (!threw) { pass = false; err += "invalid Link value accepted; "; }
+
+        threw = false;
+        try {
+            ConfigLoader::LoadFromString(R"({"upstreams": [{"name": "w",
+                "host": "127.0.0.1", "port": 1,
+                "proxy": {"early_hints": "</a>"}}]})");
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) { pass = false; err += "non-array early_hints accepted; "; }
+
+        TestFramework::RecordTest("Early Hints: config round-trip and validation",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Early Hints: config round-trip and validation",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n===== 103 Early Hints Tests =====" << std::endl;
+    TestFormatAndValidate();
+    TestBuildAndFilterHeaders();
+    TestRouteOptionEmits103();
+    TestHttp10ClientGetsNo103();
+    TestSendFromAsyncHandler();
+    TestProxyRelaysUpstream103();
+    TestProxyDropsUpstream103ByDefault();
+    TestProxyConfiguredHints();
+    TestConfigRoundTripAndValidation();
+}
+
+}  // namespace EarlyHintsTests
@@ -0,0 +1,489 @@
+#pragma once
+
+// grpc_test.h — gRPC mode for proxy routes (ProxyConfig::grpc).
+//
+// Test dimensions:
+//   Unit (in-process, no sockets):
+//     T1  grpc-timeout parse / format, status names, status sets,
+//         content-type and path helpers
+//     T2  MessageFramer: split prefixes, oversize cap, bad flag (sticky)
+//     T3  RetryPolicy GRPC_STATUS bypasses the idempotency gate;
+//         GrpcStatusForResult / MakeGrpcErrorResponse contract
+//   Integration (real HttpServer backend + gateway, raw H1 client):
+//     T4  Trailers-only grpc-status in retry_on is retried; the client
+//         sees the second attempt's status
+//     T5  grpc-timeout bounds the upstream wait, is re-emitted upstream,
+//         and a timeout surfaces as grpc-status 4 (not HTTP 504)
+//     T6  Request message above max_message_bytes is rejected locally
+//         with grpc-status 8; the upstream is never contacted
+//   Config:
+//     T7  proxy.grpc JSON round-trip; unknown status name rejected by
+//         Validate; non-array retry_on rejected by the loader
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "proxy_test.h"  // MakeProxyUpstreamConfig, SendAll, RecvUntilClose
+#include "http/http_server.h"
+#include "upstream/grpc.h"
+#include "upstream/proxy_transaction.h"
+#include "upstream/retry_policy.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+
+namespace GrpcTests {
+
+// One framed message: flag 0, big-endian length, payload.
+inline std::string Frame(const std::string& payload) {
+    std::string out(5, '\0');
+    uint32_t n = static_cast<uint32_t>(payload.size());
+    out[1] = static_cast<char>((n >> 24) & 0xff);
+    out[2] = static_cast<char>((n >> 16) & 0xff);
+    out[3] = static_cast<char>((n >> 8) & 0xff);
+    out[4] = static_cast<char>(n & 0xff);
+    return out + payload;
+}
+
+inline std::string GrpcPost(const std::string& path, const std::string& body,
+                            const std::string& extra_headers = "") {
+    return "POST " + path + " HTTP/1.1\r\n"
+           "Host: localhost\r\n"
+           "Content-Type: application/grpc\r\n"
+           "TE: trailers\r\n" + extra_headers +
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: close\r\n\r\n" + body;
+}
+
+// Send `request` on a fresh connection, read until close, lowercase.
+inline std::string Exchange(int port, const std::string& request,
+                            int timeout_ms = 3000) {
+    int fd = TestHttpClient::ConnectRawSocket(port);
+    if (fd < 0) return "";
+    if (!ProxyTests::SendAll(fd, request)) {
+        close(fd);
+        return "";
+    }
+    std::string out = ProxyTests::RecvUntilClose(fd, timeout_ms);
+    close(fd);
+    for (auto& c : out) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return out;
+}
+
+inline ServerConfig MakeGatewayConfig(const UpstreamConfig& u) {
+    ServerConfig gw_config;
+    gw_config.bind_host = "127.0.0.1";
+    gw_config.bind_port = 0;
+    gw_config.worker_threads = 1;
+    gw_config.http2.enabled = false;
+    gw_config.upstreams.push_back(u);
+    return gw_config;
+}
+
+// T1
+void TestHelpers() {
+    std::cout << "\n[TEST] gRPC: timeout / status / path helpers..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        using namespace GRPC_NAMESPACE;
+
+        if (ParseTimeoutMs("250m") != std::optional<int64_t>(250)) { pass = false; err += "250m; "; }
+        if (ParseTimeoutMs("2S") != std::optional<int64_t>(2000)) { pass = false; err += "2S; "; }
+        if (ParseTimeoutMs("1H") != std::optional<int64_t>(3600000)) { pass = false; err += "1H; "; }
+        if (ParseTimeoutMs("1500u") != std::optional<int64_t>(2)) { pass = false; err += "1500u rounds up; "; }
+        if (ParseTimeoutMs("1n") != std::optional<int64_t>(1)) { pass = false; err += "1n rounds up; "; }
+        if (ParseTimeoutMs("123456789m")) { pass = false; err += "9 digits accepted; "; }
+        if (ParseTimeoutMs("10x") || ParseTimeoutMs("m") || ParseTimeoutMs("-1S")) {
+            pass = false; err += "malformed accepted; ";
+        }
+        if (FormatTimeout(250) != "250m") { pass = false; err += "format 250m; "; }
+        if (FormatTimeout(100000000) != "100000S") { pass = false; err += "format unit step; "; }
+        if (ParseTimeoutMs(FormatTimeout(7)) != std::optional<int64_t>(7)) {
+            pass = false; err += "format/parse round-trip; ";
+        }
+
+        if (ParseStatusName("unavailable") != UNAVAILABLE ||
+            ParseStatusName("resource-exhausted") != RESOURCE_EXHAUSTED ||
+            ParseStatusName("UNAVAILABLE") != -1) {
+            pass = false; err += "ParseStatusName; ";
+        }
+        if (std::string(StatusName(DEADLINE_EXCEEDED)) != "deadline-exceeded" ||
+            std::string(StatusName(99)) != "") {
+            pass = false; err += "StatusName; ";
+        }
+        StatusSet set = MakeStatusSet({"unavailable", "aborted"});
+        if (!Contains(set, UNAVAILABLE) || !Contains(set, ABORTED) ||
+            Contains(set, OK) || Contains(set, 40)) {
+            pass = false; err += "StatusSet; ";
+        }
+        if (ParseStatus("14") != std::optional<int>(14) || ParseStatus("") ||
+            ParseStatus("1a")) {
+            pass = false; err += "ParseStatus; ";
+        }
+        if (FindStatus({{"Grpc-Status", "5"}}) != std::optional<int>(5) ||
+            FindStatus({{"grpc-message", "x"}})) {
+            pass = false; err += "FindStatus; ";
+        }
+
+        if (!IsGrpcContentType("application/grpc") ||
+            !IsGrpcContentType("Application/GRPC+proto") ||
+            !IsGrpcContentType("application/grpc;charset=utf-8") ||
+            IsGrpcContentType("application/grpc-web") ||
+            IsGrpcContentType("application/json")) {
+            pass = false; err += "IsGrpcContentType; ";
+        }
+
+        std::string service, method;
+        if (!SplitMethodPath("/pkg.Greeter/SayHello", service, method) ||
+            service != "pkg.Greeter" || method != "SayHello") {
+            pass = false; err += "SplitMethodPath valid; ";
+        }
+        if (SplitMethodPath("/a/b/c", service, method) ||
+            SplitMethodPath("/only", service, method) ||
+            SplitMethodPath("//m", service, method)) {
+            pass = false; err += "SplitMethodPath accepted non-RPC path; ";
+        }
+
+        TestFramework::RecordTest("gRPC: timeout / status / path helpers",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: timeout / status / path helpers",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestMessageFramer() {
+    std::cout << "\n[TEST] gRPC: MessageFramer..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        using Framer = GRPC_NAMESPACE::MessageFramer;
+
+        // Two messages fed one byte at a time, plus an empty message.
+        std::string wire = Frame("hello") + Frame("") + Frame("world!");
+        Framer f;
+        for (char c : wire) {
+            if (f.Feed(&c, 1) != Framer::Result::OK) { pass = false; err += "split feed; "; break; }
+        }
+        if (f.messages() != 3 || !f.AtBoundary()) { pass = false; err += "count/boundary; "; }
+
+        Framer partial;
+        std::string half = Frame("abcdef").substr(0, 7);
+        partial.Feed(half.data(), half.size());
+        if (partial.AtBoundary() || partial.messages() != 0) {
+            pass = false; err += "partial reported complete; ";
+        }
+
+        Framer capped(4);
+        std::string big = Frame("12345");
+        if (capped.Feed(big.data(), big.size()) != Framer::Result::OVERSIZE) {
+            pass = false; err += "oversize not detected; ";
+        }
+        std::string ok = Frame("1");
+        if (capped.Feed(ok.data(), ok.size()) != Framer::Result::OVERSIZE) {
+            pass = false; err += "error not sticky; ";
+        }
+
+        Framer flag;
+        std::string bad = Frame("x");
+        bad[0] = 2;
+        if (flag.Feed(bad.data(), bad.size()) != Framer::Result::BAD_FLAG) {
+            pass = false; err += "bad flag not detected; ";
+        }
+
+        TestFramework::RecordTest("gRPC: MessageFramer",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: MessageFramer",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T3
+void TestRetryConditionAndErrorMapping() {
+    std::cout << "\n[TEST] gRPC: GRPC_STATUS retry condition + error mapping..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        RetryPolicy::Config rc;
+        rc.max_retries = 2;
+        rc.retry_on_grpc_status = true;
+        RetryPolicy policy(rc);
+        using Cond = RetryPolicy::RetryCondition;
+        if (!policy.ShouldRetry(0, "POST", Cond::GRPC_STATUS, false)) {
+            pass = false; err += "POST gRPC status not retried; ";
+        }
+        if (policy.ShouldRetry(0, "POST", Cond::RESPONSE_5XX, false)) {
+            pass = false; err += "5xx retried without retry_on_5xx; ";
+        }
+        if (policy.ShouldRetry(2, "POST", Cond::GRPC_STATUS, false) ||
+            policy.ShouldRetry(0, "POST", Cond::GRPC_STATUS, true)) {
+            pass = false; err += "max_retries / headers_sent gate bypassed; ";
+        }
+        RetryPolicy off(RetryPolicy::Config{2});
+        if (off.ShouldRetry(0, "POST", Cond::GRPC_STATUS, false)) {
+            pass = false; err += "retried without retry_on_grpc_status; ";
+        }
+
+        if (ProxyTransaction::GrpcStatusForResult(
+                ProxyTransaction::RESULT_RESPONSE_TIMEOUT) != GRPC_NAMESPACE::DEADLINE_EXCEEDED ||
+            ProxyTransaction::GrpcStatusForResult(
+                ProxyTransaction::RESULT_RESPONSE_TOO_LARGE) != GRPC_NAMESPACE::RESOURCE_EXHAUSTED ||
+            ProxyTransaction::GrpcStatusForResult(
+                ProxyTransaction::RESULT_CHECKOUT_FAILED) != GRPC_NAMESPACE::UNAVAILABLE ||
+            ProxyTransaction::GrpcStatusForResult(
+                ProxyTransaction::RESULT_PARSE_ERROR) != GRPC_NAMESPACE::INTERNAL) {
+            pass = false; err += "GrpcStatusForResult; ";
+        }
+
+        HttpResponse resp = ProxyTransaction::MakeGrpcErrorResponse(
+            GRPC_NAMESPACE::UNAVAILABLE, "proxy: 502 Bad Gateway");
+        bool has_status = false, has_ct = false;
+        for (const auto& [k, v] : resp.GetHeaders()) {
+            if (k == "grpc-status" && v == "14") has_status = true;
+            if (k == "Content-Type" && v == "application/grpc") has_ct = true;
+        }
+        if (resp.GetStatusCode() != 200 || !has_status || !has_ct ||
+            !resp.GetBody().empty()) {
+            pass = false; err += "MakeGrpcErrorResponse shape; ";
+        }
+
+        TestFramework::RecordTest("gRPC: GRPC_STATUS retry condition + error mapping",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: GRPC_STATUS retry condition + error mapping",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestTrailersOnlyStatusRetried() {
+    std::cout << "\n[TEST] gRPC: trailers-only retry_on status is retried..." << std::endl;
+    try {
+        std::atomic<int> calls{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Post("/pkg.Svc/Call", [&calls](const HttpRequest&, HttpResponse& resp) {
+            int n = ++calls;
+            resp.Status(200)
+                .Header("Content-Type", "application/grpc")
+                .Header("grpc-status", n == 1 ? "14" : "0");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "grpc", "127.0.0.1", backend_runner.GetPort(), "/pkg.Svc/Call");
+        u.proxy.retry.max_retries = 1;
+        // Unary call: buffer the request so the retry can replay it.
+        u.request_mode = http::RouteRequestMode::Buffered;
+        u.proxy.grpc.enabled = true;
+        u.proxy.grpc.retry_on = {"unavailable"};
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Exchange(gw_runner.GetPort(),
+                                    GrpcPost("/pkg.Svc/Call", Frame("req")));
+
+        bool pass = true;
+        std::string err;
+        if (calls.load() != 2) {
+            pass = false; err += "calls=" + std::to_string(calls.load()) + "; ";
+        }
+        if (resp.find("grpc-status: 0") == std::string::npos) {
+            pass = false; err += "final status not 0; ";
+        }
+        TestFramework::RecordTest("gRPC: trailers-only retry_on status is retried",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: trailers-only retry_on status is retried",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestTimeoutPropagatedAndMapped() {
+    std::cout << "\n[TEST] gRPC: grpc-timeout propagated and mapped..." << std::endl;
+    try {
+        std::mutex mu;
+        std::string seen_timeout;
+        HttpServer backend("127.0.0.1", 0);
+        backend.Post("/pkg.Svc/Slow", [&](const HttpRequest& req, HttpResponse& resp) {
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                auto it = req.headers.find("grpc-timeout");
+                if (it != req.headers.end()) seen_timeout = it->second;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+            resp.Status(200)
+                .Header("Content-Type", "application/grpc")
+                .Header("grpc-status", "0");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "grpc", "127.0.0.1", backend_runner.GetPort(), "/pkg.Svc/Slow");
+        u.proxy.grpc.enabled = true;
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        auto start = std::chrono::steady_clock::now();
+        std::string resp = Exchange(gw_runner.GetPort(),
+                                    GrpcPost("/pkg.Svc/Slow", Frame("req"),
+                                             "grpc-timeout: 300m\r\n"), 5000);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        bool pass = true;
+        std::string err;
+        if (resp.find("http/1.1 200") == std::string::npos ||
+            resp.find("grpc-status: 4") == std::string::npos) {
+            pass = false; err += "expected trailers-only DEADLINE_EXCEEDED; ";
+        }
+        // The gateway's timer sweep is coarse; anything well short of the
+        // backend's 2.5s stall proves the client deadline won.
+        if (elapsed.count() >= 2000) {
+            pass = false; err += "deadline not enforced (" +
+                std::to_string(elapsed.count()) + "ms); ";
+        }
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            auto ms = GRPC_NAMESPACE::ParseTimeoutMs(seen_timeout);
+            if (!ms || *ms > 300 || *ms <= 0) {
+                pass = false; err += "upstream grpc-timeout='" + seen_timeout + "'; ";
+            }
+        }
+        TestFramework::RecordTest("gRPC: grpc-timeout propagated and mapped",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: grpc-timeout propagated and mapped",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T6
+void TestOversizeRequestMessageRejected() {
+    std::cout << "\n[TEST] gRPC: oversize request message rejected..." << std::endl;
+    try {
+        std::atomic<int> calls{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Post("/pkg.Svc/Put", [&calls](const HttpRequest&, HttpResponse& resp) {
+            ++calls;
+            resp.Status(200).Header("grpc-status", "0");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+            "grpc", "127.0.0.1", backend_runner.GetPort(), "/pkg.Svc/Put");
+        // Framing is validated on buffered request bodies only.
+        u.request_mode = http::RouteRequestMode::Buffered;
+        u.proxy.grpc.enabled = true;
+        u.proxy.grpc.max_message_bytes = 4;
+
+        HttpServer gateway(MakeGatewayConfig(u));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Exchange(gw_runner.GetPort(),
+                                    GrpcPost("/pkg.Svc/Put", Frame("0123456789")));
+
+        bool pass = true;
+        std::string err;
+        if (resp.find("grpc-status: 8") == std::string::npos) {
+            pass = false; err += "expected RESOURCE_EXHAUSTED; ";
+        }
+        if (calls.load() != 0) { pass = false; err += "upstream contacted; "; }
+        TestFramework::RecordTest("gRPC: oversize request message rejected",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: oversize request message rejected",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T7
+void TestConfigRoundTripAndValidation() {
+    std::cout << "\n[TEST] gRPC: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        const std::string json = R"({
+            "upstreams": [{
+                "name": "rpc",
+                "host": "127.0.0.1",
+                "port": 9000,
+                "proxy": {
+                    "route_prefix": "/pkg.Svc",
+                    "grpc": {
+                        "enabled": true,
+                        "retry_on": ["unavailable", "resource-exhausted"],
+                        "breaker_failure_on": ["unavailable"],
+                        "propagate_timeout": false,
+                        "max_timeout_ms": 30000,
+                        "max_message_bytes": 4194304,
+                        "method_histograms": false
+                    }
+                }
+            }]
+        })";
+        ServerConfig cfg = ConfigLoader::LoadFromString(json);
+        ConfigLoader::Validate(cfg);
+        const auto& g = cfg.upstreams.at(0).proxy.grpc;
+        if (!g.enabled || g.retry_on.size() != 2 || g.breaker_failure_on.size() != 1 ||
+            g.propagate_timeout || g.max_timeout_ms != 30000 ||
+            g.max_message_bytes != 4194304 || g.method_histograms) {
+            pass = false; err += "fields not loaded; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (!(again.upstreams.at(0).proxy == cfg.upstreams.at(0).proxy)) {
+            pass = false; err += "ToJson round-trip mismatch; ";
+        }
+
+        cfg.upstreams[0].proxy.grpc.retry_on = {"Unavailable"};
+        bool threw = false;
+        try {
+            ConfigLoader::Validate(cfg);
+        } catch (const std::invalid_argument& e) {
+            threw = std::string(e.what()).find("proxy.grpc") != std::string::npos;
+        }
+        if (!threw) { pass = false; err += "unknown status name accepted; "; }
+
+        threw = false;
+        try {
+            ConfigLoader::LoadFromString(R"({"upstreams": [{"name": "r",
+                "host": "127.0.0.1", "port": 1,
+                "proxy": {"grpc": {"retry_on": "unavailable"}}}]})");
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        if (!threw) { pass = false; err += "non-array retry_on accepted; "; }
+
+        TestFramework::RecordTest("gRPC: config round-trip and validation",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("gRPC: config round-trip and validation",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n===== gRPC Proxy Mode Tests =====" << std::endl;
+    TestHelpers();
+    TestMessageFramer();
+    TestRetryConditionAndErrorMapping();
+    TestTrailersOnlyStatusRetried();
+    TestTimeoutPropagatedAndMapped();
+    TestOversizeRequestMessageRejected();
+    TestConfigRoundTripAndValidation();
+}
+
+}  // namespace GrpcTests
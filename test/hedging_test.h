@@ -0,0 +1,280 @@
+#pragma once
+
+// hedging_test.h — hedged proxy requests (proxy.retry.hedge).
+//
+// Test dimensions:
+//   Unit (HedgePolicy in-process, no sockets):
+//     T1  Eligible: bodiless GET/HEAD/OPTIONS only
+//     T2  Delay: fixed delay_ms until enough samples, then the
+//         configured percentile of recorded latencies
+//   Integration (backend behind a hedging gateway):
+//     T3  A slow primary is overtaken by the hedge; the client gets the
+//         hedge's response well before the primary would have answered
+//     T4  A response faster than the hedge delay sends no hedge
+//   Config:
+//     T5  proxy.retry.hedge JSON round-trip and validation
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "proxy_test.h"  // MakeProxyUpstreamConfig
+#include "http/http_server.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "upstream/hedged_request.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace HedgingTests {
+
+// T1
+void TestEligible() {
+    std::cout << "\n[TEST] Hedging: eligible requests..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        auto make = [](const std::string& method,
+                       std::map<std::string, std::string> headers = {}) {
+            HttpRequest req;
+            req.method = method;
+            req.path = "/a";
+            req.headers = std::move(headers);
+            return req;
+        };
+        for (const char* m : {"GET", "HEAD", "OPTIONS"}) {
+            if (!HedgePolicy::Eligible(make(m))) {
+                pass = false; err += std::string(m) + " not eligible; ";
+            }
+        }
+        for (const char* m : {"POST", "PUT", "DELETE", "PATCH"}) {
+            if (HedgePolicy::Eligible(make(m))) {
+                pass = false; err += std::string(m) + " eligible; ";
+            }
+        }
+        if (!HedgePolicy::Eligible(make("GET", {{"content-length", "0"}}))) {
+            pass = false; err += "GET with Content-Length: 0 not eligible; ";
+        }
+        if (HedgePolicy::Eligible(make("GET", {{"content-length", "4"}}))) {
+            pass = false; err += "GET with body eligible; ";
+        }
+        if (HedgePolicy::Eligible(make("GET", {{"transfer-encoding", "chunked"}}))) {
+            pass = false; err += "chunked GET eligible; ";
+        }
+        TestFramework::RecordTest("Hedging: eligible requests", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Hedging: eligible requests", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestDelay() {
+    std::cout << "\n[TEST] Hedging: fixed and percentile delay..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ProxyHedgeConfig fixed;
+        fixed.enabled = true;
+        fixed.delay_ms = 75;
+        HedgePolicy fixed_policy(fixed);
+        for (int i = 0; i < 100; ++i) {
+            fixed_policy.RecordLatency(std::chrono::milliseconds(5));
+        }
+        if (fixed_policy.Delay() != std::chrono::milliseconds(75)) {
+            pass = false; err += "fixed delay moved with samples; ";
+        }
+
+        ProxyHedgeConfig dynamic = fixed;
+        dynamic.percentile = 90;
+        HedgePolicy policy(dynamic);
+        if (policy.Delay() != std::chrono::milliseconds(75)) {
+            pass = false; err += "no fallback to delay_ms before samples; ";
+        }
+        // 90% of requests at 10ms, the slowest 10% at 200ms: p90 is the
+        // boundary, so the hedge fires after the fast majority.
+        for (int i = 0; i < 64; ++i) {
+            policy.RecordLatency(std::chrono::milliseconds(i % 10 == 9 ? 200 : 10));
+        }
+        auto d = policy.Delay().count();
+        if (d < 10 || d > 200) {
+            pass = false; err += "p90 delay=" + std::to_string(d) + "ms; ";
+        }
+        for (int i = 0; i < 256; ++i) {
+            policy.RecordLatency(std::chrono::microseconds(20500));
+        }
+        if (policy.Delay() != std::chrono::milliseconds(21)) {
+            pass = false;
+            err += "steady delay=" + std::to_string(policy.Delay().count()) + "ms; ";
+        }
+        TestFramework::RecordTest("Hedging: fixed and percentile delay", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Hedging: fixed and percentile delay", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+inline ServerConfig HedgingGatewayConfig(int backend_port, const std::string& prefix,
+                                         int delay_ms) {
+    UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+        "backend", "127.0.0.1", backend_port, prefix);
+    u.proxy.retry.hedge.enabled = true;
+    u.proxy.retry.hedge.delay_ms = delay_ms;
+    ServerConfig gw;
+    gw.bind_host = "127.0.0.1";
+    gw.bind_port = 0;
+    gw.worker_threads = 1;
+    gw.http2.enabled = false;
+    gw.upstreams.push_back(u);
+    return gw;
+}
+
+// Backend with enough workers that a sleeping handler does not hold up
+// the hedge behind it.
+inline ServerConfig BackendConfig() {
+    ServerConfig cfg;
+    cfg.bind_host = "127.0.0.1";
+    cfg.bind_port = 0;
+    cfg.worker_threads = 4;
+    cfg.http2.enabled = false;
+    return cfg;
+}
+
+inline std::string Get(int port, const std::string& path) {
+    return TestHttpClient::SendHttpRequest(port,
+        "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n",
+        5000);
+}
+
+// T3
+void TestIntegrationHedgeWins() {
+    std::cout << "\n[TEST] Hedging: hedge overtakes a slow primary..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend(BackendConfig());
+        backend.Get("/tail", [&](const HttpRequest&, HttpResponse& resp) {
+            int n = ++hits;
+            if (n == 1) std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+            resp.Status(200).Body("attempt" + std::to_string(n), "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(HedgingGatewayConfig(backend_runner.GetPort(), "/tail", 100));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        auto start = std::chrono::steady_clock::now();
+        std::string resp = Get(gw_runner.GetPort(), "/tail");
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        bool pass = true;
+        std::string err;
+        if (!TestHttpClient::HasStatus(resp, 200) ||
+            TestHttpClient::ExtractBody(resp) != "attempt2") {
+            pass = false; err += "client got '" + resp + "'; ";
+        }
+        if (elapsed >= 1000) {
+            pass = false; err += "answered after " + std::to_string(elapsed) + "ms; ";
+        }
+        if (hits.load() != 2) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("Hedging: hedge overtakes a slow primary", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Hedging: hedge overtakes a slow primary", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestIntegrationNoHedgeWhenFast() {
+    std::cout << "\n[TEST] Hedging: fast response sends no hedge..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend(BackendConfig());
+        backend.Get("/fast", [&](const HttpRequest&, HttpResponse& resp) {
+            ++hits;
+            resp.Status(200).Body("fast", "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(HedgingGatewayConfig(backend_runner.GetPort(), "/fast", 500));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        bool pass = true;
+        std::string err;
+        for (int i = 0; i < 3; ++i) {
+            std::string body = TestHttpClient::ExtractBody(Get(port, "/fast"));
+            if (body != "fast") { pass = false; err += "client got '" + body + "'; "; }
+        }
+        // Give a wrongly armed hedge time to reach the backend.
+        std::this_thread::sleep_for(std::chrono::milliseconds(700));
+        if (hits.load() != 3) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("Hedging: fast response sends no hedge", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Hedging: fast response sends no hedge", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestConfig() {
+    std::cout << "\n[TEST] Hedging: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                           "proxy": {"route_prefix": "/svc",
+                                     "retry": {"hedge": {"enabled": true,
+                                                         "delay_ms": 40,
+                                                         "percentile": 95}}}}]
+        })");
+        ConfigLoader::Validate(cfg);
+        const auto& hedge = cfg.upstreams[0].proxy.retry.hedge;
+        if (!hedge.enabled || hedge.delay_ms != 40 || hedge.percentile != 95) {
+            pass = false; err += "parse mismatch; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (!(again.upstreams[0].proxy == cfg.upstreams[0].proxy)) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+
+        auto expect_invalid = [&](int delay_ms, int percentile, const char* field) {
+            ServerConfig bad = cfg;
+            bad.upstreams[0].proxy.retry.hedge.delay_ms = delay_ms;
+            bad.upstreams[0].proxy.retry.hedge.percentile = percentile;
+            try {
+                ConfigLoader::Validate(bad);
+                pass = false; err += std::string(field) + " accepted; ";
+            } catch (const std::invalid_argument& e) {
+                if (std::string(e.what()).find(field) == std::string::npos) {
+                    pass = false; err += std::string("wrong error: ") + e.what() + "; ";
+                }
+            }
+        };
+        expect_invalid(0, 95, "delay_ms");
+        expect_invalid(40, 40, "percentile");
+        expect_invalid(40, 100, "percentile");
+        TestFramework::RecordTest("Hedging: config round-trip and validation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Hedging: config round-trip and validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== Proxy Hedging Tests ===" << std::endl;
+    TestEligible();
+    TestDelay();
+    TestIntegrationHedgeWins();
+    TestIntegrationNoHedgeWhenFast();
+    TestConfig();
+}
+
+}  // namespace HedgingTests
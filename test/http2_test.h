@@ -1121,6 +1121,7 @@ void TestH2ConfigSerialization() {
         cfg.http2.max_frame_size         = 32768;
         cfg.http2.max_header_list_size   = 16384;
         cfg.http2.enable_push            = true;
+        cfg.http2.write_batching         = false;
 
         std::string json = ConfigLoader::ToJson(cfg);
 
@@ -1164,6 +1165,9 @@ void TestH2ConfigSerialization() {
         if (!cfg2.http2.enable_push) {
             pass = false; err += "round-trip enable_push mismatch; ";
         }
+        if (cfg2.http2.write_batching) {
+            pass = false; err += "round-trip write_batching mismatch; ";
+        }
 
         TestFramework::RecordTest("H2 Config: Serialization", pass, err,
                                   TestFramework::TestCategory::OTHER);
@@ -1594,6 +1598,96 @@ void TestStreamInvalidHeaders() {
     }
 }
 
+// ClassifyHeaderName maps the names the ingestion path branches on to
+// tokens and leaves everything else (including near-misses) as OTHER.
+void TestStreamHeaderTokenClassification() {
+    std::cout << "\n[TEST] Http2Stream: header name token classification..." << std::endl;
+    using T = Http2Stream::HeaderToken;
+    bool pass = true;
+    std::string err;
+    const std::vector<std::pair<std::string, T>> cases = {
+        {":method", T::METHOD}, {":path", T::PATH}, {":scheme", T::SCHEME},
+        {":authority", T::AUTHORITY}, {"host", T::HOST}, {"cookie", T::COOKIE},
+        {"te", T::TE}, {"content-length", T::CONTENT_LENGTH},
+        {"content-type", T::CONTENT_TYPE}, {"content-range", T::CONTENT_RANGE},
+        {"content-disposition", T::CONTENT_DISPOSITION},
+        {"authorization", T::AUTHORIZATION}, {"connection", T::CONNECTION},
+        {"keep-alive", T::KEEP_ALIVE}, {"proxy-connection", T::PROXY_CONNECTION},
+        {"transfer-encoding", T::TRANSFER_ENCODING}, {"upgrade", T::UPGRADE},
+        {"accept", T::OTHER}, {"hostx", T::OTHER}, {"cookies", T::OTHER},
+        {":status", T::OTHER}, {"", T::OTHER}, {"content-lengtH", T::OTHER},
+    };
+    for (const auto& [name, expected] : cases) {
+        if (Http2Stream::ClassifyHeaderName(name) != expected) {
+            pass = false; err += "wrong token for '" + name + "'; ";
+        }
+    }
+    TestFramework::RecordTest("Http2Stream: header name token classification",
+                              pass, err, TestFramework::TestCategory::OTHER);
+}
+
+// The token path (what OnHeaderCallback feeds) keeps the string path's
+// semantics: list headers comma-fold, singletons reject duplicates,
+// identical content-length duplicates are accepted, overflow is rejected.
+void TestStreamTokenPathSemantics() {
+    std::cout << "\n[TEST] Http2Stream: token-path header semantics..." << std::endl;
+    using T = Http2Stream::HeaderToken;
+    bool pass = true;
+    std::string err;
+    try {
+        {
+            Http2Stream stream(7);
+            stream.AddHeader(T::OTHER, "accept", "text/html");
+            stream.AddHeader(T::OTHER, "accept", "application/json");
+            if (stream.GetRequest().GetHeader("accept") !=
+                    "text/html, application/json") {
+                pass = false; err += "accept not comma-folded; ";
+            }
+            if (stream.AddHeader(T::AUTHORIZATION, "authorization", "a") != 0 ||
+                stream.AddHeader(T::AUTHORIZATION, "authorization", "b") == 0) {
+                pass = false; err += "duplicate authorization accepted; ";
+            }
+        }
+        {
+            Http2Stream stream(9);
+            if (stream.AddHeader(T::CONTENT_LENGTH, "content-length", "42") != 0 ||
+                stream.AddHeader(T::CONTENT_LENGTH, "content-length", "42") != 0 ||
+                stream.GetRequest().content_length != 42) {
+                pass = false; err += "identical content-length duplicate rejected; ";
+            }
+            if (stream.AddHeader(T::CONTENT_LENGTH, "content-length", "43") == 0) {
+                pass = false; err += "conflicting content-length accepted; ";
+            }
+        }
+        {
+            Http2Stream stream(11);
+            if (stream.AddHeader(T::CONTENT_LENGTH, "content-length",
+                                 "99999999999999999999999") == 0) {
+                pass = false; err += "overflowing content-length accepted; ";
+            }
+        }
+        {
+            // Views into a buffer that is overwritten afterwards: the stream
+            // must own its copies.
+            Http2Stream stream(13);
+            std::string buf = ":path/a?b=1x-tracevalue";
+            std::string_view view(buf);
+            stream.AddHeader(T::PATH, view.substr(0, 5), view.substr(5, 6));
+            stream.AddHeader(T::OTHER, view.substr(11, 7), view.substr(18));
+            std::fill(buf.begin(), buf.end(), '#');
+            const HttpRequest& req = stream.GetRequest();
+            if (req.path != "/a" || req.query != "b=1" ||
+                req.GetHeader("x-trace") != "value") {
+                pass = false; err += "stored fields alias caller buffer; ";
+            }
+        }
+    } catch (const std::exception& e) {
+        pass = false; err += e.what();
+    }
+    TestFramework::RecordTest("Http2Stream: token-path header semantics",
+                              pass, err, TestFramework::TestCategory::OTHER);
+}
+
 void TestStreamCookieConcatenation() {
     std::cout << "\n[TEST] Http2Stream: cookie headers concatenated with \"; \"..." << std::endl;
     try {
@@ -2096,6 +2190,60 @@ void TestH2C_MultipleStreams() {
     }
 }
 
+// Write batching on and off must produce identical responses on one
+// connection: small frames coalesced per loop iteration, and a body large
+// enough to cross the 64 KB mid-batch flush.
+void TestH2C_WriteBatchingResponsesIntact() {
+    std::cout << "\n[TEST] H2C: write batching keeps responses intact..." << std::endl;
+    bool pass = true;
+    std::string err;
+    try {
+        const std::string big(300 * 1024, 'b');
+        for (bool batching : {true, false}) {
+            ServerConfig cfg;
+            cfg.bind_host            = "127.0.0.1";
+            cfg.bind_port            = 0;
+            cfg.worker_threads       = 2;
+            cfg.http2.enabled        = true;
+            cfg.http2.write_batching = batching;
+
+            HttpServer server(cfg);
+            server.Get("/small", [](const HttpRequest&, HttpResponse& res) {
+                res.Status(200).Text("small");
+            });
+            server.Get("/big", [&big](const HttpRequest&, HttpResponse& res) {
+                res.Status(200).Body(big, "application/octet-stream");
+            });
+
+            TestServerRunner<HttpServer> runner(server);
+            Http2TestClient client;
+            const std::string tag = batching ? "batching=on: " : "batching=off: ";
+            if (!client.Connect("127.0.0.1", runner.GetPort())) {
+                pass = false; err += tag + "connect failed; ";
+                continue;
+            }
+            for (int i = 0; i < 3; ++i) {
+                auto s = client.Get("/small");
+                if (s.error || s.status != 200 || s.body != "small") {
+                    pass = false; err += tag + "small response wrong; ";
+                }
+                auto b = client.Get("/big");
+                if (b.error || b.status != 200 || b.body != big) {
+                    pass = false;
+                    err += tag + "big response wrong (status=" +
+                           std::to_string(b.status) + " size=" +
+                           std::to_string(b.body.size()) + "); ";
+                }
+            }
+            client.Disconnect();
+        }
+    } catch (const std::exception& e) {
+        pass = false; err += e.what();
+    }
+    TestFramework::RecordTest("H2C: write batching keeps responses intact",
+                              pass, err, TestFramework::TestCategory::OTHER);
+}
+
 // A POST body that fits within max_body_size must succeed.
 void TestH2C_LargeBody() {
     std::cout << "\n[TEST] H2C: large body within limit..." << std::endl;
@@ -6499,6 +6647,8 @@ void RunAllTests() {
     TestStreamAddRegularHeaders();
     TestStreamInvalidHeaders();
     TestStreamCookieConcatenation();
+    TestStreamHeaderTokenClassification();
+    TestStreamTokenPathSemantics();
     TestStreamBodyAppend();
     TestStreamLifecycle();
     TestStreamRequestComplete();
@@ -6511,6 +6661,7 @@ void RunAllTests() {
     TestH2C_Middleware();
     TestH2C_MiddlewareRejectionHonored();
     TestH2C_MultipleStreams();
+    TestH2C_WriteBatchingResponsesIntact();
     TestH2C_LargeBody();
 
     // --- Category 5: Error Handling ---
@@ -0,0 +1,708 @@
+#pragma once
+
+// http3_test.h — experimental HTTP/3-framed UDP listener.
+//
+// Test dimensions:
+//   Unit (in-process, no sockets):
+//     T1  QUIC varint round-trip across all four length classes
+//     T2  QPACK literal field section round-trip; Huffman / static refs rejected
+//     T3  ParseRequest: pseudo-headers, :authority -> host, cookie re-join,
+//         body over max_body_size, missing :path, uppercase names
+//     T4  SerializeResponse + Packetize: datagram cap honoured, FIN on last,
+//         HEAD suppresses DATA, Content-Length recomputed
+//   Integration (real HttpServer + UDP client on loopback):
+//     T5  Sync route: GET over UDP reaches the router, middleware headers kept
+//     T6  Async route: POST body echoed through the buffering stream sender
+//     T7  Large response split across several datagrams and reassembled
+//     T8  Malformed request -> 400; unknown route -> 404; stats counted
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http/http_server.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "http3/http3_codec.h"
+#include "config/server_config.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <map>
+#include <thread>
+#include <chrono>
+
+namespace Http3Tests {
+
+// ---------------------------------------------------------------------------
+// Http3UdpTestClient — builds one-datagram requests and reassembles the
+// multi-datagram response by envelope offset.
+// ---------------------------------------------------------------------------
+class Http3UdpTestClient {
+public:
+    struct Response {
+        int status = 0;
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers;
+        size_t datagrams = 0;
+        bool error = false;
+        std::string err;
+
+        const std::string* Header(const std::string& name) const {
+            for (const auto& h : headers) {
+                if (h.first == name) return &h.second;
+            }
+            return nullptr;
+        }
+    };
+
+    Http3UdpTestClient() = default;
+    ~Http3UdpTestClient() { if (fd_ >= 0) ::close(fd_); }
+
+    Http3UdpTestClient(const Http3UdpTestClient&) = delete;
+    Http3UdpTestClient& operator=(const Http3UdpTestClient&) = delete;
+
+    bool Connect(int port) {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0) return false;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        return ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    static std::string BuildRequest(
+            uint64_t request_id, const std::string& method,
+            const std::string& path, const std::string& body,
+            std::vector<std::pair<std::string, std::string>> extra = {}) {
+        std::vector<std::pair<std::string, std::string>> fields = {
+            {":method", method}, {":scheme", "https"},
+            {":authority", "localhost"}, {":path", path},
+        };
+        for (auto& f : extra) fields.push_back(std::move(f));
+        std::string section;
+        HTTP3_CODEC::EncodeFieldSection(fields, section);
+
+        std::string out;
+        HTTP3_CODEC::Envelope env;
+        env.request_id = request_id;
+        env.fin = true;
+        HTTP3_CODEC::AppendEnvelope(env, out);
+        HTTP3_CODEC::AppendVarint(HTTP3_CODEC::FRAME_HEADERS, out);
+        HTTP3_CODEC::AppendVarint(section.size(), out);
+        out += section;
+        if (!body.empty()) {
+            HTTP3_CODEC::AppendVarint(HTTP3_CODEC::FRAME_DATA, out);
+            HTTP3_CODEC::AppendVarint(body.size(), out);
+            out += body;
+        }
+        return out;
+    }
+
+    bool SendRaw(const std::string& datagram) {
+        return ::send(fd_, datagram.data(), datagram.size(), 0) ==
+               static_cast<ssize_t>(datagram.size());
+    }
+
+    Response Request(uint64_t request_id, const std::string& method,
+                     const std::string& path, const std::string& body = "",
+                     std::vector<std::pair<std::string, std::string>> extra = {}) {
+        if (!SendRaw(BuildRequest(request_id, method, path, body, std::move(extra)))) {
+            Response r;
+            r.error = true;
+            r.err = "send failed";
+            return r;
+        }
+        return Receive(request_id);
+    }
+
+    // Collect datagrams for `request_id` until the FIN one and every
+    // earlier offset are in, then decode the frame stream.
+    Response Receive(uint64_t request_id, int timeout_ms = 3000) {
+        Response r;
+        std::map<uint64_t, std::string> chunks;
+        bool have_fin = false;
+        uint64_t total = 0;
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(timeout_ms);
+        std::vector<char> buf(HTTP3_CODEC::MAX_DATAGRAM_PAYLOAD + 1);
+        for (;;) {
+            if (have_fin) {
+                uint64_t have = 0;
+                for (const auto& c : chunks) {
+                    if (c.first != have) break;
+                    have += c.second.size();
+                }
+                if (have == total) break;
+            }
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                r.error = true;
+                r.err = "timeout";
+                return r;
+            }
+            pollfd pfd{fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(left)) <= 0) continue;
+            ssize_t n = ::recv(fd_, buf.data(), buf.size(), 0);
+            if (n <= 0) continue;
+            HTTP3_CODEC::Envelope env;
+            const auto* p = reinterpret_cast<const uint8_t*>(buf.data());
+            size_t hdr = HTTP3_CODEC::DecodeEnvelope(p, static_cast<size_t>(n), env);
+            if (hdr == 0 || env.request_id != request_id) continue;
+            ++r.datagrams;
+            chunks[env.offset].assign(buf.data() + hdr, static_cast<size_t>(n) - hdr);
+            if (env.fin) {
+                have_fin = true;
+                total = env.offset + static_cast<uint64_t>(n) - hdr;
+            }
+        }
+
+        std::string frames;
+        for (auto& c : chunks) frames += c.second;
+        const auto* p = reinterpret_cast<const uint8_t*>(frames.data());
+        size_t pos = 0;
+        while (pos < frames.size()) {
+            uint64_t type = 0, flen = 0;
+            size_t n1 = HTTP3_CODEC::DecodeVarint(p + pos, frames.size() - pos, type);
+            if (n1 == 0) break;
+            size_t n2 = HTTP3_CODEC::DecodeVarint(p + pos + n1,
+                                                  frames.size() - pos - n1, flen);
+            if (n2 == 0 || pos + n1 + n2 + flen > frames.size()) {
+                r.error = true;
+                r.err = "truncated frame";
+                return r;
+            }
+            pos += n1 + n2;
+            if (type == HTTP3_CODEC::FRAME_HEADERS) {
+                std::vector<std::pair<std::string, std::string>> fields;
+                std::string err;
+                if (!HTTP3_CODEC::DecodeFieldSection(p + pos, flen, fields, err)) {
+                    r.error = true;
+                    r.err = "field section: " + err;
+                    return r;
+                }
+                for (auto& f : fields) {
+                    if (f.first == ":status") {
+                        r.status = std::atoi(f.second.c_str());
+                    } else {
+                        r.headers.push_back(std::move(f));
+                    }
+                }
+            } else if (type == HTTP3_CODEC::FRAME_DATA) {
+                r.body.append(frames, pos, flen);
+            }
+            pos += flen;
+        }
+        return r;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+static ServerConfig MakeHttp3TestConfig() {
+    ServerConfig cfg;
+    cfg.bind_host      = "127.0.0.1";
+    cfg.bind_port      = 0;
+    cfg.worker_threads = 2;
+    cfg.http3.enabled  = true;
+    cfg.http3.port     = 0;
+    return cfg;
+}
+
+// ---------------------------------------------------------------------------
+// T1: varint round-trip
+// ---------------------------------------------------------------------------
+void TestVarintRoundTrip() {
+    std::cout << "\n[TEST] HTTP/3 codec: varint round-trip..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        const std::vector<std::pair<uint64_t, size_t>> cases = {
+            {0, 1}, {63, 1}, {64, 2}, {16383, 2}, {16384, 4},
+            {1073741823ULL, 4}, {1073741824ULL, 8}, {(1ULL << 62) - 1, 8},
+        };
+        for (const auto& c : cases) {
+            std::string buf;
+            HTTP3_CODEC::AppendVarint(c.first, buf);
+            uint64_t back = 0;
+            size_t n = HTTP3_CODEC::DecodeVarint(
+                reinterpret_cast<const uint8_t*>(buf.data()), buf.size(), back);
+            if (buf.size() != c.second || n != c.second || back != c.first) {
+                pass = false;
+                err += "value " + std::to_string(c.first) + " len=" +
+                       std::to_string(buf.size()) + "; ";
+            }
+            // Truncated input must report 0, never read past the end.
+            uint64_t dummy = 0;
+            if (c.second > 1 && HTTP3_CODEC::DecodeVarint(
+                    reinterpret_cast<const uint8_t*>(buf.data()),
+                    buf.size() - 1, dummy) != 0) {
+                pass = false;
+                err += "truncated " + std::to_string(c.first) + " accepted; ";
+            }
+        }
+        TestFramework::RecordTest("HTTP/3 codec: varint round-trip", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 codec: varint round-trip", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T2: QPACK literal field section
+// ---------------------------------------------------------------------------
+void TestFieldSectionRoundTrip() {
+    std::cout << "\n[TEST] HTTP/3 codec: QPACK literal field section..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        std::vector<std::pair<std::string, std::string>> in = {
+            {":status", "200"}, {"content-type", "text/plain"},
+            {"x-long", std::string(300, 'v')}, {"x-empty", ""},
+        };
+        std::string section;
+        HTTP3_CODEC::EncodeFieldSection(in, section);
+        std::vector<std::pair<std::string, std::string>> out;
+        std::string derr;
+        if (!HTTP3_CODEC::DecodeFieldSection(
+                reinterpret_cast<const uint8_t*>(section.data()),
+                section.size(), out, derr)) {
+            pass = false;
+            err += "decode failed: " + derr + "; ";
+        } else if (out != in) {
+            pass = false;
+            err += "round-trip mismatch; ";
+        }
+
+        // Indexed field line referencing the static table (0b11xxxxxx):
+        // this encoder never emits it, so the decoder must refuse it.
+        std::string static_ref = std::string("\x00\x00", 2) + "\xd1";
+        out.clear();
+        if (HTTP3_CODEC::DecodeFieldSection(
+                reinterpret_cast<const uint8_t*>(static_ref.data()),
+                static_ref.size(), out, derr)) {
+            pass = false;
+            err += "static-table reference accepted; ";
+        }
+        // Truncated section.
+        out.clear();
+        if (HTTP3_CODEC::DecodeFieldSection(
+                reinterpret_cast<const uint8_t*>(section.data()),
+                section.size() - 5, out, derr)) {
+            pass = false;
+            err += "truncated section accepted; ";
+        }
+        TestFramework::RecordTest("HTTP/3 codec: QPACK literal field section",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 codec: QPACK literal field section",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T3: ParseRequest validation
+// ---------------------------------------------------------------------------
+void TestParseRequest() {
+    std::cout << "\n[TEST] HTTP/3 codec: ParseRequest validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        auto parse = [](const std::string& dgram, size_t max_body,
+                        HttpRequest& req, std::string& perr) {
+            HTTP3_CODEC::Envelope env;
+            const auto* p = reinterpret_cast<const uint8_t*>(dgram.data());
+            size_t hdr = HTTP3_CODEC::DecodeEnvelope(p, dgram.size(), env);
+            return hdr != 0 &&
+                   HTTP3_CODEC::ParseRequest(p + hdr, dgram.size() - hdr,
+                                             max_body, req, perr);
+        };
+
+        {
+            HttpRequest req;
+            std::string perr;
+            auto d = Http3UdpTestClient::BuildRequest(
+                1, "POST", "/items?id=7", "hello",
+                {{"cookie", "a=1"}, {"cookie", "b=2"}, {"x-tag", "t"}});
+            if (!parse(d, 1024, req, perr)) {
+                pass = false;
+                err += "valid request rejected: " + perr + "; ";
+            } else {
+                if (req.method != "POST") { pass = false; err += "method; "; }
+                if (req.path != "/items") { pass = false; err += "path=" + req.path + "; "; }
+                if (req.query != "id=7") { pass = false; err += "query; "; }
+                if (req.body != "hello") { pass = false; err += "body; "; }
+                if (req.GetHeader("host") != "localhost") { pass = false; err += "host; "; }
+                if (req.GetHeader("cookie") != "a=1; b=2") {
+                    pass = false;
+                    err += "cookie='" + req.GetHeader("cookie") + "'; ";
+                }
+                if (req.http_major != 3) { pass = false; err += "http_major; "; }
+            }
+        }
+        {
+            HttpRequest req;
+            std::string perr;
+            auto d = Http3UdpTestClient::BuildRequest(2, "POST", "/", "0123456789");
+            if (parse(d, 4, req, perr)) {
+                pass = false;
+                err += "oversized body accepted; ";
+            }
+        }
+        {
+            HttpRequest req;
+            std::string perr;
+            auto d = Http3UdpTestClient::BuildRequest(3, "GET", "", "");
+            if (parse(d, 1024, req, perr)) {
+                pass = false;
+                err += "empty :path accepted; ";
+            }
+        }
+        {
+            HttpRequest req;
+            std::string perr;
+            auto d = Http3UdpTestClient::BuildRequest(4, "GET", "/", "",
+                                                      {{"X-Upper", "1"}});
+            if (parse(d, 1024, req, perr)) {
+                pass = false;
+                err += "uppercase header name accepted; ";
+            }
+        }
+        {
+            HttpRequest req;
+            std::string perr;
+            auto d = Http3UdpTestClient::BuildRequest(5, "GET", "/", "",
+                                                      {{"connection", "close"}});
+            if (parse(d, 1024, req, perr)) {
+                pass = false;
+                err += "connection-specific header accepted; ";
+            }
+        }
+        TestFramework::RecordTest("HTTP/3 codec: ParseRequest validation", pass,
+                                  err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 codec: ParseRequest validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T4: SerializeResponse + Packetize
+// ---------------------------------------------------------------------------
+void TestSerializeAndPacketize() {
+    std::cout << "\n[TEST] HTTP/3 codec: SerializeResponse + Packetize..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        HttpResponse resp;
+        resp.Status(200).Header("Connection", "keep-alive")
+            .Header("Content-Length", "1").Body(std::string(5000, 'x'));
+        std::string frames = HTTP3_CODEC::SerializeResponse(resp, false);
+        auto dgrams = HTTP3_CODEC::Packetize(9, frames, 600);
+        if (dgrams.size() < 9) {
+            pass = false;
+            err += "expected >=9 datagrams, got " + std::to_string(dgrams.size()) + "; ";
+        }
+        std::string joined;
+        for (size_t i = 0; i < dgrams.size(); ++i) {
+            if (dgrams[i].size() > 600) {
+                pass = false;
+                err += "datagram " + std::to_string(i) + " over cap; ";
+            }
+            HTTP3_CODEC::Envelope env;
+            size_t hdr = HTTP3_CODEC::DecodeEnvelope(
+                reinterpret_cast<const uint8_t*>(dgrams[i].data()),
+                dgrams[i].size(), env);
+            if (hdr == 0 || env.request_id != 9 || env.offset != joined.size() ||
+                env.fin != (i + 1 == dgrams.size())) {
+                pass = false;
+                err += "bad envelope at " + std::to_string(i) + "; ";
+                break;
+            }
+            joined.append(dgrams[i], hdr, std::string::npos);
+        }
+        if (joined != frames) {
+            pass = false;
+            err += "reassembly mismatch; ";
+        }
+        if (frames.find("keep-alive") != std::string::npos) {
+            pass = false;
+            err += "connection header leaked; ";
+        }
+        if (frames.find("5000") == std::string::npos) {
+            pass = false;
+            err += "content-length not recomputed; ";
+        }
+
+        // HEAD: headers only, no DATA frame.
+        std::string head_frames = HTTP3_CODEC::SerializeResponse(resp, true);
+        if (head_frames.size() >= 5000 ||
+            head_frames.find(std::string(16, 'x')) != std::string::npos) {
+            pass = false;
+            err += "HEAD response carried a body; ";
+        }
+        TestFramework::RecordTest("HTTP/3 codec: SerializeResponse + Packetize",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 codec: SerializeResponse + Packetize",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T5: sync route over UDP
+// ---------------------------------------------------------------------------
+void TestSyncRouteOverUdp() {
+    std::cout << "\n[TEST] HTTP/3 listener: sync route over UDP..." << std::endl;
+    try {
+        HttpServer server(MakeHttp3TestConfig());
+        server.Use([](const HttpRequest&, HttpResponse& resp) {
+            resp.Header("X-Mw", "seen");
+            return true;
+        });
+        server.Get("/hello", [](const HttpRequest& req, HttpResponse& resp) {
+            resp.Status(200).Text("hi from " + req.network_protocol_version +
+                                  " " + req.GetHeader("host"));
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        int h3_port = server.GetHttp3BoundPort();
+        Http3UdpTestClient client;
+        if (h3_port <= 0 || !client.Connect(h3_port)) {
+            pass = false;
+            err = "no HTTP/3 port";
+        } else {
+            auto r = client.Request(1, "GET", "/hello");
+            if (r.error) { pass = false; err += r.err + "; "; }
+            if (r.status != 200) {
+                pass = false;
+                err += "status=" + std::to_string(r.status) + "; ";
+            }
+            if (r.body != "hi from 3 localhost") {
+                pass = false;
+                err += "body='" + r.body + "'; ";
+            }
+            auto* mw = r.Header("x-mw");
+            if (!mw || *mw != "seen") { pass = false; err += "middleware header missing; "; }
+        }
+        TestFramework::RecordTest("HTTP/3 listener: sync route over UDP", pass,
+                                  err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 listener: sync route over UDP", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T6: async route — completion from another thread, and streaming sender
+// ---------------------------------------------------------------------------
+void TestAsyncRouteOverUdp() {
+    std::cout << "\n[TEST] HTTP/3 listener: async + streaming routes..." << std::endl;
+    try {
+        HttpServer server(MakeHttp3TestConfig());
+        server.PostAsync("/echo",
+            [](const HttpRequest& req,
+               HttpRouter::InterimResponseSender,
+               HttpRouter::ResourcePusher,
+               HttpRouter::StreamingResponseSender,
+               HttpRouter::AsyncCompletionCallback complete) {
+                std::string body = req.body;
+                std::thread([body, complete]() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    HttpResponse r;
+                    r.Status(201).Text("echo:" + body);
+                    complete(std::move(r));
+                }).detach();
+            });
+        server.GetAsync("/stream",
+            [](const HttpRequest&,
+               HttpRouter::InterimResponseSender,
+               HttpRouter::ResourcePusher,
+               HttpRouter::StreamingResponseSender sender,
+               HttpRouter::AsyncCompletionCallback) {
+                HttpResponse head;
+                head.Status(200).Header("Content-Type", "text/plain");
+                if (sender.SendHeaders(head) < 0) return;
+                (void)sender.SendData("ab", 2);
+                (void)sender.SendData("cd", 2);
+                (void)sender.End({{"x-trailer", "dropped"}});
+            });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        Http3UdpTestClient client;
+        if (!client.Connect(server.GetHttp3BoundPort())) {
+            pass = false;
+            err = "connect failed";
+        } else {
+            auto r = client.Request(7, "POST", "/echo", "payload");
+            if (r.error || r.status != 201 || r.body != "echo:payload") {
+                pass = false;
+                err += "echo status=" + std::to_string(r.status) + " body='" +
+                       r.body + "' " + r.err + "; ";
+            }
+            auto s = client.Request(8, "GET", "/stream");
+            if (s.error || s.status != 200 || s.body != "abcd") {
+                pass = false;
+                err += "stream status=" + std::to_string(s.status) + " body='" +
+                       s.body + "' " + s.err + "; ";
+            }
+            auto* cl = s.Header("content-length");
+            if (!cl || *cl != "4") { pass = false; err += "stream content-length; "; }
+        }
+        TestFramework::RecordTest("HTTP/3 listener: async + streaming routes",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 listener: async + streaming routes",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T7: large response spans many datagrams
+// ---------------------------------------------------------------------------
+void TestLargeResponseMultiDatagram() {
+    std::cout << "\n[TEST] HTTP/3 listener: multi-datagram response..." << std::endl;
+    try {
+        auto cfg = MakeHttp3TestConfig();
+        cfg.http3.max_datagram_size = 512;
+        HttpServer server(cfg);
+        std::string big;
+        for (int i = 0; i < 20000; ++i) big.push_back(static_cast<char>('a' + i % 26));
+        server.Get("/big", [big](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(200).Body(big);
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        Http3UdpTestClient client;
+        if (!client.Connect(server.GetHttp3BoundPort())) {
+            pass = false;
+            err = "connect failed";
+        } else {
+            auto r = client.Request(11, "GET", "/big");
+            if (r.error || r.status != 200 || r.body != big) {
+                pass = false;
+                err += "status=" + std::to_string(r.status) + " len=" +
+                       std::to_string(r.body.size()) + " " + r.err + "; ";
+            }
+            if (r.datagrams < 40) {
+                pass = false;
+                err += "only " + std::to_string(r.datagrams) + " datagrams; ";
+            }
+            auto head = client.Request(12, "HEAD", "/big");
+            if (head.error || head.status != 200 || !head.body.empty()) {
+                pass = false;
+                err += "HEAD status=" + std::to_string(head.status) + "; ";
+            }
+            auto stats = server.GetHttp3Stats();
+            if (!stats || stats->udp.send_batches == 0 ||
+                stats->udp.datagrams_sent < r.datagrams) {
+                pass = false;
+                err += "send stats not recorded; ";
+            }
+        }
+        TestFramework::RecordTest("HTTP/3 listener: multi-datagram response",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 listener: multi-datagram response",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// T8: malformed request / unknown route / disabled listener
+// ---------------------------------------------------------------------------
+void TestMalformedAndNotFound() {
+    std::cout << "\n[TEST] HTTP/3 listener: malformed + not found..." << std::endl;
+    try {
+        HttpServer server(MakeHttp3TestConfig());
+        server.Get("/ok", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(200).Text("ok");
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        Http3UdpTestClient client;
+        if (!client.Connect(server.GetHttp3BoundPort())) {
+            pass = false;
+            err = "connect failed";
+        } else {
+            // Valid envelope, garbage frame payload.
+            std::string bad;
+            HTTP3_CODEC::Envelope env;
+            env.request_id = 21;
+            env.fin = true;
+            HTTP3_CODEC::AppendEnvelope(env, bad);
+            bad += "\x01\x05\xff\xff";
+            client.SendRaw(bad);
+            auto r = client.Receive(21);
+            if (r.error || r.status != 400) {
+                pass = false;
+                err += "malformed status=" + std::to_string(r.status) + "; ";
+            }
+            auto nf = client.Request(22, "GET", "/missing");
+            if (nf.status != 404) {
+                pass = false;
+                err += "missing status=" + std::to_string(nf.status) + "; ";
+            }
+            auto ok = client.Request(23, "GET", "/ok");
+            if (ok.status != 200 || ok.body != "ok") {
+                pass = false;
+                err += "ok status=" + std::to_string(ok.status) + "; ";
+            }
+            auto stats = server.GetHttp3Stats();
+            if (!stats || stats->malformed < 1 || stats->requests < 2 ||
+                stats->responses < 3) {
+                pass = false;
+                err += "listener stats not recorded; ";
+            }
+        }
+
+        // Listener absent when http3 is disabled.
+        ServerConfig off;
+        off.bind_host = "127.0.0.1";
+        off.bind_port = 0;
+        HttpServer plain(off);
+        TestServerRunner<HttpServer> plain_runner(plain);
+        if (plain.GetHttp3BoundPort() != 0 || plain.GetHttp3Stats()) {
+            pass = false;
+            err += "listener started while disabled; ";
+        }
+        TestFramework::RecordTest("HTTP/3 listener: malformed + not found", pass,
+                                  err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("HTTP/3 listener: malformed + not found", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== HTTP/3 (experimental UDP) Tests ===" << std::endl;
+
+    TestVarintRoundTrip();
+    TestFieldSectionRoundTrip();
+    TestParseRequest();
+    TestSerializeAndPacketize();
+
+    TestSyncRouteOverUdp();
+    TestAsyncRouteOverUdp();
+    TestLargeResponseMultiDatagram();
+    TestMalformedAndNotFound();
+
+    std::cout << "=== HTTP/3 Tests Done ===" << std::endl;
+}
+
+}  // namespace Http3Tests
@@ -141,14 +141,23 @@ inline void TestCatalogInstrumentsRegistered() {
                    cat.http_server_request_body_size != nullptr &&
                    cat.http_server_response_body_size != nullptr &&
                    cat.reactor_http_connections_active != nullptr &&
-                   cat.reactor_http_connections_accepted != nullptr;
+                   cat.reactor_http_connections_accepted != nullptr &&
+                   cat.reactor_tls_handshakes != nullptr &&
+                   cat.reactor_tls_handshakes_queued != nullptr &&
+                   cat.reactor_tls_records != nullptr;
         // §7.2 client / pool
         bool s72 = cat.http_client_request_duration != nullptr &&
                    cat.http_client_active_requests != nullptr &&
                    cat.reactor_upstream_retries != nullptr &&
                    cat.reactor_upstream_pool_connections_idle != nullptr &&
                    cat.reactor_upstream_pool_connections_active != nullptr &&
-                   cat.reactor_upstream_pool_checkout_wait_duration != nullptr;
+                   cat.reactor_upstream_pool_checkout_wait_duration != nullptr &&
+                   cat.reactor_upstream_pool_connects != nullptr &&
+                   cat.reactor_upstream_tls_handshakes != nullptr &&
+                   cat.reactor_upstream_health_checks != nullptr &&
+                   cat.reactor_upstream_health_transitions != nullptr &&
+                   cat.reactor_upstream_outlier_ejections != nullptr &&
+                   cat.rpc_client_duration != nullptr;
         // §7.3 middleware
         bool s73 = cat.reactor_auth_requests != nullptr &&
                    cat.reactor_auth_cache_lookups != nullptr &&
@@ -160,7 +169,12 @@ inline void TestCatalogInstrumentsRegistered() {
                    cat.reactor_circuit_breaker_transitions != nullptr &&
                    cat.reactor_dns_resolves != nullptr &&
                    cat.reactor_websocket_active_connections != nullptr &&
-                   cat.reactor_websocket_frames != nullptr;
+                   cat.reactor_websocket_frames != nullptr &&
+                   cat.reactor_proxy_cache_lookups != nullptr &&
+                   cat.reactor_proxy_cache_served_bytes != nullptr &&
+                   cat.reactor_proxy_cache_origin_latency_saved != nullptr &&
+                   cat.reactor_proxy_singleflight_coalesced != nullptr &&
+                   cat.reactor_proxy_hedges != nullptr;
         // §7.4 self-metrics
         bool s74 = cat.reactor_otel_spans_created != nullptr &&
                    cat.reactor_otel_spans_dropped_unsampled != nullptr &&
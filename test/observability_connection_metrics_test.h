@@ -6,7 +6,7 @@
 //   * reactor.net.connections.active   — UpDownCounter, no labels.
 //   * reactor.net.connections.accepted — Counter,        no labels.
 //   * reactor.http.connections.active  — UpDownCounter, {protocol}.
-//   * reactor.tls.handshakes           — Counter,        {outcome}.
+//   * reactor.tls.handshakes           — Counter,        {outcome, mode}.
 //
 // The transport gauges are driven from ConnectionHandler at accept-time;
 // the protocol gauge is driven by MarkApplicationProtocolConfirmed once
@@ -0,0 +1,315 @@
+#pragma once
+
+// pool_prewarm_test.h — upstream pool pre-warming
+// (pool.min_idle_connections, pool.adaptive_min_idle).
+//
+// Test dimensions:
+//   Unit (PoolPrewarmPolicy in-process, no sockets):
+//     T1  Static floor: min_idle_connections, unaffected by traffic
+//     T2  Adaptive floor: checkout rate x connect time, capped at
+//         max_idle_connections, back to the static floor when traffic stops
+//   Integration (UpstreamManager against a local listener):
+//     T3  The timer tick fills the idle pool to the floor without checkouts
+//     T4  A checkout is served from the warm pool without a connect and
+//         the pool is refilled; without a floor the checkout connects
+//   Config:
+//     T5  pool.min_idle_connections / adaptive_min_idle round-trip and
+//         validation
+
+#include "test_framework.h"
+#include "upstream_pool_test.h"  // MakeListenerFd, StartDispatcher, ...
+#include "upstream/upstream_manager.h"
+#include "upstream/pool_partition.h"
+#include "upstream/pool_prewarm.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace PoolPrewarmTests {
+
+using Clock = std::chrono::steady_clock;
+
+// T1
+void TestStaticFloor() {
+    std::cout << "\n[TEST] PoolPrewarm: static floor..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        UpstreamPoolConfig cfg;
+        cfg.max_idle_connections = 4;
+        if (PoolPrewarmPolicy(cfg).enabled()) {
+            pass = false; err += "enabled with no floor; ";
+        }
+        cfg.min_idle_connections = 2;
+        PoolPrewarmPolicy policy(cfg);
+        auto now = Clock::now();
+        if (!policy.enabled() || policy.TargetIdle(now) != 2) {
+            pass = false; err += "target=" + std::to_string(policy.TargetIdle(now)) + "; ";
+        }
+        policy.RecordConnectTime(0.5);
+        for (int i = 0; i < 1000; ++i) {
+            policy.RecordCheckout(now + std::chrono::milliseconds(i));
+        }
+        if (policy.TargetIdle(now + std::chrono::seconds(1)) != 2) {
+            pass = false; err += "static floor moved with traffic; ";
+        }
+        TestFramework::RecordTest("PoolPrewarm: static floor", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("PoolPrewarm: static floor", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestAdaptiveFloor() {
+    std::cout << "\n[TEST] PoolPrewarm: adaptive floor..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        UpstreamPoolConfig cfg;
+        cfg.max_idle_connections = 16;
+        cfg.min_idle_connections = 1;
+        cfg.adaptive_min_idle = true;
+        PoolPrewarmPolicy policy(cfg);
+        auto start = Clock::now();
+        if (policy.TargetIdle(start) != 1) {
+            pass = false; err += "no traffic target=" +
+                std::to_string(policy.TargetIdle(start)) + "; ";
+        }
+
+        // 50ms connects; 200 checkouts/s for a minute settles the rate.
+        policy.RecordConnectTime(0.05);
+        policy.RecordConnectTime(0.05);
+        auto t = start;
+        for (int i = 0; i < 12000; ++i) {
+            t += std::chrono::milliseconds(5);
+            policy.RecordCheckout(t);
+        }
+        double rate = policy.CheckoutRate(t);
+        if (rate < 190.0 || rate > 210.0) {
+            pass = false; err += "rate=" + std::to_string(rate) + "; ";
+        }
+        // 200/s x 50ms = 10 checkouts arrive during one connect.
+        if (policy.TargetIdle(t) != 10) {
+            pass = false; err += "busy target=" + std::to_string(policy.TargetIdle(t)) + "; ";
+        }
+        // Slower connects: the floor is capped at max_idle_connections.
+        for (int i = 0; i < 40; ++i) policy.RecordConnectTime(1.0);
+        if (policy.TargetIdle(t) != 16) {
+            pass = false; err += "capped target=" + std::to_string(policy.TargetIdle(t)) + "; ";
+        }
+        // Two minutes of silence: back to the static floor.
+        if (policy.TargetIdle(t + std::chrono::minutes(2)) != 1) {
+            pass = false; err += "quiet target=" +
+                std::to_string(policy.TargetIdle(t + std::chrono::minutes(2))) + "; ";
+        }
+        TestFramework::RecordTest("PoolPrewarm: adaptive floor", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("PoolPrewarm: adaptive floor", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Run `fn` on the dispatcher thread and wait for its result.
+template <typename Fn>
+auto OnDispatcher(const std::shared_ptr<Dispatcher>& disp, Fn fn) -> decltype(fn()) {
+    auto promise = std::make_shared<std::promise<decltype(fn())>>();
+    auto future = promise->get_future();
+    disp->EnQueue([promise, fn]() { promise->set_value(fn()); });
+    if (future.wait_for(std::chrono::seconds(3)) != std::future_status::ready) {
+        throw std::runtime_error("dispatcher task timed out");
+    }
+    return future.get();
+}
+
+// Poll until the partition holds `want` idle connections.
+inline bool WaitForIdle(const std::shared_ptr<Dispatcher>& disp,
+                        PoolPartition* part, size_t want) {
+    for (int i = 0; i < 100; ++i) {
+        if (OnDispatcher(disp, [part]() { return part->IdleCount(); }) == want) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+// T3
+void TestTickFillsIdlePool() {
+    std::cout << "\n[TEST] PoolPrewarm: timer tick fills the idle pool..." << std::endl;
+    try {
+        auto [lfd, port] = UpstreamPoolTests::MakeListenerFd();
+        auto disp = std::make_shared<Dispatcher>(true, 5);
+        auto t = UpstreamPoolTests::StartDispatcher(disp);
+        UpstreamConfig cfg = UpstreamPoolTests::MakeUpstreamConfig("svc", "127.0.0.1", port);
+        cfg.pool.min_idle_connections = 2;
+        UpstreamManager mgr({cfg}, {disp});
+        UpstreamPoolTests::DispatcherThreadGuard dtg{disp, t};
+        PoolPartition* part = mgr.GetPoolPartition("svc", 0);
+
+        bool pass = true;
+        std::string err;
+        OnDispatcher(disp, [&mgr]() { mgr.EvictExpired(0); return 0; });
+        if (!WaitForIdle(disp, part, 2)) {
+            pass = false; err += "idle=" + std::to_string(
+                OnDispatcher(disp, [part]() { return part->IdleCount(); })) + "; ";
+        }
+        // A second tick with the floor met opens nothing.
+        OnDispatcher(disp, [&mgr]() { mgr.EvictExpired(0); return 0; });
+        if (part->prewarm_connects() != 2 || part->checkout_connects() != 0) {
+            pass = false; err += "prewarm=" + std::to_string(part->prewarm_connects()) +
+                " checkout=" + std::to_string(part->checkout_connects()) + "; ";
+        }
+
+        mgr.InitiateShutdown();
+        mgr.WaitForDrain(std::chrono::seconds(2));
+        ::close(lfd);
+        TestFramework::RecordTest("PoolPrewarm: timer tick fills the idle pool", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("PoolPrewarm: timer tick fills the idle pool", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Check out one connection and hold the lease until the partition has
+// `want_idle` idle connections (or gives up waiting); returns
+// {checkout succeeded, idle count while held}.
+inline std::pair<bool, size_t> CheckoutAndHold(UpstreamManager& mgr,
+                                               const std::shared_ptr<Dispatcher>& disp,
+                                               PoolPartition* part, size_t want_idle) {
+    auto held = std::make_shared<std::unique_ptr<UpstreamLease>>();
+    auto got = std::make_shared<std::promise<bool>>();
+    auto future = got->get_future();
+    disp->EnQueue([&mgr, held, got]() {
+        mgr.CheckoutAsync("svc", 0,
+            [held, got](UpstreamLease lease) {
+                *held = std::make_unique<UpstreamLease>(std::move(lease));
+                try { got->set_value(true); } catch (...) {}
+            },
+            [got](int) { try { got->set_value(false); } catch (...) {} });
+    });
+    if (future.wait_for(std::chrono::seconds(3)) != std::future_status::ready ||
+        !future.get()) {
+        return {false, 0};
+    }
+    WaitForIdle(disp, part, want_idle);
+    size_t idle = OnDispatcher(disp, [part]() { return part->IdleCount(); });
+    OnDispatcher(disp, [held]() { held->reset(); return 0; });
+    return {true, idle};
+}
+
+// T4
+void TestCheckoutServedWarm() {
+    std::cout << "\n[TEST] PoolPrewarm: checkout served from the warm pool..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        auto [lfd, port] = UpstreamPoolTests::MakeListenerFd();
+        for (int min_idle : {2, 0}) {
+            auto disp = std::make_shared<Dispatcher>(true, 5);
+            auto t = UpstreamPoolTests::StartDispatcher(disp);
+            UpstreamConfig cfg = UpstreamPoolTests::MakeUpstreamConfig("svc", "127.0.0.1", port);
+            cfg.pool.min_idle_connections = min_idle;
+            UpstreamManager mgr({cfg}, {disp});
+            UpstreamPoolTests::DispatcherThreadGuard dtg{disp, t};
+            PoolPartition* part = mgr.GetPoolPartition("svc", 0);
+            const std::string tag = "min_idle=" + std::to_string(min_idle) + ": ";
+
+            OnDispatcher(disp, [&mgr]() { mgr.EvictExpired(0); return 0; });
+            if (min_idle > 0 && !WaitForIdle(disp, part, 2)) {
+                pass = false; err += tag + "pool not warmed; ";
+            }
+            auto [ok, idle] = CheckoutAndHold(mgr, disp, part,
+                                              static_cast<size_t>(min_idle));
+            if (!ok) { pass = false; err += tag + "checkout failed; "; }
+            if (min_idle > 0) {
+                // Served from idle, and the taken connection was replaced.
+                if (part->checkout_connects() != 0) {
+                    pass = false; err += tag + "checkout waited on a connect; ";
+                }
+                if (idle != 2 || part->prewarm_connects() != 3) {
+                    pass = false; err += tag + "idle=" + std::to_string(idle) +
+                        " prewarm=" + std::to_string(part->prewarm_connects()) + "; ";
+                }
+            } else if (part->checkout_connects() != 1 || part->prewarm_connects() != 0) {
+                pass = false; err += tag + "checkout=" +
+                    std::to_string(part->checkout_connects()) + "; ";
+            }
+            mgr.InitiateShutdown();
+            mgr.WaitForDrain(std::chrono::seconds(2));
+        }
+        ::close(lfd);
+        TestFramework::RecordTest("PoolPrewarm: checkout served from the warm pool", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("PoolPrewarm: checkout served from the warm pool", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestConfig() {
+    std::cout << "\n[TEST] PoolPrewarm: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                           "pool": {"max_connections": 8,
+                                    "max_idle_connections": 4,
+                                    "min_idle_connections": 3,
+                                    "adaptive_min_idle": true}}]
+        })");
+        ConfigLoader::Validate(cfg);
+        const auto& pool = cfg.upstreams[0].pool;
+        if (pool.min_idle_connections != 3 || !pool.adaptive_min_idle) {
+            pass = false; err += "parse mismatch; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (again.upstreams[0].pool != pool) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+
+        for (int bad_min : {-1, 5}) {
+            ServerConfig bad = cfg;
+            bad.upstreams[0].pool.min_idle_connections = bad_min;
+            try {
+                ConfigLoader::Validate(bad);
+                pass = false; err += "min_idle=" + std::to_string(bad_min) + " accepted; ";
+            } catch (const std::invalid_argument& e) {
+                if (std::string(e.what()).find("min_idle_connections") == std::string::npos) {
+                    pass = false; err += std::string("wrong error: ") + e.what() + "; ";
+                }
+            }
+        }
+        try {
+            ConfigLoader::LoadFromString(R"({
+                "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                               "pool": {"adaptive_min_idle": "yes"}}]
+            })");
+            pass = false; err += "string adaptive_min_idle accepted; ";
+        } catch (const std::runtime_error&) {}
+        TestFramework::RecordTest("PoolPrewarm: config round-trip and validation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("PoolPrewarm: config round-trip and validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== Upstream Pool Pre-warming Tests ===" << std::endl;
+    TestStaticFloor();
+    TestAdaptiveFloor();
+    TestTickFillsIdlePool();
+    TestCheckoutServedWarm();
+    TestConfig();
+}
+
+}  // namespace PoolPrewarmTests
@@ -0,0 +1,643 @@
+#pragma once
+
+// proxy_cache_test.h — shared proxy response cache (proxy_cache +
+// proxy.cache).
+//
+// Test dimensions:
+//   Unit (ResponseCache in-process, no sockets):
+//     T1  ClassifyRequest: GET lookup, unsafe / Authorization / Range /
+//         no-store bypass, no-cache and Pragma refresh
+//     T2  Storability and freshness: max-age fresh, Age header ages the
+//         entry, no-store / private / Set-Cookie / no lifetime not stored
+//     T3  Stale usability: stale-while-revalidate, stale-if-error,
+//         must-revalidate never served stale
+//     T4  Vary: variants selected by request headers; a miss reports
+//         the URL's Vary names
+//     T5  Memory byte budget evicts least recently used URLs
+//     T6  Memory evictions demote to the mmap'd disk tier and are served
+//         from it intact
+//   Integration (backend HttpServer behind a caching gateway):
+//     T7  max-age response served from cache with an Age header; POST
+//         invalidates the URL
+//     T8  Concurrent misses on one URL collapse to one upstream request
+//     T9  stale-while-revalidate serves stale and refreshes in background
+//     T10 stale-if-error serves the stale entry on an upstream 500
+//     T11 Expired entry revalidated with If-None-Match; 304 refreshes it
+//   Config:
+//     T12 proxy_cache / proxy.cache JSON round-trip and validation
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "proxy_test.h"  // MakeProxyUpstreamConfig
+#include "http/http_server.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "upstream/response_cache.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ProxyCacheTests {
+
+inline HttpRequest MakeRequest(const std::string& method, const std::string& path,
+                               std::map<std::string, std::string> headers = {}) {
+    HttpRequest req;
+    req.method = method;
+    req.path = path;
+    req.headers = std::move(headers);
+    req.headers.emplace("host", "example.test");
+    return req;
+}
+
+// Run `response` through a Fill as if the proxy had relayed it.
+inline void StoreResponse(const std::shared_ptr<ResponseCache>& cache,
+                          const HttpRequest& req, const HttpResponse& response) {
+    ResponseCache::Fill fill(cache, "svc", ResponseCache::PrimaryKey("svc", req),
+                             "", req, ResponseCache::Lookup{}, false, true);
+    fill.OnResponseHead(response);
+    fill.OnBody(response.GetBody().data(), response.GetBody().size());
+    fill.OnComplete(true);
+}
+
+inline HttpResponse Cacheable(const std::string& cache_control,
+                              const std::string& body = "payload") {
+    HttpResponse r;
+    r.Status(200).Header("Cache-Control", cache_control).Body(body, "text/plain");
+    return r;
+}
+
+inline ResponseCache::Lookup Find(const std::shared_ptr<ResponseCache>& cache,
+                                  const HttpRequest& req) {
+    return cache->Find(ResponseCache::PrimaryKey("svc", req), req,
+                       std::chrono::steady_clock::now());
+}
+
+inline ProxyCacheConfig UnitConfig() {
+    ProxyCacheConfig c;
+    c.enabled = true;
+    return c;
+}
+
+// T1
+void TestClassifyRequest() {
+    std::cout << "\n[TEST] ProxyCache: request classification..." << std::endl;
+    using P = ResponseCache::RequestPolicy;
+    bool pass = true;
+    std::string err;
+    auto expect = [&](const HttpRequest& req, P want, const char* what) {
+        if (ResponseCache::ClassifyRequest(req) != want) {
+            pass = false; err += std::string(what) + "; ";
+        }
+    };
+    expect(MakeRequest("GET", "/a"), P::LOOKUP, "GET not LOOKUP");
+    expect(MakeRequest("HEAD", "/a"), P::LOOKUP, "HEAD not LOOKUP");
+    expect(MakeRequest("POST", "/a"), P::BYPASS, "POST not BYPASS");
+    expect(MakeRequest("GET", "/a", {{"authorization", "Bearer x"}}), P::BYPASS,
+           "Authorization not BYPASS");
+    expect(MakeRequest("GET", "/a", {{"range", "bytes=0-1"}}), P::BYPASS,
+           "Range not BYPASS");
+    expect(MakeRequest("GET", "/a", {{"cache-control", "no-store"}}), P::BYPASS,
+           "no-store not BYPASS");
+    expect(MakeRequest("GET", "/a", {{"cache-control", "no-cache"}}), P::REFRESH,
+           "no-cache not REFRESH");
+    expect(MakeRequest("GET", "/a", {{"cache-control", "max-age=0"}}), P::REFRESH,
+           "max-age=0 not REFRESH");
+    expect(MakeRequest("GET", "/a", {{"pragma", "no-cache"}}), P::REFRESH,
+           "Pragma no-cache not REFRESH");
+    TestFramework::RecordTest("ProxyCache: request classification", pass, err,
+                              TestFramework::TestCategory::OTHER);
+}
+
+// T2
+void TestStorabilityAndFreshness() {
+    std::cout << "\n[TEST] ProxyCache: storability and freshness..." << std::endl;
+    try {
+        auto cache = std::make_shared<ResponseCache>(UnitConfig());
+        bool pass = true;
+        std::string err;
+
+        auto fresh = MakeRequest("GET", "/fresh");
+        StoreResponse(cache, fresh, Cacheable("public, max-age=60", "hello"));
+        auto found = Find(cache, fresh);
+        if (!found.entry || found.usability != ResponseCache::Usability::FRESH) {
+            pass = false; err += "max-age=60 not fresh; ";
+        } else if (std::string(found.entry->body->data(), found.entry->body->size()) != "hello") {
+            pass = false; err += "body mismatch; ";
+        }
+
+        auto aged = MakeRequest("GET", "/aged");
+        auto aged_resp = Cacheable("max-age=60");
+        aged_resp.Header("Age", "100");
+        aged_resp.Header("ETag", "\"a\"");
+        StoreResponse(cache, aged, aged_resp);
+        found = Find(cache, aged);
+        if (!found.entry || found.usability != ResponseCache::Usability::STALE ||
+            found.age_sec < 100) {
+            pass = false; err += "Age header not applied; ";
+        }
+
+        const std::pair<const char*, HttpResponse> not_stored[] = {
+            {"/no-store", Cacheable("no-store, max-age=60")},
+            {"/private", Cacheable("private, max-age=60")},
+            {"/no-lifetime", Cacheable("public")},
+        };
+        for (const auto& [path, resp] : not_stored) {
+            auto req = MakeRequest("GET", path);
+            StoreResponse(cache, req, resp);
+            if (Find(cache, req).entry) { pass = false; err += std::string(path) + " stored; "; }
+        }
+        auto cookie = MakeRequest("GET", "/cookie");
+        auto cookie_resp = Cacheable("max-age=60");
+        cookie_resp.Header("Set-Cookie", "sid=1");
+        StoreResponse(cache, cookie, cookie_resp);
+        if (Find(cache, cookie).entry) { pass = false; err += "Set-Cookie stored; "; }
+
+        auto teapot = MakeRequest("GET", "/teapot");
+        HttpResponse teapot_resp;
+        teapot_resp.Status(418).Header("Cache-Control", "max-age=60");
+        StoreResponse(cache, teapot, teapot_resp);
+        if (Find(cache, teapot).entry) { pass = false; err += "418 stored; "; }
+
+        TestFramework::RecordTest("ProxyCache: storability and freshness", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: storability and freshness", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T3
+void TestStaleUsability() {
+    std::cout << "\n[TEST] ProxyCache: stale-while-revalidate / stale-if-error..." << std::endl;
+    try {
+        auto cache = std::make_shared<ResponseCache>(UnitConfig());
+        bool pass = true;
+        std::string err;
+        auto store_aged = [&](const std::string& path, const std::string& cc,
+                              const std::string& age) {
+            auto req = MakeRequest("GET", path);
+            auto resp = Cacheable(cc);
+            resp.Header("Age", age);
+            StoreResponse(cache, req, resp);
+            return Find(cache, req);
+        };
+        auto swr = store_aged("/swr", "max-age=10, stale-while-revalidate=30", "20");
+        if (!swr.entry ||
+            swr.usability != ResponseCache::Usability::STALE_WHILE_REVALIDATE) {
+            pass = false; err += "swr window not detected; ";
+        }
+        auto sie = store_aged("/sie", "max-age=10, stale-if-error=100", "50");
+        if (!sie.entry || sie.usability != ResponseCache::Usability::STALE_IF_ERROR) {
+            pass = false; err += "sie window not detected; ";
+        }
+        auto past = store_aged("/past", "max-age=10, stale-while-revalidate=5", "40");
+        if (past.entry && past.usability != ResponseCache::Usability::STALE) {
+            pass = false; err += "past swr window still usable; ";
+        }
+        auto mr = store_aged("/mr",
+                             "max-age=10, must-revalidate, stale-while-revalidate=30",
+                             "20");
+        if (!mr.entry || mr.usability != ResponseCache::Usability::STALE) {
+            pass = false; err += "must-revalidate served stale; ";
+        }
+        TestFramework::RecordTest("ProxyCache: stale-while-revalidate / stale-if-error",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: stale-while-revalidate / stale-if-error",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestVaryVariants() {
+    std::cout << "\n[TEST] ProxyCache: Vary selects variants..." << std::endl;
+    try {
+        auto cache = std::make_shared<ResponseCache>(UnitConfig());
+        bool pass = true;
+        std::string err;
+        auto gzip = MakeRequest("GET", "/v", {{"accept-encoding", "gzip"}});
+        auto plain = MakeRequest("GET", "/v");
+        auto br = MakeRequest("GET", "/v", {{"accept-encoding", "br"}});
+
+        auto gzip_resp = Cacheable("max-age=60", "gz-body");
+        gzip_resp.Header("Vary", "Accept-Encoding");
+        StoreResponse(cache, gzip, gzip_resp);
+        auto plain_resp = Cacheable("max-age=60", "plain-body");
+        plain_resp.Header("Vary", "accept-encoding");
+        StoreResponse(cache, plain, plain_resp);
+
+        auto hit = Find(cache, gzip);
+        if (!hit.entry ||
+            std::string(hit.entry->body->data(), hit.entry->body->size()) != "gz-body") {
+            pass = false; err += "gzip variant lost; ";
+        }
+        hit = Find(cache, plain);
+        if (!hit.entry ||
+            std::string(hit.entry->body->data(), hit.entry->body->size()) != "plain-body") {
+            pass = false; err += "absent-header variant lost; ";
+        }
+        auto miss = Find(cache, br);
+        if (miss.entry) { pass = false; err += "br matched another variant; "; }
+        if (miss.vary != std::vector<std::string>{"accept-encoding"}) {
+            pass = false; err += "miss did not report Vary names; ";
+        }
+
+        auto star = MakeRequest("GET", "/star");
+        auto star_resp = Cacheable("max-age=60");
+        star_resp.Header("Vary", "*");
+        StoreResponse(cache, star, star_resp);
+        if (Find(cache, star).entry) { pass = false; err += "Vary: * stored; "; }
+
+        TestFramework::RecordTest("ProxyCache: Vary selects variants", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: Vary selects variants", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestMemoryBudgetEviction() {
+    std::cout << "\n[TEST] ProxyCache: memory byte budget eviction..." << std::endl;
+    try {
+        ProxyCacheConfig config = UnitConfig();
+        config.memory_max_bytes = 20000;
+        config.max_object_bytes = 8000;
+        auto cache = std::make_shared<ResponseCache>(config);
+        const std::string body(6000, 'x');
+        for (int i = 0; i < 8; ++i) {
+            StoreResponse(cache, MakeRequest("GET", "/obj" + std::to_string(i)),
+                          Cacheable("max-age=60", body));
+        }
+        bool pass = true;
+        std::string err;
+        if (cache->memory_bytes() > config.memory_max_bytes) {
+            pass = false; err += "memory over budget: " +
+                                 std::to_string(cache->memory_bytes()) + "; ";
+        }
+        if (!Find(cache, MakeRequest("GET", "/obj7")).entry) {
+            pass = false; err += "newest entry evicted; ";
+        }
+        if (Find(cache, MakeRequest("GET", "/obj0")).entry) {
+            pass = false; err += "oldest entry survived; ";
+        }
+        if (cache->disk_entries() != 0) { pass = false; err += "disk used without disk_path; "; }
+
+        // Over max_object_bytes: relayed but never stored.
+        auto big = MakeRequest("GET", "/big");
+        StoreResponse(cache, big, Cacheable("max-age=60", std::string(9000, 'y')));
+        if (Find(cache, big).entry) { pass = false; err += "oversized object stored; "; }
+
+        TestFramework::RecordTest("ProxyCache: memory byte budget eviction", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: memory byte budget eviction", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T6
+void TestDiskTierDemotion() {
+    std::cout << "\n[TEST] ProxyCache: disk tier demotion..." << std::endl;
+    char dir_template[] = "/tmp/reactor-cache-test-XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    try {
+        if (!dir) throw std::runtime_error("mkdtemp failed");
+        ProxyCacheConfig config = UnitConfig();
+        config.memory_max_bytes = 10000;
+        config.max_object_bytes = 8000;
+        config.disk_path = dir;
+        config.disk_max_bytes = 1 << 20;
+        auto cache = std::make_shared<ResponseCache>(config);
+
+        const std::string first(7000, 'a');
+        StoreResponse(cache, MakeRequest("GET", "/first"), Cacheable("max-age=60", first));
+        StoreResponse(cache, MakeRequest("GET", "/second"),
+                      Cacheable("max-age=60", std::string(7000, 'b')));
+
+        bool pass = true;
+        std::string err;
+        if (!cache->disk_enabled()) { pass = false; err += "disk tier not enabled; "; }
+        auto found = Find(cache, MakeRequest("GET", "/first"));
+        if (!found.entry || !found.entry->body) {
+            pass = false; err += "demoted entry not found; ";
+        } else {
+            if (found.entry->body->tier() != ResponseCache::Tier::DISK) {
+                pass = false; err += "entry not on disk tier; ";
+            }
+            if (std::string(found.entry->body->data(), found.entry->body->size()) != first) {
+                pass = false; err += "disk body corrupted; ";
+            }
+        }
+        if (cache->disk_bytes() <= 0 || cache->memory_bytes() > config.memory_max_bytes) {
+            pass = false; err += "tier accounting wrong; ";
+        }
+        // Files are unlinked on creation: nothing left in the directory.
+        size_t files = 0;
+        if (DIR* d = opendir(dir)) {
+            while (dirent* e = readdir(d)) {
+                if (e->d_name[0] != '.') ++files;
+            }
+            closedir(d);
+        }
+        if (files != 0) { pass = false; err += "cache files left on disk; "; }
+
+        TestFramework::RecordTest("ProxyCache: disk tier demotion", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: disk tier demotion", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+    if (dir) rmdir(dir);
+}
+
+inline ServerConfig CachingGatewayConfig(int backend_port, const std::string& prefix,
+                                         int worker_threads = 1) {
+    UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+        "backend", "127.0.0.1", backend_port, prefix);
+    u.proxy.cache = true;
+    ServerConfig gw;
+    gw.bind_host = "127.0.0.1";
+    gw.bind_port = 0;
+    gw.worker_threads = worker_threads;
+    gw.http2.enabled = false;
+    gw.proxy_cache.enabled = true;
+    gw.upstreams.push_back(u);
+    return gw;
+}
+
+inline std::string Get(int port, const std::string& path) {
+    return TestHttpClient::SendHttpRequest(port,
+        "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n",
+        5000);
+}
+
+// T7
+void TestIntegrationHitAndInvalidate() {
+    std::cout << "\n[TEST] ProxyCache: max-age hit and POST invalidation..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/item", [&](const HttpRequest&, HttpResponse& resp) {
+            int n = ++hits;
+            resp.Status(200).Header("Cache-Control", "max-age=60")
+                .Body("v" + std::to_string(n), "text/plain");
+        });
+        backend.Post("/item", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(204);
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CachingGatewayConfig(backend_runner.GetPort(), "/item"));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string r1 = Get(port, "/item");
+        std::string r2 = Get(port, "/item");
+        bool pass = true;
+        std::string err;
+        if (TestHttpClient::ExtractBody(r1) != "v1" || TestHttpClient::ExtractBody(r2) != "v1") {
+            pass = false; err += "bodies: " + TestHttpClient::ExtractBody(r1) + "/" +
+                                 TestHttpClient::ExtractBody(r2) + "; ";
+        }
+        if (hits.load() != 1) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        if (r2.find("Age: ") == std::string::npos) { pass = false; err += "no Age on hit; "; }
+
+        TestHttpClient::SendHttpRequest(port,
+            "POST /item HTTP/1.1\r\nHost: localhost\r\nContent-Length: 0\r\n"
+            "Connection: close\r\n\r\n", 5000);
+        std::string r3 = Get(port, "/item");
+        if (TestHttpClient::ExtractBody(r3) != "v2") {
+            pass = false; err += "POST did not invalidate (got " +
+                                 TestHttpClient::ExtractBody(r3) + "); ";
+        }
+        TestFramework::RecordTest("ProxyCache: max-age hit and POST invalidation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: max-age hit and POST invalidation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T8
+void TestIntegrationCollapse() {
+    std::cout << "\n[TEST] ProxyCache: concurrent misses collapse..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/slow", [&](const HttpRequest&, HttpResponse& resp) {
+            ++hits;
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            resp.Status(200).Header("Cache-Control", "max-age=60").Body("slow", "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CachingGatewayConfig(backend_runner.GetPort(), "/slow", 2));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        constexpr int kClients = 6;
+        std::vector<std::string> bodies(kClients);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < kClients; ++i) {
+            clients.emplace_back([&, i]() {
+                bodies[i] = TestHttpClient::ExtractBody(Get(port, "/slow"));
+            });
+        }
+        for (auto& t : clients) t.join();
+
+        bool pass = true;
+        std::string err;
+        for (const auto& b : bodies) {
+            if (b != "slow") { pass = false; err += "client got '" + b + "'; "; break; }
+        }
+        if (hits.load() != 1) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("ProxyCache: concurrent misses collapse", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: concurrent misses collapse", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T9
+void TestIntegrationStaleWhileRevalidate() {
+    std::cout << "\n[TEST] ProxyCache: stale-while-revalidate..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/swr", [&](const HttpRequest&, HttpResponse& resp) {
+            int n = ++hits;
+            resp.Status(200).Header("Cache-Control", "max-age=1, stale-while-revalidate=30")
+                .Body("v" + std::to_string(n), "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CachingGatewayConfig(backend_runner.GetPort(), "/swr"));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string first = TestHttpClient::ExtractBody(Get(port, "/swr"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        std::string stale = TestHttpClient::ExtractBody(Get(port, "/swr"));
+        bool refreshed = ProxyTests::WaitFor([&]() { return hits.load() >= 2; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::string fresh = TestHttpClient::ExtractBody(Get(port, "/swr"));
+
+        bool pass = true;
+        std::string err;
+        if (first != "v1") { pass = false; err += "first=" + first + "; "; }
+        if (stale != "v1") { pass = false; err += "stale response=" + stale + "; "; }
+        if (!refreshed) { pass = false; err += "no background revalidation; "; }
+        if (fresh != "v2") { pass = false; err += "after refresh=" + fresh + "; "; }
+        if (hits.load() != 2) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("ProxyCache: stale-while-revalidate", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: stale-while-revalidate", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T10
+void TestIntegrationStaleIfError() {
+    std::cout << "\n[TEST] ProxyCache: stale-if-error..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/sie", [&](const HttpRequest&, HttpResponse& resp) {
+            if (++hits == 1) {
+                resp.Status(200).Header("Cache-Control", "max-age=1, stale-if-error=60")
+                    .Body("good", "text/plain");
+            } else {
+                resp.Status(500).Body("broken", "text/plain");
+            }
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CachingGatewayConfig(backend_runner.GetPort(), "/sie"));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string r1 = Get(port, "/sie");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        std::string r2 = Get(port, "/sie");
+
+        bool pass = true;
+        std::string err;
+        if (TestHttpClient::ExtractBody(r1) != "good") { pass = false; err += "first not good; "; }
+        if (!TestHttpClient::HasStatus(r2, 200) || TestHttpClient::ExtractBody(r2) != "good") {
+            pass = false; err += "stale entry not served on 500; ";
+        }
+        if (hits.load() != 2) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("ProxyCache: stale-if-error", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: stale-if-error", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T11
+void TestIntegrationRevalidation() {
+    std::cout << "\n[TEST] ProxyCache: 304 revalidation..." << std::endl;
+    try {
+        std::atomic<int> full{0};
+        std::atomic<int> not_modified{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/etag", [&](const HttpRequest& req, HttpResponse& resp) {
+            auto it = req.headers.find("if-none-match");
+            if (it != req.headers.end() && it->second == "\"v1\"") {
+                ++not_modified;
+                resp.Status(304).Header("ETag", "\"v1\"").Header("Cache-Control", "max-age=1");
+                return;
+            }
+            ++full;
+            resp.Status(200).Header("ETag", "\"v1\"").Header("Cache-Control", "max-age=1")
+                .Body("tagged", "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CachingGatewayConfig(backend_runner.GetPort(), "/etag"));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string r1 = Get(port, "/etag");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2100));
+        std::string r2 = Get(port, "/etag");
+        std::string r3 = Get(port, "/etag");
+
+        bool pass = true;
+        std::string err;
+        if (!TestHttpClient::HasStatus(r2, 200) || TestHttpClient::ExtractBody(r2) != "tagged") {
+            pass = false; err += "revalidated response not served whole; ";
+        }
+        if (TestHttpClient::ExtractBody(r3) != "tagged") { pass = false; err += "refreshed entry lost; "; }
+        if (full.load() != 1 || not_modified.load() != 1) {
+            pass = false; err += "full=" + std::to_string(full.load()) +
+                                 " 304s=" + std::to_string(not_modified.load()) + "; ";
+        }
+        TestFramework::RecordTest("ProxyCache: 304 revalidation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: 304 revalidation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T12
+void TestConfig() {
+    std::cout << "\n[TEST] ProxyCache: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "proxy_cache": {"enabled": true, "memory_max_bytes": 1048576,
+                            "max_object_bytes": 65536, "collapse_requests": false},
+            "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                           "proxy": {"route_prefix": "/svc", "cache": true}}]
+        })");
+        ConfigLoader::Validate(cfg);
+        if (!cfg.proxy_cache.enabled || cfg.proxy_cache.memory_max_bytes != 1048576 ||
+            cfg.proxy_cache.collapse_requests || !cfg.upstreams[0].proxy.cache) {
+            pass = false; err += "parse mismatch; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (again.proxy_cache != cfg.proxy_cache ||
+            !(again.upstreams[0].proxy == cfg.upstreams[0].proxy)) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+
+        cfg.proxy_cache.max_object_bytes = cfg.proxy_cache.memory_max_bytes + 1;
+        try {
+            ConfigLoader::Validate(cfg);
+            pass = false; err += "max_object_bytes > memory_max_bytes accepted; ";
+        } catch (const std::invalid_argument& e) {
+            if (std::string(e.what()).find("max_object_bytes") == std::string::npos) {
+                pass = false; err += std::string("wrong error: ") + e.what() + "; ";
+            }
+        }
+        TestFramework::RecordTest("ProxyCache: config round-trip and validation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("ProxyCache: config round-trip and validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== Proxy Response Cache Tests ===" << std::endl;
+    TestClassifyRequest();
+    TestStorabilityAndFreshness();
+    TestStaleUsability();
+    TestVaryVariants();
+    TestMemoryBudgetEviction();
+    TestDiskTierDemotion();
+    TestIntegrationHitAndInvalidate();
+    TestIntegrationCollapse();
+    TestIntegrationStaleWhileRevalidate();
+    TestIntegrationStaleIfError();
+    TestIntegrationRevalidation();
+    TestConfig();
+}
+
+}  // namespace ProxyCacheTests
@@ -4057,6 +4057,299 @@ void TestIntegrationBackoffDoesNotBlockOtherRequests() {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Section 15: Integration tests -- multi-endpoint load balancing
+// ---------------------------------------------------------------------------
+
+// Gateway with one upstream spread over two backends that answer with
+// their own name. Returns the body of each response in order ("" on a
+// non-200).
+static std::vector<std::string> SendThroughBalancedGateway(
+        const std::string& policy, const std::string& hash_key,
+        int weight_a, int weight_b,
+        const std::vector<std::string>& users) {
+    HttpServer backend_a("127.0.0.1", 0);
+    backend_a.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+        resp.Status(200).Body("a", "text/plain");
+    });
+    HttpServer backend_b("127.0.0.1", 0);
+    backend_b.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+        resp.Status(200).Body("b", "text/plain");
+    });
+    TestServerRunner<HttpServer> runner_a(backend_a);
+    TestServerRunner<HttpServer> runner_b(backend_b);
+
+    ServerConfig gw_config;
+    gw_config.bind_host = "127.0.0.1";
+    gw_config.bind_port = 0;
+    // One dispatcher: round-robin state is per dispatcher, so a single
+    // one makes the expected split exact.
+    gw_config.worker_threads = 1;
+    UpstreamConfig u = MakeProxyUpstreamConfig(
+        "backend", "127.0.0.1", runner_a.GetPort(), "/who");
+    UpstreamEndpointConfig a, b;
+    a.host = "127.0.0.1"; a.port = runner_a.GetPort(); a.weight = weight_a;
+    b.host = "127.0.0.1"; b.port = runner_b.GetPort(); b.weight = weight_b;
+    u.endpoints = {a, b};
+    u.load_balancer.policy = policy;
+    u.load_balancer.hash_key = hash_key;
+    gw_config.upstreams.push_back(u);
+
+    HttpServer gateway(gw_config);
+    TestServerRunner<HttpServer> gw_runner(gateway);
+    int gw_port = gw_runner.GetPort();
+
+    std::vector<std::string> bodies;
+    for (const auto& user : users) {
+        std::string req = "GET /who HTTP/1.1\r\nHost: localhost\r\n";
+        if (!user.empty()) req += "X-User: " + user + "\r\n";
+        req += "Connection: close\r\n\r\n";
+        std::string resp = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+        bodies.push_back(TestHttpClient::HasStatus(resp, 200)
+                             ? TestHttpClient::ExtractBody(resp) : "");
+    }
+    return bodies;
+}
+
+// round_robin alternates evenly; weighted 3:1 sends exactly three of every
+// four requests to the heavy endpoint.
+void TestIntegrationLoadBalancerRoundRobinAndWeighted() {
+    std::cout << "\n[TEST] Integration: round_robin and weighted endpoint split..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        std::vector<std::string> eight(8);
+
+        auto rr = SendThroughBalancedGateway("round_robin", "client_ip", 1, 1, eight);
+        int rr_a = static_cast<int>(std::count(rr.begin(), rr.end(), "a"));
+        int rr_b = static_cast<int>(std::count(rr.begin(), rr.end(), "b"));
+        if (rr_a != 4 || rr_b != 4) {
+            pass = false;
+            err += "round_robin a=" + std::to_string(rr_a) +
+                   " b=" + std::to_string(rr_b) + "; ";
+        }
+
+        auto wr = SendThroughBalancedGateway("weighted", "client_ip", 3, 1, eight);
+        int wr_a = static_cast<int>(std::count(wr.begin(), wr.end(), "a"));
+        int wr_b = static_cast<int>(std::count(wr.begin(), wr.end(), "b"));
+        if (wr_a != 6 || wr_b != 2) {
+            pass = false;
+            err += "weighted a=" + std::to_string(wr_a) +
+                   " b=" + std::to_string(wr_b) + "; ";
+        }
+
+        TestFramework::RecordTest("Integration: round_robin and weighted endpoint split", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Integration: round_robin and weighted endpoint split", false, e.what());
+    }
+}
+
+// ring_hash and maglev keyed on a header: every user sticks to one
+// backend across requests, and the user population uses both.
+void TestIntegrationLoadBalancerHashAffinity() {
+    std::cout << "\n[TEST] Integration: ring_hash/maglev header affinity..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        std::vector<std::string> users;
+        for (int i = 0; i < 12; ++i) {
+            users.push_back("user-" + std::to_string(i));
+            users.push_back("user-" + std::to_string(i));
+        }
+
+        for (const std::string policy : {"ring_hash", "maglev"}) {
+            auto bodies = SendThroughBalancedGateway(
+                policy, "header:x-user", 1, 1, users);
+            std::set<std::string> used;
+            for (size_t i = 0; i + 1 < bodies.size(); i += 2) {
+                if (bodies[i].empty() || bodies[i] != bodies[i + 1]) {
+                    pass = false;
+                    err += policy + " " + users[i] + " not sticky; ";
+                    break;
+                }
+                used.insert(bodies[i]);
+            }
+            if (used.size() != 2) {
+                pass = false;
+                err += policy + " used " + std::to_string(used.size()) + " backend(s); ";
+            }
+        }
+
+        TestFramework::RecordTest("Integration: ring_hash/maglev header affinity", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Integration: ring_hash/maglev header affinity", false, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Section 16: Integration tests -- active health checks
+// ---------------------------------------------------------------------------
+
+// Backend "a" serves traffic but fails its health endpoint: once the
+// checks mark it unhealthy, round-robin sends everything to "b". With
+// both failing and the breaker enforcing, requests fail fast with the
+// circuit-open 503 instead of reaching a backend.
+void TestIntegrationHealthCheckRouting() {
+    std::cout << "\n[TEST] Integration: health checks gate endpoint selection..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        auto health_a = std::make_shared<std::atomic<int>>(503);
+        auto health_b = std::make_shared<std::atomic<int>>(200);
+        HttpServer backend_a("127.0.0.1", 0);
+        backend_a.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(200).Body("a", "text/plain");
+        });
+        backend_a.Get("/health", [health_a](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(health_a->load()).Body("", "text/plain");
+        });
+        HttpServer backend_b("127.0.0.1", 0);
+        backend_b.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(200).Body("b", "text/plain");
+        });
+        backend_b.Get("/health", [health_b](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(health_b->load()).Body("", "text/plain");
+        });
+        TestServerRunner<HttpServer> runner_a(backend_a);
+        TestServerRunner<HttpServer> runner_b(backend_b);
+
+        ServerConfig gw_config;
+        gw_config.bind_host = "127.0.0.1";
+        gw_config.bind_port = 0;
+        gw_config.worker_threads = 1;
+        UpstreamConfig u = MakeProxyUpstreamConfig(
+            "backend", "127.0.0.1", runner_a.GetPort(), "/who");
+        UpstreamEndpointConfig a, b;
+        a.host = "127.0.0.1"; a.port = runner_a.GetPort();
+        b.host = "127.0.0.1"; b.port = runner_b.GetPort();
+        u.endpoints = {a, b};
+        u.health_check.enabled = true;
+        u.health_check.interval_ms = 100;
+        u.health_check.timeout_ms = 80;
+        u.health_check.jitter_percent = 0;
+        u.health_check.unhealthy_threshold = 1;
+        u.health_check.healthy_threshold = 1;
+        u.circuit_breaker.enabled = true;
+        gw_config.upstreams.push_back(u);
+
+        HttpServer gateway(gw_config);
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int gw_port = gw_runner.GetPort();
+        const std::string req =
+            "GET /who HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+        // A couple of check intervals for the first verdicts.
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        for (int i = 0; i < 6; ++i) {
+            std::string resp = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+            if (!TestHttpClient::HasStatus(resp, 200) ||
+                TestHttpClient::ExtractBody(resp) != "b") {
+                pass = false; err += "request " + std::to_string(i) +
+                                     " not served by healthy b; ";
+                break;
+            }
+        }
+
+        health_b->store(500);
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        std::string rejected = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+        if (!TestHttpClient::HasStatus(rejected, 503) ||
+            rejected.find("circuit breaker") == std::string::npos) {
+            pass = false; err += "no fast-fail with every endpoint unhealthy; ";
+        }
+
+        health_a->store(200);
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        std::string recovered = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+        if (!TestHttpClient::HasStatus(recovered, 200) ||
+            TestHttpClient::ExtractBody(recovered) != "a") {
+            pass = false; err += "recovered endpoint not used; ";
+        }
+
+        TestFramework::RecordTest("Integration: health checks gate endpoint selection", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Integration: health checks gate endpoint selection", false, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Section 17: Integration tests -- passive outlier detection
+// ---------------------------------------------------------------------------
+
+// An endpoint that answers every request with 500 is ejected after
+// consecutive_5xx failures of live traffic; the rest of the traffic
+// lands on the healthy endpoint while the ejection lasts.
+void TestIntegrationOutlierEjection() {
+    std::cout << "\n[TEST] Integration: outlier detection ejects a 5xx endpoint..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        HttpServer backend_a("127.0.0.1", 0);
+        backend_a.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(500).Body("a", "text/plain");
+        });
+        HttpServer backend_b("127.0.0.1", 0);
+        backend_b.Get("/who", [](const HttpRequest&, HttpResponse& resp) {
+            resp.Status(200).Body("b", "text/plain");
+        });
+        TestServerRunner<HttpServer> runner_a(backend_a);
+        TestServerRunner<HttpServer> runner_b(backend_b);
+
+        ServerConfig gw_config;
+        gw_config.bind_host = "127.0.0.1";
+        gw_config.bind_port = 0;
+        gw_config.worker_threads = 1;
+        UpstreamConfig u = MakeProxyUpstreamConfig(
+            "backend", "127.0.0.1", runner_a.GetPort(), "/who");
+        UpstreamEndpointConfig a, b;
+        a.host = "127.0.0.1"; a.port = runner_a.GetPort();
+        b.host = "127.0.0.1"; b.port = runner_b.GetPort();
+        u.endpoints = {a, b};
+        u.circuit_breaker.enabled = true;
+        // Keep the service-wide breaker out of the way: only the
+        // per-endpoint detector should react.
+        u.circuit_breaker.consecutive_failure_threshold = 100;
+        u.circuit_breaker.minimum_volume = 1000;
+        u.circuit_breaker.outlier_detection.enabled = true;
+        u.circuit_breaker.outlier_detection.consecutive_5xx = 3;
+        u.circuit_breaker.outlier_detection.base_ejection_time_ms = 60000;
+        gw_config.upstreams.push_back(u);
+
+        HttpServer gateway(gw_config);
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int gw_port = gw_runner.GetPort();
+        const std::string req =
+            "GET /who HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+
+        // Round robin alternates a/b, so a has failed three times in a
+        // row by the sixth request.
+        int a_hits = 0;
+        for (int i = 0; i < 6; ++i) {
+            std::string resp = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+            if (TestHttpClient::ExtractBody(resp) == "a") ++a_hits;
+        }
+        if (a_hits != 3) {
+            pass = false; err += "expected 3 requests on a before ejection, got " +
+                                 std::to_string(a_hits) + "; ";
+        }
+        for (int i = 0; i < 6; ++i) {
+            std::string resp = TestHttpClient::SendHttpRequest(gw_port, req, 5000);
+            if (!TestHttpClient::HasStatus(resp, 200) ||
+                TestHttpClient::ExtractBody(resp) != "b") {
+                pass = false; err += "request " + std::to_string(i) +
+                                     " after ejection not served by b; ";
+                break;
+            }
+        }
+
+        TestFramework::RecordTest("Integration: outlier detection ejects a 5xx endpoint", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Integration: outlier detection ejects a 5xx endpoint", false, e.what());
+    }
+}
+
 // ---------------------------------------------------------------------------
 // RunAllTests
 // ---------------------------------------------------------------------------
@@ -4158,6 +4451,16 @@ void RunAllTests() {
     TestIntegrationMaxRetriesExhaustedStillRelaysUpstream5xx();
     TestIntegrationConnectFailureFirstRetryIsImmediate();
     TestIntegrationBackoffDoesNotBlockOtherRequests();
+
+    // Section 15: Integration tests -- multi-endpoint load balancing
+    TestIntegrationLoadBalancerRoundRobinAndWeighted();
+    TestIntegrationLoadBalancerHashAffinity();
+
+    // Section 16: Integration tests -- active health checks
+    TestIntegrationHealthCheckRouting();
+
+    // Section 17: Integration tests -- passive outlier detection
+    TestIntegrationOutlierEjection();
 }
 
 } // namespace ProxyTests
@@ -0,0 +1,402 @@
+#pragma once
+
+// replay_buffer_test.h — retrying streamed request bodies
+// (proxy.retry.replay_buffer).
+//
+// Test dimensions:
+//   Unit (ReplayBodyStream over a ChunkQueueBodyStream, no sockets):
+//     T1  Rewind replays recorded bytes, memory and spilled, then
+//         continues from the source
+//     T2  A body past max_bytes drops the recording; StopRecording
+//         mid-replay still delivers the rest of the recording
+//   Integration (streaming upload through a gateway to a scripted backend):
+//     T3  Backend resets mid-upload: the retry resends the whole body
+//     T4  Same reset with a body larger than max_bytes: retry refused, 502
+//   Config:
+//     T5  proxy.retry.replay_buffer JSON round-trip and validation
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "http/http_server.h"
+#include "http/body_stream_impl.h"
+#include "upstream/replay_body_stream.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ReplayBufferTests {
+
+inline std::string ReadAll(http::BodyStream& stream, size_t chunk = 7) {
+    std::string out;
+    char buf[64];
+    size_t n = 0;
+    while (stream.Read(buf, std::min(chunk, sizeof(buf)), &n) ==
+           http::BodyStreamResult::OK) {
+        out.append(buf, n);
+    }
+    return out;
+}
+
+inline ProxyReplayBufferConfig ReplayConfig(int64_t max_bytes, int64_t memory_bytes) {
+    ProxyReplayBufferConfig config;
+    config.max_bytes = max_bytes;
+    config.memory_bytes = memory_bytes;
+    config.spill_dir = "/tmp";
+    return config;
+}
+
+// T1
+void TestRewind() {
+    std::cout << "\n[TEST] Replay buffer: rewind replays memory and spilled bytes..." << std::endl;
+    try {
+        auto source = std::make_shared<http::ChunkQueueBodyStream>(
+            http::ChunkQueueBodyStream::Config{});
+        // 10 bytes in memory, the rest spilled to the temp file.
+        ReplayBodyStream replay(source, ReplayConfig(1024, 10));
+
+        bool pass = true;
+        std::string err;
+        source->Push("0123456789abcdefghij");
+        std::string first = ReadAll(replay);
+        if (first != "0123456789abcdefghij") { pass = false; err += "first pass '" + first + "'; "; }
+        if (replay.spilled_bytes() != 10) {
+            pass = false; err += "spilled=" + std::to_string(replay.spilled_bytes()) + "; ";
+        }
+
+        if (!replay.Rewind()) { pass = false; err += "rewind refused; "; }
+        if (replay.BytesQueued() != 20 || replay.IsEndOfStream()) {
+            pass = false; err += "rewound stream looks empty; ";
+        }
+        source->Push("KLMNO");
+        source->CloseEmpty();
+        std::string second = ReadAll(replay);
+        if (second != "0123456789abcdefghijKLMNO") { pass = false; err += "replay '" + second + "'; "; }
+        if (!replay.IsEndOfStream()) { pass = false; err += "no EOS after replay; "; }
+
+        // A second retry replays everything, including the bytes read
+        // after the first rewind.
+        if (!replay.Rewind()) { pass = false; err += "second rewind refused; "; }
+        std::string third = ReadAll(replay, 64);
+        if (third != "0123456789abcdefghijKLMNO") { pass = false; err += "second replay '" + third + "'; "; }
+        TestFramework::RecordTest("Replay buffer: rewind replays memory and spilled bytes",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Replay buffer: rewind replays memory and spilled bytes",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestLimits() {
+    std::cout << "\n[TEST] Replay buffer: max_bytes and StopRecording..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        {
+            auto source = std::make_shared<http::ChunkQueueBodyStream>(
+                http::ChunkQueueBodyStream::Config{});
+            ReplayBodyStream replay(source, ReplayConfig(8, 8));
+            source->Push("0123456789");
+            std::string got = ReadAll(replay);
+            if (got != "0123456789") { pass = false; err += "pass-through '" + got + "'; "; }
+            if (replay.recording() || replay.Rewind()) {
+                pass = false; err += "oversized body still rewindable; ";
+            }
+        }
+        {
+            auto source = std::make_shared<http::ChunkQueueBodyStream>(
+                http::ChunkQueueBodyStream::Config{});
+            ReplayBodyStream replay(source, ReplayConfig(64, 64));
+            source->Push("abcdef");
+            ReadAll(replay);
+            replay.Rewind();
+            char buf[2];
+            size_t n = 0;
+            replay.Read(buf, sizeof(buf), &n);
+            replay.StopRecording();
+            source->Push("XY");
+            std::string rest = ReadAll(replay);
+            if (rest != "cdefXY") { pass = false; err += "after stop '" + rest + "'; "; }
+            if (replay.recording() || replay.Rewind()) {
+                pass = false; err += "stopped recording still rewindable; ";
+            }
+        }
+        TestFramework::RecordTest("Replay buffer: max_bytes and StopRecording", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Replay buffer: max_bytes and StopRecording", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Accepts connections one at a time. The first session reads the head
+// and part of the chunked body, then resets the connection; later
+// sessions read the whole body and answer 200 with its length.
+class ResettingUploadBackend {
+public:
+    explicit ResettingUploadBackend(size_t reset_after_bytes)
+        : reset_after_bytes_(reset_after_bytes) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) throw std::runtime_error("socket() failed");
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        socklen_t len = sizeof(addr);
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listen_fd_, 4) != 0 ||
+            getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            close(listen_fd_);
+            throw std::runtime_error("bind/listen failed");
+        }
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    ~ResettingUploadBackend() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        if (thread_.joinable()) thread_.join();
+    }
+
+    int GetPort() const { return port_; }
+    int sessions() const { return sessions_.load(); }
+    // Decoded body of the last complete upload.
+    std::string body() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return body_;
+    }
+
+private:
+    void Run() {
+        while (true) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) return;
+            const int session = sessions_++;
+            std::string raw;
+            char buf[16384];
+            size_t head_end = std::string::npos;
+            bool done = false;
+            while (!done) {
+                ssize_t n = recv(fd, buf, sizeof(buf), 0);
+                if (n <= 0) break;
+                raw.append(buf, static_cast<size_t>(n));
+                if (head_end == std::string::npos) {
+                    head_end = raw.find("\r\n\r\n");
+                    if (head_end == std::string::npos) continue;
+                }
+                const size_t body_bytes = raw.size() - head_end - 4;
+                if (session == 0 && body_bytes >= reset_after_bytes_) {
+                    struct linger lg{1, 0};
+                    setsockopt(fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+                    break;
+                }
+                done = raw.size() >= 5 && raw.compare(raw.size() - 5, 5, "0\r\n\r\n") == 0;
+            }
+            if (done) {
+                std::string decoded = Dechunk(raw.substr(head_end + 4));
+                {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    body_ = decoded;
+                }
+                std::string size = std::to_string(decoded.size());
+                std::string resp = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                                   std::to_string(size.size()) +
+                                   "\r\nConnection: close\r\n\r\n" + size;
+                send(fd, resp.data(), resp.size(), MSG_NOSIGNAL);
+            }
+            close(fd);
+        }
+    }
+
+    static std::string Dechunk(const std::string& in) {
+        std::string out;
+        size_t pos = 0;
+        while (pos < in.size()) {
+            size_t eol = in.find("\r\n", pos);
+            if (eol == std::string::npos) break;
+            size_t len = std::stoul(in.substr(pos, eol - pos), nullptr, 16);
+            if (len == 0) break;
+            out.append(in, eol + 2, len);
+            pos = eol + 2 + len + 2;
+        }
+        return out;
+    }
+
+    const size_t reset_after_bytes_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<int> sessions_{0};
+    mutable std::mutex mtx_;
+    std::string body_;
+    std::thread thread_;
+};
+
+inline ServerConfig ReplayGatewayConfig(int backend_port, int64_t max_bytes) {
+    ServerConfig gw;
+    gw.bind_host = "127.0.0.1";
+    gw.bind_port = 0;
+    gw.worker_threads = 1;
+    gw.http2.enabled = false;
+    UpstreamConfig u;
+    u.name = "backend";
+    u.host = "127.0.0.1";
+    u.port = backend_port;
+    u.pool.max_connections = 4;
+    u.pool.max_idle_connections = 2;
+    u.pool.connect_timeout_ms = 3000;
+    u.proxy.route_prefix = "/upload";
+    u.proxy.response_timeout_ms = 5000;
+    u.proxy.retry.max_retries = 1;
+    u.proxy.retry.replay_buffer = ReplayConfig(max_bytes, 16384);
+    u.request_mode = http::RouteRequestMode::Streaming;
+    gw.upstreams.push_back(u);
+    return gw;
+}
+
+inline std::string UploadBody() {
+    std::string body(300 * 1024, '\0');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = static_cast<char>('a' + (i * 7) % 26);
+    }
+    return body;
+}
+
+inline std::string Put(int port, const std::string& body) {
+    return TestHttpClient::SendHttpRequest(port,
+        "PUT /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: " +
+        std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body,
+        10000);
+}
+
+// T3
+void TestIntegrationRetryAfterReset() {
+    std::cout << "\n[TEST] Replay buffer: upload retried after a mid-body reset..." << std::endl;
+    try {
+        ResettingUploadBackend backend(64 * 1024);
+        HttpServer gateway(ReplayGatewayConfig(backend.GetPort(), 1024 * 1024));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        const std::string body = UploadBody();
+        std::string resp = Put(gw_runner.GetPort(), body);
+
+        bool pass = true;
+        std::string err;
+        if (!TestHttpClient::HasStatus(resp, 200) ||
+            TestHttpClient::ExtractBody(resp) != std::to_string(body.size())) {
+            pass = false; err += "client got '" + resp.substr(0, 200) + "'; ";
+        }
+        if (backend.sessions() != 2) {
+            pass = false; err += "sessions=" + std::to_string(backend.sessions()) + "; ";
+        }
+        if (backend.body() != body) { pass = false; err += "retried body differs; "; }
+        TestFramework::RecordTest("Replay buffer: upload retried after a mid-body reset",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Replay buffer: upload retried after a mid-body reset",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestIntegrationOversizedNotRetried() {
+    std::cout << "\n[TEST] Replay buffer: body past max_bytes is not retried..." << std::endl;
+    try {
+        ResettingUploadBackend backend(64 * 1024);
+        HttpServer gateway(ReplayGatewayConfig(backend.GetPort(), 32 * 1024));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+
+        std::string resp = Put(gw_runner.GetPort(), UploadBody());
+
+        bool pass = true;
+        std::string err;
+        if (!TestHttpClient::HasStatus(resp, 502)) {
+            pass = false; err += "client got '" + resp.substr(0, 200) + "'; ";
+        }
+        if (backend.sessions() != 1) {
+            pass = false; err += "sessions=" + std::to_string(backend.sessions()) + "; ";
+        }
+        TestFramework::RecordTest("Replay buffer: body past max_bytes is not retried",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Replay buffer: body past max_bytes is not retried",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestConfig() {
+    std::cout << "\n[TEST] Replay buffer: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                           "proxy": {"route_prefix": "/svc",
+                                     "retry": {"max_retries": 2,
+                                               "replay_buffer": {"max_bytes": 1048576,
+                                                                 "memory_bytes": 4096,
+                                                                 "spill_dir": "/var/tmp"}}}}]
+        })");
+        ConfigLoader::Validate(cfg);
+        const auto& rb = cfg.upstreams[0].proxy.retry.replay_buffer;
+        if (rb.max_bytes != 1048576 || rb.memory_bytes != 4096 || rb.spill_dir != "/var/tmp") {
+            pass = false; err += "parse mismatch; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (!(again.upstreams[0].proxy == cfg.upstreams[0].proxy)) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+
+        auto expect_invalid = [&](ProxyReplayBufferConfig bad_rb, const char* field) {
+            ServerConfig bad = cfg;
+            bad.upstreams[0].proxy.retry.replay_buffer = bad_rb;
+            try {
+                ConfigLoader::Validate(bad);
+                pass = false; err += std::string(field) + " accepted; ";
+            } catch (const std::invalid_argument& e) {
+                if (std::string(e.what()).find(field) == std::string::npos) {
+                    pass = false; err += std::string("wrong error: ") + e.what() + "; ";
+                }
+            }
+        };
+        expect_invalid(ReplayConfig(-1, 0), "max_bytes");
+        ProxyReplayBufferConfig no_dir = ReplayConfig(8192, 4096);
+        no_dir.spill_dir.clear();
+        expect_invalid(no_dir, "spill_dir");
+        try {
+            ConfigLoader::LoadFromString(R"({
+                "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                               "proxy": {"retry": {"replay_buffer": {"max_bytes": "1M"}}}}]
+            })");
+            pass = false; err += "string max_bytes accepted; ";
+        } catch (const std::runtime_error&) {
+        }
+        TestFramework::RecordTest("Replay buffer: config round-trip and validation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Replay buffer: config round-trip and validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== Proxy Replay Buffer Tests ===" << std::endl;
+    TestRewind();
+    TestLimits();
+    TestIntegrationRetryAfterReset();
+    TestIntegrationOversizedNotRetried();
+    TestConfig();
+}
+
+}  // namespace ReplayBufferTests
@@ -70,6 +70,18 @@
 #include "observability_pool_gauges_test.h"
 #include "streaming_request_test.h"
 #include "h2_trailer_test.h"
+#include "http3_test.h"
+#include "early_hints_test.h"
+#include "grpc_test.h"
+#include "websocket_deflate_test.h"
+#include "websocket_broadcast_test.h"
+#include "websocket_streaming_test.h"
+#include "ws_proxy_test.h"
+#include "proxy_cache_test.h"
+#include "singleflight_test.h"
+#include "hedging_test.h"
+#include "replay_buffer_test.h"
+#include "pool_prewarm_test.h"
 #include "test_framework.h"
 #include <algorithm>
 #include <sys/resource.h>
@@ -346,6 +358,43 @@ void RunAllTest(){
     // verifying trailing HEADERS frames reach a real H2 client.
     H2TrailerTests::RunAllH2TrailerTests();
 
+    // Experimental HTTP/3-framed UDP listener — varint/QPACK codec units
+    // and loopback integration through the router and async handlers.
+    Http3Tests::RunAllTests();
+
+    // 103 Early Hints — Link helpers, route-declared hints, proxy relay.
+    EarlyHintsTests::RunAllTests();
+
+    // gRPC proxy mode — status/timeout helpers, framing, retry + deadline.
+    GrpcTests::RunAllTests();
+
+    // WebSocket permessage-deflate — negotiation, codec, budget, echo.
+    WebSocketDeflateTests::RunAllTests();
+
+    // WebSocket topic broadcast — fan-out, pruning, slow consumers.
+    WebSocketBroadcastTests::RunAllTests();
+
+    // WebSocket streaming delivery — chunk callback, incremental UTF-8, pause.
+    WebSocketStreamingTests::RunAllTests();
+
+    // WebSocket proxy tunnels — upgrade relay, splice, backpressure.
+    WsProxyTests::RunAllTests();
+
+    // Proxy response cache — freshness, Vary, tiers, collapsing, stale.
+    ProxyCacheTests::RunAllTests();
+
+    // Proxy request coalescing — shared transaction, streamed replay.
+    SingleflightTests::RunAllTests();
+
+    // Proxy hedging — delayed second attempt, first response wins.
+    HedgingTests::RunAllTests();
+
+    // Streamed request replay buffer — retries after body bytes were sent.
+    ReplayBufferTests::RunAllTests();
+
+    // Upstream pool pre-warming — min idle floor, adaptive floor.
+    PoolPrewarmTests::RunAllTests();
+
     std::cout << "====================================\n" << std::endl;
 }
 
@@ -459,6 +508,30 @@ void PrintUsage(const char* program_name) {
     std::cout << "  h2_trailer             H2 trailer sanitizer tests — IsForbiddenH2TrailerName," << std::endl;
     std::cout << "                         SanitizeHttp2TrailerField, outbound emit filtering," << std::endl;
     std::cout << "                         and trailing HEADERS integration (real H2 client)" << std::endl;
+    std::cout << "  http3                  Experimental HTTP/3 UDP listener — varint / QPACK codec," << std::endl;
+    std::cout << "                         request parsing, packetization, loopback integration" << std::endl;
+    std::cout << "  early_hints            103 Early Hints — Link value helpers, route-declared hints," << std::endl;
+    std::cout << "                         async Send(), upstream 103 relay, config validation" << std::endl;
+    std::cout << "  grpc                   gRPC proxy mode — grpc-timeout / grpc-status helpers, message" << std::endl;
+    std::cout << "                         framing, status retry, deadline propagation, config" << std::endl;
+    std::cout << "  ws_deflate             WebSocket permessage-deflate — negotiation, codec, memory" << std::endl;
+    std::cout << "                         budget, RSV1 gating, compressed echo, config" << std::endl;
+    std::cout << "  ws_broadcast           WebSocket topic broadcast — cross-dispatcher fan-out, unsubscribe," << std::endl;
+    std::cout << "                         pruning, slow-consumer drop / disconnect" << std::endl;
+    std::cout << "  ws_streaming           WebSocket streaming delivery — chunk callback, incremental UTF-8," << std::endl;
+    std::cout << "                         parser pieces, read-pump pause / resume" << std::endl;
+    std::cout << "  ws_proxy               WebSocket proxy tunnels — upstream handshake relay, byte splice," << std::endl;
+    std::cout << "                         backpressure, tunnel stats" << std::endl;
+    std::cout << "  proxy_cache            Proxy response cache — freshness, Vary, memory/disk tiers," << std::endl;
+    std::cout << "                         request collapsing, stale-while-revalidate / stale-if-error" << std::endl;
+    std::cout << "  singleflight           Proxy request coalescing — shared upstream transaction," << std::endl;
+    std::cout << "                         streamed body replay to late joiners, coalescing key" << std::endl;
+    std::cout << "  hedging                Proxy hedged requests — fixed / percentile delay," << std::endl;
+    std::cout << "                         first response wins, retry-budget cap" << std::endl;
+    std::cout << "  replay_buffer          Streamed request replay buffer — rewind, disk spill," << std::endl;
+    std::cout << "                         retry after a mid-upload reset, max_bytes fallback" << std::endl;
+    std::cout << "  pool_prewarm           Upstream pool pre-warming — min idle floor, adaptive" << std::endl;
+    std::cout << "                         floor from checkout rate, connect-wait counter" << std::endl;
     std::cout << std::endl;
     std::cout << "  dns,         -D    Run the full DNS / dual-stack feature family" << std::endl;
     std::cout << "                     (DnsResolver primitives + dual-stack integration)" << std::endl;
@@ -708,6 +781,42 @@ int main(int argc, char* argv[]) {
         // H2 trailer sanitizer — per-field classification + integration.
         }else if(mode == "h2_trailer"){
             H2TrailerTests::RunAllH2TrailerTests();
+        // Experimental HTTP/3 UDP listener — codec units + loopback integration.
+        }else if(mode == "http3"){
+            Http3Tests::RunAllTests();
+        // 103 Early Hints — helpers, route hints, proxy relay.
+        }else if(mode == "early_hints"){
+            EarlyHintsTests::RunAllTests();
+        // gRPC proxy mode — helpers, framing, retry, deadline.
+        }else if(mode == "grpc"){
+            GrpcTests::RunAllTests();
+        // WebSocket permessage-deflate.
+        }else if(mode == "ws_deflate"){
+            WebSocketDeflateTests::RunAllTests();
+        // WebSocket topic broadcast.
+        }else if(mode == "ws_broadcast"){
+            WebSocketBroadcastTests::RunAllTests();
+        // WebSocket streaming delivery.
+        }else if(mode == "ws_streaming"){
+            WebSocketStreamingTests::RunAllTests();
+        // WebSocket proxy tunnels.
+        }else if(mode == "ws_proxy"){
+            WsProxyTests::RunAllTests();
+        // Proxy response cache.
+        }else if(mode == "proxy_cache"){
+            ProxyCacheTests::RunAllTests();
+        // Proxy request coalescing.
+        }else if(mode == "singleflight"){
+            SingleflightTests::RunAllTests();
+        // Proxy hedged requests.
+        }else if(mode == "hedging"){
+            HedgingTests::RunAllTests();
+        // Streamed request replay buffer.
+        }else if(mode == "replay_buffer"){
+            ReplayBufferTests::RunAllTests();
+        // Upstream pool pre-warming.
+        }else if(mode == "pool_prewarm"){
+            PoolPrewarmTests::RunAllTests();
         // Show help
         }else if(mode == "help" || mode == "-h" || mode == "--help"){
             PrintUsage(argv[0]);
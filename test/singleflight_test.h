@@ -0,0 +1,319 @@
+#pragma once
+
+// singleflight_test.h — request coalescing on proxy routes
+// (proxy.singleflight).
+//
+// Test dimensions:
+//   Unit (SingleflightGroup in-process, no sockets):
+//     T1  KeyFor: GET/HEAD keyed by method, Host, path, query and key
+//         headers; bodies, unsafe methods, HTTP/1.0 and unkeyed
+//         Authorization / Cookie / Range are not coalesced
+//   Integration (backend behind a coalescing gateway):
+//     T2  Concurrent identical slow GETs share one upstream request
+//     T3  A client joining a streamed response mid-body is replayed the
+//         head and the chunks so far, then follows the live stream
+//     T4  Different key_header values and unkeyed Authorization go to
+//         the upstream separately
+//   Config:
+//     T5  proxy.singleflight JSON round-trip and validation
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "proxy_test.h"  // MakeProxyUpstreamConfig, RawHttpBackendServer
+#include "http/http_server.h"
+#include "http/http_request.h"
+#include "http/http_response.h"
+#include "upstream/singleflight.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace SingleflightTests {
+
+inline HttpRequest MakeRequest(const std::string& method, const std::string& path,
+                               std::map<std::string, std::string> headers = {}) {
+    HttpRequest req;
+    req.method = method;
+    req.path = path;
+    req.headers = std::move(headers);
+    req.headers.emplace("host", "example.test");
+    return req;
+}
+
+// T1
+void TestKeyFor() {
+    std::cout << "\n[TEST] Singleflight: coalescing key..." << std::endl;
+    try {
+        ProxySingleflightConfig config;
+        config.enabled = true;
+        config.key_headers = {"X-Tenant", "Cookie"};
+        SingleflightGroup group("svc", config);
+
+        bool pass = true;
+        std::string err;
+        auto get = MakeRequest("GET", "/a");
+        const std::string base = group.KeyFor(get);
+        if (base.empty()) { pass = false; err += "plain GET not coalesced; "; }
+        if (group.KeyFor(MakeRequest("GET", "/a")) != base) {
+            pass = false; err += "identical GETs keyed differently; ";
+        }
+        if (group.KeyFor(MakeRequest("HEAD", "/a")) == base) {
+            pass = false; err += "HEAD shares the GET key; ";
+        }
+        auto query = MakeRequest("GET", "/a");
+        query.query = "page=2";
+        if (group.KeyFor(query) == base) { pass = false; err += "query ignored; "; }
+        if (group.KeyFor(MakeRequest("GET", "/a", {{"x-tenant", "t1"}})) == base) {
+            pass = false; err += "key header ignored; ";
+        }
+        // Headers outside the key do not split flights.
+        if (group.KeyFor(MakeRequest("GET", "/a", {{"accept", "text/plain"}})) != base) {
+            pass = false; err += "unkeyed header split the key; ";
+        }
+        if (group.KeyFor(MakeRequest("GET", "/a", {{"cookie", "s=1"}})).empty()) {
+            pass = false; err += "keyed Cookie not coalesced; ";
+        }
+
+        if (!group.KeyFor(MakeRequest("POST", "/a")).empty()) {
+            pass = false; err += "POST coalesced; ";
+        }
+        if (!group.KeyFor(MakeRequest("GET", "/a", {{"content-length", "4"}})).empty()) {
+            pass = false; err += "GET with body coalesced; ";
+        }
+        if (!group.KeyFor(MakeRequest("GET", "/a", {{"authorization", "Bearer x"}})).empty()) {
+            pass = false; err += "unkeyed Authorization coalesced; ";
+        }
+        if (!group.KeyFor(MakeRequest("GET", "/a", {{"range", "bytes=0-1"}})).empty()) {
+            pass = false; err += "unkeyed Range coalesced; ";
+        }
+        auto h10 = MakeRequest("GET", "/a");
+        h10.http_minor = 0;
+        if (!group.KeyFor(h10).empty()) { pass = false; err += "HTTP/1.0 coalesced; "; }
+
+        TestFramework::RecordTest("Singleflight: coalescing key", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Singleflight: coalescing key", false, e.what(),
+                                  TestFramework::TestCategory::OTHER);
+    }
+}
+
+inline ServerConfig CoalescingGatewayConfig(int backend_port, const std::string& prefix,
+                                            int worker_threads = 1) {
+    UpstreamConfig u = ProxyTests::MakeProxyUpstreamConfig(
+        "backend", "127.0.0.1", backend_port, prefix);
+    u.proxy.singleflight.enabled = true;
+    u.proxy.singleflight.key_headers = {"x-tenant"};
+    ServerConfig gw;
+    gw.bind_host = "127.0.0.1";
+    gw.bind_port = 0;
+    gw.worker_threads = worker_threads;
+    gw.http2.enabled = false;
+    gw.upstreams.push_back(u);
+    return gw;
+}
+
+inline std::string Get(int port, const std::string& path,
+                       const std::string& extra_headers = "") {
+    return TestHttpClient::SendHttpRequest(port,
+        "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n" + extra_headers +
+        "Connection: close\r\n\r\n",
+        5000);
+}
+
+// T2
+void TestIntegrationCoalesce() {
+    std::cout << "\n[TEST] Singleflight: concurrent GETs share one upstream request..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/slow", [&](const HttpRequest&, HttpResponse& resp) {
+            int n = ++hits;
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            resp.Status(200).Body("slow" + std::to_string(n), "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CoalescingGatewayConfig(backend_runner.GetPort(), "/slow", 2));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        constexpr int kClients = 6;
+        std::vector<std::string> bodies(kClients);
+        std::vector<std::thread> clients;
+        for (int i = 0; i < kClients; ++i) {
+            clients.emplace_back([&, i]() {
+                bodies[i] = TestHttpClient::ExtractBody(Get(port, "/slow"));
+            });
+        }
+        for (auto& t : clients) t.join();
+
+        bool pass = true;
+        std::string err;
+        for (const auto& b : bodies) {
+            if (b != "slow1") { pass = false; err += "client got '" + b + "'; "; break; }
+        }
+        if (hits.load() != 1) { pass = false; err += "backend hits=" + std::to_string(hits.load()) + "; "; }
+
+        // The flight is gone once answered: the next request goes upstream.
+        std::string after = TestHttpClient::ExtractBody(Get(port, "/slow"));
+        if (after != "slow2") { pass = false; err += "later request got '" + after + "'; "; }
+        TestFramework::RecordTest("Singleflight: concurrent GETs share one upstream request",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Singleflight: concurrent GETs share one upstream request",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T3
+void TestIntegrationStreamReplay() {
+    std::cout << "\n[TEST] Singleflight: late joiner replayed a streamed body..." << std::endl;
+    try {
+        // Accepts a single upstream connection: a second upstream
+        // request would never be answered.
+        ProxyTests::RawHttpBackendServer backend([](int fd, const std::string&) {
+            ProxyTests::SendAll(fd,
+                    "HTTP/1.1 200 OK\r\n"
+                    "Content-Length: 10\r\n"
+                    "Content-Type: text/plain\r\n"
+                    "\r\n");
+            ProxyTests::SendAll(fd, "part1");
+            std::this_thread::sleep_for(std::chrono::milliseconds(600));
+            ProxyTests::SendAll(fd, "part2");
+        });
+        ServerConfig gw_config = CoalescingGatewayConfig(backend.GetPort(), "/stream", 2);
+        gw_config.upstreams[0].proxy.buffering = "never";
+        HttpServer gateway(gw_config);
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string first;
+        std::thread leader([&]() { first = Get(port, "/stream"); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        std::string second = Get(port, "/stream");
+        leader.join();
+
+        bool pass = true;
+        std::string err;
+        if (!TestHttpClient::HasStatus(first, 200) ||
+            TestHttpClient::ExtractBody(first) != "part1part2") {
+            pass = false; err += "leader got '" + first + "'; ";
+        }
+        if (!TestHttpClient::HasStatus(second, 200) ||
+            TestHttpClient::ExtractBody(second) != "part1part2") {
+            pass = false; err += "late joiner got '" + second + "'; ";
+        }
+        TestFramework::RecordTest("Singleflight: late joiner replayed a streamed body",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Singleflight: late joiner replayed a streamed body",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestIntegrationKeySeparation() {
+    std::cout << "\n[TEST] Singleflight: key headers and credentials separate flights..." << std::endl;
+    try {
+        std::atomic<int> hits{0};
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/who", [&](const HttpRequest& req, HttpResponse& resp) {
+            ++hits;
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            auto it = req.headers.find("x-tenant");
+            resp.Status(200).Body(it != req.headers.end() ? it->second : "none",
+                                  "text/plain");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+        HttpServer gateway(CoalescingGatewayConfig(backend_runner.GetPort(), "/who", 2));
+        TestServerRunner<HttpServer> gw_runner(gateway);
+        int port = gw_runner.GetPort();
+
+        std::string a, b;
+        std::thread ta([&]() { a = TestHttpClient::ExtractBody(Get(port, "/who", "X-Tenant: a\r\n")); });
+        std::thread tb([&]() { b = TestHttpClient::ExtractBody(Get(port, "/who", "X-Tenant: b\r\n")); });
+        ta.join();
+        tb.join();
+
+        bool pass = true;
+        std::string err;
+        if (a != "a" || b != "b") { pass = false; err += "tenants got '" + a + "'/'" + b + "'; "; }
+        if (hits.load() != 2) { pass = false; err += "tenant hits=" + std::to_string(hits.load()) + "; "; }
+
+        hits = 0;
+        std::thread tc([&]() { Get(port, "/who", "Authorization: Bearer one\r\n"); });
+        std::thread td([&]() { Get(port, "/who", "Authorization: Bearer two\r\n"); });
+        tc.join();
+        td.join();
+        if (hits.load() != 2) { pass = false; err += "authorized hits=" + std::to_string(hits.load()) + "; "; }
+        TestFramework::RecordTest("Singleflight: key headers and credentials separate flights",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Singleflight: key headers and credentials separate flights",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestConfig() {
+    std::cout << "\n[TEST] Singleflight: config round-trip and validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                           "proxy": {"route_prefix": "/svc",
+                                     "singleflight": {"enabled": true,
+                                                      "key_headers": ["Accept-Encoding"],
+                                                      "max_replay_bytes": 4096}}}]
+        })");
+        ConfigLoader::Validate(cfg);
+        const auto& sf = cfg.upstreams[0].proxy.singleflight;
+        if (!sf.enabled || sf.key_headers.size() != 1 ||
+            sf.key_headers[0] != "Accept-Encoding" || sf.max_replay_bytes != 4096) {
+            pass = false; err += "parse mismatch; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (!(again.upstreams[0].proxy == cfg.upstreams[0].proxy)) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+
+        cfg.upstreams[0].proxy.singleflight.max_replay_bytes = -1;
+        try {
+            ConfigLoader::Validate(cfg);
+            pass = false; err += "negative max_replay_bytes accepted; ";
+        } catch (const std::invalid_argument& e) {
+            if (std::string(e.what()).find("max_replay_bytes") == std::string::npos) {
+                pass = false; err += std::string("wrong error: ") + e.what() + "; ";
+            }
+        }
+        try {
+            ConfigLoader::LoadFromString(R"({
+                "upstreams": [{"name": "svc", "host": "10.0.0.1", "port": 8080,
+                               "proxy": {"singleflight": {"key_headers": "x-tenant"}}}]
+            })");
+            pass = false; err += "non-array key_headers accepted; ";
+        } catch (const std::runtime_error&) {
+        }
+        TestFramework::RecordTest("Singleflight: config round-trip and validation", pass, err,
+                                  TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("Singleflight: config round-trip and validation", false,
+                                  e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n=== Proxy Singleflight Tests ===" << std::endl;
+    TestKeyFor();
+    TestIntegrationCoalesce();
+    TestIntegrationStreamReplay();
+    TestIntegrationKeySeparation();
+    TestConfig();
+}
+
+}  // namespace SingleflightTests
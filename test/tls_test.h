@@ -1,13 +1,29 @@
 #pragma once
 
 #include "test_framework.h"
+#include "test_server_runner.h"
+#include "http_test_client.h"
+#include "http/http_server.h"
+#include "config/server_config.h"
+#include "upstream/upstream_manager.h"
 #include "tls/tls_context.h"
 #include "tls/tls_client_context.h"
 #include "tls/tls_connection.h"
+#include "tls/tls_session_cache.h"
 #include <openssl/ssl.h>
+#include <openssl/rand.h>
 #include <openssl/x509_vfy.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <sys/socket.h>
+#include <unistd.h>
 #include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 namespace TlsTests {
 
@@ -315,6 +331,1114 @@ namespace TlsTests {
         }
     }
 
+    // ---- Session resumption -------------------------------------------
+
+    static const char* kTicketKeyFile = "/tmp/test_ticket.key";
+
+    // Write `count` random 80-byte ticket keys to `path`. Returns the
+    // raw bytes so a test can reorder / re-write the same keys.
+    static std::string WriteRandomTicketKeys(const std::string& path, int count) {
+        std::string raw(TlsContext::TICKET_KEY_SIZE * count, '\0');
+        RAND_bytes(reinterpret_cast<unsigned char*>(&raw[0]),
+                   static_cast<int>(raw.size()));
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << raw;
+        return raw;
+    }
+
+    static void WriteTicketKeys(const std::string& path, const std::string& raw) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << raw;
+    }
+
+    // Minimal verify-none client context pinned to one protocol version.
+    static SSL_CTX* NewResumptionClientCtx(int version) {
+        SSL_CTX* c = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_verify(c, SSL_VERIFY_NONE, nullptr);
+        SSL_CTX_set_min_proto_version(c, version);
+        SSL_CTX_set_max_proto_version(c, version);
+        return c;
+    }
+
+    // Run one blocking handshake over a socketpair: the server side on a
+    // helper thread with `server`, the client side here with `client_ctx`,
+    // offering `offer` (may be null). The server writes one byte after the
+    // handshake so the client has processed any NewSessionTicket before
+    // the session is captured. Returns false if the handshake failed;
+    // `*reused` reports SSL_session_reused on the client, and `*out` (when
+    // non-null) receives the resulting session (caller frees).
+    static bool RunResumptionHandshake(TlsContext& server, SSL_CTX* client_ctx,
+                                       SSL_SESSION* offer, bool* reused,
+                                       SSL_SESSION** out = nullptr) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return false;
+
+        std::thread server_thread([&server, fd = sv[1]]() {
+            SSL* ssl = SSL_new(server.GetCtx());
+            SSL_set_fd(ssl, fd);
+            if (SSL_accept(ssl) == 1) {
+                SSL_write(ssl, "x", 1);
+                char sink;
+                SSL_read(ssl, &sink, 1);  // until the client closes
+                // A session is evicted from the cache when its SSL is
+                // freed without a close_notify — mirror the clean close.
+                SSL_shutdown(ssl);
+            }
+            SSL_free(ssl);
+            ::close(fd);
+        });
+
+        SSL* ssl = SSL_new(client_ctx);
+        SSL_set_fd(ssl, sv[0]);
+        if (offer) SSL_set_session(ssl, offer);
+        bool ok = false;
+        if (SSL_connect(ssl) == 1) {
+            char byte;
+            ok = SSL_read(ssl, &byte, 1) == 1;
+            *reused = SSL_session_reused(ssl) == 1;
+            if (out) *out = SSL_get1_session(ssl);
+            // Bidirectional close: wait for the server's close_notify so
+            // its SSL_shutdown never writes into a closed socket.
+            if (SSL_shutdown(ssl) == 0) {
+                SSL_read(ssl, &byte, 1);
+            }
+        }
+        SSL_free(ssl);
+        ::shutdown(sv[0], SHUT_RDWR);
+        ::close(sv[0]);
+        server_thread.join();
+        return ok;
+    }
+
+    // Full handshake on `issuer`, then offer its session to `resumer`.
+    // Returns true if the second handshake resumed.
+    static bool ResumesAcross(TlsContext& issuer, TlsContext& resumer, int version,
+                              std::string* err) {
+        SSL_CTX* client = NewResumptionClientCtx(version);
+        bool reused = false;
+        SSL_SESSION* sess = nullptr;
+        bool resumed = false;
+        if (!RunResumptionHandshake(issuer, client, nullptr, &reused, &sess) || !sess) {
+            *err = "initial handshake failed";
+        } else if (reused) {
+            *err = "initial handshake unexpectedly resumed";
+        } else if (!RunResumptionHandshake(resumer, client, sess, &reused)) {
+            *err = "second handshake failed";
+        } else {
+            resumed = reused;
+        }
+        if (sess) SSL_SESSION_free(sess);
+        SSL_CTX_free(client);
+        return resumed;
+    }
+
+    void TestSessionTicketResumption() {
+        std::cout << "\n[TEST] TLS session tickets resume (1.2 + 1.3)..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS session tickets resume", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            ctx.ConfigureSessionResumption(true, "", 0, 300);
+
+            std::string err;
+            bool r13 = ResumesAcross(ctx, ctx, TLS1_3_VERSION, &err);
+            std::string err12;
+            bool r12 = ResumesAcross(ctx, ctx, TLS1_2_VERSION, &err12);
+            bool pass = r13 && r12 && ctx.TicketKeyCount() == 1;
+
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS session tickets resume", pass,
+                pass ? "" : "1.3: " + (r13 ? std::string("ok") : err) +
+                            ", 1.2: " + (r12 ? std::string("ok") : err12),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS session tickets resume", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // Two contexts loading the same key file resume each other's tickets
+    // (multi-instance / restart); a context with in-process keys cannot.
+    void TestTicketKeyFileShared() {
+        std::cout << "\n[TEST] TLS ticket key file shared across contexts..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS ticket key file shared", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            WriteRandomTicketKeys(kTicketKeyFile, 2);
+            TlsContext a("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            TlsContext b("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            TlsContext other("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            a.ConfigureSessionResumption(true, kTicketKeyFile, 0, 300);
+            b.ConfigureSessionResumption(true, kTicketKeyFile, 0, 300);
+            other.ConfigureSessionResumption(true, "", 0, 300);
+
+            std::string err, err_other;
+            bool shared = ResumesAcross(a, b, TLS1_3_VERSION, &err);
+            bool foreign = ResumesAcross(a, other, TLS1_3_VERSION, &err_other);
+            bool pass = shared && !foreign && a.TicketKeyCount() == 2;
+
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key file shared", pass,
+                pass ? "" : "shared=" + std::to_string(shared) + " (" + err +
+                            ") foreign=" + std::to_string(foreign) +
+                            " keys=" + std::to_string(a.TicketKeyCount()),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key file shared", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // Rotation: a file-backed context keeps resuming while the old key
+    // stays in the file and stops once it is removed; an in-process
+    // context keeps exactly one previous key.
+    void TestTicketKeyRotation() {
+        std::cout << "\n[TEST] TLS ticket key rotation..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS ticket key rotation", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            std::string err;
+            std::string old_key = WriteRandomTicketKeys(kTicketKeyFile, 1);
+
+            TlsContext ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            ctx.ConfigureSessionResumption(true, kTicketKeyFile, 0, 300);
+            SSL_CTX* client = NewResumptionClientCtx(TLS1_3_VERSION);
+            bool reused = false;
+            SSL_SESSION* sess = nullptr;
+            bool ok = RunResumptionHandshake(ctx, client, nullptr, &reused, &sess) && sess;
+
+            // New key first, old key still accepted.
+            std::string new_key = WriteRandomTicketKeys(kTicketKeyFile, 1);
+            WriteTicketKeys(kTicketKeyFile, new_key + old_key);
+            ctx.RotateTicketKeys();
+            bool resumed_during_overlap = false;
+            ok = ok && RunResumptionHandshake(ctx, client, sess, &resumed_during_overlap);
+
+            // Old key dropped: the old ticket no longer resumes.
+            WriteTicketKeys(kTicketKeyFile, new_key);
+            ctx.RotateTicketKeys();
+            bool resumed_after_drop = true;
+            ok = ok && RunResumptionHandshake(ctx, client, sess, &resumed_after_drop);
+
+            // A malformed file leaves the current key set in force.
+            WriteTicketKeys(kTicketKeyFile, "short");
+            bool threw = false;
+            try { ctx.RotateTicketKeys(); } catch (const std::runtime_error&) { threw = true; }
+            bool kept = ctx.TicketKeyCount() == 1;
+
+            // In-process keys: one rotation keeps the previous key, two drop it.
+            TlsContext mem("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            mem.ConfigureSessionResumption(true, "", 0, 300);
+            SSL_SESSION* mem_sess = nullptr;
+            ok = ok && RunResumptionHandshake(mem, client, nullptr, &reused, &mem_sess) && mem_sess;
+            mem.RotateTicketKeys();
+            bool mem_after_one = false;
+            ok = ok && RunResumptionHandshake(mem, client, mem_sess, &mem_after_one);
+            mem.RotateTicketKeys();
+            mem.RotateTicketKeys();
+            bool mem_after_three = true;
+            ok = ok && RunResumptionHandshake(mem, client, mem_sess, &mem_after_three);
+
+            if (sess) SSL_SESSION_free(sess);
+            if (mem_sess) SSL_SESSION_free(mem_sess);
+            SSL_CTX_free(client);
+
+            bool pass = ok && resumed_during_overlap && !resumed_after_drop &&
+                        threw && kept && mem_after_one && !mem_after_three &&
+                        mem.TicketKeyCount() == 2;
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key rotation", pass,
+                pass ? "" : "ok=" + std::to_string(ok) +
+                            " overlap=" + std::to_string(resumed_during_overlap) +
+                            " after_drop=" + std::to_string(resumed_after_drop) +
+                            " threw=" + std::to_string(threw) +
+                            " kept=" + std::to_string(kept) +
+                            " mem1=" + std::to_string(mem_after_one) +
+                            " mem3=" + std::to_string(mem_after_three),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key rotation", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // With tickets off, TLS 1.2 resumes only through the session cache.
+    void TestSessionCacheResumption() {
+        std::cout << "\n[TEST] TLS session cache resumption (tickets off)..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS session cache resumption", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext cached("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            cached.ConfigureSessionResumption(false, "", 128, 300);
+            TlsContext none("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            none.ConfigureSessionResumption(false, "", 0, 300);
+
+            std::string err, err_none, err13;
+            bool with_cache = ResumesAcross(cached, cached, TLS1_2_VERSION, &err);
+            bool with_cache13 = ResumesAcross(cached, cached, TLS1_3_VERSION, &err13);
+            bool without = ResumesAcross(none, none, TLS1_2_VERSION, &err_none);
+            bool pass = with_cache && with_cache13 && !without &&
+                        cached.TicketKeyCount() == 0;
+
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS session cache resumption", pass,
+                pass ? "" : "cache(1.2)=" + std::to_string(with_cache) + " (" + err +
+                            ") cache(1.3)=" + std::to_string(with_cache13) + " (" + err13 +
+                            ") off=" + std::to_string(without),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS session cache resumption", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    void TestTicketKeyFileInvalid() {
+        std::cout << "\n[TEST] TLS ticket key file invalid size..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS ticket key file invalid", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            WriteTicketKeys(kTicketKeyFile, std::string(81, 'k'));
+            TlsContext ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            bool threw = false;
+            try {
+                ctx.ConfigureSessionResumption(true, kTicketKeyFile, 0, 300);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            // The 48-byte layout is accepted.
+            WriteTicketKeys(kTicketKeyFile, std::string(96, 'k'));
+            TlsContext legacy("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            legacy.ConfigureSessionResumption(true, kTicketKeyFile, 0, 300);
+            bool pass = threw && legacy.TicketKeyCount() == 2;
+
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key file invalid", pass,
+                pass ? "" : threw ? "48-byte keys not parsed"
+                                  : "Expected exception for 81-byte key file",
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            std::remove(kTicketKeyFile);
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS ticket key file invalid", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // ---- Upstream session reuse ---------------------------------------
+
+    // Sessions a TlsClientContext receives land in the bound cache and are
+    // offered on the next connect with the same key; other keys miss.
+    void TestClientSessionCacheReuse() {
+        std::cout << "\n[TEST] TLS client session cache reuse..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS client session cache reuse", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext server("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            server.ConfigureSessionResumption(true, "", 0, 300);
+            TlsClientContext client("", /*verify_peer=*/false);
+            client.SetSessionReuse(true);
+            auto cache = std::make_shared<TlsSessionCache>();
+
+            // Drive one client connection through the production wrapper
+            // (TlsConnection + AttachSessionCache) against a blocking server.
+            auto connect_once = [&](const std::string& key, bool* offered,
+                                    bool* reused) {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return false;
+                std::thread server_thread([&server, fd = sv[1]]() {
+                    SSL* ssl = SSL_new(server.GetCtx());
+                    SSL_set_fd(ssl, fd);
+                    if (SSL_accept(ssl) == 1) {
+                        SSL_write(ssl, "x", 1);
+                        char sink;
+                        SSL_read(ssl, &sink, 1);
+                        SSL_shutdown(ssl);
+                    }
+                    SSL_free(ssl);
+                    ::close(fd);
+                });
+                bool ok = false;
+                {
+                    TlsConnection conn(client, sv[0]);
+                    *offered = conn.AttachSessionCache(*cache, key);
+                    SSL* ssl = conn.GetSslForTesting();
+                    char byte;
+                    if (SSL_connect(ssl) == 1 && SSL_read(ssl, &byte, 1) == 1) {
+                        ok = true;
+                        *reused = conn.IsSessionReused();
+                        if (SSL_shutdown(ssl) == 0) SSL_read(ssl, &byte, 1);
+                    }
+                }
+                ::close(sv[0]);
+                server_thread.join();
+                return ok;
+            };
+
+            bool offered1 = true, reused1 = true;
+            bool offered2 = false, reused2 = false;
+            bool offered3 = true, reused3 = true;
+            bool ok = connect_once("backend:443/a", &offered1, &reused1) &&
+                      connect_once("backend:443/a", &offered2, &reused2) &&
+                      connect_once("backend:443/b", &offered3, &reused3);
+            size_t entries = cache->Size();
+            cache->Remove("backend:443/a");
+            bool pass = ok && !offered1 && !reused1 && offered2 && reused2 &&
+                        !offered3 && !reused3 && entries == 2 && cache->Size() == 1;
+
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS client session cache reuse", pass,
+                pass ? "" : "ok=" + std::to_string(ok) +
+                            " first(offered,reused)=" + std::to_string(offered1) +
+                            std::to_string(reused1) +
+                            " second=" + std::to_string(offered2) + std::to_string(reused2) +
+                            " other_key=" + std::to_string(offered3) + std::to_string(reused3) +
+                            " entries=" + std::to_string(entries),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS client session cache reuse", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // Proxy to a TLS backend with one request per pooled connection: every
+    // request opens a fresh upstream connection, and all but the first on
+    // the dispatcher resume. With session_reuse off, none do.
+    void TestUpstreamPoolSessionReuse() {
+        std::cout << "\n[TEST] TLS upstream pool session reuse..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS upstream pool session reuse", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            ServerConfig backend_cfg;
+            backend_cfg.bind_host = "127.0.0.1";
+            backend_cfg.bind_port = 0;
+            backend_cfg.worker_threads = 1;
+            backend_cfg.http2.enabled = false;
+            backend_cfg.tls.enabled = true;
+            backend_cfg.tls.cert_file = "/tmp/test_cert.pem";
+            backend_cfg.tls.key_file = "/tmp/test_key.pem";
+            HttpServer backend(backend_cfg);
+            backend.Get("/hello", [](const HttpRequest&, HttpResponse& res) {
+                res.Status(200).Text("hello");
+            });
+            TestServerRunner<HttpServer> backend_runner(backend);
+
+            auto run_gateway = [&](bool session_reuse, int64_t* full, int64_t* resumed) {
+                UpstreamConfig u;
+                u.name = "tls-backend";
+                u.host = "127.0.0.1";
+                u.port = backend_runner.GetPort();
+                u.tls.enabled = true;
+                u.tls.verify_peer = false;
+                u.tls.session_reuse = session_reuse;
+                u.pool.max_connections = 4;
+                u.pool.max_idle_connections = 2;
+                u.pool.connect_timeout_ms = 3000;
+                u.pool.max_requests_per_conn = 1;
+                u.proxy.route_prefix = "/hello";
+                u.proxy.response_timeout_ms = 5000;
+                ServerConfig gw;
+                gw.bind_host = "127.0.0.1";
+                gw.bind_port = 0;
+                gw.worker_threads = 1;
+                gw.http2.enabled = false;
+                gw.upstreams.push_back(u);
+                HttpServer gateway(gw);
+                TestServerRunner<HttpServer> runner(gateway);
+                int ok = 0;
+                for (int i = 0; i < 4; ++i) {
+                    std::string r = TestHttpClient::HttpGet(runner.GetPort(), "/hello", 5000);
+                    if (r.find("200") != std::string::npos &&
+                        r.find("hello") != std::string::npos) {
+                        ++ok;
+                    }
+                }
+                auto* upm = gateway.GetUpstreamManager();
+                *full = upm ? upm->tls_handshakes_full() : -1;
+                *resumed = upm ? upm->tls_handshakes_resumed() : -1;
+                return ok;
+            };
+
+            int64_t full_on = 0, resumed_on = 0, full_off = 0, resumed_off = 0;
+            int ok_on = run_gateway(true, &full_on, &resumed_on);
+            int ok_off = run_gateway(false, &full_off, &resumed_off);
+            bool pass = ok_on == 4 && ok_off == 4 &&
+                        full_on == 1 && resumed_on == 3 &&
+                        full_off == 4 && resumed_off == 0;
+
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS upstream pool session reuse", pass,
+                pass ? "" : "reuse on: ok=" + std::to_string(ok_on) +
+                            " full=" + std::to_string(full_on) +
+                            " resumed=" + std::to_string(resumed_on) +
+                            "; reuse off: ok=" + std::to_string(ok_off) +
+                            " full=" + std::to_string(full_off) +
+                            " resumed=" + std::to_string(resumed_off),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS upstream pool session reuse", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // ---- Kernel TLS ---------------------------------------------------
+
+    // kTLS needs a TCP socket (the TLS ULP), so unlike the socketpair
+    // helpers above this runs over a loopback listener. Whichever side has
+    // kTLS send active writes plaintext straight to the fd; the peer must
+    // still decrypt it. Without kernel support both sides fall back to
+    // OpenSSL and the exchange must be unaffected.
+    void TestKtlsLoopback() {
+        std::cout << "\n[TEST] TLS kTLS loopback (offload or fallback)..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS kTLS loopback", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext server_ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            TlsClientContext client_ctx("", /*verify_peer=*/false);
+            bool available = server_ctx.EnableKtls();
+            bool client_available = client_ctx.EnableKtls();
+
+            int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t addr_len = sizeof(addr);
+            if (listen_fd < 0 ||
+                ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                ::listen(listen_fd, 1) != 0 ||
+                ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+                if (listen_fd >= 0) ::close(listen_fd);
+                CleanupTestCert();
+                TestFramework::RecordTest("TLS kTLS loopback", false,
+                    "loopback listener setup failed", TestFramework::TestCategory::OTHER);
+                return;
+            }
+
+            // Plaintext goes straight to the fd when the kernel encrypts.
+            auto send_all = [](TlsConnection& conn, int fd, const std::string& msg) {
+                if (conn.KtlsSendActive()) {
+                    return ::send(fd, msg.data(), msg.size(), MSG_NOSIGNAL) ==
+                           static_cast<ssize_t>(msg.size());
+                }
+                return conn.Write(msg.data(), msg.size()) ==
+                       static_cast<int>(msg.size());
+            };
+            auto recv_exact = [](TlsConnection& conn, size_t n) {
+                std::string out;
+                char buf[256];
+                while (out.size() < n) {
+                    int r = conn.Read(buf, std::min(sizeof(buf), n - out.size()));
+                    if (r <= 0) break;
+                    out.append(buf, r);
+                }
+                return out;
+            };
+            const std::string to_client = "offloaded server->client";
+            const std::string to_server = "offloaded client->server";
+
+            bool server_tx = false, server_rx = false;
+            std::string server_got;
+            std::thread server_thread([&]() {
+                int fd = ::accept(listen_fd, nullptr, nullptr);
+                if (fd < 0) return;
+                {
+                    TlsConnection conn(server_ctx, fd);
+                    if (conn.DoHandshake() == TlsConnection::TLS_COMPLETE) {
+                        server_tx = conn.KtlsSendActive();
+                        server_rx = conn.KtlsRecvActive();
+                        if (send_all(conn, fd, to_client)) {
+                            server_got = recv_exact(conn, to_server.size());
+                        }
+                        conn.Shutdown();
+                    }
+                }
+                ::close(fd);
+            });
+
+            int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            bool client_tx = false, client_rx = false;
+            std::string client_got;
+            bool sent = false;
+            if (fd >= 0 &&
+                ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+                TlsConnection conn(client_ctx, fd);
+                if (conn.DoHandshake() == TlsConnection::TLS_COMPLETE) {
+                    client_tx = conn.KtlsSendActive();
+                    client_rx = conn.KtlsRecvActive();
+                    client_got = recv_exact(conn, to_client.size());
+                    sent = send_all(conn, fd, to_server);
+                    char byte;
+                    if (conn.Shutdown() == 0) conn.Read(&byte, 1);
+                }
+            }
+            server_thread.join();
+            if (fd >= 0) ::close(fd);
+            ::close(listen_fd);
+            CleanupTestCert();
+
+            const bool any = server_tx || server_rx || client_tx || client_rx;
+            std::cout << "  kTLS " << (any ? "active" : "unavailable, OpenSSL fallback")
+                      << " (server tx=" << server_tx << " rx=" << server_rx
+                      << ", client tx=" << client_tx << " rx=" << client_rx << ")"
+                      << std::endl;
+            bool pass = available == client_available &&
+                        available == TlsConnection::KtlsAvailable() &&
+                        (available || !any) &&
+                        sent && client_got == to_client && server_got == to_server;
+            TestFramework::RecordTest("TLS kTLS loopback", pass,
+                pass ? "" : "available=" + std::to_string(available) +
+                            " client_got='" + client_got + "' server_got='" +
+                            server_got + "' sent=" + std::to_string(sent),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS kTLS loopback", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // Proxy a large response from a kTLS-enabled TLS backend through an
+    // upstream pool with kTLS enabled, exercising partial writes on the
+    // handler's direct-send path when the kernel takes the records.
+    void TestKtlsProxyRoundTrip() {
+        std::cout << "\n[TEST] TLS kTLS proxy round trip..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS kTLS proxy round trip", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            const std::string payload(256 * 1024, 'k');
+            ServerConfig backend_cfg;
+            backend_cfg.bind_host = "127.0.0.1";
+            backend_cfg.bind_port = 0;
+            backend_cfg.worker_threads = 1;
+            backend_cfg.http2.enabled = false;
+            backend_cfg.tls.enabled = true;
+            backend_cfg.tls.cert_file = "/tmp/test_cert.pem";
+            backend_cfg.tls.key_file = "/tmp/test_key.pem";
+            backend_cfg.tls.ktls = true;
+            HttpServer backend(backend_cfg);
+            backend.Get("/blob", [&payload](const HttpRequest&, HttpResponse& res) {
+                res.Status(200).Text(payload);
+            });
+            TestServerRunner<HttpServer> backend_runner(backend);
+
+            UpstreamConfig u;
+            u.name = "ktls-backend";
+            u.host = "127.0.0.1";
+            u.port = backend_runner.GetPort();
+            u.tls.enabled = true;
+            u.tls.verify_peer = false;
+            u.tls.ktls = true;
+            u.pool.max_connections = 2;
+            u.pool.max_idle_connections = 1;
+            u.pool.connect_timeout_ms = 3000;
+            u.proxy.route_prefix = "/blob";
+            u.proxy.response_timeout_ms = 5000;
+            ServerConfig gw;
+            gw.bind_host = "127.0.0.1";
+            gw.bind_port = 0;
+            gw.worker_threads = 1;
+            gw.http2.enabled = false;
+            gw.upstreams.push_back(u);
+            HttpServer gateway(gw);
+            TestServerRunner<HttpServer> runner(gateway);
+
+            int ok = 0;
+            for (int i = 0; i < 2; ++i) {
+                std::string r = TestHttpClient::HttpGet(runner.GetPort(), "/blob", 10000);
+                if (r.find("200") != std::string::npos &&
+                    r.size() >= payload.size() &&
+                    r.compare(r.size() - payload.size(), payload.size(), payload) == 0) {
+                    ++ok;
+                }
+            }
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS kTLS proxy round trip", ok == 2,
+                ok == 2 ? "" : "ok=" + std::to_string(ok) + "/2",
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS kTLS proxy round trip", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // ---- Handshake key offload ----------------------------------------
+
+    // Drive a server TlsConnection's handshake to completion, parking on
+    // TLS_WANT_ASYNC until the offload worker's resume callback fires —
+    // the role the dispatcher plays for ConnectionHandler. Returns the
+    // final DoHandshake result; `*async_waits` counts the parks.
+    static int DriveOffloadedHandshake(TlsConnection& conn, int* async_waits) {
+        std::mutex mu;
+        std::condition_variable cv;
+        bool resumed = false;
+        conn.SetAsyncResumeCallback([&]() {
+            std::lock_guard<std::mutex> lock(mu);
+            resumed = true;
+            cv.notify_one();
+        });
+        for (;;) {
+            int r = conn.DoHandshake();
+            if (r != TlsConnection::TLS_WANT_ASYNC) return r;
+            ++*async_waits;
+            std::unique_lock<std::mutex> lock(mu);
+            if (!cv.wait_for(lock, std::chrono::seconds(5),
+                             [&]() { return resumed; })) {
+                return TlsConnection::TLS_ERROR;
+            }
+            resumed = false;
+        }
+    }
+
+    // One handshake over a socketpair against `server` (offload enabled),
+    // client pinned to `version`. True when both sides completed and a
+    // byte made it across afterwards.
+    static bool RunOffloadedHandshake(TlsContext& server, int version,
+                                      std::string* err) {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+            *err = "socketpair failed";
+            return false;
+        }
+        SSL_CTX* client_ctx = NewResumptionClientCtx(version);
+        bool client_ok = false;
+        std::thread client_thread([&client_ok, client_ctx, fd = sv[0]]() {
+            SSL* ssl = SSL_new(client_ctx);
+            SSL_set_fd(ssl, fd);
+            if (SSL_connect(ssl) == 1) {
+                char byte;
+                client_ok = SSL_read(ssl, &byte, 1) == 1 && byte == 'k';
+            }
+            SSL_free(ssl);
+            ::shutdown(fd, SHUT_RDWR);
+        });
+
+        int waits = 0;
+        int result;
+        bool wrote = false;
+        {
+            TlsConnection conn(server, sv[1]);
+            result = DriveOffloadedHandshake(conn, &waits);
+            if (result == TlsConnection::TLS_COMPLETE) {
+                wrote = conn.Write("k", 1) == 1;
+            }
+        }
+        client_thread.join();
+        ::close(sv[0]);
+        ::close(sv[1]);
+        SSL_CTX_free(client_ctx);
+        if (result != TlsConnection::TLS_COMPLETE || !wrote || !client_ok) {
+            *err = "handshake result=" + std::to_string(result) +
+                   " wrote=" + std::to_string(wrote) +
+                   " client_ok=" + std::to_string(client_ok);
+            return false;
+        }
+        // `waits` stays 0 when the worker finished before the job got to
+        // pause — the hook then takes the result without parking.
+        return true;
+    }
+
+    // RSA (TLS 1.2 and 1.3) and ECDSA handshakes sign on the pool —
+    // parking on TLS_WANT_ASYNC until resumed — and complete.
+    void TestKeyOffloadHandshake() {
+        std::cout << "\n[TEST] TLS handshake key offload (RSA + ECDSA)..." << std::endl;
+        const char* ec_cert = "/tmp/test_ec_cert.pem";
+        const char* ec_key = "/tmp/test_ec_key.pem";
+        auto cleanup = [&]() {
+            CleanupTestCert();
+            std::remove(ec_cert);
+            std::remove(ec_key);
+        };
+        try {
+            if (!TlsKeyOffloader::Supported()) {
+                TestFramework::RecordTest("TLS handshake key offload", true,
+                    "", TestFramework::TestCategory::OTHER);
+                std::cout << "  async jobs unsupported on this platform, skipped" << std::endl;
+                return;
+            }
+            bool certs = GenerateTestCert() && std::system(
+                "openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 "
+                "-keyout /tmp/test_ec_key.pem -out /tmp/test_ec_cert.pem "
+                "-days 1 -nodes -subj '/CN=localhost' 2>/dev/null") == 0;
+            if (!certs) {
+                cleanup();
+                TestFramework::RecordTest("TLS handshake key offload", false,
+                    "Failed to generate test certs", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext rsa_ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            TlsContext ec_ctx(ec_cert, ec_key);
+            std::string err;
+            bool pass = rsa_ctx.EnableKeyOffload(2) && ec_ctx.EnableKeyOffload(1);
+            if (!pass) err = "EnableKeyOffload failed";
+            if (pass && rsa_ctx.EnableKeyOffload(2)) {
+                pass = false;
+                err = "second EnableKeyOffload accepted";
+            }
+            if (pass && !RunOffloadedHandshake(rsa_ctx, TLS1_2_VERSION, &err)) {
+                pass = false;
+                err = "RSA TLS 1.2: " + err;
+            }
+            if (pass && !RunOffloadedHandshake(rsa_ctx, TLS1_3_VERSION, &err)) {
+                pass = false;
+                err = "RSA TLS 1.3: " + err;
+            }
+            if (pass && !RunOffloadedHandshake(ec_ctx, TLS1_3_VERSION, &err)) {
+                pass = false;
+                err = "ECDSA TLS 1.3: " + err;
+            }
+            const TlsKeyOffloader* rsa_off = rsa_ctx.KeyOffloader();
+            const TlsKeyOffloader* ec_off = ec_ctx.KeyOffloader();
+            if (pass && (rsa_off->submitted() != 2 || rsa_off->completed() != 2 ||
+                         ec_off->submitted() != 1 || ec_off->completed() != 1 ||
+                         rsa_off->in_flight() != 0 || ec_off->in_flight() != 0)) {
+                pass = false;
+                err = "counters rsa submitted=" + std::to_string(rsa_off->submitted()) +
+                      " completed=" + std::to_string(rsa_off->completed()) +
+                      " ec submitted=" + std::to_string(ec_off->submitted()) +
+                      " completed=" + std::to_string(ec_off->completed());
+            }
+            cleanup();
+            TestFramework::RecordTest("TLS handshake key offload", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            cleanup();
+            TestFramework::RecordTest("TLS handshake key offload", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // A connection destroyed while its signature is queued or running must
+    // not crash, write to the fd, or leak the operation: it ends up either
+    // cancelled or completed, and the client sees the handshake fail.
+    void TestKeyOffloadAbandon() {
+        std::cout << "\n[TEST] TLS key offload abandoned mid-handshake..." << std::endl;
+        try {
+            if (!TlsKeyOffloader::Supported()) {
+                TestFramework::RecordTest("TLS key offload abandon", true,
+                    "", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS key offload abandon", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext server_ctx("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            bool pass = server_ctx.EnableKeyOffload(1);
+            std::string err = pass ? "" : "EnableKeyOffload failed";
+            const TlsKeyOffloader* off = server_ctx.KeyOffloader();
+            int parked = 0;
+            for (int i = 0; pass && i < 8; ++i) {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+                    pass = false;
+                    err = "socketpair failed";
+                    break;
+                }
+                SSL_CTX* client_ctx = NewResumptionClientCtx(TLS1_3_VERSION);
+                bool client_connected = false;
+                std::thread client_thread([&client_connected, client_ctx, fd = sv[0]]() {
+                    SSL* ssl = SSL_new(client_ctx);
+                    SSL_set_fd(ssl, fd);
+                    client_connected = SSL_connect(ssl) == 1;
+                    SSL_free(ssl);
+                });
+                bool was_parked = false;
+                {
+                    TlsConnection conn(server_ctx, sv[1]);
+                    conn.SetAsyncResumeCallback([]() {});
+                    // A worker that finishes before the job gets to pause
+                    // lets the handshake run through; only parked
+                    // iterations exercise the abandon path.
+                    was_parked = conn.DoHandshake() == TlsConnection::TLS_WANT_ASYNC;
+                    // Destroyed here, with the operation still outstanding.
+                }
+                if (was_parked) ++parked;
+                ::shutdown(sv[1], SHUT_RDWR);
+                client_thread.join();
+                ::close(sv[0]);
+                ::close(sv[1]);
+                SSL_CTX_free(client_ctx);
+                if (was_parked && client_connected) {
+                    pass = false;
+                    err = "client completed a handshake the server abandoned";
+                }
+            }
+            if (pass && (parked == 0 || off->in_flight() != 0 ||
+                         off->completed() + off->cancelled() != off->submitted() ||
+                         off->submitted() != 8)) {
+                pass = false;
+                err = "parked=" + std::to_string(parked) +
+                      " submitted=" + std::to_string(off->submitted()) +
+                      " completed=" + std::to_string(off->completed()) +
+                      " cancelled=" + std::to_string(off->cancelled());
+            }
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS key offload abandon", pass, err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS key offload abandon", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // End to end through ConnectionHandler: a TLS backend with offload
+    // enabled serves a proxied request; the handshake went through the
+    // pool and the queued gauge drained.
+    void TestKeyOffloadServer() {
+        std::cout << "\n[TEST] TLS key offload through HttpServer..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS key offload server", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            ServerConfig backend_cfg;
+            backend_cfg.bind_host = "127.0.0.1";
+            backend_cfg.bind_port = 0;
+            backend_cfg.worker_threads = 1;
+            backend_cfg.http2.enabled = false;
+            backend_cfg.tls.enabled = true;
+            backend_cfg.tls.cert_file = "/tmp/test_cert.pem";
+            backend_cfg.tls.key_file = "/tmp/test_key.pem";
+            backend_cfg.tls.handshake_offload_threads = 2;
+            HttpServer backend(backend_cfg);
+            backend.Get("/sig", [](const HttpRequest&, HttpResponse& res) {
+                res.Status(200).Text("signed-off");
+            });
+            TestServerRunner<HttpServer> backend_runner(backend);
+
+            UpstreamConfig u;
+            u.name = "offload-backend";
+            u.host = "127.0.0.1";
+            u.port = backend_runner.GetPort();
+            u.tls.enabled = true;
+            u.tls.verify_peer = false;
+            u.tls.session_reuse = false;  // every handshake signs
+            u.pool.max_connections = 2;
+            u.pool.max_idle_connections = 0;
+            u.pool.connect_timeout_ms = 3000;
+            u.proxy.route_prefix = "/sig";
+            u.proxy.response_timeout_ms = 5000;
+            ServerConfig gw;
+            gw.bind_host = "127.0.0.1";
+            gw.bind_port = 0;
+            gw.worker_threads = 1;
+            gw.http2.enabled = false;
+            gw.upstreams.push_back(u);
+            HttpServer gateway(gw);
+            TestServerRunner<HttpServer> runner(gateway);
+
+            int ok = 0;
+            for (int i = 0; i < 3; ++i) {
+                std::string r = TestHttpClient::HttpGet(runner.GetPort(), "/sig", 5000);
+                if (r.find("200") != std::string::npos &&
+                    r.find("signed-off") != std::string::npos) {
+                    ++ok;
+                }
+            }
+            HttpServer::ServerStats stats = backend.GetStats();
+            bool pass = TlsKeyOffloader::Supported()
+                ? (ok == 3 && stats.tls_offload_threads == 2 &&
+                   stats.tls_offload_submitted >= 1 &&
+                   stats.tls_offload_in_flight == 0)
+                : ok == 3;
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS key offload server", pass,
+                pass ? "" : "ok=" + std::to_string(ok) + "/3 threads=" +
+                            std::to_string(stats.tls_offload_threads) +
+                            " submitted=" + std::to_string(stats.tls_offload_submitted) +
+                            " in_flight=" + std::to_string(stats.tls_offload_in_flight),
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS key offload server", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    // ---- Dynamic record sizing ----------------------------------------
+
+    // Plaintext bytes of the application-data records a client received,
+    // recovered from the record headers seen by the message callback
+    // (TLS 1.2 AES-GCM: 8-byte explicit nonce + 16-byte tag per record).
+    struct RecordLog {
+        std::vector<size_t> app_records;
+    };
+
+    static void RecordHeaderCallback(int write_p, int /*version*/, int content_type,
+                                     const void* buf, size_t len, SSL* /*ssl*/,
+                                     void* arg) {
+        if (write_p != 0 || content_type != SSL3_RT_HEADER || len < 5) return;
+        const auto* h = static_cast<const unsigned char*>(buf);
+        if (h[0] != SSL3_RT_APPLICATION_DATA) return;
+        const size_t wire = (static_cast<size_t>(h[3]) << 8) | h[4];
+        static_cast<RecordLog*>(arg)->app_records.push_back(wire > 24 ? wire - 24 : 0);
+    }
+
+    // Server writes `writes` (sleeping `gaps_ms[i]` before write i) over a
+    // TLS 1.2 socketpair; returns the plaintext size of each record the
+    // client received, or an empty vector on failure. `limits` receives
+    // each change of LastRecordLimit() across the writes.
+    static std::vector<size_t> RunRecordSizingExchange(
+            TlsContext& server, const std::vector<size_t>& writes,
+            const std::vector<int>& gaps_ms, std::vector<size_t>* limits) {
+        size_t total = 0;
+        for (size_t w : writes) total += w;
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return {};
+        SSL_CTX* client_ctx = NewResumptionClientCtx(TLS1_2_VERSION);
+        SSL_CTX_set_cipher_list(client_ctx, "ECDHE-RSA-AES128-GCM-SHA256");
+        RecordLog log;
+        bool client_ok = false;
+        std::thread client_thread([&, fd = sv[0]]() {
+            SSL* ssl = SSL_new(client_ctx);
+            SSL_set_fd(ssl, fd);
+            SSL_set_msg_callback(ssl, RecordHeaderCallback);
+            SSL_set_msg_callback_arg(ssl, &log);
+            if (SSL_connect(ssl) == 1) {
+                size_t got = 0;
+                char buf[4096];
+                while (got < total) {
+                    int r = SSL_read(ssl, buf, sizeof(buf));
+                    if (r <= 0) break;
+                    got += static_cast<size_t>(r);
+                }
+                client_ok = got == total;
+            }
+            SSL_free(ssl);
+        });
+
+        bool server_ok = false;
+        {
+            TlsConnection conn(server, sv[1]);
+            if (conn.DoHandshake() == TlsConnection::TLS_COMPLETE) {
+                server_ok = true;
+                for (size_t i = 0; i < writes.size() && server_ok; ++i) {
+                    if (i < gaps_ms.size() && gaps_ms[i] > 0) {
+                        std::this_thread::sleep_for(
+                            std::chrono::milliseconds(gaps_ms[i]));
+                    }
+                    std::string data(writes[i], 'r');
+                    size_t off = 0;
+                    while (off < data.size()) {
+                        int w = conn.Write(data.data() + off, data.size() - off);
+                        if (w <= 0) { server_ok = false; break; }
+                        off += static_cast<size_t>(w);
+                        // Partial writes return per record; keep the
+                        // transitions only.
+                        if (limits->empty() || limits->back() != conn.LastRecordLimit()) {
+                            limits->push_back(conn.LastRecordLimit());
+                        }
+                    }
+                }
+            }
+        }
+        client_thread.join();
+        ::close(sv[0]);
+        ::close(sv[1]);
+        SSL_CTX_free(client_ctx);
+        if (!server_ok || !client_ok) return {};
+        return log.app_records;
+    }
+
+    static std::string JoinSizes(const std::vector<size_t>& v) {
+        std::string out;
+        for (size_t x : v) out += (out.empty() ? "" : ",") + std::to_string(x);
+        return out;
+    }
+
+    // Cold connections write small records up to the ramp point — the
+    // write crossing it is cut there — then full records; an idle gap
+    // makes the connection cold again. Without sizing, records are 16 KB.
+    void TestDynamicRecordSizing() {
+        std::cout << "\n[TEST] TLS dynamic record sizing..." << std::endl;
+        try {
+            if (!GenerateTestCert()) {
+                TestFramework::RecordTest("TLS dynamic record sizing", false,
+                    "Failed to generate test cert", TestFramework::TestCategory::OTHER);
+                return;
+            }
+            TlsContext sized("/tmp/test_cert.pem", "/tmp/test_key.pem");
+            TlsContext::RecordSizing sizing;
+            sizing.enabled = true;
+            sizing.initial_record_size = 1400;
+            sizing.ramp_bytes = 8192;
+            sizing.idle_reset_ms = 50;
+            sized.SetRecordSizing(sizing);
+            TlsContext plain("/tmp/test_cert.pem", "/tmp/test_key.pem");
+
+            std::string err;
+            std::vector<size_t> limits;
+            // 20000 = 8192 cold (5 x 1400 + 1192) + 11808 warm; after the
+            // idle gap 3000 = 1400 + 1400 + 200.
+            std::vector<size_t> records = RunRecordSizingExchange(
+                sized, {20000, 3000}, {0, 150}, &limits);
+            const std::vector<size_t> want = {1400, 1400, 1400, 1400, 1400, 1192,
+                                              11808, 1400, 1400, 200};
+            const std::vector<size_t> want_limits = {1400, 16384, 1400};
+            if (records != want) {
+                err = "sized records [" + JoinSizes(records) + "]";
+            } else if (limits != want_limits) {
+                err = "sized limits [" + JoinSizes(limits) + "]";
+            }
+
+            if (err.empty()) {
+                limits.clear();
+                records = RunRecordSizingExchange(plain, {20000}, {}, &limits);
+                if (records != std::vector<size_t>{16384, 3616} ||
+                    limits != std::vector<size_t>{16384}) {
+                    err = "unsized records [" + JoinSizes(records) +
+                          "] limits [" + JoinSizes(limits) + "]";
+                }
+            }
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS dynamic record sizing", err.empty(), err,
+                TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            CleanupTestCert();
+            TestFramework::RecordTest("TLS dynamic record sizing", false, e.what(),
+                TestFramework::TestCategory::OTHER);
+        }
+    }
+
     void RunAllTests() {
         std::cout << "\n" << std::string(60, '=') << std::endl;
         std::cout << "TLS/SSL - UNIT TESTS" << std::endl;
@@ -326,6 +1450,19 @@ namespace TlsTests {
         TestSniRuleIpv4LiteralNoFallback();
         TestSniRuleIpv6LiteralNoFallback();
         TestSniRuleExplicitOverridesAlways();
+        TestSessionTicketResumption();
+        TestTicketKeyFileShared();
+        TestTicketKeyRotation();
+        TestSessionCacheResumption();
+        TestTicketKeyFileInvalid();
+        TestClientSessionCacheReuse();
+        TestUpstreamPoolSessionReuse();
+        TestKtlsLoopback();
+        TestKtlsProxyRoundTrip();
+        TestKeyOffloadHandshake();
+        TestKeyOffloadAbandon();
+        TestKeyOffloadServer();
+        TestDynamicRecordSizing();
     }
 
 }  // namespace TlsTests
@@ -20,6 +20,7 @@
 #include "upstream/upstream_lease.h"
 #include "upstream/upstream_manager.h"
 #include "upstream/upstream_host_pool.h"
+#include "upstream/load_balancer.h"
 #include "upstream/pool_partition.h"
 #include "upstream/upstream_h2_connection.h"
 #include "upstream/host_port_key.h"
@@ -2545,6 +2546,578 @@ void TestUpstreamManagerEffectiveSni() {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Section 14: Multi-endpoint upstreams and load balancing
+// ---------------------------------------------------------------------------
+
+// `endpoints` / `load_balancer` parse, default the identity host/port to
+// the first endpoint, round-trip through ToJson, and validate.
+void TestConfigMultiEndpointLoadBalancer() {
+    std::cout << "\n[TEST] UpstreamPool Config: endpoints + load_balancer..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        const std::string json = R"({
+            "upstreams": [{
+                "name": "replicas",
+                "endpoints": [
+                    {"host": "10.0.0.1", "port": 8081, "weight": 3},
+                    {"host": "10.0.0.2", "port": 8082}
+                ],
+                "load_balancer": {"policy": "maglev", "hash_key": "header:X-User"}
+            }]
+        })";
+        ServerConfig cfg = ConfigLoader::LoadFromString(json);
+        ConfigLoader::Validate(cfg);
+        const auto& u = cfg.upstreams.at(0);
+        if (u.endpoints.size() != 2) { pass = false; err += "endpoint count; "; }
+        if (u.host != "10.0.0.1" || u.port != 8081) {
+            pass = false; err += "identity not defaulted to endpoints[0]; ";
+        }
+        if (u.endpoints.size() == 2 &&
+            (u.endpoints[0].weight != 3 || u.endpoints[1].weight != 1 ||
+             u.endpoints[1].port != 8082)) {
+            pass = false; err += "endpoint fields; ";
+        }
+        if (u.load_balancer.policy != "maglev" ||
+            u.load_balancer.hash_key != "header:X-User") {
+            pass = false; err += "load_balancer fields; ";
+        }
+        ServerConfig restored =
+            ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (restored.upstreams.size() != 1 || restored.upstreams[0] != u) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+        // A single-endpoint upstream keeps its one implicit endpoint.
+        UpstreamConfig single = MakeUpstreamConfig("one", "127.0.0.1", 9000);
+        if (single.EffectiveEndpoints().size() != 1 ||
+            single.EffectiveEndpoints()[0].port != 9000) {
+            pass = false; err += "EffectiveEndpoints single; ";
+        }
+
+        auto rejects = [&](const std::function<void(ServerConfig&)>& mutate,
+                           const std::string& what) {
+            ServerConfig bad = cfg;
+            mutate(bad);
+            try {
+                ConfigLoader::Validate(bad);
+                pass = false;
+                err += what + " accepted; ";
+            } catch (const std::invalid_argument&) {}
+        };
+        rejects([](ServerConfig& c) { c.upstreams[0].load_balancer.policy = "random"; },
+                "unknown policy");
+        rejects([](ServerConfig& c) { c.upstreams[0].load_balancer.hash_key = "header:"; },
+                "empty header hash_key");
+        rejects([](ServerConfig& c) { c.upstreams[0].load_balancer.hash_key = "cookie"; },
+                "unknown hash_key");
+        rejects([](ServerConfig& c) { c.upstreams[0].endpoints[1].weight = 0; },
+                "weight 0");
+        rejects([](ServerConfig& c) { c.upstreams[0].endpoints[1].port = 70000; },
+                "endpoint port");
+        rejects([](ServerConfig& c) { c.upstreams[0].endpoints[1].host = "bad host"; },
+                "endpoint host");
+        rejects([](ServerConfig& c) {
+                    c.upstreams.push_back(MakeUpstreamConfig("a#1", "127.0.0.1", 9000));
+                }, "'#' name beside a multi-endpoint upstream");
+
+        TestFramework::RecordTest("UpstreamPool Config: endpoints + load_balancer",
+                                  pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool Config: endpoints + load_balancer",
+                                  false, e.what());
+    }
+}
+
+// Policy behaviour of LoadBalancer in isolation.
+void TestLoadBalancerPolicies() {
+    std::cout << "\n[TEST] UpstreamPool LoadBalancer: policies..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        using Policy = LoadBalancer::Policy;
+        std::vector<LoadBalancer::Member> three = {
+            {"10.0.0.1:80", 1}, {"10.0.0.2:80", 1}, {"10.0.0.3:80", 1}};
+
+        // Round-robin cycles in order.
+        {
+            LoadBalancer lb(Policy::ROUND_ROBIN, three);
+            auto st = lb.MakeState(0);
+            for (size_t i = 0; i < 6; ++i) {
+                if (lb.Pick(st, 0, nullptr) != i % 3) {
+                    pass = false; err += "round_robin order; "; break;
+                }
+            }
+        }
+        // Smooth weighted: 3:1 over 8 picks is exactly 6:2, never three
+        // heavy picks in a row.
+        {
+            LoadBalancer lb(Policy::WEIGHTED, {{"a", 3}, {"b", 1}});
+            auto st = lb.MakeState(0);
+            int counts[2] = {0, 0};
+            int run = 0, max_run = 0;
+            for (int i = 0; i < 8; ++i) {
+                size_t m = lb.Pick(st, 0, nullptr);
+                ++counts[m];
+                run = (m == 0) ? run + 1 : 0;
+                max_run = std::max(max_run, run);
+            }
+            if (counts[0] != 6 || counts[1] != 2) {
+                pass = false; err += "weighted 3:1 split; ";
+            }
+            if (max_run > 3) { pass = false; err += "weighted not smooth; "; }
+        }
+        // P2C: a member with far more outstanding requests never wins a
+        // pairing, and each of the idle ones gets picked.
+        {
+            LoadBalancer lb(Policy::LEAST_REQUEST, three);
+            auto st = lb.MakeState(1);
+            std::vector<int> counts(3, 0);
+            auto load = [](size_t i) -> int64_t { return i == 0 ? 100 : 0; };
+            for (int i = 0; i < 300; ++i) ++counts[lb.Pick(st, 0, load)];
+            if (counts[0] != 0 || counts[1] == 0 || counts[2] == 0) {
+                pass = false; err += "least_request avoided busy member; ";
+            }
+        }
+        // Ring hash and Maglev: keys stick to a member, spread across all
+        // members, and removing a member only moves (almost only) its keys.
+        for (Policy policy : {Policy::RING_HASH, Policy::MAGLEV}) {
+            const std::string name =
+                policy == Policy::RING_HASH ? "ring_hash" : "maglev";
+            LoadBalancer lb(policy, three);
+            LoadBalancer shrunk(policy, {three[0], three[1]});
+            auto st = lb.MakeState(0);
+            auto st2 = shrunk.MakeState(0);
+            std::vector<int> counts(3, 0);
+            int stayed_total = 0, moved = 0;
+            for (int k = 0; k < 3000; ++k) {
+                uint64_t h = LoadBalancer::Hash("user-" + std::to_string(k));
+                size_t m = lb.Pick(st, h, nullptr);
+                if (lb.Pick(st, h, nullptr) != m) {
+                    pass = false; err += name + " not sticky; "; break;
+                }
+                ++counts[m];
+                if (m != 2) {
+                    ++stayed_total;
+                    if (shrunk.Pick(st2, h, nullptr) != m) ++moved;
+                }
+            }
+            for (int c : counts) {
+                if (c < 600) {   // 20% floor for a 33% share
+                    pass = false; err += name + " uneven spread; "; break;
+                }
+            }
+            // Ring hash moves none of the surviving keys; Maglev trades a
+            // little disruption for its even spread.
+            if (moved * 100 > stayed_total * 5) {
+                pass = false;
+                err += name + " moved " + std::to_string(moved) + " keys; ";
+            }
+        }
+        // Weighted Maglev: a 2:1 member owns about two thirds of the table.
+        {
+            LoadBalancer lb(Policy::MAGLEV, {{"a", 2}, {"b", 1}});
+            auto st = lb.MakeState(0);
+            int heavy = 0;
+            for (int k = 0; k < 3000; ++k) {
+                if (lb.Pick(st, LoadBalancer::Hash(std::to_string(k)), nullptr) == 0) {
+                    ++heavy;
+                }
+            }
+            if (heavy < 1800 || heavy > 2200) {
+                pass = false;
+                err += "weighted maglev share " + std::to_string(heavy) + "/3000; ";
+            }
+        }
+        // No request key: hash policies fall back to round-robin.
+        {
+            LoadBalancer lb(Policy::RING_HASH, three);
+            auto st = lb.MakeState(0);
+            std::set<size_t> seen;
+            for (int i = 0; i < 3; ++i) seen.insert(lb.Pick(st, 0, nullptr));
+            if (seen.size() != 3) { pass = false; err += "keyless fallback; "; }
+        }
+
+        TestFramework::RecordTest("UpstreamPool LoadBalancer: policies", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool LoadBalancer: policies", false, e.what());
+    }
+}
+
+// An upstream with two endpoints, the second resolving to two addresses,
+// gets three members: one partition each per dispatcher, all visible to
+// the enumerators, selected in turn, and re-pointed per endpoint on a
+// DNS refresh.
+void TestUpstreamManagerMultiEndpoint() {
+    std::cout << "\n[TEST] UpstreamPool: multi-endpoint members..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        auto dispatcher = std::make_shared<Dispatcher>(true, 5);
+        std::thread dt = StartDispatcher(dispatcher);
+
+        UpstreamConfig u = MakeUpstreamConfig("svc", "127.0.0.1", 9911);
+        UpstreamEndpointConfig e0, e1;
+        e0.host = "127.0.0.1"; e0.port = 9911;
+        e1.host = "backend.internal"; e1.port = 9912;
+        u.endpoints = {e0, e1};
+
+        auto make_ep = [](std::vector<std::string> ips, int port) {
+            auto ep = std::make_shared<NET_DNS_NAMESPACE::ResolvedEndpoint>();
+            for (const auto& ip : ips) ep->addrs.emplace_back(ip, port);
+            ep->addr = ep->addrs.front();
+            ep->port = port;
+            ep->resolved_at = std::chrono::steady_clock::now();
+            return ep;
+        };
+        NET_DNS_NAMESPACE::ResolvedMap resolved;
+        resolved["svc"] = make_ep({"127.0.0.1"}, 9911);
+        resolved[UpstreamManager::EndpointResolveKey("svc", 1)] =
+            make_ep({"127.0.0.2", "127.0.0.3"}, 9912);
+
+        UpstreamManager mgr({u}, {dispatcher}, resolved);
+        DispatcherThreadGuard dtg{dispatcher, dt};
+
+        auto parts = mgr.GetPoolPartitions("svc", 0);
+        if (parts.size() != 3) {
+            pass = false;
+            err += "expected 3 members, got " + std::to_string(parts.size()) + "; ";
+        } else {
+            std::vector<std::string> ips;
+            for (auto* p : parts) ips.push_back(p->LoadResolvedEndpoint()->addr.Ip());
+            if (ips != std::vector<std::string>{"127.0.0.1", "127.0.0.2", "127.0.0.3"}) {
+                pass = false; err += "member addresses; ";
+            }
+            if (mgr.GetPoolPartition("svc", 0) != parts[0]) {
+                pass = false; err += "GetPoolPartition not first member; ";
+            }
+            if (mgr.LivePartitions().size() != 3) {
+                pass = false; err += "LivePartitions count; ";
+            }
+            std::set<PoolPartition*> picked;
+            for (int i = 0; i < 3; ++i) picked.insert(mgr.SelectPartition("svc", 0, 0));
+            if (picked.size() != 3) { pass = false; err += "round-robin members; "; }
+
+            // Refresh endpoint 1 down to one address: both of its members
+            // follow it; endpoint 0 is untouched.
+            NET_DNS_NAMESPACE::ResolvedMap refreshed;
+            refreshed[UpstreamManager::EndpointResolveKey("svc", 1)] =
+                make_ep({"127.0.0.4"}, 9912);
+            mgr.UpdateResolvedEndpoints(refreshed);
+            if (parts[0]->LoadResolvedEndpoint()->addr.Ip() != "127.0.0.1" ||
+                parts[1]->LoadResolvedEndpoint()->addr.Ip() != "127.0.0.4" ||
+                parts[2]->LoadResolvedEndpoint()->addr.Ip() != "127.0.0.4") {
+                pass = false; err += "per-endpoint refresh; ";
+            }
+        }
+        if (UpstreamManager::EndpointResolveKey("svc", 0) != "svc" ||
+            UpstreamManager::EndpointResolveKey("svc", 2) != "svc#2") {
+            pass = false; err += "EndpointResolveKey; ";
+        }
+
+        TestFramework::RecordTest("UpstreamPool: multi-endpoint members", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool: multi-endpoint members", false, e.what());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Section 15: Active health checks
+// ---------------------------------------------------------------------------
+
+// `health_check` parses, round-trips through ToJson, and validates.
+void TestConfigHealthCheck() {
+    std::cout << "\n[TEST] UpstreamPool Config: health_check..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        const std::string json = R"({
+            "upstreams": [{
+                "name": "checked",
+                "host": "127.0.0.1",
+                "port": 8080,
+                "health_check": {
+                    "enabled": true,
+                    "type": "http",
+                    "path": "/healthz",
+                    "host": "svc.internal",
+                    "interval_ms": 1000,
+                    "timeout_ms": 250,
+                    "jitter_percent": 20,
+                    "healthy_threshold": 1,
+                    "unhealthy_threshold": 4,
+                    "expected_status_min": 200,
+                    "expected_status_max": 204
+                }
+            }]
+        })";
+        ServerConfig cfg = ConfigLoader::LoadFromString(json);
+        ConfigLoader::Validate(cfg);
+        const auto& hc = cfg.upstreams.at(0).health_check;
+        if (!hc.enabled || hc.type != "http" || hc.path != "/healthz" ||
+            hc.host != "svc.internal") {
+            pass = false; err += "string fields; ";
+        }
+        if (hc.interval_ms != 1000 || hc.timeout_ms != 250 ||
+            hc.jitter_percent != 20 || hc.healthy_threshold != 1 ||
+            hc.unhealthy_threshold != 4 || hc.expected_status_max != 204) {
+            pass = false; err += "numeric fields; ";
+        }
+        ServerConfig restored =
+            ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (restored.upstreams.size() != 1 ||
+            restored.upstreams[0] != cfg.upstreams[0]) {
+            pass = false; err += "round-trip mismatch; ";
+        }
+        // Disabled by default.
+        if (MakeUpstreamConfig("plain", "127.0.0.1", 9000).health_check.enabled) {
+            pass = false; err += "enabled by default; ";
+        }
+
+        auto rejects = [&](const std::function<void(UpstreamHealthCheckConfig&)>& mutate,
+                           const std::string& what) {
+            ServerConfig bad = cfg;
+            mutate(bad.upstreams[0].health_check);
+            try {
+                ConfigLoader::Validate(bad);
+                pass = false;
+                err += what + " accepted; ";
+            } catch (const std::invalid_argument&) {}
+        };
+        rejects([](UpstreamHealthCheckConfig& h) { h.type = "grpc"; }, "unknown type");
+        rejects([](UpstreamHealthCheckConfig& h) { h.path = "health"; }, "relative path");
+        rejects([](UpstreamHealthCheckConfig& h) { h.path = "/a b"; }, "path with space");
+        rejects([](UpstreamHealthCheckConfig& h) { h.interval_ms = 10; }, "interval_ms 10");
+        rejects([](UpstreamHealthCheckConfig& h) { h.timeout_ms = 2000; },
+                "timeout_ms above interval_ms");
+        rejects([](UpstreamHealthCheckConfig& h) { h.jitter_percent = 80; }, "jitter 80");
+        rejects([](UpstreamHealthCheckConfig& h) { h.unhealthy_threshold = 0; },
+                "unhealthy_threshold 0");
+        rejects([](UpstreamHealthCheckConfig& h) {
+                    h.expected_status_min = 300; h.expected_status_max = 200;
+                }, "inverted status range");
+
+        TestFramework::RecordTest("UpstreamPool Config: health_check", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool Config: health_check", false, e.what());
+    }
+}
+
+// Pick() with an eligibility filter: excluded members are skipped by
+// every policy, hash policies move only the excluded member's keys, and
+// with nobody eligible the filter is ignored.
+void TestLoadBalancerEligibility() {
+    std::cout << "\n[TEST] UpstreamPool LoadBalancer: eligibility..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        using Policy = LoadBalancer::Policy;
+        std::vector<LoadBalancer::Member> three = {
+            {"10.0.0.1:80", 1}, {"10.0.0.2:80", 2}, {"10.0.0.3:80", 1}};
+        auto not_1 = [](size_t i) { return i != 1; };
+
+        for (Policy policy : {Policy::ROUND_ROBIN, Policy::WEIGHTED,
+                              Policy::LEAST_REQUEST}) {
+            LoadBalancer lb(policy, three);
+            auto st = lb.MakeState(0);
+            std::vector<int> counts(3, 0);
+            for (int i = 0; i < 60; ++i) ++counts[lb.Pick(st, 0, nullptr, not_1)];
+            if (counts[1] != 0 || counts[0] == 0 || counts[2] == 0) {
+                pass = false;
+                err += "policy " + std::to_string(static_cast<int>(policy)) +
+                       " used excluded member; ";
+            }
+            // Weighted keeps the survivors' 1:1 ratio exactly.
+            if (policy == Policy::WEIGHTED && counts[0] != counts[2]) {
+                pass = false; err += "weighted survivors split; ";
+            }
+        }
+        for (Policy policy : {Policy::RING_HASH, Policy::MAGLEV}) {
+            const std::string name =
+                policy == Policy::RING_HASH ? "ring_hash" : "maglev";
+            LoadBalancer lb(policy, three);
+            auto st = lb.MakeState(0);
+            int moved = 0;
+            for (int k = 0; k < 2000; ++k) {
+                uint64_t h = LoadBalancer::Hash("user-" + std::to_string(k));
+                size_t before = lb.Pick(st, h, nullptr);
+                size_t after = lb.Pick(st, h, nullptr, not_1);
+                if (after == 1) { pass = false; err += name + " picked excluded; "; break; }
+                if (before != 1 && after != before) ++moved;
+            }
+            if (moved != 0) {
+                pass = false;
+                err += name + " moved " + std::to_string(moved) + " surviving keys; ";
+            }
+        }
+        {
+            LoadBalancer lb(Policy::ROUND_ROBIN, three);
+            auto st = lb.MakeState(0);
+            std::set<size_t> seen;
+            for (int i = 0; i < 3; ++i) {
+                seen.insert(lb.Pick(st, 0, nullptr, [](size_t) { return false; }));
+            }
+            if (seen.size() != 3) { pass = false; err += "none-eligible fallback; "; }
+        }
+
+        TestFramework::RecordTest("UpstreamPool LoadBalancer: eligibility", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool LoadBalancer: eligibility", false, e.what());
+    }
+}
+
+// A port with nothing listening (bound, then closed).
+int ClosedLoopbackPort() {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    ::close(fd);
+    return ntohs(addr.sin_port);
+}
+
+// Two-endpoint upstream with fast checks against `live_port` and a
+// closed port, resolved without DNS.
+UpstreamConfig MakeHealthCheckedUpstream(const std::string& type,
+                                         int live_port, int dead_port,
+                                         NET_DNS_NAMESPACE::ResolvedMap* resolved) {
+    UpstreamConfig u = MakeUpstreamConfig("svc", "127.0.0.1", live_port);
+    UpstreamEndpointConfig e0, e1;
+    e0.host = "127.0.0.1"; e0.port = live_port;
+    e1.host = "127.0.0.1"; e1.port = dead_port;
+    u.endpoints = {e0, e1};
+    u.health_check.enabled = true;
+    u.health_check.type = type;
+    u.health_check.interval_ms = 100;
+    u.health_check.timeout_ms = 80;
+    u.health_check.jitter_percent = 0;
+    u.health_check.healthy_threshold = 1;
+    u.health_check.unhealthy_threshold = 2;
+    auto make_ep = [](int port) {
+        auto ep = std::make_shared<NET_DNS_NAMESPACE::ResolvedEndpoint>();
+        ep->addrs.emplace_back("127.0.0.1", port);
+        ep->addr = ep->addrs.front();
+        ep->port = port;
+        ep->resolved_at = std::chrono::steady_clock::now();
+        return ep;
+    };
+    (*resolved)["svc"] = make_ep(live_port);
+    (*resolved)[UpstreamManager::EndpointResolveKey("svc", 1)] = make_ep(dead_port);
+    return u;
+}
+
+bool WaitFor(const std::function<bool()>& cond, int timeout_ms = 3000) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (cond()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return cond();
+}
+
+// HTTP checks: the closed endpoint goes unhealthy and drops out of the
+// rotation; the live one follows its /health status both ways.
+void TestHealthCheckHttpTransitions() {
+    std::cout << "\n[TEST] UpstreamPool: HTTP health check transitions..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        auto health_status = std::make_shared<std::atomic<int>>(200);
+        HttpServer backend("127.0.0.1", 0);
+        backend.Get("/health", [health_status](const HttpRequest&, HttpResponse& res) {
+            res.Status(health_status->load()).Body("ok");
+        });
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        auto dispatcher = std::make_shared<Dispatcher>(true, 5);
+        std::thread dt = StartDispatcher(dispatcher);
+        NET_DNS_NAMESPACE::ResolvedMap resolved;
+        UpstreamConfig u = MakeHealthCheckedUpstream(
+            "http", backend_runner.GetPort(), ClosedLoopbackPort(), &resolved);
+        UpstreamManager mgr({u}, {dispatcher}, resolved);
+        DispatcherThreadGuard dtg{dispatcher, dt};
+        const UpstreamHostPool* pool = mgr.GetHostPool("svc");
+
+        if (!pool || !WaitFor([pool] { return !pool->member_healthy(1); })) {
+            pass = false; err += "closed endpoint never marked unhealthy; ";
+        } else {
+            if (!pool->member_healthy(0)) {
+                pass = false; err += "live endpoint marked unhealthy; ";
+            }
+            auto parts = mgr.GetPoolPartitions("svc", 0);
+            for (int i = 0; i < 6; ++i) {
+                if (mgr.SelectPartition("svc", 0, 0) != parts[0]) {
+                    pass = false; err += "unhealthy member selected; "; break;
+                }
+            }
+            health_status->store(503);
+            if (!WaitFor([pool] { return !pool->member_healthy(0); })) {
+                pass = false; err += "503 never marked unhealthy; ";
+            } else if (mgr.HasHealthyEndpoint("svc")) {
+                pass = false; err += "HasHealthyEndpoint with none healthy; ";
+            }
+            health_status->store(200);
+            if (!WaitFor([pool] { return pool->member_healthy(0); })) {
+                pass = false; err += "recovery never marked healthy; ";
+            }
+            if (pool->health_checks_passed() == 0 ||
+                pool->health_checks_failed() == 0) {
+                pass = false; err += "check counters; ";
+            }
+        }
+
+        TestFramework::RecordTest("UpstreamPool: HTTP health check transitions", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool: HTTP health check transitions", false, e.what());
+    }
+}
+
+// TCP checks pass on connect alone.
+void TestHealthCheckTcp() {
+    std::cout << "\n[TEST] UpstreamPool: TCP health check..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+
+        HttpServer backend("127.0.0.1", 0);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        auto dispatcher = std::make_shared<Dispatcher>(true, 5);
+        std::thread dt = StartDispatcher(dispatcher);
+        NET_DNS_NAMESPACE::ResolvedMap resolved;
+        UpstreamConfig u = MakeHealthCheckedUpstream(
+            "tcp", backend_runner.GetPort(), ClosedLoopbackPort(), &resolved);
+        UpstreamManager mgr({u}, {dispatcher}, resolved);
+        DispatcherThreadGuard dtg{dispatcher, dt};
+        const UpstreamHostPool* pool = mgr.GetHostPool("svc");
+
+        if (!pool || !WaitFor([pool] { return !pool->member_healthy(1); })) {
+            pass = false; err += "closed endpoint never marked unhealthy; ";
+        } else {
+            if (!WaitFor([pool] { return pool->health_checks_passed() >= 2; }) ||
+                !pool->member_healthy(0)) {
+                pass = false; err += "listening endpoint not passing; ";
+            }
+            if (!mgr.HasHealthyEndpoint("svc")) {
+                pass = false; err += "HasHealthyEndpoint; ";
+            }
+        }
+
+        TestFramework::RecordTest("UpstreamPool: TCP health check", pass, err);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("UpstreamPool: TCP health check", false, e.what());
+    }
+}
+
 // ---------------------------------------------------------------------------
 // RunAllTests
 // ---------------------------------------------------------------------------
@@ -2625,6 +3198,17 @@ void RunAllTests() {
 
     // Section 13: §5.10 effective-SNI derivation
     TestUpstreamManagerEffectiveSni();
+
+    // Section 14: Multi-endpoint upstreams and load balancing
+    TestConfigMultiEndpointLoadBalancer();
+    TestLoadBalancerPolicies();
+    TestUpstreamManagerMultiEndpoint();
+
+    // Section 15: Active health checks
+    TestConfigHealthCheck();
+    TestLoadBalancerEligibility();
+    TestHealthCheckHttpTransitions();
+    TestHealthCheckTcp();
 }
 
 } // namespace UpstreamPoolTests
@@ -0,0 +1,439 @@
+#pragma once
+
+// websocket_broadcast_test.h — WebSocketBroadcaster topic fan-out.
+//
+// All tests run a real HttpServer and raw TCP clients:
+//   T1  Fan-out across dispatchers: every subscriber receives a single
+//       broadcast and an ordered burst; stats count the deliveries
+//   T2  Unsubscribe from a message callback; a disconnected subscriber
+//       is pruned after the next delivery
+//   T3  SlowConsumerPolicy::DROP: a non-reading client loses whole
+//       frames, stays subscribed, and what it does get parses cleanly
+//   T4  SlowConsumerPolicy::DISCONNECT: the slow client is closed and
+//       unsubscribed
+//   T5  API edges: unknown topic, duplicate subscribe, SetTopicOptions
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http/http_server.h"
+#include "ws/websocket_broadcast.h"
+#include "ws/websocket_connection.h"
+#include "config/server_config.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace WebSocketBroadcastTests {
+
+// Connect and complete the upgrade. `rcvbuf` > 0 shrinks the client's
+// receive buffer (set before connect so the window starts small).
+inline int ConnectWs(int port, int rcvbuf = 0) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (rcvbuf > 0) {
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    const std::string req =
+        "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n"
+        "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (::send(fd, req.data(), req.size(), 0) != static_cast<ssize_t>(req.size())) {
+        ::close(fd);
+        return -1;
+    }
+    // Read the 101 header block byte by byte so no frame bytes are eaten.
+    std::string head;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        char c;
+        if (::recv(fd, &c, 1, 0) != 1) break;
+        head.push_back(c);
+        if (head.size() >= 4 && head.compare(head.size() - 4, 4, "\r\n\r\n") == 0) {
+            if (head.find(" 101 ") != std::string::npos) return fd;
+            break;
+        }
+    }
+    ::close(fd);
+    return -1;
+}
+
+inline std::string ReadN(int fd, size_t n, int timeout_ms = 3000) {
+    std::string out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (out.size() < n && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        char buf[65536];
+        ssize_t r = ::recv(fd, buf, std::min(sizeof(buf), n - out.size()), 0);
+        if (r <= 0) break;
+        out.append(buf, static_cast<size_t>(r));
+    }
+    return out;
+}
+
+// One unmasked server frame. Returns false on timeout / short read.
+inline bool ReadFrame(int fd, uint8_t& byte0, std::string& payload, int timeout_ms = 3000) {
+    std::string hdr = ReadN(fd, 2, timeout_ms);
+    if (hdr.size() < 2) return false;
+    byte0 = static_cast<uint8_t>(hdr[0]);
+    uint64_t len = static_cast<uint8_t>(hdr[1]) & 0x7F;
+    if (len == 126) {
+        std::string ext = ReadN(fd, 2, timeout_ms);
+        if (ext.size() < 2) return false;
+        len = (static_cast<uint8_t>(ext[0]) << 8) | static_cast<uint8_t>(ext[1]);
+    } else if (len == 127) {
+        std::string ext = ReadN(fd, 8, timeout_ms);
+        if (ext.size() < 8) return false;
+        len = 0;
+        for (char c : ext) len = (len << 8) | static_cast<uint8_t>(c);
+    }
+    payload = ReadN(fd, static_cast<size_t>(len), timeout_ms);
+    return payload.size() == len;
+}
+
+// Masked client text frame.
+inline std::string ClientText(const std::string& payload) {
+    std::string f;
+    f.push_back(static_cast<char>(0x81));
+    f.push_back(static_cast<char>(0x80 | payload.size()));  // < 126 only
+    const uint8_t mask[4] = {1, 2, 3, 4};
+    f.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        f.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    return f;
+}
+
+inline bool WaitFor(const std::function<bool()>& pred, int timeout_ms = 3000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
+inline ServerConfig BroadcastServerConfig() {
+    ServerConfig cfg;
+    cfg.bind_host = "127.0.0.1";
+    cfg.bind_port = 0;
+    cfg.worker_threads = 2;
+    return cfg;
+}
+
+// T1
+void TestFanOutAcrossDispatchers() {
+    std::cout << "\n[TEST] WS broadcast: fan-out across dispatchers..." << std::endl;
+    std::vector<int> fds;
+    try {
+        HttpServer server(BroadcastServerConfig());
+        server.WebSocket("/ws", [&server](WebSocketConnection& conn) {
+            server.Broadcaster().Subscribe("room", conn);
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        for (int i = 0; i < 4; ++i) {
+            int fd = ConnectWs(runner.GetPort());
+            if (fd < 0) throw std::runtime_error("connect/upgrade failed");
+            fds.push_back(fd);
+        }
+        if (!WaitFor([&] { return server.Broadcaster().SubscriberCount("room") == 4; })) {
+            pass = false; err += "subscriber count never reached 4; ";
+        }
+
+        size_t n = server.Broadcaster().BroadcastText("room", "hello room");
+        if (n != 4) { pass = false; err += "recipients=" + std::to_string(n) + "; "; }
+        for (int fd : fds) {
+            uint8_t b0 = 0;
+            std::string payload;
+            if (!ReadFrame(fd, b0, payload) || b0 != 0x81 || payload != "hello room") {
+                pass = false; err += "client missed first broadcast; ";
+            }
+        }
+
+        // A burst from one thread arrives complete and in order.
+        const int kBurst = 50;
+        for (int i = 0; i < kBurst; ++i) {
+            server.Broadcaster().BroadcastBinary("room", "m" + std::to_string(i));
+        }
+        for (int fd : fds) {
+            for (int i = 0; i < kBurst; ++i) {
+                uint8_t b0 = 0;
+                std::string payload;
+                if (!ReadFrame(fd, b0, payload) || b0 != 0x82 ||
+                    payload != "m" + std::to_string(i)) {
+                    pass = false; err += "burst frame " + std::to_string(i) + " wrong; ";
+                    break;
+                }
+            }
+        }
+        auto stats = server.Broadcaster().GetStats();
+        if (stats.broadcasts != kBurst + 1 || stats.delivered != 4u * (kBurst + 1) ||
+            stats.dropped != 0) {
+            pass = false;
+            err += "stats broadcasts=" + std::to_string(stats.broadcasts) +
+                   " delivered=" + std::to_string(stats.delivered) + "; ";
+        }
+
+        for (int fd : fds) ::close(fd);
+        fds.clear();
+        TestFramework::RecordTest("WS broadcast: fan-out across dispatchers",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        for (int fd : fds) ::close(fd);
+        TestFramework::RecordTest("WS broadcast: fan-out across dispatchers",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestUnsubscribeAndPrune() {
+    std::cout << "\n[TEST] WS broadcast: unsubscribe + prune closed..." << std::endl;
+    std::vector<int> fds;
+    try {
+        HttpServer server(BroadcastServerConfig());
+        server.WebSocket("/ws", [&server](WebSocketConnection& conn) {
+            server.Broadcaster().Subscribe("room", conn);
+            conn.OnMessage([&server](WebSocketConnection& c, const std::string& msg, bool) {
+                if (msg == "leave") {
+                    bool ok = server.Broadcaster().Unsubscribe("room", c);
+                    c.SendText(ok ? "left" : "not-subscribed");
+                }
+            });
+        });
+        TestServerRunner<HttpServer> runner(server);
+        auto& hub = server.Broadcaster();
+
+        bool pass = true;
+        std::string err;
+        for (int i = 0; i < 3; ++i) {
+            int fd = ConnectWs(runner.GetPort());
+            if (fd < 0) throw std::runtime_error("connect/upgrade failed");
+            fds.push_back(fd);
+        }
+        WaitFor([&] { return hub.SubscriberCount("room") == 3; });
+
+        std::string leave = ClientText("leave");
+        ::send(fds[0], leave.data(), leave.size(), 0);
+        uint8_t b0 = 0;
+        std::string payload;
+        if (!ReadFrame(fds[0], b0, payload) || payload != "left") {
+            pass = false; err += "unsubscribe reply=" + payload + "; ";
+        }
+        if (hub.SubscriberCount("room") != 2) {
+            pass = false; err += "count after leave=" + std::to_string(hub.SubscriberCount("room")) + "; ";
+        }
+
+        // Drop client 1 without a Close; the server notices the EOF and
+        // destroys the connection. The next delivery prunes it.
+        ::close(fds[1]);
+        fds[1] = -1;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        hub.BroadcastText("room", "after-close");
+        if (!WaitFor([&] { return hub.SubscriberCount("room") == 1; })) {
+            pass = false; err += "closed subscriber not pruned (count=" +
+                                 std::to_string(hub.SubscriberCount("room")) + "); ";
+        }
+        if (!ReadFrame(fds[2], b0, payload) || payload != "after-close") {
+            pass = false; err += "remaining subscriber missed broadcast; ";
+        }
+        // The unsubscribed client gets nothing.
+        if (ReadFrame(fds[0], b0, payload, 300)) {
+            pass = false; err += "unsubscribed client received " + payload + "; ";
+        }
+
+        for (int fd : fds) if (fd >= 0) ::close(fd);
+        fds.clear();
+        TestFramework::RecordTest("WS broadcast: unsubscribe + prune closed",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        for (int fd : fds) if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS broadcast: unsubscribe + prune closed",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// Shared body of T3 / T4: one client that never reads, flooded until
+// its server-side output buffer passes max_pending_bytes.
+inline void FloodSlowConsumer(HttpServer& server, int port, SlowConsumerPolicy policy,
+                              int& fd_out) {
+    WebSocketTopicOptions opts;
+    opts.max_pending_bytes = 64 * 1024;
+    opts.slow_consumer_policy = policy;
+    server.Broadcaster().SetTopicOptions("feed", opts);
+
+    fd_out = ConnectWs(port, /*rcvbuf=*/4096);
+    if (fd_out < 0) throw std::runtime_error("connect/upgrade failed");
+    WaitFor([&] { return server.Broadcaster().SubscriberCount("feed") == 1; });
+
+    const std::string chunk(32 * 1024, 'x');
+    for (int i = 0; i < 400; ++i) {
+        server.Broadcaster().BroadcastBinary("feed", chunk);
+        auto s = server.Broadcaster().GetStats();
+        if (s.dropped > 0 || s.disconnected > 0) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// T3
+void TestSlowConsumerDrop() {
+    std::cout << "\n[TEST] WS broadcast: slow consumer DROP..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer server(BroadcastServerConfig());
+        server.WebSocket("/ws", [&server](WebSocketConnection& conn) {
+            server.Broadcaster().Subscribe("feed", conn);
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        FloodSlowConsumer(server, runner.GetPort(), SlowConsumerPolicy::DROP, fd);
+
+        if (!WaitFor([&] { return server.Broadcaster().GetStats().dropped > 0; })) {
+            pass = false; err += "nothing dropped; ";
+        }
+        if (server.Broadcaster().SubscriberCount("feed") != 1) {
+            pass = false; err += "DROP policy unsubscribed the client; ";
+        }
+        // Whatever was queued is whole frames.
+        for (int i = 0; i < 3; ++i) {
+            uint8_t b0 = 0;
+            std::string payload;
+            if (!ReadFrame(fd, b0, payload) || b0 != 0x82 ||
+                payload != std::string(32 * 1024, 'x')) {
+                pass = false; err += "queued frame " + std::to_string(i) + " corrupt; ";
+                break;
+            }
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS broadcast: slow consumer DROP",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS broadcast: slow consumer DROP",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestSlowConsumerDisconnect() {
+    std::cout << "\n[TEST] WS broadcast: slow consumer DISCONNECT..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer server(BroadcastServerConfig());
+        server.WebSocket("/ws", [&server](WebSocketConnection& conn) {
+            server.Broadcaster().Subscribe("feed", conn);
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+        FloodSlowConsumer(server, runner.GetPort(), SlowConsumerPolicy::DISCONNECT, fd);
+
+        if (!WaitFor([&] { return server.Broadcaster().GetStats().disconnected == 1; })) {
+            pass = false; err += "disconnected=" +
+                std::to_string(server.Broadcaster().GetStats().disconnected) + "; ";
+        }
+        if (!WaitFor([&] { return server.Broadcaster().SubscriberCount("feed") == 0; })) {
+            pass = false; err += "slow client still subscribed; ";
+        }
+        auto before = server.Broadcaster().GetStats().delivered;
+        server.Broadcaster().BroadcastText("feed", "late");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (server.Broadcaster().GetStats().delivered != before) {
+            pass = false; err += "delivered after disconnect; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS broadcast: slow consumer DISCONNECT",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS broadcast: slow consumer DISCONNECT",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestApiEdges() {
+    std::cout << "\n[TEST] WS broadcast: API edges..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer server(BroadcastServerConfig());
+        std::atomic<int> first{-1}, second{-1};
+        server.WebSocket("/ws", [&](WebSocketConnection& conn) {
+            first = server.Broadcaster().Subscribe("room", conn) ? 1 : 0;
+            second = server.Broadcaster().Subscribe("room", conn) ? 1 : 0;
+        });
+        TestServerRunner<HttpServer> runner(server);
+        auto& hub = server.Broadcaster();
+
+        bool pass = true;
+        std::string err;
+        if (hub.BroadcastText("nobody-here", "x") != 0) {
+            pass = false; err += "unknown topic had recipients; ";
+        }
+        fd = ConnectWs(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect/upgrade failed");
+        WaitFor([&] { return first.load() >= 0 && second.load() >= 0; });
+        if (first.load() != 1 || second.load() != 0) {
+            pass = false; err += "duplicate subscribe accepted; ";
+        }
+        if (hub.SubscriberCount("room") != 1) {
+            pass = false; err += "count=" + std::to_string(hub.SubscriberCount("room")) + "; ";
+        }
+
+        // Options survive an empty topic; an unconfigured empty topic
+        // is forgotten.
+        hub.SetTopicOptions("configured", WebSocketTopicOptions{});
+        if (hub.SubscriberCount("configured") != 0 ||
+            hub.BroadcastText("configured", "x") != 0) {
+            pass = false; err += "configured empty topic had recipients; ";
+        }
+        if (hub.GetStats().broadcasts != 0) {
+            pass = false; err += "broadcast with no recipients counted; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS broadcast: API edges",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS broadcast: API edges",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n===== WebSocket Broadcast Tests =====" << std::endl;
+    TestFanOutAcrossDispatchers();
+    TestUnsubscribeAndPrune();
+    TestSlowConsumerDrop();
+    TestSlowConsumerDisconnect();
+    TestApiEdges();
+}
+
+}  // namespace WebSocketBroadcastTests
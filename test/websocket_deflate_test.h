@@ -0,0 +1,501 @@
+#pragma once
+
+// websocket_deflate_test.h — permessage-deflate (RFC 7692) for
+// WebSocketConnection.
+//
+// Test dimensions:
+//   Unit (in-process, no sockets):
+//     T1  Handshake negotiation: plain offer, window-bits clamping, hint
+//         echo, declined offers (8-bit server window, unknown / duplicate
+//         parameter) falling through to the next offer, disabled config
+//     T2  Codec round-trip with and without context takeover; takeover
+//         makes a repeated message smaller; oversize and corrupt input
+//     T3  Memory budget: reservation per context-takeover direction,
+//         refusal at the cap, release on destruction, shared-context
+//         directions cost nothing
+//     T4  Parser: RSV1 rejected until allowed, then accepted on data
+//         frames only
+//   Integration (real HttpServer, raw TCP client):
+//     T5  Negotiated connection: 101 carries the extension, a compressed
+//         client message is inflated for OnMessage, the echo comes back
+//         with RSV1 set; a client without an offer gets plain frames
+//   Config:
+//     T6  websocket.permessage_deflate JSON round-trip + range validation
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http/http_server.h"
+#include "ws/websocket_connection.h"
+#include "ws/websocket_deflate.h"
+#include "ws/websocket_handshake.h"
+#include "ws/websocket_parser.h"
+#include "config/server_config.h"
+#include "config/config_loader.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace WebSocketDeflateTests {
+
+inline HttpRequest MakeUpgrade(const std::string& extensions) {
+    HttpRequest req;
+    req.method = "GET";
+    req.http_major = 1; req.http_minor = 1;
+    req.headers["host"] = "localhost";
+    req.headers["upgrade"] = "websocket";
+    req.headers["connection"] = "Upgrade";
+    req.headers["sec-websocket-key"] = "dGhlIHNhbXBsZSBub25jZQ==";
+    req.headers["sec-websocket-version"] = "13";
+    if (!extensions.empty()) req.headers["sec-websocket-extensions"] = extensions;
+    return req;
+}
+
+inline WebSocketDeflateConfig EnabledConfig() {
+    WebSocketDeflateConfig c;
+    c.enabled = true;
+    c.min_message_size = 0;
+    return c;
+}
+
+// Masked client frame; `rsv1` marks a compressed message.
+inline std::string ClientFrame(uint8_t opcode, const std::string& payload,
+                               bool rsv1 = false, bool fin = true) {
+    std::string f;
+    f.push_back(static_cast<char>((fin ? 0x80 : 0) | (rsv1 ? 0x40 : 0) | opcode));
+    size_t len = payload.size();
+    if (len < 126) {
+        f.push_back(static_cast<char>(0x80 | len));
+    } else if (len <= 0xFFFF) {
+        f.push_back(static_cast<char>(0x80 | 126));
+        f.push_back(static_cast<char>((len >> 8) & 0xFF));
+        f.push_back(static_cast<char>(len & 0xFF));
+    } else {
+        f.push_back(static_cast<char>(0x80 | 127));
+        for (int i = 7; i >= 0; --i) f.push_back(static_cast<char>((len >> (8 * i)) & 0xFF));
+    }
+    const uint8_t mask[4] = {0x37, 0xfa, 0x21, 0x3d};
+    f.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < len; ++i) f.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    return f;
+}
+
+inline int Connect(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+inline bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Read exactly `n` bytes (or fewer on timeout / close).
+inline std::string ReadN(int fd, size_t n, int timeout_ms = 3000) {
+    std::string out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (out.size() < n && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        char buf[4096];
+        ssize_t r = ::recv(fd, buf, std::min(sizeof(buf), n - out.size()), 0);
+        if (r <= 0) break;
+        out.append(buf, static_cast<size_t>(r));
+    }
+    return out;
+}
+
+inline std::string ReadHeaderBlock(int fd) {
+    std::string buf;
+    while (buf.size() < 8192) {
+        std::string c = ReadN(fd, 1);
+        if (c.empty()) break;
+        buf += c;
+        if (buf.size() >= 4 && buf.compare(buf.size() - 4, 4, "\r\n\r\n") == 0) break;
+    }
+    return buf;
+}
+
+// Read one unmasked server frame. Returns false on timeout.
+inline bool ReadServerFrame(int fd, uint8_t& byte0, std::string& payload) {
+    std::string hdr = ReadN(fd, 2);
+    if (hdr.size() < 2) return false;
+    byte0 = static_cast<uint8_t>(hdr[0]);
+    uint64_t len = static_cast<uint8_t>(hdr[1]) & 0x7F;
+    if (len == 126) {
+        std::string ext = ReadN(fd, 2);
+        if (ext.size() < 2) return false;
+        len = (static_cast<uint8_t>(ext[0]) << 8) | static_cast<uint8_t>(ext[1]);
+    } else if (len == 127) {
+        std::string ext = ReadN(fd, 8);
+        if (ext.size() < 8) return false;
+        len = 0;
+        for (char c : ext) len = (len << 8) | static_cast<uint8_t>(c);
+    }
+    payload = ReadN(fd, static_cast<size_t>(len));
+    return payload.size() == len;
+}
+
+// T1
+void TestNegotiation() {
+    std::cout << "\n[TEST] WS deflate: handshake negotiation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        WebSocketDeflateParams p;
+        auto cfg = EnabledConfig();
+
+        if (!WebSocketHandshake::NegotiateDeflate(MakeUpgrade("permessage-deflate"), cfg, p) ||
+            p.ToHeaderValue() != "permessage-deflate") {
+            pass = false; err += "plain offer: " + p.ToHeaderValue() + "; ";
+        }
+
+        cfg.client_max_window_bits = 10;
+        if (!WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("permessage-deflate; client_max_window_bits; server_max_window_bits=12"),
+                cfg, p) ||
+            p.ToHeaderValue() !=
+                "permessage-deflate; server_max_window_bits=12; client_max_window_bits=10") {
+            pass = false; err += "window bits: " + p.ToHeaderValue() + "; ";
+        }
+        // Without client_max_window_bits in the offer the client keeps 15.
+        if (!WebSocketHandshake::NegotiateDeflate(MakeUpgrade("permessage-deflate"), cfg, p) ||
+            p.client_max_window_bits != 15) {
+            pass = false; err += "client bits requested without offer; ";
+        }
+        cfg.client_max_window_bits = 15;
+
+        if (!WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("permessage-deflate; client_no_context_takeover"), cfg, p) ||
+            !p.client_no_context_takeover) {
+            pass = false; err += "client hint not echoed; ";
+        }
+
+        // First offer declined (8-bit server window), second accepted.
+        if (!WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("permessage-deflate; server_max_window_bits=8, "
+                            "permessage-deflate; server_no_context_takeover"),
+                cfg, p) ||
+            !p.server_no_context_takeover) {
+            pass = false; err += "fallback offer; ";
+        }
+        if (WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("permessage-deflate; foo"), cfg, p) ||
+            WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("permessage-deflate; server_no_context_takeover; "
+                            "server_no_context_takeover"), cfg, p) ||
+            WebSocketHandshake::NegotiateDeflate(
+                MakeUpgrade("x-webkit-deflate-frame"), cfg, p)) {
+            pass = false; err += "invalid offer accepted; ";
+        }
+        WebSocketDeflateConfig off;
+        if (WebSocketHandshake::NegotiateDeflate(MakeUpgrade("permessage-deflate"), off, p)) {
+            pass = false; err += "negotiated while disabled; ";
+        }
+
+        TestFramework::RecordTest("WS deflate: handshake negotiation",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: handshake negotiation",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestCodecRoundTrip() {
+    std::cout << "\n[TEST] WS deflate: codec round-trip..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        const std::string msg =
+            "{\"symbol\":\"ACME\",\"bid\":101.25,\"ask\":101.50,\"volume\":12000}";
+
+        for (bool takeover : {true, false}) {
+            WebSocketDeflateParams params;
+            params.server_no_context_takeover = !takeover;
+            params.client_no_context_takeover = !takeover;
+            auto tx = WebSocketDeflate::Create(params, EnabledConfig(), nullptr);
+            auto rx = WebSocketDeflate::Create(params, EnabledConfig(), nullptr);
+            if (!tx || !rx) { pass = false; err += "create failed; "; continue; }
+
+            std::string first, second, out;
+            if (!tx->Compress(msg, first) || !tx->Compress(msg, second)) {
+                pass = false; err += "compress failed; ";
+                continue;
+            }
+            if (rx->Decompress(first, out, 0) != WebSocketDeflate::InflateResult::OK ||
+                out != msg ||
+                rx->Decompress(second, out, 0) != WebSocketDeflate::InflateResult::OK ||
+                out != msg) {
+                pass = false;
+                err += std::string(takeover ? "takeover" : "no-takeover") + " round-trip; ";
+            }
+            if (takeover && second.size() >= first.size()) {
+                pass = false; err += "context takeover did not shrink repeat; ";
+            }
+            if (!takeover && second != first) {
+                pass = false; err += "no-takeover output depends on history; ";
+            }
+        }
+
+        WebSocketDeflateParams params;
+        auto tx = WebSocketDeflate::Create(params, EnabledConfig(), nullptr);
+        auto rx = WebSocketDeflate::Create(params, EnabledConfig(), nullptr);
+        std::string big(100000, 'a'), compressed, out;
+        tx->Compress(big, compressed);
+        if (rx->Decompress(compressed, out, 1000) !=
+                WebSocketDeflate::InflateResult::TOO_LARGE) {
+            pass = false; err += "max_size not enforced; ";
+        }
+        auto rx2 = WebSocketDeflate::Create(params, EnabledConfig(), nullptr);
+        if (rx2->Decompress(std::string("\xff\xff\xff\xff", 4), out, 0) !=
+                WebSocketDeflate::InflateResult::CORRUPT) {
+            pass = false; err += "corrupt input accepted; ";
+        }
+
+        TestFramework::RecordTest("WS deflate: codec round-trip",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: codec round-trip",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T3
+void TestMemoryBudget() {
+    std::cout << "\n[TEST] WS deflate: server-wide memory budget..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        WebSocketDeflateParams params;
+        auto cfg = EnabledConfig();
+        size_t one = WebSocketDeflate::EstimateDeflateBytes(15, cfg.mem_level) +
+                     WebSocketDeflate::EstimateInflateBytes(15);
+
+        auto budget = std::make_shared<WebSocketDeflateBudget>(one * 2);
+        auto a = WebSocketDeflate::Create(params, cfg, budget);
+        auto b = WebSocketDeflate::Create(params, cfg, budget);
+        auto c = WebSocketDeflate::Create(params, cfg, budget);
+        if (!a || !b || c) {
+            pass = false; err += "cap not applied at 2 connections; ";
+        }
+        if (budget->used_bytes() != one * 2) {
+            pass = false; err += "used=" + std::to_string(budget->used_bytes()) + "; ";
+        }
+        a.reset();
+        if (budget->used_bytes() != one) {
+            pass = false; err += "release on destruction; ";
+        }
+
+        // No context takeover either way → shared contexts, no charge.
+        WebSocketDeflateParams shared;
+        shared.server_no_context_takeover = true;
+        shared.client_no_context_takeover = true;
+        auto tight = std::make_shared<WebSocketDeflateBudget>(1);
+        auto d = WebSocketDeflate::Create(shared, cfg, tight);
+        if (!d || d->reserved_bytes() != 0 || tight->used_bytes() != 0) {
+            pass = false; err += "shared-context connection charged; ";
+        }
+
+        TestFramework::RecordTest("WS deflate: server-wide memory budget",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: server-wide memory budget",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestParserRsv1() {
+    std::cout << "\n[TEST] WS deflate: parser RSV1 gating..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        std::string compressed_text = ClientFrame(0x1, "xyz", /*rsv1=*/true);
+
+        WebSocketParser plain;
+        plain.Parse(compressed_text.data(), compressed_text.size());
+        if (!plain.HasError()) { pass = false; err += "RSV1 accepted without extension; "; }
+
+        WebSocketParser negotiated;
+        negotiated.SetRsv1Allowed(true);
+        negotiated.Parse(compressed_text.data(), compressed_text.size());
+        if (negotiated.HasError() || !negotiated.HasFrame() ||
+            !negotiated.NextFrame().rsv1) {
+            pass = false; err += "RSV1 data frame rejected; ";
+        }
+        std::string ping = ClientFrame(0x9, "p", /*rsv1=*/true);
+        negotiated.Parse(ping.data(), ping.size());
+        if (!negotiated.HasError()) { pass = false; err += "RSV1 on ping accepted; "; }
+
+        TestFramework::RecordTest("WS deflate: parser RSV1 gating",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: parser RSV1 gating",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestEndToEnd() {
+    std::cout << "\n[TEST] WS deflate: negotiated echo over a real connection..." << std::endl;
+    try {
+        ServerConfig cfg;
+        cfg.bind_host = "127.0.0.1";
+        cfg.bind_port = 0;
+        cfg.worker_threads = 1;
+        cfg.websocket.permessage_deflate.enabled = true;
+        cfg.websocket.permessage_deflate.min_message_size = 16;
+        HttpServer server(cfg);
+
+        std::atomic<int> inflated_ok{0};
+        const std::string msg(200, 'q');
+        server.WebSocket("/ws", [&](WebSocketConnection& conn) {
+            conn.OnMessage([&](WebSocketConnection& c, const std::string& data, bool) {
+                if (data == msg) ++inflated_ok;
+                c.SendText(data);
+            });
+        });
+        TestServerRunner<HttpServer> runner(server);
+
+        bool pass = true;
+        std::string err;
+
+        // Peer-side codec: same raw-DEFLATE framing in both directions.
+        WebSocketDeflateParams peer_params;
+        auto peer = WebSocketDeflate::Create(peer_params, EnabledConfig(), nullptr);
+
+        int fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n"
+                    "Connection: Upgrade\r\n"
+                    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                    "Sec-WebSocket-Version: 13\r\n"
+                    "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n\r\n");
+        std::string head = ReadHeaderBlock(fd);
+        if (head.find(" 101 ") == std::string::npos ||
+            head.find("Sec-WebSocket-Extensions: permessage-deflate") == std::string::npos) {
+            pass = false; err += "101 without extension: " + head + "; ";
+        }
+
+        std::string compressed;
+        peer->Compress(msg, compressed);
+        SendAll(fd, ClientFrame(0x1, compressed, /*rsv1=*/true));
+        uint8_t b0 = 0;
+        std::string payload, echoed;
+        if (!ReadServerFrame(fd, b0, payload)) {
+            pass = false; err += "no echo; ";
+        } else {
+            if ((b0 & 0x40) == 0) { pass = false; err += "echo not compressed; "; }
+            if (payload.size() >= msg.size()) { pass = false; err += "echo not smaller; "; }
+            if (peer->Decompress(payload, echoed, 0) !=
+                    WebSocketDeflate::InflateResult::OK || echoed != msg) {
+                pass = false; err += "echo does not inflate to the message; ";
+            }
+        }
+        if (inflated_ok.load() != 1) { pass = false; err += "OnMessage saw compressed bytes; "; }
+        ::close(fd);
+
+        // No offer → no extension, plain frames.
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n"
+                    "Connection: Upgrade\r\n"
+                    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                    "Sec-WebSocket-Version: 13\r\n\r\n");
+        head = ReadHeaderBlock(fd);
+        if (head.find("Sec-WebSocket-Extensions") != std::string::npos) {
+            pass = false; err += "extension sent without offer; ";
+        }
+        SendAll(fd, ClientFrame(0x1, msg));
+        if (!ReadServerFrame(fd, b0, payload) || (b0 & 0x40) != 0 || payload != msg) {
+            pass = false; err += "plain echo wrong; ";
+        }
+        ::close(fd);
+
+        TestFramework::RecordTest("WS deflate: negotiated echo over a real connection",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: negotiated echo over a real connection",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T6
+void TestConfigRoundTripAndValidation() {
+    std::cout << "\n[TEST] WS deflate: config round-trip + validation..." << std::endl;
+    try {
+        bool pass = true;
+        std::string err;
+        ServerConfig cfg = ConfigLoader::LoadFromString(R"({
+            "websocket": { "permessage_deflate": {
+                "enabled": true,
+                "server_no_context_takeover": true,
+                "client_max_window_bits": 12,
+                "compression_level": 3,
+                "max_memory_bytes": 1048576
+            }}
+        })");
+        const auto& dc = cfg.websocket.permessage_deflate;
+        if (!dc.enabled || !dc.server_no_context_takeover ||
+            dc.client_max_window_bits != 12 || dc.compression_level != 3 ||
+            dc.max_memory_bytes != 1048576) {
+            pass = false; err += "load; ";
+        }
+        ServerConfig again = ConfigLoader::LoadFromString(ConfigLoader::ToJson(cfg));
+        if (again.websocket.permessage_deflate != dc) {
+            pass = false; err += "round-trip; ";
+        }
+
+        ServerConfig bad;
+        bad.websocket.permessage_deflate.server_max_window_bits = 8;
+        try {
+            ConfigLoader::Validate(bad);
+            pass = false; err += "8-bit window accepted; ";
+        } catch (const std::invalid_argument&) {}
+
+        try {
+            ConfigLoader::LoadFromString(
+                R"({"websocket": {"permessage_deflate": {"enabled": "yes"}}})");
+            pass = false; err += "non-bool enabled accepted; ";
+        } catch (const std::runtime_error&) {}
+
+        TestFramework::RecordTest("WS deflate: config round-trip + validation",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        TestFramework::RecordTest("WS deflate: config round-trip + validation",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n===== WebSocket permessage-deflate Tests =====" << std::endl;
+    TestNegotiation();
+    TestCodecRoundTrip();
+    TestMemoryBudget();
+    TestParserRsv1();
+    TestEndToEnd();
+    TestConfigRoundTripAndValidation();
+}
+
+}  // namespace WebSocketDeflateTests
@@ -5,10 +5,14 @@
 #include "ws/websocket_parser.h"
 #include "ws/websocket_handshake.h"
 #include "ws/websocket_connection.h"
+#include "ws/websocket_simd.h"
+#include "ws/utf8_validate.h"
 #include "http/http_request.h"
 
 #include <iostream>
 #include <cstring>
+#include <random>
+#include <vector>
 
 namespace WebSocketTests {
 
@@ -359,6 +363,123 @@ namespace WebSocketTests {
         }
     }
 
+    // === Vectorized unmask / UTF-8 ===
+
+    // Every level up to what this CPU supports.
+    inline std::vector<websocket_simd::Level> SimdLevels() {
+        std::vector<websocket_simd::Level> levels;
+        for (int l = 0; l <= static_cast<int>(websocket_simd::DetectedLevel()); ++l) {
+            levels.push_back(static_cast<websocket_simd::Level>(l));
+        }
+        return levels;
+    }
+
+    void TestSimdUnmaskMatchesScalar() {
+        std::cout << "\n[TEST] Vectorized Unmask Matches Byte Loop..." << std::endl;
+        try {
+            bool pass = true;
+            std::string err;
+            std::mt19937 rng(7);
+            const uint8_t key[4] = {0x12, 0x34, 0xAB, 0xCD};
+
+            // Lengths straddle every vector width; offsets shift the key phase.
+            for (size_t len : {0, 1, 3, 7, 8, 15, 16, 31, 32, 33, 63, 64, 65, 127, 200, 4099}) {
+                for (size_t offset : {0, 1, 2, 5}) {
+                    if (offset > len) continue;
+                    std::string src(len, '\0');
+                    for (auto& c : src) c = static_cast<char>(rng());
+                    std::string expect = src;
+                    for (size_t i = offset; i < expect.size(); i++) {
+                        expect[i] ^= key[(i - offset) % 4];
+                    }
+                    for (auto level : SimdLevels()) {
+                        std::string tail = src.substr(offset);
+                        websocket_simd::Unmask(level, reinterpret_cast<uint8_t*>(&tail[0]),
+                                               tail.size(), key);
+                        if (tail != expect.substr(offset)) {
+                            pass = false;
+                            err += std::string(websocket_simd::LevelName(level)) +
+                                   " len=" + std::to_string(len) + "; ";
+                        }
+                    }
+                }
+            }
+
+            TestFramework::RecordTest("Vectorized Unmask Matches Byte Loop", pass, err, TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            TestFramework::RecordTest("Vectorized Unmask Matches Byte Loop", false, e.what(), TestFramework::TestCategory::OTHER);
+        }
+    }
+
+    void TestSimdUtf8MatchesScalar() {
+        std::cout << "\n[TEST] Vectorized UTF-8 Matches Scalar Validator..." << std::endl;
+        try {
+            bool pass = true;
+            std::string err;
+
+            auto check = [&](const std::string& s, const std::string& label) {
+                bool expect = IsValidUtf8Scalar(s);
+                if (IsValidUtf8(s) != expect) {
+                    pass = false; err += "IsValidUtf8 " + label + "; ";
+                }
+                for (auto level : SimdLevels()) {
+                    if (websocket_simd::ValidateUtf8(level, s.data(), s.size()) != expect) {
+                        pass = false;
+                        err += std::string(websocket_simd::LevelName(level)) + " " + label + "; ";
+                    }
+                }
+            };
+
+            // Known edge cases, each placed at several offsets so it lands
+            // inside a block and across the 8/16/32-byte boundaries.
+            const std::pair<std::string, bool> cases[] = {
+                {"\xC3\xA9", true}, {"\xE2\x82\xAC", true}, {"\xF0\x9F\x98\x80", true},
+                {"\xF4\x8F\xBF\xBF", true},    // U+10FFFF
+                {"\xED\x9F\xBF", true},        // U+D7FF
+                {"\xC0\x80", false}, {"\xC1\xBF", false},          // overlong 2
+                {"\xE0\x80\xAF", false}, {"\xE0\x9F\xBF", false},  // overlong 3
+                {"\xF0\x8F\xBF\xBF", false},                       // overlong 4
+                {"\xED\xA0\x80", false}, {"\xED\xBF\xBF", false},  // surrogates
+                {"\xF4\x90\x80\x80", false}, {"\xF5\x80\x80\x80", false},  // > U+10FFFF
+                {"\xF8\x88\x80\x80\x80", false}, {"\xFF", false},
+                {"\x80", false}, {"\xC3", false}, {"\xE2\x82", false},     // stray / truncated
+                {"\xF0\x9F\x98", false}, {"\xC3\xA9\xA9", false},
+                {"\xE2\x28\xA1", false},
+            };
+            for (const auto& c : cases) {
+                for (size_t pad : {0, 5, 6, 7, 13, 14, 15, 29, 30, 31, 33}) {
+                    for (size_t trail : {0, 1, 40}) {
+                        std::string s = std::string(pad, 'a') + c.first + std::string(trail, 'b');
+                        if (IsValidUtf8Scalar(s) != c.second) {
+                            pass = false; err += "scalar disagrees with table; ";
+                        }
+                        check(s, "case pad=" + std::to_string(pad));
+                    }
+                }
+            }
+
+            // Random mutation of valid mixed text.
+            std::mt19937 rng(11);
+            const char* const samples[] = {"x", " ", "\xC3\xA9", "\xE4\xB8\xAD",
+                                           "\xF0\x9F\x98\x80", "\xED\x9F\xBF"};
+            for (int round = 0; round < 2000; ++round) {
+                std::string s;
+                size_t target = rng() % 150;
+                while (s.size() < target) s += samples[rng() % 6];
+                int flips = round % 3;
+                for (int f = 0; f < flips && !s.empty(); ++f) {
+                    s[rng() % s.size()] = static_cast<char>(rng());
+                }
+                check(s, "fuzz round " + std::to_string(round));
+                if (!pass) break;
+            }
+
+            TestFramework::RecordTest("Vectorized UTF-8 Matches Scalar Validator", pass, err, TestFramework::TestCategory::OTHER);
+        } catch (const std::exception& e) {
+            TestFramework::RecordTest("Vectorized UTF-8 Matches Scalar Validator", false, e.what(), TestFramework::TestCategory::OTHER);
+        }
+    }
+
     // Run all WebSocket tests
     void RunAllTests() {
         std::cout << "\n" << std::string(60, '=') << std::endl;
@@ -375,6 +496,8 @@ namespace WebSocketTests {
         TestParserBinaryFrame();
         TestFragmentationReassembly();
         TestPingPongAutoResponse();
+        TestSimdUnmaskMatchesScalar();
+        TestSimdUtf8MatchesScalar();
     }
 
 }  // namespace WebSocketTests
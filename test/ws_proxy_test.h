@@ -0,0 +1,465 @@
+#pragma once
+
+// ws_proxy_test.h — WebSocket proxy tunnels (proxy.websocket).
+//
+//   T1  Upgrade through a strip_prefix route reaches the backend's
+//       WebSocket route; its 101 (Sec-WebSocket-Accept) is relayed and a
+//       text frame round-trips
+//   T2  A frame pipelined in the same packet as the upgrade request is
+//       held until the 101 and then relayed
+//   T3  Backend refusal (404) is relayed to the client; a proxy route
+//       without proxy.websocket still rejects upgrades
+//   T4  A 6 MB binary message echoes intact through a 64 KB relay cap
+//       (read-pump backpressure on both directions)
+//   T5  Backend-initiated Close reaches the client; tunnel stats count
+//       the tunnel and its bytes and drop to zero active
+
+#include "test_framework.h"
+#include "test_server_runner.h"
+#include "http/http_server.h"
+#include "ws/websocket_connection.h"
+#include "config/server_config.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace WsProxyTests {
+
+static const char* kSampleKey = "dGhlIHNhbXBsZSBub25jZQ==";
+// What the backend answers for kSampleKey (see WebSocketTests accept-key).
+static const char* kSampleAccept = "yCpM3L09Tfw7+3c/uzBUkSLeN8M=";
+
+inline std::string UpgradeRequest(const std::string& path) {
+    return "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\n"
+           "Connection: Upgrade\r\nSec-WebSocket-Key: " + std::string(kSampleKey) +
+           "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+}
+
+inline int Connect(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+inline bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline std::string ReadN(int fd, size_t n, int timeout_ms = 5000) {
+    std::string out;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (out.size() < n && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        char buf[65536];
+        ssize_t r = ::recv(fd, buf, std::min(sizeof(buf), n - out.size()), 0);
+        if (r <= 0) break;
+        out.append(buf, static_cast<size_t>(r));
+    }
+    return out;
+}
+
+// Read one response head (through the blank line), byte at a time so
+// nothing after it is consumed.
+inline std::string ReadHead(int fd, int timeout_ms = 5000) {
+    std::string head;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        char c;
+        if (::recv(fd, &c, 1, 0) != 1) break;
+        head.push_back(c);
+        if (head.size() >= 4 && head.compare(head.size() - 4, 4, "\r\n\r\n") == 0) break;
+    }
+    return head;
+}
+
+// Masked client frame with any payload size.
+inline std::string ClientFrame(uint8_t opcode, const std::string& payload) {
+    std::string f;
+    f.push_back(static_cast<char>(0x80 | opcode));
+    size_t n = payload.size();
+    if (n < 126) {
+        f.push_back(static_cast<char>(0x80 | n));
+    } else if (n <= 0xFFFF) {
+        f.push_back(static_cast<char>(0x80 | 126));
+        f.push_back(static_cast<char>(n >> 8));
+        f.push_back(static_cast<char>(n & 0xFF));
+    } else {
+        f.push_back(static_cast<char>(0x80 | 127));
+        for (int i = 7; i >= 0; --i) f.push_back(static_cast<char>((n >> (8 * i)) & 0xFF));
+    }
+    const uint8_t mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+    f.append(reinterpret_cast<const char*>(mask), 4);
+    for (size_t i = 0; i < n; ++i) {
+        f.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    return f;
+}
+
+struct ServerFrame {
+    int opcode = -1;  // -1 = nothing read
+    std::string payload;
+};
+
+// Read one unmasked server frame.
+inline ServerFrame ReadFrame(int fd, int timeout_ms = 5000) {
+    ServerFrame out;
+    std::string hdr = ReadN(fd, 2, timeout_ms);
+    if (hdr.size() < 2) return out;
+    uint64_t len = static_cast<uint8_t>(hdr[1]) & 0x7F;
+    if (len == 126 || len == 127) {
+        std::string ext = ReadN(fd, len == 126 ? 2 : 8, timeout_ms);
+        len = 0;
+        for (char c : ext) len = (len << 8) | static_cast<uint8_t>(c);
+    }
+    out.payload = ReadN(fd, static_cast<size_t>(len), timeout_ms);
+    if (out.payload.size() != len) return out;
+    out.opcode = static_cast<uint8_t>(hdr[0]) & 0x0F;
+    return out;
+}
+
+inline bool WaitFor(const std::function<bool()>& pred, int timeout_ms = 3000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (pred()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return pred();
+}
+
+inline UpstreamConfig WsUpstream(int port, const std::string& route_prefix,
+                                 bool strip_prefix, bool websocket = true) {
+    UpstreamConfig u;
+    u.name = "ws-backend";
+    u.host = "127.0.0.1";
+    u.port = port;
+    u.pool.max_connections = 8;
+    u.pool.max_idle_connections = 4;
+    u.pool.connect_timeout_ms = 3000;
+    u.proxy.route_prefix = route_prefix;
+    u.proxy.strip_prefix = strip_prefix;
+    u.proxy.response_timeout_ms = 5000;
+    u.proxy.websocket = websocket;
+    return u;
+}
+
+inline ServerConfig GatewayConfig(const UpstreamConfig& u) {
+    ServerConfig gw;
+    gw.bind_host = "127.0.0.1";
+    gw.bind_port = 0;
+    gw.worker_threads = 1;
+    gw.http2.enabled = false;
+    gw.upstreams.push_back(u);
+    return gw;
+}
+
+// Backend with an echo route at /echo and a route at /bye that sends
+// one message and then closes 1000.
+inline ServerConfig BackendConfig() {
+    ServerConfig cfg;
+    cfg.bind_host = "127.0.0.1";
+    cfg.bind_port = 0;
+    cfg.worker_threads = 1;
+    cfg.http2.enabled = false;
+    cfg.max_ws_message_size = 16 * 1024 * 1024;
+    return cfg;
+}
+
+inline void InstallBackendRoutes(HttpServer& backend) {
+    backend.WebSocket("/echo", [](WebSocketConnection& conn) {
+        conn.OnMessage([](WebSocketConnection& c, const std::string& msg, bool is_binary) {
+            if (is_binary) c.SendBinary(msg); else c.SendText(msg);
+        });
+    });
+    backend.WebSocket("/bye", [](WebSocketConnection& conn) {
+        conn.OnMessage([](WebSocketConnection& c, const std::string&, bool) {
+            c.SendText("bye");
+            c.SendClose(1000, "done");
+        });
+    });
+}
+
+// T1
+void TestEchoThroughTunnel() {
+    std::cout << "\n[TEST] WS proxy: upgrade and echo through tunnel..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer backend(BackendConfig());
+        InstallBackendRoutes(backend);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        HttpServer gateway(GatewayConfig(
+            WsUpstream(backend_runner.GetPort(), "/chat", /*strip_prefix=*/true)));
+        TestServerRunner<HttpServer> runner(gateway);
+
+        bool pass = true;
+        std::string err;
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/chat/echo"));
+        std::string head = ReadHead(fd);
+        if (head.find(" 101 ") == std::string::npos) {
+            pass = false; err += "no 101: " + head.substr(0, head.find("\r\n")) + "; ";
+        }
+        if (head.find(kSampleAccept) == std::string::npos) {
+            pass = false; err += "backend Sec-WebSocket-Accept not relayed; ";
+        }
+        SendAll(fd, ClientFrame(0x1, "hello through the proxy"));
+        ServerFrame f = ReadFrame(fd);
+        if (f.opcode != 0x1 || f.payload != "hello through the proxy") {
+            pass = false; err += "echo mismatch (op=" + std::to_string(f.opcode) + "); ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS proxy: upgrade and echo through tunnel",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS proxy: upgrade and echo through tunnel",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T2
+void TestFramePipelinedWithUpgrade() {
+    std::cout << "\n[TEST] WS proxy: frame pipelined with upgrade..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer backend(BackendConfig());
+        InstallBackendRoutes(backend);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        HttpServer gateway(GatewayConfig(
+            WsUpstream(backend_runner.GetPort(), "/echo", false)));
+        TestServerRunner<HttpServer> runner(gateway);
+
+        bool pass = true;
+        std::string err;
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/echo") + ClientFrame(0x2, std::string("\x00\x01\x02pipelined", 12)));
+        std::string head = ReadHead(fd);
+        if (head.find(" 101 ") == std::string::npos) {
+            pass = false; err += "no 101; ";
+        }
+        ServerFrame f = ReadFrame(fd);
+        if (f.opcode != 0x2 || f.payload != std::string("\x00\x01\x02pipelined", 12)) {
+            pass = false; err += "pipelined frame lost or corrupted; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS proxy: frame pipelined with upgrade",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS proxy: frame pipelined with upgrade",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T3
+void TestBackendRefusalRelayed() {
+    std::cout << "\n[TEST] WS proxy: backend refusal relayed..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer backend(BackendConfig());
+        InstallBackendRoutes(backend);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        ServerConfig gw = GatewayConfig(
+            WsUpstream(backend_runner.GetPort(), "/ws", false));
+        UpstreamConfig plain = WsUpstream(backend_runner.GetPort(), "/plain",
+                                          true, /*websocket=*/false);
+        plain.name = "plain-backend";
+        gw.upstreams.push_back(plain);
+        HttpServer gateway(gw);
+        TestServerRunner<HttpServer> runner(gateway);
+
+        bool pass = true;
+        std::string err;
+        // The backend has no /ws/missing WebSocket route.
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/ws/missing"));
+        std::string head = ReadHead(fd);
+        if (head.find(" 404 ") == std::string::npos) {
+            pass = false; err += "expected relayed 404, got: " +
+                                 head.substr(0, head.find("\r\n")) + "; ";
+        }
+        ::close(fd);
+
+        // websocket=false: the route is HTTP-only and upgrades miss.
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/plain/echo"));
+        head = ReadHead(fd);
+        if (head.find(" 101 ") != std::string::npos || head.empty()) {
+            pass = false; err += "upgrade on non-websocket proxy route: " +
+                                 head.substr(0, head.find("\r\n")) + "; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS proxy: backend refusal relayed",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS proxy: backend refusal relayed",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T4
+void TestLargeMessageBackpressure() {
+    std::cout << "\n[TEST] WS proxy: large message through small relay cap..." << std::endl;
+    int fd = -1;
+    std::thread writer;
+    try {
+        HttpServer backend(BackendConfig());
+        InstallBackendRoutes(backend);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        UpstreamConfig u = WsUpstream(backend_runner.GetPort(), "/echo", false);
+        u.proxy.relay_buffer_limit_bytes = 64 * 1024;
+        u.proxy.auto_stream_content_length_threshold_bytes = 64 * 1024;
+        HttpServer gateway(GatewayConfig(u));
+        TestServerRunner<HttpServer> runner(gateway);
+
+        bool pass = true;
+        std::string err;
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/echo"));
+        if (ReadHead(fd).find(" 101 ") == std::string::npos) {
+            throw std::runtime_error("upgrade failed");
+        }
+
+        std::string message(6 * 1024 * 1024, '\0');
+        for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<char>(i % 253);
+        std::string frame = ClientFrame(0x2, message);
+        writer = std::thread([fd, &frame] { SendAll(fd, frame); });
+
+        ServerFrame f = ReadFrame(fd, 20000);
+        writer.join();
+        if (f.opcode != 0x2) { pass = false; err += "no binary echo; "; }
+        if (f.payload != message) {
+            pass = false; err += "payload differs (" + std::to_string(f.payload.size()) + " bytes); ";
+        }
+        auto stats = gateway.GetStats();
+        if (stats.ws_tunnel_bytes_to_upstream < static_cast<int64_t>(frame.size())) {
+            pass = false; err += "bytes_to_upstream=" +
+                                 std::to_string(stats.ws_tunnel_bytes_to_upstream) + "; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS proxy: large message through small relay cap",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (writer.joinable()) {
+            ::shutdown(fd, SHUT_RDWR);
+            writer.join();
+        }
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS proxy: large message through small relay cap",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+// T5
+void TestBackendCloseAndStats() {
+    std::cout << "\n[TEST] WS proxy: backend close and tunnel stats..." << std::endl;
+    int fd = -1;
+    try {
+        HttpServer backend(BackendConfig());
+        InstallBackendRoutes(backend);
+        TestServerRunner<HttpServer> backend_runner(backend);
+
+        HttpServer gateway(GatewayConfig(
+            WsUpstream(backend_runner.GetPort(), "/bye", false)));
+        TestServerRunner<HttpServer> runner(gateway);
+
+        bool pass = true;
+        std::string err;
+        fd = Connect(runner.GetPort());
+        if (fd < 0) throw std::runtime_error("connect failed");
+        SendAll(fd, UpgradeRequest("/bye"));
+        if (ReadHead(fd).find(" 101 ") == std::string::npos) {
+            throw std::runtime_error("upgrade failed");
+        }
+        if (!WaitFor([&] { return gateway.GetStats().ws_tunnels_active == 1; })) {
+            pass = false; err += "active tunnel not counted; ";
+        }
+
+        SendAll(fd, ClientFrame(0x1, "hi"));
+        ServerFrame msg = ReadFrame(fd);
+        if (msg.opcode != 0x1 || msg.payload != "bye") {
+            pass = false; err += "message before close missing; ";
+        }
+        ServerFrame close = ReadFrame(fd);
+        if (close.opcode != 0x8 || close.payload.size() < 2 ||
+            ((static_cast<uint8_t>(close.payload[0]) << 8) |
+             static_cast<uint8_t>(close.payload[1])) != 1000) {
+            pass = false; err += "backend Close 1000 not relayed; ";
+        }
+        // Answer the close; the backend then drops TCP and the tunnel
+        // closes the client side.
+        SendAll(fd, ClientFrame(0x8, std::string("\x03\xE8", 2)));
+        char c;
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 3000) <= 0 || ::recv(fd, &c, 1, 0) != 0) {
+            pass = false; err += "client side not closed; ";
+        }
+
+        if (!WaitFor([&] { return gateway.GetStats().ws_tunnels_active == 0; })) {
+            pass = false; err += "active tunnel not released; ";
+        }
+        auto stats = gateway.GetStats();
+        if (stats.ws_tunnels_total != 1) {
+            pass = false; err += "total=" + std::to_string(stats.ws_tunnels_total) + "; ";
+        }
+        if (stats.ws_tunnel_bytes_to_client <= 0 || stats.ws_tunnel_bytes_to_upstream <= 0) {
+            pass = false; err += "byte counters not advanced; ";
+        }
+
+        ::close(fd);
+        TestFramework::RecordTest("WS proxy: backend close and tunnel stats",
+                                  pass, err, TestFramework::TestCategory::OTHER);
+    } catch (const std::exception& e) {
+        if (fd >= 0) ::close(fd);
+        TestFramework::RecordTest("WS proxy: backend close and tunnel stats",
+                                  false, e.what(), TestFramework::TestCategory::OTHER);
+    }
+}
+
+void RunAllTests() {
+    std::cout << "\n===== WebSocket Proxy Tests =====" << std::endl;
+    TestEchoThroughTunnel();
+    TestFramePipelinedWithUpgrade();
+    TestBackendRefusalRelayed();
+    TestLargeMessageBackpressure();
+    TestBackendCloseAndStats();
+}
+
+}  // namespace WsProxyTests